@@ -18,8 +18,208 @@
 
 #include "coreaction.hh"
 
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
 namespace ghidra {
 
+// Deadline for the decompilation running on the current thread. Checked at
+// action granularity inside perform() and per PcodeOp inside ActionPool, so
+// an expired deadline surfaces as a break (-1) within a bounded amount of
+// additional work. Thread-local so parallel decompilations have independent
+// deadlines.
+static thread_local bool action_timeout_armed = false;
+static thread_local std::chrono::steady_clock::time_point action_deadline;
+
+/// Arm a deadline \e max_ms milliseconds in the future for any perform()
+/// call made by the current thread. A value of 0 disarms the deadline.
+/// \param max_ms is the number of milliseconds until the deadline
+void Action::startTimeout(uint4 max_ms)
+
+{
+  if (max_ms == 0) {
+    action_timeout_armed = false;
+    return;
+  }
+  action_timeout_armed = true;
+  action_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(max_ms);
+}
+
+/// Disarm any deadline previously armed on the current thread
+void Action::clearTimeout(void)
+
+{
+  action_timeout_armed = false;
+}
+
+/// \return true if a deadline is armed on the current thread and has passed
+bool Action::timeoutExpired(void)
+
+{
+  if (!action_timeout_armed) return false;
+  return (std::chrono::steady_clock::now() >= action_deadline);
+}
+
+// External cancellation test (e.g. "has the RPC client hung up") for the
+// decompilation running on the current thread. The callback may be
+// comparatively expensive, so isCancelled() rate limits it and caches a
+// positive result.
+static thread_local bool (*action_cancel_cb)(void *) = (bool (*)(void *))0;
+static thread_local void *action_cancel_data = (void *)0;
+static thread_local uint4 action_cancel_phase = 0;
+static thread_local bool action_cancel_hit = false;
+
+/// Register a test, invoked periodically during perform() on the current
+/// thread, that returns \b true when the work should be abandoned.
+/// \param cb is the test to invoke
+/// \param data is an opaque value passed to the test
+void Action::setCancelCallback(bool (*cb)(void *),void *data)
+
+{
+  action_cancel_cb = cb;
+  action_cancel_data = data;
+  action_cancel_phase = 0;
+  action_cancel_hit = false;
+}
+
+/// Remove any cancellation test registered on the current thread
+void Action::clearCancelCallback(void)
+
+{
+  action_cancel_cb = (bool (*)(void *))0;
+  action_cancel_data = (void *)0;
+  action_cancel_hit = false;
+}
+
+/// \return true if the registered cancellation test has fired
+bool Action::isCancelled(void)
+
+{
+  if (action_cancel_hit) return true;
+  if (action_cancel_cb == (bool (*)(void *))0) return false;
+  action_cancel_phase += 1;
+  if ((action_cancel_phase & 0xff) != 0) return false;	// Poll once per 256 checks
+  if ((*action_cancel_cb)(action_cancel_data))
+    action_cancel_hit = true;
+  return action_cancel_hit;
+}
+
+// Cooperative yield point for low-priority decompilations. Invoked between
+// the members of an ActionGroup, where the callback may block until higher
+// priority work has drained without leaving the function in a bad state.
+static thread_local void (*action_yield_cb)(void *) = (void (*)(void *))0;
+static thread_local void *action_yield_data = (void *)0;
+
+/// Register a callback, invoked between the members of an ActionGroup on the
+/// current thread, that may block to let higher priority work run first.
+/// \param cb is the callback to invoke
+/// \param data is an opaque value passed to the callback
+void Action::setYieldCallback(void (*cb)(void *),void *data)
+
+{
+  action_yield_cb = cb;
+  action_yield_data = data;
+}
+
+/// Remove any yield callback registered on the current thread
+void Action::clearYieldCallback(void)
+
+{
+  action_yield_cb = (void (*)(void *))0;
+  action_yield_data = (void *)0;
+}
+
+/// Called between the members of an ActionGroup; gives a registered yield
+/// callback the chance to stall \b this thread behind higher priority work
+void Action::yieldPoint(void)
+
+{
+  if (action_yield_cb != (void (*)(void *))0)
+    (*action_yield_cb)(action_yield_data);
+}
+
+/// Combined early-exit test used inside the pipeline loops
+/// \return true if the current thread's work should stop
+bool Action::isAborted(void)
+
+{
+  return (timeoutExpired() || isCancelled());
+}
+
+// Sampling profiler. A watcher thread advances a global tick at the sampling
+// interval; worker threads compare the tick at Action and Rule boundaries and,
+// when it has advanced, attribute the elapsed ticks to whatever they just
+// executed. Unlike OPACTION_DEBUG tracing this needs no recompilation, costs
+// one relaxed atomic load per boundary when idle, and produces a statistical
+// profile rather than an exhaustive transform log, so it can stay on in
+// production.
+static std::atomic<bool> profile_enabled(false);
+static std::atomic<uint4> profile_tick(0);
+static thread_local uint4 profile_seen = 0;
+static std::mutex profile_lock;		// Guards profile_counts
+static map<string,uint8> profile_counts;
+
+/// Attribute sampling ticks that elapsed during the just-finished piece of
+/// work to \a name. The fast path (profiling off, or no tick has passed)
+/// never takes a lock.
+/// \param name is the name of the Action or Rule that was executing
+static inline void profileSample(const string &name)
+
+{
+  if (!profile_enabled.load(std::memory_order_relaxed)) return;
+  uint4 tick = profile_tick.load(std::memory_order_relaxed);
+  uint4 delta = tick - profile_seen;
+  if (delta == 0) return;
+  profile_seen = tick;
+  std::lock_guard<std::mutex> lock(profile_lock);
+  profile_counts[name] += delta;
+}
+
+/// Forget any sampling ticks that elapsed while the current thread was not
+/// executing pipeline work, so idle time between functions is never
+/// attributed to the next Action that happens to run.
+static inline void profileResync(void)
+
+{
+  if (!profile_enabled.load(std::memory_order_relaxed)) return;
+  profile_seen = profile_tick.load(std::memory_order_relaxed);
+}
+
+/// Turn on statistical sampling of Action/Rule execution process-wide.
+/// A watcher thread must drive profileTick() for samples to accumulate.
+void Action::enableProfiling(void)
+
+{
+  profile_enabled.store(true);
+}
+
+/// Turn off statistical sampling process-wide.  Accumulated counts are kept.
+void Action::disableProfiling(void)
+
+{
+  profile_enabled.store(false);
+}
+
+/// Advance the sampling clock by one tick.  Intended to be called from a
+/// dedicated watcher thread at the desired sampling interval; the interval
+/// chosen determines what one unit in the profile represents.
+void Action::profileTick(void)
+
+{
+  profile_tick.fetch_add(1,std::memory_order_relaxed);
+}
+
+/// Copy the accumulated profile into the given map, keyed by Action/Rule
+/// name, each value counting sampling ticks attributed to that name.
+/// \param res will hold the sample counts
+void Action::takeProfile(map<string,uint8> &res)
+
+{
+  std::lock_guard<std::mutex> lock(profile_lock);
+  res = profile_counts;
+}
+
 /// Specify the name, group, and properties of the Action
 /// \param f is the collection of property flags
 /// \param nm is the Action name
@@ -34,6 +234,7 @@ Action::Action(uint4 f,const string &nm,const string &g)
   basegroup = g;
   count_tests = 0;
   count_apply = 0;
+  count_usec = 0;
 }
 
 /// If enabled, issue a warning that this Action has been applied
@@ -93,7 +294,42 @@ bool Action::turnOffDebug(const string &nm)
 void Action::printStatistics(ostream &s) const
 
 {
-  s << name << dec << " Tested=" << count_tests << " Applied=" << count_apply << endl;
+  s << name << dec << " Tested=" << count_tests << " Applied=" << count_apply << " Micros=" << count_usec << endl;
+}
+
+/// The default implementation just adds \b this to the list.  Containers
+/// override it to recurse into their children, producing the flat list of
+/// actions that back each phase statistic.
+/// \param res will hold the flattened list of actions
+void Action::collectStatistics(vector<Action *> &res)
+
+{
+  res.push_back(this);
+}
+
+/// The default implementation is empty; containers recurse into their
+/// children and pools contribute their Rule objects, producing the flat
+/// list backing the per-rule profile.
+/// \param res will hold the flattened list of rules
+void Action::collectRules(vector<Rule *> &res)
+
+{
+}
+
+/// The default implementation is empty; containers recurse into their
+/// children so that the toggle reaches every ActionPool in the hierarchy.
+/// \param val is \b true to enable adaptive rule ordering
+void Action::setAdaptiveReorder(bool val)
+
+{
+}
+
+/// The default implementation is empty; containers recurse into their
+/// children so that the toggle reaches every ActionPool in the hierarchy.
+/// \param val is \b true to enable locality-aware worklist ordering
+void Action::setLocalityOrder(bool val)
+
+{
 }
 
 /// \param data is the new function \b this Action may affect
@@ -102,6 +338,7 @@ void Action::reset(Funcdata &data)
 {
   status = status_start;
   flags &= ~rule_warnings_given; // Indicate a warning has not been given yet
+  profileResync();		// Never attribute idle time preceding this function
 }
 
 /// Reset all the counts to zero
@@ -110,6 +347,7 @@ void Action::resetStats(void)
 {
   count_tests = 0;
   count_apply = 0;
+  count_usec = 0;
 }
 
 /// Check if there was an active \e action breakpoint on this Action
@@ -301,6 +539,10 @@ int4 Action::perform(Funcdata &data)
   int4 res;
 
   do {
+    if (isAborted()) {
+      status = status_mid;	// Allow a later perform() to continue
+      return -1;		// Indicate partial completion
+    }
     switch(status) {
     case status_start:
       count = 0;		// No changes made yet by this action
@@ -316,7 +558,13 @@ int4 Action::perform(Funcdata &data)
 #ifdef OPACTION_DEBUG
       data.debugActivate();
 #endif
-      res = apply(data);	// Start or continue action
+      {
+	std::chrono::steady_clock::time_point applystart = std::chrono::steady_clock::now();
+	res = apply(data);	// Start or continue action
+	count_usec += std::chrono::duration_cast<std::chrono::microseconds>(
+	    std::chrono::steady_clock::now() - applystart).count();
+	profileSample(name);
+      }
 #ifdef OPACTION_DEBUG
       data.debugModPrint(getName());
 #endif
@@ -511,6 +759,7 @@ int4 ActionGroup::apply(Funcdata &data)
   if (status != status_mid)
     state = list.begin();	// Initialize the derived action
   for(;state!=list.end();++state) {
+    yieldPoint();		// Low priority work stalls here behind interactive requests
     res = (*state)->perform(data);
     if (res>0) {		// A change was made
       count  += res;
@@ -521,6 +770,7 @@ int4 ActionGroup::apply(Funcdata &data)
     }
     else if (res<0)		// Partial completion of member
       return -1;		// equates to partial completion of group action
+    data.opRecycleRetired();	// Member is complete, reclaim storage of ops it retired
   }
 
   return 0;			// Indicate successful completion
@@ -547,6 +797,7 @@ void ActionRestartGroup::reset(Funcdata &data)
 
 {
   curstart = 0;
+  data.clearRestartTally();
   ActionGroup::reset(data);
 }
 
@@ -566,6 +817,7 @@ int4 ActionRestartGroup::apply(Funcdata &data)
     if (data.isJumptableRecoveryOn()) // Don't restart within jumptable recovery
       return 0;
     curstart += 1;
+    data.countRestart();	// Attribute the restart before analysis is cleared
     if (curstart > maxrestarts) {
       data.warningHeader("Exceeded maximum restarts with more pending");
       curstart = -1;
@@ -616,6 +868,39 @@ void ActionGroup::printStatistics(ostream &s) const
     (*iter)->printStatistics(s);
 }
 
+void ActionGroup::collectStatistics(vector<Action *> &res)
+
+{
+  Action::collectStatistics(res);
+  vector<Action *>::iterator iter;
+  for(iter = list.begin();iter!=list.end();++iter)
+    (*iter)->collectStatistics(res);
+}
+
+void ActionGroup::collectRules(vector<Rule *> &res)
+
+{
+  vector<Action *>::iterator iter;
+  for(iter = list.begin();iter!=list.end();++iter)
+    (*iter)->collectRules(res);
+}
+
+void ActionGroup::setAdaptiveReorder(bool val)
+
+{
+  vector<Action *>::iterator iter;
+  for(iter = list.begin();iter!=list.end();++iter)
+    (*iter)->setAdaptiveReorder(val);
+}
+
+void ActionGroup::setLocalityOrder(bool val)
+
+{
+  vector<Action *>::iterator iter;
+  for(iter = list.begin();iter!=list.end();++iter)
+    (*iter)->setLocalityOrder(val);
+}
+
 /// \param g is the groupname to which \b this Rule belongs
 /// \param fl is the set of properties
 /// \param nm is the name of the Rule
@@ -628,6 +913,8 @@ Rule::Rule(const string &g,uint4 fl,const string &nm)
   basegroup = g;
   count_tests = 0;
   count_apply = 0;
+  count_nsec = 0;
+  fastid = 0;
 }
 
 /// This method is called whenever \b this Rule applies. If warnings have been
@@ -660,6 +947,7 @@ void Rule::resetStats(void)
 {
   count_tests = 0;
   count_apply = 0;
+  count_nsec = 0;
 }
 
 #ifdef OPACTION_DEBUG
@@ -697,7 +985,7 @@ bool Rule::turnOffDebug(const string &nm)
 void Rule::printStatistics(ostream &s) const
 
 {
-  s << name << dec << " Tested=" << count_tests << " Applied=" << count_apply << endl;
+  s << name << dec << " Tested=" << count_tests << " Applied=" << count_apply << " Nanos=" << count_nsec << endl;
 }
 
 /// Populate the given array with all possible OpCodes this Rule might apply to.
@@ -811,27 +1099,20 @@ Rule *ActionPool::getSubRule(const string &specify)
   return lastrule;
 }
 
-/// This method attempts to apply each Rule to the current PcodeOp
-/// Action breakpoints are checked if the Rule successfully applies.
-/// 0 is returned for no breakpoint, -1 if a breakpoint occurs.
-/// If a breakpoint did occur, an additional call to processOp() will
-/// pick up where it left off before the breakpoint. The PcodeOp iterator is advanced.
+/// The per-opcode rule list is run over the op, restarting whenever a
+/// successful application changes the op's opcode.  Action breakpoints are
+/// checked if a Rule successfully applies; if one trips, \b rule_index records
+/// where iteration stopped so a later call picks up where it left off.
 /// \param op is the current PcodeOp
 /// \param data is the function being transformed
 /// \return 0 if no breakpoint, -1 otherwise
-int4 ActionPool::processOp(PcodeOp *op,Funcdata &data)
+int4 ActionPool::applyRules(PcodeOp *op,Funcdata &data)
 
 {
   Rule *rl;
   int4 res;
   uint4 opc;
 
-  if (op->isDead()) {
-    op_state++;
-    data.opDeadAndGone(op);
-    rule_index = 0;
-    return 0;
-  }
   opc = op->code();
   while(rule_index < perop[opc].size()) {
     rl = perop[opc][rule_index++];
@@ -840,7 +1121,14 @@ int4 ActionPool::processOp(PcodeOp *op,Funcdata &data)
     data.debugActivate();
 #endif
     rl->count_tests += 1;
-    res = rl->applyOp(op,data);
+    std::chrono::steady_clock::time_point applystart = std::chrono::steady_clock::now();
+    if (rl->fastid != 0)
+      res = ruleApplyFast(rl->fastid,rl,op,data);
+    else
+      res = rl->applyOp(op,data);
+    rl->count_nsec += std::chrono::duration_cast<std::chrono::nanoseconds>(
+	std::chrono::steady_clock::now() - applystart).count();
+    profileSample(rl->getName());
 #ifdef OPACTION_DEBUG
     data.debugModPrint(rl->getName());
 #endif
@@ -868,21 +1156,88 @@ int4 ActionPool::processOp(PcodeOp *op,Funcdata &data)
       rule_index = 0;	
     }
   }
+  return 0;
+}
+
+/// This method attempts to apply each Rule to the current PcodeOp
+/// Action breakpoints are checked if the Rule successfully applies.
+/// 0 is returned for no breakpoint, -1 if a breakpoint occurs.
+/// If a breakpoint did occur, an additional call to processOp() will
+/// pick up where it left off before the breakpoint. The PcodeOp iterator is advanced.
+/// \param op is the current PcodeOp
+/// \param data is the function being transformed
+/// \return 0 if no breakpoint, -1 otherwise
+int4 ActionPool::processOp(PcodeOp *op,Funcdata &data)
+
+{
+  if (op->isDead()) {
+    op_state++;
+    data.opDeadAndGone(op);
+    rule_index = 0;
+    return 0;
+  }
+  if (0!=applyRules(op,data)) return -1;
   op_state++;
   rule_index = 0;
 
   return 0;
 }
 
+/// The ops of the function are collected block by block, in each block's
+/// execution order, with ops not linked into any block appended at the end in
+/// sequence-number order.  Consecutive rule applications then touch
+/// neighboring ops and varnodes instead of bouncing between distant blocks.
+/// Ops created while the pass drains land in the op bank as usual and are
+/// picked up by the pool's next repeat pass, in their home bucket.
+/// \param data is the function being transformed
+void ActionPool::buildLocalOrder(Funcdata &data)
+
+{
+  localorder.clear();
+  const BlockGraph &graph(data.getBasicBlocks());
+  for(int4 i=0;i<graph.getSize();++i) {
+    const BlockBasic *bb = (const BlockBasic *)graph.getBlock(i);
+    list<PcodeOp *>::const_iterator oiter;
+    for(oiter=bb->beginOp();oiter!=bb->endOp();++oiter)
+      localorder.push_back(*oiter);
+  }
+  PcodeOpTree::const_iterator iter;
+  for(iter=data.beginOpAll();iter!=data.endOpAll();++iter) {
+    PcodeOp *op = (*iter).second;
+    if (op->getParent() == (BlockBasic *)0)
+      localorder.push_back(op);
+  }
+}
+
 int4 ActionPool::apply(Funcdata &data)
 
 {
+  if (localityorder) {
+    if (status != status_mid) {
+      buildLocalOrder(data);	// Initialize the derived action
+      local_index = 0;
+      rule_index = 0;
+    }
+    while(local_index < localorder.size()) {
+      if (isAborted()) return -1;	// Resumable via local_index/rule_index
+      PcodeOp *op = localorder[local_index];
+      if (!op->isDead()) {		// Ops killed earlier in the pass are left for dead-code removal
+	if (0!=applyRules(op,data)) return -1;
+      }
+      local_index += 1;
+      rule_index = 0;
+    }
+    localorder.clear();
+    return 0;
+  }
   if (status != status_mid) {
     op_state = data.beginOpAll();	// Initialize the derived action
     rule_index = 0;
   }
-  for(;op_state!=data.endOpAll();)
+  for(;op_state!=data.endOpAll();) {
+	  if (isAborted()) return -1;	// Resumable via op_state/rule_index
 	  if (0!=processOp((*op_state).second,data)) return -1;
+  }
 
   return 0;			// Indicate successful completion
 }
@@ -921,6 +1276,49 @@ void ActionPool::reset(Funcdata &data)
   Action::reset(data);
   for(iter=allrules.begin();iter!=allrules.end();++iter)
     (*iter)->reset(data);
+  if (adaptivereorder) {
+    reordercountdown -= 1;
+    if (reordercountdown <= 0) {
+      reorderRules();
+      reordercountdown = reorder_period;
+    }
+  }
+}
+
+/// \brief Order rules by descending observed apply-rate
+///
+/// The rates are compared cross-multiplied so untested rules sort last
+/// without floating-point arithmetic.
+static bool compareRuleRate(Rule *a,Rule *b)
+
+{
+  return ((uint8)a->getNumApply() * b->getNumTests() > (uint8)b->getNumApply() * a->getNumTests());
+}
+
+/// Each per-opcode rule list is stably resorted so the rules most likely to
+/// fire are tested first.  The sort is stable, so rules with equal apply-rates
+/// keep their registration order, and it only runs between function
+/// transformations when no rule iteration is in flight.
+void ActionPool::reorderRules(void)
+
+{
+  for(int4 i=0;i<CPUI_MAX;++i)
+    stable_sort(perop[i].begin(),perop[i].end(),compareRuleRate);
+}
+
+void ActionPool::setAdaptiveReorder(bool val)
+
+{
+  adaptivereorder = val;
+  reordercountdown = reorder_period;
+}
+
+void ActionPool::setLocalityOrder(bool val)
+
+{
+  localityorder = val;
+  localorder.clear();
+  local_index = 0;
 }
 
 void ActionPool::resetStats(void)
@@ -971,6 +1369,15 @@ void ActionPool::printStatistics(ostream &s) const
     (*iter)->printStatistics(s);
 }
 
+void ActionPool::collectRules(vector<Rule *> &res)
+
+{
+  vector<Rule *>::const_iterator iter;
+
+  for(iter=allrules.begin();iter!=allrules.end();++iter)
+    res.push_back(*iter);
+}
+
 const char ActionDatabase::universalname[] = "universal";
 
 ActionDatabase::~ActionDatabase(void)
@@ -1026,6 +1433,33 @@ Action *ActionDatabase::setCurrent(const string &actname)
   return currentact;
 }
 
+/// The Action is specified by name and is derived from the \e universal action
+/// if it hasn't been already.  Unlike setCurrent(), the current root Action
+/// selection is left untouched, so a caller can run an alternate pipeline
+/// without disturbing other users of the database.
+/// \param actname is the name of the \e root Action
+/// \return the root Action
+Action *ActionDatabase::getRoot(const string &actname)
+
+{
+  return deriveAction(universalname,actname);
+}
+
+/// The Action is specified by name and is derived from the \e universal action
+/// if it hasn't been already.  A fresh copy of its tree is then cloned off and
+/// returned.  Unlike the registered instance, the copy is owned by the caller,
+/// so its mutable per-run state (status, apply counts, break points) is private
+/// and it can be applied without synchronizing against other users of the
+/// database.  The grouplists and registered instances remain shared.
+/// \param actname is the name of the \e root Action
+/// \return a new caller-owned copy of the root Action
+Action *ActionDatabase::cloneRoot(const string &actname)
+
+{
+  Action *act = deriveAction(universalname,actname);
+  return act->clone(getGroup(actname));
+}
+
 
 /// A particular group is either added or removed from the grouplist defining
 /// a particular \e root Action.  The \e root Action is then (re)derived from the universal
@@ -84,6 +84,7 @@ protected:
   uint4 flags;			///< Behavior properties
   uint4 count_tests;		///< Number of times apply() has been called
   uint4 count_apply;		///< Number of times apply() made changes
+  uint8 count_usec;		///< Accumulated wall-clock time spent in apply() (microseconds)
   string name;			///< Name of the action
   string basegroup;		///< Base group this action belongs to
   void issueWarning(Architecture *glb);	///< Warn that this Action has applied
@@ -99,7 +100,25 @@ public:
   virtual bool turnOffDebug(const string &nm);			///< Turn off debugging
 #endif
   virtual void printStatistics(ostream &s) const;		///< Dump statistics to stream
+  virtual void collectStatistics(vector<Action *> &res);	///< Flatten \b this hierarchy into a list
+  virtual void collectRules(vector<Rule *> &res);		///< Flatten the Rules in \b this hierarchy into a list
+  virtual void setAdaptiveReorder(bool val);			///< Toggle adaptive rule ordering in any pools under \b this
+  virtual void setLocalityOrder(bool val);			///< Toggle locality-aware worklist ordering in any pools under \b this
   int4 perform(Funcdata &data); 				///< Perform this action (if necessary)
+  static void startTimeout(uint4 max_ms);			///< Arm a deadline for perform() on the current thread
+  static void clearTimeout(void);				///< Disarm any deadline on the current thread
+  static bool timeoutExpired(void);				///< Has the current thread's deadline passed
+  static void setCancelCallback(bool (*cb)(void *),void *data);	///< Register an external cancel test for the current thread
+  static void clearCancelCallback(void);			///< Remove the current thread's cancel test
+  static bool isCancelled(void);				///< Does the current thread's cancel test fire
+  static bool isAborted(void);					///< Should perform() stop early (deadline or cancel)
+  static void setYieldCallback(void (*cb)(void *),void *data);	///< Register a between-actions yield point for the current thread
+  static void clearYieldCallback(void);				///< Remove the current thread's yield point
+  static void yieldPoint(void);					///< Invoke the current thread's yield point (if any)
+  static void enableProfiling(void);				///< Turn on statistical sampling of Action/Rule execution
+  static void disableProfiling(void);				///< Turn off statistical sampling
+  static void profileTick(void);				///< Advance the sampling clock (called by a watcher thread)
+  static void takeProfile(map<string,uint8> &res);		///< Copy out the accumulated sample counts
   bool setBreakPoint(uint4 tp,const string &specify);		///< Set a breakpoint on this action
   virtual void clearBreakPoints(void);				///< Clear all breakpoints set on \b this Action
   bool setWarning(bool val,const string &specify);		///< Set a warning on this action
@@ -110,6 +129,7 @@ public:
   uint4 getStatus(void) const { return status; }		///< Get the current status of \b this Action
   uint4 getNumTests(void) { return count_tests; }		///< Get the number of times apply() was invoked
   uint4 getNumApply(void) { return count_apply; }		///< Get the number of times apply() made changes
+  uint8 getElapsedUsec(void) { return count_usec; }		///< Get the accumulated apply() time in microseconds
   /// \brief Clone the Action
   ///
   /// If \b this Action is a member of one of the groups in the grouplist,
@@ -162,6 +182,10 @@ public:
   virtual bool turnOffDebug(const string &nm);
 #endif
   virtual void printStatistics(ostream &s) const;
+  virtual void collectStatistics(vector<Action *> &res);
+  virtual void collectRules(vector<Rule *> &res);
+  virtual void setAdaptiveReorder(bool val);
+  virtual void setLocalityOrder(bool val);
 };
 
 /// \brief Action which checks if restart (sub)actions have been generated
@@ -208,7 +232,11 @@ private:
   string basegroup;		///< Group to which \b this Rule belongs
   uint4 count_tests;		///< Number of times \b this Rule has attempted to apply
   uint4 count_apply;		///< Number of times \b this Rule has successfully been applied
+  uint8 count_nsec;		///< Cumulative nanoseconds spent inside applyOp()
+  int4 fastid;			///< Non-zero id if \b this Rule dispatches through ruleApplyFast()
   void issueWarning(Architecture *glb);	///< If enabled, print a warning that this Rule has been applied
+protected:
+  void setFastId(int4 val) { fastid = val; }	///< Register \b this Rule with the devirtualized fast path
 public:
   Rule(const string &g,uint4 fl,const string &nm);		///< Construct given group, properties name
   virtual ~Rule(void) {}					///< Destructor
@@ -216,6 +244,8 @@ public:
   const string &getGroup(void) const { return basegroup; }	///< Return the group \b this Rule belongs to
   uint4 getNumTests(void) { return count_tests; }		///< Get number of attempted applications
   uint4 getNumApply(void) { return count_apply; }		///< Get number of successful applications
+  int4 getFastId(void) const { return fastid; }			///< Get the fast-path dispatch id (0 for the virtual path)
+  uint8 getNanos(void) { return count_nsec; }			///< Get cumulative time spent applying, in nanoseconds
   void setBreak(uint4 tp) { breakpoint |= tp; }			///< Set a breakpoint on \b this Rule
   void clearBreak(uint4 tp) { breakpoint &= ~tp; }		///< Clear a breakpoint on \b this Rule
   void clearBreakPoints(void) { breakpoint = 0; }		///< Clear all breakpoints on \b this Rule
@@ -253,6 +283,20 @@ public:
 #endif
 };
 
+/// \brief Apply a Rule on the devirtualized fast path
+///
+/// The hottest rewrite rules are registered with a non-zero fast-path id (setFastId)
+/// and are dispatched through a single switch whose cases call the concrete applyOp()
+/// methods directly, letting the compiler inline the opcode guards and bodies.  The
+/// long tail of rules continues through the virtual applyOp() call.  The switch is
+/// defined with the rule implementations in ruleaction.cc.
+/// \param fastid is the fast-path id of the Rule
+/// \param rl is the Rule being applied
+/// \param op is the given PcodeOp where the Rule may apply
+/// \param data is the function to which to apply
+/// \return 1 if the Rule made changes, 0 otherwise
+extern int4 ruleApplyFast(int4 fastid,Rule *rl,PcodeOp *op,Funcdata &data);
+
 /// \brief A pool of Rules that apply simultaneously
 ///
 /// This class groups together a set of Rules as a formal Action.
@@ -264,9 +308,20 @@ class ActionPool : public Action {
   vector<Rule *> perop[CPUI_MAX];			///< Rules associated with each OpCode
   PcodeOpTree::const_iterator op_state; 		///< Current PcodeOp up for rule application
   int4 rule_index;					///< Iterator over Rules for one OpCode
+  bool adaptivereorder;					///< True if per-opcode lists reorder by observed apply-rate
+  int4 reordercountdown;				///< Function resets remaining until the next reorder
+  static const int4 reorder_period = 32;		///< Number of function resets between reorders
+  bool localityorder;					///< True if the worklist drains in (block, op-order) buckets
+  vector<PcodeOp *> localorder;				///< Snapshot of the ops in bucket order for the current pass
+  size_t local_index;					///< Position of the current pass within \b localorder
   int4 processOp(PcodeOp *op,Funcdata &data);		///< Apply the next possible Rule to a PcodeOp
+  int4 applyRules(PcodeOp *op,Funcdata &data);		///< Run the per-opcode rule list over one PcodeOp
+  void reorderRules(void);				///< Sort each per-opcode rule list by observed apply-rate
+  void buildLocalOrder(Funcdata &data);			///< Snapshot the ops of the function in (block, op-order) buckets
 public:
-  ActionPool(uint4 f,const string &nm) : Action(f,nm,"") {}	///< Construct providing properties and name
+  ActionPool(uint4 f,const string &nm) : Action(f,nm,"") {
+    adaptivereorder = false; reordercountdown = reorder_period;
+    localityorder = false; local_index = 0; }	///< Construct providing properties and name
   virtual ~ActionPool(void);				///< Destructor
   void addRule(Rule *rl);				///< Add a Rule to the pool
   virtual void clearBreakPoints(void);
@@ -278,6 +333,9 @@ public:
   virtual void printState(ostream &s) const;
   virtual Rule *getSubRule(const string &specify);
   virtual void printStatistics(ostream &s) const;
+  virtual void collectRules(vector<Rule *> &res);
+  virtual void setAdaptiveReorder(bool val);
+  virtual void setLocalityOrder(bool val);
 #ifdef OPACTION_DEBUG
   virtual bool turnOnDebug(const string &nm);
   virtual bool turnOffDebug(const string &nm);
@@ -314,6 +372,8 @@ public:
   const string &getCurrentName(void) const { return currentactname; }	///< Get the name of the current \e root Action
   const ActionGroupList &getGroup(const string &grp) const;	///< Get a specific grouplist by name
   Action *setCurrent(const string &actname);		///< Set the current \e root Action
+  Action *getRoot(const string &actname);		///< Get a \e root Action by name without making it current
+  Action *cloneRoot(const string &actname);		///< Build a caller-owned copy of a \e root Action
   Action *toggleAction(const string &grp,const string &basegrp,bool val);	///< Toggle a group of Actions with a \e root Action
 
   void setGroup(const string &grp,const char **argv);			///< Establish a new \e root Action
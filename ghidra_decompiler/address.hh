@@ -43,6 +43,30 @@ extern ElementId ELEM_REGISTER;		///< Marshaling element \<register>
 extern ElementId ELEM_SEQNUM;		///< Marshaling element \<seqnum>
 extern ElementId ELEM_VARNODE;		///< Marshaling element \<varnode>
 
+/// \brief A packed 128-bit sort key for an Address
+///
+/// The key holds the index of the address space in its high 64 bits and the
+/// byte offset in its low 64 bits, so containers keyed by address order their
+/// entries with plain integer comparisons on values already in the key, rather
+/// than invoking the multi-field Address comparator and chasing the space
+/// pointer on every probe.  Keys order exactly as Address::operator< orders,
+/// including the extremal addresses.  Build a key with Address::toKey().
+class AddrKey {
+  friend class Address;
+  uint8 hi;			///< Space index (+1), or an extremal marker
+  uint8 lo;			///< Byte offset within the space
+  AddrKey(uint8 h,uint8 l) { hi = h; lo = l; }	///< Construct from pre-packed halves
+public:
+  AddrKey(void) { hi = 0; lo = 0; }	///< Construct the minimal key
+  bool operator==(const AddrKey &op2) const { return ((hi==op2.hi)&&(lo==op2.lo)); }	///< Compare two keys for equality
+  bool operator!=(const AddrKey &op2) const { return ((hi!=op2.hi)||(lo!=op2.lo)); }	///< Compare two keys for inequality
+  /// Compare two keys with the natural ordering of their addresses
+  bool operator<(const AddrKey &op2) const {
+    if (hi != op2.hi) return (hi < op2.hi);
+    return (lo < op2.lo);
+  }
+};
+
 /// \brief A low-level machine address for labelling bytes and data.
 ///
 /// All data that can be manipulated within the processor reverse
@@ -79,6 +103,7 @@ public:
   AddrSpace *getSpace(void) const; ///< Get the address space
   uintb getOffset(void) const;  ///< Get the address offset
   char getShortcut(void) const;	///< Get the shortcut character for the address space
+  AddrKey toKey(void) const;	///< Get the packed integer sort key for \b this address
   Address &operator=(const Address &op2); ///< Copy an address
   bool operator==(const Address &op2) const; ///< Compare two addresses for equality
   bool operator!=(const Address &op2) const; ///< Compare two addresses for inequality
@@ -392,6 +417,19 @@ inline bool Address::operator<(const Address &op2) const {
   return false;
 }
 
+/// Pack the address into a single 128-bit key that sorts identically to the
+/// natural ordering of addresses.  Space indices are stored biased by one so
+/// an invalid (minimal) address packs below every real space and the maximal
+/// marker packs above.
+/// \return the packed sort key
+inline AddrKey Address::toKey(void) const {
+  if (base == (AddrSpace *)0)
+    return AddrKey(0,offset);
+  if (base == (AddrSpace *) ~((uintp)0))
+    return AddrKey(~((uint8)0),offset);
+  return AddrKey((uint8)base->getIndex() + 1,offset);
+}
+
 /// Do an ordering comparison of two addresses.
 /// \param op2 is the address to compare to
 /// \return \b true if \e this comes before or is equal to \e op2
@@ -16,6 +16,10 @@
 #include "analyzesigs.hh"
 #include "loadimage_bfd.hh"
 
+#include <atomic>
+#include <mutex>
+#include <thread>
+
 namespace ghidra {
 
 // Constructing this registers the capability
@@ -35,6 +39,7 @@ void IfaceAnalyzeSigsCapability::registerCommands(IfaceStatus *status)
   status->registerCom(new IfcSaveSignatures(),"save","signatures");
   status->registerCom(new IfcSaveAllSignatures(),"saveall","signatures");
   status->registerCom(new IfcProduceSignatures(),"produce","signatures");
+  status->registerCom(new IfcProduceSignaturesParallel(),"produceall","signatures");
 }
 
 /// \class IfcSignatureSettings
@@ -240,4 +245,117 @@ void IfcProduceSignatures::iterationCallback(Funcdata *fd)
   dcp->conf->clearAnalysis(fd);
 }
 
+/// \class IfcProduceSignaturesParallel
+/// \brief Calculate combined hashes for all functions on a thread pool: `produceall signatures <filename> [<numthreads>] [...]`
+///
+/// Parallel form of `produce signatures`.  Every known function entry point is decompiled
+/// (using the "normalize" action) and features are extracted and combined into an overall
+/// hash by a pool of worker threads, each with its own signature manager.  Output lines are
+/// buffered per function and written in address order, so the file matches what the serial
+/// command would produce.  The second parameter gives the number of worker threads (0 lets
+/// the machine decide), and any further parameters alter signature generation as with the
+/// serial command.
+void IfcProduceSignaturesParallel::execute(istream &s)
+
+{
+  if (dcp->conf == (Architecture *)0)
+    throw IfaceExecutionError("No architecture loaded");
+
+  string sigfilename;
+
+  s >> sigfilename;
+  if (sigfilename.size() == 0)
+    throw IfaceExecutionError("Need name of file to save signatures to");
+  int4 numthreads = 0;
+  s >> ws;
+  if (!s.eof())
+    s >> numthreads;
+  if (numthreads <= 0) {
+    numthreads = std::thread::hardware_concurrency();
+    if (numthreads <= 0)
+      numthreads = 1;
+  }
+  string sigconfig;		// Remaining configuration, replicated into each worker's manager
+  getline(s,sigconfig);
+
+  ofstream outfile(sigfilename.c_str());
+  if (!outfile)
+    throw IfaceExecutionError("Unable to open signature save file: "+sigfilename);
+
+  funclist.clear();
+  iterateFunctionsAddrOrder();	// Gather the functions in address order
+
+  string oldactname = dcp->conf->allacts.getCurrentName();
+  dcp->conf->allacts.setCurrent("normalize");
+
+  if (numthreads > (int4)funclist.size() && funclist.size() != 0)
+    numthreads = funclist.size();
+  vector<string> results(funclist.size());
+  std::atomic<int4> nextindex(0);
+  std::mutex archmutex;		// Serializes mutation of shared architecture state
+  vector<std::thread> pool;
+  for(int4 t=0;t<numthreads;++t) {
+    pool.emplace_back([this,&results,&nextindex,&archmutex,&sigconfig](void) {
+      GraphSigManager smanager;
+      istringstream cfgstream(sigconfig);
+      smanager.initializeFromStream(cfgstream);
+      Action *rootact;
+      {				// cloneRoot may derive and register the pipeline
+	std::lock_guard<std::mutex> lock(archmutex);
+	rootact = dcp->conf->allacts.cloneRoot("normalize");
+      }
+      for(;;) {
+	int4 idx = nextindex.fetch_add(1);
+	if (idx >= (int4)funclist.size()) break;
+	Funcdata *fd = funclist[idx];
+	if (fd->hasNoCode()) continue;
+	try {
+	  {			// Clearing old analysis touches shared symbol state
+	    std::lock_guard<std::mutex> lock(archmutex);
+	    dcp->conf->clearAnalysis(fd);
+	  }
+	  rootact->reset(*fd);
+	  rootact->perform(*fd);
+	}
+	catch(LowlevelError &err) {
+	  continue;		// Skip functions that fail to decompile, as the serial command does
+	}
+	smanager.setCurrentFunction(fd);
+	smanager.generate();
+	hashword finalsig = smanager.getOverallHash();
+	ostringstream line;
+	line << fd->getName() << " = 0x" << hex << setfill('0') << setw(16) << finalsig << '\n';
+	results[idx] = line.str();
+	smanager.clear();
+	{
+	  std::lock_guard<std::mutex> lock(archmutex);
+	  dcp->conf->clearAnalysis(fd);
+	}
+      }
+      delete rootact;
+    });
+  }
+  for(int4 t=0;t<numthreads;++t)
+    pool[t].join();
+
+  int4 signedcount = 0;
+  for(int4 i=0;i<(int4)funclist.size();++i) {
+    if (results[i].size() != 0)
+      signedcount += 1;
+    outfile << results[i];
+  }
+  outfile.close();
+
+  dcp->conf->allacts.setCurrent(oldactname);
+  *status->optr << "Signed " << dec << signedcount << " of " << funclist.size();
+  *status->optr << " functions using " << numthreads << " threads" << endl;
+  funclist.clear();
+}
+
+void IfcProduceSignaturesParallel::iterationCallback(Funcdata *fd)
+
+{
+  funclist.push_back(fd);	// Just collect the function; the worker pool does the processing
+}
+
 } // End namespace ghidra
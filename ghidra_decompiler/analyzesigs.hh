@@ -63,5 +63,12 @@ public:
   virtual void iterationCallback(Funcdata *fd);
 };
 
+class IfcProduceSignaturesParallel : public IfcProduceSignatures {
+  vector<Funcdata *> funclist;	///< Functions collected for the worker pool
+public:
+  virtual void execute(istream &s);
+  virtual void iterationCallback(Funcdata *fd);
+};
+
 } // End namespace ghidra
 #endif
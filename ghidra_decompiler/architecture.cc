@@ -17,6 +17,7 @@
 
 #include "coreaction.hh"
 #include "flow.hh"
+#include <thread>
 #ifdef CPUI_RULECOMPILE
 #include "rulecompile.hh"
 #endif
@@ -152,6 +153,7 @@ Architecture::Architecture(void)
 {
   //  endian = -1;
   resetDefaultsInternal();
+  valueset_iterations = 0;
   min_funcsymbol_size = 1;
   aggressive_ext_trim = false;
   funcptr_align = 0;
@@ -330,12 +332,15 @@ void Architecture::setDefaultModel(ProtoModel *model)
 }
 
 /// Throw out the syntax tree, (unlocked) symbols, comments, and other derived information
-/// about a single function.
+/// about a single function.  Artifacts that can be re-validated against the rebuilt
+/// data-flow -- recovered jump-table addresses and data-types resolved for unlocked
+/// Symbols -- can optionally be kept to re-seed the new analysis.
 /// \param fd is the function to clear
-void Architecture::clearAnalysis(Funcdata *fd)
+/// \param keepRecovered is \b true if re-validatable artifacts should be kept
+void Architecture::clearAnalysis(Funcdata *fd,bool keepRecovered)
 
 {
-  fd->clear();			// Clear stuff internal to function
+  fd->clear(keepRecovered);	// Clear stuff internal to function
   // Clear out any analysis generated comments
   commentdb->clearType(fd->getAddress(),Comment::warning|Comment::warningheader);
 }
@@ -495,6 +500,17 @@ void Architecture::restoreXml(DocumentStorage &store)
   if (el == (const Element *)0)
     throw LowlevelError("Could not find save_state tag");
   XmlDecode decoder(this,el);
+  restore(decoder);
+}
+
+/// The stream decoder may be backed by either the XML or the packed binary format;
+/// everything under the \<save_state> element marshals through the abstract
+/// Encoder/Decoder interface, so a state written with PackedEncode restores here
+/// without ever building a document tree.
+/// \param decoder is the stream decoder positioned at the \<save_state> element
+void Architecture::restore(Decoder &decoder)
+
+{
   uint4 elemId = decoder.openElement(ELEM_SAVE_STATE);
   loadersymbols_parsed = false;
   for(;;) {
@@ -618,14 +634,14 @@ void Architecture::postSpecFile(void)
   cacheAddrSpaceProperties();
 }
 
-/// Once the processor is known, the Translate object can be built and
-/// fully initialized. Processor and compiler specific configuration is performed
+/// Configure the Architecture around a Translate object whose tables have
+/// already been decoded (init() builds and initializes it on a worker thread).
+/// Processor and compiler specific configuration is performed
 /// \param store will hold parsed configuration information
-void Architecture::restoreFromSpec(DocumentStorage &store)
+/// \param newtrans is the fully decoded Translate object to adopt
+void Architecture::restoreFromSpec(DocumentStorage &store,Translate *newtrans)
 
 {
-  Translate *newtrans = buildTranslator(store); // Once language is described we can build translator
-  newtrans->initialize(store);
   translate = newtrans;
   modifySpaces(newtrans);	// Give architecture chance to modify spaces, before copying
   copySpaces(newtrans);
@@ -1393,16 +1409,35 @@ void Architecture::init(DocumentStorage &store)
 {
   buildLoader(store);		// Loader is built first
   resolveArchitecture();
+  buildContext(store);		// Trivial, but the translator needs it below
   buildSpecFile(store);
 
-  buildContext(store);
+  // Decoding the translator tables is the longest single stage of a cold
+  // start and depends only on the <sleigh> tag registered above, so it
+  // runs on a worker thread while the analysis containers are built here.
+  // Configuration parsing (restoreFromSpec) needs both and joins first.
+  Translate *newtrans = (Translate *)0;
+  string transerror;
+  std::thread transthread([this,&store,&newtrans,&transerror]() {
+    try {
+      newtrans = buildTranslator(store);
+      newtrans->initialize(store);
+    }
+    catch(LowlevelError &err) {
+      transerror = err.explain;
+    }
+  });
+
   buildTypegrp(store);
   buildCommentDB(store);
   buildStringManager(store);
   buildConstantPool(store);
   buildDatabase(store);
 
-  restoreFromSpec(store);
+  transthread.join();
+  if (!transerror.empty())
+    throw LowlevelError(transerror);
+  restoreFromSpec(store,newtrans);
   buildCoreTypes(store);
   print->initializeFromArchitecture();
   symboltab->adjustCaches();	// In case the specs created additional address spaces
@@ -1422,6 +1457,9 @@ void Architecture::resetDefaultsInternal(void)
   max_basetype_size = 10;	// Needs to be 8 or bigger
   flowoptions = FlowInfo::error_toomanyinstructions;
   max_instructions = 100000;
+  valueset_maxiter = 10000;	// Matches the historically hard-coded budget
+  valueset_wideniter = 2;
+  valueset_fulliter = 5;
   infer_pointers = true;
   analyze_for_loops = true;
   readonlypropagate = false;
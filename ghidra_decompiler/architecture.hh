@@ -185,6 +185,10 @@ public:
   uint4 max_instructions;	///< Maximum instructions that can be processed in one function
   int4 alias_block_level;	///< Aliases blocked by 0=none, 1=struct, 2=array, 3=all
   uint4 split_datatype_config;	///< Toggle for data-types splitting: Bit 0=structs, 1=arrays, 2=pointers
+  int4 valueset_maxiter;	///< Maximum value set solver iterations during LOAD/STORE guard analysis
+  int4 valueset_wideniter;	///< Value set iteration at which widening is first attempted
+  int4 valueset_fulliter;	///< Value set iteration at which widening jumps to the full range
+  uint8 valueset_iterations;	///< Accumulated value set solver iterations (for performance monitoring)
   vector<Rule *> extra_pool_rules; ///< Extra rules that go in the main pool (cpu specific, experimental)
 
   Database *symboltab;		///< Memory map of global variables and functions
@@ -229,7 +233,7 @@ public:
   const LanedRegister *getLanedRegister(const Address &loc,int4 size) const;	///< Get LanedRegister associated with storage
   int4 getMinimumLanedRegisterSize(void) const;		///< Get the minimum size of a laned register in bytes
   void setDefaultModel(ProtoModel *model);		///< Set the default PrototypeModel
-  void clearAnalysis(Funcdata *fd);			///< Clear analysis specific to a function
+  void clearAnalysis(Funcdata *fd,bool keepRecovered=false);	///< Clear analysis specific to a function
   void readLoaderSymbols(const string &delim);		 ///< Read any symbols from loader into database
   void collectBehaviors(vector<OpBehavior *> &behave) const;	///< Provide a list of OpBehavior objects
   SegmentOp *getSegmentOp(AddrSpace *spc) const;	///< Retrieve the \e segment op for the given space if any
@@ -250,6 +254,7 @@ public:
   virtual void printMessage(const string &message) const=0;
   virtual void encode(Encoder &encoder) const;		///< Encode \b this architecture to a stream
   virtual void restoreXml(DocumentStorage &store);	///< Restore the Architecture state from XML documents
+  void restore(Decoder &decoder);	///< Restore the Architecture state from a \<save_state> element
   virtual void nameFunction(const Address &addr,string &name) const;	///< Pick a default name for a function
 #ifdef OPACTION_DEBUG
   void setDebugStream(ostream *s) { debugstream = s; }	///< Establish the debug console stream
@@ -347,7 +352,7 @@ protected:
 
   virtual void resolveArchitecture(void)=0;	///< Figure out the processor and compiler of the target executable
 
-  void restoreFromSpec(DocumentStorage &store);		///< Fully initialize the Translate object
+  void restoreFromSpec(DocumentStorage &store,Translate *newtrans);	///< Fully initialize the given Translate object
   void fillinReadOnlyFromLoader(void);			///< Load info about read-only sections
   void initializeSegments();				///< Set up segment resolvers
   void cacheAddrSpaceProperties(void);			///< Calculate some frequently used space properties and cache them
@@ -0,0 +1,487 @@
+/**
+ * Ghidra Decompiler Corpus Benchmark
+ *
+ * Loads every binary in a corpus directory through the same
+ * ServerArchitecture/LoadImage path the gRPC server uses, runs the code
+ * discovery sweep, decompiles every recovered function, and reports
+ * throughput (functions/sec), per-function latency percentiles, and
+ * per-phase timing plus peak RSS.  Results can be written as JSON so runs
+ * are diffable across releases:
+ *
+ *     ghidra_bench --corpus <dir> [--lang <id>] [--base <hex>]
+ *                  [--threads <n>] [--timeout <ms>] [--json <file>]
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "libdecomp.hh"
+#include "sleigh_arch.hh"
+#include "codedata.hh"
+#include "action.hh"
+#include "server_arch.hh"
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+// Peak resident set size of the process so far, in kilobytes (0 where the
+// platform doesn't expose it). The value is monotonic, so sampling it after
+// each phase shows which phase first pushed memory to its high-water mark.
+static uint64_t peakRssKb() {
+#ifdef _WIN32
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#ifdef __APPLE__
+    return static_cast<uint64_t>(usage.ru_maxrss) / 1024;  // Reported in bytes
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss);         // Reported in KB
+#endif
+#endif
+}
+
+static double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start).count();
+}
+
+// Timing and memory results for one binary of the corpus
+struct BinaryResult {
+    std::string file;
+    uint64_t functions = 0;
+    uint64_t failures = 0;
+    double load_ms = 0.0;       // Loader construction + architecture init
+    double discovery_ms = 0.0;  // Code/data discovery sweep
+    double decompile_ms = 0.0;  // Sum of per-function decompilation
+    uint64_t rss_load_kb = 0;   // Peak RSS after each phase
+    uint64_t rss_discovery_kb = 0;
+    uint64_t rss_decompile_kb = 0;
+};
+
+struct BenchConfig {
+    std::string corpus_dir;
+    std::string lang_id = "x86:LE:64:default";
+    std::string json_path;
+    uint64_t base_address = 0;
+    unsigned sweep_threads = 0;  // 0 = hardware concurrency
+    uint32_t timeout_ms = 0;     // Per-function decompile deadline; 0 = none
+};
+
+// Run one binary through load, discovery, and full decompilation, appending
+// each function's decompile latency (in microseconds) to latencies_us
+static BinaryResult benchBinary(const BenchConfig& config, const std::string& path,
+                                std::vector<double>& latencies_us) {
+    BinaryResult result;
+    result.file = path;
+
+    auto t0 = std::chrono::steady_clock::now();
+    // Heap-allocated: the architecture takes ownership and deletes the
+    // loader in ~Architecture
+    MmapLoadImage* loader = new MmapLoadImage(path, config.base_address);
+    ServerArchitecture arch(config.lang_id, loader, &std::cerr);
+    DocumentStorage store;
+    arch.init(store);
+    loader->setCodeSpace(arch.getDefaultCodeSpace());
+    result.load_ms = elapsedMs(t0);
+    result.rss_load_kb = peakRssKb();
+
+    // Discovery sweep: same path AnalyzeBinary uses to find entry points
+    t0 = std::chrono::steady_clock::now();
+    CodeDataAnalysis codedata;
+    codedata.init(&arch);
+    unsigned sweep_threads = config.sweep_threads;
+    if (sweep_threads == 0)
+        sweep_threads = std::thread::hardware_concurrency();
+    codedata.runModel(sweep_threads == 0 ? 1 : (int)sweep_threads);
+    std::set<uint64_t> starts;
+    for (const auto& entry : codedata.tofrom_crossref) {
+        if ((entry.second & CodeUnit::call) != 0)
+            starts.insert(entry.first.a.getOffset());
+    }
+    for (const auto& addr : codedata.unlinkedstarts)
+        starts.insert(addr.getOffset());
+    result.discovery_ms = elapsedMs(t0);
+    result.rss_discovery_kb = peakRssKb();
+
+    // Decompile every recovered function with the default action pipeline
+    Scope* global_scope = arch.symboltab->getGlobalScope();
+    Action* rootact = arch.allacts.getCurrent();
+    for (uint64_t start : starts) {
+        Address func_addr(arch.getDefaultCodeSpace(), start);
+        std::ostringstream fname;
+        fname << "func_" << std::hex << start;
+        auto f0 = std::chrono::steady_clock::now();
+        Funcdata* fd = nullptr;
+        try {
+            fd = global_scope->findFunction(func_addr);
+            if (fd == nullptr)
+                fd = global_scope->addFunction(func_addr, fname.str())->getFunction();
+            if (config.timeout_ms != 0)
+                Action::startTimeout(config.timeout_ms);
+            rootact->reset(*fd);
+            int4 res = rootact->perform(*fd);
+            Action::clearTimeout();
+            if (res < 0) {
+                result.failures += 1;
+            } else {
+                result.functions += 1;
+                latencies_us.push_back(elapsedMs(f0) * 1000.0);
+            }
+            arch.clearAnalysis(fd);  // Keep per-binary memory bounded
+        } catch (const LowlevelError& e) {
+            Action::clearTimeout();
+            result.failures += 1;
+            if (fd != nullptr)
+                arch.clearAnalysis(fd);  // Failed decompiles retain state too
+        }
+    }
+    result.decompile_ms = elapsedMs(t0) - result.discovery_ms;
+    result.rss_decompile_kb = peakRssKb();
+    return result;
+}
+
+static double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty())
+        return 0.0;
+    size_t idx = static_cast<size_t>(p * (sorted.size() - 1));
+    return sorted[idx];
+}
+
+static void writeJson(std::ostream& s, const BenchConfig& config,
+                      const std::vector<BinaryResult>& results,
+                      const std::vector<double>& sorted_us,
+                      double total_decompile_sec) {
+    uint64_t functions = 0, failures = 0;
+    uint64_t rss_load = 0, rss_discovery = 0, rss_decompile = 0;
+    for (const auto& r : results) {
+        functions += r.functions;
+        failures += r.failures;
+        rss_load = std::max(rss_load, r.rss_load_kb);
+        rss_discovery = std::max(rss_discovery, r.rss_discovery_kb);
+        rss_decompile = std::max(rss_decompile, r.rss_decompile_kb);
+    }
+    double fps = total_decompile_sec > 0.0 ? functions / total_decompile_sec : 0.0;
+    s << "{\n";
+    s << "  \"corpus\": \"" << config.corpus_dir << "\",\n";
+    s << "  \"language\": \"" << config.lang_id << "\",\n";
+    s << "  \"binaries\": " << results.size() << ",\n";
+    s << "  \"functions\": " << functions << ",\n";
+    s << "  \"failures\": " << failures << ",\n";
+    s << "  \"functions_per_sec\": " << fps << ",\n";
+    s << "  \"latency_us\": { \"p50\": " << percentile(sorted_us, 0.50)
+      << ", \"p99\": " << percentile(sorted_us, 0.99) << " },\n";
+    s << "  \"peak_rss_kb\": { \"load\": " << rss_load
+      << ", \"discovery\": " << rss_discovery
+      << ", \"decompile\": " << rss_decompile << " },\n";
+    s << "  \"per_binary\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BinaryResult& r = results[i];
+        s << "    { \"file\": \"" << r.file << "\", \"functions\": " << r.functions
+          << ", \"failures\": " << r.failures
+          << ", \"load_ms\": " << r.load_ms
+          << ", \"discovery_ms\": " << r.discovery_ms
+          << ", \"decompile_ms\": " << r.decompile_ms << " }"
+          << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    s << "  ]\n";
+    s << "}\n";
+}
+
+// Fixed corpus of raw x86-64 instruction bytes for the decode
+// microbenchmark: a representative mix of stack setup, memory addressing,
+// ALU, short branches, REX-prefixed wide operations, movabs, and scalar
+// SSE.  Decode throughput over a fixed byte stream isolates the Sleigh
+// decision-tree and pattern-matching layer from the rest of decompilation.
+static const uint1 decode_corpus[] = {
+    0x55,                                                        // push rbp
+    0x48, 0x89, 0xe5,                                            // mov rbp,rsp
+    0x48, 0x83, 0xec, 0x20,                                      // sub rsp,0x20
+    0x89, 0x7d, 0xec,                                            // mov [rbp-0x14],edi
+    0x48, 0x89, 0x75, 0xe0,                                      // mov [rbp-0x20],rsi
+    0xc7, 0x45, 0xfc, 0x00, 0x00, 0x00, 0x00,                    // mov dword [rbp-4],0
+    0xeb, 0x1c,                                                  // jmp short
+    0x8b, 0x45, 0xfc,                                            // mov eax,[rbp-4]
+    0x48, 0x98,                                                  // cdqe
+    0x48, 0x8d, 0x14, 0xc5, 0x00, 0x00, 0x00, 0x00,              // lea rdx,[rax*8]
+    0x48, 0x8b, 0x45, 0xe0,                                      // mov rax,[rbp-0x20]
+    0x48, 0x01, 0xd0,                                            // add rax,rdx
+    0x48, 0x8b, 0x00,                                            // mov rax,[rax]
+    0x48, 0x85, 0xc0,                                            // test rax,rax
+    0x74, 0x04,                                                  // je short
+    0x83, 0x45, 0xfc, 0x01,                                      // add dword [rbp-4],1
+    0x8b, 0x45, 0xfc,                                            // mov eax,[rbp-4]
+    0x3b, 0x45, 0xec,                                            // cmp eax,[rbp-0x14]
+    0x7c, 0xdc,                                                  // jl short
+    0x8b, 0x45, 0xfc,                                            // mov eax,[rbp-4]
+    0x48, 0x83, 0xc4, 0x20,                                      // add rsp,0x20
+    0x5d,                                                        // pop rbp
+    0xc3,                                                        // ret
+    0x66, 0x0f, 0x1f, 0x44, 0x00, 0x00,                          // nop word [rax+rax]
+    0xf3, 0x0f, 0x10, 0x07,                                      // movss xmm0,[rdi]
+    0xf3, 0x0f, 0x58, 0x06,                                      // addss xmm0,[rsi]
+    0xf3, 0x0f, 0x11, 0x07,                                      // movss [rdi],xmm0
+    0x31, 0xc0,                                                  // xor eax,eax
+    0xc3,                                                        // ret
+    0x48, 0xb8, 0xef, 0xbe, 0xad, 0xde, 0xef, 0xbe, 0xad, 0xde,  // movabs rax,imm64
+    0x48, 0xc1, 0xe8, 0x08,                                      // shr rax,8
+    0x48, 0x0f, 0xaf, 0xc0,                                      // imul rax,rax
+    0x0f, 0xb6, 0x0f,                                            // movzx ecx,byte [rdi]
+    0x0f, 0xbe, 0x57, 0x01,                                      // movsx edx,byte [rdi+1]
+    0x41, 0x54,                                                  // push r12
+    0x45, 0x31, 0xe4,                                            // xor r12d,r12d
+    0x41, 0x5c,                                                  // pop r12
+    0xe8, 0x00, 0x00, 0x00, 0x00,                                // call rel32
+    0xc3                                                         // ret
+};
+
+// Discards disassembly output; the benchmark measures decode, not printing
+class NullAssemblyEmit : public AssemblyEmit {
+public:
+    virtual void dump(const Address& addr, const std::string& mnem,
+                      const std::string& body) override {}
+};
+
+// Discards emitted p-code ops
+class NullPcodeEmit : public PcodeEmit {
+public:
+    virtual void dump(const Address& addr, OpCode opc, VarnodeData* outvar,
+                      VarnodeData* vars, int4 isize) override {}
+};
+
+// Decode the embedded corpus end to end `reps` times through both decode
+// entry points, reporting instructions/sec for each and the hit rate of
+// the DisassemblyCache
+static int runDecodeBench(const BenchConfig& config, int reps) {
+    std::string bytes(reinterpret_cast<const char*>(decode_corpus),
+                      sizeof(decode_corpus));
+    uint64_t base = config.base_address != 0 ? config.base_address : 0x100000;
+    // Heap-allocated: owned and deleted by ~Architecture
+    MemoryLoadImage* loader = new MemoryLoadImage(bytes, base);
+    ServerArchitecture arch(config.lang_id, loader, &std::cerr);
+    DocumentStorage store;
+    arch.init(store);
+    loader->setCodeSpace(arch.getDefaultCodeSpace());
+    AddrSpace* space = arch.getDefaultCodeSpace();
+    uint64_t end = base + sizeof(decode_corpus);
+
+    // Assembly pass: decode + operand formatting
+    NullAssemblyEmit asm_emit;
+    uint64_t asm_count = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        uint64_t off = base;
+        while (off < end) {
+            int4 len;
+            try {
+                len = arch.translate->printAssembly(asm_emit, Address(space, off));
+            } catch (const LowlevelError&) {
+                len = 1;  // Skip an undecodable byte (shouldn't happen on this corpus)
+            }
+            off += (len > 0) ? len : 1;
+            asm_count += 1;
+        }
+    }
+    double asm_sec = elapsedMs(t0) / 1000.0;
+
+    // P-code pass: decode + semantic template expansion
+    NullPcodeEmit pcode_emit;
+    uint64_t pcode_count = 0;
+    t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        uint64_t off = base;
+        while (off < end) {
+            int4 len;
+            try {
+                len = arch.translate->oneInstruction(pcode_emit, Address(space, off));
+            } catch (const LowlevelError&) {
+                len = 1;
+            }
+            off += (len > 0) ? len : 1;
+            pcode_count += 1;
+        }
+    }
+    double pcode_sec = elapsedMs(t0) / 1000.0;
+
+    uint64_t hits = 0, misses = 0;
+    const Sleigh* sleigh = dynamic_cast<const Sleigh*>(arch.translate);
+    if (sleigh != nullptr)
+        sleigh->getCacheStats(hits, misses);
+    double hit_rate = (hits + misses) > 0
+        ? static_cast<double>(hits) / static_cast<double>(hits + misses) : 0.0;
+
+    double asm_ips = asm_sec > 0.0 ? asm_count / asm_sec : 0.0;
+    double pcode_ips = pcode_sec > 0.0 ? pcode_count / pcode_sec : 0.0;
+    std::cout << "[Bench] decode corpus: " << sizeof(decode_corpus)
+              << " bytes x " << reps << " reps (" << config.lang_id << ")" << std::endl;
+    std::cout << "[Bench] printAssembly:  " << asm_count << " instructions, "
+              << static_cast<uint64_t>(asm_ips) << " inst/sec" << std::endl;
+    std::cout << "[Bench] oneInstruction: " << pcode_count << " instructions, "
+              << static_cast<uint64_t>(pcode_ips) << " inst/sec" << std::endl;
+    std::cout << "[Bench] DisassemblyCache: " << hits << " hits, " << misses
+              << " misses (" << hit_rate * 100.0 << "% hit rate)" << std::endl;
+
+    if (!config.json_path.empty()) {
+        std::ofstream json(config.json_path.c_str());
+        if (!json) {
+            std::cerr << "ghidra_bench: cannot write " << config.json_path << std::endl;
+            return 1;
+        }
+        json << "{\n";
+        json << "  \"language\": \"" << config.lang_id << "\",\n";
+        json << "  \"corpus_bytes\": " << sizeof(decode_corpus) << ",\n";
+        json << "  \"reps\": " << reps << ",\n";
+        json << "  \"asm_inst_per_sec\": " << asm_ips << ",\n";
+        json << "  \"pcode_inst_per_sec\": " << pcode_ips << ",\n";
+        json << "  \"cache_hits\": " << hits << ",\n";
+        json << "  \"cache_misses\": " << misses << ",\n";
+        json << "  \"cache_hit_rate\": " << hit_rate << "\n";
+        json << "}\n";
+        std::cout << "[Bench] JSON written to " << config.json_path << std::endl;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    BenchConfig config;
+    bool decode_bench = false;
+    int decode_reps = 10000;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg(argv[i]);
+        if (arg == "--corpus" && i + 1 < argc) {
+            config.corpus_dir = argv[++i];
+        } else if (arg == "--decode") {
+            decode_bench = true;
+        } else if (arg == "--reps" && i + 1 < argc) {
+            decode_reps = atoi(argv[++i]);
+        } else if (arg == "--lang" && i + 1 < argc) {
+            config.lang_id = argv[++i];
+        } else if (arg == "--json" && i + 1 < argc) {
+            config.json_path = argv[++i];
+        } else if (arg == "--base" && i + 1 < argc) {
+            config.base_address = strtoull(argv[++i], nullptr, 16);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            config.sweep_threads = static_cast<unsigned>(atoi(argv[++i]));
+        } else if (arg == "--timeout" && i + 1 < argc) {
+            config.timeout_ms = static_cast<uint32_t>(atoi(argv[++i]));
+        } else {
+            std::cerr << "Usage: ghidra_bench --corpus <dir> [--lang <id>] "
+                         "[--base <hex>] [--threads <n>] [--timeout <ms>] "
+                         "[--json <file>]\n"
+                         "       ghidra_bench --decode [--reps <n>] [--lang <id>] "
+                         "[--json <file>]" << std::endl;
+            return 1;
+        }
+    }
+    if (config.corpus_dir.empty() && !decode_bench) {
+        std::cerr << "ghidra_bench: --corpus (or --decode) is required" << std::endl;
+        return 1;
+    }
+
+    // Locate the languages directory the same way the server does
+    std::string exeDir = getExecutableDir();
+    std::vector<std::pair<std::string, std::string>> searchPaths = {
+        {exeDir + "/../../ghidra_decompiler", exeDir + "/../../ghidra_decompiler/languages"},
+        {exeDir + "/../ghidra_decompiler", exeDir + "/../ghidra_decompiler/languages"},
+        {exeDir, exeDir + "/languages"}
+    };
+    std::string baseDir, langDir;
+    for (const auto& paths : searchPaths) {
+        std::vector<std::string> hits;
+        FileManage::matchListDir(hits, "x86.ldefs", true, paths.second, false);
+        if (!hits.empty()) {
+            baseDir = paths.first;
+            langDir = paths.second;
+            break;
+        }
+    }
+    if (langDir.empty()) {
+        std::cerr << "ghidra_bench: could not find languages directory near "
+                  << exeDir << std::endl;
+        return 1;
+    }
+    startDecompilerLibrary(baseDir.c_str());
+    SleighArchitecture::specpaths.addDir2Path(langDir);
+    try {
+        SleighArchitecture::getDescriptions();
+    } catch (const LowlevelError& e) {
+        std::cerr << "ghidra_bench: " << e.explain << std::endl;
+    }
+
+    if (decode_bench) {
+        int ret;
+        try {
+            ret = runDecodeBench(config, decode_reps);
+        } catch (const LowlevelError& e) {
+            std::cerr << "ghidra_bench: " << e.explain << std::endl;
+            ret = 1;
+        }
+        shutdownDecompilerLibrary();
+        return ret;
+    }
+
+    std::vector<std::string> corpus;
+    FileManage::matchListDir(corpus, "", true, config.corpus_dir, false);
+    std::sort(corpus.begin(), corpus.end());
+    if (corpus.empty()) {
+        std::cerr << "ghidra_bench: no files in corpus " << config.corpus_dir << std::endl;
+        return 1;
+    }
+
+    std::vector<BinaryResult> results;
+    std::vector<double> latencies_us;
+    double total_decompile_sec = 0.0;
+    for (const std::string& path : corpus) {
+#ifndef _WIN32
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+            continue;  // Skip subdirectories and special files
+#endif
+        std::cout << "[Bench] " << path << std::endl;
+        try {
+            BinaryResult r = benchBinary(config, path, latencies_us);
+            total_decompile_sec += r.decompile_ms / 1000.0;
+            std::cout << "[Bench]   " << r.functions << " functions, "
+                      << r.failures << " failures, load " << r.load_ms
+                      << " ms, discovery " << r.discovery_ms
+                      << " ms, decompile " << r.decompile_ms << " ms" << std::endl;
+            results.push_back(std::move(r));
+        } catch (const LowlevelError& e) {
+            std::cerr << "[Bench] Skipping " << path << ": " << e.explain << std::endl;
+        }
+    }
+
+    std::sort(latencies_us.begin(), latencies_us.end());
+    uint64_t functions = 0;
+    for (const auto& r : results)
+        functions += r.functions;
+    double fps = total_decompile_sec > 0.0 ? functions / total_decompile_sec : 0.0;
+    std::cout << "[Bench] " << results.size() << " binaries, " << functions
+              << " functions, " << fps << " functions/sec" << std::endl;
+    std::cout << "[Bench] latency p50 " << percentile(latencies_us, 0.50)
+              << " us, p99 " << percentile(latencies_us, 0.99) << " us" << std::endl;
+    std::cout << "[Bench] peak RSS " << peakRssKb() << " KB" << std::endl;
+
+    if (!config.json_path.empty()) {
+        std::ofstream json(config.json_path.c_str());
+        if (!json) {
+            std::cerr << "ghidra_bench: cannot write " << config.json_path << std::endl;
+            return 1;
+        }
+        writeJson(json, config, results, latencies_us, total_decompile_sec);
+        std::cout << "[Bench] JSON written to " << config.json_path << std::endl;
+    }
+
+    shutdownDecompilerLibrary();
+    return 0;
+}
@@ -58,6 +58,42 @@ void BlockEdge::decode(Decoder &decoder,BlockMap &resolver)
   decoder.closeElement(elemId);
 }
 
+/// Capacity is doubled and the existing edges are copied over.  Once the edges have
+/// spilled out of the inline storage, they never move back.
+void EdgeList::enlarge(void)
+
+{
+  int4 newCap = capacity * 2;
+  BlockEdge *newEdges = new BlockEdge[newCap];
+  for(int4 i=0;i<count;++i)
+    newEdges[i] = edges[i];
+  if (edges != inlineStore)
+    delete [] edges;
+  edges = newEdges;
+  capacity = newCap;
+}
+
+EdgeList::EdgeList(const EdgeList &op2)
+
+{
+  edges = inlineStore;
+  count = 0;
+  capacity = INLINE_MAX;
+  *this = op2;
+}
+
+EdgeList &EdgeList::operator=(const EdgeList &op2)
+
+{
+  if (this == &op2) return *this;
+  while(capacity < op2.count)
+    enlarge();
+  count = op2.count;
+  for(int4 i=0;i<count;++i)
+    edges[i] = op2.edges[i];
+  return *this;
+}
+
 FlowBlock::FlowBlock(void)
 
 {
@@ -265,10 +301,10 @@ void FlowBlock::markLabelBumpUp(bool bump)
 
 /// Block references are updated using the getCopyMap() reference on the original block
 /// \param vec is the list of edges whose block references should be updated
-void FlowBlock::replaceEdgeMap(vector<BlockEdge> &vec)
+void FlowBlock::replaceEdgeMap(EdgeList &vec)
 
 {
-  vector<BlockEdge>::iterator iter;
+  EdgeList::iterator iter;
 
   for(iter=vec.begin();iter!=vec.end();++iter)
     (*iter).point = (*iter).point->getCopyMap();
@@ -504,10 +540,10 @@ void FlowBlock::eliminateOutDups(FlowBlock *bl)
 ///
 /// \param ref is the list of BlockEdges to search
 /// \param duplist will contain the list of blocks with duplicate edges
-void FlowBlock::findDups(const vector<BlockEdge> &ref,vector<FlowBlock *> &duplist)
+void FlowBlock::findDups(const EdgeList &ref,vector<FlowBlock *> &duplist)
 
 {
-  vector<BlockEdge>::const_iterator iter;
+  EdgeList::const_iterator iter;
 
   for(iter=ref.begin();iter!=ref.end();++iter) {
     if (((*iter).point->flags&f_mark2)!=0) continue; // Already marked as a duplicate
@@ -1944,91 +1980,142 @@ void BlockGraph::clearVisitCount(void)
     list[i]->visitcount = 0;
 }
 
+/// \brief Find the minimal semidominator label on the linked ancestor path of a vertex
+///
+/// The EVAL half of the Lengauer-Tarjan eval/link structure, with iterative path
+/// compression so deeply linear graphs don't overflow the call stack.
+/// \param v is the pre-order number of the vertex to evaluate
+/// \param ancestor gives the (compressed) linked ancestor of each vertex
+/// \param label holds the minimal semidominator representative of each vertex
+/// \param semi holds the semidominator (as a pre-order number) of each vertex
+/// \return the pre-order number of the representative vertex
+static int4 evalSemi(int4 v,vector<int4> &ancestor,vector<int4> &label,const vector<int4> &semi)
+
+{
+  if (ancestor[v] == -1) return v;	// Vertex has not been linked yet
+  vector<int4> path;
+  int4 t = v;
+  while(ancestor[ancestor[t]] != -1) {	// Collect the path to the deepest linked ancestor
+    path.push_back(t);
+    t = ancestor[t];
+  }
+  for(int4 i=path.size()-1;i>=0;--i) {	// Compress from the top of the path down
+    t = path[i];
+    int4 anc = ancestor[t];
+    if (semi[label[anc]] < semi[label[t]])
+      label[t] = label[anc];
+    ancestor[t] = ancestor[anc];
+  }
+  return label[v];
+}
+
 /// Calculate the immediate dominator for each FlowBlock node in \b this BlockGraph,
 /// for forward control-flow.
 /// The algorithm must be provided a list of entry points for the graph.
-/// We assume the blocks are in reverse post-order and this is reflected in the index field.
-/// Using an algorithm by Cooper, Harvey, and Kennedy.
-/// Softw. Pract. Exper. 2001; 4: 1-10
+/// Using the semi-NCA variant of Lengauer-Tarjan, which runs in near-linear time
+/// regardless of how irreducible the graph is:
+/// Georgiadis, Tarjan, and Werneck, "Finding Dominators in Practice",
+/// J. Graph Algorithms Appl. 2006; 10: 69-94
 /// \param rootlist is the list of entry point FlowBlocks
 void BlockGraph::calcForwardDominator(const vector<FlowBlock *> &rootlist)
 
 {
-  vector<FlowBlock *> postorder;
   FlowBlock *virtualroot;
-  FlowBlock *b,*new_idom,*rho;
-  bool changed;
-  int4 i,j,finger1,finger2;
+  FlowBlock *startbl;
+  int4 i,j;
 
   if (list.empty()) return;
-  int4 numnodes = list.size()-1;
-  postorder.resize(list.size());
-  for(i=0;i<list.size();++i) {
+  int4 size = list.size();
+  for(i=0;i<size;++i)
     list[i]->immed_dom = (FlowBlock *)0; // Clear the dominator field
-    postorder[ numnodes-i ] = list[i]; // Construct a forward post order list
-  }
+  virtualroot = (FlowBlock *)0;
+  startbl = list[0];		// The official start node
   if (rootlist.size() > 1) {
     virtualroot = createVirtualRoot(rootlist);
-    postorder.push_back(virtualroot);
+    startbl = virtualroot;
   }
-  else
-    virtualroot = (FlowBlock *)0;
-
-  b = postorder.back();		// The official start node
-  if (b->sizeIn() != 0) {	// Root node must have no in edges
-    if ((rootlist.size() != 1)||(rootlist[0] != b))
+  else if (startbl->sizeIn() != 0) {	// Root node must have no in edges
+    if ((rootlist.size() != 1)||(rootlist[0] != startbl))
       throw LowlevelError("Problems finding root node of graph");
     virtualroot = createVirtualRoot(rootlist); // Create virtual root with no in edges
-    postorder.push_back(virtualroot);
-    b = virtualroot;
-  }
-  b->immed_dom = b;
-  for(i=0;i<b->sizeOut();++i)	// Fill in dom of nodes which start immediately
-    b->getOut(i)->immed_dom = b;	// connects to (to deal with possible artificial edge)
-  changed = true;
-  new_idom = (FlowBlock *)0;
-  while(changed) {
-    changed = false;
-    for(i=postorder.size()-2;i>=0;--i) { // For all nodes, in reverse post-order, except root
-      b = postorder[i];
-      if (b->immed_dom != postorder.back()) {
-	for(j=0;j<b->sizeIn();++j) { // Find first processed node
-	  new_idom = b->getIn(j);
-	  if (new_idom->immed_dom != (FlowBlock *)0)
-	    break;
-	}
-	j += 1;
-	for(;j<b->sizeIn();++j) {
-	  rho = b->getIn(j);
-	  if (rho->immed_dom != (FlowBlock *)0) { // Here is the intersection routine
-	    finger1 = numnodes - rho->index;
-	    finger2 = numnodes - new_idom->index;
-	    while(finger1 != finger2) {
-	      while(finger1 < finger2)
-		finger1 = numnodes - postorder[finger1]->immed_dom->index;
-	      while(finger2 < finger1)
-		finger2 = numnodes - postorder[finger2]->immed_dom->index;
-	    }
-	    new_idom = postorder[finger1];
-	  }
-	}
-	if (b->immed_dom != new_idom) {
-	  b->immed_dom = new_idom;
-	  changed = true;
-	}
+    startbl = virtualroot;
+  }
+
+  // Depth-first search assigning pre-order numbers; the virtual root (if any) uses
+  // the extra slot at the end of the -pre- map
+  vector<int4> pre(size+1,-1);		// Map from FlowBlock index to pre-order number
+  vector<FlowBlock *> vertex;		// Map from pre-order number back to the FlowBlock
+  vector<int4> parent;			// DFS tree parent of each vertex, as a pre-order number
+  vertex.reserve(size);
+  parent.reserve(size);
+  vector<FlowBlock *> blstack;
+  vector<int4> parstack;
+  blstack.push_back(startbl);
+  parstack.push_back(-1);
+  while(!blstack.empty()) {
+    FlowBlock *bl = blstack.back();
+    int4 par = parstack.back();
+    blstack.pop_back();
+    parstack.pop_back();
+    int4 slot = (bl == virtualroot) ? size : bl->index;
+    if (pre[slot] != -1) continue;	// Already visited
+    pre[slot] = vertex.size();
+    vertex.push_back(bl);
+    parent.push_back(par);
+    for(i=bl->sizeOut()-1;i>=0;--i) {
+      FlowBlock *outbl = bl->getOut(i);
+      if (pre[outbl->index] == -1) {
+	blstack.push_back(outbl);
+	parstack.push_back(pre[slot]);
       }
     }
   }
+
+  // Compute semidominators in reverse pre-order, using eval/link with path compression
+  int4 numvertex = vertex.size();
+  vector<int4> semi(numvertex);
+  vector<int4> ancestor(numvertex,-1);
+  vector<int4> label(numvertex);
+  for(i=0;i<numvertex;++i) {
+    semi[i] = i;
+    label[i] = i;
+  }
+  for(i=numvertex-1;i>0;--i) {
+    FlowBlock *bl = vertex[i];
+    for(j=0;j<bl->sizeIn();++j) {
+      FlowBlock *inbl = bl->getIn(j);
+      int4 slot = (inbl == virtualroot) ? size : inbl->index;
+      int4 v = pre[slot];
+      if (v == -1) continue;		// Predecessor is unreachable from the root
+      int4 u = evalSemi(v,ancestor,label,semi);
+      if (semi[u] < semi[i])
+	semi[i] = semi[u];
+    }
+    ancestor[i] = parent[i];		// Link the vertex beneath its DFS parent
+  }
+
+  // The immediate dominator is the nearest common ancestor (in the partially built
+  // dominator tree) of the DFS parent and the semidominator
+  vector<int4> idom(numvertex);
+  idom[0] = 0;
+  for(i=1;i<numvertex;++i) {
+    int4 anc = parent[i];
+    while(anc > semi[i])
+      anc = idom[anc];
+    idom[i] = anc;
+    vertex[i]->immed_dom = vertex[anc];
+  }
+
   if (virtualroot != (FlowBlock *)0) { // If there was a virtual root, excise it from the dominator tree
-    for(i=0;i<list.size();++i)
-      if (postorder[i]->immed_dom == virtualroot)
-	postorder[i]->immed_dom = (FlowBlock *)0; // Remove the dominator link to virtualroot
+    for(i=1;i<numvertex;++i)
+      if (vertex[i]->immed_dom == virtualroot)
+	vertex[i]->immed_dom = (FlowBlock *)0; // Remove the dominator link to virtualroot
     while(virtualroot->sizeOut() > 0)
       virtualroot->removeOutEdge(virtualroot->sizeOut()-1); // Remove any edges from virtualroot
     delete virtualroot;
   }
   else
-    postorder.back()->immed_dom = (FlowBlock *)0;
+    startbl->immed_dom = (FlowBlock *)0;	// The real root has no immediate dominator
 }
 
 /// Associate dominator children with each node via a list (of lists) indexed by the FlowBlock index.
@@ -64,6 +64,40 @@ struct BlockEdge {
   void decode(Decoder &decoder,BlockMap &resolver);	///< Restore \b this edge from a stream
 };
 
+/// \brief A list of BlockEdge objects with inline storage for the common case
+///
+/// The overwhelming majority of blocks have at most 2 incoming and 2 outgoing edges,
+/// so the first few edges are stored directly in the containing FlowBlock, and only
+/// high-degree blocks (switch hubs) spill to a separate heap allocation.  This supports
+/// just the slice of the vector interface that FlowBlock uses to maintain its edges.
+class EdgeList {
+  static const int4 INLINE_MAX = 2;	///< Number of edges held directly in the container
+  BlockEdge inlineStore[INLINE_MAX];	///< Storage for the first few edges
+  BlockEdge *edges;			///< Active storage, either \b inlineStore or a heap spill
+  int4 count;				///< Number of edges in the list
+  int4 capacity;			///< Number of edges the active storage can hold
+  void enlarge(void);			///< Move the edges to a bigger heap allocation
+public:
+  typedef BlockEdge *iterator;			///< Iterator over edges in \b this list
+  typedef const BlockEdge *const_iterator;	///< Const iterator over edges in \b this list
+  EdgeList(void) { edges = inlineStore; count = 0; capacity = INLINE_MAX; }	///< Construct an empty list
+  EdgeList(const EdgeList &op2);		///< Copy constructor
+  ~EdgeList(void) { if (edges != inlineStore) delete [] edges; }	///< Destructor
+  EdgeList &operator=(const EdgeList &op2);	///< Assignment operator
+  int4 size(void) const { return count; }	///< Get the number of edges in the list
+  bool empty(void) const { return (count == 0); }	///< Return \b true if the list has no edges
+  BlockEdge &operator[](int4 i) { return edges[i]; }	///< Get a reference to the i-th edge
+  const BlockEdge &operator[](int4 i) const { return edges[i]; }	///< Get a const reference to the i-th edge
+  void push_back(const BlockEdge &edge) { if (count == capacity) enlarge(); edges[count++] = edge; }	///< Append a copy of the given edge
+  BlockEdge &emplace_back(void) { if (count == capacity) enlarge(); count += 1; return edges[count-1]; }	///< Append a new uninitialized edge
+  BlockEdge &back(void) { return edges[count-1]; }	///< Get a reference to the last edge
+  void pop_back(void) { count -= 1; }		///< Remove the last edge from the list
+  iterator begin(void) { return edges; }	///< Get an iterator to the first edge
+  iterator end(void) { return edges + count; }	///< Get an iterator past the last edge
+  const_iterator begin(void) const { return edges; }	///< Get a const iterator to the first edge
+  const_iterator end(void) const { return edges + count; }	///< Get a const iterator past the last edge
+};
+
 /// \brief Description of a control-flow block containing PcodeOps
 ///
 /// This is the base class for basic blocks (BlockBasic) and the
@@ -124,13 +158,13 @@ private:
   int4 index;			///< Reference index for this block (reverse post order)
   int4 visitcount;		///< A count of visits of this node for various algorithms
   int4 numdesc;			///< Number of descendants of this block in spanning tree (+1)
-  vector<BlockEdge> intothis;	///< Blocks which (can) fall into this block
-  vector<BlockEdge> outofthis;	///< Blocks into which this block (can) fall
+  EdgeList intothis;		///< Blocks which (can) fall into this block
+  EdgeList outofthis;		///< Blocks into which this block (can) fall
 				// If there are two possible outputs as the
 				// result of a conditional branch
 				// the first block in outofthis should be
 				// the result of the condition being false
-  static void replaceEdgeMap(vector<BlockEdge> &vec);	///< Update block references in edges with copy map
+  static void replaceEdgeMap(EdgeList &vec);	///< Update block references in edges with copy map
   void addInEdge(FlowBlock *b,uint4 lab);	///< Add an edge coming into \b this
   void decodeNextInEdge(Decoder &decoder,BlockMap &resolver);	///< Decode the next input edge from stream
   void halfDeleteInEdge(int4 slot);		///< Delete the \e in half of an edge, correcting indices
@@ -145,7 +179,7 @@ private:
   void clearOutEdgeFlag(int4 i,uint4 lab);	///< Remove an \e out edge label
   void eliminateInDups(FlowBlock *bl);		///< Eliminate duplicate \e in edges from given block
   void eliminateOutDups(FlowBlock *bl);		///< Eliminate duplicate \e out edges to given block
-  static void findDups(const vector<BlockEdge> &ref,vector<FlowBlock *> &duplist);
+  static void findDups(const EdgeList &ref,vector<FlowBlock *> &duplist);
   void dedup(void);				///< Eliminate duplicate edges
   void replaceUsingMap(void);			///< Update references to other blocks using getCopyMap()
 #ifdef BLOCKCONSISTENT_DEBUG
@@ -1761,8 +1761,37 @@ bool CollapseStructure::ruleCaseFallthru(FlowBlock *bl)
   return true;
 }
 
+/// A structuring rule reads properties of blocks within (at most) two edges of
+/// its root block, so a new collapse can only enable rules rooted in that
+/// neighborhood.  Remove the collapsed block, and everything within two edges
+/// of it, from the clean set so those roots get re-attempted.
+/// \param bl is the block produced by the collapse
+void CollapseStructure::markDirty(FlowBlock *bl)
+
+{
+  cleanblocks.erase(bl);
+  for(int4 i=0;i<bl->sizeIn();++i) {
+    FlowBlock *sidebl = bl->getIn(i);
+    cleanblocks.erase(sidebl);
+    for(int4 j=0;j<sidebl->sizeIn();++j)
+      cleanblocks.erase(sidebl->getIn(j));
+    for(int4 j=0;j<sidebl->sizeOut();++j)
+      cleanblocks.erase(sidebl->getOut(j));
+  }
+  for(int4 i=0;i<bl->sizeOut();++i) {
+    FlowBlock *sidebl = bl->getOut(i);
+    cleanblocks.erase(sidebl);
+    for(int4 j=0;j<sidebl->sizeIn();++j)
+      cleanblocks.erase(sidebl->getIn(j));
+    for(int4 j=0;j<sidebl->sizeOut();++j)
+      cleanblocks.erase(sidebl->getOut(j));
+  }
+}
+
 /// Collapse everything until no additional rules apply.
 /// If handed a particular FlowBlock, try simplifying from that block first.
+/// Blocks where every rule has already failed are skipped until a collapse
+/// happens near them, so the repeated rescans stay close to linear.
 /// \param targetbl is the FlowBlock to start from or NULL
 /// \return the count of \e isolated FlowBlocks (with no incoming or outgoing edges)
 int4 CollapseStructure::collapseInternal(FlowBlock *targetbl)
@@ -1773,6 +1802,7 @@ int4 CollapseStructure::collapseInternal(FlowBlock *targetbl)
   int4 isolated_count;
   FlowBlock *bl;
 
+  cleanblocks.clear();		// Edges may have been marked as gotos since the last attempt
   do {
     do {
       change = false;
@@ -1793,43 +1823,54 @@ int4 CollapseStructure::collapseInternal(FlowBlock *targetbl)
 	  isolated_count += 1;
 	  continue;		// This does not constitute a chanage
 	}
+	if (cleanblocks.find(bl) != cleanblocks.end())
+	  continue;		// Every rule already failed here and nothing nearby has changed
 	// Try each rule on the block
 	if (ruleBlockGoto(bl)) {
 	  change = true;
+	  markDirty(bl->getParent());
 	  continue;
 	}
 	if (ruleBlockCat(bl)) {
 	  change = true;
+	  markDirty(bl->getParent());
 	  continue;
 	}
 	if (ruleBlockProperIf(bl)) {
 	  change = true;
+	  markDirty(bl->getParent());
 	  continue;
 	}
 	if (ruleBlockIfElse(bl)) {
 	  change = true;
+	  markDirty(bl->getParent());
 	  continue;
 	}
 	if (ruleBlockWhileDo(bl)) {
 	  change = true;
+	  markDirty(bl->getParent());
 	  continue;
 	}
 	if (ruleBlockDoWhile(bl)) {
 	  change = true;
+	  markDirty(bl->getParent());
 	  continue;
 	}
 	if (ruleBlockInfLoop(bl)) {
 	  change = true;
+	  markDirty(bl->getParent());
 	  continue;
 	}
 	if (ruleBlockSwitch(bl)) {
 	  change = true;
+	  markDirty(bl->getParent());
 	  continue;
 	}
 	//      if (ruleBlockOr(bl)) {
 	//	change = true;
 	//	continue;
 	//      }
+	cleanblocks.insert(bl);	// Nothing applied: skip this block until a collapse happens nearby
       }
     } while(change);
     // Applying IfNoExit rule too early can cause other (preferable) rules to miss
@@ -1839,10 +1880,12 @@ int4 CollapseStructure::collapseInternal(FlowBlock *targetbl)
       bl = graph.getBlock(index);
       if (ruleBlockIfNoExit(bl)) { // If no other change is possible but still blocks left, try ifnoexit
 	fullchange = true;
+	cleanblocks.clear();	// The collapse may enable rules anywhere the exit was reachable
 	break;
       }
       if (ruleCaseFallthru(bl)) { // Check for fallthru cases in a switch
 	fullchange = true;
+	cleanblocks.clear();	// New goto edges change the picture for any block near the switch
 	break;
       }
     }
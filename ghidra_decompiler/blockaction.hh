@@ -198,6 +198,8 @@ class CollapseStructure {
   list<LoopBody>::iterator loopbodyiter;	///< Current (innermost) loop being structured
   BlockGraph &graph;				///< The control-flow graph
   int4 dataflow_changecount;			///< Number of data-flow changes made during structuring
+  set<FlowBlock *> cleanblocks;			///< Blocks where every rule failed, with no local change since
+  void markDirty(FlowBlock *bl);		///< Remove the neighborhood of a new collapse from the clean set
   bool checkSwitchSkips(FlowBlock *switchbl,FlowBlock *exitblock);
   void onlyReachableFromRoot(FlowBlock *root,vector<FlowBlock *> &body);
   int4 markExitsAsGotos(vector<FlowBlock *> &body);	///< Mark edges exiting the body as \e unstructured gotos
@@ -16,6 +16,7 @@
  */
 #include "codedata.hh"
 #include "loadimage_bfd.hh"
+#include <thread>
 
 namespace ghidra {
 
@@ -375,6 +376,118 @@ void CodeDataAnalysis::disassembleRangeList(const RangeList &rangelist)
   }
 }
 
+void CodeDataAnalysis::disassembleRangeList(const RangeList &rangelist,int4 numthreads)
+
+{ // Disassemble the ranges, sharding big ranges across worker threads.  Each
+  // worker carries its own decode state and result maps; the shards are then
+  // reconciled in address order so the final tables match a serial scan.
+  const uintb minshard = 0x10000;	// Smallest range piece worth a separate thread
+  const uintb overlap = 1024;		// Window both sides of a cut disassemble
+
+  uintb totalsize = 0;
+  set<Range>::const_iterator riter;
+  for(riter=rangelist.begin();riter!=rangelist.end();++riter)
+    totalsize += (*riter).getLast() - (*riter).getFirst() + 1;
+  if (numthreads > 1 && totalsize / numthreads < minshard)
+    numthreads = (int4)(totalsize / minshard);
+  if (numthreads <= 1) {
+    disassembleRangeList(rangelist);
+    return;
+  }
+  uintb target = totalsize / numthreads;
+  target = (target / alignment) * alignment;	// Keep the cuts aligned
+  if (target == 0)
+    target = alignment;
+
+  vector<Range> shardrange;		// Addresses each shard decodes (including overlap)
+  vector<uintb> shardcut;		// First offset each shard logically owns
+  vector<bool> shardsync;		// Does the shard start at an artificial cut?
+  for(riter=rangelist.begin();riter!=rangelist.end();++riter) {
+    AddrSpace *spc = (*riter).getSpace();
+    uintb last = (*riter).getLast();
+    uintb cur = (*riter).getFirst();
+    bool syncneed = false;
+    while(cur <= last) {
+      uintb end = cur + target - 1;	// Last offset this shard owns
+      if (end < cur || end >= last)
+	end = last;
+      uintb decodeend = end;
+      if (end != last) {		// Decode into the next shard to allow resynchronization
+	decodeend = end + overlap;
+	if (decodeend > last)
+	  decodeend = last;
+      }
+      shardrange.emplace_back(spc,cur,decodeend);
+      shardcut.push_back(cur);
+      shardsync.push_back(syncneed);
+      syncneed = true;
+      if (end == last) break;
+      cur = end + 1;
+    }
+  }
+
+  int4 nshards = shardrange.size();
+  if (numthreads > nshards)
+    numthreads = nshards;
+  vector<CodeDataAnalysis> shardstate(nshards);
+  vector<std::thread> pool;
+  for(int4 t=0;t<numthreads;++t) {
+    int4 start = (int4)(((int8)nshards * t) / numthreads);
+    int4 stop = (int4)(((int8)nshards * (t+1)) / numthreads);
+    pool.emplace_back([this,start,stop,&shardstate,&shardrange](void) {
+      for(int4 i=start;i<stop;++i) {
+	CodeDataAnalysis &shard( shardstate[i] );
+	shard.init(glb);
+	map<Address,TargetFeature>::const_iterator titer;
+	for(titer=targets.begin();titer!=targets.end();++titer)
+	  shard.disengine.addTarget((*titer).first);
+	shard.disassembleRange(shardrange[i]);
+      }
+    });
+  }
+  for(int4 t=0;t<numthreads;++t)
+    pool[t].join();
+
+  // An artificial cut can fall mid-instruction, so a shard's first units may
+  // be errant.  Both neighbors decoded the overlap window; the first
+  // instruction start they agree on is where ownership switches.
+  vector<Address> keepfirst(nshards);
+  for(int4 i=0;i<nshards;++i) {
+    AddrSpace *spc = shardrange[i].getSpace();
+    keepfirst[i] = Address(spc,shardcut[i]);
+    if (!shardsync[i]) continue;
+    CodeDataAnalysis &shard( shardstate[i] );
+    CodeDataAnalysis &prev( shardstate[i-1] );
+    map<Address,CodeUnit>::const_iterator siter = shard.codeunit.lower_bound(keepfirst[i]);
+    while(siter != shard.codeunit.end()) {
+      if ((*siter).first.getOffset() > shardrange[i-1].getLast()) break;	// Past the shared window
+      if (prev.codeunit.find((*siter).first) != prev.codeunit.end()) {
+	keepfirst[i] = (*siter).first;
+	break;
+      }
+      ++siter;
+    }
+  }
+
+  for(int4 i=0;i<nshards;++i) {
+    CodeDataAnalysis &shard( shardstate[i] );
+    bool trimend = (i+1 < nshards) && shardsync[i+1];
+    map<Address,CodeUnit>::const_iterator citer = shard.codeunit.lower_bound(keepfirst[i]);
+    map<Address,CodeUnit>::const_iterator cend;
+    cend = trimend ? shard.codeunit.lower_bound(keepfirst[i+1]) : shard.codeunit.end();
+    for(;citer!=cend;++citer)
+      codeunit[(*citer).first] = (*citer).second;
+    map<AddrLink,uint4>::const_iterator fiter = shard.fromto_crossref.lower_bound(AddrLink(keepfirst[i]));
+    map<AddrLink,uint4>::const_iterator fend;
+    fend = trimend ? shard.fromto_crossref.lower_bound(AddrLink(keepfirst[i+1])) : shard.fromto_crossref.end();
+    for(;fiter!=fend;++fiter) {
+      const AddrLink &fromto( (*fiter).first );
+      fromto_crossref[ fromto ] = (*fiter).second;
+      tofrom_crossref[ AddrLink(fromto.b,fromto.a) ] = (*fiter).second;
+    }
+  }
+}
+
 void CodeDataAnalysis::findNotCodeUnits(void)
 
 { // Mark any code units that have flow into "notcode" units as "notcode"
@@ -679,6 +792,12 @@ void CodeDataAnalysis::dumpTargetHits(ostream &s) const
 
 void CodeDataAnalysis::runModel(void)
 
+{
+  runModel(1);
+}
+
+void CodeDataAnalysis::runModel(int4 numthreads)
+
 {
   LoadImage *loadimage = glb->loader;
   LoadImageSection secinfo;
@@ -703,7 +822,7 @@ void CodeDataAnalysis::runModel(void)
   CodeUnit &cu( codeunit[lastaddr] );
   cu.size = 100;
   cu.flags = CodeUnit::notcode;
-  disassembleRangeList(modelhits);
+  disassembleRangeList(modelhits,numthreads);
   findNotCodeUnits();
   markFallthruHits();
   markCrossHits();
@@ -126,6 +126,7 @@ public:
   Address disassembleBlock(const Address &addr,const Address &endaddr);
   void disassembleRange(const Range &range);
   void disassembleRangeList(const RangeList &rangelist);
+  void disassembleRangeList(const RangeList &rangelist,int4 numthreads);
   void findNotCodeUnits(void);
   void markFallthruHits(void);
   void markCrossHits(void);
@@ -143,6 +144,7 @@ public:
   void dumpUnlinked(ostream &s) const;
   void dumpTargetHits(ostream &s) const;
   void runModel(void);
+  void runModel(int4 numthreads);
 };
 
 class IfaceCodeDataCommand : public IfaceCommand {
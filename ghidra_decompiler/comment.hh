@@ -157,7 +157,10 @@ public:
 ///
 /// All Comment objects are held in memory in a sorted container.  This
 /// can be used as stand-alone database of comments, or it can act as a
-/// cache for some other container.
+/// cache for some other container.  Comments are sorted by function address
+/// first, so all comments for a single function sit contiguously, and the
+/// beginComment()/endComment() range for one function is found with a
+/// binary search; per-function retrieval does not scan the whole database.
 class CommentDatabaseInternal : public CommentDatabase {
   CommentSet commentset;			///< The sorted set of Comment objects
 public:
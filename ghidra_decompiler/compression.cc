@@ -104,6 +104,89 @@ Decompress::~Decompress(void)
   inflateEnd(&compStream);
 }
 
+#ifdef ZSTD_SUPPORT
+/// The compression \b level follows the zstd convention, 1-22 from faster/least
+/// compression to slower/most compression, with negative values trading further
+/// compression away for speed.
+/// \param level is the compression level
+ZstdCompress::ZstdCompress(int4 level)
+
+{
+  compStream = ZSTD_createCCtx();
+  if (compStream == (ZSTD_CCtx *)0)
+    throw LowlevelError("Could not initialize zstd compression context");
+  ZSTD_CCtx_setParameter(compStream,ZSTD_c_compressionLevel,level);
+  inDesc.src = (const void *)0;
+  inDesc.size = 0;
+  inDesc.pos = 0;
+}
+
+ZstdCompress::~ZstdCompress(void)
+
+{
+  ZSTD_freeCCtx(compStream);
+}
+
+/// Return the number of bytes of output space still available.  Output may be limited by the amount
+/// of space in the output buffer or the amount of data available in the current input buffer.
+/// \param buffer is where compressed bytes are stored
+/// \param sz is the size, in bytes, of the buffer
+/// \param finish is set to \b true if this is the final buffer to add to the stream
+/// \return the number of output bytes still available
+int4 ZstdCompress::deflate(uint1 *buffer,int4 sz,bool finish)
+
+{
+  ZSTD_outBuffer outDesc;
+  outDesc.dst = buffer;
+  outDesc.size = sz;
+  outDesc.pos = 0;
+
+  size_t ret = ZSTD_compressStream2(compStream,&outDesc,&inDesc,finish ? ZSTD_e_end : ZSTD_e_continue);
+  if (ZSTD_isError(ret))
+    throw LowlevelError("Error compressing stream");
+  return sz - (int4)outDesc.pos;
+}
+
+ZstdDecompress::ZstdDecompress(void)
+
+{
+  streamFinished = false;
+  compStream = ZSTD_createDCtx();
+  if (compStream == (ZSTD_DCtx *)0)
+    throw LowlevelError("Could not initialize zstd decompression context");
+  inDesc.src = (const void *)0;
+  inDesc.size = 0;
+  inDesc.pos = 0;
+}
+
+ZstdDecompress::~ZstdDecompress(void)
+
+{
+  ZSTD_freeDCtx(compStream);
+}
+
+/// Return the number of bytes of output space still available.  Output may be limited by the amount
+/// of space in the output buffer or the amount of data available in the current input buffer.
+/// \param buffer is where uncompressed bytes are stored
+/// \param sz is the size, in bytes, of the buffer
+/// \return the number of output bytes still available
+int4 ZstdDecompress::inflate(uint1 *buffer,int4 sz)
+
+{
+  ZSTD_outBuffer outDesc;
+  outDesc.dst = buffer;
+  outDesc.size = sz;
+  outDesc.pos = 0;
+
+  size_t ret = ZSTD_decompressStream(compStream,&outDesc,&inDesc);
+  if (ZSTD_isError(ret))
+    throw LowlevelError("Error decompressing stream");
+  if (ret == 0)
+    streamFinished = true;
+  return sz - (int4)outDesc.pos;
+}
+#endif
+
 const int4 CompressBuffer::IN_BUFFER_SIZE = 4096;
 const int4 CompressBuffer::OUT_BUFFER_SIZE = 4096;
 
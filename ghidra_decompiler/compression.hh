@@ -24,6 +24,9 @@
 #else
 #include <zlib.h>
 #endif
+#ifdef ZSTD_SUPPORT
+#include <zstd.h>
+#endif
 
 namespace ghidra {
 
@@ -72,6 +75,61 @@ public:
   int4 inflate(uint1 *buffer,int4 sz);	///< Inflate as much as possible into given buffer
 };
 
+#ifdef ZSTD_SUPPORT
+/// \brief Wrapper for the zstd compression algorithm
+///
+/// Presents the same streaming interface as Compress, so writers of new cache
+/// artifacts can select either codec.  Initialize/free algorithm resources.
+/// Provide successive arrays of bytes to compress via the input() method.
+/// Compute successive arrays of compressed bytes via the deflate() method.
+class ZstdCompress {
+  ZSTD_CCtx *compStream;	///< The zstd compression context
+  ZSTD_inBuffer inDesc;		///< Descriptor of the current input buffer
+public:
+  ZstdCompress(int4 level);	///< Initialize the compression context
+  ~ZstdCompress(void);		///< Free algorithm state resources
+
+  /// \brief Provide the next sequence of bytes to be compressed
+  ///
+  /// \param buffer is a pointer to the bytes to compress
+  /// \param sz is the number of bytes
+  void input(uint1 *buffer,int4 sz) {
+    inDesc.src = buffer;
+    inDesc.size = sz;
+    inDesc.pos = 0;
+  }
+  int4 deflate(uint1 *buffer,int4 sz,bool finish);	///< Compress as much as possible into given buffer
+};
+
+/// \brief Wrapper for the zstd decompression algorithm
+///
+/// Presents the same streaming interface as Decompress.  Initialize/free
+/// algorithm resources.  Provide successive arrays of compressed bytes via the
+/// input() method.  Compute successive arrays of uncompressed bytes via the
+/// inflate() method.
+class ZstdDecompress {
+  ZSTD_DCtx *compStream;	///< The zstd decompression context
+  ZSTD_inBuffer inDesc;		///< Descriptor of the current input buffer
+  bool streamFinished;		///< Set to \b true if the end of the compressed frame has been reached
+public:
+  ZstdDecompress(void);		///< Initialize the decompression context
+  ~ZstdDecompress(void);	///< Free algorithm state resources
+
+  /// \brief Provide the next sequence of compressed bytes
+  ///
+  /// \param buffer is a pointer to the compressed bytes
+  /// \param sz is the number of bytes
+  void input(uint1 *buffer,int4 sz) {
+    inDesc.src = buffer;
+    inDesc.size = sz;
+    inDesc.pos = 0;
+  }
+
+  bool isFinished(void) const { return streamFinished; }	///< Return \b if end of compressed frame is reached
+  int4 inflate(uint1 *buffer,int4 sz);	///< Decompress as much as possible into given buffer
+};
+#endif
+
 /// \brief Stream buffer that performs compression
 ///
 /// Provides an ostream filter that compresses the stream using the \e deflate algorithm.
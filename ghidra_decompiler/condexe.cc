@@ -544,6 +544,12 @@ int4 ActionConditionalExe::apply(Funcdata &data)
 
   if (data.hasUnreachableBlocks()) // Conditional execution elimination logic may not work with unreachable blocks
     return 0;
+  // The form requires CBRANCHs in both the iblock and the initblock, so functions with
+  // fewer than 2 conditional branches can be skipped without any setup
+  list<PcodeOp *>::const_iterator branchiter = data.beginOp(CPUI_CBRANCH);
+  list<PcodeOp *>::const_iterator branchend = data.endOp(CPUI_CBRANCH);
+  if (branchiter == branchend) return 0;
+  if (++branchiter == branchend) return 0;
   ConditionalExecution condexe(&data);
   const BlockGraph &bblocks( data.getBasicBlocks() );
 
@@ -23,6 +23,7 @@ ParserContext::ParserContext(ContextCache *ccache,Translate *trans)
 
 {
   parsestate = uninitialized;
+  pcodecached = false;
   contcache = ccache;
   translate = trans;
   if (ccache != (ContextCache *)0) {
@@ -191,6 +192,45 @@ void ParserContext::applyCommits(void)
   }
 }
 
+/// The operand data is copied into the cache's operand array and the op is
+/// appended to the cached translation.
+/// \param opc is the op code of the p-code op
+/// \param outvar is the output operand (or null if there is none)
+/// \param invar is the array of input operands
+/// \param isize is the number of input operands
+void ParserContext::addCachedOp(OpCode opc,const VarnodeData *outvar,const VarnodeData *invar,int4 isize)
+
+{
+  PcodeCacheOp op;
+  op.opc = opc;
+  if (outvar != (const VarnodeData *)0) {
+    op.outindex = pcodepool.size();
+    pcodepool.push_back(*outvar);
+  }
+  else
+    op.outindex = -1;
+  op.instart = pcodepool.size();
+  op.isize = isize;
+  for(int4 i=0;i<isize;++i)
+    pcodepool.push_back(invar[i]);
+  pcodeops.push_back(op);
+}
+
+/// Dump the cached p-code translation to the given emitter, producing the same
+/// sequence of ops as rebuilding the instruction would.
+/// \param baseaddr is the address of the machine instruction
+/// \param emit is the emitter to dump to
+void ParserContext::emitPcodeCache(const Address &baseaddr,PcodeEmit &emit)
+
+{
+  for(int4 i=0;i<pcodeops.size();++i) {
+    PcodeCacheOp &op( pcodeops[i] );
+    VarnodeData *outvar = (op.outindex < 0) ? (VarnodeData *)0 : &pcodepool[op.outindex];
+    VarnodeData *invar = (op.isize == 0) ? (VarnodeData *)0 : &pcodepool[op.instart];
+    emit.dump(baseaddr,op.opc,outvar,invar,op.isize);
+  }
+}
+
 void ParserWalker::setOutOfBandState(Constructor *ct,int4 index,ConstructState *tempstate,const ParserWalker &otherwalker)
 
 { // Initialize walker for future calls into getInstructionBytes assuming -ct- is the current position in the walk
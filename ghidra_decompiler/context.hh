@@ -67,6 +67,7 @@ struct ContextSet {		// Instructions for setting a global context value
 class ParserWalker;		// Forward declaration
 class ParserWalkerChange;
 class Translate;
+class PcodeEmit;
 
 class ParserContext {
   friend class ParserWalker;
@@ -77,6 +78,16 @@ public:
     disassembly = 1,		// Instruction is parsed in preparation for disassembly
     pcode = 2			// Instruction is parsed in preparation for generating p-code
   };
+  /// \brief A p-code op in the cached translation of the instruction
+  ///
+  /// The output and input operands are held as indices into a single
+  /// array of VarnodeData storing all operands for the translation.
+  struct PcodeCacheOp {
+    OpCode opc;			// The op code
+    int4 outindex;		// Index of the output operand (-1 if there is none)
+    int4 instart;		// Index of the first input operand
+    int4 isize;			// Number of input operands
+  };
 private:
   Translate *translate;		// Instruction parser
   int4 parsestate;
@@ -94,13 +105,21 @@ private:
   ConstructState *base_state;
   int4 alloc;			// Number of ConstructState's allocated
   int4 delayslot;		// delayslot depth
+  vector<PcodeCacheOp> pcodeops;	// Cached p-code translation of the instruction
+  vector<VarnodeData> pcodepool;	// Operand storage for the cached translation
+  bool pcodecached;		// Set to true if the p-code translation has been cached
 public:
   ParserContext(ContextCache *ccache,Translate *trans);
   ~ParserContext(void) { if (context != (uintm *)0) delete [] context; }
   uint1 *getBuffer(void) { return buf; }
   void initialize(int4 maxstate,int4 maxparam,AddrSpace *spc);
   int4 getParserState(void) const { return parsestate; }
-  void setParserState(int4 st) { parsestate = st; }
+  void setParserState(int4 st) { parsestate = st; if (st != pcode) clearPcodeCache(); }
+  bool isPcodeCached(void) const { return pcodecached; }	///< Return \b true if a p-code translation is cached
+  void clearPcodeCache(void) { pcodecached = false; pcodeops.clear(); pcodepool.clear(); }	///< Drop any cached p-code
+  void addCachedOp(OpCode opc,const VarnodeData *outvar,const VarnodeData *invar,int4 isize);
+  void finalizePcodeCache(void) { pcodecached = true; }	///< Mark the cached p-code as complete
+  void emitPcodeCache(const Address &baseaddr,PcodeEmit &emit);	///< Replay the cached p-code to an emitter
   void deallocateState(ParserWalkerChange &walker);
   void allocateOperand(int4 i,ParserWalkerChange &walker);
   void setAddr(const Address &ad) { addr = ad; n2addr = Address(); }
@@ -108,6 +127,7 @@ public:
   void setCalladdr(const Address &ad) { calladdr = ad; }
   void addCommit(TripleSymbol *sym,int4 num,uintm mask,bool flow,ConstructState *point);
   void clearCommits(void) { contextcommit.clear(); }
+  bool hasCommits(void) const { return !contextcommit.empty(); }
   void applyCommits(void);
   const Address &getAddr(void) const { return addr; }
   const Address &getNaddr(void) const { return naddr; }
@@ -1053,6 +1053,70 @@ bool ActionConstantPtr::checkCopy(PcodeOp *op,Funcdata &data)
   return data.getArch()->infer_pointers;
 }
 
+/// The page number is folded down to an index into the prefilter bit array, mixing
+/// in the address space so spaces with overlapping offsets use different bits.
+/// \param spc is the address space containing the page
+/// \param page is the page number within the space
+/// \return the bit position within the prefilter
+uint4 ActionConstantPtr::filterHash(AddrSpace *spc,uintb page)
+
+{
+  return (uint4)((page ^ (page >> 10) ^ ((uintb)spc->getIndex() << 5)) & (filter_bits-1));
+}
+
+/// The address ranges owned by the global scope cover any address that can resolve
+/// to a symbol.  Each page touched by a range sets one bit in the filter, letting
+/// isPointer() reject most addresses that cannot have a symbol without a range query.
+/// If the scope has no recorded ranges, or a range is large enough to saturate the
+/// filter, the filter is left inactive and every address is probed as before.
+/// \param data is the function being analyzed
+void ActionConstantPtr::buildRangeFilter(Funcdata &data)
+
+{
+  filterActive = false;
+  for(int4 i=0;i<filter_words;++i)
+    rangeFilter[i] = 0;
+  const RangeList &tree(data.getScopeLocal()->getParent()->getRangeTree());
+  if (tree.begin() == tree.end()) return;	// No recorded ranges, filter cannot exclude anything
+  set<Range>::const_iterator iter;
+  for(iter=tree.begin();iter!=tree.end();++iter) {
+    const Range &range(*iter);
+    uintb firstPage = range.getFirst() >> filter_pageshift;
+    uintb lastPage = range.getLast() >> filter_pageshift;
+    if (lastPage - firstPage >= filter_bits) return;	// Range saturates the filter
+    for(uintb page=firstPage;page<=lastPage;++page) {
+      uint4 bit = filterHash(range.getSpace(),page);
+      rangeFilter[bit >> 6] |= ((uint8)1) << (bit & 0x3f);
+    }
+  }
+  filterActive = true;
+}
+
+/// \param addr is the address being tested
+/// \return \b false if the address cannot be contained in a global range
+bool ActionConstantPtr::possiblePointer(const Address &addr) const
+
+{
+  uint4 bit = filterHash(addr.getSpace(),addr.getOffset() >> filter_pageshift);
+  return ((rangeFilter[bit >> 6] >> (bit & 0x3f)) & 1) != 0;
+}
+
+/// The prefilter is consulted first.  Only if it cannot exclude the address is the
+/// symbol table's range query performed, memoized through the per-function cache so
+/// repeated constants resolving to the same address are answered without a search.
+/// \param rampoint is the address to which a constant resolves
+/// \param data is the function being analyzed
+/// \return the symbol containing the address or NULL
+SymbolEntry *ActionConstantPtr::queryCached(const Address &rampoint,Funcdata &data)
+
+{
+  if (filterActive && !possiblePointer(rampoint))
+    return (SymbolEntry *)0;
+    // Since we are looking for a global address
+    // Assume it is address tied and use empty usepoint
+  return data.queryGlobalContainer(rampoint);
+}
+
 /// \brief Determine if given Varnode might be a pointer constant.
 ///
 /// If it is a pointer, return the symbol it points to, or NULL otherwise. If it is determined
@@ -1146,9 +1210,7 @@ SymbolEntry *ActionConstantPtr::isPointer(AddrSpace *spc,Varnode *vn,PcodeOp *op
   }
 
   if (rampoint.isInvalid()) return (SymbolEntry *)0;
-    // Since we are looking for a global address
-    // Assume it is address tied and use empty usepoint
-  SymbolEntry *entry = data.getScopeLocal()->getParent()->queryContainer(rampoint,1,Address());
+  SymbolEntry *entry = queryCached(rampoint,data);
   if (entry != (SymbolEntry *)0) {
     Datatype *ptrType = entry->getSymbol()->getType();
     if (ptrType->getMetatype() == TYPE_ARRAY) {
@@ -1171,6 +1233,8 @@ int4 ActionConstantPtr::apply(Funcdata &data)
 
   if (localcount >= 4)		// At most 4 passes (once type recovery starts)
     return 0;
+  if (localcount == 0)
+    buildRangeFilter(data);
   localcount += 1;
 
   VarnodeLocSet::const_iterator begiter,enditer;
@@ -1248,7 +1312,7 @@ int4 ActionDeindirect::apply(Funcdata &data)
 	offset <<= align;
       }
       Address codeaddr(sp,offset);
-      Funcdata *newfd = data.getScopeLocal()->getParent()->queryFunction(codeaddr);
+      Funcdata *newfd = data.queryGlobalFunction(codeaddr);
       if (newfd != (Funcdata *)0) {
 	fc->deindirect(data,newfd);
 	count += 1;
@@ -3464,7 +3528,9 @@ int4 ActionDoNothing::apply(Funcdata &data)
   const BlockGraph &graph(data.getBasicBlocks());
   BlockBasic *bb;
 
-  for(i=0;i<graph.getSize();++i) {
+  data.startCfgBatch();		// Defer structure recalculation until all blocks are removed
+  i = 0;
+  while(i<graph.getSize()) {
     bb = (BlockBasic *) graph.getBlock(i);
     if (bb->isDoNothing()) {
       if ((bb->sizeOut()==1)&&(bb->getOut(0)==bb)) { // Infinite loop
@@ -3476,10 +3542,12 @@ int4 ActionDoNothing::apply(Funcdata &data)
       else if (bb->unblockedMulti(0)) {
 	data.removeDoNothingBlock(bb);
 	count += 1;
-	return 0;
+	continue;		// A new block shifted into slot i
       }
     }
+    i += 1;
   }
+  data.endCfgBatch();
   return 0;
 }
 
@@ -3492,6 +3560,7 @@ int4 ActionRedundBranch::apply(Funcdata &data)
   BlockBasic *bb;
   FlowBlock *bl;
 
+  data.startCfgBatch();		// Defer structure recalculation across the splices
   for(i=0;i<graph.getSize();++i) {
     bb = (BlockBasic *) graph.getBlock(i);
     if (bb->sizeOut() == 0) continue;
@@ -3518,6 +3587,7 @@ int4 ActionRedundBranch::apply(Funcdata &data)
     data.removeBranch(bb,1);	// Remove the branch instruction
     count += 1;
   }
+  data.endCfgBatch();
   return 0;			// Indicate full rule was applied
 }
 
@@ -3529,6 +3599,7 @@ int4 ActionDeterminedBranch::apply(Funcdata &data)
   BlockBasic *bb;
   PcodeOp *cbranch;
 
+  data.startCfgBatch();		// Defer structure recalculation across the branch removals
   for(i=0;i<graph.getSize();++i) {
     bb = (BlockBasic *) graph.getBlock(i);
     cbranch = bb->lastOp();
@@ -3539,22 +3610,36 @@ int4 ActionDeterminedBranch::apply(Funcdata &data)
     data.removeBranch(bb,num);
     count += 1;
   }
+  data.endCfgBatch();
   return 0;
 }
 
+/// The list is emptied and the bit arrays are zeroed, with one word of storage
+/// allocated for every 64 Varnodes in the function.
+/// \param maxIndex is one past the largest Varnode creation index for the function
+void ConsumeWorklist::init(uint4 maxIndex)
+
+{
+  stack.clear();
+  uint4 numWords = (maxIndex >> 6) + 1;
+  vacuous.assign(numWords,0);
+  onlist.assign(numWords,0);
+}
+
 /// Given a new \e consume value to push to a Varnode, determine if this changes
 /// the Varnodes consume value and whether to push the Varnode onto the work-list.
 /// \param val is the new consume value
 /// \param vn is the Varnode to push to
 /// \param worklist is the current work-list
-inline void ActionDeadCode::pushConsumed(uintb val,Varnode *vn,vector<Varnode *> &worklist)
+inline void ActionDeadCode::pushConsumed(uintb val,Varnode *vn,ConsumeWorklist &worklist)
 
 {
-  uintb newval = (val | vn->getConsume())&calc_mask(vn->getSize());
-  if ((newval == vn->getConsume())&&vn->isConsumeVacuous()) return;
-  vn->setConsumeVacuous();
-  if (!vn->isConsumeList()) { // Check if already in list
-    vn->setConsumeList();	// Mark as in the list
+  uintb cur = worklist.isVacuous(vn) ? vn->getConsume() : 0;	// A stale value from an earlier pass reads as zero
+  uintb newval = (val | cur)&calc_mask(vn->getSize());
+  if ((newval == cur)&&worklist.isVacuous(vn)) return;
+  worklist.setVacuous(vn);
+  if (!worklist.isOnList(vn)) { // Check if already in list
+    worklist.setOnList(vn);	// Mark as in the list
     if (vn->isWritten())
       worklist.push_back(vn);	// add to list
   }
@@ -3567,13 +3652,13 @@ inline void ActionDeadCode::pushConsumed(uintb val,Varnode *vn,vector<Varnode *>
 /// \e consumed value is propagated  backward to the inputs of the op
 /// that produced it.
 /// \param worklist is the current stack of dirty Varnodes
-void ActionDeadCode::propagateConsumed(vector<Varnode *> &worklist)
+void ActionDeadCode::propagateConsumed(ConsumeWorklist &worklist)
 
 {
   Varnode *vn = worklist.back();
   worklist.pop_back();
   uintb outc = vn->getConsume();
-  vn->clearConsumeList();
+  worklist.clearOnList(vn);
 
   PcodeOp *op = vn->getDef();	// Assume vn is written
 
@@ -3831,7 +3916,7 @@ bool ActionDeadCode::neverConsumed(Varnode *vn,Funcdata &data)
 /// If the prototype is locked, assume parameters are entirely consumed.
 /// \param fc is the call specification for the given sub-function
 /// \param worklist will hold input Varnodes that can propagate their consume property
-void ActionDeadCode::markConsumedParameters(FuncCallSpecs *fc,vector<Varnode *> &worklist)
+void ActionDeadCode::markConsumedParameters(FuncCallSpecs *fc,ConsumeWorklist &worklist)
 
 {
   PcodeOp *callOp = fc->getOp();
@@ -3893,7 +3978,7 @@ uintb ActionDeadCode::gatherConsumedReturn(Funcdata &data)
 /// \param data is the function being analyzed
 /// \param worklist is the container of consumed Varnodes to further process
 /// \return \b true if there was at least one LOAD added to the worklist
-bool ActionDeadCode::lastChanceLoad(Funcdata &data,vector<Varnode *> &worklist)
+bool ActionDeadCode::lastChanceLoad(Funcdata &data,ConsumeWorklist &worklist)
 
 {
   if (data.getHeritagePass() > 1) return false;
@@ -3906,7 +3991,7 @@ bool ActionDeadCode::lastChanceLoad(Funcdata &data,vector<Varnode *> &worklist)
     ++iter;
     if (op->isDead()) continue;
     Varnode *vn = op->getOut();
-    if (vn->isConsumeVacuous()) continue;
+    if (worklist.isVacuous(vn)) continue;
     if (op->getIn(1)->isEventualConstant(3, 1)) {
       pushConsumed(~(uintb)0, vn, worklist);
       vn->setAutoLiveHold();
@@ -3924,17 +4009,14 @@ int4 ActionDeadCode::apply(Funcdata &data)
   PcodeOp *op;
   Varnode *vn;
   uintb returnConsume;
-  vector<Varnode *> worklist;
+  ConsumeWorklist worklist;
   VarnodeLocSet::const_iterator viter,endviter;
   const AddrSpaceManager *manage = data.getArch();
   AddrSpace *spc;
 
-				// Clear consume flags
+  worklist.init(data.getCreateIndex());	// Stale consume values from an earlier pass are distinguished by the vacuous bits
   for(viter=data.beginLoc();viter!=data.endLoc();++viter) {
     vn = *viter;
-    vn->clearConsumeList();
-    vn->clearConsumeVacuous();
-    vn->setConsume(0);
     if (vn->isAddrForce()&&(!vn->isDirectWrite()))
       vn->clearAddrForce();
   }
@@ -4026,10 +4108,7 @@ int4 ActionDeadCode::apply(Funcdata &data)
     while(viter != endviter) {
       vn = *viter++;		// Advance iterator BEFORE (possibly) deleting varnode
       if (!vn->isWritten()) continue;
-      bool vacflag = vn->isConsumeVacuous();
-      vn->clearConsumeList();
-      vn->clearConsumeVacuous();
-      if (!vacflag) {		// Not even vacuously consumed
+      if (!worklist.isVacuous(vn)) {	// Not even vacuously consumed
 	op = vn->getDef();
 	changecount += 1;
 	if (op->isCall())
@@ -4700,25 +4779,29 @@ int4 ActionHideShadow::apply(Funcdata &data)
 {
   VarnodeDefSet::const_iterator iter,enditer;
   HighVariable *high;
+  vector<Varnode *> markedVn;	// One representative Varnode per marked HighVariable
 
   enditer = data.endDef(Varnode::written);
   for(iter=data.beginDef();iter!=enditer;++iter) {
-    high = (*iter)->getHigh();
+    Varnode *vn = *iter;
+    high = vn->getHigh();
     if (high->isMark()) continue;
     if (data.getMerge().hideShadows(high))
       count += 1;
     high->setMark();
+    markedVn.push_back(vn);
   }
-  for(iter=data.beginDef();iter!=enditer;++iter) {
-    high = (*iter)->getHigh();
-    high->clearMark();
-  }
+  // Clear through the representatives, which remain valid even if hideShadows
+  // merged (and deleted) some of the marked HighVariables
+  for(int4 i=0;i<markedVn.size();++i)
+    markedVn[i]->getHigh()->clearMark();
   return 0;
 }
 
 int4 ActionDynamicMapping::apply(Funcdata &data)
 
 {
+  count += data.applyUnionSalvage();	// Reattach union resolutions surviving a restart
   ScopeLocal *localmap = data.getScopeLocal();
   list<SymbolEntry>::iterator iter,enditer;
   iter = localmap->beginDynamic();
@@ -5064,6 +5147,45 @@ void ActionInferTypes::propagateOneType(TypeFactory *typegrp,Varnode *vn)
   }
 }
 
+/// \brief Propagate the initial (local) data-types of all Varnodes to a fixed point
+///
+/// Every eligible Varnode is placed on a work-list, marked to indicate its presence.
+/// As each Varnode comes off the list, its data-type is pushed across all adjacent
+/// propagation edges.  A Varnode whose (temporary) data-type improves goes back on
+/// the list, so after the initial seeding, work is proportional to the number of
+/// data-type changes rather than to repeated walks of the whole graph.
+/// \param data is the function being analyzed
+void ActionInferTypes::propagateWorklist(Funcdata &data)
+
+{
+  TypeFactory *typegrp = data.getArch()->types;
+  vector<Varnode *> worklist;
+  VarnodeLocSet::const_iterator iter;
+  Varnode *vn;
+
+  for(iter=data.beginLoc();iter!=data.endLoc();++iter) {
+    vn = *iter;
+    if (vn->isAnnotation()) continue;
+    if ((!vn->isWritten())&&(vn->hasNoDescend())) continue;
+    worklist.push_back(vn);
+    vn->setMark();		// Mark indicates presence on the work-list
+  }
+  while(!worklist.empty()) {
+    vn = worklist.back();
+    worklist.pop_back();
+    vn->clearMark();
+    PropagationState prop(vn);
+    while(prop.valid()) {
+      if (propagateTypeEdge(typegrp,prop.op,prop.inslot,prop.slot)) {
+	Varnode *outvn = (prop.slot==-1) ? prop.op->getOut() : prop.op->getIn(prop.slot);
+	worklist.push_back(outvn);	// Data-type improved, so the Varnode must be revisited
+	outvn->setMark();
+      }
+      prop.step();
+    }
+  }
+}
+
 /// \brief Try to propagate a pointer data-type to known aliases.
 ///
 /// Given a Varnode which is a likely pointer and an Address that
@@ -5243,9 +5365,6 @@ int4 ActionInferTypes::apply(Funcdata &data)
 {
   // Make sure spacebase is accurate or bases could get typed and then ptrarithed
   if (!data.hasTypeRecoveryStarted()) return 0;
-  TypeFactory *typegrp = data.getArch()->types;
-  Varnode *vn;
-  VarnodeLocSet::const_iterator iter;
 
 #ifdef TYPEPROP_DEBUG
   if (TypeFactory::propagatedbg_on) {
@@ -5264,12 +5383,7 @@ int4 ActionInferTypes::apply(Funcdata &data)
   }
   data.getScopeLocal()->applyTypeRecommendations();
   buildLocaltypes(data);	// Set up initial types (based on local info)
-  for(iter=data.beginLoc();iter!=data.endLoc();++iter) {
-    vn = *iter;
-    if (vn->isAnnotation()) continue;
-    if ((!vn->isWritten())&&(vn->hasNoDescend())) continue;
-    propagateOneType(typegrp,vn);
-  }
+  propagateWorklist(data);	// Propagate the initial types to their fixed point
   propagateAcrossReturns(data);
   AddrSpace *spcid = data.getScopeLocal()->getSpaceId();
   Varnode *spcvn = data.findSpacebaseInput(spcid);
@@ -5358,6 +5472,19 @@ void ActionDatabase::buildDefaultGroups(void)
 			    "conditionalexe", "" };
   setGroup("decompile",members);
 
+  // Trimmed pipeline for interactive browsing: drops the expensive late
+  // stages (type inference iteration, conditional execution analysis,
+  // split copy/pointer recovery, double-precision recovery) for a faster
+  // first paint.  A full "decompile" run refines the result on demand.
+  const char *preview[] = { "base", "protorecovery", "protorecovery_a", "deindirect", "localrecovery",
+			    "deadcode", "stackptrflow",
+			    "blockrecovery", "stackvars", "deadcontrolflow", "switchnorm",
+			    "cleanup", "merge", "dynamic", "casts", "analysis",
+			    "fixateglobals", "fixateproto", "constsequence",
+			    "segment", "returnsplit", "nodejoin",
+			    "unreachable", "subvar", "floatprecision", "" };
+  setGroup("preview",preview);
+
   const char *jumptab[] = { "base", "noproto", "localrecovery", "deadcode", "stackptrflow",
 			    "stackvars", "analysis", "segment", "subvar", "normalizebranches", "conditionalexe", "" };
   setGroup("jumptable",jumptab);
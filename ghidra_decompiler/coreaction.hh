@@ -186,15 +186,24 @@ public:
 
 /// \brief Check for constants, with pointer type, that correspond to global symbols
 class ActionConstantPtr : public Action {
+  static const int4 filter_pageshift = 12;	///< Log2 of the page size used by the range prefilter
+  static const int4 filter_bits = 1024;		///< Number of bits in the range prefilter
+  static const int4 filter_words = 16;		///< Number of 64-bit words in the range prefilter
   int4 localcount;		///< Number of passes made for this function
+  uint8 rangeFilter[filter_words];	///< Bloom-style prefilter over the valid data address ranges
+  bool filterActive;		///< True if rangeFilter can exclude addresses
   static AddrSpace *searchForSpaceAttribute(Varnode *vn,PcodeOp *op);
   static AddrSpace *selectInferSpace(Varnode *vn,PcodeOp *op,const vector<AddrSpace *> &spaceList);
   static bool checkCopy(PcodeOp *op,Funcdata &data);
-  static SymbolEntry *isPointer(AddrSpace *spc,Varnode *vn,PcodeOp *op,int4 slot,
-				Address &rampoint,uintb &fullEncoding,Funcdata &data);
-public:
-  ActionConstantPtr(const string &g) : Action(0,"constantptr",g) {}	///< Constructor
-  virtual void reset(Funcdata &data) { localcount = 0; }
+  static uint4 filterHash(AddrSpace *spc,uintb page);	///< Map an address page to a prefilter bit position
+  void buildRangeFilter(Funcdata &data);	///< Populate the prefilter from the global address ranges
+  bool possiblePointer(const Address &addr) const;	///< Check if an address passes the range prefilter
+  SymbolEntry *queryCached(const Address &rampoint,Funcdata &data);	///< Search for a symbol, consulting the cache first
+  SymbolEntry *isPointer(AddrSpace *spc,Varnode *vn,PcodeOp *op,int4 slot,
+			 Address &rampoint,uintb &fullEncoding,Funcdata &data);
+public:
+  ActionConstantPtr(const string &g) : Action(0,"constantptr",g) { filterActive = false; }	///< Constructor
+  virtual void reset(Funcdata &data) { localcount = 0; filterActive = false; }
   virtual Action *clone(const ActionGroupList &grouplist) const {
     if (!grouplist.contains(getGroup())) return (Action *)0;
     return new ActionConstantPtr(getGroup());
@@ -531,15 +540,82 @@ public:
   virtual int4 apply(Funcdata &data);
 };
 
+/// \brief Work-list state for the consume-bit propagation in ActionDeadCode
+///
+/// Holds the list of Varnodes whose \e consume value still needs to be propagated,
+/// together with dense bit arrays, indexed by Varnode creation index, recording which
+/// Varnodes have entered the propagation this pass and which are currently on the list.
+/// Keeping these per-pass booleans out of the Varnode objects lets a pass start by
+/// zeroing one word of state for every 64 Varnodes, rather than writing marker flags
+/// and a cleared \e consume value into every Varnode in the function.
+class ConsumeWorklist {
+  vector<Varnode *> stack;	///< Varnodes whose consume value still needs to be propagated
+  vector<uint8> vacuous;	///< One bit for each Varnode that has entered the propagation
+  vector<uint8> onlist;		///< One bit for each Varnode currently on the list
+public:
+  void init(uint4 maxIndex);	///< Clear the state, sizing the bit arrays for the given index bound
+  bool empty(void) const { return stack.empty(); }	///< Return \b true if no Varnodes are left to process
+  void push_back(Varnode *vn) { stack.push_back(vn); }	///< Add a Varnode to the list
+  Varnode *back(void) const { return stack.back(); }	///< Get the most recently added Varnode
+  void pop_back(void) { stack.pop_back(); }		///< Remove the most recently added Varnode
+  bool isVacuous(const Varnode *vn) const;	///< Has the given Varnode entered the propagation
+  void setVacuous(const Varnode *vn);		///< Mark that the given Varnode has entered the propagation
+  bool isOnList(const Varnode *vn) const;	///< Is the given Varnode currently on the list
+  void setOnList(const Varnode *vn);		///< Mark the given Varnode as on the list
+  void clearOnList(const Varnode *vn);		///< Mark the given Varnode as no longer on the list
+};
+
+/// \param vn is the given Varnode
+/// \return \b true if the Varnode has entered the propagation this pass
+inline bool ConsumeWorklist::isVacuous(const Varnode *vn) const
+
+{
+  uint4 index = vn->getCreateIndex();
+  return ((vacuous[index >> 6] >> (index & 0x3f)) & 1) != 0;
+}
+
+/// \param vn is the given Varnode
+inline void ConsumeWorklist::setVacuous(const Varnode *vn)
+
+{
+  uint4 index = vn->getCreateIndex();
+  vacuous[index >> 6] |= ((uint8)1) << (index & 0x3f);
+}
+
+/// \param vn is the given Varnode
+/// \return \b true if the Varnode is currently on the list
+inline bool ConsumeWorklist::isOnList(const Varnode *vn) const
+
+{
+  uint4 index = vn->getCreateIndex();
+  return ((onlist[index >> 6] >> (index & 0x3f)) & 1) != 0;
+}
+
+/// \param vn is the given Varnode
+inline void ConsumeWorklist::setOnList(const Varnode *vn)
+
+{
+  uint4 index = vn->getCreateIndex();
+  onlist[index >> 6] |= ((uint8)1) << (index & 0x3f);
+}
+
+/// \param vn is the given Varnode
+inline void ConsumeWorklist::clearOnList(const Varnode *vn)
+
+{
+  uint4 index = vn->getCreateIndex();
+  onlist[index >> 6] &= ~(((uint8)1) << (index & 0x3f));
+}
+
 /// \brief Dead code removal.  Eliminate \e dead p-code ops
 ///
 /// This is a very fine grained algorithm, it detects usage
 /// of individual bits within the Varnode, not just use of the
 /// Varnode itself.  Each Varnode has a \e consumed word, which
-/// indicates if a bit in the Varnode is being used, and it has
-/// two flags layed out as follows:
-///    - Varnode::lisconsume = varnode is in the working list
-///    - Varnode::vacconsume = vacuously used bit
+/// indicates if a bit in the Varnode is being used.  The work-list
+/// state (ConsumeWorklist) tracks two booleans for each Varnode:
+///    - whether the varnode is in the working list
+///    - the vacuously used bit
 ///            there is a path from the varnode through assignment
 ///            op outputs down to a varnode that is used
 ///
@@ -550,12 +626,12 @@ public:
 /// the particular op being passed through can transform the
 /// "bit usage" vector of the output to obtain the input.
 class ActionDeadCode : public Action {
-  static void pushConsumed(uintb val,Varnode *vn,vector<Varnode *> &worklist);
-  static void propagateConsumed(vector<Varnode *> &worklist);
+  static void pushConsumed(uintb val,Varnode *vn,ConsumeWorklist &worklist);
+  static void propagateConsumed(ConsumeWorklist &worklist);
   static bool neverConsumed(Varnode *vn,Funcdata &data);
-  static void markConsumedParameters(FuncCallSpecs *fc,vector<Varnode *> &worklist);
+  static void markConsumedParameters(FuncCallSpecs *fc,ConsumeWorklist &worklist);
   static uintb gatherConsumedReturn(Funcdata &data);
-  static bool lastChanceLoad(Funcdata &data,vector<Varnode *> &worklist);
+  static bool lastChanceLoad(Funcdata &data,ConsumeWorklist &worklist);
 public:
   ActionDeadCode(const string &g) : Action(0,"deadcode",g) {}	///< Constructor
   virtual Action *clone(const ActionGroupList &grouplist) const {
@@ -950,6 +1026,7 @@ class ActionInferTypes : public Action {
   static bool writeBack(Funcdata &data);		///< Commit the final propagated data-types to Varnodes
   static bool propagateTypeEdge(TypeFactory *typegrp,PcodeOp *op,int4 inslot,int4 outslot);
   static void propagateOneType(TypeFactory *typegrp,Varnode *vn);
+  static void propagateWorklist(Funcdata &data);	///< Propagate all initial data-types to their fixed point
   static void propagateRef(Funcdata &data,Varnode *vn,const Address &addr);
   static void propagateSpacebaseRef(Funcdata &data,Varnode *spcvn);
   static PcodeOp *canonicalReturnOp(Funcdata &data);
@@ -272,6 +272,7 @@ int4 Cover::intersect(const Cover &op2) const
   map<int4,CoverBlock>::const_iterator iter,iter2;
   int4 res,newres;
 
+  if (!maskIntersect(op2)) return 0;	// Bitsets prove the Covers touch no common block
   res = 0;
   iter = cover.begin();
   iter2 = op2.cover.begin();
@@ -311,6 +312,7 @@ void Cover::intersectList(vector<int4> &listout,const Cover &op2,int4 level) con
   int4 val;
 
   listout.clear();
+  if (!maskIntersect(op2)) return;	// Bitsets prove the Covers touch no common block
 
   iter = cover.begin();
   iter2 = op2.cover.begin();
@@ -461,14 +463,46 @@ int4 Cover::containVarnodeDef(const Varnode *vn) const
   return 0;
 }
 
+/// The given block index is recorded in the summary bitset, growing the
+/// bitset as necessary.
+/// \param index is the block index to mark
+void Cover::maskBlock(int4 index)
+
+{
+  int4 word = index >> 5;
+  while(blockmask.size() <= word)
+    blockmask.push_back(0);
+  blockmask[word] |= ((uintm)1) << (index & 0x1f);
+}
+
+/// The bitsets cannot miss a covered block, so a \b false result proves the
+/// two Covers touch no common block and the precise CoverBlock ranges need
+/// not be consulted.
+/// \param op2 is the other Cover
+/// \return \b true if the summary bitsets share a block index
+bool Cover::maskIntersect(const Cover &op2) const
+
+{
+  int4 num = blockmask.size();
+  if (op2.blockmask.size() < num)
+    num = op2.blockmask.size();
+  for(int4 i=0;i<num;++i) {
+    if ((blockmask[i] & op2.blockmask[i]) != 0)
+      return true;
+  }
+  return false;
+}
+
 /// \param op2 is the other Cover
 void Cover::merge(const Cover &op2)
 
 {
   map<int4,CoverBlock>::const_iterator iter;
 
-  for(iter=op2.cover.begin();iter!=op2.cover.end();++iter)
+  for(iter=op2.cover.begin();iter!=op2.cover.end();++iter) {
     cover[(*iter).first].merge((*iter).second);
+    maskBlock((*iter).first);
+  }
 }
 
 /// The cover is set to all p-code ops between the point where
@@ -503,16 +537,18 @@ void Cover::addDefPoint(const Varnode *vn)
 {
   const PcodeOp *def;
 
-  cover.clear();
+  clear();
 
   def = vn->getDef();
   if (def != (const PcodeOp *)0) {
     CoverBlock &block( cover[def->getParent()->getIndex() ] );
+    maskBlock(def->getParent()->getIndex());
     block.setBegin(def);	// Set the point topology
     block.setEnd(def);
   }
   else if (vn->isInput()) {
     CoverBlock &block( cover[0] );
+    maskBlock(0);
     block.setBegin( (const PcodeOp *)2 ); // Special mark for input
     block.setEnd( (const PcodeOp *)2 );
   }
@@ -528,6 +564,7 @@ void Cover::addRefRecurse(const FlowBlock *bl)
   uintm ustart,ustop;
 
   CoverBlock &block(cover[bl->getIndex()]);
+  maskBlock(bl->getIndex());
   if (block.empty()) {
     block.setAll();		// No cover encountered, fill in entire block
     //    if (bl->InSize()==0)
@@ -571,6 +608,7 @@ void Cover::addRefPoint(const PcodeOp *ref,const Varnode *vn)
 
   bl = ref->getParent();
   CoverBlock &block(cover[bl->getIndex()]);
+  maskBlock(bl->getIndex());
   if (block.empty()) {
     block.setEnd(ref);
   }
@@ -107,10 +107,13 @@ public:
 /// Internally this is implemented as a map from basic block to their non-empty CoverBlock
 class Cover {
   map<int4,CoverBlock> cover; 			///< block index -> CoverBlock
+  vector<uintm> blockmask;			///< Bitset over block indices summarizing which blocks are covered
   static const CoverBlock emptyBlock;		///< Global empty CoverBlock for blocks not covered by \b this
   void addRefRecurse(const FlowBlock *bl);	///< Fill-in \b this recursively from the given block
+  void maskBlock(int4 index);			///< Mark a block index in the summary bitset
+  bool maskIntersect(const Cover &op2) const;	///< Do the summary bitsets share a block index?
 public:
-  void clear(void) { cover.clear(); }		///< Clear \b this to an empty Cover
+  void clear(void) { cover.clear(); blockmask.clear(); }	///< Clear \b this to an empty Cover
   int4 compareTo(const Cover &op2) const;	///< Give ordering of \b this and another Cover
   const CoverBlock &getCoverBlock(int4 i) const;	///< Get the CoverBlock corresponding to the i-th block
   int4 intersect(const Cover &op2) const;	///< Characterize the intersection between \b this and another Cover.
@@ -197,18 +197,27 @@ CPoolRecord *ConstantPoolInternal::createRecord(const vector<uintb> &refs)
 
 {
   CheapSorter sorter(refs);
-  pair<map<CheapSorter,CPoolRecord>::iterator,bool> res;
+  pair<unordered_map<CheapSorter,CPoolRecord,SorterHash>::iterator,bool> res;
   res = cpoolMap.emplace(piecewise_construct,forward_as_tuple(sorter),forward_as_tuple());
   if (res.second == false)
     throw LowlevelError("Creating duplicate entry in constant pool: "+(*res.first).second.getToken());
   return &(*res.first).second;
 }
 
+/// \param a is the first reference to compare
+/// \param b is the second reference
+/// \return \b true if the first reference lexicographically precedes the second
+bool ConstantPoolInternal::sortByReference(const CheapSorter *a,const CheapSorter *b)
+
+{
+  return (*a < *b);
+}
+
 const CPoolRecord *ConstantPoolInternal::getRecord(const vector<uintb> &refs) const
 
 {
   CheapSorter sorter(refs);
-  map<CheapSorter,CPoolRecord>::const_iterator iter = cpoolMap.find(sorter);
+  unordered_map<CheapSorter,CPoolRecord,SorterHash>::const_iterator iter = cpoolMap.find(sorter);
   if (iter == cpoolMap.end())
     return (CPoolRecord *)0;
 
@@ -218,11 +227,17 @@ const CPoolRecord *ConstantPoolInternal::getRecord(const vector<uintb> &refs) co
 void ConstantPoolInternal::encode(Encoder &encoder) const
 
 {
-  map<CheapSorter,CPoolRecord>::const_iterator iter;
+  unordered_map<CheapSorter,CPoolRecord,SorterHash>::const_iterator iter;
+  vector<const CheapSorter *> sortlist;	// Emit records in reference order for a reproducible stream
+  sortlist.reserve(cpoolMap.size());
+  for(iter=cpoolMap.begin();iter!=cpoolMap.end();++iter)
+    sortlist.push_back(&(*iter).first);
+  std::sort(sortlist.begin(),sortlist.end(),sortByReference);
   encoder.openElement(ELEM_CONSTANTPOOL);
-  for(iter=cpoolMap.begin();iter!=cpoolMap.end();++iter) {
-    (*iter).first.encode(encoder);
-    (*iter).second.encode(encoder);
+  for(int4 i=0;i<sortlist.size();++i) {
+    const CheapSorter &sorter( *sortlist[i] );
+    sorter.encode(encoder);
+    (*cpoolMap.find(sorter)).second.encode(encoder);
   }
   encoder.closeElement(ELEM_CONSTANTPOOL);
 }
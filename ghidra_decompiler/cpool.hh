@@ -189,6 +189,14 @@ class ConstantPoolInternal : public ConstantPool {
       return (b < op2.b);
     }
 
+    /// \brief Test equality of two references
+    ///
+    /// \param op2 is the reference to compare with \b this
+    /// \return \b true if the references are identical
+    bool operator==(const CheapSorter &op2) const {
+      return ((a == op2.a)&&(b == op2.b));
+    }
+
     /// \brief Convert the reference back to a formal array of integers
     ///
     /// \param refs is the provided container of integers
@@ -197,7 +205,22 @@ class ConstantPoolInternal : public ConstantPool {
     void encode(Encoder &encoder) const;	///< Encode the \e reference to a stream
     void decode(Decoder &decoder);		///< Decode the \e reference from a stream
   };
-  map<CheapSorter,CPoolRecord> cpoolMap;	///< A map from \e reference to constant pool record
+  /// \brief Hash function for a CheapSorter \e reference
+  struct SorterHash {
+    /// \brief Mix both integers of a reference into a hash bucket index
+    ///
+    /// \param val is the reference to hash
+    /// \return the hash value
+    size_t operator()(const CheapSorter &val) const {
+      uint8 res = val.a;
+      res *= 0x100000001b3;	// FNV-1a style mixing of the two reference integers
+      res ^= val.b;
+      res *= 0x100000001b3;
+      return (size_t)(res ^ (res >> 32));
+    }
+  };
+  unordered_map<CheapSorter,CPoolRecord,SorterHash> cpoolMap;	///< A hash map from \e reference to constant pool record
+  static bool sortByReference(const CheapSorter *a,const CheapSorter *b);	///< Compare two references for sorted encoding
   virtual CPoolRecord *createRecord(const vector<uintb> &refs);
 public:
   virtual const CPoolRecord *getRecord(const vector<uintb> &refs) const;
@@ -33,5 +33,7 @@ extern uint4 crc32tab[];	///< Table for quickly computing a 32-bit Cyclic Redund
 inline uint4 crc_update(uint4 reg,uint4 val) {
   return crc32tab[(reg ^ val)&0xff] ^ (reg>>8); }
 
+extern uint4 crc_update_bytes(uint4 reg,const uint1 *buf,int4 size);	///< Feed an array of bytes into a CRC register
+
 } // End namespace ghidra
 #endif
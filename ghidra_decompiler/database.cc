@@ -1106,6 +1106,8 @@ void Scope::addRange(AddrSpace *spc,uintb first,uintb last)
 
 {
   rangetree.insertRange(spc,first,last);
+  if (glb->symboltab != (Database *)0)
+    glb->symboltab->bumpChangeCounter();
 }
 
 /// \param spc is the address space of the range
@@ -1115,6 +1117,8 @@ void Scope::removeRange(AddrSpace *spc,uintb first,uintb last)
 
 {
   rangetree.removeRange(spc,first,last);
+  if (glb->symboltab != (Database *)0)
+    glb->symboltab->bumpChangeCounter();
 }
 
 /// The mapping is given as an unintegrated SymbolEntry object. Memory
@@ -1810,6 +1814,8 @@ Scope *ScopeInternal::buildSubScope(uint8 id,const string &nm)
 void ScopeInternal::addSymbolInternal(Symbol *sym)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
+  glb->symboltab->bumpChangeCounter();
   if (sym->symbolId == 0) {
     sym->symbolId = Symbol::ID_BASE + ((uniqueId & 0xffff) << 40) + nextUniqueId;
     nextUniqueId += 1;
@@ -1843,6 +1849,8 @@ void ScopeInternal::addSymbolInternal(Symbol *sym)
 SymbolEntry *ScopeInternal::addMapInternal(Symbol *sym,uint4 exfl,const Address &addr,int4 off,int4 sz,
 					   const RangeList &uselim)
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
+  glb->symboltab->bumpChangeCounter();
   // Find or create the appropriate rangemap
   AddrSpace *spc = addr.getSpace();
   EntryMap *rangemap = maptable[spc->getIndex()];
@@ -1874,6 +1882,7 @@ SymbolEntry *ScopeInternal::addMapInternal(Symbol *sym,uint4 exfl,const Address
 SymbolEntry *ScopeInternal::addDynamicMapInternal(Symbol *sym,uint4 exfl,uint8 hash,int4 off,int4 sz,
 						  const RangeList &uselim)
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
   dynamicentry.push_back(SymbolEntry(sym,exfl,hash,off,sz,uselim));
   list<SymbolEntry>::iterator iter = dynamicentry.end();
   --iter;
@@ -1886,9 +1895,77 @@ SymbolEntry *ScopeInternal::addDynamicMapInternal(Symbol *sym,uint4 exfl,uint8 h
   return &dynamicentry.back();
 }
 
+/// The record is stored in a compact table, and the full Symbol and SymbolEntry objects
+/// are not built until a query actually hits the record's address range or searches by
+/// name.  The symbol is eventually materialized with an \e unknown data-type of the
+/// recorded size.  This lets a large import populate the Scope without paying for
+/// symbols that are never viewed.
+/// \param nm is the name of the symbol
+/// \param addr is the starting address of the symbol's storage
+/// \param size is the number of bytes in the storage
+void ScopeInternal::addDeferred(const string &nm,const Address &addr,int4 size)
+
+{
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
+  glb->symboltab->bumpChangeCounter();
+  DeferredSymbol rec;
+  rec.name = nm;
+  rec.addr = addr;
+  rec.size = size;
+  deferredsymbols.insert(std::make_pair(addr,rec));
+  if (size > deferredmaxsize)
+    deferredmaxsize = size;
+}
+
+/// Deferred records overlapping the given range are removed from the deferred table,
+/// and full Symbol objects are constructed for them via addSymbol().
+/// \param addr is the starting address of the range being queried
+/// \param size is the number of bytes in the range
+void ScopeInternal::materializeRange(const Address &addr,int4 size) const
+
+{
+  vector<DeferredSymbol> hits;
+  std::multimap<Address,DeferredSymbol>::iterator iter;
+  iter = deferredsymbols.upper_bound(addr + (size-1));
+  while(iter != deferredsymbols.begin()) {
+    --iter;
+    const Address &start( (*iter).first );
+    if (start.getSpace() != addr.getSpace()) break;
+    if (addr.getOffset() > start.getOffset() &&
+	addr.getOffset() - start.getOffset() >= (uintb)deferredmaxsize)
+      break;			// No earlier record can reach the queried range
+    const DeferredSymbol &rec( (*iter).second );
+    if (start.getOffset() + (rec.size-1) >= addr.getOffset()) {
+      hits.push_back(rec);
+      iter = deferredsymbols.erase(iter);
+    }
+  }
+  for(int4 i=0;i<hits.size();++i) {
+    DeferredSymbol &rec( hits[i] );
+    Datatype *ct = glb->types->getBase(rec.size,TYPE_UNKNOWN);
+    const_cast<ScopeInternal *>(this)->addSymbol(rec.name,ct,rec.addr,Address());
+  }
+}
+
+/// Every remaining deferred record is converted into a full Symbol.  This is required
+/// before any operation that enumerates the Scope or searches it by name.
+void ScopeInternal::materializeAll(void) const
+
+{
+  while(!deferredsymbols.empty()) {
+    DeferredSymbol rec = (*deferredsymbols.begin()).second;
+    deferredsymbols.erase(deferredsymbols.begin());
+    Datatype *ct = glb->types->getBase(rec.size,TYPE_UNKNOWN);
+    const_cast<ScopeInternal *>(this)->addSymbol(rec.name,ct,rec.addr,Address());
+  }
+}
+
 MapIterator ScopeInternal::begin(void) const
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
+  if (!deferredsymbols.empty())
+    materializeAll();
   // The symbols are ordered via their mapping address
   vector<EntryMap *>::const_iterator iter;
   iter = maptable.begin();
@@ -1914,6 +1991,7 @@ MapIterator ScopeInternal::begin(void) const
 MapIterator ScopeInternal::end(void) const
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
   list<SymbolEntry>::const_iterator curiter;
   return MapIterator(&maptable,maptable.end(),curiter);
 }
@@ -1921,24 +1999,28 @@ MapIterator ScopeInternal::end(void) const
 list<SymbolEntry>::const_iterator ScopeInternal::beginDynamic(void) const
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
   return dynamicentry.begin();
 }
 
 list<SymbolEntry>::const_iterator ScopeInternal::endDynamic(void) const
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
   return dynamicentry.end();
 }
 
 list<SymbolEntry>::iterator ScopeInternal::beginDynamic(void)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
   return dynamicentry.begin();
 }
 
 list<SymbolEntry>::iterator ScopeInternal::endDynamic(void)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
   return dynamicentry.end();
 }
 
@@ -1949,6 +2031,7 @@ ScopeInternal::ScopeInternal(uint8 id,const string &nm,Architecture *g)
   : Scope(id,nm,g,this)
 {
   nextUniqueId = 0;
+  deferredmaxsize = 0;
   maptable.resize(g->numSpaces(),(EntryMap *)0);
 }
 
@@ -1956,6 +2039,7 @@ ScopeInternal::ScopeInternal(uint8 id,const string &nm,Architecture *g, Scope *o
   : Scope(id,nm,g,own)
 {
   nextUniqueId = 0;
+  deferredmaxsize = 0;
   maptable.resize(g->numSpaces(),(EntryMap *)0);
 }
 
@@ -1977,8 +2061,12 @@ ScopeInternal::~ScopeInternal(void)
 void ScopeInternal::clear(void)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
+  glb->symboltab->bumpChangeCounter();
   SymbolNameTree::iterator iter;
 
+  deferredsymbols.clear();	// Unmaterialized records are dropped along with the symbols
+  deferredmaxsize = 0;
   iter = nametree.begin();
   while(iter!=nametree.end()) {
     Symbol *sym = *iter++;
@@ -1992,6 +2080,7 @@ void ScopeInternal::clear(void)
 void ScopeInternal::categorySanity(void)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
   for(int4 i=0;i<category.size();++i) {
     int4 num = category[i].size();
     if (num == 0) continue;
@@ -2020,6 +2109,8 @@ void ScopeInternal::categorySanity(void)
 void ScopeInternal::clearCategory(int4 cat)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
+  glb->symboltab->bumpChangeCounter();
   if (cat >= 0) {
     if (cat >= category.size()) return;	// Category doesn't exist
     int4 sz = category[cat].size();
@@ -2042,8 +2133,12 @@ void ScopeInternal::clearCategory(int4 cat)
 void ScopeInternal::clearUnlocked(void)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
+  glb->symboltab->bumpChangeCounter();
   SymbolNameTree::iterator iter;
 
+  deferredsymbols.clear();	// Unmaterialized records would come back unlocked; drop them
+  deferredmaxsize = 0;
   iter = nametree.begin();
   while(iter!=nametree.end()) {
     Symbol *sym = *iter++;
@@ -2071,6 +2166,8 @@ void ScopeInternal::clearUnlocked(void)
 void ScopeInternal::clearUnlockedCategory(int4 cat)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
+  glb->symboltab->bumpChangeCounter();
   if (cat >= 0) {
     if (cat >= category.size()) return;	// Category doesn't exist
     int4 sz = category[cat].size();
@@ -2111,12 +2208,15 @@ void ScopeInternal::clearUnlockedCategory(int4 cat)
 void ScopeInternal::adjustCaches(void)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
   maptable.resize(glb->numSpaces(),(EntryMap *)0);
 }
 
 void ScopeInternal::removeSymbolMappings(Symbol *symbol)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
+  glb->symboltab->bumpChangeCounter();
   vector<list<SymbolEntry>::iterator>::iterator iter;
 
   if (symbol->wholeCount > 1)
@@ -2138,6 +2238,8 @@ void ScopeInternal::removeSymbolMappings(Symbol *symbol)
 void ScopeInternal::removeSymbol(Symbol *symbol)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
+  glb->symboltab->bumpChangeCounter();
   if (symbol->category >= 0) {
     vector<Symbol *> &list(category[symbol->category]);
     list[symbol->catindex] = (Symbol *)0;
@@ -2145,6 +2247,7 @@ void ScopeInternal::removeSymbol(Symbol *symbol)
       list.pop_back();
   }
   removeSymbolMappings(symbol);
+  eraseNameHash(symbol);
   nametree.erase(symbol);
   delete symbol;
 }
@@ -2152,7 +2255,9 @@ void ScopeInternal::removeSymbol(Symbol *symbol)
 void ScopeInternal::renameSymbol(Symbol *sym,const string &newname)
 
 {
-  nametree.erase(sym);		// Erase under old name
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
+  eraseNameHash(sym);		// Erase under old name
+  nametree.erase(sym);
   if (sym->wholeCount > 1)
     multiEntrySet.erase(sym);	// The multi-entry set is sorted by name, remove
   string oldname = sym->name;
@@ -2166,6 +2271,8 @@ void ScopeInternal::renameSymbol(Symbol *sym,const string &newname)
 void ScopeInternal::retypeSymbol(Symbol *sym,Datatype *ct)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
+  glb->symboltab->bumpChangeCounter();
   if (ct->hasStripped())
     ct = ct->getStripped();
   if ((sym->type->getSize() == ct->getSize())||(sym->mapentry.empty())) { 
@@ -2200,6 +2307,8 @@ void ScopeInternal::retypeSymbol(Symbol *sym,Datatype *ct)
 void ScopeInternal::setAttribute(Symbol *sym,uint4 attr)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
+  glb->symboltab->bumpChangeCounter();
   attr &= (Varnode::typelock | Varnode::namelock | Varnode::readonly | Varnode::incidental_copy |
 	   Varnode::nolocalalias | Varnode::volatil | Varnode::indirectstorage | Varnode::hiddenretparm);
   sym->flags |= attr;
@@ -2209,6 +2318,8 @@ void ScopeInternal::setAttribute(Symbol *sym,uint4 attr)
 void ScopeInternal::clearAttribute(Symbol *sym,uint4 attr)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
+  glb->symboltab->bumpChangeCounter();
   attr &= (Varnode::typelock | Varnode::namelock | Varnode::readonly | Varnode::incidental_copy |
 	   Varnode::nolocalalias | Varnode::volatil | Varnode::indirectstorage | Varnode::hiddenretparm);
   sym->flags &= ~attr;
@@ -2218,12 +2329,16 @@ void ScopeInternal::clearAttribute(Symbol *sym,uint4 attr)
 void ScopeInternal::setDisplayFormat(Symbol *sym,uint4 attr)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
   sym->setDisplayFormat(attr);
 }
 
 SymbolEntry *ScopeInternal::findAddr(const Address &addr,const Address &usepoint) const
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
+  if (!deferredsymbols.empty())	// Build any deferred symbols overlapping the query first
+    materializeRange(addr,1);
   EntryMap *rangemap = maptable[ addr.getSpace()->getIndex() ];
   if (rangemap != (EntryMap *)0) {
     pair<EntryMap::const_iterator,EntryMap::const_iterator> res;
@@ -2250,6 +2365,9 @@ SymbolEntry *ScopeInternal::findAddr(const Address &addr,const Address &usepoint
 SymbolEntry *ScopeInternal::findContainer(const Address &addr,int4 size,
 						   const Address &usepoint) const
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
+  if (!deferredsymbols.empty())
+    materializeRange(addr,size);
   SymbolEntry *bestentry = (SymbolEntry *)0;
   EntryMap *rangemap = maptable[ addr.getSpace()->getIndex() ];
   if (rangemap != (EntryMap *)0) {
@@ -2284,6 +2402,9 @@ SymbolEntry *ScopeInternal::findContainer(const Address &addr,int4 size,
 SymbolEntry *ScopeInternal::findClosestFit(const Address &addr,int4 size,
 					   const Address &usepoint) const
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
+  if (!deferredsymbols.empty())
+    materializeRange(addr,size);
   SymbolEntry *bestentry = (SymbolEntry *)0;
   EntryMap *rangemap = maptable[ addr.getSpace()->getIndex() ];
   if (rangemap != (EntryMap *)0) {
@@ -2321,6 +2442,9 @@ SymbolEntry *ScopeInternal::findClosestFit(const Address &addr,int4 size,
 Funcdata *ScopeInternal::findFunction(const Address &addr) const
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
+  if (!deferredsymbols.empty())
+    materializeRange(addr,1);
   FunctionSymbol *sym;
   EntryMap *rangemap = maptable[ addr.getSpace()->getIndex() ];
   if (rangemap != (EntryMap *)0) {
@@ -2342,6 +2466,9 @@ Funcdata *ScopeInternal::findFunction(const Address &addr) const
 ExternRefSymbol *ScopeInternal::findExternalRef(const Address &addr) const
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
+  if (!deferredsymbols.empty())
+    materializeRange(addr,1);
   ExternRefSymbol *sym = (ExternRefSymbol *)0;
   EntryMap *rangemap = maptable[ addr.getSpace()->getIndex() ];
   if (rangemap != (EntryMap *)0) {
@@ -2368,6 +2495,9 @@ Funcdata *ScopeInternal::resolveExternalRefFunction(ExternRefSymbol *sym) const
 LabSymbol *ScopeInternal::findCodeLabel(const Address &addr) const
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
+  if (!deferredsymbols.empty())
+    materializeRange(addr,1);
   LabSymbol *sym = (LabSymbol *)0;
   EntryMap *rangemap = maptable[ addr.getSpace()->getIndex() ];
   if (rangemap != (EntryMap *)0) {
@@ -2392,6 +2522,9 @@ LabSymbol *ScopeInternal::findCodeLabel(const Address &addr) const
 SymbolEntry *ScopeInternal::findOverlap(const Address &addr,int4 size) const
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
+  if (!deferredsymbols.empty())
+    materializeRange(addr,size);
   EntryMap *rangemap = maptable[ addr.getSpace()->getIndex() ];
   if (rangemap != (EntryMap *)0) {
     EntryMap::const_iterator iter;
@@ -2405,23 +2538,33 @@ SymbolEntry *ScopeInternal::findOverlap(const Address &addr,int4 size) const
 void ScopeInternal::findByName(const string &nm,vector<Symbol *> &res) const
 
 {
-  SymbolNameTree::const_iterator iter = findFirstByName(nm);
-  while(iter != nametree.end()) {
-    Symbol *sym = *iter;
-    if (sym->name != nm) break;
-    res.push_back(sym);
-    ++iter;
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
+  if (!deferredsymbols.empty())	// Name searches must see every symbol
+    materializeAll();
+  int4 start = res.size();
+  pair<unordered_multimap<uint8,Symbol *>::const_iterator,unordered_multimap<uint8,Symbol *>::const_iterator> range;
+  range = namehash.equal_range(hashSymbolName(nm));
+  while(range.first != range.second) {
+    Symbol *sym = (*range.first).second;
+    if (sym->name == nm)
+      res.push_back(sym);
+    ++range.first;
   }
+  sort(res.begin()+start,res.end(),SymbolCompareName());	// Present in deduplication order, as the nametree would
 }
 
 bool ScopeInternal::isNameUsed(const string &nm,const Scope *op2) const
 
 {
-  Symbol sym((Scope *)0,nm,(Datatype *)0);
-  SymbolNameTree::const_iterator iter = nametree.lower_bound(&sym);
-  if (iter != nametree.end()) {
-    if ((*iter)->getName() == nm)
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
+  if (!deferredsymbols.empty())	// Name searches must see every symbol
+    materializeAll();
+  pair<unordered_multimap<uint8,Symbol *>::const_iterator,unordered_multimap<uint8,Symbol *>::const_iterator> range;
+  range = namehash.equal_range(hashSymbolName(nm));
+  while(range.first != range.second) {
+    if ((*range.first).second->getName() == nm)
       return true;
+    ++range.first;
   }
   Scope *par = getParent();
   if (par == (Scope *)0 || par == op2)
@@ -2435,6 +2578,7 @@ string ScopeInternal::buildVariableName(const Address &addr,
 					const Address &pc,
 					Datatype *ct,int4 &index,uint4 flags) const
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
   ostringstream s;
   int4 sz = (ct == (Datatype *)0) ? 1 : ct->getSize();
 
@@ -2520,6 +2664,7 @@ string ScopeInternal::buildVariableName(const Address &addr,
 string ScopeInternal::buildUndefinedName(void) const
 
 { // We maintain a family of officially undefined names
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
   // so that symbols can be stored in the database without
   // having their name defined
   // We generate a name of the form '$$undefXXXXXXXX'
@@ -2553,6 +2698,7 @@ string ScopeInternal::buildUndefinedName(void) const
 string ScopeInternal::makeNameUnique(const string &nm) const
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
   SymbolNameTree::const_iterator iter = findFirstByName(nm);
   if (iter == nametree.end()) return nm; // nm is already unique
 
@@ -2616,6 +2762,9 @@ string ScopeInternal::makeNameUnique(const string &nm) const
 void ScopeInternal::encode(Encoder &encoder) const
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
+  if (!deferredsymbols.empty())	// Saving must see every symbol
+    materializeAll();
   encoder.openElement(ELEM_SCOPE);
   encoder.writeString(ATTRIB_NAME, name);
   encoder.writeUnsignedInteger(ATTRIB_ID, uniqueId);
@@ -2708,6 +2857,7 @@ void ScopeInternal::decodeCollision(Decoder &decoder)
 /// \brief Insert a Symbol into the \b nametree
 ///
 /// Duplicate symbol names are allowed for by establishing a deduplication id for the Symbol.
+/// The Symbol is also entered into the \b namehash index.
 /// \param sym is the Symbol to insert
 void ScopeInternal::insertNameTree(Symbol *sym)
 
@@ -2724,6 +2874,38 @@ void ScopeInternal::insertNameTree(Symbol *sym)
     if (!nameres.second)
       throw LowlevelError("Could  not deduplicate symbol: "+sym->name);
   }
+  namehash.insert(pair<uint8,Symbol *>(hashSymbolName(sym->name),sym));
+}
+
+/// The hash is an FNV-1a over the characters of the name.
+/// \param nm is the symbol name to hash
+/// \return the hash key
+uint8 ScopeInternal::hashSymbolName(const string &nm)
+
+{
+  uint8 res = 0xcbf29ce484222325;
+  for(int4 i=0;i<nm.size();++i) {
+    res ^= (uint8)(uint1)nm[i];
+    res *= 0x100000001b3;
+  }
+  return res;
+}
+
+/// Symbols sharing a hash bucket are distinguished by pointer identity.
+/// The Symbol must still carry the name it was indexed under.
+/// \param sym is the Symbol to remove from the index
+void ScopeInternal::eraseNameHash(Symbol *sym)
+
+{
+  pair<unordered_multimap<uint8,Symbol *>::iterator,unordered_multimap<uint8,Symbol *>::iterator> range;
+  range = namehash.equal_range(hashSymbolName(sym->name));
+  while(range.first != range.second) {
+    if ((*range.first).second == sym) {
+      namehash.erase(range.first);
+      return;
+    }
+    ++range.first;
+  }
 }
 
 /// \brief Find an iterator pointing to the first Symbol in the ordering with a given name
@@ -2744,6 +2926,7 @@ SymbolNameTree::const_iterator ScopeInternal::findFirstByName(const string &nm)
 void ScopeInternal::decode(Decoder &decoder)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
 //  uint4 elemId = decoder.openElement(ELEM_SCOPE);
 //  name = el->getAttributeValue("name");	// Name must already be set in the constructor
   bool rangeequalssymbols = false;
@@ -2791,6 +2974,9 @@ void ScopeInternal::decode(Decoder &decoder)
 void ScopeInternal::printEntries(ostream &s) const
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
+  if (!deferredsymbols.empty())
+    materializeAll();
   s << "Scope " << name << endl;
   for(int4 i=0;i<maptable.size();++i) {
     EntryMap *rangemap = maptable[i];
@@ -2806,6 +2992,7 @@ void ScopeInternal::printEntries(ostream &s) const
 int4 ScopeInternal::getCategorySize(int4 cat) const
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
   if ((cat >= category.size())||(cat<0))
     return 0;
   return category[cat].size();
@@ -2814,6 +3001,7 @@ int4 ScopeInternal::getCategorySize(int4 cat) const
 Symbol *ScopeInternal::getCategorySymbol(int4 cat,int4 ind) const
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
   if ((cat >= category.size())||(cat<0))
     return (Symbol *)0;
   if ((ind < 0)||(ind >= category[cat].size()))
@@ -2824,6 +3012,7 @@ Symbol *ScopeInternal::getCategorySymbol(int4 cat,int4 ind) const
 void ScopeInternal::setCategory(Symbol *sym,int4 cat,int4 ind)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
   if (sym->category >= 0) {
     vector<Symbol *> &list(category[sym->category]);
     list[sym->catindex] = (Symbol *)0;
@@ -2850,6 +3039,7 @@ void ScopeInternal::setCategory(Symbol *sym,int4 cat,int4 ind)
 void ScopeInternal::assignDefaultNames(int4 &base)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(scopelock);
   SymbolNameTree::const_iterator iter;
 
   Symbol testsym((Scope *)0,"$$undef",(Datatype *)0);
@@ -2928,6 +3118,7 @@ Database::Database(Architecture *g,bool idByName)
   globalscope=(Scope *)0;
   flagbase.defaultValue()=0;
   idByNameHash=idByName;
+  changeCounter=0;
 }
 
 Database::~Database(void)
@@ -2985,6 +3176,7 @@ void Database::adjustCaches(void)
 void Database::deleteScope(Scope *scope)
 
 {
+  bumpChangeCounter();
   clearReferences(scope);
   if (globalscope == scope) {
     globalscope = (Scope *)0;
@@ -3003,6 +3195,7 @@ void Database::deleteScope(Scope *scope)
 void Database::deleteSubScopes(Scope *scope)
 
 {
+  bumpChangeCounter();
   ScopeMap::iterator iter = scope->children.begin();
   ScopeMap::iterator enditer = scope->children.end();
   ScopeMap::iterator curiter;
@@ -3220,6 +3413,7 @@ Scope *Database::mapScope(Scope *qpoint,const Address &addr,
 void Database::setPropertyRange(uint4 flags,const Range &range)
 
 {
+  bumpChangeCounter();
   Address addr1 = range.getFirstAddr();
   Address addr2 = range.getLastAddrOpen(glb);
   flagbase.split(addr1);
@@ -3236,6 +3430,7 @@ void Database::setPropertyRange(uint4 flags,const Range &range)
     (*aiter).second |= flags;
     ++aiter;
   }
+  flagbase.prepareReads();	// Callers hold the lock excluding getProperty() readers
 }
 
 /// The non-zero bits in the \b flags parameter indicate the boolean properties to be cleared.
@@ -3245,6 +3440,7 @@ void Database::setPropertyRange(uint4 flags,const Range &range)
 void Database::clearPropertyRange(uint4 flags,const Range &range)
 
 {
+  bumpChangeCounter();
   Address addr1 = range.getFirstAddr();
   Address addr2 = range.getLastAddrOpen(glb);
   flagbase.split(addr1);
@@ -3262,6 +3458,7 @@ void Database::clearPropertyRange(uint4 flags,const Range &range)
     (*aiter).second &= flags;
     ++aiter;
   }
+  flagbase.prepareReads();	// Callers hold the lock excluding getProperty() readers
 }
 
 /// Encode a single \<db> element to the stream, which contains child elements
@@ -3333,6 +3530,7 @@ void Database::decode(Decoder &decoder)
     decoder.closeElement(subId);
     flagbase.split(addr) = val;
   }
+  flagbase.prepareReads();
 
   for(;;) {
     uint4 subId = decoder.openElement();
@@ -26,6 +26,7 @@
 #include "variable.hh"
 #include "partmap.hh"
 #include "rangemap.hh"
+#include <mutex>
 
 namespace ghidra {
 
@@ -503,8 +504,6 @@ protected:
 					  const Address &addr,
 					  LabSymbol **addrmatch);
 
-  const RangeList &getRangeTree(void) const { return rangetree; }	///< Access the address ranges owned by \b this Scope
-
   /// \brief Build an unattached Scope to be associated as a sub-scope of \b this
   ///
   /// This is a Scope object \e factory, intended to be called off of the global scope for building
@@ -570,6 +569,7 @@ public:
 #endif
   }
   virtual ~Scope(void);						///< Destructor
+  const RangeList &getRangeTree(void) const { return rangetree; }	///< Access the address ranges owned by \b this Scope
   virtual MapIterator begin(void) const=0;			///< Beginning iterator to mapped SymbolEntrys
   virtual MapIterator end(void) const=0;			///< Ending iterator to mapped SymbolEntrys
   virtual list<SymbolEntry>::const_iterator beginDynamic(void) const=0;	///< Beginning iterator to dynamic SymbolEntrys
@@ -796,10 +796,22 @@ public:
 /// a set of Symbol objects (the set owns the Symbol objects). It also implements
 /// a \b maptable, which is a list of rangemaps that own the SymbolEntry objects.
 class ScopeInternal : public Scope {
+  /// \brief A raw symbol record whose full Symbol object is built on first query
+  struct DeferredSymbol {
+    string name;		///< Name of the symbol
+    Address addr;		///< Starting address of the symbol's storage
+    int4 size;			///< Number of bytes in the storage
+  };
+  mutable std::multimap<Address,DeferredSymbol> deferredsymbols;	///< Unmaterialized symbol records, sorted by address
+  mutable int4 deferredmaxsize;		///< Maximum size of any deferred symbol record
+  void materializeRange(const Address &addr,int4 size) const;	///< Build Symbol objects for deferred records in a range
+  void materializeAll(void) const;	///< Build Symbol objects for all remaining deferred records
   void decodeHole(Decoder &decoder);
   void decodeCollision(Decoder &decoder);
   void insertNameTree(Symbol *sym);
   SymbolNameTree::const_iterator findFirstByName(const string &nm) const;
+  static uint8 hashSymbolName(const string &nm);	///< Compute the hash index key for a symbol name
+  void eraseNameHash(Symbol *sym);		///< Remove a Symbol from the name hash index
 protected:
   virtual Scope *buildSubScope(uint8 id,const string &nm);	///< Build an unattached Scope to be associated as a sub-scope of \b this
   virtual void addSymbolInternal(Symbol *sym);
@@ -807,11 +819,13 @@ protected:
   virtual SymbolEntry *addDynamicMapInternal(Symbol *sym,uint4 exfl,uint8 hash,int4 off,int4 sz,
 					     const RangeList &uselim);
   SymbolNameTree nametree;			///< The set of Symbol objects, sorted by name
+  unordered_multimap<uint8,Symbol *> namehash;	///< Hash index from name to Symbol, for constant-time exact lookup
   vector<EntryMap *> maptable;			///< Rangemaps of SymbolEntry, one map for each address space
   vector<vector<Symbol *> > category;		///< References to Symbol objects organized by category
   list<SymbolEntry> dynamicentry;		///< Dynamic symbol entries
   SymbolNameTree multiEntrySet;			///< Set of symbols with multiple entries
   uint8 nextUniqueId;				///< Next available symbol id
+  mutable std::recursive_mutex scopelock;	///< Guards the symbol containers across decompiling threads
 public:
   ScopeInternal(uint8 id,const string &nm,Architecture *g);	///< Construct the Scope
   ScopeInternal(uint8 id,const string &nm,Architecture *g, Scope *own);	///< Construct as a cache
@@ -861,6 +875,7 @@ public:
   virtual int4 getCategorySize(int4 cat) const;
   virtual Symbol *getCategorySymbol(int4 cat,int4 ind) const;
   virtual void setCategory(Symbol *sym,int4 cat,int4 ind);
+  void addDeferred(const string &nm,const Address &addr,int4 size);	///< Register a symbol record without building its Symbol object
   void assignDefaultNames(int4 &base);		///< Assign a default name (via buildVariableName) to any unnamed symbol
   set<Symbol *>::const_iterator beginMultiEntry(void) const { return multiEntrySet.begin(); }	///< Start of symbols with more than one entry
   set<Symbol *>::const_iterator endMultiEntry(void) const { return multiEntrySet.end(); }	///< End of symbols with more than one entry
@@ -920,6 +935,7 @@ class Database {
   ScopeMap idmap;			///< Map from id to Scope
   partmap<Address,uint4> flagbase;	///< Map of global properties
   bool idByNameHash;			///< True if scope ids are built from hash of name
+  uint4 changeCounter;			///< Counter incremented whenever symbols or properties change
   void clearResolve(Scope *scope);	///< Clear the \e ownership ranges associated with the given Scope
   void clearReferences(Scope *scope);	///< Clear any map references to the given Scope and its children
   void fillResolve(Scope *scope);	///< Add the \e ownership ranges of the given Scope to the map
@@ -944,9 +960,12 @@ public:
   const Scope *mapScope(const Scope *qpoint,const Address &addr,const Address &usepoint) const;
   Scope *mapScope(Scope *qpoint,const Address &addr,const Address &usepoint);
   uint4 getProperty(const Address &addr) const { return flagbase.getValue(addr); }	///< Get boolean properties at the given address
+  uint4 getChangeCounter(void) const { return changeCounter; }	///< Get the count of symbol and property changes
+  void bumpChangeCounter(void) { changeCounter += 1; }		///< Note a change to symbols or properties
   void setPropertyRange(uint4 flags,const Range &range);	///< Set boolean properties over a given memory range
   void clearPropertyRange(uint4 flags,const Range &range);	///< Clear boolean properties over a given memory range
-  void setProperties(const partmap<Address,uint4> &newflags) { flagbase = newflags; }	///< Replace the property map
+  void setProperties(const partmap<Address,uint4> &newflags) {
+    flagbase = newflags; flagbase.prepareReads(); }		///< Replace the property map
   const partmap<Address,uint4> &getProperties(void) const { return flagbase; }	///< Get the entire property map
   void encode(Encoder &encoder) const;				///< Encode the whole Database to a stream
   void decode(Decoder &decoder);				///< Decode the whole database from a stream
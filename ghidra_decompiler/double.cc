@@ -99,6 +99,78 @@ void SplitVarnode::initAll(Varnode *w,Varnode *l,Varnode *h)
   defblock = (BlockBasic *)0;
 }
 
+// Companion CPUI_SUBPIECE ops keyed by the whole Varnode they split, as found by
+// findCompanionPiece().  Entries are hints only: every field is revalidated against
+// the current data-flow before use, so the cache never needs to be invalidated as
+// the graph is edited.
+static thread_local map<Varnode *,pair<PcodeOp *,PcodeOp *> > pieceCache;
+
+/// \brief Find a piece marked for double precision that is split from the given whole
+///
+/// Search the descendants of the whole Varnode for a CPUI_SUBPIECE producing a piece of
+/// the given size, marked as either the most or least significant half.  Results are
+/// cached by whole Varnode, so repeated queries by different rules avoid rescanning the
+/// same descendant list.  A cached op is fully revalidated before its output is returned,
+/// making a stale entry equivalent to a cache miss.
+/// \param w is the given whole Varnode
+/// \param size is the size in bytes of the piece being requested
+/// \param findlo is \b true if the least significant piece is requested
+/// \return the matching piece or null
+Varnode *SplitVarnode::findCompanionPiece(Varnode *w,int4 size,bool findlo)
+
+{
+  uintb off = findlo ? 0 : (uintb)(w->getSize() - size);
+  map<Varnode *,pair<PcodeOp *,PcodeOp *> >::iterator miter = pieceCache.find(w);
+  if (miter != pieceCache.end()) {
+    PcodeOp *cacheop = findlo ? (*miter).second.first : (*miter).second.second;
+    if (cacheop != (PcodeOp *)0 && !cacheop->isDead() && cacheop->code() == CPUI_SUBPIECE &&
+	cacheop->getIn(0) == w && cacheop->getIn(1)->getOffset() == off) {
+      Varnode *vn = cacheop->getOut();
+      if (vn->getSize() == size && (findlo ? vn->isPrecisLo() : vn->isPrecisHi()))
+	return vn;
+    }
+  }
+  PcodeOp *loop = (PcodeOp *)0;
+  PcodeOp *hiop = (PcodeOp *)0;
+  Varnode *res = (Varnode *)0;
+  list<PcodeOp *>::const_iterator iter,enditer;
+  iter = w->beginDescend();
+  enditer = w->endDescend();
+  while(iter != enditer) {
+    PcodeOp *tmpop = *iter;
+    ++iter;
+    if (tmpop->code() != CPUI_SUBPIECE) continue;
+    Varnode *tmpvn = tmpop->getOut();
+    if (tmpvn->isPrecisLo() && tmpop->getIn(1)->getOffset() == 0) {
+      // There could conceivably be more than one, but this shouldn't happen with CSE
+      if (loop == (PcodeOp *)0) loop = tmpop;
+      if (findlo && res == (Varnode *)0 && tmpvn->getSize() == size) {
+	loop = tmpop;
+	res = tmpvn;
+      }
+    }
+    else if (tmpvn->isPrecisHi() && tmpop->getIn(1)->getOffset() == (uintb)(w->getSize()-tmpvn->getSize())) {
+      if (hiop == (PcodeOp *)0) hiop = tmpop;
+      if (!findlo && res == (Varnode *)0 && tmpvn->getSize() == size) {
+	hiop = tmpop;
+	res = tmpvn;
+      }
+    }
+  }
+  if (pieceCache.size() >= 4096)
+    pieceCache.clear();		// Keep the cache from growing without bound
+  pieceCache[w] = make_pair(loop,hiop);
+  return res;
+}
+
+/// Drop all cached companion piece results.  Cached entries are revalidated on every
+/// look up, so this is purely a memory management operation.
+void SplitVarnode::clearPieceCache(void)
+
+{
+  pieceCache.clear();
+}
+
 /// Verify that the given most significant piece is formed via CPUI_SUBPIECE and search
 /// for the least significant piece being formed as a CPUI_SUBPIECE of the same whole.
 /// \param h is the given (most significant) Varnode piece
@@ -114,18 +186,8 @@ bool SplitVarnode::inHandHi(Varnode *h)
     if (op->code() == CPUI_SUBPIECE) {
       Varnode *w = op->getIn(0);
       if (op->getIn(1)->getOffset() != (uintb)(w->getSize()-h->getSize())) return false;
-      list<PcodeOp *>::const_iterator iter,enditer;
-      iter = w->beginDescend();
-      enditer = w->endDescend();
-      while(iter != enditer) {
-	PcodeOp *tmpop = *iter;
-	++iter;
-	if (tmpop->code() != CPUI_SUBPIECE) continue;
-	Varnode *tmplo = tmpop->getOut();
-	if (!tmplo->isPrecisLo()) continue;
-	if (tmplo->getSize() + h->getSize() != w->getSize()) continue;
-	if (tmpop->getIn(1)->getOffset() != 0) continue;
-	// There could conceivably be more than one, but this shouldn't happen with CSE
+      Varnode *tmplo = findCompanionPiece(w,w->getSize()-h->getSize(),true);
+      if (tmplo != (Varnode *)0) {
 	initAll(w,tmplo,h);
 	return true;
       }
@@ -149,18 +211,8 @@ bool SplitVarnode::inHandLo(Varnode *l)
     if (op->code() == CPUI_SUBPIECE) {
       Varnode *w = op->getIn(0);
       if (op->getIn(1)->getOffset() != 0) return false;
-      list<PcodeOp *>::const_iterator iter,enditer;
-      iter = w->beginDescend();
-      enditer = w->endDescend();
-      while(iter != enditer) {
-	PcodeOp *tmpop = *iter;
-	++iter;
-	if (tmpop->code() != CPUI_SUBPIECE) continue;
-	Varnode *tmphi = tmpop->getOut();
-	if (!tmphi->isPrecisHi()) continue;
-	if (tmphi->getSize() + l->getSize() != w->getSize()) continue;
-	if (tmpop->getIn(1)->getOffset() != (uintb)l->getSize()) continue;
-	// There could conceivably be more than one, but this shouldn't happen with CSE
+      Varnode *tmphi = findCompanionPiece(w,w->getSize()-l->getSize(),false);
+      if (tmphi != (Varnode *)0) {
 	initAll(w,l,tmphi);
 	return true;
       }
@@ -185,22 +237,8 @@ bool SplitVarnode::inHandLoNoHi(Varnode *l)
   if (op->getIn(1)->getOffset() != 0) return false;
   Varnode *w = op->getIn(0);
 
-  list<PcodeOp *>::const_iterator iter,enditer;
-  iter = w->beginDescend();
-  enditer = w->endDescend();
-  while(iter != enditer) {
-    PcodeOp *tmpop = *iter;
-    ++iter;
-    if (tmpop->code() != CPUI_SUBPIECE) continue;
-    Varnode *tmphi = tmpop->getOut();
-    if (!tmphi->isPrecisHi()) continue;
-    if (tmphi->getSize() + l->getSize() != w->getSize()) continue;
-    if (tmpop->getIn(1)->getOffset() != (uintb)l->getSize()) continue;
-    // There could conceivably be more than one, but this shouldn't happen with CSE
-    initAll(w,l,tmphi);
-    return true;
-  }
-  initAll(w,l,(Varnode *)0);
+  Varnode *tmphi = findCompanionPiece(w,w->getSize()-l->getSize(),false);
+  initAll(w,l,tmphi);
   return true;
 }
 
@@ -3198,6 +3236,7 @@ void RuleDoubleIn::reset(Funcdata &data)
 
 {
   data.setDoublePrecisRecovery(true); // Mark that we are doing double precision recovery
+  SplitVarnode::clearPieceCache();	// Results from any previous function are no longer interesting
 }
 
 void RuleDoubleIn::getOpList(vector<uint4> &oplist) const
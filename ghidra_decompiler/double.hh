@@ -40,6 +40,7 @@ class SplitVarnode {
   bool findWholeSplitToPieces(void);	///< Find whole out of which \b hi and \b lo are split
   bool findDefinitionPoint(void);	///< Find the earliest PcodeOp where both \b lo and \b hi are defined
   bool findWholeBuiltFromPieces(void);	///< Find whole Varnode formed as a CPUI_PIECE of \b hi and \b lo
+  static Varnode *findCompanionPiece(Varnode *w,int4 size,bool findlo);	///< Find a marked piece split from the given whole
 public:
   SplitVarnode(void) {}			///< Construct an uninitialized SplitVarnode
   SplitVarnode(int4 sz,uintb v);	///< Construct a double precision constant
@@ -71,6 +72,7 @@ public:
   PcodeOp *findEarliestSplitPoint(void);	///< Find the earliest definition point of the \b lo and \b hi pieces
   PcodeOp *findOutExist(void);			///< Find the point at which the output \b whole must exist
   bool exceedsConstPrecision(void) const;	///< Check if \b this is a constant that exceeds precision limits
+  static void clearPieceCache(void);	///< Clear the cache used by companion piece searches
   static bool adjacentOffsets(Varnode *vn1,Varnode *vn2,uintb size1);
   static bool testContiguousPointers(PcodeOp *most,PcodeOp *least,PcodeOp *&first,PcodeOp *&second,AddrSpace *&spc);
   static bool isAddrTiedContiguous(Varnode *lo,Varnode *hi,Address &res);
@@ -554,6 +554,11 @@ void DynamicHash::uniqueHash(const PcodeOp *op,int4 slot,Funcdata *fd)
 /// and the Varnode which matches the hash (and the position) is returned.
 /// If the number of collisions for the hash does not match, this method
 /// will not return a Varnode, even if the position looks valid.
+/// The gathered candidates and their hashes are cached on \b this, keyed by the
+/// address and the hash with its collision fields cleared, so that symbols whose
+/// hashes collide at the same address do not retraverse the data-flow.  The cache
+/// is never invalidated, so a single DynamicHash instance must not be used across
+/// modifications to the data-flow graph.
 /// \param fd is the function containing the data-flow
 /// \param addr is the given address
 /// \param h is the hash
@@ -565,15 +570,24 @@ Varnode *DynamicHash::findVarnode(const Funcdata *fd,const Address &addr,uint8 h
   uint4 total = getTotalFromHash(h);
   uint4 pos = getPositionFromHash(h);
   clearTotalPosition(h);
-  vector<Varnode *> vnlist;
+  pair<Address,uint8> key(addr,h);
+  map<pair<Address,uint8>,vector<pair<Varnode *,uint8> > >::iterator citer = vncache.find(key);
+  if (citer == vncache.end()) {
+    citer = vncache.insert(pair<pair<Address,uint8>,vector<pair<Varnode *,uint8> > >(key,vector<pair<Varnode *,uint8> >())).first;
+    vector<Varnode *> vnlist;
+    gatherFirstLevelVars(vnlist,fd,addr,h);
+    for(uint4 i=0;i<vnlist.size();++i) {
+      Varnode *tmpvn = vnlist[i];
+      clear();
+      calcHash(tmpvn,method);
+      citer->second.push_back(pair<Varnode *,uint8>(tmpvn,hash));
+    }
+  }
+  const vector<pair<Varnode *,uint8> > &candidates( citer->second );
   vector<Varnode *> vnlist2;
-  gatherFirstLevelVars(vnlist,fd,addr,h);
-  for(uint4 i=0;i<vnlist.size();++i) {
-    Varnode *tmpvn = vnlist[i];
-    clear();
-    calcHash(tmpvn,method);
-    if (getComparable(hash) == getComparable(h))
-      vnlist2.push_back(tmpvn);
+  for(uint4 i=0;i<candidates.size();++i) {
+    if (getComparable(candidates[i].second) == getComparable(h))
+      vnlist2.push_back(candidates[i].first);
   }
   if (total != vnlist2.size()) return (Varnode *)0;
   return vnlist2[pos];
@@ -586,6 +600,7 @@ Varnode *DynamicHash::findVarnode(const Funcdata *fd,const Address &addr,uint8 h
 /// and the PcodeOp which matches the hash (and the position) is returned.
 /// If the number of collisions for the hash does not match, this method
 /// will not return a PcodeOp, even if the position looks valid.
+/// Candidates are cached on \b this under the same regime as findVarnode().
 /// \param fd is the function containing the data-flow
 /// \param addr is the given address
 /// \param h is the hash
@@ -598,16 +613,25 @@ PcodeOp *DynamicHash::findOp(const Funcdata *fd,const Address &addr,uint8 h)
   int total = getTotalFromHash(h);
   int pos = getPositionFromHash(h);
   clearTotalPosition(h);
-  vector<PcodeOp *> oplist;
+  pair<Address,uint8> key(addr,h);
+  map<pair<Address,uint8>,vector<pair<PcodeOp *,uint8> > >::iterator citer = opcache.find(key);
+  if (citer == opcache.end()) {
+    citer = opcache.insert(pair<pair<Address,uint8>,vector<pair<PcodeOp *,uint8> > >(key,vector<pair<PcodeOp *,uint8> >())).first;
+    vector<PcodeOp *> oplist;
+    gatherOpsAtAddress(oplist,fd,addr);
+    for(uint4 i=0;i<oplist.size();++i) {
+      PcodeOp *tmpop = oplist[i];
+      if (slot >= tmpop->numInput()) continue;
+      clear();
+      calcHash(tmpop,slot,method);
+      citer->second.push_back(pair<PcodeOp *,uint8>(tmpop,hash));
+    }
+  }
+  const vector<pair<PcodeOp *,uint8> > &candidates( citer->second );
   vector<PcodeOp *> oplist2;
-  gatherOpsAtAddress(oplist,fd,addr);
-  for(uint4 i=0;i<oplist.size();++i) {
-    PcodeOp *tmpop = oplist[i];
-    if (slot >= tmpop->numInput()) continue;
-    clear();
-    calcHash(tmpop,slot,method);
-    if (getComparable(hash) == getComparable(h))
-      oplist2.push_back(tmpop);
+  for(uint4 i=0;i<candidates.size();++i) {
+    if (getComparable(candidates[i].second) == getComparable(h))
+      oplist2.push_back(candidates[i].first);
   }
   if (total != oplist2.size())
     return (PcodeOp *)0;
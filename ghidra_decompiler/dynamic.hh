@@ -71,6 +71,8 @@ class DynamicHash {
 
   Address addrresult;			///< Address most closely associated with variable
   uint8 hash;				///< The calculated hash value
+  map<pair<Address,uint8>,vector<pair<Varnode *,uint8> > > vncache;	///< Hashed Varnode candidates from previous findVarnode() queries
+  map<pair<Address,uint8>,vector<pair<PcodeOp *,uint8> > > opcache;	///< Hashed PcodeOp candidates from previous findOp() queries
   void buildVnUp(const Varnode *vn);	///< Add in the edge between the given Varnode and its defining PcodeOp
   void buildVnDown(const Varnode *vn);	///< Add in edges between the given Varnode and any PcodeOp that reads it
   void buildOpUp(const PcodeOp *op);	///< Move input Varnodes for the given PcodeOp into staging
@@ -219,8 +219,8 @@ void EmulateMemory::executeUnary(void)
 
 {
   uintb in1 = memstate->getValue(currentOp->getInput(0));
-  uintb out = currentBehave->evaluateUnary(currentOp->getOutput()->size,
-					   currentOp->getInput(0)->size,in1);
+  uintb out = OpBehavior::evaluateUnaryFast(currentBehave,currentOp->getOutput()->size,
+					    currentOp->getInput(0)->size,in1);
   memstate->setValue(currentOp->getOutput(),out);
 }
 
@@ -229,8 +229,8 @@ void EmulateMemory::executeBinary(void)
 {
   uintb in1 = memstate->getValue(currentOp->getInput(0));
   uintb in2 = memstate->getValue(currentOp->getInput(1));
-  uintb out = currentBehave->evaluateBinary(currentOp->getOutput()->size,
-					    currentOp->getInput(0)->size,in1,in2);
+  uintb out = OpBehavior::evaluateBinaryFast(currentBehave,currentOp->getOutput()->size,
+					     currentOp->getInput(0)->size,in1,in2);
   memstate->setValue(currentOp->getOutput(),out);
 }
 
@@ -332,43 +332,104 @@ EmulatePcodeCache::EmulatePcodeCache(Translate *t,MemoryState *s,BreakTable *b)
   : EmulateMemory(s)
 {
   trans = t;
+  cache_max = 1024;
+  currentInstruction = (CachedInstruction *)0;
   OpBehavior::registerInstructions(inst,t);
   breaktable = b;
   breaktable->setEmulate(this);
 }
 
-/// Free all the VarnodeData and PcodeOpRaw objects and clear the cache
+/// Free the VarnodeData and PcodeOpRaw objects of a single cached translation
+/// \param instr is the cached translation to free
+void EmulatePcodeCache::freeInstruction(CachedInstruction *instr)
+
+{
+  for(int4 i=0;i<instr->opcache.size();++i)
+    delete instr->opcache[i];
+  for(int4 i=0;i<instr->varcache.size();++i)
+    delete instr->varcache[i];
+  delete instr;
+}
+
+/// Free every cached translation and clear the cache
 void EmulatePcodeCache::clearCache(void)
 
 {
-  for(int4 i=0;i<opcache.size();++i)
-    delete opcache[i];
-  for(int4 i=0;i<varcache.size();++i)
-    delete varcache[i];
-  opcache.clear();
-  varcache.clear();
+  map<AddrKey,CachedInstruction *>::iterator iter;
+  for(iter=instcache.begin();iter!=instcache.end();++iter)
+    freeInstruction((*iter).second);
+  instcache.clear();
+  lru.clear();
+  currentInstruction = (CachedInstruction *)0;
 }
 
 EmulatePcodeCache::~EmulatePcodeCache(void)
 
 {
   clearCache();
-  for(int4 i=0;i<inst.size();++i) {
-    OpBehavior *t_op = inst[i];
-    if (t_op != (OpBehavior *)0)
-      delete t_op;
+  OpBehavior::deregisterInstructions(inst);
+}
+
+/// The limit is applied immediately, evicting least recently used translations
+/// if the cache currently exceeds it.
+/// \param max is the maximum number of translations to retain
+void EmulatePcodeCache::setCacheMax(int4 max)
+
+{
+  if (max < 2)
+    max = 2;			// Always allow the current and next instruction
+  cache_max = max;
+  while(instcache.size() > cache_max) {
+    map<AddrKey,CachedInstruction *>::iterator iter = instcache.find(lru.front());
+    lru.pop_front();
+    freeInstruction((*iter).second);
+    instcache.erase(iter);
+  }
+}
+
+/// Look up the translation of the instruction at the given address, building it
+/// via the Translate object if it has not been cached.  The translation is marked
+/// as the most recently used, and if building it pushed the cache over its size
+/// limit, the least recently used translation is freed.
+/// \param addr is the address of the machine instruction
+/// \return the cached translation
+EmulatePcodeCache::CachedInstruction *EmulatePcodeCache::translateInstruction(const Address &addr)
+
+{
+  AddrKey key = addr.toKey();
+  map<AddrKey,CachedInstruction *>::iterator iter = instcache.find(key);
+  if (iter != instcache.end()) {
+    CachedInstruction *res = (*iter).second;
+    lru.splice(lru.end(),lru,res->lruslot);	// Mark as most recently used
+    return res;
+  }
+  CachedInstruction *res = new CachedInstruction();
+  PcodeEmitCache emit(res->opcache,res->varcache,inst,0);
+  try {
+    res->length = trans->oneInstruction(emit,addr);
   }
+  catch(LowlevelError &err) {
+    freeInstruction(res);	// Don't cache failed translations
+    throw;
+  }
+  res->lruslot = lru.insert(lru.end(),key);
+  instcache[key] = res;
+  if (instcache.size() > cache_max) {	// Evict the least recently used translation
+    iter = instcache.find(lru.front());
+    lru.pop_front();
+    freeInstruction((*iter).second);
+    instcache.erase(iter);
+  }
+  return res;
 }
 
-/// This is a private routine which does the work of translating a machine instruction
-/// into pcode, putting it into the cache, and setting up the iterators
-/// \param addr is the address of the instruction to translate
+/// This is a private routine which sets the instruction at the given address as the
+/// one currently executing, translating it if necessary, and sets up the iterators
+/// \param addr is the address of the instruction
 void EmulatePcodeCache::createInstruction(const Address &addr)
 
 {
-  clearCache();
-  PcodeEmitCache emit(opcache,varcache,inst,0);
-  instruction_length = trans->oneInstruction(emit,addr);
+  currentInstruction = translateInstruction(addr);
   current_op = 0;
   instruction_start = true;
 }
@@ -377,8 +438,8 @@ void EmulatePcodeCache::createInstruction(const Address &addr)
 void EmulatePcodeCache::establishOp(void)
 
 {
-  if (current_op < opcache.size()) {
-    currentOp = opcache[current_op];
+  if (current_op < currentInstruction->opcache.size()) {
+    currentOp = currentInstruction->opcache[current_op];
     currentBehave = currentOp->getBehavior();
     return;
   }
@@ -393,8 +454,8 @@ void EmulatePcodeCache::fallthruOp(void)
 {
   instruction_start = false;
   current_op += 1;
-  if (current_op >= opcache.size()) {
-    current_address = current_address + instruction_length;
+  if (current_op >= currentInstruction->opcache.size()) {
+    current_address = current_address + currentInstruction->length;
     createInstruction(current_address);
   }
   establishOp();
@@ -409,9 +470,9 @@ void EmulatePcodeCache::executeBranch(void)
     uintm id = destaddr.getOffset();
     id = id + (uintm)current_op;
     current_op = id;
-    if (current_op == opcache.size())
+    if (current_op == currentInstruction->opcache.size())
       fallthruOp();
-    else if ((current_op < 0)||(current_op >= opcache.size()))
+    else if ((current_op < 0)||(current_op >= currentInstruction->opcache.size()))
       throw LowlevelError("Bad intra-instruction branch");
     else
       establishOp();
@@ -437,7 +498,7 @@ void EmulatePcodeCache::setExecuteAddress(const Address &addr)
 
 {
   current_address = addr;	// Copy -addr- BEFORE calling createInstruction
-                                // as it calls clear and may delete -addr-
+                                // as it may evict the translation that owns -addr-
   createInstruction(current_address);
   establishOp();
 }
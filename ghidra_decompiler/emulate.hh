@@ -293,20 +293,32 @@ public:
 ///
 /// This implementation uses a Translate object to translate machine instructions into
 /// pcode and caches pcode ops for later use by the emulator.  The pcode is cached as soon
-/// as the execution address is set, either explicitly, or via branches and fallthrus.  There
+/// as the execution address is set, either explicitly, or via branches and fallthrus.
+/// Translations are retained in a bounded least-recently-used cache, so an instruction
+/// revisited by a loop or branch is translated only once.  There
 /// are additional methods for inspecting the pcode ops in the current instruction as a sequence.
 class EmulatePcodeCache : public EmulateMemory {
+  /// \brief The p-code translation of a single machine instruction, as held in the cache
+  struct CachedInstruction {
+    vector<PcodeOpRaw *> opcache;	///< The p-code ops of the translation
+    vector<VarnodeData *> varcache;	///< Varnodes allocated for the ops
+    int4 length;			///< Length of the machine instruction in bytes
+    list<AddrKey>::iterator lruslot;	///< Position of the instruction in the LRU ordering
+  };
   Translate *trans;		///< The SLEIGH translator
-  vector<PcodeOpRaw *> opcache;	///< The cache of current p-code ops
-  vector<VarnodeData *> varcache;	///< The cache of current varnodes
+  map<AddrKey,CachedInstruction *> instcache;	///< Cached translations, keyed by packed instruction address
+  list<AddrKey> lru;		///< Cached address keys, from least to most recently used
+  int4 cache_max;		///< Maximum number of translations retained in the cache
   vector<OpBehavior *> inst;	///< Map from OpCode to OpBehavior
   BreakTable *breaktable;	///< The table of breakpoints
   Address current_address;	///< Address of current instruction being executed
+  CachedInstruction *currentInstruction;	///< Translation of the instruction being executed
   bool instruction_start;	///< \b true if next pcode op is start of instruction
   int4 current_op;		///< Index of current pcode op within machine instruction
-  int4 instruction_length;	///< Length of current instruction in bytes
+  static void freeInstruction(CachedInstruction *instr);	///< Free a single cached translation
   void clearCache(void);	///< Clear the p-code cache
-  void createInstruction(const Address &addr); ///< Cache pcode for instruction at given address
+  CachedInstruction *translateInstruction(const Address &addr);	///< Find or build the translation at an address
+  void createInstruction(const Address &addr); ///< Establish the instruction at the given address as current
   void establishOp(void);
 protected:
   virtual void fallthruOp(void); ///< Execute fallthru semantics for the pcode cache
@@ -315,6 +327,7 @@ protected:
 public:
   EmulatePcodeCache(Translate *t,MemoryState *s,BreakTable *b);	///< Pcode cache emulator constructor
   ~EmulatePcodeCache(void);
+  void setCacheMax(int4 max);	///< Set the maximum number of translations retained
   bool isInstructionStart(void) const; ///< Return \b true if we are at an instruction start
   int4 numCurrentOps(void) const; ///< Return number of pcode ops in translation of current instruction
   int4 getCurrentOpIndex(void) const; ///< Get the index of current pcode op within current instruction
@@ -340,7 +353,7 @@ inline bool EmulatePcodeCache::isInstructionStart(void) const
 inline int4 EmulatePcodeCache::numCurrentOps(void) const
 
 {
-  return opcache.size();
+  return currentInstruction->opcache.size();
 }
 
 /// This routine can be used to determine where, within the sequence of ops in the translation
@@ -359,7 +372,7 @@ inline int4 EmulatePcodeCache::getCurrentOpIndex(void) const
 inline PcodeOpRaw *EmulatePcodeCache::getOpByIndex(int4 i) const
 
 {
-  return opcache[i];
+  return currentInstruction->opcache[i];
 }
 
 /// \return the currently executing machine address
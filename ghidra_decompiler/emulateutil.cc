@@ -48,8 +48,8 @@ void EmulatePcodeOp::executeUnary(void)
 
 {
   uintb in1 = getVarnodeValue(currentOp->getIn(0));
-  uintb out = currentBehave->evaluateUnary(currentOp->getOut()->getSize(),
-					   currentOp->getIn(0)->getSize(),in1);
+  uintb out = OpBehavior::evaluateUnaryFast(currentBehave,currentOp->getOut()->getSize(),
+					    currentOp->getIn(0)->getSize(),in1);
   setVarnodeValue(currentOp->getOut(), out);
 }
 
@@ -58,8 +58,8 @@ void EmulatePcodeOp::executeBinary(void)
 {
   uintb in1 = getVarnodeValue(currentOp->getIn(0));
   uintb in2 = getVarnodeValue(currentOp->getIn(1));
-  uintb out = currentBehave->evaluateBinary(currentOp->getOut()->getSize(),
-					    currentOp->getIn(0)->getSize(),in1,in2);
+  uintb out = OpBehavior::evaluateBinaryFast(currentBehave,currentOp->getOut()->getSize(),
+					     currentOp->getIn(0)->getSize(),in1,in2);
   setVarnodeValue(currentOp->getOut(), out);
 }
 
@@ -168,8 +168,8 @@ void EmulateSnippet::executeUnary(void)
 
 {
   uintb in1 = getVarnodeValue(currentOp->getInput(0));
-  uintb out = currentBehave->evaluateUnary(currentOp->getOutput()->size,
-					   currentOp->getInput(0)->size,in1);
+  uintb out = OpBehavior::evaluateUnaryFast(currentBehave,currentOp->getOutput()->size,
+					    currentOp->getInput(0)->size,in1);
   setVarnodeValue(currentOp->getOutput()->offset, out);
 }
 
@@ -178,8 +178,8 @@ void EmulateSnippet::executeBinary(void)
 {
   uintb in1 = getVarnodeValue(currentOp->getInput(0));
   uintb in2 = getVarnodeValue(currentOp->getInput(1));
-  uintb out = currentBehave->evaluateBinary(currentOp->getOutput()->size,
-					    currentOp->getInput(0)->size,in1,in2);
+  uintb out = OpBehavior::evaluateBinaryFast(currentBehave,currentOp->getOutput()->size,
+					     currentOp->getInput(0)->size,in1,in2);
   setVarnodeValue(currentOp->getOutput()->offset, out);
 }
 
@@ -40,6 +40,21 @@ char FileManage::separator = '/';
 char FileManage::separatorClass[] = "/";
 #endif
 
+std::map<string,FileManage::DirCacheEntry> FileManage::dircache;
+std::mutex FileManage::dircache_mutex;
+
+/// Listings are cached because spec discovery walks the same directories
+/// repeatedly and deployments may put them on network shares, where each
+/// opendir/stat round trip is expensive.  Call this before rescanning if
+/// files were added or removed without touching the directory modification
+/// time (e.g. within the same second).
+void FileManage::clearDirectoryCache(void)
+
+{
+  std::lock_guard<std::mutex> lock(dircache_mutex);
+  dircache.clear();
+}
+
 void FileManage::addDir2Path(const string &path)
 
 {
@@ -174,20 +189,62 @@ void FileManage::matchListDir(vector<string> &res,const string &match,bool isSuf
 }
 
 #else
+/// Return the listing of the given directory, reading it from the file system
+/// only if no cached copy exists or the directory's modification time has
+/// changed since the cached copy was made.  Entry names are paired with a flag
+/// indicating whether the entry is itself a directory.
+/// \param dirfinal is the directory path, ending in a separator
+/// \param res will hold the listing
+/// \return \b true unless the directory could not be read
+bool FileManage::readDirectoryCached(const string &dirfinal,vector<pair<string,bool> > &res)
+
+{
+  struct stat dirstat;
+  if (stat(dirfinal.c_str(),&dirstat) != 0) return false;
+
+  std::lock_guard<std::mutex> lock(dircache_mutex);
+  std::map<string,DirCacheEntry>::iterator iter = dircache.find(dirfinal);
+  if (iter != dircache.end() && (*iter).second.mtime == dirstat.st_mtime) {
+    res = (*iter).second.entries;
+    return true;
+  }
+
+  DIR *dir = opendir(dirfinal.c_str());
+  if (dir == (DIR *)0) return false;
+  DirCacheEntry &cached( dircache[dirfinal] );
+  cached.mtime = dirstat.st_mtime;
+  cached.entries.clear();
+  struct dirent *entry = readdir(dir);
+  while(entry != (struct dirent *)0) {
+    bool isDirectory = false;
+    if (entry->d_type == DT_DIR)
+      isDirectory = true;
+    else if (entry->d_type == DT_UNKNOWN || entry->d_type == DT_LNK) {
+      string path = dirfinal + entry->d_name;
+      struct stat stbuf;
+      stat(path.c_str(), &stbuf);
+      isDirectory = S_ISDIR(stbuf.st_mode);
+    }
+    cached.entries.push_back(std::make_pair(string(entry->d_name),isDirectory));
+    entry = readdir(dir);
+  }
+  closedir(dir);
+  res = cached.entries;
+  return true;
+}
+
 void FileManage::matchListDir(vector<string> &res,const string &match,bool isSuffix,const string &dirname,bool allowdot)
 
 {				// Look through files in a directory for those matching -match-
-  DIR *dir;
-  struct dirent *entry;
   string dirfinal = dirname;
   if (!isSeparator(dirfinal[dirfinal.size()-1]))
     dirfinal += separator;
 
-  dir = opendir(dirfinal.c_str());
-  if (dir == (DIR *)0) return;
-  entry = readdir(dir);
-  while(entry != (struct dirent *)0) {
-    string fullname(entry->d_name);
+  vector<pair<string,bool> > listing;
+  if (!readDirectoryCached(dirfinal,listing)) return;
+  vector<pair<string,bool> >::const_iterator iter;
+  for(iter=listing.begin();iter!=listing.end();++iter) {
+    const string &fullname( (*iter).first );
     if (match.size() <= fullname.size()) {
       if (allowdot||(fullname[0] != '.')) {
 	if (isSuffix) {
@@ -200,9 +257,7 @@ void FileManage::matchListDir(vector<string> &res,const string &match,bool isSuf
 	}
       }
     }
-    entry = readdir(dir);
   }
-  closedir(dir);
 }
 #endif
 
@@ -245,37 +300,24 @@ void FileManage::directoryList(vector<string> &res,const string &dirname,bool al
 void FileManage::directoryList(vector<string> &res,const string &dirname,bool allowdot)
 
 { // List full pathnames of all directories under the directory -dir-
-  DIR *dir;
-  struct dirent *entry;
   string dirfinal;
 
   dirfinal = dirname;
   if (!isSeparator(dirfinal[dirfinal.size()-1]))
     dirfinal += separator;
 
-  dir = opendir(dirfinal.c_str());
-  if (dir == (DIR *)0) return;
-  entry = readdir(dir);
-  while(entry != (struct dirent *)0) {
-    bool isDirectory = false;
-    if (entry->d_type == DT_DIR)
-      isDirectory = true;
-    else if (entry->d_type == DT_UNKNOWN || entry->d_type == DT_LNK) {
-      string path = dirfinal + entry->d_name;
-      struct stat stbuf;
-      stat(path.c_str(), &stbuf);
-      isDirectory = S_ISDIR(stbuf.st_mode);
-    }
-    if (isDirectory) {
-      string fullname(entry->d_name);
+  vector<pair<string,bool> > listing;
+  if (!readDirectoryCached(dirfinal,listing)) return;
+  vector<pair<string,bool> >::const_iterator iter;
+  for(iter=listing.begin();iter!=listing.end();++iter) {
+    if ((*iter).second) {
+      const string &fullname( (*iter).first );
       if ((fullname!=".")&&(fullname!="..")) {
 	if (allowdot || (fullname[0] != '.'))
 	  res.push_back( dirfinal + fullname );
       }
     }
-    entry = readdir(dir);
   }
-  closedir(dir);
 }
 
 #endif
@@ -23,6 +23,10 @@
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <ctime>
 
 namespace ghidra {
 
@@ -30,14 +34,24 @@ using std::vector;
 using std::string;
 using std::ifstream;
 using std::ostringstream;
+using std::pair;
 
 class FileManage {
+  // One cached directory listing: entry names paired with an is-directory flag,
+  // valid as long as the directory's modification time is unchanged
+  struct DirCacheEntry {
+    time_t mtime;			// Modification time of the directory when it was read
+    vector<pair<string,bool> > entries;	// Entry name and whether it is a subdirectory
+  };
   vector<string> pathlist;	// List of paths to search for files
   static char separator;
   static char separatorClass[];	// Characters that can be accepted as a separator
+  static std::map<string,DirCacheEntry> dircache;	// Directory listings keyed by path
+  static std::mutex dircache_mutex;	// Guards dircache
   static string buildPath(const vector<string> &pathels,int level);
   static bool testDevelopmentPath(const vector<string> &pathels,int level,string &root);
   static bool testInstallPath(const vector<string> &pathels,int level,string &root);
+  static bool readDirectoryCached(const string &dirfinal,vector<pair<string,bool> > &res);
 public:
   void addDir2Path(const string &path);
   void addCurrentDir(void);
@@ -48,6 +62,7 @@ public:
   static void matchListDir(vector<string> &res,const string &match,bool isSuffix,const string &dir,bool allowdot);
   static void directoryList(vector<string> &res,const string &dirname,bool allowdot=false);
   static void scanDirectoryRecursive(vector<string> &res,const string &matchname,const string &rootpath,int maxdepth);
+  static void clearDirectoryCache(void);	// Drop all cached directory listings
   static void splitPath(const string &full,string &path,string &base);
   static bool isAbsolutePath(const string &full) { if (full.empty()) return false; return (full[0] == separator); }
   static string discoverGhidraRoot(const char *argv0);
@@ -18,6 +18,7 @@
 #include "address.hh"
 
 #include <cmath>
+#include <cstring>
 #include <limits>
 
 namespace ghidra {
@@ -57,6 +58,9 @@ FloatFormat::FloatFormat(int4 sz)
     jbitimplied = true;
   }
   maxexponent = (1<<exp_size)-1;
+  // Sizes 4 and 8 above use the standard IEEE 754 layout.  If the host floating-point
+  // types do too, conversions can reinterpret bits rather than reconstruct the value.
+  ieeeHost = std::numeric_limits<double>::is_iec559 && (size == 4 || size == 8);
   calcPrecision();
 }
 
@@ -256,6 +260,19 @@ double FloatFormat::getHostFloat(uintb encoding,floatclass *type) const
   else
     *type = normalized;
 
+  if (ieeeHost) {		// Same layout as the host: reinterpret the bits directly
+    if (size == 8) {
+      double res;
+      uint8 enc = (uint8)encoding;
+      memcpy(&res,&enc,sizeof(res));
+      return res;
+    }
+    float res;
+    uint4 enc = (uint4)encoding;
+    memcpy(&res,&enc,sizeof(res));
+    return (double)res;
+  }
+
   // Get "true" exponent and fractional
   exp -= bias;
   if (normal && jbitimplied) {
@@ -293,6 +310,19 @@ bool FloatFormat::roundToNearestEven(uintb &signif, int4 lowbitpos)
 uintb FloatFormat::getEncoding(double host) const
 
 {
+  if (ieeeHost) {		// Same layout as the host: reinterpret the bits directly
+    if (std::isnan(host))
+      return getNaNEncoding(signbit(host));	// Keep the canonical quiet NaN encoding
+    if (size == 8) {
+      uint8 enc;
+      memcpy(&enc,&host,sizeof(enc));
+      return (uintb)enc;
+    }
+    float hostf = (float)host;	// Rounds to nearest even, matching the conversion below
+    uint4 enc;
+    memcpy(&enc,&hostf,sizeof(enc));
+    return (uintb)enc;
+  }
   floatclass type;
   bool sgn;
   uintb signif;
@@ -51,6 +51,7 @@ private:
   int4 decimalMinPrecision;	///< Minimum decimal digits of precision guaranteed by the format
   int4 decimalMaxPrecision;	///< Maximum decimal digits of precision needed to uniquely represent value
   bool jbitimplied;		///< Set to \b true if integer bit of 1 is assumed
+  bool ieeeHost;		///< Set to \b true if the host shares \b this format's IEEE 754 layout
   static double createFloat(bool sign,uintb signif,int4 exp);	 ///< Create a double given sign, fractional, and exponent
   static floatclass extractExpSig(double x,bool *sgn,uintb *signif,int4 *exp);
   static bool roundToNearestEven(uintb &signif, int4 lowbitpos);
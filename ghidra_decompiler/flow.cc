@@ -418,6 +418,8 @@ bool FlowInfo::processInstruction(const Address &curaddr,bool &startbasic)
     flowoverride = Override::NONE;
 
   try {
+    if (!glb->loader->isExecutableAddress(curaddr))
+      throw BadDataError("Flow into non-executable address");
     step = glb->translate->oneInstruction(emitter,curaddr); // Generate ops for instruction
   }
   catch(UnimplError &err) {	// Instruction is unimplemented
@@ -552,7 +554,8 @@ void FlowInfo::fallthru(void)
   Address curaddr;
   bool startbasic = true;
   bool fallthruflag;
-  
+
+  glb->translate->decodeRange(addrlist.back(),bound,max_decodeahead);
   for(;;) {
     curaddr = addrlist.back();
     addrlist.pop_back();
@@ -575,6 +578,7 @@ void FlowInfo::fallthru(void)
 	break;
       }
       if (!setFallthruBound(bound)) return; // Reset bound
+      glb->translate->decodeRange(addrlist.back(),bound,max_decodeahead);
     }
   }
 }
@@ -657,7 +661,7 @@ void FlowInfo::queryCall(FuncCallSpecs &fspecs)
 
 {
   if (!fspecs.getEntryAddress().isInvalid()) { // If this is a direct call
-    Funcdata *otherfunc = data.getScopeLocal()->getParent()->queryFunction( fspecs.getEntryAddress() );
+    Funcdata *otherfunc = data.queryGlobalFunction( fspecs.getEntryAddress() );
     if (otherfunc != (Funcdata *)0) {
       fspecs.setFuncdata(otherfunc); // Associate the symbol with the callsite
       if (!fspecs.hasModel() || otherfunc->getFuncProto().isInline()) {	// If the prototype was not overridden
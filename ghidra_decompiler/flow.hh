@@ -78,6 +78,7 @@ private:
     SeqNum seqnum;	///< Sequence number of first PcodeOp in the instruction (or INVALID if no p-code)
     int4 size;		///< Number of bytes in the instruction
   };
+  static const int4 max_decodeahead = 32;	///< Maximum instructions to speculatively decode ahead of generation
   Architecture *glb;			///< Owner of the function
   Funcdata &data;			///< The function being flow-followed
   PcodeOpBank &obank;			///< Container for generated p-code
@@ -4216,6 +4216,16 @@ uint4 FuncProto::hasEffect(const Address &addr,int4 size) const
   return ProtoModel::lookupEffect(effectlist,addr,size);
 }
 
+/// If \b this prototype has no EffectRecords of its own, the model's list is returned.
+/// \return the list of EffectRecords in effect for \b this prototype
+const vector<EffectRecord> &FuncProto::getEffectList(void) const
+
+{
+  if (effectlist.empty())
+    return model->getEffectList();
+  return effectlist;
+}
+
 vector<EffectRecord>::const_iterator FuncProto::effectBegin(void) const
 
 {
@@ -5444,7 +5454,7 @@ void FuncCallSpecs::deindirect(Funcdata &data,Funcdata *newfd)
       return;	// We have successfully updated the prototype, don't restart
     }
   }
-  data.setRestartPending(true);
+  data.setRestartPending(true,Funcdata::cause_prototype);
 }
 
 /// \brief Force a more restrictive prototype on \b this call site
@@ -5476,7 +5486,7 @@ void FuncCallSpecs::forceSet(Funcdata &data,const FuncProto &fp)
   else {
     // Too late to make restrictions to correct prototype
     // Force a restart
-    data.setRestartPending(true);
+    data.setRestartPending(true,Funcdata::cause_prototype);
   }
   // Regardless of what happened, lock the prototype so it doesn't happen again
   setInputLock(true);
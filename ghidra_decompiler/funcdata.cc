@@ -42,9 +42,14 @@ Funcdata::Funcdata(const string &nm,const string &disp,Scope *scope,const Addres
 				// function by giving address and size
   functionSymbol = sym;
   flags = 0;
+  restartCause = 0;
+  for(int4 i=0;i<cause_max;++i)
+    restartTally[i] = 0;
   clean_up_index = 0;
   high_level_index = 0;
   cast_phase_index = 0;
+  subflowFailStamp = 0;
+  inlineEZValid = false;
   glb = scope->getArch();
   minLanedSize = glb->getMinimumLanedRegisterSize();
   name = nm;
@@ -81,26 +86,39 @@ Funcdata::Funcdata(const string &nm,const string &disp,Scope *scope,const Addres
 #endif
 }
 
-void Funcdata::clear(void)
+/// Clear everything associated with decompilation (analysis) of \b this function.
+/// If requested, data-types resolved for unlocked Symbols are first converted into
+/// type recommendations so the next analysis can re-seed itself with them.  Recovered
+/// jump-table addresses are always retained in re-validatable form.
+/// \param keepRecovered is \b true if recovered artifacts should seed the next analysis
+void Funcdata::clear(bool keepRecovered)
 
-{				// Clear everything associated with decompilation (analysis)
+{
 
   flags &= ~(highlevel_on|blocks_generated|processing_started|typerecovery_start|typerecovery_on|
-      double_precis_on|restart_pending);
+      double_precis_on|restart_pending|structure_hold|structure_pending);
+  restartCause = 0;	// A pending cause is consumed (tallied or abandoned) before analysis clears
   clean_up_index = 0;
   high_level_index = 0;
   cast_phase_index = 0;
   minLanedSize = glb->getMinimumLanedRegisterSize();
 
+  if (keepRecovered)
+    localmap->collectTypeRecs();	// Must happen before unlocked Symbols are cleared
   localmap->clearUnlocked();	// Clear non-permanent stuff
   localmap->resetLocalWindow();
 
   clearActiveOutput();
   funcp.clearUnlockedOutput();	// Inputs are cleared by localmap
+  salvageUnionResolutions();	// Must come while ops and varnodes are still alive
   unionMap.clear();
   clearBlocks();
   obank.clear();
   vbank.clear();
+  subflowFails.clear();
+  subflowFailStamp = 0;
+  inlineEZCache.clear();
+  inlineEZValid = false;
   clearCallSpecs();
   clearJumpTables();
   // Do not clear overrides
@@ -111,6 +129,159 @@ void Funcdata::clear(void)
 #endif
 }
 
+/// Attribute the restart about to be performed to whatever cause(s) were
+/// recorded with the pending request.  A request that arrived without a
+/// cause is tallied as \e unknown.  The cause bits are then cleared for
+/// the next iteration of analysis.
+void Funcdata::countRestart(void)
+
+{
+  if (restartCause == 0)
+    restartTally[cause_unknown] += 1;
+  for(int4 i=0;i<cause_max;++i) {
+    if ((restartCause & (1<<i))!=0)
+      restartTally[i] += 1;
+  }
+  restartCause = 0;
+}
+
+void Funcdata::clearRestartTally(void)
+
+{
+  for(int4 i=0;i<cause_max;++i)
+    restartTally[i] = 0;
+}
+
+int4 Funcdata::numRestarts(void) const
+
+{
+  int4 res = 0;
+  for(int4 i=0;i<cause_max;++i)
+    res += restartTally[i];
+  return res;
+}
+
+/// \param cause is the RestartCause to name
+/// \return a short display string for the cause
+const char *Funcdata::restartCauseName(int4 cause)
+
+{
+  switch(cause) {
+    case cause_jumptable:
+      return "jumptable";
+    case cause_prototype:
+      return "prototype";
+    case cause_deadcode:
+      return "deadcodedelay";
+    default:
+      break;
+  }
+  return "unknown";
+}
+
+/// \param addr is the queried address
+/// \param entry will hold the memoized symbol entry (or null) if a memo is found
+/// \return \b true if a memoized answer was found
+bool GlobalQueryCache::findContainer(const Address &addr,SymbolEntry *&entry) const
+
+{
+  map<AddrKey,SymbolEntry *>::const_iterator iter = containers.find(addr.toKey());
+  if (iter == containers.end()) return false;
+  entry = (*iter).second;
+  return true;
+}
+
+/// \param addr is the queried address
+/// \param fd will hold the memoized function (or null) if a memo is found
+/// \return \b true if a memoized answer was found
+bool GlobalQueryCache::findFunction(const Address &addr,Funcdata *&fd) const
+
+{
+  map<AddrKey,Funcdata *>::const_iterator iter = functions.find(addr.toKey());
+  if (iter == functions.end()) return false;
+  fd = (*iter).second;
+  return true;
+}
+
+/// \brief Find the global symbol containing the given address, through the memo cache
+///
+/// This wraps Scope::queryContainer() on the parent scope of the function for a
+/// 1-byte range with no specific usepoint.  Repeated queries for the same address
+/// within one decompilation are answered from the cache, which is discarded whenever
+/// the symbol table changes.
+/// \param addr is the given address
+/// \return the smallest global SymbolEntry containing the address, or null
+SymbolEntry *Funcdata::queryGlobalContainer(const Address &addr) const
+
+{
+  globalCache.checkCurrent(glb->symboltab->getChangeCounter());
+  SymbolEntry *entry;
+  if (globalCache.findContainer(addr,entry))
+    return entry;
+  entry = localmap->getParent()->queryContainer(addr,1,Address());
+  globalCache.recordContainer(addr,entry);
+  return entry;
+}
+
+/// \brief Find the function starting at the given address, through the memo cache
+///
+/// This wraps Scope::queryFunction() on the parent scope of the function.  Repeated
+/// queries for the same entry address within one decompilation are answered from the
+/// cache, which is discarded whenever the symbol table changes.
+/// \param addr is the given entry address
+/// \return the Funcdata object starting at the address, or null
+Funcdata *Funcdata::queryGlobalFunction(const Address &addr) const
+
+{
+  globalCache.checkCurrent(glb->symboltab->getChangeCounter());
+  Funcdata *fd;
+  if (globalCache.findFunction(addr,fd))
+    return fd;
+  fd = localmap->getParent()->queryFunction(addr);
+  globalCache.recordFunction(addr,fd);
+  return fd;
+}
+
+/// \brief Check if a failed sub-variable trace has been recorded for the given seed
+///
+/// Failed SubvariableFlow attempts are remembered per (Varnode, mask, trace mode)
+/// so bitfield-heavy code doesn't re-explore the same subgraph from every seed op.
+/// A negative result is only valid while the data-flow graph is unchanged; any
+/// Varnode creation since the last record invalidates the whole cache. Failed
+/// traces themselves create nothing, so seeds accumulate freely across the
+/// sub-variable rules within one sweep of the simplification pool.
+/// \param vn is the seed Varnode of the proposed trace
+/// \param mask is the seed mask describing the logical sub-variable
+/// \param mode encodes the trace variant (aggressive/sext/big flags)
+/// \return \b true if an identical trace attempt already failed
+bool Funcdata::isSubflowFailed(Varnode *vn,uintb mask,uint4 mode)
+
+{
+  if (subflowFailStamp != vbank.getCreateIndex()) {	// Graph has changed since last record
+    subflowFails.clear();
+    subflowFailStamp = vbank.getCreateIndex();
+    return false;
+  }
+  uint8 key = ((uint8)mode << 32) | vn->getCreateIndex();
+  return (subflowFails.find(pair<uint8,uintb>(key,mask)) != subflowFails.end());
+}
+
+/// \brief Record that a sub-variable trace from the given seed failed
+///
+/// \param vn is the seed Varnode of the failed trace
+/// \param mask is the seed mask describing the logical sub-variable
+/// \param mode encodes the trace variant (aggressive/sext/big flags)
+void Funcdata::recordSubflowFail(Varnode *vn,uintb mask,uint4 mode)
+
+{
+  if (subflowFailStamp != vbank.getCreateIndex()) {
+    subflowFails.clear();
+    subflowFailStamp = vbank.getCreateIndex();
+  }
+  uint8 key = ((uint8)mode << 32) | vn->getCreateIndex();
+  subflowFails.insert(pair<uint8,uintb>(key,mask));
+}
+
 /// The comment is added to the global database, indexed via its placement address and
 /// the entry address of the function. The emitter will attempt to place the comment
 /// before the source expression that maps most closely to the address.
@@ -224,6 +395,46 @@ void Funcdata::printRaw(ostream &s) const
     bblocks.printRaw(s);
 }
 
+/// Walk the Varnode and PcodeOp containers, estimating the heap bytes behind the
+/// current analysis state: the objects themselves, their per-object containers
+/// (descendant lists, input arrays), and any Cover objects attached to Varnodes.
+/// Node overhead for list/map entries is approximated as three pointers.  The
+/// estimate is intended for attributing memory growth across many functions, not
+/// for exact accounting.
+/// \param usage will hold the accumulated counts and byte estimates
+void Funcdata::measureMemory(FuncMemoryUsage &usage) const
+
+{
+  const int4 nodeoverhead = 3*sizeof(void *);
+
+  VarnodeLocSet::const_iterator viter;
+  for(viter=vbank.beginLoc();viter!=vbank.endLoc();++viter) {
+    const Varnode *vn = *viter;
+    usage.varnodecount += 1;
+    usage.varnodebytes += sizeof(Varnode) + nodeoverhead;
+    list<PcodeOp *>::const_iterator diter;
+    for(diter=vn->beginDescend();diter!=vn->endDescend();++diter)
+      usage.varnodebytes += sizeof(PcodeOp *) + nodeoverhead;
+    if (vn->hasCover()) {
+      const Cover *cov = vn->getCover();
+      if (cov != (const Cover *)0) {
+	usage.coverbytes += sizeof(Cover);
+	map<int4,CoverBlock>::const_iterator citer;
+	for(citer=cov->begin();citer!=cov->end();++citer)
+	  usage.coverbytes += sizeof(CoverBlock) + sizeof(int4) + nodeoverhead;
+      }
+    }
+  }
+
+  PcodeOpTree::const_iterator oiter;
+  for(oiter=obank.beginAll();oiter!=obank.endAll();++oiter) {
+    const PcodeOp *op = (*oiter).second;
+    usage.opcount += 1;
+    usage.opbytes += sizeof(PcodeOp) + nodeoverhead;
+    usage.opbytes += op->numInput() * sizeof(Varnode *);
+  }
+}
+
 /// This routine searches for an marks Varnode objects, like stack-pointer registers,
 /// that are used as a base address for a virtual address space. Each Varnode gets a
 /// special data-type and is marked so that Varnode::isSpacebase() returns \b true.
@@ -667,19 +878,18 @@ void Funcdata::encodeHigh(Encoder &encoder) const
   if (!isHighOn()) return;
   encoder.openElement(ELEM_HIGHLIST);
   VarnodeLocSet::const_iterator iter;
+  vector<HighVariable *> markedHigh;
   for(iter=beginLoc();iter!=endLoc();++iter) {
     vn = *iter;
     if (vn->isAnnotation()) continue;
     high = vn->getHigh();
     if (high->isMark()) continue;
     high->setMark();
+    markedHigh.push_back(high);
     high->encode(encoder);
   }
-  for(iter=beginLoc();iter!=endLoc();++iter) {
-    vn = *iter;
-    if (!vn->isAnnotation())
-      vn->getHigh()->clearMark();
-  }
+  for(int4 i=0;i<markedHigh.size();++i)
+    markedHigh[i]->clearMark();	// Clear just the highs we marked, avoiding a second full sweep
   encoder.closeElement(ELEM_HIGHLIST);
 }
 
@@ -964,6 +1174,62 @@ bool Funcdata::setUnionField(const Datatype *parent,const PcodeOp *op,int4 slot,
   return true;
 }
 
+/// Resolution verdicts in \b unionMap are keyed by PcodeOp ids that do not survive a
+/// restart of analysis.  For each verdict whose PcodeOp is still alive, compute a dynamic
+/// hash for its data-flow edge, and save the verdict and hash in \b unionSalvage so the
+/// verdict can be reattached (applyUnionSalvage) once data-flow is rebuilt, rather than
+/// repeating the field scoring.  This must be called while the data-flow is still intact.
+void Funcdata::salvageUnionResolutions(void)
+
+{
+  unionSalvage.clear();
+  if (unionMap.empty()) return;
+  map<uintm,PcodeOp *> aliveMap;	// Map from the id keying \b unionMap back to the PcodeOp
+  list<PcodeOp *>::const_iterator oiter;
+  for(oiter=obank.beginAlive();oiter!=obank.endAlive();++oiter)
+    aliveMap[(*oiter)->getTime()] = *oiter;
+  DynamicHash dhash;
+  map<ResolveEdge,ResolvedUnion>::const_iterator iter;
+  for(iter=unionMap.begin();iter!=unionMap.end();++iter) {
+    const ResolveEdge &edge((*iter).first);
+    map<uintm,PcodeOp *>::const_iterator fiter = aliveMap.find(edge.getOpTime());
+    if (fiter == aliveMap.end()) continue;	// The PcodeOp has been removed
+    dhash.clear();
+    dhash.uniqueHash((*fiter).second,edge.getSlot(),this);
+    if (dhash.getHash() == 0) continue;		// Could not uniquely identify the edge
+    unionSalvage.emplace_back(edge.getTypeId(),edge.getEncoding(),dhash.getAddress(),dhash.getHash(),(*iter).second);
+  }
+}
+
+/// Each salvaged verdict (salvageUnionResolutions) is located in the rebuilt data-flow
+/// via its dynamic hash and reentered in \b unionMap, where it will be found by the
+/// resolveInFlow() methods in place of a fresh scoring of the union fields.  A verdict
+/// whose edge cannot be found, possibly because SSA construction has not yet recreated
+/// it, is retained for a later attempt.
+/// \return the number of verdicts reattached
+int4 Funcdata::applyUnionSalvage(void)
+
+{
+  if (unionSalvage.empty()) return 0;
+  int4 count = 0;
+  DynamicHash dhash;
+  vector<UnionSalvage> remain;
+  for(int4 i=0;i<unionSalvage.size();++i) {
+    UnionSalvage &cur(unionSalvage[i]);
+    dhash.clear();
+    PcodeOp *op = dhash.findOp(this,cur.addr,cur.hash);
+    if (op == (PcodeOp *)0) {
+      remain.push_back(cur);	// The edge is not present (yet)
+      continue;
+    }
+    ResolveEdge edge(cur.typeId,op,cur.encoding);
+    if (unionMap.emplace(edge,cur.resolve).second)
+      count += 1;
+  }
+  unionSalvage.swap(remain);
+  return count;
+}
+
 /// \brief Force a specific union field resolution for the given edge
 ///
 /// The \b parent data-type is taken directly from the given Varnode.
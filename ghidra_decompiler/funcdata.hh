@@ -38,6 +38,123 @@ extern ElementId ELEM_HIGHLIST;		///< Marshaling element \<highlist>
 extern ElementId ELEM_JUMPTABLELIST;	///< Marshaling element \<jumptablelist>
 extern ElementId ELEM_VARNODES;		///< Marshaling element \<varnodes>
 
+/// \brief Estimated heap memory behind a single function's analysis state
+///
+/// Filled in by Funcdata::measureMemory().  The counts are exact; the byte totals are
+/// estimates built from object sizes plus the per-object container overhead, intended for
+/// attributing server memory growth rather than exact accounting.
+struct FuncMemoryUsage {
+  uint8 varnodebytes;		///< Bytes in Varnode objects (including descendant lists)
+  uint8 opbytes;		///< Bytes in PcodeOp objects (including input arrays)
+  uint8 coverbytes;		///< Bytes in Cover objects attached to Varnodes
+  int4 varnodecount;		///< Number of Varnodes
+  int4 opcount;			///< Number of PcodeOps
+  FuncMemoryUsage(void) { varnodebytes = 0; opbytes = 0; coverbytes = 0; varnodecount = 0; opcount = 0; }	///< Constructor
+  uint8 getTotal(void) const { return varnodebytes + opbytes + coverbytes; }	///< Get total estimated bytes
+};
+
+/// \brief A union field resolution salvaged across a restart of analysis
+///
+/// Resolution verdicts in the Funcdata union resolution map are keyed by PcodeOp ids that
+/// do not survive a restart.  This holds one verdict, together with a dynamic hash of the
+/// data-flow edge it was attached to, so the verdict can be reattached once data-flow is
+/// rebuilt, rather than repeating the field scoring.
+struct UnionSalvage {
+  uint8 typeId;			///< Id of the base data-type being resolved
+  int4 encoding;		///< Encoding of the slot and pointer-ness of the original edge
+  Address addr;			///< Address of the PcodeOp of the original edge
+  uint8 hash;			///< Dynamic hash identifying the edge in rebuilt data-flow
+  ResolvedUnion resolve;	///< The resolution verdict being preserved
+
+  /// \brief Constructor
+  ///
+  /// \param id is the id of the base data-type being resolved
+  /// \param code is the encoded slot and pointer-ness of the original edge
+  /// \param ad is the address of the PcodeOp of the original edge
+  /// \param h is the dynamic hash identifying the edge
+  /// \param r is the resolution verdict being preserved
+  UnionSalvage(uint8 id,int4 code,const Address &ad,uint8 h,const ResolvedUnion &r)
+    : addr(ad), resolve(r) { typeId = id; encoding = code; hash = h; }
+};
+
+/// \brief One p-code op of a cached in-line expansion sequence
+///
+/// When a straight-line leaf function (the \e EZ in-lining model) is in-lined, the decoded
+/// op sequence is the same at every call site, up to the address part of the sequence
+/// numbers.  After the first expansion the sequence is captured as a list of these raw
+/// templates attached to the in-lined function, so later call sites can stamp the ops
+/// directly into the caller without re-decoding the function.  The sequence depends only
+/// on the function's image bytes and global context, so it stays valid until the
+/// function's analysis state is cleared.
+struct InlineEZOp {
+  OpCode opc;			///< The op-code
+  uint4 flags;			///< Control-flow properties (\e startmark, \e startbasic) to replicate
+  uintm time;			///< Sub-address portion of the original op's sequence number
+  bool hasOutput;		///< \b true if the op has an output Varnode
+  VarnodeData outvar;		///< Storage of the output Varnode (if present)
+  vector<VarnodeData> invar;	///< Storage of the input Varnodes
+};
+
+/// \brief A cache of symbol-table property queries made during Varnode creation
+///
+/// Every Varnode created at a mapped storage location asks the symbol table for its
+/// boolean properties (read-only, volatile, etc.) and a containing symbol, which walks
+/// the scope hierarchy.  The verdicts are accumulated here in one sorted array per
+/// address space, so the heavily repeated queries against the same storage ranges are
+/// answered with a single binary search.  Only \e usepoint independent verdicts are
+/// cached:  an address space where the local scope holds use-limited symbol entries is
+/// excluded entirely, as is any individual entry with a use limit.  The cache is
+/// discarded whenever the symbol table registers a change (Database::getChangeCounter).
+class VarnodePropertyCache {
+  /// \brief A cached verdict for one queried storage range
+  struct Verdict {
+    uintb first;		///< Offset of the first byte of the queried range
+    uintb last;			///< Offset of the last byte of the queried range
+    uint4 flags;		///< Boolean properties of the range
+    SymbolEntry *entry;		///< Symbol entry containing the range, or null
+    /// \brief Compare verdicts by offset range
+    bool operator<(const Verdict &op2) const {
+      if (first != op2.first) return (first < op2.first);
+      return (last < op2.last);
+    }
+  };
+  vector<vector<Verdict> > table;	///< Sorted verdicts for each address space
+  vector<bool> cacheable;	///< For each address space, \b true if verdicts are usepoint independent
+  uint4 lastChange;		///< Symbol table change counter when the cache was built
+public:
+  VarnodePropertyCache(void) { lastChange = ~((uint4)0); }	///< Constructor
+  bool isCurrent(uint4 counter) const { return (!table.empty() && counter == lastChange); }	///< Is the cache up to date
+  void build(const Scope *scope,int4 numSpaces,uint4 counter);	///< Clear the cache and recompute which spaces are cacheable
+  bool query(const Address &addr,int4 size,uint4 &flags,SymbolEntry *&entry) const;	///< Look for a cached verdict
+  void record(const Address &addr,int4 size,uint4 flags,SymbolEntry *entry);	///< Cache the verdict of a query
+};
+
+/// \brief A cache of global scope queries made on behalf of a single function
+///
+/// Call target resolution and constant pointer analysis repeatedly ask the global scope
+/// about the same addresses over the course of one decompilation.  The answers are
+/// memoized here, keyed by the packed form of the queried address, and are discarded
+/// whenever the symbol table registers a change (Database::getChangeCounter).
+class GlobalQueryCache {
+  map<AddrKey,SymbolEntry *> containers;	///< Memoized Scope::queryContainer() answers (for size 1 ranges)
+  map<AddrKey,Funcdata *> functions;	///< Memoized Scope::queryFunction() answers
+  uint4 lastChange;		///< Symbol table change counter when the memos were recorded
+public:
+  GlobalQueryCache(void) { lastChange = ~((uint4)0); }	///< Constructor
+
+  /// \brief Discard all memos if the symbol table has changed since they were recorded
+  void checkCurrent(uint4 counter) {
+    if (counter == lastChange) return;
+    containers.clear();
+    functions.clear();
+    lastChange = counter;
+  }
+  bool findContainer(const Address &addr,SymbolEntry *&entry) const;	///< Look for a memoized container query
+  void recordContainer(const Address &addr,SymbolEntry *entry) { containers[addr.toKey()] = entry; }	///< Memoize a container query
+  bool findFunction(const Address &addr,Funcdata *&fd) const;	///< Look for a memoized function query
+  void recordFunction(const Address &addr,Funcdata *fd) { functions[addr.toKey()] = fd; }	///< Memoize a function query
+};
+
 /// \brief Container for data structures associated with a single function
 ///
 /// This class holds the primary data structures for decompiling a function. In particular it holds
@@ -54,6 +171,16 @@ extern ElementId ELEM_VARNODES;		///< Marshaling element \<varnodes>
 ///    - Access to subfunction prototypes
 ///    - Access to jump-tables (within the body of the function)
 class Funcdata {
+public:
+  /// \brief Causes that can trigger a full restart of analysis
+  enum RestartCause {
+    cause_unknown = 0,		///< Restart was requested without a recorded cause
+    cause_jumptable = 1,	///< A multistage jump-table was recovered late
+    cause_prototype = 2,	///< A (sub)function prototype was discovered too late to apply in place
+    cause_deadcode = 3,		///< A dead-code delay was installed on an address space
+    cause_max = 4		///< Number of distinct causes
+  };
+private:
   enum {
     highlevel_on = 1,		///< Set if Varnodes have HighVariables assigned
     blocks_generated = 2,	///< Set if Basic blocks have been generated
@@ -69,9 +196,13 @@ class Funcdata {
     unimplemented_present = 0x800,	///< Set if function contains unimplemented instructions
     baddata_present = 0x1000,	///< Set if function flowed into bad data
     double_precis_on = 0x2000,	///< Set if we are performing double precision recovery
-    typerecovery_exceeded= 0x4000	///< Set if data-type propagation passes reached maximum
+    typerecovery_exceeded= 0x4000,	///< Set if data-type propagation passes reached maximum
+    structure_hold = 0x8000,	///< Set if control-flow edits are being batched, deferring structure recalculation
+    structure_pending = 0x10000	///< Set if a deferred structure recalculation is owed at the end of the batch
   };
   uint4 flags;			///< Boolean properties associated with \b this function
+  uint4 restartCause;		///< Cause bits (1 shifted by RestartCause) behind a pending restart
+  int4 restartTally[cause_max];	///< Count of restarts performed, indexed by triggering cause
   uint4 clean_up_index;		///< Creation index of first Varnode created after start of cleanup
   uint4 high_level_index;	///< Creation index of first Varnode created after HighVariables are created
   uint4 cast_phase_index;	///< Creation index of first Varnode created after ActionSetCasts
@@ -84,6 +215,8 @@ class Funcdata {
   Address baseaddr;		///< Starting code address of binary data
   FuncProto funcp;		///< Prototype of this function
   ScopeLocal *localmap;		///< Local variables (symbols in the function scope)
+  mutable VarnodePropertyCache propertyCache;	///< Cached symbol-table property queries for Varnode creation
+  mutable GlobalQueryCache globalCache;	///< Memoized global scope queries made during analysis
 
   vector<FuncCallSpecs *> qlst;	///< List of calls this function makes
   vector<JumpTable *> jumpvec;	///< List of jump-tables for this function
@@ -97,7 +230,13 @@ class Funcdata {
   ParamActive *activeoutput;	///< Data for assessing which parameters are passed to \b this function
   Override localoverride;	///< Overrides of data-flow, prototypes, etc. that are local to \b this function
   map<VarnodeData,const LanedRegister *> lanedMap;	///< Current storage locations which may be laned registers
+  TransformArena transformArena;	///< Reusable storage backing placeholder nodes during transforms
   map<ResolveEdge,ResolvedUnion> unionMap;	///< A map from data-flow edges to the resolved field of TypeUnion being accessed
+  vector<UnionSalvage> unionSalvage;	///< Union resolutions salvaged before a restart, awaiting reattachment
+  set<pair<uint8,uintb>> subflowFails;	///< Sub-variable seeds that failed to trace, while the graph is unchanged
+  uint4 subflowFailStamp;	///< Varnode creation index for which \b subflowFails is valid
+  vector<InlineEZOp> inlineEZCache;	///< Cached op sequence for in-lining \b this function with the EZ model
+  bool inlineEZValid;		///< Set if \b inlineEZCache holds a valid sequence
 
 				// Low level Varnode functions
   void setVarnodeProperties(Varnode *vn) const;	///< Look-up boolean properties and data-type information
@@ -111,6 +250,7 @@ class Funcdata {
   void destroyVarnode(Varnode *vn);		///< Delete the given Varnode from \b this function
   void coverVarnodes(SymbolEntry *entry,vector<Varnode *> &list);
   bool applyUnionFacet(SymbolEntry *entry,DynamicHash &dhash);
+  void salvageUnionResolutions(void);	///< Hash union resolutions in advance of a restart
 				// Low level op functions
   void opZeroMulti(PcodeOp *op);		///< Transform trivial CPUI_MULTIEQUAL to CPUI_COPY
 				// Low level block functions
@@ -168,7 +308,7 @@ public:
 
   bool isDoublePrecisOn(void) const { return ((flags & double_precis_on)!=0); }	///< Is double precision analysis enabled
   bool hasNoStructBlocks(void) const { return (sblocks.getSize() == 0); }	///< Return \b true if no block structuring was performed
-  void clear(void);						///< Clear out old disassembly
+  void clear(bool keepRecovered=false);				///< Clear out old disassembly
   void warning(const string &txt,const Address &ad) const;	///< Add a warning comment in the function body
   void warningHeader(const string &txt) const;			///< Add a warning comment as part of the function header
   void startProcessing(void);					///< Start processing for this function
@@ -185,10 +325,14 @@ public:
   uint4 getHighLevelIndex(void) const { return high_level_index; }	///< Get creation index at the start of HighVariable creation
   void startCleanUp(void) { clean_up_index = vbank.getCreateIndex(); }	///< Start \e clean-up phase
   uint4 getCleanUpIndex(void) const { return clean_up_index; }	///< Get creation index at the start of \b clean-up phase
+  uint4 getCreateIndex(void) const { return vbank.getCreateIndex(); }	///< Get the creation index of the next Varnode to be created
 
   void followFlow(const Address &baddr,const Address &eadddr);
   void truncatedFlow(const Funcdata *fd,const FlowInfo *flow);
   int4 inlineFlow(Funcdata *inlinefd,FlowInfo &flow,PcodeOp *callop);
+  void cacheInlineEZ(void);			///< Capture the generated op sequence of \b this for repeated in-lining
+  void stampInlineEZ(const Funcdata *inlinefd,PcodeOp *callop);	///< Stamp a cached in-line sequence at the given call site
+  bool hasInlineEZCache(void) const { return inlineEZValid; }	///< Is a cached in-line sequence available for \b this function
   void overrideFlow(const Address &addr,uint4 type);
   void doLiveInject(InjectPayload *payload,const Address &addr,BlockBasic *bl,list<PcodeOp *>::iterator pos);
   
@@ -208,13 +352,23 @@ public:
   /// \brief Toggle whether analysis needs to be restarted for \b this function
   ///
   /// \param val is \b true if a reset is required
-  void setRestartPending(bool val) { flags = val ? (flags|restart_pending) : (flags & ~((uint4)restart_pending)); }
+  /// \param cause is the RestartCause being recorded with the request
+  void setRestartPending(bool val,uint4 cause=cause_unknown) {
+    flags = val ? (flags|restart_pending) : (flags & ~((uint4)restart_pending));
+    if (val) restartCause |= (1 << cause);
+  }
 
   /// \brief Does \b this function need to restart its analysis
   ///
   /// \return \b true if analysis should be restarted
   bool hasRestartPending(void) const { return ((flags&restart_pending)!=0); }
 
+  void countRestart(void);	///< Tally the pending restart against its recorded cause(s)
+  void clearRestartTally(void);	///< Reset restart counts at the start of a fresh decompilation
+  int4 numRestarts(void) const;	///< Get the number of restarts performed so far
+  int4 getRestartCount(int4 cause) const { return restartTally[cause]; }	///< Get the number of restarts attributed to a cause
+  static const char *restartCauseName(int4 cause);	///< Get the display name of a RestartCause
+
   /// \brief Does \b this function have instructions marked as \e unimplemented
   ///
   /// \return \b true if the function's body contains at least one unimplemented instruction
@@ -275,6 +429,8 @@ public:
   FuncCallSpecs *getCallSpecs(const PcodeOp *op) const;	///< Get the call specification associated with a CALL op
   int4 fillinExtrapop(void);			///< Recover and return the \e extrapop for this function
 
+  void measureMemory(FuncMemoryUsage &usage) const;	///< Estimate heap memory behind the current analysis state
+
   // Varnode routines
   int4 numVarnodes(void) const { return vbank.numVarnodes(); }	///< Get the total number of Varnodes
   Varnode *newVarnodeOut(int4 s,const Address &m,PcodeOp *op);	///< Create a new output Varnode
@@ -406,6 +562,9 @@ public:
   void totalReplaceConstant(Varnode *vn,uintb val);
   ScopeLocal *getScopeLocal(void) { return localmap; }		///< Get the local function scope
   const ScopeLocal *getScopeLocal(void) const { return localmap; }	///< Get the local function scope
+  SymbolEntry *queryScopeProperties(const Address &addr,int4 size,const Address &usepoint,uint4 &flags) const;
+  SymbolEntry *queryGlobalContainer(const Address &addr) const;	///< Query the global scope for a symbol containing an address
+  Funcdata *queryGlobalFunction(const Address &addr) const;	///< Query the global scope for a function at an address
   FuncProto &getFuncProto(void) { return funcp; }		///< Get the function's prototype object
   const FuncProto &getFuncProto(void) const { return funcp; }	///< Get the function's prototype object
   void initActiveOutput(void);					///< Initialize \e return prototype recovery analysis
@@ -431,6 +590,7 @@ public:
   bool attemptDynamicMapping(SymbolEntry *entry,DynamicHash &dhash);
   bool attemptDynamicMappingLate(SymbolEntry *entry,DynamicHash &dhash);
   Merge &getMerge(void) { return covermerge; }			///< Get the Merge object for \b this function
+  TransformArena *getTransformArena(void) { return &transformArena; }	///< Get the arena backing transform placeholders
   Varnode *getInternalString(const uint1 *buf,int4 size,Datatype *ptrType,PcodeOp *readOp);
 
   // op routines
@@ -466,6 +626,7 @@ public:
   void opDestroy(PcodeOp *op);					///< Remove given PcodeOp and destroy its Varnode operands
   void opDestroyRecursive(PcodeOp *op,vector<PcodeOp *> &scratch);	///< Remove a PcodeOp and recursively remove ops producing its inputs
   void opDestroyRaw(PcodeOp *op);				///< Remove the given \e raw PcodeOp
+  void opRecycleRetired(void) { obank.recycleRetired(); }	///< Recycle storage of retired PcodeOps
   void opDeadAndGone(PcodeOp *op) { obank.destroy(op); }	///< Free resources for the given \e dead PcodeOp
   void opSetAllInput(PcodeOp *op,const vector<Varnode *> &vvec);	///< Set all input Varnodes for the given PcodeOp simultaneously
   void opRemoveInput(PcodeOp *op,int4 slot);			///< Remove a specific input slot for the given PcodeOp
@@ -525,6 +686,7 @@ public:
   bool setUnionField(const Datatype *parent,const PcodeOp *op,int4 slot,const ResolvedUnion &resolve);
   void forceFacingType(Datatype *parent,int4 fieldNum,PcodeOp *op,int4 slot);
   int4 inheritResolution(Datatype *parent,const PcodeOp *op,int4 slot,PcodeOp *oldOp,int4 oldSlot);
+  int4 applyUnionSalvage(void);		///< Reattach union resolutions salvaged before a restart
 
   // Jumptable routines
   JumpTable *linkJumpTable(PcodeOp *op);		///< Link jump-table with a given BRANCHIND
@@ -533,6 +695,8 @@ public:
   JumpTable *recoverJumpTable(Funcdata &partial,PcodeOp *op,FlowInfo *flow,JumpTable::RecoveryMode &mode);
   JumpTable::RecoveryMode earlyJumpTableFail(PcodeOp *op);	///< Try to determine, early, if jump-table analysis will fail
   int4 numJumpTables(void) const { return jumpvec.size(); }	///< Get the number of jump-tables for \b this function
+  bool isSubflowFailed(Varnode *vn,uintb mask,uint4 mode);	///< Check if a sub-variable trace from the given seed failed before
+  void recordSubflowFail(Varnode *vn,uintb mask,uint4 mode);	///< Record that a sub-variable trace from the given seed failed
   JumpTable *getJumpTable(int4 i) { return jumpvec[i]; }	///< Get the i-th jump-table
   void removeJumpTable(JumpTable *jt);			///< Remove/delete the given jump-table
 
@@ -548,6 +712,8 @@ public:
   /// \param end is the ending Address of the owned code range
   void setBasicBlockRange(BlockBasic *bb,const Address &beg,const Address &end) { bb->setInitialRange(beg, end); }
 
+  void startCfgBatch(void);			///< Start batching control-flow edits, deferring structure recalculation
+  void endCfgBatch(void);			///< End a batch of control-flow edits, recalculating structure once if owed
   void removeDoNothingBlock(BlockBasic *bb);	///< Remove a basic block from control-flow that performs no operations
   bool removeUnreachableBlocks(bool issuewarning,bool checkexistence);
   void pushBranch(BlockBasic *bb,int4 slot,BlockBasic *bbnew);
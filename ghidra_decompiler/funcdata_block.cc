@@ -38,7 +38,9 @@ void Funcdata::clearBlocks(void)
   sblocks.clear();
 }
 
-/// Any override information is preserved.
+/// Any override information is preserved.  Fully recovered tables are retained in
+/// their address-only form, so that a restarted analysis revalidates the addresses
+/// against the rebuilt data-flow instead of rerunning the full recovery emulation.
 void Funcdata::clearJumpTables(void)
 
 {
@@ -51,6 +53,10 @@ void Funcdata::clearJumpTables(void)
       jt->clear();		// Clear out any derived data
       remain.push_back(jt);	// Keep the override itself
     }
+    else if (jt->isRecovered() && !jt->isPartial()) {
+      jt->clearForRestart();	// Keep the recovered addresses
+      remain.push_back(jt);
+    }
     else
       delete jt;
   }
@@ -704,6 +710,10 @@ void Funcdata::structureReset(void)
   vector<JumpTable *>::iterator iter;
   vector<FlowBlock *> rootlist;
 
+  if ((flags & structure_hold)!=0) {	// A batch of control-flow edits is underway
+    flags |= structure_pending;		// Recalculation is owed at the end of the batch
+    return;
+  }
   flags &= ~blocks_unreachable;	// Clear any old blocks flag
   bblocks.structureLoops(rootlist);
   bblocks.calcForwardDominator(rootlist);
@@ -727,6 +737,28 @@ void Funcdata::structureReset(void)
   heritage.forceRestructure();
 }
 
+/// Between this call and the matching endCfgBatch(), any structureReset() triggered by a
+/// control-flow edit is deferred:  the list surgery for each edit is still applied
+/// immediately, but loop structure and dominance are recalculated only once, at the end
+/// of the batch.  Code inside a batch must not rely on dominator or loop information.
+void Funcdata::startCfgBatch(void)
+
+{
+  flags |= structure_hold;
+}
+
+/// Close the batch opened by startCfgBatch().  If any control-flow edit requested a
+/// structure recalculation during the batch, it is performed now.
+void Funcdata::endCfgBatch(void)
+
+{
+  flags &= ~structure_hold;
+  if ((flags & structure_pending)!=0) {
+    flags &= ~structure_pending;
+    structureReset();
+  }
+}
+
 /// \brief Force a specific control-flow edge to be marked as \e unstructured
 ///
 /// The edge is specified by a source and destination Address (of the branch).
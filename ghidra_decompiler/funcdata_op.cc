@@ -853,6 +853,27 @@ void Funcdata::truncatedFlow(const Funcdata *fd,const FlowInfo *flow)
 int4 Funcdata::inlineFlow(Funcdata *inlinefd,FlowInfo &flow,PcodeOp *callop)
 
 {
+  if (inlinefd->hasInlineEZCache()) {	// A previous expansion captured the op sequence
+    list<PcodeOp *>::const_iterator oiter = obank.endDead();
+    --oiter;			// There is at least one op
+    stampInlineEZ(inlinefd,callop);
+    ++oiter;
+    if (oiter != obank.endDead()) { // If there was at least one PcodeOp stamped
+      PcodeOp *firstop = *oiter;
+      oiter = obank.endDead();
+      --oiter;
+      PcodeOp *lastop = *oiter;
+      obank.moveSequenceDead(firstop,lastop,callop); // Move the sequence to right after callop
+      if (callop->isBlockStart()) {
+	firstop->setFlag(PcodeOp::startbasic); // First op of inline inherits callop's startbasic flag
+	flow.updateTarget(callop, firstop);
+      }
+      else
+	firstop->clearFlag(PcodeOp::startbasic);
+    }
+    opDestroyRaw(callop);
+    return 0;
+  }
   inlinefd->getArch()->clearAnalysis(inlinefd);
   FlowInfo inlineflow(*inlinefd,inlinefd->obank,inlinefd->bblocks,inlinefd->qlst);
   inlinefd->obank.setUniqId( obank.getUniqId() );
@@ -888,6 +909,8 @@ int4 Funcdata::inlineFlow(Funcdata *inlinefd,FlowInfo &flow,PcodeOp *callop)
 	firstop->clearFlag(PcodeOp::startbasic);
     }
     opDestroyRaw(callop);
+    if (inlinefd->obank.getUniqId() == obank.getUniqId())	// If generation allocated no dynamic temporaries,
+      inlinefd->cacheInlineEZ();	// the sequence is caller independent and can be reused
   }
   else {
     Address retaddr;
@@ -911,10 +934,74 @@ int4 Funcdata::inlineFlow(Funcdata *inlinefd,FlowInfo &flow,PcodeOp *callop)
   }
 
   obank.setUniqId( inlinefd->obank.getUniqId() );
-  
+
   return res;
 }
 
+/// The sequence of dead PcodeOps just generated for \b this function, up to the first
+/// RETURN, is captured as raw templates in \b inlineEZCache.  The capture is only made
+/// for EZ model expansions where generation allocated no dynamic temporaries, so the
+/// sequence contains nothing specific to the caller it was generated for.  The cache is
+/// dropped whenever the analysis state of \b this function clears.
+void Funcdata::cacheInlineEZ(void)
+
+{
+  list<PcodeOp *>::const_iterator iter;
+
+  inlineEZCache.clear();
+  for(iter=obank.beginDead();iter!=obank.endDead();++iter) {
+    PcodeOp *op = *iter;
+    if (op->code() == CPUI_RETURN) break;
+    inlineEZCache.emplace_back();
+    InlineEZOp &rec( inlineEZCache.back() );
+    rec.opc = op->code();
+    rec.flags = op->flags & (PcodeOp::startmark | PcodeOp::startbasic);
+    rec.time = op->getSeqNum().getTime();
+    Varnode *outvn = op->getOut();
+    rec.hasOutput = (outvn != (Varnode *)0);
+    if (rec.hasOutput) {
+      rec.outvar.space = outvn->getSpace();
+      rec.outvar.offset = outvn->getOffset();
+      rec.outvar.size = outvn->getSize();
+    }
+    for(int4 i=0;i<op->numInput();++i) {
+      Varnode *vn = op->getIn(i);
+      rec.invar.emplace_back();
+      rec.invar.back().space = vn->getSpace();
+      rec.invar.back().offset = vn->getOffset();
+      rec.invar.back().size = vn->getSize();
+    }
+  }
+  inlineEZValid = true;
+}
+
+/// Raw ops from the in-line function's cached EZ sequence are instantiated in \b this
+/// function's dead list, assigned to the fixed address of the call site, matching what
+/// a fresh expansion through inlineEZClone() would produce.
+/// \param inlinefd is the in-line function holding a cached sequence
+/// \param callop is the CALL op at the site of the in-line
+void Funcdata::stampInlineEZ(const Funcdata *inlinefd,PcodeOp *callop)
+
+{
+  vector<InlineEZOp>::const_iterator iter;
+
+  for(iter=inlinefd->inlineEZCache.begin();iter!=inlinefd->inlineEZCache.end();++iter) {
+    const InlineEZOp &rec( *iter );
+    SeqNum myseq(callop->getAddr(),rec.time);
+    PcodeOp *op = newOp((int4)rec.invar.size(),myseq);
+    opSetOpcode(op,rec.opc);
+    op->setFlag(rec.flags);
+    if (rec.hasOutput) {
+      Address oaddr(rec.outvar.space,rec.outvar.offset);
+      newVarnodeOut(rec.outvar.size,oaddr,op);
+    }
+    for(int4 i=0;i<rec.invar.size();++i) {
+      Varnode *vn = newVarnode(rec.invar[i].size,rec.invar[i].space,rec.invar[i].offset);
+      opSetInput(op,vn,i);
+    }
+  }
+}
+
 /// \brief Find the primary branch operation for an instruction
 ///
 /// For machine instructions that branch, this finds the \e primary PcodeOp that performs
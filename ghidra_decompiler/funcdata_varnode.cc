@@ -19,6 +19,99 @@ namespace ghidra {
 
 // Funcdata members pertaining directly to varnodes
 
+/// Walk the SymbolEntry objects mapped by the given scope and mark the address space
+/// of any entry with a use limit as not cacheable.  All other state is cleared.
+/// \param scope is the given (local) scope
+/// \param numSpaces is the number of address spaces to prepare for
+/// \param counter is the current symbol table change counter
+void VarnodePropertyCache::build(const Scope *scope,int4 numSpaces,uint4 counter)
+
+{
+  table.clear();
+  table.resize(numSpaces);
+  cacheable.clear();
+  cacheable.resize(numSpaces,true);
+  MapIterator iter = scope->begin();
+  MapIterator enditer = scope->end();
+  while(iter != enditer) {
+    const SymbolEntry *entry = *iter;
+    ++iter;
+    if (!entry->getUseLimit().empty())
+      cacheable[entry->getAddr().getSpace()->getIndex()] = false;
+  }
+  lastChange = counter;
+}
+
+/// \param addr is the starting address of the queried range
+/// \param size is the number of bytes in the range
+/// \param flags will hold the cached boolean properties if a verdict is found
+/// \param entry will hold the cached symbol entry (or null) if a verdict is found
+/// \return \b true if a cached verdict was found
+bool VarnodePropertyCache::query(const Address &addr,int4 size,uint4 &flags,SymbolEntry *&entry) const
+
+{
+  int4 index = addr.getSpace()->getIndex();
+  if (!cacheable[index]) return false;
+  const vector<Verdict> &vec(table[index]);
+  Verdict probe;
+  probe.first = addr.getOffset();
+  probe.last = probe.first + (size-1);
+  vector<Verdict>::const_iterator iter = lower_bound(vec.begin(),vec.end(),probe);
+  if (iter == vec.end() || (*iter).first != probe.first || (*iter).last != probe.last)
+    return false;
+  flags = (*iter).flags;
+  entry = (*iter).entry;
+  return true;
+}
+
+/// The verdict is inserted in sorted position.  Nothing is recorded for an
+/// uncacheable address space or for an entry restricted by a use limit.
+/// \param addr is the starting address of the queried range
+/// \param size is the number of bytes in the range
+/// \param flags is the boolean properties the query produced
+/// \param entry is the symbol entry (or null) the query produced
+void VarnodePropertyCache::record(const Address &addr,int4 size,uint4 flags,SymbolEntry *entry)
+
+{
+  int4 index = addr.getSpace()->getIndex();
+  if (!cacheable[index]) return;
+  if (entry != (SymbolEntry *)0 && !entry->getUseLimit().empty())
+    return;			// Verdict may depend on the usepoint
+  vector<Verdict> &vec(table[index]);
+  Verdict probe;
+  probe.first = addr.getOffset();
+  probe.last = probe.first + (size-1);
+  probe.flags = flags;
+  probe.entry = entry;
+  vector<Verdict>::iterator iter = lower_bound(vec.begin(),vec.end(),probe);
+  if (iter != vec.end() && (*iter).first == probe.first && (*iter).last == probe.last)
+    return;			// Already recorded
+  vec.insert(iter,probe);
+}
+
+/// \brief Query the symbol table for properties of a storage location, through the cache
+///
+/// This wraps Scope::queryProperties() with the per-function VarnodePropertyCache,
+/// rebuilding the cache if the symbol table has changed since it was filled.
+/// \param addr is the starting address of the storage location
+/// \param size is the number of bytes in the location
+/// \param usepoint is a point at which the location is accessed (may be \e invalid)
+/// \param flags is a reference used to pass back the boolean properties
+/// \return the smallest SymbolEntry containing the location, or null
+SymbolEntry *Funcdata::queryScopeProperties(const Address &addr,int4 size,const Address &usepoint,uint4 &flags) const
+
+{
+  uint4 counter = glb->symboltab->getChangeCounter();
+  if (!propertyCache.isCurrent(counter))
+    propertyCache.build(localmap,glb->numSpaces(),counter);
+  SymbolEntry *entry;
+  if (propertyCache.query(addr,size,flags,entry))
+    return entry;
+  entry = localmap->queryProperties(addr,size,usepoint,flags);
+  propertyCache.record(addr,size,flags,entry);
+  return entry;
+}
+
 /// Properties of a given storage location are gathered from symbol information and
 /// applied to the given Varnode.
 /// \param vn is the given Varnode
@@ -28,7 +121,7 @@ void Funcdata::setVarnodeProperties(Varnode *vn) const
   if (!vn->isMapped()) {
   // One more chance to find entry, now that we know usepoint
     uint4 vflags=0;
-    SymbolEntry *entry = localmap->queryProperties(vn->getAddr(),vn->getSize(),vn->getUsePoint(*this),vflags);
+    SymbolEntry *entry = queryScopeProperties(vn->getAddr(),vn->getSize(),vn->getUsePoint(*this),vflags);
     if (entry != (SymbolEntry *)0) // Let entry try to force type
       vn->setSymbolProperties(entry);
     else
@@ -112,7 +205,7 @@ Varnode *Funcdata::newVarnodeOut(int4 s,const Address &m,PcodeOp *op)
   if (s >= minLanedSize)
     checkForLanedRegister(s,m);
   uint4 vflags = 0;
-  SymbolEntry *entry = localmap->queryProperties(m,s,op->getAddr(),vflags);
+  SymbolEntry *entry = queryScopeProperties(m,s,op->getAddr(),vflags);
   if (entry != (SymbolEntry *)0)
     vn->setSymbolProperties(entry);
   else
@@ -159,7 +252,7 @@ Varnode *Funcdata::newVarnode(int4 s,const Address &m,Datatype *ct)
   if (s >= minLanedSize)
     checkForLanedRegister(s,m);
   uint4 vflags=0;
-  SymbolEntry *entry = localmap->queryProperties(vn->getAddr(),vn->getSize(),Address(),vflags);
+  SymbolEntry *entry = queryScopeProperties(vn->getAddr(),vn->getSize(),Address(),vflags);
   if (entry != (SymbolEntry *)0)	// Let entry try to force type
     vn->setSymbolProperties(entry);
   else
@@ -141,6 +141,7 @@ int4 GhidraCommand::doit(void)
   }
   catch(JavaError &err) {
     ArchitectureGhidra::passJavaException(sout,err.type,err.explain);
+    sout.flush();
     return status;			// Abort sending any results
   }
   catch(RecovError &err) {
@@ -155,7 +156,13 @@ int4 GhidraCommand::doit(void)
   }
   sendResult();
   sout.write("\000\000\001\007",4); // Command response closer
-  sout.flush();
+  // Pipelining: when the client has already queued its next command, leave
+  // this response in the output buffer and let the flush happen once the
+  // input drains, so a batch of commands costs one flush cycle instead of a
+  // round trip each.  A synchronous client never has input pending and still
+  // gets a flush per command.
+  if (sin.rdbuf()->in_avail() <= 0)
+    sout.flush();
   return status;
 }
 
@@ -479,7 +486,8 @@ int4 GhidraCapability::readCommand(istream &sin,ostream &out)
     out << "Bad command: " << function;
     out.write("\000\000\001\021",4);
     out.write("\000\000\001\007",4); // Command response closer
-    out.flush();
+    if (sin.rdbuf()->in_avail() <= 0)
+      out.flush();
     return 0;
   }
   return (*iter).second->doit();
@@ -518,6 +526,10 @@ int main(int argc,char **argv)
   _setmode(_fileno(stdin), _O_BINARY);
   _setmode(_fileno(stdout), _O_BINARY);
 #endif
+  // Untie the streams: with the default tie every read of cin flushes cout,
+  // which would force one round trip per command even when a headless driver
+  // pipelines a batch of commands.  Response order is unaffected.
+  cin.tie((ostream *)0);
   AttributeId::initialize();
   ElementId::initialize();
   CapabilityPoint::initializeAll();
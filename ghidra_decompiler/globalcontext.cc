@@ -441,6 +441,7 @@ void ContextInternal::getRegionForSet(vector<uintm *> &res,const Address &addr1,
     maskPtr[num] |= mask;		// Mark that this value is being definitely set
     ++aiter;
   }
+  database.prepareReads();
 }
 
 void ContextInternal::getRegionToChangePoint(vector<uintm *> &res,const Address &addr,int4 num,uintm mask)
@@ -452,7 +453,10 @@ void ContextInternal::getRegionToChangePoint(vector<uintm *> &res,const Address
 
   aiter = database.begin(addr);
   biter = database.end();
-  if (aiter == biter) return;
+  if (aiter == biter) {
+    database.prepareReads();
+    return;
+  }
   vecArray = (*aiter).second.array;
   res.push_back(vecArray);
   maskArray = (*aiter).second.mask;
@@ -465,6 +469,7 @@ void ContextInternal::getRegionToChangePoint(vector<uintm *> &res,const Address
     res.push_back(vecArray);
     ++aiter;
   }
+  database.prepareReads();
 }
 
 TrackedSet &ContextInternal::createSet(const Address &addr1,const Address &addr2)
@@ -472,6 +477,7 @@ TrackedSet &ContextInternal::createSet(const Address &addr1,const Address &addr2
 {
   TrackedSet &res(trackbase.clearRange(addr1,addr2));
   res.clear();
+  trackbase.prepareReads();
   return res;
 }
 
@@ -526,6 +532,8 @@ void ContextInternal::decode(Decoder &decoder)
     decoder.closeElement(subId);
   }
   decoder.closeElement(elemId);
+  database.prepareReads();
+  trackbase.prepareReads();
 }
 
 void ContextInternal::decodeFromSpec(Decoder &decoder)
@@ -559,6 +567,7 @@ ContextCache::ContextCache(ContextDatabase *db)
   database = db;
   curspace = (AddrSpace *)0;	// Mark cache as invalid
   allowset = true;
+  generation.store(0);
 }
 
 /// Check if the address is in the current valid range. If it is, return the cached
@@ -568,11 +577,12 @@ ContextCache::ContextCache(ContextDatabase *db)
 void ContextCache::getContext(const Address &addr,uintm *buf) const
 
 {
+  std::lock_guard<std::mutex> guard(cachelock);
   if ((addr.getSpace()!=curspace)||(first>addr.getOffset())||(last<addr.getOffset())) {
     curspace = addr.getSpace();
     context = database->getContext(addr,first,last);
   }
-  for(int4 i=0;i<database->getContextSize();++i) 
+  for(int4 i=0;i<database->getContextSize();++i)
     buf[i] = context[i];
 }
 
@@ -588,7 +598,9 @@ void ContextCache::setContext(const Address &addr,int4 num,uintm mask,uintm valu
 
 {
   if (!allowset) return;
+  std::lock_guard<std::mutex> guard(cachelock);
   database->setContextChangePoint(addr,num,mask,value);
+  generation.fetch_add(1,std::memory_order_release);
   if ((addr.getSpace()==curspace)&&(first<=addr.getOffset())&&(last>=addr.getOffset()))
     curspace = (AddrSpace *)0;	// Invalidate cache
 }
@@ -606,7 +618,9 @@ void ContextCache::setContext(const Address &addr1,const Address &addr2,int4 num
 
 {
   if (!allowset) return;
+  std::lock_guard<std::mutex> guard(cachelock);
   database->setContextRegion(addr1,addr2,num,mask,value);
+  generation.fetch_add(1,std::memory_order_release);
   if ((addr1.getSpace()==curspace)&&(first<=addr1.getOffset())&&(last>=addr1.getOffset()))
     curspace = (AddrSpace *)0;	// Invalidate cache
   if ((first<=addr2.getOffset())&&(last>=addr2.getOffset()))
@@ -615,4 +629,88 @@ void ContextCache::setContext(const Address &addr1,const Address &addr2,int4 num
     curspace = (AddrSpace *)0;	// Invalidate cache
 }
 
+/// The view starts invalid; the first getContext() call populates the private copy.
+/// \param par is the shared cache being viewed
+ContextCacheView::ContextCacheView(ContextCache *par)
+  : ContextCache(par->getDatabase())
+{
+  parent = par;
+  blob.resize(par->getDatabase()->getContextSize(),0);
+  scratch.resize(par->getDatabase()->getContextSize(),0);
+  viewspace = (AddrSpace *)0;	// Mark the private copy as invalid
+  viewfirst = 0;
+  viewlast = 0;
+  snapshot = 0;
+}
+
+/// If the address lies in the copied range and no other view has written to the
+/// database since the copy was made, the blob is returned with no locking.
+/// Otherwise the private copy is refreshed from the database under the parent's lock.
+/// \param addr is the given address
+/// \param buf is where the blob should be stored
+void ContextCacheView::getContext(const Address &addr,uintm *buf) const
+
+{
+  uint4 curgen = parent->generation.load(std::memory_order_acquire);
+  if ((curgen != snapshot)||(addr.getSpace()!=viewspace)||(viewfirst>addr.getOffset())||(viewlast<addr.getOffset())) {
+    std::lock_guard<std::mutex> guard(parent->cachelock);
+    const uintm *fresh = parent->database->getContext(addr,viewfirst,viewlast);
+    for(int4 i=0;i<blob.size();++i)
+      blob[i] = fresh[i];
+    viewspace = addr.getSpace();
+    snapshot = parent->generation.load(std::memory_order_acquire);
+  }
+  for(int4 i=0;i<blob.size();++i)
+    buf[i] = blob[i];
+}
+
+/// \brief Change a context variable at the given address, promoting only real changes
+///
+/// The copied range is bounded by explicit change points, so if the range holds the
+/// address and already contains the requested value, painting to the next change point
+/// is a no-op and the shared database is never touched.
+/// \param addr is the given starting address
+/// \param num is the word index of the context variable
+/// \param mask is the mask delimiting the context variable
+/// \param value is the (already shifted) value to set
+void ContextCacheView::setContext(const Address &addr,int4 num,uintm mask,uintm value)
+
+{
+  if (!parent->allowset) return;
+  getContext(addr,scratch.data());	// Refresh the copy so it covers the address
+  if (((scratch[num] ^ value) & mask) == 0)
+    return;				// Region already holds this value
+  {
+    std::lock_guard<std::mutex> guard(parent->cachelock);
+    parent->database->setContextChangePoint(addr,num,mask,value);
+    parent->generation.fetch_add(1,std::memory_order_release);
+  }
+  viewspace = (AddrSpace *)0;		// Invalidate the private copy
+}
+
+/// \brief Change a context variable across an address range, promoting only real changes
+///
+/// The write is skipped when the copied range covers the whole target range and
+/// already contains the requested value.
+/// \param addr1 is the starting address of the given range
+/// \param addr2 is the ending address of the given range
+/// \param num is the word index of the context variable
+/// \param mask is the mask delimiting the context variable
+/// \param value is the (already shifted) value to set
+void ContextCacheView::setContext(const Address &addr1,const Address &addr2,int4 num,uintm mask,uintm value)
+
+{
+  if (!parent->allowset) return;
+  getContext(addr1,scratch.data());	// Refresh the copy so it covers the start address
+  if ((addr2.getSpace()==viewspace)&&(addr2.getOffset()<=viewlast)&&
+      (((scratch[num] ^ value) & mask) == 0))
+    return;				// Whole range lies in the copy and holds this value
+  {
+    std::lock_guard<std::mutex> guard(parent->cachelock);
+    parent->database->setContextRegion(addr1,addr2,num,mask,value);
+    parent->generation.fetch_add(1,std::memory_order_release);
+  }
+  viewspace = (AddrSpace *)0;		// Invalidate the private copy
+}
+
 } // End namespace ghidra
@@ -22,6 +22,9 @@
 #include "pcoderaw.hh"
 #include "partmap.hh"
 
+#include <atomic>
+#include <mutex>
+
 namespace ghidra {
 
 extern ElementId ELEM_CONTEXT_DATA;	///< Marshaling element \<context_data>
@@ -314,20 +317,51 @@ public:
 /// This merely caches the last retrieved context blob ("array of words") and the range of
 /// addresses over which the blob is valid.  It encapsulates the ContextDatabase itself and
 /// exposes a minimal interface (getContext() and setContext()).
+///
+/// One ContextCache serializes all access to its database through an internal lock, and
+/// multiple ContextCacheView objects can wrap it to give concurrent decode threads
+/// lock-free read access to the context (see ContextCacheView).
 class ContextCache {
+  friend class ContextCacheView;
   ContextDatabase *database;		///< The encapsulated context database
   bool allowset;			///< If set to \b false, and setContext() call is dropped
+  mutable std::mutex cachelock;		///< Lock serializing database access among views
+  std::atomic<uint4> generation;	///< Incremented on every write that reaches the database
   mutable AddrSpace *curspace;		///< Address space of the current valid range
   mutable uintb first;			///< Starting offset of the current valid range
   mutable uintb last;			///< Ending offset of the current valid range
   mutable const uintm *context;		///< The current cached context blob
 public:
   ContextCache(ContextDatabase *db);	///< Construct given a context database
+  virtual ~ContextCache(void) {}	///< Destructor
   ContextDatabase *getDatabase(void) const { return database; }		///< Retrieve the encapsulated database object
   void allowSet(bool val) { allowset = val; }		///< Toggle whether setContext() calls are ignored
-  void getContext(const Address &addr,uintm *buf) const;	///< Retrieve the context blob for the given address
-  void setContext(const Address &addr,int4 num,uintm mask,uintm value);
-  void setContext(const Address &addr1,const Address &addr2,int4 num,uintm mask,uintm value);
+  virtual void getContext(const Address &addr,uintm *buf) const;	///< Retrieve the context blob for the given address
+  virtual void setContext(const Address &addr,int4 num,uintm mask,uintm value);
+  virtual void setContext(const Address &addr1,const Address &addr2,int4 num,uintm mask,uintm value);
+};
+
+/// \brief A copy-on-write view of a shared ContextCache, for concurrent decode threads
+///
+/// Each decode worker owns one view.  Reads are serviced from a private copy of the
+/// current context blob without touching the shared database; the copy is refreshed,
+/// under the parent's lock, only when an address falls outside the copied range or
+/// another view has promoted a write (detected via the parent's generation counter).
+/// Writes are promoted to the shared database only when they would actually change a
+/// context value, which is rare during normal decode, so threads almost never contend.
+class ContextCacheView : public ContextCache {
+  ContextCache *parent;			///< The shared cache this is a view of
+  mutable vector<uintm> blob;		///< Private copy of the current context blob
+  vector<uintm> scratch;		///< Scratch blob for testing writes against current values
+  mutable AddrSpace *viewspace;		///< Address space of the copied range (null if invalid)
+  mutable uintb viewfirst;		///< Starting offset of the copied range
+  mutable uintb viewlast;		///< Ending offset of the copied range
+  mutable uint4 snapshot;		///< Parent's generation when the copy was made
+public:
+  ContextCacheView(ContextCache *par);	///< Construct a view of the given shared cache
+  virtual void getContext(const Address &addr,uintm *buf) const;
+  virtual void setContext(const Address &addr,int4 num,uintm mask,uintm value);
+  virtual void setContext(const Address &addr1,const Address &addr2,int4 num,uintm mask,uintm value);
 };
 
 } // End namespace ghidra
@@ -91,9 +91,15 @@
 /* First part of user prologue.  */
 
 #include "grammar.hh"
+#include "crc32.hh"
 
 namespace ghidra {
 
+ElementId ELEM_PROTOLIB = ElementId("protolib",289);
+ElementId ELEM_PROTOENTRY = ElementId("protoentry",290);
+ElementId ELEM_PROTOINPUT = ElementId("protoinput",291);
+AttributeId ATTRIB_CHECKSUM = AttributeId("checksum",152);
+
 extern int grammarlex(void);
 extern int grammarerror(const char *str);
 static CParse *parse;
@@ -3194,6 +3200,133 @@ void parse_C(Architecture *glb,istream &s)
     throw LowlevelError("Not sure what to do with this type");
 }
 
+static void encodeProtoPieces(Encoder &encoder,const PrototypePieces &pieces)
+
+{ // Marshal one parsed prototype: name, model, varargs slot, return type,
+  // then one <protoinput> per parameter
+  encoder.openElement(ELEM_PROTOENTRY);
+  encoder.writeString(ATTRIB_NAME,pieces.name);
+  if (pieces.model != (ProtoModel *)0)
+    encoder.writeString(ATTRIB_MODEL,pieces.model->getName());
+  encoder.writeSignedInteger(ATTRIB_INDEX,pieces.firstVarArgSlot);
+  pieces.outtype->encode(encoder);
+  for(int4 i=0;i<pieces.intypes.size();++i) {
+    encoder.openElement(ELEM_PROTOINPUT);
+    if (i < pieces.innames.size())
+      encoder.writeString(ATTRIB_NAME,pieces.innames[i]);
+    pieces.intypes[i]->encode(encoder);
+    encoder.closeElement(ELEM_PROTOINPUT);
+  }
+  encoder.closeElement(ELEM_PROTOENTRY);
+}
+
+static void decodeProtoPieces(Decoder &decoder,PrototypePieces &pieces,Architecture *glb)
+
+{ // Recover one prototype, resolving data-types through the Architecture's
+  // TypeFactory and the model by name
+  uint4 elemId = decoder.openElement(ELEM_PROTOENTRY);
+  pieces.model = (ProtoModel *)0;
+  pieces.firstVarArgSlot = -1;
+  for(;;) {
+    uint4 attribId = decoder.getNextAttributeId();
+    if (attribId == 0) break;
+    if (attribId == ATTRIB_NAME)
+      pieces.name = decoder.readString();
+    else if (attribId == ATTRIB_MODEL)
+      pieces.model = glb->getModel(decoder.readString());
+    else if (attribId == ATTRIB_INDEX)
+      pieces.firstVarArgSlot = decoder.readSignedInteger();
+  }
+  pieces.outtype = glb->types->decodeType(decoder);
+  while(decoder.peekElement() == ELEM_PROTOINPUT) {
+    uint4 subId = decoder.openElement();
+    string nm;
+    uint4 attribId = decoder.getNextAttributeId();
+    if (attribId == ATTRIB_NAME)
+      nm = decoder.readString();
+    pieces.innames.push_back(nm);
+    pieces.intypes.push_back(glb->types->decodeType(decoder));
+    decoder.closeElement(subId);
+  }
+  decoder.closeElement(elemId);
+}
+
+void parse_protolib(Architecture *glb,const string &filename,vector<PrototypePieces> &protolist)
+
+{ // Batch-parse a file of C declarations, one prototype per line, through an
+  // on-disk cache.  The first run pays the full grammar parse and writes the
+  // parsed prototypes in packed form to <filename>.protocache, keyed by a
+  // checksum of the source; later runs (other sessions, restarts) bulk-load
+  // the packed records, skipping the parser entirely.  A stale or unreadable
+  // cache silently falls back to reparsing.
+  ifstream fs(filename.c_str(),ios::binary);
+  if (!fs)
+    throw ParseError("Unable to open prototype file: "+filename);
+  ostringstream cbuf;
+  cbuf << fs.rdbuf();
+  fs.close();
+  string content = cbuf.str();
+  uint4 crc = 0xffffffff;
+  crc = crc_update_bytes(crc,(const uint1 *)content.data(),(int4)content.size());
+  crc ^= 0xffffffff;
+  string cachename = filename + ".protocache";
+
+  ifstream cs(cachename.c_str(),ios::binary);
+  if (cs) {
+    try {
+      PackedDecode decoder(glb);
+      decoder.ingestStream(cs);
+      uint4 elemId = decoder.openElement(ELEM_PROTOLIB);
+      if ((uint4)decoder.readUnsignedInteger(ATTRIB_CHECKSUM) == crc) {
+	while(decoder.peekElement() == ELEM_PROTOENTRY) {
+	  protolist.emplace_back();
+	  decodeProtoPieces(decoder,protolist.back(),glb);
+	}
+	decoder.closeElement(elemId);
+	return;
+      }
+    }
+    catch(DecoderError &err) {
+      // Treat like a checksum mismatch and reparse
+    }
+    catch(LowlevelError &err) {
+    }
+    protolist.clear();
+  }
+
+  istringstream decls(content);
+  string line;
+  int4 lineno = 0;
+  while(getline(decls,line)) {
+    lineno += 1;
+    string::size_type pos = line.find_first_not_of(" \t\r");
+    if (pos == string::npos) continue;		// Blank line
+    if (line.compare(pos,2,"//") == 0) continue;	// Comment
+    if (line[pos] == '#') continue;		// Stray preprocessor line
+    PrototypePieces pieces;
+    istringstream ls(line);
+    try {
+      parse_protopieces(pieces,ls,glb);
+    }
+    catch(ParseError &err) {
+      ostringstream msg;
+      msg << filename << " line " << dec << lineno << ": " << err.explain;
+      throw ParseError(msg.str());
+    }
+    protolist.push_back(pieces);
+  }
+
+  ofstream os(cachename.c_str(),ios::binary);	// Write-back is best effort
+  if (os) {
+    PackedEncode encoder(os);
+    encoder.openElement(ELEM_PROTOLIB);
+    encoder.writeUnsignedInteger(ATTRIB_CHECKSUM,crc);
+    for(int4 i=0;i<protolist.size();++i)
+      encodeProtoPieces(encoder,protolist[i]);
+    encoder.closeElement(ELEM_PROTOLIB);
+  }
+}
+
 void parse_toseparator(istream &s,string &name)
 
 {				// parse to next (C) separator
@@ -279,9 +279,15 @@ public:
   vector<TypeDeclarator *> *getResultDeclarations(void) { return lastdecls; }
 };
 
+extern ElementId ELEM_PROTOLIB;		///< Marshaling element \<protolib>
+extern ElementId ELEM_PROTOENTRY;	///< Marshaling element \<protoentry>
+extern ElementId ELEM_PROTOINPUT;	///< Marshaling element \<protoinput>
+extern AttributeId ATTRIB_CHECKSUM;	///< Marshaling attribute "checksum"
+
 extern Datatype *parse_type(istream &s,string &name,Architecture *glb);
 extern void parse_protopieces(PrototypePieces &pieces,istream &s,Architecture *glb);
 extern void parse_C(Architecture *glb,istream &s);
+extern void parse_protolib(Architecture *glb,const string &filename,vector<PrototypePieces> &protolist);
 
 // Routines to parse interface commands
 
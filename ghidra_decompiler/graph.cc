@@ -18,6 +18,303 @@
 
 namespace ghidra {
 
+/// The given graph becomes the subject of the next layout() call.  One Node is
+/// created per basic block with a nominal default size, which the caller can
+/// adjust through getNode() before computing the layout.
+/// \param graph is the control-flow graph to lay out
+void GraphLayout::reset(const BlockGraph &graph)
+
+{
+  int4 n = graph.getSize();
+  nodes.clear();
+  nodes.resize(n);
+  for(int4 i=0;i<n;++i) {
+    nodes[i].width = 120;
+    nodes[i].height = 40;
+    nodes[i].x = 0;
+    nodes[i].y = 0;
+  }
+  edges.clear();
+  for(int4 i=0;i<n;++i) {
+    FlowBlock *bl = graph.getBlock(i);
+    for(int4 j=0;j<bl->sizeOut();++j) {
+      edges.emplace_back();
+      edges.back().from = i;
+      edges.back().to = bl->getOut(j)->getIndex();
+    }
+  }
+}
+
+/// Run a depth-first search over the blocks, marking any edge whose target is
+/// still on the active search path.  Removing the marked edges leaves a DAG.
+/// \param isback is the array, indexed by edge, to mark
+void GraphLayout::markBackEdges(vector<bool> &isback) const
+
+{
+  int4 n = nodes.size();
+  vector<vector<int4> > out(n);		// Edge indices leaving each block
+  for(int4 i=0;i<(int4)edges.size();++i)
+    out[edges[i].from].push_back(i);
+  vector<int4> color(n,0);		// 0 = unvisited, 1 = on path, 2 = finished
+  vector<pair<int4,int4> > stack;	// (block, position in its out list)
+  for(int4 root=0;root<n;++root) {
+    if (color[root] != 0) continue;
+    color[root] = 1;
+    stack.push_back(pair<int4,int4>(root,0));
+    while(!stack.empty()) {
+      int4 bl = stack.back().first;
+      int4 &pos( stack.back().second );
+      if (pos >= (int4)out[bl].size()) {
+	color[bl] = 2;
+	stack.pop_back();
+	continue;
+      }
+      int4 edgeIdx = out[bl][pos];
+      pos += 1;
+      int4 target = edges[edgeIdx].to;
+      if (color[target] == 1)
+	isback[edgeIdx] = true;		// Target still on the path: edge closes a cycle
+      else if (color[target] == 0) {
+	color[target] = 1;
+	stack.push_back(pair<int4,int4>(target,0));
+      }
+    }
+  }
+}
+
+/// Assign each block the longest path length reaching it over non-back edges,
+/// so every such edge points strictly downward.
+/// \param isback marks the edges excluded from layering
+/// \param rank will hold the layer assigned to each block
+void GraphLayout::assignRanks(const vector<bool> &isback,vector<int4> &rank) const
+
+{
+  int4 n = nodes.size();
+  rank.assign(n,0);
+  vector<int4> indeg(n,0);
+  for(int4 i=0;i<(int4)edges.size();++i) {
+    if (isback[i] || edges[i].from == edges[i].to) continue;
+    indeg[edges[i].to] += 1;
+  }
+  vector<int4> ready;
+  for(int4 i=0;i<n;++i) {
+    if (indeg[i] == 0)
+      ready.push_back(i);
+  }
+  while(!ready.empty()) {
+    int4 bl = ready.back();
+    ready.pop_back();
+    for(int4 i=0;i<(int4)edges.size();++i) {
+      if (isback[i] || edges[i].from != bl || edges[i].to == bl) continue;
+      int4 target = edges[i].to;
+      if (rank[bl] + 1 > rank[target])
+	rank[target] = rank[bl] + 1;
+      if (--indeg[target] == 0)
+	ready.push_back(target);
+    }
+  }
+}
+
+/// Create one vertex per block, then thread every non-back edge spanning more
+/// than one rank through a chain of dummy vertices, one per intermediate rank,
+/// recording the chain for later routing.  Layers are populated in creation
+/// order, which becomes the initial crossing-reduction order.
+/// \param isback marks the edges excluded from layering
+/// \param rank is the layer assigned to each block
+void GraphLayout::buildLayers(const vector<bool> &isback,const vector<int4> &rank)
+
+{
+  int4 n = nodes.size();
+  int4 maxrank = 0;
+  for(int4 i=0;i<n;++i) {
+    if (rank[i] > maxrank) maxrank = rank[i];
+  }
+  verts.clear();
+  verts.resize(n);
+  layers.clear();
+  layers.resize(maxrank+1);
+  for(int4 i=0;i<n;++i) {
+    verts[i].block = i;
+    verts[i].rank = rank[i];
+    verts[i].width = nodes[i].width;
+    verts[i].order = (int4)layers[rank[i]].size();
+    layers[rank[i]].push_back(i);
+  }
+  edgepath.clear();
+  edgepath.resize(edges.size());
+  for(int4 i=0;i<(int4)edges.size();++i) {
+    if (isback[i] || edges[i].from == edges[i].to) continue;
+    int4 from = edges[i].from;
+    int4 to = edges[i].to;
+    if (rank[to] <= rank[from]) continue;	// Flat edge, routed directly
+    vector<int4> &path( edgepath[i] );
+    path.push_back(from);
+    int4 prev = from;
+    for(int4 r=rank[from]+1;r<rank[to];++r) {	// A dummy on each intermediate rank
+      verts.emplace_back();
+      Vertex &dummy( verts.back() );
+      int4 dummyIdx = (int4)verts.size() - 1;
+      dummy.block = -1;
+      dummy.rank = r;
+      dummy.width = dummy_width;
+      dummy.order = (int4)layers[r].size();
+      layers[r].push_back(dummyIdx);
+      verts[prev].succs.push_back(dummyIdx);
+      dummy.preds.push_back(prev);
+      path.push_back(dummyIdx);
+      prev = dummyIdx;
+    }
+    verts[prev].succs.push_back(to);
+    verts[to].preds.push_back(prev);
+    path.push_back(to);
+  }
+}
+
+/// Sweep the layers top-down and bottom-up a fixed number of times, sorting
+/// each layer by the average order of its neighbors on the previous layer.
+void GraphLayout::orderLayers(void)
+
+{
+  vector<pair<double,int4> > keyed;
+  for(int4 pass=0;pass<4;++pass) {
+    bool down = ((pass & 1) == 0);
+    int4 numlayer = (int4)layers.size();
+    for(int4 li=0;li<numlayer;++li) {
+      vector<int4> &layer( layers[down ? li : (numlayer-1-li)] );
+      keyed.clear();
+      for(int4 i=0;i<(int4)layer.size();++i) {
+	Vertex &vert( verts[layer[i]] );
+	const vector<int4> &nb( down ? vert.preds : vert.succs );
+	double key;
+	if (nb.empty())
+	  key = (double)vert.order;	// No neighbors: hold position
+	else {
+	  key = 0.0;
+	  for(int4 j=0;j<(int4)nb.size();++j)
+	    key += (double)verts[nb[j]].order;
+	  key /= (double)nb.size();
+	}
+	keyed.push_back(pair<double,int4>(key,layer[i]));
+      }
+      stable_sort(keyed.begin(),keyed.end());
+      for(int4 i=0;i<(int4)layer.size();++i) {
+	layer[i] = keyed[i].second;
+	verts[layer[i]].order = i;
+      }
+    }
+  }
+}
+
+/// Pack each layer left to right, then pull vertices toward the average center
+/// of their neighbors while preserving the computed order and minimum gaps.
+/// Layer heights and vertical positions are passed back for edge routing.
+/// \param layerY will hold the top coordinate of each rank
+/// \param layerH will hold the height of each rank
+void GraphLayout::assignCoords(vector<int4> &layerY,vector<int4> &layerH)
+
+{
+  int4 numlayer = (int4)layers.size();
+  for(int4 li=0;li<numlayer;++li) {	// Initial left-to-right packing
+    double x = 0.0;
+    vector<int4> &layer( layers[li] );
+    for(int4 i=0;i<(int4)layer.size();++i) {
+      Vertex &vert( verts[layer[i]] );
+      vert.center = x + (double)vert.width / 2.0;
+      x += (double)(vert.width + node_gap);
+    }
+  }
+  for(int4 pass=0;pass<2;++pass) {	// Pull toward neighbors, keeping order and gaps
+    bool down = ((pass & 1) == 0);
+    for(int4 li=0;li<numlayer;++li) {
+      vector<int4> &layer( layers[down ? li : (numlayer-1-li)] );
+      double minCenter = 0.0;
+      for(int4 i=0;i<(int4)layer.size();++i) {
+	Vertex &vert( verts[layer[i]] );
+	const vector<int4> &nb( down ? vert.preds : vert.succs );
+	double desired = vert.center;
+	if (!nb.empty()) {
+	  desired = 0.0;
+	  for(int4 j=0;j<(int4)nb.size();++j)
+	    desired += verts[nb[j]].center;
+	  desired /= (double)nb.size();
+	}
+	if (i != 0 && desired < minCenter)
+	  desired = minCenter;
+	vert.center = desired;
+	minCenter = desired + (double)vert.width / 2.0 + (double)node_gap;
+	if (i + 1 < (int4)layer.size())
+	  minCenter += (double)verts[layer[i+1]].width / 2.0;
+      }
+    }
+  }
+  layerY.assign(numlayer,0);
+  layerH.assign(numlayer,0);
+  int4 y = 0;
+  for(int4 li=0;li<numlayer;++li) {
+    int4 h = 0;
+    vector<int4> &layer( layers[li] );
+    for(int4 i=0;i<(int4)layer.size();++i) {
+      int4 block = verts[layer[i]].block;
+      if (block >= 0 && nodes[block].height > h)
+	h = nodes[block].height;
+    }
+    layerY[li] = y;
+    layerH[li] = h;
+    y += h + rank_gap;
+  }
+  for(int4 i=0;i<(int4)verts.size();++i) {
+    if (verts[i].block < 0) continue;
+    Node &node( nodes[verts[i].block] );
+    node.x = (int4)(verts[i].center - (double)node.width / 2.0);
+    node.y = layerY[verts[i].rank];
+  }
+}
+
+/// Forward edges leave the bottom center of their source, bend at each dummy
+/// vertex on the intermediate ranks, and enter the top center of their target.
+/// Flat, back, and self edges get their two endpoints only, leaving the
+/// detour shape to the renderer.
+/// \param layerY is the top coordinate of each rank
+/// \param layerH is the height of each rank
+void GraphLayout::routeEdges(const vector<int4> &layerY,const vector<int4> &layerH)
+
+{
+  for(int4 i=0;i<(int4)edges.size();++i) {
+    Edge &edge( edges[i] );
+    edge.xs.clear();
+    edge.ys.clear();
+    const Node &src( nodes[edge.from] );
+    const Node &dst( nodes[edge.to] );
+    edge.xs.push_back(src.x + src.width/2);
+    edge.ys.push_back(src.y + src.height);
+    const vector<int4> &path( edgepath[i] );
+    for(int4 j=1;j+1<(int4)path.size();++j) {	// Interior chain entries are dummies
+      const Vertex &dummy( verts[path[j]] );
+      edge.xs.push_back((int4)dummy.center);
+      edge.ys.push_back(layerY[dummy.rank] + layerH[dummy.rank]/2);
+    }
+    edge.xs.push_back(dst.x + dst.width/2);
+    edge.ys.push_back(dst.y);
+  }
+}
+
+/// Compute coordinates for every block and a polyline route for every edge,
+/// based on the graph captured by reset() and the block sizes currently set.
+void GraphLayout::layout(void)
+
+{
+  if (nodes.empty()) return;
+  vector<bool> isback(edges.size(),false);
+  markBackEdges(isback);
+  vector<int4> rank;
+  assignRanks(isback,rank);
+  buildLayers(isback,rank);
+  orderLayers();
+  vector<int4> layerY,layerH;
+  assignCoords(layerY,layerH);
+  routeEdges(layerY,layerH);
+}
+
 static void print_varnode_vertex(Varnode *vn,ostream &s)
 
 {
@@ -20,6 +20,67 @@
 
 namespace ghidra {
 
+/// \brief Layered drawing of a control-flow graph, in the style of Sugiyama
+///
+/// Basic blocks are assigned to horizontal ranks so loop-free control flow
+/// points downward, ordered within their rank by repeated barycenter sweeps to
+/// reduce edge crossings, and finally given concrete coordinates.  Edges that
+/// span several ranks are threaded through dummy vertices on the intermediate
+/// ranks, producing a polyline route for each; back edges are reported with
+/// their endpoints only.  The caller supplies the size of each block and reads
+/// back positions and routes in the same (abstract) units.
+class GraphLayout {
+public:
+  /// \brief Placement of a single basic block
+  struct Node {
+    int4 width;			///< Width of the block (supplied by the caller)
+    int4 height;		///< Height of the block (supplied by the caller)
+    int4 x;			///< Computed left edge
+    int4 y;			///< Computed top edge
+  };
+
+  /// \brief Route of a single control-flow edge
+  struct Edge {
+    int4 from;			///< Index of the source block
+    int4 to;			///< Index of the target block
+    vector<int4> xs;		///< X coordinates of the polyline, source to target
+    vector<int4> ys;		///< Y coordinates of the polyline
+  };
+private:
+  /// \brief A vertex of the layered graph: a basic block or a dummy bend point
+  struct Vertex {
+    int4 block;			///< Index of the underlying block, or -1 for a dummy
+    int4 rank;			///< Layer assigned to the vertex
+    int4 order;			///< Position within the layer
+    int4 width;			///< Width reserved on the layer
+    double center;		///< X coordinate of the vertex center
+    vector<int4> preds;		///< Layered in-edges (vertex indices)
+    vector<int4> succs;		///< Layered out-edges (vertex indices)
+  };
+  vector<Node> nodes;		///< Block placements, indexed by block
+  vector<Edge> edges;		///< Every control-flow edge
+  vector<Vertex> verts;		///< Vertices of the layered graph
+  vector<vector<int4> > layers;	///< Vertex indices making up each rank
+  vector<vector<int4> > edgepath;	///< Vertex chain (source..target) for each layered edge
+  static const int4 rank_gap = 40;	///< Vertical space between ranks
+  static const int4 node_gap = 30;	///< Horizontal space between blocks on a rank
+  static const int4 dummy_width = 10;	///< Width reserved by a dummy vertex
+  void markBackEdges(vector<bool> &isback) const;	///< Find edges closing a cycle
+  void assignRanks(const vector<bool> &isback,vector<int4> &rank) const;	///< Longest-path layering
+  void buildLayers(const vector<bool> &isback,const vector<int4> &rank);	///< Create vertices, dummies, and layers
+  void orderLayers(void);	///< Reduce crossings with barycenter sweeps
+  void assignCoords(vector<int4> &layerY,vector<int4> &layerH);	///< Turn ranks and orders into coordinates
+  void routeEdges(const vector<int4> &layerY,const vector<int4> &layerH);	///< Build the edge polylines
+public:
+  void reset(const BlockGraph &graph);	///< Initialize over the given graph with default block sizes
+  int4 numNodes(void) const { return nodes.size(); }	///< Get the number of blocks
+  Node &getNode(int4 i) { return nodes[i]; }	///< Get the (mutable) placement of a block
+  const Node &getNode(int4 i) const { return nodes[i]; }	///< Get the placement of a block
+  int4 numEdges(void) const { return edges.size(); }	///< Get the number of edges
+  const Edge &getEdge(int4 i) const { return edges[i]; }	///< Get the route of an edge
+  void layout(void);		///< Compute positions and routes
+};
+
 extern void dump_dataflow_graph(Funcdata &data,ostream &s);
 extern void dump_controlflow_graph(const string &name,const BlockGraph &graph,ostream &s);
 extern void dump_dom_graph(const string &name,const BlockGraph &graph,ostream &s);
@@ -19,6 +19,44 @@
 
 namespace ghidra {
 
+/// Equivalent to an upper bound on the range starting addresses: the index of the first
+/// range starting strictly after the given address.  Successive queries during a heritage
+/// pass land close together in address order, so rather than a full binary search, gallop
+/// outward from the previously returned index in doubling steps to bracket the answer,
+/// then binary search within the bracket.
+/// \param addr is the given address
+/// \return the index of the first range past the address
+size_t LocationMap::gallop(const Address &addr) const
+
+{
+  size_t n = themap.size();
+  if (n == 0) return 0;
+  size_t pos = (hint < n) ? hint : n - 1;
+  size_t lo,hi;
+  size_t bound = 1;
+  if (!(addr < themap[pos].first)) {	// Boundary lies beyond pos
+    while(pos + bound < n && !(addr < themap[pos + bound].first))
+      bound <<= 1;
+    lo = pos + (bound >> 1) + 1;
+    hi = (pos + bound < n) ? pos + bound : n;
+  }
+  else {				// Boundary lies at or before pos
+    while(bound <= pos && addr < themap[pos - bound].first)
+      bound <<= 1;
+    hi = pos - (bound >> 1);
+    lo = (bound <= pos) ? pos - bound + 1 : 0;
+  }
+  while(lo < hi) {			// Conventional binary search on the bracket
+    size_t mid = (lo + hi) >> 1;
+    if (addr < themap[mid].first)
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+  hint = lo;
+  return lo;
+}
+
 /// Update disjoint cover making sure (addr,size) is contained in a single element and return
 /// an iterator to this element. The element's \b pass number is set to be the smallest value
 /// of any previous intersecting element. Additionally an \b intersect code is passed back:
@@ -33,11 +71,19 @@ namespace ghidra {
 LocationMap::iterator LocationMap::add(Address addr,int4 size,int4 pass,int4 &intersect)
 
 {
-  iterator iter = themap.lower_bound(addr);
-  if (iter != themap.begin())
-    --iter;
-  if ((iter!=themap.end())&&(-1 == addr.overlap(0,(*iter).first,(*iter).second.size)))
-    ++iter;
+  if (themap.empty() || (themap.back().first < addr &&
+			 -1 == addr.overlap(0,themap.back().first,themap.back().second.size))) {
+    intersect = 0;	// Append path: ranges in a pass mostly arrive in address order
+    themap.emplace_back(addr,SizePass());
+    themap.back().second.size = size;
+    themap.back().second.pass = pass;
+    hint = themap.size() - 1;
+    return themap.begin() + (themap.size() - 1);
+  }
+  size_t pos = gallop(addr);
+  if (pos != 0 && -1 != addr.overlap(0,themap[pos-1].first,themap[pos-1].second.size))
+    pos -= 1;			// Start with the overlapping predecessor
+  iterator iter = themap.begin() + pos;
 
   int4 where=0;
   intersect = 0;
@@ -52,7 +98,7 @@ LocationMap::iterator LocationMap::add(Address addr,int4 size,int4 pass,int4 &in
       intersect = 1;			// Partial overlap with old element
       pass = (*iter).second.pass;
     }
-    themap.erase(iter++);
+    iter = themap.erase(iter);
   }
   while((iter!=themap.end())&&(-1!=(where=(*iter).first.overlap(0,addr,size)))) {
     if (where+(*iter).second.size>size)
@@ -61,11 +107,12 @@ LocationMap::iterator LocationMap::add(Address addr,int4 size,int4 pass,int4 &in
       intersect = 1;
       pass = (*iter).second.pass;
     }
-    themap.erase(iter++);
+    iter = themap.erase(iter);
   }
-  iter = themap.insert(pair<Address,SizePass>( addr, SizePass() )).first;
+  iter = themap.insert(iter, Entry( addr, SizePass() ));
   (*iter).second.size = size;
   (*iter).second.pass = pass;
+  hint = iter - themap.begin();
   return iter;
 }
 
@@ -76,9 +123,9 @@ LocationMap::iterator LocationMap::add(Address addr,int4 size,int4 pass,int4 &in
 LocationMap::iterator LocationMap::find(const Address &addr)
 
 {
-  iterator iter = themap.upper_bound(addr); // First range after address
-  if (iter == themap.begin()) return themap.end();
-  --iter;			// First range before or equal to address
+  size_t pos = gallop(addr);	// First range after address
+  if (pos == 0) return themap.end();
+  iterator iter = themap.begin() + (pos - 1);	// First range before or equal to address
   if (-1!=addr.overlap(0,(*iter).first,(*iter).second.size))
     return iter;
   return themap.end();
@@ -90,11 +137,11 @@ LocationMap::iterator LocationMap::find(const Address &addr)
 int4 LocationMap::findPass(const Address &addr) const
 
 {
-  map<Address,SizePass>::const_iterator iter = themap.upper_bound(addr); // First range after address
-  if (iter == themap.begin()) return -1;
-  --iter;			// First range before or equal to address
-  if (-1!=addr.overlap(0,(*iter).first,(*iter).second.size))
-    return (*iter).second.pass;
+  size_t pos = gallop(addr);	// First range after address
+  if (pos == 0) return -1;
+  const Entry &entry( themap[pos-1] );	// First range before or equal to address
+  if (-1!=addr.overlap(0,entry.first,entry.second.size))
+    return entry.second.pass;
   return -1;
 }
 
@@ -135,10 +182,91 @@ TaskList::iterator TaskList::insert(iterator pos,Address addr,int4 size,uint4 fl
   return tasklist.emplace(pos,addr,size,fl);
 }
 
+/// Walk the Varnodes within the given set of disjoint ranges and register the
+/// address of each one, assigning dense stack ids.  Any previous stack state
+/// is cleared.
+/// \param fd is the function being renamed
+/// \param disjoint is the set of address ranges being heritaged this pass
+void VariableStack::init(Funcdata *fd,TaskList &disjoint)
+
+{
+  addrList.clear();
+  backing.clear();
+  TaskList::iterator iter;
+  VarnodeLocSet::const_iterator viter,venditer;
+  for(iter=disjoint.begin();iter!=disjoint.end();++iter) {
+    const MemRange &memrange(*iter);
+    uintb start = memrange.addr.getOffset();
+    Address endaddr = memrange.addr + memrange.size;
+    if (endaddr.getOffset() < start) {	// Wraparound
+      Address tmp(endaddr.getSpace(),endaddr.getSpace()->getHighest());
+      venditer = fd->endLoc(tmp);
+    }
+    else
+      venditer = fd->beginLoc(endaddr);
+    for(viter=fd->beginLoc(memrange.addr);viter!=venditer;++viter) {
+      const Address &addr((*viter)->getAddr());
+      if (addrList.empty() || addrList.back() != addr)	// The location set is sorted by address
+	addrList.push_back(addr);
+    }
+  }
+  sort(addrList.begin(),addrList.end());	// Ranges may not arrive in address order
+  addrList.erase(unique(addrList.begin(),addrList.end()),addrList.end());
+  top.assign(addrList.size(),-1);
+}
+
+/// The sorted address list is probed by binary search.  An address that was never
+/// registered is inserted in sorted position with an empty stack.
+/// \param addr is the given address
+/// \return the id of the stack associated with the address
+int4 VariableStack::getStack(const Address &addr)
+
+{
+  int4 pos = lower_bound(addrList.begin(),addrList.end(),addr) - addrList.begin();
+  if (pos == addrList.size() || addrList[pos] != addr) {
+    addrList.insert(addrList.begin()+pos,addr);
+    top.insert(top.begin()+pos,-1);
+  }
+  return pos;
+}
+
+/// \param id is the stack being pushed to
+/// \param vn is the Varnode to push
+void VariableStack::push(int4 id,Varnode *vn)
+
+{
+  StackNode node;
+  node.vn = vn;
+  node.prev = top[id];
+  backing.push_back(node);
+  top[id] = backing.size()-1;
+}
+
+/// The stack must have exactly one entry.  The new Varnode goes underneath it.
+/// \param id is the stack being inserted into
+/// \param vn is the Varnode to insert
+void VariableStack::insertBottom(int4 id,Varnode *vn)
+
+{
+  StackNode node;
+  node.vn = vn;
+  node.prev = -1;
+  backing.push_back(node);
+  backing[top[id]].prev = backing.size()-1;
+}
+
+/// \param addr is the address of the stack to pop
+void VariableStack::pop(const Address &addr)
+
+{
+  int4 id = getStack(addr);
+  top[id] = backing[top[id]].prev;
+}
+
 /// Any basic blocks currently in \b this queue are removed. Space is
 /// reserved for a new set of prioritized stacks.
 /// \param maxdepth is the number of stacks to allocate
-void PriorityQueue::reset(int4 maxdepth) 
+void PriorityQueue::reset(int4 maxdepth)
 
 {
   if ((curdepth==-1)&&(maxdepth==queue.size()-1)) return; // Already reset
@@ -867,10 +995,12 @@ void Heritage::analyzeNewLoadGuards(void)
   Varnode *stackReg = (Varnode *)0;
   if (stackSpc != (AddrSpace *)0 && stackSpc->numSpacebase() > 0)
     stackReg = fd->findSpacebaseInput(stackSpc);
+  Architecture *glb = fd->getArch();
   ValueSetSolver vsSolver;
   vsSolver.establishValueSets(sinks, reads, stackReg, false);
   WidenerNone widener;
-  vsSolver.solve(10000,widener);
+  vsSolver.solve(glb->valueset_maxiter,widener);
+  glb->valueset_iterations += vsSolver.getNumIterations();
   list<LoadGuard>::iterator iter;
   bool runFullAnalysis = false;
   for(iter=loadIter;iter!=loadGuard.end(); ++iter) {
@@ -886,15 +1016,37 @@ void Heritage::analyzeNewLoadGuards(void)
       runFullAnalysis = true;
   }
   if (runFullAnalysis) {
-    WidenerFull fullWidener;
-    vsSolver.solve(10000, fullWidener);
+    // Only the guards that failed to stabilize need the expensive widening
+    // pass. Rebuild the system restricted to their sinks, so data-flow feeding
+    // only the already resolved guards isn't dragged through the solver again.
+    vector<Varnode *> fullSinks;
+    vector<PcodeOp *> fullReads;
+    for(iter=loadIter;iter!=loadGuard.end();++iter) {
+      LoadGuard &guard( *iter );
+      if (guard.analysisState != 0) continue;
+      fullReads.push_back(guard.op);
+      fullSinks.push_back(guard.op->getIn(1));
+    }
+    for(iter=storeIter;iter!=storeGuard.end();++iter) {
+      LoadGuard &guard( *iter );
+      if (guard.analysisState != 0) continue;
+      fullReads.push_back(guard.op);
+      fullSinks.push_back(guard.op->getIn(1));
+    }
+    ValueSetSolver fullSolver;
+    fullSolver.establishValueSets(fullSinks, fullReads, stackReg, false);
+    WidenerFull fullWidener(glb->valueset_wideniter,glb->valueset_fulliter);
+    fullSolver.solve(glb->valueset_maxiter, fullWidener);
+    glb->valueset_iterations += fullSolver.getNumIterations();
     for (iter = loadIter; iter != loadGuard.end(); ++iter) {
       LoadGuard &guard(*iter);
-      guard.finalizeRange(vsSolver.getValueSetRead(guard.op->getSeqNum()));
+      if (guard.analysisState != 0) continue;
+      guard.finalizeRange(fullSolver.getValueSetRead(guard.op->getSeqNum()));
     }
     for (iter = storeIter; iter != storeGuard.end(); ++iter) {
       LoadGuard &guard(*iter);
-      guard.finalizeRange(vsSolver.getValueSetRead(guard.op->getSeqNum()));
+      if (guard.analysisState != 0) continue;
+      guard.finalizeRange(fullSolver.getValueSetRead(guard.op->getSeqNum()));
     }
   }
 }
@@ -1188,7 +1340,7 @@ void Heritage::guard(const Address &addr,int4 size,bool addIndirects,
   if (addIndirects) {
     fl = 0;
     // Query for generic properties of address (use empty usepoint)
-    fd->getScopeLocal()->queryProperties(addr,size,Address(),fl);
+    fd->queryScopeProperties(addr,size,Address(),fl);
     guardCalls(fl,addr,size,write);
     guardReturns(fl,addr,size,write);
     if (fd->getArch()->highPtrPossible(addr,size)) {
@@ -1430,6 +1582,30 @@ bool Heritage::tryOutputStackGuard(FuncCallSpecs *fc,const Address &addr,const A
   return true;
 }
 
+/// \brief Determine the effect of a call on a memory range, memoizing the resolution
+///
+/// Call sites to the same sub-function (or sharing a prototype model) consult the same
+/// list of EffectRecords, so the resolved effect for a range is cached by list identity:
+/// guarding a range across N such call sites performs a single binary search.  The cache
+/// only lives for one heritage pass, so prototype updates between passes cannot leave
+/// stale answers.
+/// \param fc is the call site being guarded
+/// \param addr is the first address of the range, translated to the callee's perspective
+/// \param size is the number of bytes in the range
+/// \return the EffectRecord type
+uint4 Heritage::cachedEffect(FuncCallSpecs *fc,const Address &addr,int4 size)
+
+{
+  const vector<EffectRecord> &efflist( fc->getEffectList() );
+  EffectRangeKey key(&efflist,addr,size);
+  map<EffectRangeKey,uint4>::const_iterator iter = effectCache.find(key);
+  if (iter != effectCache.end())
+    return (*iter).second;
+  uint4 res = ProtoModel::lookupEffect(efflist,addr,size);
+  effectCache[key] = res;
+  return res;
+}
+
 /// \brief Guard CALL/CALLIND ops in preparation for renaming algorithm
 ///
 /// For the given address range, we decide what the data-flow effect is
@@ -1464,7 +1640,7 @@ void Heritage::guardCalls(uint4 fl,const Address &addr,int4 size,vector<Varnode
 	  tryregister = false; // Do not attempt to register this stack loc as a trial
     }
     Address transAddr(spc,off);	// Address relative to callee's stack
-    effecttype = fc->hasEffect(transAddr,size);
+    effecttype = cachedEffect(fc,transAddr,size);
     bool possibleoutput = false;
     if (fc->isOutputActive() && tryregister) {
       ParamActive *active = fc->getActiveOutput();
@@ -2485,6 +2661,8 @@ void Heritage::renameRecurse(BlockBasic *bl,VariableStack &varstack)
   Varnode *vnout,*vnin,*vnnew;
   int4 i,slot;
 
+  if ((dirtyblocks[bl->getIndex()] & visit_node)==0)
+    return;			// No disturbed defs or reads in this subtree
   for(oiter=bl->beginOp();oiter!=bl->endOp();++oiter) {
     op = *oiter;
     if (op->code() != CPUI_MULTIEQUAL) {
@@ -2494,24 +2672,24 @@ void Heritage::renameRecurse(BlockBasic *bl,VariableStack &varstack)
 	if (vnin->isHeritageKnown()) continue; // not free
 	if (!vnin->isActiveHeritage()) continue; // Not being heritaged this round
 	vnin->clearActiveHeritage();
-	vector<Varnode *> &stack( varstack[ vnin->getAddr() ] );
-	if (stack.empty()) {
+	int4 stackid = varstack.getStack(vnin->getAddr());
+	if (varstack.stackEmpty(stackid)) {
 	  vnnew = fd->newVarnode(vnin->getSize(),vnin->getAddr());
 	  vnnew = fd->setInputVarnode(vnnew);
-	  stack.push_back(vnnew);
+	  varstack.push(stackid,vnnew);
 	}
 	else
-	  vnnew = stack.back();
+	  vnnew = varstack.stackTop(stackid);
 				// INDIRECTs and their op really happen AT SAME TIME
 	if (vnnew->isWritten() && (vnnew->getDef()->code()==CPUI_INDIRECT)) {
 	  if (PcodeOp::getOpFromConst(vnnew->getDef()->getIn(1)->getAddr()) == op) {
-	    if (stack.size()==1) {
+	    if (varstack.singleEntry(stackid)) {
 	      vnnew = fd->newVarnode(vnin->getSize(),vnin->getAddr());
 	      vnnew = fd->setInputVarnode(vnnew);
-	      stack.insert(stack.begin(),vnnew);
+	      varstack.insertBottom(stackid,vnnew);
 	    }
 	    else
-	      vnnew = stack[stack.size()-2];
+	      vnnew = varstack.underTop(stackid);
 	  }
 	}
 	fd->opSetInput(op,vnnew,slot);
@@ -2524,7 +2702,7 @@ void Heritage::renameRecurse(BlockBasic *bl,VariableStack &varstack)
     if (vnout == (Varnode *)0) continue;
     if (!vnout->isActiveHeritage()) continue; // Not a normalized write
     vnout->clearActiveHeritage();
-    varstack[ vnout->getAddr() ].push_back(vnout); // Push write onto stack
+    varstack.push(varstack.getStack(vnout->getAddr()),vnout); // Push write onto stack
     writelist.push_back(vnout);
   }
   for(i=0;i<bl->sizeOut();++i) {
@@ -2535,14 +2713,14 @@ void Heritage::renameRecurse(BlockBasic *bl,VariableStack &varstack)
       if (multiop->code()!=CPUI_MULTIEQUAL) break; // For each MULTIEQUAL
       vnin = multiop->getIn(slot);
       if (!vnin->isHeritageKnown()) {
-	vector<Varnode *> &stack( varstack[ vnin->getAddr() ] );
-	if (stack.empty()) {
+	int4 stackid = varstack.getStack(vnin->getAddr());
+	if (varstack.stackEmpty(stackid)) {
 	  vnnew = fd->newVarnode(vnin->getSize(),vnin->getAddr());
 	  vnnew = fd->setInputVarnode(vnnew);
-	  stack.push_back(vnnew);
+	  varstack.push(stackid,vnnew);
 	}
 	else
-	  vnnew = stack.back();
+	  vnnew = varstack.stackTop(stackid);
 	fd->opSetInput(multiop,vnnew,slot);
 	if (vnin->hasNoDescend())
 	  fd->deleteVarnode(vnin);
@@ -2556,7 +2734,7 @@ void Heritage::renameRecurse(BlockBasic *bl,VariableStack &varstack)
 				// Now we pop this blocks writes of the stack
   for(i=0;i<writelist.size();++i) {
     vnout = writelist[i];
-    varstack[vnout->getAddr()].pop_back();
+    varstack.pop(vnout->getAddr());
   }
 }
 
@@ -2577,16 +2755,89 @@ void Heritage::bumpDeadcodeDelay(AddrSpace *spc)
   if (fd->getOverride().hasDeadcodeDelay(spc))
     return;			// A delay has already been installed
   fd->getOverride().insertDeadcodeDelay(spc,spc->getDeadcodeDelay()+1);
-  fd->setRestartPending(true);
+  fd->setRestartPending(true,Funcdata::cause_deadcode);
+}
+
+/// \brief Mark basic blocks disturbed by the current set of address ranges
+///
+/// Walk the Varnodes in each range being heritaged this pass and set the
+/// \b dirty_node mark on every block that defines or reads one.  A block
+/// feeding a MULTIEQUAL that reads a disturbed range also marks all the
+/// MULTIEQUAL's incoming blocks, since the input linking happens from the
+/// predecessor side of the rename walk.
+void Heritage::markDirtyBlocks(void)
+
+{
+  TaskList::iterator iter;
+  VarnodeLocSet::const_iterator viter,venditer;
+  list<PcodeOp *>::const_iterator diter;
+
+  dirtyblocks.clear();
+  dirtyblocks.resize(fd->getBasicBlocks().getSize(),0);
+  for(iter=disjoint.begin();iter!=disjoint.end();++iter) {
+    const MemRange &memrange(*iter);
+    uintb start = memrange.addr.getOffset();
+    Address endaddr = memrange.addr + memrange.size;
+    if (endaddr.getOffset() < start) {	// Wraparound
+      Address tmp(endaddr.getSpace(),endaddr.getSpace()->getHighest());
+      venditer = fd->endLoc(tmp);
+    }
+    else
+      venditer = fd->beginLoc(endaddr);
+    for(viter=fd->beginLoc(memrange.addr);viter!=venditer;++viter) {
+      Varnode *vn = *viter;
+      if (vn->isWritten()) {
+	BlockBasic *bl = vn->getDef()->getParent();
+	if (bl != (BlockBasic *)0)
+	  dirtyblocks[bl->getIndex()] |= dirty_node;
+      }
+      for(diter=vn->beginDescend();diter!=vn->endDescend();++diter) {
+	PcodeOp *op = *diter;
+	BlockBasic *bl = op->getParent();
+	if (bl == (BlockBasic *)0) continue;
+	dirtyblocks[bl->getIndex()] |= dirty_node;
+	if (op->code() == CPUI_MULTIEQUAL) {
+	  for(int4 i=0;i<bl->sizeIn();++i)
+	    dirtyblocks[bl->getIn(i)->getIndex()] |= dirty_node;
+	}
+      }
+    }
+  }
+}
+
+/// \brief Compute which dominator subtrees the rename walk must descend into
+///
+/// The \b visit_node mark is set on a block if it, or any block in its
+/// dominator subtree, carries the \b dirty_node mark.  Subtrees without the
+/// mark contain no disturbed defs or reads and can be skipped entirely.
+/// \param bl is the root of the subtree to examine
+/// \return \b true if the subtree contains a dirty block
+bool Heritage::propagateDirty(FlowBlock *bl)
+
+{
+  int4 i = bl->getIndex();
+  bool visit = ((dirtyblocks[i] & dirty_node)!=0);
+  for(int4 slot=0;slot<domchild[i].size();++slot) {
+    if (propagateDirty(domchild[i][slot]))
+      visit = true;
+  }
+  if (visit)
+    dirtyblocks[i] |= visit_node;
+  return visit;
 }
 
 /// \brief Perform the renaming algorithm for the current set of address ranges
 ///
-/// Phi-node placement must already have happened.
+/// Phi-node placement must already have happened.  Only dominator subtrees
+/// containing blocks disturbed by the current ranges are walked, so a pass
+/// triggered by a localized change doesn't pay full-function rename cost.
 void Heritage::rename(void)
 
 {
   VariableStack varstack;
+  markDirtyBlocks();
+  propagateDirty(fd->getBasicBlocks().getBlock(0));
+  varstack.init(fd,disjoint);	// Assign dense stack ids to the addresses being renamed
   renameRecurse((BlockBasic *)fd->getBasicBlocks().getBlock(0),varstack);
   disjoint.clear();
 }
@@ -2675,8 +2926,9 @@ void Heritage::heritage(void)
   if (maxdepth == -1)		// Has a restructure been forced
     buildADT();
 
+  effectCache.clear();		// Prototype facts may have changed since the last pass
   processJoins();
-  if (pass == 0) {
+  if (pass == 0 && !fd->getArch()->splitrecords.empty()) {
     splitmanage.init(fd,&fd->getArch()->splitrecords);
     splitmanage.split();
   }
@@ -2864,6 +3116,7 @@ void Heritage::clear(void)
   clearInfoList();
   loadGuard.clear();
   storeGuard.clear();
+  effectCache.clear();
   maxdepth = -1;
   pass = 0;
 }
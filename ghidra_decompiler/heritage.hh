@@ -24,10 +24,6 @@
 
 namespace ghidra {
 
-/// Container holding the stack system for the renaming algorithm.  Every disjoint address
-/// range (indexed by its initial address) maps to its own Varnode stack.
-typedef map<Address,vector<Varnode *> > VariableStack;
-
 /// \brief Map object for keeping track of which address ranges have been heritaged
 ///
 /// We keep track of a fairly fine grained description of when each address range
@@ -35,6 +31,12 @@ typedef map<Address,vector<Varnode *> > VariableStack;
 /// no longer \b free.  An address range is added using the add() method, which includes
 /// the particular pass when it was entered.  The map can be queried using findPass()
 /// that informs the caller whether the address has been heritaged and if so in which pass.
+///
+/// The disjoint ranges are kept in a sorted vector rather than a tree.  Both the
+/// ranges added during a pass and the lookups made against them arrive in nearly
+/// sorted address order, so additions mostly append to the back of the vector and
+/// lookups gallop out from the previously queried position, while the contiguous
+/// storage avoids a pointer chase per comparison.
 class LocationMap {
 public:
   /// \brief Label for describing extent of address range that has been heritaged
@@ -42,18 +44,23 @@ public:
     int4 size;			///< Size of the range (in bytes)
     int4 pass;			///< Pass when the range was heritaged
   };
-  /// Iterator into the main map
-  typedef map<Address,SizePass>::iterator iterator;
+  /// A heritaged range: its starting address paired with its size and pass label
+  typedef pair<Address,SizePass> Entry;
+  /// Iterator into the sorted interval vector
+  typedef vector<Entry>::iterator iterator;
 private:
-  map<Address,SizePass> themap;	///< Heritaged addresses mapped to range size and pass number
+  vector<Entry> themap;		///< Heritaged ranges in address order
+  mutable size_t hint;		///< Index from the last query, seeding the galloping search
+  size_t gallop(const Address &addr) const;	///< Find index of first range past the given address
 public:
+  LocationMap(void) { hint = 0; }			///< Constructor
   iterator add(Address addr,int4 size,int4 pass,int4 &intersect); ///< Mark new address as \b heritaged
   iterator find(const Address &addr);			///< Look up if/how given address was heritaged
   int4 findPass(const Address &addr) const;		///< Look up if/how given address was heritaged
   iterator erase(iterator iter) { return themap.erase(iter); }	///< Remove a particular entry from the map
   iterator begin(void) { return themap.begin(); }	///< Get starting iterator over heritaged ranges
   iterator end(void) { return themap.end(); }		///< Get ending iterator over heritaged ranges
-  void clear(void) { themap.clear(); }			///< Clear the map of heritaged ranges
+  void clear(void) { themap.clear(); hint = 0; }	///< Clear the map of heritaged ranges
 };
 
 /// \brief An address range to be processed
@@ -112,6 +119,57 @@ public:
 class Funcdata;
 class FuncCallSpecs;
 
+/// \brief Key identifying one resolved call-effect query
+///
+/// The key pairs the identity of the EffectRecord list being consulted with the
+/// memory range being tested, so call sites sharing a callee (or a prototype model)
+/// share their resolved effects.
+struct EffectRangeKey {
+  const void *list;		///< Identity of the EffectRecord list consulted
+  AddrKey addr;			///< Packed starting address of the queried range
+  int4 size;			///< Number of bytes in the queried range
+
+  /// \brief Construct a key from the list identity and range
+  EffectRangeKey(const void *l,const Address &a,int4 s) : addr(a.toKey()) { list = l; size = s; }
+
+  /// \brief Compare two keys lexicographically
+  bool operator<(const EffectRangeKey &op2) const {
+    if (list != op2.list) return (list < op2.list);
+    if (addr != op2.addr) return (addr < op2.addr);
+    return (size < op2.size);
+  }
+};
+
+/// \brief Container holding the stack system for the renaming algorithm
+///
+/// Every address encountered during one renaming pass is assigned a dense integer
+/// id, its position in a sorted flat vector, and each id selects a stack of Varnodes.
+/// The stacks are singly linked lists threaded through one backing vector, so the
+/// whole system allocates no individual nodes.  The addresses are registered up
+/// front from the ranges being heritaged (init); an address seen only at lookup
+/// time is inserted in sorted position, which may shift ids, so an id should be
+/// used immediately after the getStack() call that produced it.
+class VariableStack {
+  /// \brief A Varnode pushed onto one of the stacks
+  struct StackNode {
+    Varnode *vn;	///< The Varnode on the stack
+    int4 prev;		///< Index of the backing entry underneath, or -1
+  };
+  vector<Address> addrList;	///< Sorted list of registered addresses, position = stack id
+  vector<int4> top;		///< Backing index of the top entry for each stack id (-1 if empty)
+  vector<StackNode> backing;	///< Backing storage for all stack entries
+public:
+  void init(Funcdata *fd,TaskList &disjoint);	///< Register the addresses in the given ranges
+  int4 getStack(const Address &addr);		///< Get the stack id for the given address
+  bool stackEmpty(int4 id) const { return (top[id] < 0); }	///< Return \b true if the given stack is empty
+  bool singleEntry(int4 id) const { return (backing[top[id]].prev < 0); }	///< Return \b true if the given stack has exactly one entry
+  Varnode *stackTop(int4 id) const { return backing[top[id]].vn; }	///< Get the top Varnode of the given stack
+  Varnode *underTop(int4 id) const { return backing[backing[top[id]].prev].vn; }	///< Get the Varnode just below the top
+  void push(int4 id,Varnode *vn);		///< Push a Varnode onto the given stack
+  void insertBottom(int4 id,Varnode *vn);	///< Insert a Varnode below the lone entry of the given stack
+  void pop(const Address &addr);		///< Pop the top Varnode of the stack for the given address
+};
+
 /// \brief Information about heritage passes performed for a specific address space
 ///
 /// For a particular address space, this keeps track of:
@@ -209,7 +267,9 @@ class Heritage {
   enum heritage_flags {
     boundary_node = 1,		///< Augmented Dominator Tree boundary node
     mark_node = 2,		///< Node has already been in queue
-    merged_node = 4		///< Node has already been merged
+    merged_node = 4,		///< Node has already been merged
+    dirty_node = 8,		///< Block touches an address range disturbed since the last rename
+    visit_node = 16		///< Rename walk must descend through this block
   };
 
   /// \brief Node for depth-first traversal of stack references
@@ -241,6 +301,7 @@ class Heritage {
   vector<vector<FlowBlock *> > domchild; ///< Parent->child edges in dominator tree
   vector<vector<FlowBlock *> > augment; ///< Augmented edges
   vector<uint4> flags;		///< Block properties for phi-node placement algorithm
+  vector<uint4> dirtyblocks;	///< Per-block dirty/visit marks for the current rename pass
   vector<int4> depth;		///< Dominator depth of individual blocks
   int4 maxdepth;		///< Maximum depth of the dominator tree
   int4 pass;			///< Current pass being executed
@@ -251,6 +312,7 @@ class Heritage {
   list<LoadGuard> loadGuard;	///< List of LOAD operations that need to be guarded
   list<LoadGuard> storeGuard;	///< List of STORE operations taking an indexed pointer to the stack
   vector<PcodeOp *> loadCopyOps;	///< List of COPY ops generated by load guards
+  map<EffectRangeKey,uint4> effectCache;	///< Resolved call-effect queries for the current pass
   void clearInfoList(void);	 ///< Reset heritage status for all address spaces
 
   /// \brief Get the heritage status for the given address space
@@ -294,6 +356,7 @@ class Heritage {
   bool tryOutputStackGuard(FuncCallSpecs *fc,const Address &addr,const Address &transAddr,int4 size,
 			   int4 outputCharacter,vector<Varnode *> &write);
   void guardOutputOverlapStack(PcodeOp *callOp,const Address &addr,int4 size,const Address &retAddr,int4 retSize,vector<Varnode *> &write);
+  uint4 cachedEffect(FuncCallSpecs *fc,const Address &addr,int4 size);
   void guardCalls(uint4 fl,const Address &addr,int4 size,vector<Varnode *> &write);
   void guardStores(const Address &addr,int4 size,vector<Varnode *> &write);
   void guardLoads(uint4 fl,const Address &addr,int4 size,vector<Varnode *> &write);
@@ -309,6 +372,8 @@ class Heritage {
 				const vector<Varnode *> &writevars,const vector<Varnode *> &inputvars);
   void visitIncr(FlowBlock *qnode,FlowBlock *vnode);
   void calcMultiequals(const vector<Varnode *> &write);
+  void markDirtyBlocks(void);
+  bool propagateDirty(FlowBlock *bl);
   void renameRecurse(BlockBasic *bl,VariableStack &varstack);
   void bumpDeadcodeDelay(AddrSpace *spc);
   void placeMultiequals(void);
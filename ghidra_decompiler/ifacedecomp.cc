@@ -19,6 +19,12 @@ extern "C" {
 }
 #include "pcodeparse.hh"
 #include "blockaction.hh"
+#include "sleigh.hh"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace ghidra {
 
@@ -48,6 +54,7 @@ void IfaceDecompCapability::registerCommands(IfaceStatus *status)
   status->registerCom(new IfcOption(),"option");
   status->registerCom(new IfcParseFile(),"parse","file");
   status->registerCom(new IfcParseLine(),"parse","line");
+  status->registerCom(new IfcParseProtoFile(),"parse","protofile");
   status->registerCom(new IfcAdjustVma(),"adjust","vma");
   status->registerCom(new IfcFuncload(),"load","function");
   status->registerCom(new IfcAddrrangeLoad(),"load","addr");
@@ -64,6 +71,8 @@ void IfaceDecompCapability::registerCommands(IfaceStatus *status)
   status->registerCom(new IfcMapunionfacet(), "map", "unionfacet");
   status->registerCom(new IfcPrintdisasm(),"disassemble");
   status->registerCom(new IfcDecompile(),"decompile");
+  status->registerCom(new IfcDecompileAll(),"decompile","all");
+  status->registerCom(new IfcDecompileBatch(),"decompile","batch");
   status->registerCom(new IfcDump(),"dump");
   status->registerCom(new IfcDumpbinary(),"binary");
   status->registerCom(new IfcForcegoto(),"force","goto");
@@ -112,6 +121,8 @@ void IfaceDecompCapability::registerCommands(IfaceStatus *status)
   status->registerCom(new IfcPrintExtrapop(),"print","extrapop");
   status->registerCom(new IfcPrintActionstats(),"print","actionstats");
   status->registerCom(new IfcResetActionstats(),"reset","actionstats");
+  status->registerCom(new IfcPrintRuleprofile(),"print","ruleprofile");
+  status->registerCom(new IfcPerfstats(),"perfstats");
   status->registerCom(new IfcCountPcode(),"count","pcode");
   status->registerCom(new IfcTypeVarnode(),"type","varnode");
   status->registerCom(new IfcNameVarnode(),"name","varnode");
@@ -400,6 +411,51 @@ void IfcParseLine::execute(istream &s)
   }
 }
 
+/// \class IfcParseProtoFile
+/// \brief Bulk-load function prototypes from a file: `parse protofile <filename>`
+///
+/// The file holds one C function declaration per line (blank lines and `//`
+/// comments are skipped).  Parsed prototypes are cached in packed form next
+/// to the file, so re-loading the same file (another session, a restart)
+/// skips the C parser.  Each prototype whose name matches an existing
+/// function is applied to that function; unmatched names are reported.
+void IfcParseProtoFile::execute(istream &s)
+
+{
+  if (dcp->conf == (Architecture *)0)
+    throw IfaceExecutionError("No load image present");
+
+  string filename;
+
+  s >> ws >> filename;
+  if (filename.empty())
+    throw IfaceParseError("Missing filename");
+
+  vector<PrototypePieces> protolist;
+  try {
+    parse_protolib(dcp->conf,filename,protolist);
+  }
+  catch(ParseError &err) {
+    *status->optr << "Error in C syntax: " << err.explain << endl;
+    throw IfaceExecutionError("Bad C syntax");
+  }
+  int4 applied = 0;
+  int4 unmatched = 0;
+  for(int4 i=0;i<protolist.size();++i) {
+    try {
+      dcp->conf->setPrototype(protolist[i]);
+      applied += 1;
+    }
+    catch(ParseError &err) {	// Name doesn't resolve to a known function
+      unmatched += 1;
+    }
+  }
+  *status->optr << "Applied " << dec << applied << " prototypes";
+  if (unmatched != 0)
+    *status->optr << " (" << dec << unmatched << " unmatched)";
+  *status->optr << endl;
+}
+
 /// \class IfcAdjustVma
 /// \brief Change the base address of the load image: `adjust vma 0xabcd0123`
 ///
@@ -918,6 +974,227 @@ void IfcDecompile::execute(istream &s)
   *status->optr << endl;
 }
 
+/// \brief A pool of worker threads decompiling a fixed list of functions
+///
+/// Functions are handed out by index from a shared work-list.  Each worker
+/// leases a private clone of the current root Action and a private printer
+/// (the registered trees and \b print carry per-run state and cannot back two
+/// concurrent runs), decompiles its functions, and spools status plus output
+/// text into a per-function slot.  The dispatching thread emits completed
+/// slots in work-list order while later functions are still in flight, so
+/// output is deterministic regardless of completion order.  Analysis for each
+/// function is cleared once its text is spooled, bounding memory use over
+/// large programs.
+class ParallelDecompile {
+  Architecture *glb;			///< Architecture being analyzed
+  const vector<Funcdata *> &worklist;	///< Functions to decompile, in output order
+  string rootname;			///< Name of the root Action to run
+  vector<string> spool;			///< Completed output text, one slot per function
+  vector<bool> ready;			///< Marks which slots are complete
+  size_t nextslot;			///< Index of the next un-dispatched function
+  std::mutex mutex;			///< Guards dispatch and spool state
+  std::condition_variable cv;		///< Signals slot completion to the emitter
+  std::mutex archMutex;			///< Serializes setup touches of shared architecture state
+  void worker(void);			///< Decompile functions until the work-list is exhausted
+  void processOne(Funcdata *fd,Action *rootact,PrintLanguage *printer,ostream &s);
+public:
+  ParallelDecompile(Architecture *g,const vector<Funcdata *> &wl) : worklist(wl) { glb = g; }
+  void run(int4 nthreads,ostream &s);	///< Run the pool and emit ordered output
+};
+
+/// Decompile one function, writing status and C output to the given stream.
+/// Analysis is cleared afterward.
+/// \param fd is the function to decompile
+/// \param rootact is this worker's private root Action
+/// \param printer is this worker's private output printer
+/// \param s is the stream receiving this function's spooled output
+void ParallelDecompile::processOne(Funcdata *fd,Action *rootact,PrintLanguage *printer,ostream &s)
+
+{
+  if (fd->hasNoCode()) {
+    s << "No code for " << fd->getName() << endl;
+    return;
+  }
+  try {
+    if (fd->isProcStarted())
+      glb->clearAnalysis(fd);	// Clear any old analysis
+    rootact->reset(*fd);
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    int4 res = rootact->perform(*fd);
+    std::chrono::steady_clock::time_point end_time = std::chrono::steady_clock::now();
+    if (res < 0) {
+      s << "Incomplete decompilation of " << fd->getName() << endl;
+      glb->clearAnalysis(fd);
+      return;
+    }
+    int8 duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time-start_time).count();
+    s << "Decompiled " << fd->getName();
+    s << '(' << dec << fd->getSize() << ')';
+    s << " time=" << duration << " ms" << endl;
+    printer->setOutputStream(&s);
+    printer->docFunction(fd);
+  }
+  catch(LowlevelError &err) {
+    s << "Skipping " << fd->getName() << ": " << err.explain << endl;
+  }
+  glb->clearAnalysis(fd);
+}
+
+void ParallelDecompile::worker(void)
+
+{
+  Action *rootact;
+  PrintLanguage *printer;
+  {
+    // cloneRoot may derive and register the pipeline, and building a printer
+    // reads capability state; construct both under the shared-state lock
+    std::lock_guard<std::mutex> lock(archMutex);
+    rootact = glb->allacts.cloneRoot(rootname);
+    printer = PrintLanguageCapability::getDefault()->buildLanguage(glb);
+    printer->initializeFromArchitecture();
+  }
+  for(;;) {
+    size_t slot;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (nextslot >= worklist.size()) break;
+      slot = nextslot;
+      nextslot += 1;
+    }
+    ostringstream out;
+    processOne(worklist[slot],rootact,printer,out);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      spool[slot] = out.str();
+      ready[slot] = true;
+    }
+    cv.notify_all();
+  }
+  delete printer;
+  delete rootact;
+}
+
+/// Workers are launched, then completed slots are written to the output
+/// stream in work-list order as they become available.
+/// \param nthreads is the number of worker threads (0 selects the hardware count)
+/// \param s is the stream receiving all output
+void ParallelDecompile::run(int4 nthreads,ostream &s)
+
+{
+  if (nthreads <= 0)
+    nthreads = (int4)std::thread::hardware_concurrency();
+  if (nthreads <= 0)
+    nthreads = 1;
+  if ((size_t)nthreads > worklist.size())
+    nthreads = (int4)worklist.size();
+  spool.resize(worklist.size());
+  ready.assign(worklist.size(),false);
+  nextslot = 0;
+  rootname = glb->allacts.getCurrentName();
+  vector<std::thread> pool;
+  for(int4 i=0;i<nthreads;++i)
+    pool.emplace_back(&ParallelDecompile::worker,this);
+  for(size_t slot=0;slot<worklist.size();++slot) {
+    string text;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock,[this,slot]{ return (bool)ready[slot]; });
+      text.swap(spool[slot]);
+    }
+    s << text;
+  }
+  for(size_t i=0;i<pool.size();++i)
+    pool[i].join();
+}
+
+/// \class IfcDecompileAll
+/// \brief Decompile every function using a worker pool: `decompile all [<threads>]`
+///
+/// All functions in the program are distributed across a pool of worker
+/// threads over the shared architecture.  Status lines and decompiled C
+/// source are emitted in address order.  Unlike `decompile`, analysis for
+/// each function is cleared once its output is written.
+void IfcDecompileAll::execute(istream &s)
+
+{
+  if (dcp->conf == (Architecture *)0)
+    throw IfaceExecutionError("No load image present");
+
+  int4 nthreads = 0;
+  s >> ws;
+  if (!s.eof())
+    s >> dec >> nthreads;
+
+  worklist.clear();
+  iterateFunctionsAddrOrder();
+  if (worklist.empty()) {
+    *status->optr << "No functions to decompile" << endl;
+    return;
+  }
+  ParallelDecompile pool(dcp->conf,worklist);
+  pool.run(nthreads,*status->fileoptr);
+  worklist.clear();
+}
+
+void IfcDecompileAll::iterationCallback(Funcdata *fd)
+
+{
+  worklist.push_back(fd);
+}
+
+/// \class IfcDecompileBatch
+/// \brief Decompile a list of functions using a worker pool: `decompile batch <file> [<threads>]`
+///
+/// The file names one function per line.  The named functions are distributed
+/// across a pool of worker threads over the shared architecture, with status
+/// lines and decompiled C source emitted in file order.  Names that don't
+/// resolve are reported and skipped.  Analysis for each function is cleared
+/// once its output is written.
+void IfcDecompileBatch::execute(istream &s)
+
+{
+  if (dcp->conf == (Architecture *)0)
+    throw IfaceExecutionError("No load image present");
+
+  string filename;
+  s >> ws;
+  if (s.eof())
+    throw IfaceParseError("Missing batch file name");
+  s >> filename;
+  int4 nthreads = 0;
+  s >> ws;
+  if (!s.eof())
+    s >> dec >> nthreads;
+
+  ifstream is(filename.c_str());
+  if (!is)
+    throw IfaceExecutionError("Unable to open batch file: "+filename);
+
+  vector<Funcdata *> worklist;
+  string funcname;
+  while(is >> ws, getline(is,funcname)) {
+    if (funcname.empty()) continue;
+    string basename;
+    Scope *funcscope = dcp->conf->symboltab->resolveScopeFromSymbolName(funcname,"::",basename,(Scope *)0);
+    if (funcscope == (Scope *)0) {
+      *status->optr << "Bad namespace: " << funcname << endl;
+      continue;
+    }
+    Funcdata *fd = funcscope->queryFunction(basename);
+    if (fd == (Funcdata *)0) {
+      *status->optr << "Unknown function name: " << funcname << endl;
+      continue;
+    }
+    worklist.push_back(fd);
+  }
+  if (worklist.empty()) {
+    *status->optr << "No functions to decompile" << endl;
+    return;
+  }
+  ParallelDecompile pool(dcp->conf,worklist);
+  pool.run(nthreads,*status->fileoptr);
+}
+
 /// \class IfcPrintCFlat
 /// \brief Print current function without control-flow: `print C flat`
 void IfcPrintCFlat::execute(istream &s)
@@ -3276,6 +3553,212 @@ void IfcResetActionstats::execute(istream &s)
   dcp->conf->allacts.getCurrent()->resetStats();
 }
 
+/// \brief Order rules by descending cumulative application time
+static bool compareRuleTime(Rule *a,Rule *b)
+
+{
+  return (a->getNanos() > b->getNanos());
+}
+
+/// \class IfcPrintRuleprofile
+/// \brief Print rules ranked by time spent applying them: `print ruleprofile`
+///
+/// Rules from the current action's pools are listed in descending order of the
+/// cumulative time spent inside their applyOp() methods, with each rule's share
+/// of the total rule time, so the dominant rule in a slow sample is visible at
+/// a glance.  Rules that were never tested are omitted.  Counters accumulate
+/// over multiple decompilations until `reset actionstats`.
+void IfcPrintRuleprofile::execute(istream &s)
+
+{
+  if (dcp->conf == (Architecture *)0)
+    throw IfaceExecutionError("Image not loaded");
+  if (dcp->conf->allacts.getCurrent() == (Action *)0)
+    throw IfaceExecutionError("No action set");
+
+  vector<Rule *> rules;
+  dcp->conf->allacts.getCurrent()->collectRules(rules);
+  sort(rules.begin(),rules.end(),compareRuleTime);
+  uint8 total = 0;
+  for(int4 i=0;i<rules.size();++i)
+    total += rules[i]->getNanos();
+  if (total == 0) {
+    *status->fileoptr << "No rule applications recorded" << endl;
+    return;
+  }
+  for(int4 i=0;i<rules.size();++i) {
+    Rule *rule = rules[i];
+    if (rule->getNumTests() == 0) continue;
+    uint8 nanos = rule->getNanos();
+    *status->fileoptr << rule->getName() << dec << " Tested=" << rule->getNumTests();
+    *status->fileoptr << " Applied=" << rule->getNumApply();
+    *status->fileoptr << " Micros=" << (nanos/1000);
+    *status->fileoptr << " (" << ((nanos*100)/total) << "%)" << endl;
+  }
+}
+
+/// \brief Order actions by descending cumulative application time
+static bool compareActionTime(Action *a,Action *b)
+
+{
+  return (a->getElapsedUsec() > b->getElapsedUsec());
+}
+
+void IfcPerfstats::emitActions(ostream &os,bool json) const
+
+{
+  vector<Action *> acts;
+  dcp->conf->allacts.getCurrent()->collectStatistics(acts);
+  sort(acts.begin(),acts.end(),compareActionTime);
+  if (json) {
+    os << "  \"actions\": [";
+    bool first = true;
+    for(int4 i=0;i<acts.size();++i) {
+      Action *act = acts[i];
+      if (act->getNumTests() == 0) continue;
+      if (!first) os << ',';
+      first = false;
+      os << "\n    { \"name\": \"" << act->getName() << "\", \"tested\": " << dec << act->getNumTests();
+      os << ", \"applied\": " << act->getNumApply() << ", \"micros\": " << act->getElapsedUsec() << " }";
+    }
+    os << "\n  ]";
+    return;
+  }
+  os << "Actions (by cumulative time):" << endl;
+  for(int4 i=0;i<acts.size();++i) {
+    Action *act = acts[i];
+    if (act->getNumTests() == 0) continue;
+    os << "  " << act->getName() << dec << " Tested=" << act->getNumTests();
+    os << " Applied=" << act->getNumApply() << " Micros=" << act->getElapsedUsec() << endl;
+  }
+}
+
+void IfcPerfstats::emitRules(ostream &os,bool json) const
+
+{
+  vector<Rule *> rules;
+  dcp->conf->allacts.getCurrent()->collectRules(rules);
+  sort(rules.begin(),rules.end(),compareRuleTime);
+  if (json) {
+    os << "  \"rules\": [";
+    bool first = true;
+    for(int4 i=0;i<rules.size();++i) {
+      Rule *rule = rules[i];
+      if (rule->getNumTests() == 0) continue;
+      if (!first) os << ',';
+      first = false;
+      os << "\n    { \"name\": \"" << rule->getName() << "\", \"tested\": " << dec << rule->getNumTests();
+      os << ", \"applied\": " << rule->getNumApply() << ", \"micros\": " << (rule->getNanos()/1000) << " }";
+    }
+    os << "\n  ]";
+    return;
+  }
+  os << "Rules (by cumulative time):" << endl;
+  for(int4 i=0;i<rules.size();++i) {
+    Rule *rule = rules[i];
+    if (rule->getNumTests() == 0) continue;
+    os << "  " << rule->getName() << dec << " Tested=" << rule->getNumTests();
+    os << " Applied=" << rule->getNumApply() << " Micros=" << (rule->getNanos()/1000) << endl;
+  }
+}
+
+void IfcPerfstats::emitRestarts(ostream &os,bool json) const
+
+{
+  int4 total = (dcp->fd != (Funcdata *)0) ? dcp->fd->numRestarts() : 0;
+  if (json) {
+    os << "  \"restarts\": { \"total\": " << dec << total;
+    if (dcp->fd != (Funcdata *)0) {
+      for(int4 i=0;i<Funcdata::cause_max;++i) {
+	int4 count = dcp->fd->getRestartCount(i);
+	if (count == 0) continue;
+	os << ", \"" << Funcdata::restartCauseName(i) << "\": " << count;
+      }
+    }
+    os << " }";
+    return;
+  }
+  if (dcp->fd == (Funcdata *)0) {
+    os << "Restarts: no current function" << endl;
+    return;
+  }
+  os << "Restarts (current function): " << dec << total << endl;
+  for(int4 i=0;i<Funcdata::cause_max;++i) {
+    int4 count = dcp->fd->getRestartCount(i);
+    if (count == 0) continue;
+    os << "  " << Funcdata::restartCauseName(i) << " = " << count << endl;
+  }
+}
+
+void IfcPerfstats::emitCaches(ostream &os,bool json) const
+
+{
+  uint8 hits = 0;
+  uint8 misses = 0;
+  const Sleigh *sleigh = dynamic_cast<const Sleigh *>(dcp->conf->translate);
+  if (sleigh != (const Sleigh *)0)
+    sleigh->getCacheStats(hits,misses);
+  uint8 total = hits + misses;
+  if (json) {
+    os << "  \"caches\": { \"disassembly\": { \"hits\": " << dec << hits << ", \"misses\": " << misses;
+    os << ", \"hit_rate\": " << ((total != 0) ? ((double)hits/(double)total) : 0.0) << " } }";
+    return;
+  }
+  os << "DisassemblyCache: " << dec << hits << " hits, " << misses << " misses";
+  if (total != 0)
+    os << " (" << ((hits*100)/total) << "% hit rate)";
+  os << endl;
+}
+
+/// \class IfcPerfstats
+/// \brief Dump accumulated performance counters: `perfstats [actions|rules|restarts|caches|all] [json]`
+///
+/// Per-action timings and per-rule counters come from the current action
+/// hierarchy (accumulating until `reset actionstats`), restart analytics from
+/// the current function, and cache hit rates from the SLEIGH disassembly
+/// engine.  By default all sections print as tables sorted by cumulative
+/// time; appending \b json emits one machine-readable object instead, for
+/// the offline tuning loop.
+void IfcPerfstats::execute(istream &s)
+
+{
+  if (dcp->conf == (Architecture *)0)
+    throw IfaceExecutionError("Image not loaded");
+  if (dcp->conf->allacts.getCurrent() == (Action *)0)
+    throw IfaceExecutionError("No action set");
+
+  string section,format;
+  s >> ws >> section >> ws >> format;
+  if (section.empty() || section == "json") {
+    if (section == "json")
+      format = "json";
+    section = "all";
+  }
+  bool json = (format == "json");
+  bool doActions = (section == "all" || section == "actions");
+  bool doRules = (section == "all" || section == "rules");
+  bool doRestarts = (section == "all" || section == "restarts");
+  bool doCaches = (section == "all" || section == "caches");
+  if (!doActions && !doRules && !doRestarts && !doCaches)
+    throw IfaceParseError("Unknown perfstats section: "+section);
+
+  ostream &os( *status->fileoptr );
+  if (json) {
+    os << "{\n";
+    bool first = true;
+    if (doActions) { emitActions(os,true); first = false; }
+    if (doRules) { if (!first) os << ",\n"; emitRules(os,true); first = false; }
+    if (doRestarts) { if (!first) os << ",\n"; emitRestarts(os,true); first = false; }
+    if (doCaches) { if (!first) os << ",\n"; emitCaches(os,true); }
+    os << "\n}" << endl;
+    return;
+  }
+  if (doActions) emitActions(os,false);
+  if (doRules) emitRules(os,false);
+  if (doRestarts) emitRestarts(os,false);
+  if (doCaches) emitCaches(os,false);
+}
+
 /// \class IfcCountPcode
 /// \brief Count p-code in the \e current function: `count pcode`
 ///
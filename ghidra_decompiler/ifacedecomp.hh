@@ -128,6 +128,11 @@ public:
   virtual void execute(istream &s);
 };
 
+class IfcParseProtoFile : public IfaceDecompCommand {
+public:
+  virtual void execute(istream &s);
+};
+
 class IfcAdjustVma : public IfaceDecompCommand {
 public:
   virtual void execute(istream &s);
@@ -218,6 +223,18 @@ public:
   virtual void execute(istream &s);
 };
 
+class IfcDecompileAll : public IfaceDecompCommand {
+  vector<Funcdata *> worklist;		///< Functions collected for the worker pool
+public:
+  virtual void execute(istream &s);
+  virtual void iterationCallback(Funcdata *fd);
+};
+
+class IfcDecompileBatch : public IfaceDecompCommand {
+public:
+  virtual void execute(istream &s);
+};
+
 class IfcPrintLanguage : public IfaceDecompCommand {
 public:
   virtual void execute(istream &s);
@@ -568,6 +585,20 @@ public:
   virtual void execute(istream &s);
 };
 
+class IfcPrintRuleprofile : public IfaceDecompCommand {
+public:
+  virtual void execute(istream &s);
+};
+
+class IfcPerfstats : public IfaceDecompCommand {
+  void emitActions(ostream &os,bool json) const;	///< Dump per-action timing counters
+  void emitRules(ostream &os,bool json) const;		///< Dump per-rule counters
+  void emitRestarts(ostream &os,bool json) const;	///< Dump restart analytics for the current function
+  void emitCaches(ostream &os,bool json) const;		///< Dump instruction cache hit rates
+public:
+  virtual void execute(istream &s);
+};
+
 class IfcVolatile : public IfaceDecompCommand {
 public:
   virtual void execute(istream &s);
@@ -19,18 +19,52 @@
 
 namespace ghidra {
 
-InjectContextSleigh::~InjectContextSleigh(void)
-
+/// \brief An injection payload compiled into p-code templates, shareable across translator instances
+///
+/// The templates reference operand symbols and address spaces owned by a specific set of
+/// SLEIGH specification tables, so the record pins the tables it was compiled against.
+/// A record is only ever reused by translators sharing those same tables.
+struct InjectCompileRecord {
+  std::shared_ptr<const SleighTables> tables;	///< The specification tables the templates were compiled against
+  std::shared_ptr<ConstructTpl> tpl;		///< The compiled p-code templates
+  uintb uniquebase;				///< State of the unique allocator after compilation
+};
+
+static map<string,InjectCompileRecord> compiledPayloads;	///< Compiled payloads shared process wide
+static std::mutex compiledPayloadsMutex;			///< Guards \b compiledPayloads
+
+/// \brief Build the cache key for a payload about to be compiled
+///
+/// The key captures everything that affects the compiled result: the specification
+/// tables (which determine operand symbols and address spaces), the payload type and
+/// operands, the starting offset for unique allocations, and the SLEIGH source itself.
+/// \param payload is the payload being compiled
+/// \param parsestring is the SLEIGH source for the payload
+/// \param tables is the specification tables for the compiling translator
+/// \param uniquebase is the starting offset for unique space allocations
+/// \return the constructed key
+static string buildPayloadKey(InjectPayload *payload,const string &parsestring,
+			      const SleighTables *tables,uintb uniquebase)
 {
-  if (pos != (ParserContext *)0)
-    delete pos;
+  ostringstream s;
+  s << hex << (uintp)tables << ' ' << uniquebase << ' ' << dec << payload->getType();
+  for(int4 i=0;i<payload->sizeInput();++i) {
+    InjectParameter &param( payload->getInput(i) );
+    s << ' ' << param.getName() << ':' << param.getIndex();
+  }
+  for(int4 i=0;i<payload->sizeOutput();++i) {
+    InjectParameter &param( payload->getOutput(i) );
+    s << ' ' << param.getName() << ':' << param.getIndex();
+  }
+  s << '\n' << parsestring;
+  return s.str();
 }
 
-InjectPayloadSleigh::~InjectPayloadSleigh(void)
+InjectContextSleigh::~InjectContextSleigh(void)
 
 {
-  if (tpl != (ConstructTpl *)0)
-    delete tpl;
+  if (pos != (ParserContext *)0)
+    delete pos;
 }
 
 /// Create an empty payload in preparation for parsing the injection from a stream
@@ -41,7 +75,6 @@ InjectPayloadSleigh::InjectPayloadSleigh(const string &src,const string &nm,int4
   : InjectPayload(nm,tp)
 {
   source = src;
-  tpl = (ConstructTpl *)0;
   paramshift = 0;
 }
 
@@ -62,7 +95,7 @@ void InjectPayloadSleigh::inject(InjectContext &context,PcodeEmit &emit) const
   // delayslot and crossbuild directives are not allowed in snippets, so we don't need the DisassemblyCache
   // and we don't need a unique allocation mask
   SleighBuilder builder(&walker,(DisassemblyCache *)0,&con.cacher,con.glb->getConstantSpace(),con.glb->getUniqueSpace(),0);
-  builder.build(tpl,-1);
+  builder.build(tpl.get(),-1);
   con.cacher.resolveRelatives();
   con.cacher.emit(con.baseaddr,&emit);
 }
@@ -221,14 +254,6 @@ void InjectPayloadCallother::decode(Decoder &decoder)
 ExecutablePcodeSleigh::ExecutablePcodeSleigh(Architecture *g,const string &src,const string &nm)
   : ExecutablePcode(g,src,nm)
 {
-  tpl = (ConstructTpl *)0;
-}
-
-ExecutablePcodeSleigh::~ExecutablePcodeSleigh(void)
-
-{
-  if (tpl != (ConstructTpl *)0)
-    delete tpl;
 }
 
 void ExecutablePcodeSleigh::inject(InjectContext &context,PcodeEmit &emit) const
@@ -248,7 +273,7 @@ void ExecutablePcodeSleigh::inject(InjectContext &context,PcodeEmit &emit) const
   // delayslot and crossbuild directives are not allowed in snippets, so we don't need the DisassemblyCache
   // and we don't need a unique allocation mask
   SleighBuilder builder(&walker,(DisassemblyCache *)0,&con.cacher,con.glb->getConstantSpace(),con.glb->getUniqueSpace(),0);
-  builder.build(tpl,-1);
+  builder.build(tpl.get(),-1);
   con.cacher.resolveRelatives();
   con.cacher.emit(con.baseaddr,&emit);
 }
@@ -367,8 +392,11 @@ InjectPayloadDynamic *PcodeInjectLibrarySleigh::forceDebugDynamic(int4 injectid)
 /// \brief Convert SLEIGH syntax to p-code templates for the given InjectPayload
 ///
 /// The payload \b parsestring must be populated with SLEIGH synatax.
-/// The SLEIGH translator is used to parse the syntax and produce the
-/// p-code templates that are then ready to be injected via InjectPayload::inject.
+/// Compiled templates are cached process wide, so if an equivalent payload was
+/// already compiled by another architecture instance sharing the same specification
+/// tables, the templates are reused directly.  Otherwise the SLEIGH translator is
+/// used to parse the syntax and produce the p-code templates that are then ready
+/// to be injected via InjectPayload::inject.
 /// \param payload is the given InjectPayload
 void PcodeInjectLibrarySleigh::parseInject(InjectPayload *payload)
 
@@ -384,6 +412,36 @@ void PcodeInjectLibrarySleigh::parseInject(InjectPayload *payload)
     contextCache.pos = new ParserContext((ContextCache *)0,(Translate *)0);
     contextCache.pos->initialize(8,8,slgh->getConstantSpace());
   }
+  bool isExecutable = (payload->getType() == InjectPayload::EXECUTABLEPCODE_TYPE);
+  ExecutablePcodeSleigh *execpayload = (ExecutablePcodeSleigh *)0;
+  InjectPayloadSleigh *sleighpayload = (InjectPayloadSleigh *)0;
+  string *parsestring;
+  uintb uniquebase;
+  if (isExecutable) {
+    execpayload = (ExecutablePcodeSleigh *)payload;
+    parsestring = &execpayload->parsestring;
+    uniquebase = 0x2000;	// Don't need to deconflict with anything other injects
+  }
+  else {
+    sleighpayload = (InjectPayloadSleigh *)payload;
+    parsestring = &sleighpayload->parsestring;
+    uniquebase = tempbase;
+  }
+  string key = buildPayloadKey(payload,*parsestring,slgh->getTables().get(),uniquebase);
+  {
+    std::lock_guard<std::mutex> lock(compiledPayloadsMutex);
+    map<string,InjectCompileRecord>::const_iterator iter = compiledPayloads.find(key);
+    if (iter != compiledPayloads.end()) {
+      if (isExecutable)
+	execpayload->tpl = (*iter).second.tpl;
+      else {
+	sleighpayload->tpl = (*iter).second.tpl;
+	tempbase = (*iter).second.uniquebase;
+      }
+      *parsestring = "";		// No longer need the memory
+      return;
+    }
+  }
   PcodeSnippet compiler(slgh);
 //  compiler.clear();			// Not necessary unless we reuse
   for(int4 i=0;i<payload->sizeInput();++i) {
@@ -394,25 +452,23 @@ void PcodeInjectLibrarySleigh::parseInject(InjectPayload *payload)
     InjectParameter &param( payload->getOutput(i) );
     compiler.addOperand(param.getName(),param.getIndex());
   }
-  if (payload->getType() == InjectPayload::EXECUTABLEPCODE_TYPE) {
-    compiler.setUniqueBase(0x2000);	// Don't need to deconflict with anything other injects
-    ExecutablePcodeSleigh *sleighpayload = (ExecutablePcodeSleigh *)payload;
-    istringstream s(sleighpayload->parsestring);
-    if (!compiler.parseStream(s))
-      throw LowlevelError(payload->getSource() + ": Unable to compile pcode: "+compiler.getErrorMessage());
-    sleighpayload->tpl = compiler.releaseResult();
-    sleighpayload->parsestring = "";		// No longer need the memory
-  }
+  compiler.setUniqueBase(uniquebase);
+  istringstream s(*parsestring);
+  if (!compiler.parseStream(s))
+    throw LowlevelError(payload->getSource() + ": Unable to compile pcode: "+compiler.getErrorMessage());
+  InjectCompileRecord record;
+  record.tables = slgh->getTables();
+  record.tpl.reset(compiler.releaseResult());
+  record.uniquebase = compiler.getUniqueBase();
+  if (isExecutable)
+    execpayload->tpl = record.tpl;
   else {
-    compiler.setUniqueBase(tempbase);
-    InjectPayloadSleigh *sleighpayload = (InjectPayloadSleigh *)payload;
-    istringstream s(sleighpayload->parsestring);
-    if (!compiler.parseStream(s))
-      throw LowlevelError(payload->getSource() + ": Unable to compile pcode: "+compiler.getErrorMessage());
-    tempbase = compiler.getUniqueBase();
-    sleighpayload->tpl = compiler.releaseResult();
-    sleighpayload->parsestring = "";		// No longer need the memory
+    tempbase = record.uniquebase;
+    sleighpayload->tpl = record.tpl;
   }
+  *parsestring = "";			// No longer need the memory
+  std::lock_guard<std::mutex> lock(compiledPayloadsMutex);
+  compiledPayloads[key] = record;
 }
 
 int4 PcodeInjectLibrarySleigh::allocateInject(const string &sourceName,const string &name,int4 type)
@@ -39,16 +39,17 @@ public:
 /// The p-code ops for the injection are described using SLEIGH syntax.
 /// This object can hold both the SLEIGH syntax as a string or the p-code templates
 /// (VarnodeTpl and OpTpl) that are prepared for emitting the p-code for the injection.
+/// The templates may be shared with equivalent payloads in other architecture
+/// instances of the same language.
 class InjectPayloadSleigh : public InjectPayload {
   friend class PcodeInjectLibrarySleigh;
-  ConstructTpl *tpl;			///< The VarnodeTpl and OpTpl objects prepared for injection
+  std::shared_ptr<ConstructTpl> tpl;	///< The VarnodeTpl and OpTpl objects prepared for injection (possibly shared)
   string parsestring;			///< SLEIGH syntax describing the injection p-code
   string source;			///< A description of the document containing the SLEIGH syntax
 protected:
   void decodeBody(Decoder &decoder);	///< Parse the \<body> tag
 public:
   InjectPayloadSleigh(const string &src,const string &nm,int4 tp);	///< Constructor for use with decode
-  virtual ~InjectPayloadSleigh(void);
   virtual void inject(InjectContext &context,PcodeEmit &emit) const;
   virtual void decode(Decoder &decoder);
   virtual void printTemplate(ostream &s) const;
@@ -81,10 +82,9 @@ class ExecutablePcodeSleigh : public ExecutablePcode {
   friend class PcodeInjectLibrarySleigh;
 protected:
   string parsestring;		///< SLEIGH syntax describing the p-code snippet
-  ConstructTpl *tpl;		///< Parsed template objects (VarnodeTpl and OpTpl) ready for injection
+  std::shared_ptr<ConstructTpl> tpl;	///< Parsed template objects (VarnodeTpl and OpTpl) ready for injection (possibly shared)
  public:
   ExecutablePcodeSleigh(Architecture *g,const string &src,const string &nm);
-  virtual ~ExecutablePcodeSleigh(void);
   virtual void inject(InjectContext &context,PcodeEmit &emit) const;
   virtual void decode(Decoder &decoder);
   virtual void printTemplate(ostream &s) const;
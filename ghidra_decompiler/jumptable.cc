@@ -17,6 +17,8 @@
 #include "emulate.hh"
 #include "flow.hh"
 
+#include <chrono>
+
 namespace ghidra {
 
 
@@ -1447,6 +1449,8 @@ void JumpBasic::buildAddresses(Funcdata *fd,PcodeOp *indop,vector<Address> &addr
   }
   AddrSpace *spc = indop->getAddr().getSpace();
   bool notdone = jrange->initializeForReading();
+  int4 count = 0;
+  std::chrono::steady_clock::time_point starttime = std::chrono::steady_clock::now();
   while(notdone) {
     val = jrange->getValue();
     addr = emul.emulatePath(val,pathMeld,jrange->getStartOp(),jrange->getStartVarnode());
@@ -1455,6 +1459,17 @@ void JumpBasic::buildAddresses(Funcdata *fd,PcodeOp *indop,vector<Address> &addr
     addresstable.push_back(Address(spc,addr));
     if (loadcounts != (vector<int4> *)0)
       loadcounts->push_back(loadpoints->size());
+    count += 1;
+    if ((count & 0xff) == 0) {	// Periodically check the emulation budget
+      int8 elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+	  std::chrono::steady_clock::now() - starttime).count();
+      if (elapsed > emulation_budget_ms) {
+	// Degrade to a truncated table rather than stalling on an obfuscated switch
+	jrange->truncate(count);
+	fd->warning("Jumptable emulation exceeded time budget: table truncated",indop->getAddr());
+	break;
+      }
+    }
     notdone = jrange->next();
   }
 }
@@ -2700,7 +2715,7 @@ void JumpTable::matchModel(Funcdata *fd)
     if ((addresstable.size()==1)&&(jmodel->getTableSize() > 1)) {
       // The jumptable was not fully recovered during flow analysis, try to issue a restart
       fd->getOverride().insertMultistageJump(opaddress);
-      fd->setRestartPending(true);
+      fd->setRestartPending(true,Funcdata::cause_jumptable);
       return;
     }
     fd->warning("Could not find normalized switch variable to match jumptable",opaddress);
@@ -2758,6 +2773,28 @@ void JumpTable::clear(void)
   // -opaddress- -maxtablesize- -maxaddsub- -maxleftright- -maxext- -collectloads- are permanent
 }
 
+/// Strip \b this back to the same state decode() would produce:  the recovered address
+/// table and any load points are kept, while the model, labels, block mappings, and the
+/// attached PcodeOp, all of which refer to a particular Funcdata instance, are thrown out.
+/// After a restart, the retained addresses are revalidated cheaply via matchModel()
+/// rather than rerunning the full emulation in recoverAddresses().
+void JumpTable::clearForRestart(void)
+
+{
+  clearSavedModel();
+  if (jmodel != (JumpModel *)0) {
+    delete jmodel;
+    jmodel = (JumpModel *)0;
+  }
+  block2addr.clear();
+  lastBlock = -1;
+  label.clear();
+  indirect = (PcodeOp *)0;
+  switchVarConsume = ~((uintb)0);
+  defaultBlock = -1;
+  // -addresstable- and -loadpoints- are retained for revalidation
+}
+
 /// The recovered addresses and case labels are encode to the stream.
 /// If override information is present, this is also incorporated into the element.
 /// \param encoder is the stream encoder
@@ -371,6 +371,7 @@ public:
 ///   - The unnormalized switch variable is recovered from the normalized variable through some basic transforms
 class JumpBasic : public JumpModel {
 protected:
+  static const int4 emulation_budget_ms = 1000;	///< Wall-clock budget for emulating all table entries
   JumpValuesRange *jrange;		///< Range of values for the (normalized) switch variable
   PathMeld pathMeld;			///< Set of PcodeOps and Varnodes producing the final target addresses
   vector<GuardRecord> selectguards;	///< Any guards associated with \b model
@@ -618,6 +619,7 @@ public:
   void recoverLabels(Funcdata *fd);		///< Recover the case labels for \b this jump-table
   bool checkForMultistage(Funcdata *fd);	///< Check if this jump-table requires an additional recovery stage
   void clear(void);				///< Clear instance specific data for \b this jump-table
+  void clearForRestart(void);			///< Clear instance specific data but keep recovered addresses
   void encode(Encoder &encoder) const;		///< Encode \b this jump-table as a \<jumptable> element
   void decode(Decoder &decoder);		///< Decode \b this jump-table from a \<jumptable> element
 };
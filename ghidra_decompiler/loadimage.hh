@@ -99,6 +99,7 @@ public:
   virtual void closeSectionInfo(void) const; ///< Stop reading section info
   virtual bool getNextSection(LoadImageSection &sec) const; ///< Get info on the next section
   virtual void getReadonly(RangeList &list) const; ///< Return list of \e readonly address ranges
+  virtual bool isExecutableAddress(const Address &addr) const; ///< Can the given address hold instructions
   virtual string getArchType(void) const=0; ///< Get a string indicating the architecture type
   virtual void adjustVma(long adjust)=0; ///< Adjust load addresses with a global offset
   uint1 *load(int4 size,const Address &addr);	///< Load a chunk of image
@@ -200,6 +201,17 @@ inline bool LoadImage::getNextSection(LoadImageSection &record) const {
 inline void LoadImage::getReadonly(RangeList &list) const {
 }
 
+/// Load images that know their section permissions can report
+/// whether an address may legally hold instructions.  Control-flow
+/// following uses this to truncate flow that leads into data
+/// regions, rather than decoding arbitrary bytes.  The default
+/// implementation places no restriction on the image.
+/// \param addr is the given address
+/// \return \b true if the address can hold instructions
+inline bool LoadImage::isExecutableAddress(const Address &addr) const {
+  return true;
+}
+
 /// \fn void LoadImage::adjustVma(long adjust)
 /// Most load image formats automatically encode information
 /// about the true loading address(es) for the data in the image.
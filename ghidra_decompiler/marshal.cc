@@ -695,12 +695,29 @@ void PackedDecode::endIngest(int4 bufPos)
 PackedDecode::~PackedDecode(void)
 
 {
+  if (!bufferOwned) return;
   list<ByteChunk>::const_iterator iter;
   for(iter=inStream.begin();iter!=inStream.end();++iter) {
     delete [] (*iter).start;
   }
 }
 
+/// The bytes are used in place as the entire input stream; no copy is made and
+/// the caller retains ownership of (and must outlive) the buffer.  The final
+/// byte of the buffer must already be an ELEMENT_END terminator, as normally
+/// appended by endIngest().
+/// \param ptr is the start of the buffer
+/// \param sz is the number of bytes in the buffer, including the terminator
+void PackedDecode::ingestBytes(uint1 *ptr,int4 sz)
+
+{
+  inStream.emplace_back(ptr,ptr + sz);
+  bufferOwned = false;
+  endPos.seqIter = inStream.begin();
+  endPos.current = ptr;
+  endPos.end = ptr + sz;
+}
+
 void PackedDecode::ingestStream(istream &s)
 
 {
@@ -713,6 +730,19 @@ void PackedDecode::ingestStream(istream &s)
   endIngest(gcount);
 }
 
+/// The position returned is only valid between elements: immediately before a
+/// peekElement(), openElement(), or after the matching closeElement() or
+/// closeElementSkipping().  A decoder that buffered its input itself, or whose
+/// input spans multiple chunks, returns null.
+/// \return the read position, or null if the input is not a contiguous buffer
+uint1 *PackedDecode::getReadPosition(void) const
+
+{
+  if (bufferOwned || inStream.size() != 1)
+    return (uint1 *)0;
+  return endPos.current;
+}
+
 uint4 PackedDecode::peekElement(void)
 
 {
@@ -1062,11 +1092,15 @@ OpCode PackedDecode::readOpcode(AttributeId &attribId)
 /// This method then fills in the length code, outputs the full type header and the encoded bytes of the integer.
 /// \param typeByte is the type header
 /// \param val is the integer value
-void PackedEncode::writeInteger(uint1 typeByte,uint8 val)
+/// \brief Compute the packed length code for an integer value
+///
+/// \param val is the integer value to be encoded
+/// \param sa will hold the shift amount of the most significant 7-bit piece
+/// \return the length code to be folded into the type byte
+static uint1 encodedIntegerLength(uint8 val,int4 &sa)
 
 {
   uint1 lenCode;
-  int4 sa;
   if (val == 0) {
     lenCode = 0;
     sa = -1;
@@ -1119,7 +1153,14 @@ void PackedEncode::writeInteger(uint1 typeByte,uint8 val)
       sa = 9*RAWDATA_BITSPERBYTE;
     }
   }
-  typeByte |= lenCode;
+  return lenCode;
+}
+
+void PackedEncode::writeInteger(uint1 typeByte,uint8 val)
+
+{
+  int4 sa;
+  typeByte |= encodedIntegerLength(val, sa);
   outStream.put(typeByte);
   for(;sa >= 0;sa -= RAWDATA_BITSPERBYTE) {
     uint1 piece = (val >> sa) & RAWDATA_MASK;
@@ -1224,6 +1265,115 @@ void PackedEncode::writeOpcode(const AttributeId &attribId,OpCode opc)
   writeInteger((TYPECODE_SIGNEDINT_POSITIVE << TYPECODE_SHIFT), opc);
 }
 
+void PackedEncodeBuffer::writeInteger(uint1 typeByte,uint8 val)
+
+{
+  int4 sa;
+  typeByte |= encodedIntegerLength(val, sa);
+  outBuffer.push_back(typeByte);
+  for(;sa >= 0;sa -= RAWDATA_BITSPERBYTE) {
+    uint1 piece = (val >> sa) & RAWDATA_MASK;
+    piece |= RAWDATA_MARKER;
+    outBuffer.push_back(piece);
+  }
+}
+
+void PackedEncodeBuffer::openElement(const ElementId &elemId)
+
+{
+  writeHeader(ELEMENT_START, elemId.getId());
+}
+
+void PackedEncodeBuffer::closeElement(const ElementId &elemId)
+
+{
+  writeHeader(ELEMENT_END, elemId.getId());
+}
+
+void PackedEncodeBuffer::writeBool(const AttributeId &attribId,bool val)
+
+{
+  writeHeader(ATTRIBUTE, attribId.getId());
+  uint1 typeByte = val ? ((TYPECODE_BOOLEAN << TYPECODE_SHIFT) | 1) : (TYPECODE_BOOLEAN << TYPECODE_SHIFT);
+  outBuffer.push_back(typeByte);
+}
+
+void PackedEncodeBuffer::writeSignedInteger(const AttributeId &attribId,intb val)
+
+{
+  writeHeader(ATTRIBUTE, attribId.getId());
+  uint1 typeByte;
+  uint8 num;
+  if (val < 0) {
+    typeByte = (TYPECODE_SIGNEDINT_NEGATIVE << TYPECODE_SHIFT);
+    num = -val;
+  }
+  else {
+    typeByte = (TYPECODE_SIGNEDINT_POSITIVE << TYPECODE_SHIFT);
+    num = val;
+  }
+  writeInteger(typeByte, num);
+}
+
+void PackedEncodeBuffer::writeUnsignedInteger(const AttributeId &attribId,uintb val)
+
+{
+  writeHeader(ATTRIBUTE, attribId.getId());
+  writeInteger((TYPECODE_UNSIGNEDINT << TYPECODE_SHIFT),val);
+}
+
+void PackedEncodeBuffer::writeString(const AttributeId &attribId,const string &val)
+
+{
+  uint8 length = val.length();
+  writeHeader(ATTRIBUTE, attribId.getId());
+  writeInteger((TYPECODE_STRING << TYPECODE_SHIFT), length);
+  outBuffer.append(val.c_str(), length);
+}
+
+void PackedEncodeBuffer::writeStringIndexed(const AttributeId &attribId,uint4 index,const string &val)
+
+{
+  uint8 length = val.length();
+  writeHeader(ATTRIBUTE, attribId.getId() + index);
+  writeInteger((TYPECODE_STRING << TYPECODE_SHIFT), length);
+  outBuffer.append(val.c_str(), length);
+}
+
+void PackedEncodeBuffer::writeSpace(const AttributeId &attribId,const AddrSpace *spc)
+
+{
+  writeHeader(ATTRIBUTE, attribId.getId());
+  switch(spc->getType()) {
+    case IPTR_FSPEC:
+      outBuffer.push_back((TYPECODE_SPECIALSPACE << TYPECODE_SHIFT) | SPECIALSPACE_FSPEC);
+      break;
+    case IPTR_IOP:
+      outBuffer.push_back((TYPECODE_SPECIALSPACE << TYPECODE_SHIFT) | SPECIALSPACE_IOP);
+      break;
+    case IPTR_JOIN:
+      outBuffer.push_back((TYPECODE_SPECIALSPACE << TYPECODE_SHIFT) | SPECIALSPACE_JOIN);
+      break;
+   case IPTR_SPACEBASE:
+     if (spc->isFormalStackSpace())
+       outBuffer.push_back((TYPECODE_SPECIALSPACE << TYPECODE_SHIFT) | SPECIALSPACE_STACK);
+     else
+       outBuffer.push_back((TYPECODE_SPECIALSPACE << TYPECODE_SHIFT) | SPECIALSPACE_SPACEBASE);	// A secondary register offset space
+     break;
+   default:
+    uint8 spcId = spc->getIndex();
+    writeInteger((TYPECODE_ADDRESSSPACE << TYPECODE_SHIFT), spcId);
+    break;
+  }
+}
+
+void PackedEncodeBuffer::writeOpcode(const AttributeId &attribId,OpCode opc)
+
+{
+  writeHeader(ATTRIBUTE, attribId.getId());
+  writeInteger((TYPECODE_SIGNEDINT_POSITIVE << TYPECODE_SHIFT), opc);
+}
+
 // Common attributes.  Attributes with multiple uses
 AttributeId ATTRIB_CONTENT = AttributeId("XMLcontent",1);
 AttributeId ATTRIB_ALIGN = AttributeId("align",2);
@@ -1254,7 +1404,7 @@ AttributeId ATTRIB_WORDSIZE = AttributeId("wordsize",26);
 AttributeId ATTRIB_STORAGE = AttributeId("storage",149);
 AttributeId ATTRIB_STACKSPILL = AttributeId("stackspill",150);
 
-AttributeId ATTRIB_UNKNOWN = AttributeId("XMLunknown",152); // Number serves as next open index
+AttributeId ATTRIB_UNKNOWN = AttributeId("XMLunknown",153); // Number serves as next open index
 
 ElementId ELEM_DATA = ElementId("data",1);
 ElementId ELEM_INPUT = ElementId("input",2);
@@ -1267,6 +1417,6 @@ ElementId ELEM_VAL = ElementId("val",8);
 ElementId ELEM_VALUE = ElementId("value",9);
 ElementId ELEM_VOID = ElementId("void",10);
 
-ElementId ELEM_UNKNOWN = ElementId("XMLunknown",288); // Number serves as next open index
+ElementId ELEM_UNKNOWN = ElementId("XMLunknown",294); // Number serves as next open index
 
 } // End namespace ghidra
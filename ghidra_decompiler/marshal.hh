@@ -292,6 +292,15 @@ public:
     uint4 elemId = openElement();
     closeElementSkipping(elemId);
   }
+
+  /// \brief Get a pointer to the current read position in the input stream
+  ///
+  /// Only a decoder drawing from a single caller-owned contiguous buffer returns a
+  /// non-null pointer; for such a decoder the underlying bytes outlive the decoder
+  /// itself, so the pointer, together with closeElementSkipping(), lets a caller
+  /// record the raw extent of an element and decode it lazily later.
+  /// \return the read position, or null if the input is not a contiguous buffer
+  virtual uint1 *getReadPosition(void) const { return (uint1 *)0; }
 };
 
 /// \brief A class for writing structured data to a stream
@@ -529,6 +538,7 @@ private:
     uint1 *end;					///< End of current sequence
   };
   list<ByteChunk> inStream;		///< Incoming raw data as a sequence of byte arrays
+  bool bufferOwned = true;		///< True if the bytes in \b inStream are owned (and freed) by \b this
   Position startPos;			///< Position at the start of the current open element
   Position curPos;			///< Position of the next attribute as returned by getNextAttributeId
   Position endPos;			///< Ending position after all attributes in current open element
@@ -549,6 +559,8 @@ public:
   PackedDecode(const AddrSpaceManager *spcManager) : Decoder(spcManager) {}	///< Constructor
   virtual ~PackedDecode(void);
   virtual void ingestStream(istream &s);
+  void ingestBytes(uint1 *ptr,int4 sz);	///< Use a caller-owned buffer as the input stream, without copying
+  virtual uint1 *getReadPosition(void) const;
   virtual uint4 peekElement(void);
   virtual uint4 openElement(void);
   virtual uint4 openElement(const ElementId &elemId);
@@ -593,6 +605,30 @@ public:
   virtual void writeOpcode(const AttributeId &attribId,OpCode opc);
 };
 
+/// \brief A byte-based encoder writing into a flat in-memory buffer
+///
+/// The output format is identical to PackedEncode, but bytes are appended to a
+/// caller-provided string rather than passing through a stream, avoiding the
+/// per-byte streambuf overhead.  The buffer can be reserved in advance and
+/// moved directly into its final destination, e.g. a protobuf \e bytes field,
+/// so bulk serialization costs a single allocation.
+class PackedEncodeBuffer : public Encoder {
+  string &outBuffer;			///< The buffer receiving the encoded data
+  void writeHeader(uint1 header,uint4 id);	///< Write a header, element or attribute, to the buffer
+  void writeInteger(uint1 typeByte,uint8 val);	///< Write an integer value to the buffer
+public:
+  PackedEncodeBuffer(string &s) : outBuffer(s) {}	///< Construct from a buffer
+  virtual void openElement(const ElementId &elemId);
+  virtual void closeElement(const ElementId &elemId);
+  virtual void writeBool(const AttributeId &attribId,bool val);
+  virtual void writeSignedInteger(const AttributeId &attribId,intb val);
+  virtual void writeUnsignedInteger(const AttributeId &attribId,uintb val);
+  virtual void writeString(const AttributeId &attribId,const string &val);
+  virtual void writeStringIndexed(const AttributeId &attribId,uint4 index,const string &val);
+  virtual void writeSpace(const AttributeId &attribId,const AddrSpace *spc);
+  virtual void writeOpcode(const AttributeId &attribId,OpCode opc);
+};
+
 /// An exception is thrown if the position currently points to the last byte in the stream
 /// \param pos is the position in the stream to look ahead from
 /// \return the next byte
@@ -674,6 +710,24 @@ inline void PackedEncode::writeHeader(uint1 header,uint4 id)
   }
 }
 
+/// \param header is the type of header
+/// \param id is the id associated with the element or attribute
+inline void PackedEncodeBuffer::writeHeader(uint1 header,uint4 id)
+
+{
+  if (id > 0x1f) {
+    header |= PackedFormat::HEADEREXTEND_MASK;
+    header |= (id >> PackedFormat::RAWDATA_BITSPERBYTE);
+    uint1 extendByte = (id & PackedFormat::RAWDATA_MASK) | PackedFormat::RAWDATA_MARKER;
+    outBuffer.push_back(header);
+    outBuffer.push_back(extendByte);
+  }
+  else {
+    header |= id;
+    outBuffer.push_back(header);
+  }
+}
+
 extern ElementId ELEM_UNKNOWN;		///< Special element to represent an element with an unrecognized name
 extern AttributeId ATTRIB_UNKNOWN;	///< Special attribute  to represent an attribute with an unrecognized name
 extern AttributeId ATTRIB_CONTENT;	///< Special attribute for XML text content of an element
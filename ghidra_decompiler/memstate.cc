@@ -416,6 +416,46 @@ MemoryImage::MemoryImage(AddrSpace *spc,int4 ws,int4 ps,LoadImage *ld)
 /// cached page.
 /// \param addr is the aligned address of the word to be written
 /// \param val is the value to be written at that word
+std::mutex MemoryPageOverlay::poolLock;
+map<int4,vector<uint1 *> > MemoryPageOverlay::pagePool;
+const int4 MemoryPageOverlay::POOL_MAX = 256;
+
+/// A buffer is pulled from the pool matching \b this bank's page size, or
+/// allocated fresh if the pool is empty.  The contents are uninitialized;
+/// callers fill the page from the underlying bank or with zeros.
+/// \return the page buffer
+uint1 *MemoryPageOverlay::allocPage(void)
+
+{
+  {
+    std::lock_guard<std::mutex> lock(poolLock);
+    vector<uint1 *> &pool( pagePool[getPageSize()] );
+    if (!pool.empty()) {
+      uint1 *ptr = pool.back();
+      pool.pop_back();
+      return ptr;
+    }
+  }
+  return new uint1[getPageSize()];
+}
+
+/// Overlayed pages return to the shared pool (up to a bound per page size)
+/// so the next emulation run reuses them instead of hitting the allocator.
+void MemoryPageOverlay::clear(void)
+
+{
+  map<uintb,uint1 *>::iterator iter;
+  std::lock_guard<std::mutex> lock(poolLock);
+  vector<uint1 *> &pool( pagePool[getPageSize()] );
+  for(iter=page.begin();iter!=page.end();++iter) {
+    if ((int4)pool.size() < POOL_MAX)
+      pool.push_back((*iter).second);
+    else
+      delete [] (*iter).second;
+  }
+  page.clear();
+}
+
 void MemoryPageOverlay::insert(uintb addr,uintb val)
 
 {
@@ -428,7 +468,7 @@ void MemoryPageOverlay::insert(uintb addr,uintb val)
   if (iter != page.end())
     pageptr = (*iter).second;
   else {
-    pageptr = new uint1[getPageSize()];
+    pageptr = allocPage();
     page[pageaddr] = pageptr;
     if (underlie == (MemoryBank *)0) {
       for(int4 i=0;i<getPageSize();++i)
@@ -507,7 +547,7 @@ void MemoryPageOverlay::setPage(uintb addr,const uint1 *val,int4 skip,int4 size)
 
   iter = page.find(addr);
   if (iter == page.end()) {
-    pageptr = new uint1[getPageSize()];
+    pageptr = allocPage();
     page[addr] = pageptr;
     if (size != getPageSize()) {
       if (underlie == (MemoryBank *)0) {
@@ -539,21 +579,45 @@ MemoryPageOverlay::MemoryPageOverlay(AddrSpace *spc,int4 ws,int4 ps,MemoryBank *
 MemoryPageOverlay::~MemoryPageOverlay(void)
 
 {
-  map<uintb,uint1 *>::iterator iter;
+  clear();
+}
+
+/// All entries are rehashed into a larger table.  Because the number of slots is
+/// always a power of two, the hash is a mask of the aligned address.
+/// \param newsize is the new number of slots (must be a power of 2)
+void MemoryHashOverlay::resize(int4 newsize)
 
-  for(iter=page.begin();iter!=page.end();++iter)
-    delete [] (*iter).second;
+{
+  vector<uintb> oldaddress;
+  vector<uintb> oldvalue;
+  oldaddress.swap(address);
+  oldvalue.swap(value);
+  address.assign(newsize,0xBADBEEF);
+  value.assign(newsize,0);
+  for(int4 i=0;i<oldaddress.size();++i) {
+    if (oldaddress[i] == (uintb)0xBADBEEF) continue;
+    uintb offset = (oldaddress[i]>>alignshift) & (newsize-1);
+    while(address[offset] != (uintb)0xBADBEEF)
+      offset = (offset + 1) & (newsize - 1);
+    address[offset] = oldaddress[i];
+    value[offset] = oldvalue[i];
+  }
 }
 
-/// Write the value into the hashtable, using \b addr as a key.
+/// Write the value into the hashtable, using \b addr as a key.  The table grows
+/// before it becomes half full, keeping probe sequences short.
 /// \param addr is the aligned address of the word being written
 /// \param val is the value of the word to write
 void MemoryHashOverlay::insert(uintb addr,uintb val)
 
 {
   int4 size = address.size();
-  uintb offset = (addr>>alignshift) % size;
-  for(int4 i=0;i<size;++i) {
+  if ((used + 1) * 2 >= size) {
+    resize(size * 2);
+    size = address.size();
+  }
+  uintb offset = (addr>>alignshift) & (size-1);
+  for(;;) {
     if (address[offset] == addr) { // Address has been seen before
       value[offset] = val;	   // Replace old value
       return;
@@ -561,11 +625,11 @@ void MemoryHashOverlay::insert(uintb addr,uintb val)
     else if (address[offset] == (uintb)0xBADBEEF) { // Address not seen before
       address[offset] = addr;			    // Claim this hash slot
       value[offset] = val;			    // Set value
+      used += 1;
       return;
     }
-    offset = (offset + collideskip) % size;
+    offset = (offset + 1) & (size - 1);
   }
-  throw LowlevelError("Memory state hash_table is full");
 }
 
 /// First search for an entry in the hashtable using \b addr as a key.  If there is no
@@ -576,13 +640,13 @@ uintb MemoryHashOverlay::find(uintb addr) const
 
 { // Find address in hash-table, or return find from underlying memory
   int4 size = address.size();
-  uintb offset = (addr>>alignshift) % size;
-  for(int4 i=0;i<size;++i) {
+  uintb offset = (addr>>alignshift) & (size-1);
+  for(;;) {
     if (address[offset] == addr) // Address has been seen before
       return value[offset];
-    else if (address[offset] == 0xBADBEEF) // Address not seen before
+    else if (address[offset] == (uintb)0xBADBEEF) // Address not seen before
       break;
-    offset = (offset + collideskip) % size;
+    offset = (offset + 1) & (size - 1);
   }
 
   // We didn't find the address in the hashtable
@@ -597,13 +661,19 @@ uintb MemoryHashOverlay::find(uintb addr) const
 /// \param spc is the address space associated with the memory bank
 /// \param ws is the number of bytes in the preferred wordsize (must be power of 2)
 /// \param ps is the number of bytes in a page (must be a power of 2)
-/// \param hashsize is the maximum number of entries in the hashtable
+/// \param hashsize is the initial number of entries in the hashtable (rounded up to a power of 2)
 /// \param ul is the underlying memory bank being overlayed
 MemoryHashOverlay::MemoryHashOverlay(AddrSpace *spc,int4 ws,int4 ps,int4 hashsize,MemoryBank *ul)
-  : MemoryBank(spc,ws,ps), address(hashsize,0xBADBEEF), value(hashsize,0)
+  : MemoryBank(spc,ws,ps)
 {
   underlie = ul;
-  collideskip = 1023;
+  used = 0;
+
+  int4 slots = 64;		// Minimum number of slots
+  while(slots < hashsize)
+    slots <<= 1;
+  address.assign(slots,0xBADBEEF);
+  value.assign(slots,0);
 
   uint4 tmp = ws - 1;
   alignshift = 0;
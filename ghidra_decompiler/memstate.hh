@@ -21,6 +21,7 @@
 
 #include "pcoderaw.hh"
 #include "loadimage.hh"
+#include <mutex>
 
 namespace ghidra {
 
@@ -109,9 +110,17 @@ public:
 /// a write. The underlying access routines are overridden to make optimal use
 /// of this page implementation.  The underlying memory bank can be a \b null pointer
 /// in which case, this memory bank behaves as if it were initially filled with zeros.
+///
+/// Page buffers are recycled through a process-wide pool rather than freed, so
+/// emulation runs that build and tear down state repeatedly (switch recovery on
+/// dispatcher-heavy binaries) stop exercising the allocator.
 class MemoryPageOverlay : public MemoryBank {
+  static std::mutex poolLock;			///< Guards the shared page buffer pool
+  static map<int4,vector<uint1 *> > pagePool;	///< Recycled page buffers, grouped by page size
+  static const int4 POOL_MAX;			///< Maximum buffers retained per page size
   MemoryBank *underlie;		///< Underlying memory object
   map<uintb,uint1 *> page;	///< Overlayed pages
+  uint1 *allocPage(void);	///< Get a page buffer, preferably recycled
 protected:
   virtual void insert(uintb addr,uintb val); ///< Overridden aligned word insert
   virtual uintb find(uintb addr) const;	///< Overridden aligned word find
@@ -120,6 +129,7 @@ protected:
 public:
   MemoryPageOverlay(AddrSpace *spc,int4 ws,int4 ps,MemoryBank *ul); ///< Constructor for page overlay
   virtual ~MemoryPageOverlay(void);
+  void clear(void);		///< Drop all overlayed pages, recycling their buffers
 };
 
 /// \brief A memory bank that implements reads and writes using a hash table.
@@ -127,12 +137,17 @@ public:
 /// The initial state of the
 /// bank is taken from an \e underlying memory bank or is all zero, if this bank is initialized with
 /// a \b null pointer.  This implementation will not be very efficient for accessing entire pages.
+///
+/// The table is open addressed with linear probing over a power-of-two number of slots,
+/// with values stored inline, so the common access is a masked index and a short scan of
+/// adjacent slots.  The table doubles itself when half full rather than ever filling up.
 class MemoryHashOverlay : public MemoryBank {
   MemoryBank *underlie;		///< Underlying memory bank
   int4 alignshift;		///< How many LSBs are thrown away from address when doing hash table lookup
-  uintb collideskip;		///< How many slots to skip after a hashtable collision
+  int4 used;			///< Number of hashtable slots holding a value
   vector<uintb> address;	///< The hashtable addresses
   vector<uintb> value;		///< The hashtable values
+  void resize(int4 newsize);	///< Grow the hashtable to the given number of slots
 protected:
   virtual void insert(uintb addr,uintb val); ///< Overridden aligned word insert
   virtual uintb find(uintb addr) const;	///< Overridden aligned word find
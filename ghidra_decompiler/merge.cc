@@ -263,18 +263,36 @@ bool Merge::mergeTestBasic(Varnode *vn)
   return true;
 }
 
+/// \brief Get the index of the last basic block covered by the given HighVariable
+///
+/// \param high is the given HighVariable
+/// \return the maximal covered block index, or -1 if the Cover is empty
+int4 Merge::lastCoverBlock(const HighVariable *high)
+
+{
+  map<int4,CoverBlock>::const_iterator iter = high->getCover().end();
+  if (iter == high->getCover().begin()) return -1;
+  --iter;
+  return (*iter).first;
+}
+
 /// \brief Speculatively merge all HighVariables in the given list as well as possible
 ///
-/// The variables are first sorted by the index of the earliest block in their range.
-/// Then proceeding in order, an attempt is made to merge each variable with the first.
-/// The attempt fails if the \e speculative test doesn't pass or if there are Cover
-/// intersections, in which case that particular merge is skipped.
+/// The variables are sorted by the index of the earliest block in their range, then
+/// processed as a single sweep over block indices.  Accumulated candidates whose range
+/// ends before the sweep point are \e retired: their Cover cannot intersect the current
+/// variable or anything after it, so merging with one of them only requires the cheap
+/// speculative flag tests.  The expensive Cover intersection tests are reserved for the
+/// \e active candidates whose block range overlaps the current variable.
 void Merge::mergeLinear(vector<HighVariable *> &highvec)
 
 {
-  vector<HighVariable *> highstack;
-  vector<HighVariable *>::iterator initer,outiter;
+  vector<HighVariable *>::iterator initer;
+  vector<HighVariable *> active;	// Candidates whose block range overlaps the sweep point
+  vector<int4> activelast;		// Last covered block index for each active candidate
+  vector<HighVariable *> retired;	// Candidates whose block range the sweep point has passed
   HighVariable *high;
+  int4 i,pos;
 
   if (highvec.size() <= 1) return;
   for(initer=highvec.begin();initer!=highvec.end();++initer)
@@ -282,12 +300,46 @@ void Merge::mergeLinear(vector<HighVariable *> &highvec)
   sort(highvec.begin(),highvec.end(),compareHighByBlock);
   for(initer=highvec.begin();initer!=highvec.end();++initer) {
     high = *initer;
-    for(outiter=highstack.begin();outiter!=highstack.end();++outiter) {
-      if (mergeTestSpeculative(*outiter,high))
-	if (merge(*outiter,high,true)) break;
+    map<int4,CoverBlock>::const_iterator citer = high->getCover().begin();
+    int4 firstblock = (citer == high->getCover().end()) ? -1 : (*citer).first;
+    pos = 0;
+    for(i=0;i<active.size();++i) {	// Retire candidates ending before the sweep point
+      if (activelast[i] < firstblock)
+	retired.push_back(active[i]);
+      else {
+	active[pos] = active[i];
+	activelast[pos] = activelast[i];
+	pos += 1;
+      }
+    }
+    active.resize(pos);
+    activelast.resize(pos);
+    bool merged = false;
+    for(i=0;i<active.size();++i) {	// Overlapping candidates require the full intersection test
+      if (mergeTestSpeculative(active[i],high)) {
+	if (merge(active[i],high,true)) {
+	  activelast[i] = lastCoverBlock(active[i]);
+	  merged = true;
+	  break;
+	}
+      }
+    }
+    if (!merged) {
+      for(i=0;i<retired.size();++i) {	// Retired Covers are block disjoint; only flag tests can fail
+	HighVariable *out = retired[i];
+	if (mergeTestSpeculative(out,high) && merge(out,high,true)) {
+	  retired.erase(retired.begin()+i);	// Candidate's range now extends past the sweep point
+	  active.push_back(out);
+	  activelast.push_back(lastCoverBlock(out));
+	  merged = true;
+	  break;
+	}
+      }
+    }
+    if (!merged) {
+      active.push_back(high);
+      activelast.push_back(lastCoverBlock(high));
     }
-    if (outiter==highstack.end())
-      highstack.push_back(high);
   }
 }
 
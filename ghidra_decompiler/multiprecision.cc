@@ -17,6 +17,101 @@
 
 namespace ghidra {
 
+#ifdef __SIZEOF_INT128__
+
+// The compiler provides a native 128-bit integer type.  Implement the operations
+// directly on it, which compiles down to a handful of instructions, rather than
+// through the portable limb-array code below.
+
+/// \brief Assemble a native 128-bit value from 2 64-bit words
+///
+/// \param in is the 128-bit value (as 2 64-bit words)
+/// \return the value as a native 128-bit integer
+static inline unsigned __int128 get_u128(const uint8 *in)
+
+{
+  return ((unsigned __int128)in[1] << 64) | in[0];
+}
+
+/// \brief Split a native 128-bit value into 2 64-bit words
+///
+/// \param out will hold the 2 64-bit words
+/// \param val is the native 128-bit value
+static inline void put_u128(uint8 *out,unsigned __int128 val)
+
+{
+  out[0] = (uint8)val;
+  out[1] = (uint8)(val >> 64);
+}
+
+/// \param in is the 128-bit input (as 2 64-bit words)
+/// \param out will hold the 128-bit result
+/// \param sa is the number of bits to shift
+void leftshift128(uint8 *in,uint8 *out,int4 sa)
+
+{
+  if (sa >= 128) {
+    out[0] = 0;
+    out[1] = 0;
+    return;
+  }
+  put_u128(out,get_u128(in) << sa);
+}
+
+/// \param in1 is the first 128-bit value (as 2 64-bit words) to compare
+/// \param in2 is the second 128-bit value
+/// \return \b true if the first value is less than the second value
+bool uless128(uint8 *in1,uint8 *in2)
+
+{
+  return get_u128(in1) < get_u128(in2);
+}
+
+/// \param in1 is the first 128-bit value (as 2 64-bit words) to compare
+/// \param in2 is the second 128-bit value
+/// \return \b true if the first value is less than or equal to the second value
+bool ulessequal128(uint8 *in1,uint8 *in2)
+
+{
+  return get_u128(in1) <= get_u128(in2);
+}
+
+/// \param in1 is the first 128-bit value (as 2 64-bit words) to add
+/// \param in2 is the second 128-bit value to add
+/// \param out will hold the 128-bit result
+void add128(uint8 *in1,uint8 *in2,uint8 *out)
+
+{
+  put_u128(out,get_u128(in1) + get_u128(in2));
+}
+
+/// \param in1 is the first 128-bit value (as 2 64-bit words)
+/// \param in2 is the second 128-bit value to subtract
+/// \param out will hold the 128-bit result
+void subtract128(uint8 *in1,uint8 *in2,uint8 *out)
+
+{
+  put_u128(out,get_u128(in1) - get_u128(in2));
+}
+
+/// \param numer holds the 2 64-bit words of the numerator
+/// \param denom holds the 2 words of the denominator
+/// \param quotient_res will hold the 2 words of the quotient
+/// \param remainder_res will hold the 2 words of the remainder
+void udiv128(uint8 *numer,uint8 *denom,uint8 *quotient_res,uint8 *remainder_res)
+
+{
+  unsigned __int128 d = get_u128(denom);
+  if (d == 0) {
+    throw LowlevelError("divide by 0");
+  }
+  unsigned __int128 n = get_u128(numer);
+  put_u128(quotient_res,n / d);
+  put_u128(remainder_res,n % d);
+}
+
+#else
+
 extern int4 count_leading_zeros(uintb val);		///< Return the number of leading zero bits in the given value
 
 /// \brief Multi-precision logical left shift by a constant amount
@@ -331,4 +426,6 @@ void udiv128(uint8 *numer,uint8 *denom,uint8 *quotient_res,uint8 *remainder_res)
   pack32_64(2,m-1,remainder_res,u);
 }
 
+#endif
+
 } // End namespace ghidra
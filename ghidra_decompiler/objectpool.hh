@@ -0,0 +1,87 @@
+/* ###
+ * IP: GHIDRA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/// \file objectpool.hh
+/// \brief The ObjectPool slab allocator template
+#ifndef __OBJECTPOOL_HH__
+#define __OBJECTPOOL_HH__
+
+#include "types.h"
+#include <vector>
+
+namespace ghidra {
+
+/// \brief A slab allocator for objects of a single type owned by one container
+///
+/// Objects are carved out of large slabs rather than allocated individually, so
+/// containers that create hundreds of thousands of small objects (Varnode, PcodeOp)
+/// never touch the global heap on their hot path, and concurrent decompilations do
+/// not contend on the process allocator.  allocate() hands out raw storage for one
+/// object, which the container initializes with placement new; destroy() runs the
+/// destructor and recycles the storage.  reset() releases every slab wholesale --
+/// the container must have already destructed all live objects -- making full
+/// teardown proportional to the number of slabs, not the number of objects.
+template<typename _type>
+class ObjectPool {
+  static const int4 SLAB_COUNT = 256;	///< Number of objects in one slab
+  std::vector<char *> slabs;		///< Allocated slabs of raw storage
+  std::vector<_type *> freelist;	///< Destroyed objects available for reuse
+  int4 slabfill;			///< Number of used slots in the most recent slab
+public:
+  ObjectPool(void) { slabfill = SLAB_COUNT; }	///< Construct an empty pool
+  ~ObjectPool(void) { reset(); }		///< Destructor
+
+  /// \brief Obtain raw storage for one object
+  ///
+  /// Storage comes from the free list if possible, then from the current slab.
+  /// \return a pointer to uninitialized storage of the right size and alignment
+  void *allocate(void) {
+    if (!freelist.empty()) {
+      _type *res = freelist.back();
+      freelist.pop_back();
+      return res;
+    }
+    if (slabfill == SLAB_COUNT) {
+      slabs.push_back((char *)::operator new(SLAB_COUNT * sizeof(_type)));
+      slabfill = 0;
+    }
+    void *res = slabs.back() + slabfill * sizeof(_type);
+    slabfill += 1;
+    return res;
+  }
+
+  /// \brief Destruct the given object and recycle its storage
+  ///
+  /// \param obj is the object, which must have come from \b this pool
+  void destroy(_type *obj) {
+    obj->~_type();
+    freelist.push_back(obj);
+  }
+
+  /// \brief Release all slabs at once
+  ///
+  /// The caller must already have run the destructor of every live object,
+  /// either through destroy() or explicitly.
+  void reset(void) {
+    for(int4 i=0;i<slabs.size();++i)
+      ::operator delete(slabs[i]);
+    slabs.clear();
+    freelist.clear();
+    slabfill = SLAB_COUNT;
+  }
+};
+
+} // End namespace ghidra
+#endif
@@ -914,7 +914,7 @@ void PcodeOpBank::clearCodeLists(void)
 PcodeOp *PcodeOpBank::create(int4 inputs,const Address &pc)
 
 {
-  PcodeOp *op = new PcodeOp(inputs,SeqNum(pc,uniqid++));
+  PcodeOp *op = new(pool.allocate()) PcodeOp(inputs,SeqNum(pc,uniqid++));
   optree[op->getSeqNum()] = op;
   op->setFlag(PcodeOp::dead);		// Start out life as dead
   op->insertiter = deadlist.insert(deadlist.end(),op);
@@ -931,7 +931,7 @@ PcodeOp *PcodeOpBank::create(int4 inputs,const SeqNum &sq)
 
 {
   PcodeOp *op;
-  op = new PcodeOp(inputs,sq);
+  op = new(pool.allocate()) PcodeOp(inputs,sq);
   if (sq.getTime() >= uniqid)
     uniqid = sq.getTime() + 1;
 
@@ -955,9 +955,10 @@ void PcodeOpBank::destroyDead(void)
 }
 
 /// The given PcodeOp is removed from all internal lists and added to a final
-/// \e deadandgone list. The memory is not reclaimed until the whole container is
-/// destroyed, in case pointer references still exist.  These will all still
-/// be marked as \e dead.
+/// \e deadandgone list. The memory is not reclaimed immediately, in case pointer
+/// references still exist; it is returned to the pool in bulk at the next quiescent
+/// point (recycleRetired) or when the whole container is cleared.  Until then the
+/// op will still be marked as \e dead.
 /// \param op is the given PcodeOp to destroy
 void PcodeOpBank::destroy(PcodeOp *op)
 
@@ -971,6 +972,18 @@ void PcodeOpBank::destroy(PcodeOp *op)
   deadandgone.push_back(op);
 }
 
+/// Ops accumulated on the \e deadandgone list are destructed, and their storage is
+/// returned to the pool for reuse by subsequent create() calls.  This must only be
+/// called at a quiescent point, once no stale references to retired ops can remain.
+void PcodeOpBank::recycleRetired(void)
+
+{
+  list<PcodeOp *>::iterator iter;
+  for(iter=deadandgone.begin();iter!=deadandgone.end();++iter)
+    pool.destroy(*iter);
+  deadandgone.clear();
+}
+
 /// The PcodeOp is assigned the new op-code, which may involve moving it
 /// between the internal op-code specific lists.
 /// \param op is the given PcodeOp to change
@@ -1170,11 +1183,12 @@ void PcodeOpBank::clear(void)
   list<PcodeOp *>::iterator iter;
 
   for(iter=alivelist.begin();iter!=alivelist.end();++iter)
-    delete *iter;
+    (*iter)->~PcodeOp();	// Storage is reclaimed wholesale by the pool
   for(iter=deadlist.begin();iter!=deadlist.end();++iter)
-    delete *iter;
+    (*iter)->~PcodeOp();
   for(iter=deadandgone.begin();iter!=deadandgone.end();++iter)
-    delete *iter;
+    (*iter)->~PcodeOp();
+  pool.reset();
   optree.clear();
   alivelist.clear();
   deadlist.clear();
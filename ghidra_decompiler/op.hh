@@ -19,6 +19,7 @@
 #define __OP_HH__
 
 #include "typeop.hh"
+#include "objectpool.hh"
 
 namespace ghidra {
 
@@ -297,7 +298,10 @@ typedef map<SeqNum,PcodeOp *> PcodeOpTree;
 /// sequence number (SeqNum). PcodeOps are also grouped into \e alive and \e dead lists
 /// to distinguish between raw p-code ops and those that are fully linked into control-flow.
 /// Several lists group PcodeOps with important op-codes (like STORE and RETURN).
+/// All PcodeOp objects are carved from a pool owned by \b this container, so
+/// creation bypasses the global heap and clear() releases them wholesale.
 class PcodeOpBank {
+  ObjectPool<PcodeOp> pool;		///< Storage pool owning all PcodeOps in the container
   PcodeOpTree optree;			///< The main sequence number sort
   list<PcodeOp *> deadlist;		///< List of \e dead PcodeOps
   list<PcodeOp *> alivelist;		///< List of \e alive PcodeOps
@@ -320,6 +324,7 @@ public:
   PcodeOp *create(int4 inputs,const SeqNum &sq);	///< Create a PcodeOp with a given sequence number
   void destroy(PcodeOp *op);				///< Destroy/retire the given PcodeOp
   void destroyDead(void);				///< Destroy/retire all PcodeOps in the \e dead list
+  void recycleRetired(void);				///< Return storage of retired PcodeOps to the pool
   void changeOpcode(PcodeOp *op,TypeOp *newopc);	///< Change the op-code for the given PcodeOp
   void markAlive(PcodeOp *op);				///< Mark the given PcodeOp as \e alive
   void markDead(PcodeOp *op);				///< Mark the given PcodeOp as \e dead
@@ -18,13 +18,16 @@
 
 namespace ghidra {
 
-/// This routine generates a vector of OpBehavior objects indexed by opcode
-/// \param inst is the vector of behaviors to be filled
-/// \param trans is the translator object needed by the floating point behaviors
-void OpBehavior::registerInstructions(vector<OpBehavior *> &inst,const Translate *trans)
+/// The shared table is constructed exactly once, in a thread-safe manner, the
+/// first time any behavior is requested.  It holds a singleton for every op-code
+/// whose behavior is independent of any particular processor.  The floating-point
+/// op-codes, whose emulation depends on the formats provided by a Translate
+/// object, are left as null entries.
+/// \return the newly constructed table, indexed by op-code
+vector<OpBehavior *> OpBehavior::buildSharedTable(void)
 
 {
-  inst.insert(inst.end(),CPUI_MAX,(OpBehavior *)0);
+  vector<OpBehavior *> inst(CPUI_MAX,(OpBehavior *)0);
 
   inst[CPUI_COPY] = new OpBehaviorCopy();
   inst[CPUI_LOAD] = new OpBehavior(CPUI_LOAD,false,true);
@@ -36,10 +39,8 @@ void OpBehavior::registerInstructions(vector<OpBehavior *> &inst,const Translate
   inst[CPUI_CALLIND] = new OpBehavior(CPUI_CALLIND,false,true);
   inst[CPUI_CALLOTHER] = new OpBehavior(CPUI_CALLOTHER,false,true);
   inst[CPUI_RETURN] = new OpBehavior(CPUI_RETURN,false,true);
-
   inst[CPUI_MULTIEQUAL] = new OpBehavior(CPUI_MULTIEQUAL,false,true);
   inst[CPUI_INDIRECT] = new OpBehavior(CPUI_INDIRECT,false,true);
-
   inst[CPUI_PIECE] = new OpBehaviorPiece();
   inst[CPUI_SUBPIECE] = new OpBehaviorSubpiece();
   inst[CPUI_INT_EQUAL] = new OpBehaviorEqual();
@@ -68,22 +69,55 @@ void OpBehavior::registerInstructions(vector<OpBehavior *> &inst,const Translate
   inst[CPUI_INT_SDIV] = new OpBehaviorIntSdiv();
   inst[CPUI_INT_REM] = new OpBehaviorIntRem();
   inst[CPUI_INT_SREM] = new OpBehaviorIntSrem();
-
   inst[CPUI_BOOL_NEGATE] = new OpBehaviorBoolNegate();
   inst[CPUI_BOOL_XOR] = new OpBehaviorBoolXor();
   inst[CPUI_BOOL_AND] = new OpBehaviorBoolAnd();
   inst[CPUI_BOOL_OR] = new OpBehaviorBoolOr();
-
   inst[CPUI_CAST] = new OpBehavior(CPUI_CAST,false,true);
   inst[CPUI_PTRADD] = new OpBehavior(CPUI_PTRADD,false);
   inst[CPUI_PTRSUB] = new OpBehavior(CPUI_PTRSUB,false);
+  inst[CPUI_SEGMENTOP] = new OpBehavior(CPUI_SEGMENTOP,false,true);
+  inst[CPUI_CPOOLREF] = new OpBehavior(CPUI_CPOOLREF,false,true);
+  inst[CPUI_NEW] = new OpBehavior(CPUI_NEW,false,true);
+  inst[CPUI_INSERT] = new OpBehavior(CPUI_INSERT,false);
+  inst[CPUI_EXTRACT] = new OpBehavior(CPUI_EXTRACT,false);
+  inst[CPUI_POPCOUNT] = new OpBehaviorPopcount();
+  inst[CPUI_LZCOUNT] = new OpBehaviorLzcount();
+
+  for(int4 i=0;i<CPUI_MAX;++i) {
+    if (inst[i] != (OpBehavior *)0)
+      inst[i]->shared = true;
+  }
+  return inst;
+}
+
+/// \param opc is the op-code of the desired behavior
+/// \return the shared immutable behavior, or null for a floating-point op-code
+OpBehavior *OpBehavior::getShared(OpCode opc)
+
+{
+  static vector<OpBehavior *> table = buildSharedTable();
+  return table[opc];
+}
+
+/// This routine generates a vector of OpBehavior objects indexed by opcode.
+/// Most entries reference the shared static singletons; only the floating-point
+/// behaviors, which depend on the translator's formats, are constructed fresh.
+/// \param inst is the vector of behaviors to be filled
+/// \param trans is the translator object needed by the floating point behaviors
+void OpBehavior::registerInstructions(vector<OpBehavior *> &inst,const Translate *trans)
+
+{
+  inst.insert(inst.end(),CPUI_MAX,(OpBehavior *)0);
+
+  for(int4 i=0;i<CPUI_MAX;++i)
+    inst[i] = getShared((OpCode)i);
 
   inst[CPUI_FLOAT_EQUAL] = new OpBehaviorFloatEqual(trans);
   inst[CPUI_FLOAT_NOTEQUAL] = new OpBehaviorFloatNotEqual(trans);
   inst[CPUI_FLOAT_LESS] = new OpBehaviorFloatLess(trans);
   inst[CPUI_FLOAT_LESSEQUAL] = new OpBehaviorFloatLessEqual(trans);
   inst[CPUI_FLOAT_NAN] = new OpBehaviorFloatNan(trans);
-
   inst[CPUI_FLOAT_ADD] = new OpBehaviorFloatAdd(trans);
   inst[CPUI_FLOAT_DIV] = new OpBehaviorFloatDiv(trans);
   inst[CPUI_FLOAT_MULT] = new OpBehaviorFloatMult(trans);
@@ -91,20 +125,26 @@ void OpBehavior::registerInstructions(vector<OpBehavior *> &inst,const Translate
   inst[CPUI_FLOAT_NEG] = new OpBehaviorFloatNeg(trans);
   inst[CPUI_FLOAT_ABS] = new OpBehaviorFloatAbs(trans);
   inst[CPUI_FLOAT_SQRT] = new OpBehaviorFloatSqrt(trans);
-
   inst[CPUI_FLOAT_INT2FLOAT] = new OpBehaviorFloatInt2Float(trans);
   inst[CPUI_FLOAT_FLOAT2FLOAT] = new OpBehaviorFloatFloat2Float(trans);
   inst[CPUI_FLOAT_TRUNC] = new OpBehaviorFloatTrunc(trans);
   inst[CPUI_FLOAT_CEIL] = new OpBehaviorFloatCeil(trans);
   inst[CPUI_FLOAT_FLOOR] = new OpBehaviorFloatFloor(trans);
   inst[CPUI_FLOAT_ROUND] = new OpBehaviorFloatRound(trans);
-  inst[CPUI_SEGMENTOP] = new OpBehavior(CPUI_SEGMENTOP,false,true);
-  inst[CPUI_CPOOLREF] = new OpBehavior(CPUI_CPOOLREF,false,true);
-  inst[CPUI_NEW] = new OpBehavior(CPUI_NEW,false,true);
-  inst[CPUI_INSERT] = new OpBehavior(CPUI_INSERT,false);
-  inst[CPUI_EXTRACT] = new OpBehavior(CPUI_EXTRACT,false);
-  inst[CPUI_POPCOUNT] = new OpBehaviorPopcount();
-  inst[CPUI_LZCOUNT] = new OpBehaviorLzcount();
+}
+
+/// Any behavior constructed specifically for the given table is freed, leaving
+/// the shared singletons in place for other tables.
+/// \param inst is the table of behaviors to tear down
+void OpBehavior::deregisterInstructions(vector<OpBehavior *> &inst)
+
+{
+  for(int4 i=0;i<inst.size();++i) {
+    OpBehavior *t_op = inst[i];
+    if (t_op != (OpBehavior *)0 && !t_op->isShared())
+      delete t_op;
+  }
+  inst.clear();
 }
 
 /// \param sizeout is the size of the output in bytes
@@ -155,6 +195,84 @@ uintb OpBehavior::recoverInputBinary(int4 slot,int4 sizeout,uintb out,int4 sizei
   throw LowlevelError("Cannot recover input parameter without loss of information");
 }
 
+/// The result is identical to evaluateUnary() on the same behavior, but the most
+/// frequently evaluated integer op-codes are computed directly, so tight evaluation
+/// loops (emulation, constant folding) avoid a virtual call per operation.
+/// \param behave is the behavior object for the op-code
+/// \param sizeout is the size of the output in bytes
+/// \param sizein is the size of the input in bytes
+/// \param in1 is the input value
+/// \return the output value
+uintb OpBehavior::evaluateUnaryFast(const OpBehavior *behave,int4 sizeout,int4 sizein,uintb in1)
+
+{
+  switch(behave->opcode) {
+  case CPUI_COPY:
+  case CPUI_INT_ZEXT:
+    return in1;
+  case CPUI_INT_SEXT:
+    return sign_extend(in1,sizein,sizeout);
+  case CPUI_INT_2COMP:
+    return uintb_negate(in1-1,sizein);
+  case CPUI_INT_NEGATE:
+    return uintb_negate(in1,sizein);
+  case CPUI_BOOL_NEGATE:
+    return in1 ^ 1;
+  default:
+    break;
+  }
+  return behave->evaluateUnary(sizeout,sizein,in1);
+}
+
+/// The result is identical to evaluateBinary() on the same behavior, but the most
+/// frequently evaluated integer op-codes are computed directly, so tight evaluation
+/// loops (emulation, constant folding) avoid a virtual call per operation.
+/// \param behave is the behavior object for the op-code
+/// \param sizeout is the size of the output in bytes
+/// \param sizein is the size of the inputs in bytes
+/// \param in1 is the first input value
+/// \param in2 is the second input value
+/// \return the output value
+uintb OpBehavior::evaluateBinaryFast(const OpBehavior *behave,int4 sizeout,int4 sizein,uintb in1,uintb in2)
+
+{
+  switch(behave->opcode) {
+  case CPUI_INT_ADD:
+    return (in1 + in2) & calc_mask(sizeout);
+  case CPUI_INT_SUB:
+    return (in1 - in2) & calc_mask(sizeout);
+  case CPUI_INT_MULT:
+    return (in1 * in2) & calc_mask(sizeout);
+  case CPUI_INT_XOR:
+    return in1 ^ in2;
+  case CPUI_INT_AND:
+    return in1 & in2;
+  case CPUI_INT_OR:
+    return in1 | in2;
+  case CPUI_INT_EQUAL:
+    return (in1 == in2) ? 1 : 0;
+  case CPUI_INT_NOTEQUAL:
+    return (in1 != in2) ? 1 : 0;
+  case CPUI_INT_LESS:
+    return (in1 < in2) ? 1 : 0;
+  case CPUI_INT_LESSEQUAL:
+    return (in1 <= in2) ? 1 : 0;
+  case CPUI_INT_LEFT:
+    if (in2 >= sizeout*8)
+      return 0;
+    return (in1 << in2) & calc_mask(sizeout);
+  case CPUI_INT_RIGHT:
+    if (in2 >= sizeout*8)
+      return 0;
+    return (in1&calc_mask(sizeout)) >> in2;
+  case CPUI_SUBPIECE:
+    return (in1>>(in2*8)) & calc_mask(sizeout);
+  default:
+    break;
+  }
+  return behave->evaluateBinary(sizeout,sizein,in1,in2);
+}
+
 uintb OpBehaviorCopy::evaluateUnary(int4 sizeout,int4 sizein,uintb in1) const
 
 {
@@ -45,6 +45,8 @@ class OpBehavior {
   OpCode opcode;		///< the internal enumeration for pcode types
   bool isunary;			///< true= use unary interfaces,  false = use binary
   bool isspecial;		///< Is op not a normal unary or binary op
+  bool shared;			///< Is \b this owned by the shared static table
+  static vector<OpBehavior *> buildSharedTable(void);	///< Construct the table of shared behavior singletons
 public:
   OpBehavior(OpCode opc,bool isun); ///< A behavior constructor
 
@@ -61,6 +63,9 @@ public:
   /// \brief Check if operator is unary
   bool isUnary(void) const;
 
+  /// \brief Check if \b this is a shared singleton (not owned by the behavior table holding it)
+  bool isShared(void) const;
+
   /// \brief Emulate the unary op-code on an input value
   virtual uintb evaluateUnary(int4 sizeout,int4 sizein,uintb in1) const;
   
@@ -73,7 +78,15 @@ public:
   /// \brief Reverse the unary op-code operation, recovering the input value
   virtual uintb recoverInputUnary(int4 sizeout,uintb out,int4 sizein) const;
 
+  /// \brief Emulate a unary op-code, bypassing virtual dispatch for the common integer ops
+  static uintb evaluateUnaryFast(const OpBehavior *behave,int4 sizeout,int4 sizein,uintb in1);
+
+  /// \brief Emulate a binary op-code, bypassing virtual dispatch for the common integer ops
+  static uintb evaluateBinaryFast(const OpBehavior *behave,int4 sizeout,int4 sizein,uintb in1,uintb in2);
+
+  static OpBehavior *getShared(OpCode opc);	///< Get the shared behavior singleton for an op-code
   static void registerInstructions(vector<OpBehavior *> &inst,const Translate *trans); ///< Build all pcode behaviors
+  static void deregisterInstructions(vector<OpBehavior *> &inst);	///< Tear down a table built by registerInstructions()
 };
 
 /// This kind of OpBehavior is associated with a particular opcode and is either unary or binary
@@ -85,6 +98,7 @@ inline OpBehavior::OpBehavior(OpCode opc,bool isun)
   opcode = opc;
   isunary = isun;
   isspecial = false;
+  shared = false;
 }
 
 /// This kind of OpBehavior can be set to \b special, if it neither unary or binary.
@@ -97,6 +111,7 @@ inline OpBehavior::OpBehavior(OpCode opc,bool isun,bool isspec)
   opcode = opc;
   isunary = isun;
   isspecial = isspec;
+  shared = false;
 }
 
 /// There is an internal enumeration value for each type of pcode operation.
@@ -119,6 +134,14 @@ inline bool OpBehavior::isUnary(void) const {
   return isunary;
 }
 
+/// Most behaviors are immutable and are instantiated once in a static table
+/// shared by every behavior table in the process.  Such shared instances must
+/// not be freed when an individual table is torn down.
+/// \return \b true if \b this is a shared singleton
+inline bool OpBehavior::isShared(void) const {
+  return shared;
+}
+
 // A class for each opcode
 
 /// CPUI_COPY behavior
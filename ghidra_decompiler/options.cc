@@ -54,6 +54,7 @@ ElementId ELEM_PARAM3 = ElementId("param3",204);
 ElementId ELEM_PROTOEVAL = ElementId("protoeval",205);
 ElementId ELEM_SETACTION = ElementId("setaction",206);
 ElementId ELEM_SETLANGUAGE = ElementId("setlanguage",207);
+ElementId ELEM_SKIPCASTS = ElementId("skipcasts",288);
 ElementId ELEM_SPLITDATATYPE = ElementId("splitdatatype",270);
 ElementId ELEM_STRUCTALIGN = ElementId("structalign",208);
 ElementId ELEM_TOGGLERULE = ElementId("togglerule",209);
@@ -61,6 +62,8 @@ ElementId ELEM_WARNING = ElementId("warning",210);
 ElementId ELEM_JUMPTABLEMAX = ElementId("jumptablemax",271);
 ElementId ELEM_NANIGNORE = ElementId("nanignore",272);
 ElementId ELEM_BRACEFORMAT = ElementId("braceformat",284);
+ElementId ELEM_PERFORMANCEPRESET = ElementId("performancepreset",292);
+ElementId ELEM_LOCALITYORDER = ElementId("localityorder",293);
 
 /// If the parameter is "on" return \b true, if "off" return \b false.
 /// Any other value causes an exception.
@@ -111,6 +114,7 @@ OptionDatabase::OptionDatabase(Architecture *g)
   registerOption(new OptionInPlaceOps());
   registerOption(new OptionConventionPrinting());
   registerOption(new OptionNoCastPrinting());
+  registerOption(new OptionSkipCasts());
   registerOption(new OptionMaxLineWidth());
   registerOption(new OptionIndentIncrement());
   registerOption(new OptionCommentIndent());
@@ -126,8 +130,14 @@ OptionDatabase::OptionDatabase(Architecture *g)
   registerOption(new OptionJumpTableMax());
   registerOption(new OptionJumpLoad());
   registerOption(new OptionToggleRule());
+  registerOption(new OptionAdaptiveRules());
+  registerOption(new OptionLocalityOrder());
   registerOption(new OptionAliasBlock());
   registerOption(new OptionMaxInstruction());
+  registerOption(new OptionValueSetMax());
+  registerOption(new OptionValueSetWidening());
+  registerOption(new OptionDisassemblyCache());
+  registerOption(new OptionPerformancePreset());
   registerOption(new OptionNamespaceStrategy());
   registerOption(new OptionSplitDatatypes());
   registerOption(new OptionNanIgnore());
@@ -448,6 +458,25 @@ string OptionNoCastPrinting::apply(Architecture *glb,const string &p1,const stri
   return "No cast printing turned "+prop;
 }
 
+/// \class OptionSkipCasts
+/// \brief Toggle whether precise cast analysis runs during decompilation
+///
+/// Turning the option on removes the "casts" group from the current root Action, so
+/// ActionSetCasts never computes cast placements or union resolutions.  Output prints
+/// without cast syntax, falling back to the raw operator form at spots that would have
+/// needed a resolution.  Intended for fast skimmable output during triage.
+string OptionSkipCasts::apply(Architecture *glb,const string &p1,const string &p2,const string &p3) const
+
+{
+  bool val = onOrOff(p1);
+  if (glb->allacts.getCurrent() == (Action *)0)
+    throw LowlevelError("Missing current action");
+  glb->allacts.toggleAction(glb->allacts.getCurrentName(),"casts",!val);
+  string prop;
+  prop = val ? "on" : "off";
+  return "Cast analysis skipping turned "+prop;
+}
+
 /// \class OptionHideExtensions
 /// \brief Toggle whether implied extensions (ZEXT or SEXT) are printed
 string OptionHideExtensions::apply(Architecture *glb,const string &p1,const string &p2,const string &p3) const
@@ -900,6 +929,48 @@ string OptionToggleRule::apply(Architecture *glb,const string &p1,const string &
   return res;
 }
 
+/// \class OptionAdaptiveRules
+/// \brief Toggle adaptive rule ordering in the current Action's pools
+///
+/// If the parameter is "on", each pool periodically resorts its per-opcode
+/// rule lists by observed apply-rate so the rules most likely to fire are
+/// tested first.  "off" freezes the lists in their current order.
+string OptionAdaptiveRules::apply(Architecture *glb,const string &p1,const string &p2,const string &p3) const
+
+{
+  bool val = onOrOff(p1);
+
+  Action *root = glb->allacts.getCurrent();
+  if (root == (Action *)0)
+    throw LowlevelError("Missing current action");
+  root->setAdaptiveReorder(val);
+  string res = "Adaptive rule ordering turned ";
+  res += val ? "on" : "off";
+  return res;
+}
+
+/// \class OptionLocalityOrder
+/// \brief Toggle locality-aware worklist ordering in the current Action's pools
+///
+/// If the parameter is "on", each pool drains its worklist in (block, op-order)
+/// buckets, so consecutive rule applications touch neighboring ops and varnodes
+/// instead of bouncing between distant blocks; ops changed across a block
+/// boundary are picked up in their home bucket on the pool's next repeat pass.
+/// "off" restores plain sequence-number order.
+string OptionLocalityOrder::apply(Architecture *glb,const string &p1,const string &p2,const string &p3) const
+
+{
+  bool val = onOrOff(p1);
+
+  Action *root = glb->allacts.getCurrent();
+  if (root == (Action *)0)
+    throw LowlevelError("Missing current action");
+  root->setLocalityOrder(val);
+  string res = "Locality worklist ordering turned ";
+  res += val ? "on" : "off";
+  return res;
+}
+
 /// \class OptionAliasBlock
 /// \brief Set how locked data-types on the stack affect alias heuristics
 ///
@@ -951,6 +1022,134 @@ string OptionMaxInstruction::apply(Architecture *glb,const string &p1,const stri
   return "Maximum instructions per function set";
 }
 
+/// \class OptionValueSetMax
+/// \brief Maximum iterations allowed for a single value set analysis
+///
+/// The first parameter is an integer specifying the iteration cap. Value set
+/// analysis drives LOAD/STORE guard ranges (and from there jump-table bounds);
+/// lowering the cap trades range precision on loop-dense functions for speed.
+string OptionValueSetMax::apply(Architecture *glb,const string &p1,const string &p2,const string &p3) const
+
+{
+  if (p1.size() == 0)
+    throw ParseError("Must specify number of iterations");
+
+  int4 newMax = -1;
+  istringstream s1(p1);
+  s1.unsetf(ios::dec | ios::hex | ios::oct); // Let user specify base
+  s1 >> newMax;
+  if (newMax <= 0)
+    throw ParseError("Bad valuesetmax parameter");
+  glb->valueset_maxiter = newMax;
+  return "Maximum value set iterations set";
+}
+
+/// \class OptionValueSetWidening
+/// \brief Set how aggressively value set analysis widens non-stabilizing ranges
+///
+/// The first parameter is the iteration at which controlled widening starts.
+/// The optional second parameter is the iteration at which a range that still
+/// hasn't stabilized is widened to the full range. Smaller values converge
+/// faster but produce coarser LOAD/STORE guard ranges.
+string OptionValueSetWidening::apply(Architecture *glb,const string &p1,const string &p2,const string &p3) const
+
+{
+  if (p1.size() == 0)
+    throw ParseError("Must specify widening iteration");
+
+  int4 widenIter = -1;
+  istringstream s1(p1);
+  s1.unsetf(ios::dec | ios::hex | ios::oct); // Let user specify base
+  s1 >> widenIter;
+  if (widenIter < 1)
+    throw ParseError("Bad valuesetwidening parameter");
+  int4 fullIter = glb->valueset_fulliter;
+  if (p2.size() != 0) {
+    istringstream s2(p2);
+    s2.unsetf(ios::dec | ios::hex | ios::oct);
+    s2 >> fullIter;
+  }
+  if (fullIter <= widenIter)
+    throw ParseError("Full widening iteration must be greater than widening iteration");
+  glb->valueset_wideniter = widenIter;
+  glb->valueset_fulliter = fullIter;
+  return "Value set widening thresholds set";
+}
+
+/// \class OptionDisassemblyCache
+/// \brief Set the sizing of the translator's per-thread instruction parse cache
+///
+/// The first parameter is the number of cached instruction parses held per
+/// decode thread; the second is the size of the address hash-table, which must
+/// be a power of 2.  Larger values help disassembly heavy workloads that page
+/// through big code sections.  Engines with no such cache ignore the option.
+string OptionDisassemblyCache::apply(Architecture *glb,const string &p1,const string &p2,const string &p3) const
+
+{
+  if (p1.size() == 0 || p2.size() == 0)
+    throw ParseError("Must specify cache size and window size");
+
+  int4 cachesize = -1;
+  int4 windowsize = -1;
+  istringstream s1(p1);
+  s1.unsetf(ios::dec | ios::hex | ios::oct); // Let user specify base
+  s1 >> cachesize;
+  istringstream s2(p2);
+  s2.unsetf(ios::dec | ios::hex | ios::oct);
+  s2 >> windowsize;
+  if (cachesize <= 0 || windowsize <= 0)
+    throw ParseError("Bad disassemblycache parameter");
+  glb->translate->setDisassemblyCache(cachesize,windowsize);
+  return "Disassembly cache sized to "+p1+" contexts with window "+p2;
+}
+
+/// \class OptionPerformancePreset
+/// \brief Select a named point on the speed/fidelity curve
+///
+/// The first parameter names the preset.  Each preset atomically configures the
+/// current root Action, the per-function instruction limit, the jump-table and
+/// value set analysis budgets, and the disassembly cache sizing, replacing a
+/// volley of individual option commands:
+///   - fast - the trimmed "preview" pipeline with tight budgets, for triage
+///   - balanced - the full "decompile" pipeline with the default budgets
+///   - thorough - the full "decompile" pipeline with generous budgets, for deep dives
+///
+/// Individual options can still be adjusted afterward; a later preset overwrites them.
+string OptionPerformancePreset::apply(Architecture *glb,const string &p1,const string &p2,const string &p3) const
+
+{
+  if (p1 == "fast") {
+    glb->allacts.setCurrent("preview");
+    glb->max_instructions = 50000;
+    glb->max_jumptable_size = 256;
+    glb->valueset_maxiter = 2000;
+    glb->valueset_wideniter = 1;
+    glb->valueset_fulliter = 3;
+    glb->translate->setDisassemblyCache(16,512);	// Triage pages through a lot of code
+  }
+  else if (p1 == "balanced") {
+    glb->allacts.setCurrent("decompile");
+    glb->max_instructions = 100000;
+    glb->max_jumptable_size = 1024;
+    glb->valueset_maxiter = 10000;
+    glb->valueset_wideniter = 2;
+    glb->valueset_fulliter = 5;
+    glb->translate->setDisassemblyCache(8,256);
+  }
+  else if (p1 == "thorough") {
+    glb->allacts.setCurrent("decompile");
+    glb->max_instructions = 500000;
+    glb->max_jumptable_size = 4096;
+    glb->valueset_maxiter = 50000;
+    glb->valueset_wideniter = 3;
+    glb->valueset_fulliter = 10;
+    glb->translate->setDisassemblyCache(8,256);
+  }
+  else
+    throw ParseError("Unknown performance preset: "+p1);
+  return "Performance preset set to "+p1;
+}
+
 /// \class OptionNamespaceStrategy
 /// \brief How should namespace tokens be displayed
 ///
@@ -57,15 +57,18 @@ extern ElementId ELEM_OPTIONSLIST;		///< Marshaling element \<optionslist>
 extern ElementId ELEM_PARAM1;			///< Marshaling element \<param1>
 extern ElementId ELEM_PARAM2;			///< Marshaling element \<param2>
 extern ElementId ELEM_PARAM3;			///< Marshaling element \<param3>
+extern ElementId ELEM_PERFORMANCEPRESET;	///< Marshaling element \<performancepreset>
 extern ElementId ELEM_PROTOEVAL;		///< Marshaling element \<protoeval>
 extern ElementId ELEM_SETACTION;		///< Marshaling element \<setaction>
 extern ElementId ELEM_SETLANGUAGE;		///< Marshaling element \<setlanguage>
+extern ElementId ELEM_SKIPCASTS;		///< Marshaling element \<skipcasts>
 extern ElementId ELEM_SPLITDATATYPE;		///< Marshaling element \<splitdatatype>
 extern ElementId ELEM_STRUCTALIGN;		///< Marshaling element \<structalign>
 extern ElementId ELEM_TOGGLERULE;		///< Marshaling element \<togglerule>
 extern ElementId ELEM_WARNING;			///< Marshaling element \<warning>
 extern ElementId ELEM_JUMPTABLEMAX;		///< Marshaling element \<jumptablemax>
 extern ElementId ELEM_NANIGNORE;		///< Marshaling element \<nanignore>
+extern ElementId ELEM_LOCALITYORDER;		///< Marshaling element \<localityorder>
 
 /// \brief Base class for options classes that affect the configuration of the Architecture object
 ///
@@ -187,6 +190,12 @@ public:
   virtual string apply(Architecture *glb,const string &p1,const string &p2,const string &p3) const;
 };
 
+class OptionSkipCasts : public ArchOption {
+public:
+  OptionSkipCasts(void) { name = "skipcasts"; }		///< Constructor
+  virtual string apply(Architecture *glb,const string &p1,const string &p2,const string &p3) const;
+};
+
 class OptionHideExtensions : public ArchOption {
 public:
   OptionHideExtensions(void) { name="hideextensions"; }		///< Constructor
@@ -313,6 +322,18 @@ public:
   virtual string apply(Architecture *glb,const string &p1,const string &p2,const string &p3) const;
 };
 
+class OptionAdaptiveRules : public ArchOption {
+public:
+  OptionAdaptiveRules(void) { name = "adaptiverules"; }	///< Constructor
+  virtual string apply(Architecture *glb,const string &p1,const string &p2,const string &p3) const;
+};
+
+class OptionLocalityOrder : public ArchOption {
+public:
+  OptionLocalityOrder(void) { name = "localityorder"; }	///< Constructor
+  virtual string apply(Architecture *glb,const string &p1,const string &p2,const string &p3) const;
+};
+
 class OptionAliasBlock : public ArchOption {
 public:
   OptionAliasBlock(void) { name = "aliasblock"; }	///< Constructor
@@ -325,6 +346,30 @@ public:
   virtual string apply(Architecture *glb,const string &p1,const string &p2,const string &p3) const;
 };
 
+class OptionValueSetMax : public ArchOption {
+public:
+  OptionValueSetMax(void) { name="valuesetmax"; }	///< Constructor
+  virtual string apply(Architecture *glb,const string &p1,const string &p2,const string &p3) const;
+};
+
+class OptionValueSetWidening : public ArchOption {
+public:
+  OptionValueSetWidening(void) { name="valuesetwidening"; }	///< Constructor
+  virtual string apply(Architecture *glb,const string &p1,const string &p2,const string &p3) const;
+};
+
+class OptionDisassemblyCache : public ArchOption {
+public:
+  OptionDisassemblyCache(void) { name="disassemblycache"; }	///< Constructor
+  virtual string apply(Architecture *glb,const string &p1,const string &p2,const string &p3) const;
+};
+
+class OptionPerformancePreset : public ArchOption {
+public:
+  OptionPerformancePreset(void) { name="performancepreset"; }	///< Constructor
+  virtual string apply(Architecture *glb,const string &p1,const string &p2,const string &p3) const;
+};
+
 class OptionNamespaceStrategy : public ArchOption {
 public:
   OptionNamespaceStrategy(void) { name = "namespacestrategy"; }	///< Constructor
@@ -40,6 +40,7 @@ void Override::clear(void)
   protoover.clear();
   multistagejump.clear();
   flowoverride.clear();
+  activemask = 0;
 }
 
 /// \brief Generate \e warning message related to a dead code delay
@@ -67,6 +68,7 @@ void Override::insertForceGoto(const Address &targetpc,const Address &destpc)
 
 {
   forcegoto[targetpc] = destpc;
+  activemask |= forcegoto_active;
 }
 
 /// \brief Override the number of passes that are executed before \e dead-code elimination starts
@@ -83,6 +85,7 @@ void Override::insertDeadcodeDelay(AddrSpace *spc,int4 delay)
     deadcodedelay.push_back(-1);
 
   deadcodedelay[spc->getIndex()] = delay;
+  activemask |= deadcodedelay_active;
 }
 
 /// \brief Check if a delay override is already installed for an address space
@@ -110,6 +113,7 @@ void Override::insertIndirectOverride(const Address &callpoint,const Address &di
 
 {
   indirectover[callpoint] = directcall;
+  activemask |= indirect_active;
 }
 
 /// \brief Override the assumed function prototype at a specific call site
@@ -129,6 +133,7 @@ void Override::insertProtoOverride(const Address &callpoint,FuncProto *p)
 
   p->setOverride(true);		// Mark this as an override
   protoover[callpoint] = p;	// Take ownership of the object
+  activemask |= proto_active;
 }
 
 /// \brief Flag an indirect jump for multistage analysis
@@ -138,6 +143,7 @@ void Override::insertMultistageJump(const Address &addr)
 
 {
   multistagejump.push_back(addr);
+  activemask |= multistage_active;
 }
 
 /// \brief Mark a branch instruction with a different flow type
@@ -149,6 +155,7 @@ void Override::insertFlowOverride(const Address &addr,uint4 type)
 
 {
   flowoverride[addr] = type;
+  activemask |= flow_active;
 }
 
 /// \brief Look for and apply a function prototype override
@@ -160,7 +167,7 @@ void Override::insertFlowOverride(const Address &addr,uint4 type)
 void Override::applyPrototype(Funcdata &data,FuncCallSpecs &fspecs) const
 
 {
-  if (!protoover.empty()) {
+  if ((activemask & proto_active)!=0) {
     map<Address,FuncProto *>::const_iterator iter = protoover.find(fspecs.getOp()->getAddr());
     if (iter != protoover.end()) {
       fspecs.copy(*(*iter).second);
@@ -177,7 +184,7 @@ void Override::applyPrototype(Funcdata &data,FuncCallSpecs &fspecs) const
 void Override::applyIndirect(Funcdata &data,FuncCallSpecs &fspecs) const
 
 {
-  if (!indirectover.empty()) {
+  if ((activemask & indirect_active)!=0) {
     map<Address,Address>::const_iterator iter = indirectover.find(fspecs.getOp()->getAddr());
     if (iter != indirectover.end())
       fspecs.setAddress( (*iter).second );
@@ -191,6 +198,7 @@ void Override::applyIndirect(Funcdata &data,FuncCallSpecs &fspecs) const
 bool Override::queryMultistageJumptable(const Address &addr) const
 
 {
+  if ((activemask & multistage_active)==0) return false;
   for(int4 i=0;i<multistagejump.size();++i) {
     if (multistagejump[i] == addr)
       return true;
@@ -206,6 +214,7 @@ void Override::applyForceGoto(Funcdata &data) const
 {
   map<Address,Address>::const_iterator iter;
 
+  if ((activemask & forcegoto_active)==0) return;
   for(iter=forcegoto.begin();iter!=forcegoto.end();++iter)
     data.forceGoto((*iter).first,(*iter).second);
 }
@@ -217,6 +226,7 @@ void Override::applyForceGoto(Funcdata &data) const
 void Override::applyDeadCodeDelay(Funcdata &data) const
 
 {
+  if ((activemask & deadcodedelay_active)==0) return;
   Architecture *glb = data.getArch();
   for(int4 i=0;i<deadcodedelay.size();++i) {
     int4 delay = deadcodedelay[i];
@@ -58,6 +58,16 @@ public:
     RETURN = 4			///< Replace primary BRANCH or CALL with a suitable RETURN operation
   };
 private:
+  /// \brief Bits within \b activemask indicating which override categories are present
+  enum {
+    forcegoto_active = 1,		///< At least one force-goto override is present
+    deadcodedelay_active = 2,		///< At least one dead-code delay override is present
+    indirect_active = 4,		///< At least one indirect call override is present
+    proto_active = 8,			///< At least one prototype override is present
+    multistage_active = 0x10,		///< At least one multistage jump override is present
+    flow_active = 0x20			///< At least one branch flow override is present
+  };
+  uint4 activemask;			///< Digest of which override categories are active
   map<Address,Address> forcegoto;	///< Force goto on jump at \b targetpc to \b destpc
   vector<int4> deadcodedelay;		///< Delay count indexed by address space
   map<Address,Address> indirectover;	///< Override indirect at \b call-point into direct to \b addr
@@ -67,7 +77,9 @@ private:
   void clear(void);			///< Clear the entire set of overrides
   static string generateDeadcodeDelayMessage(int4 index,Architecture *glb);
 public:
+  Override(void) { activemask = 0; }	///< Constructor
   ~Override(void) { clear(); }		///< Destructor
+  bool empty(void) const { return (activemask == 0); }	///< Return \b true if no overrides of any type are present
   void insertForceGoto(const Address &targetpc,const Address &destpc);
   void insertDeadcodeDelay(AddrSpace *spc,int4 delay);
   bool hasDeadcodeDelay(AddrSpace *spc) const;
@@ -81,7 +93,7 @@ public:
   bool queryMultistageJumptable(const Address &addr) const;
   void applyDeadCodeDelay(Funcdata &data) const;
   void applyForceGoto(Funcdata &data) const;
-  bool hasFlowOverride(void) const { return (!flowoverride.empty()); }	///< Are there any flow overrides
+  bool hasFlowOverride(void) const { return ((activemask & flow_active)!=0); }	///< Are there any flow overrides
   uint4 getFlowOverride(const Address &addr) const;
   void printRaw(ostream &s,Architecture *glb) const;
   void generateOverrideMessages(vector<string> &messagelist,Architecture *glb) const;
@@ -20,6 +20,7 @@
 #define __PARTMAP_HH__
 
 #include <map>
+#include <vector>
 
 namespace ghidra {
 
@@ -55,7 +56,22 @@ public:
 private:
   maptype database;						///< Map from linear split points to the value objects
   _valuetype defaultvalue;					///< The value object \e before the first split point
+  mutable std::vector<std::pair<_linetype,const _valuetype *> > flat;	///< Flat sorted mirror of the split points for read traffic
+  mutable bool flatvalid;					///< Set to \b true if \b flat mirrors the current split points
+  void buildFlat(void) const;					///< Rebuild the flat mirror from the split point map
 public:
+  partmap(void) { flatvalid = false; }				///< Constructor
+  partmap(const partmap &op2) : database(op2.database), defaultvalue(op2.defaultvalue) {
+    flatvalid = false; }					///< Copy constructor
+  partmap &operator=(const partmap &op2) {
+    if (this != &op2) {
+      database = op2.database;
+      defaultvalue = op2.defaultvalue;
+      flat.clear();
+      flatvalid = false;
+    }
+    return *this;
+  }								///< Assignment operator
   _valuetype &getValue(const _linetype &pnt);			///< Get the value object at a point
   const _valuetype &getValue(const _linetype &pnt) const;	///< Get the value object at a point
   const _valuetype &bounds(const _linetype &pnt,_linetype &before,_linetype &after,int &valid) const;
@@ -69,7 +85,8 @@ public:
   iterator end(void) { return database.end(); }				///< End of split points
   const_iterator begin(const _linetype &pnt) const { return database.lower_bound(pnt); }	///< Get first split point after given point
   iterator begin(const _linetype &pnt) { return database.lower_bound(pnt); }	///< Get first split point after given point
-  void clear(void) { database.clear(); }				///< Clear all split points
+  void prepareReads(void) const { if (!flatvalid) buildFlat(); }	///< Rebuild the flat mirror, if stale, ahead of concurrent reads
+  void clear(void) { database.clear(); flat.clear(); flatvalid = false; }	///< Clear all split points
   bool empty(void) const { return database.empty(); }			///< Return \b true if there are no split points
 };
 
@@ -92,23 +109,58 @@ template<typename _linetype,typename _valuetype>
     return (*iter).second;
   }
 
+/// The mirror is a sorted vector of split points paired with pointers to their value
+/// objects, so constant look ups can binary search over cache-contiguous entries rather
+/// than chase map nodes.  The pointers remain valid as values are modified in place;
+/// the mirror is only rebuilt after split points are added or removed.  The rebuild
+/// must not run concurrently with readers: call prepareReads() from the code that
+/// just mutated the split points, while it still holds whatever lock excluded the
+/// readers, so getValue() never has to build the mirror itself.
+template<typename _linetype,typename _valuetype>
+  void partmap<_linetype,_valuetype>::
+  buildFlat(void) const
+
+  {
+    flat.clear();
+    flat.reserve(database.size());
+    const_iterator iter;
+    for(iter=database.begin();iter!=database.end();++iter)
+      flat.push_back(std::pair<_linetype,const _valuetype *>((*iter).first,&(*iter).second));
+    flatvalid = true;
+  }
+
 /// Look up the first split point coming before the given point
 /// and return the value object it maps to. If there is no earlier split point
-/// return the default value.
+/// return the default value.  The search runs over the flat mirror of the split
+/// points when it is current; a stale mirror (split points changed with no
+/// prepareReads() call yet) falls back to the map itself rather than rebuilding,
+/// since \b this may be shared with other reading threads.
 /// \param pnt is the given point in the linear space
 /// \return the corresponding value object
 template<typename _linetype,typename _valuetype>
   const _valuetype &partmap<_linetype,_valuetype>::
   getValue(const _linetype &pnt) const
-  
+
   {
-    const_iterator iter;
-    
-    iter = database.upper_bound(pnt);
-    if (iter == database.begin())
+    if (!flatvalid) {
+      const_iterator iter = database.upper_bound(pnt);
+      if (iter == database.begin())
+	return defaultvalue;
+      --iter;
+      return (*iter).second;
+    }
+    std::size_t min = 0;
+    std::size_t max = flat.size();
+    while(min < max) {		// Find the first split point greater than pnt
+      std::size_t mid = (min + max) / 2;
+      if (pnt < flat[mid].first)
+	max = mid;
+      else
+	min = mid + 1;
+    }
+    if (min == 0)
       return defaultvalue;
-    --iter;
-    return (*iter).second;
+    return *flat[min-1].second;
   }
 
 /// Add (if not already present) a point to the linear partition.
@@ -126,10 +178,12 @@ template<typename _linetype,typename _valuetype>
       --iter;
       if ((*iter).first == pnt)	// point matches exactly
 	return (*iter).second;	// Return old ref
+      flatvalid = false;	// Adding a split point invalidates the flat mirror
       _valuetype &newref( database[pnt] ); // Create new ref at point
       newref = (*iter).second;	// Copy of original partition value
       return newref;
     }
+    flatvalid = false;		// Adding a split point invalidates the flat mirror
     _valuetype &newref( database[pnt] ); // Create new ref at point
     newref = defaultvalue;	// Copy of defaultvalue
     return newref;
@@ -153,8 +207,9 @@ template<typename _linetype,typename _valuetype>
     _valuetype &ref( (*beg).second );
     ++beg;
     database.erase(beg,end);
+    flatvalid = false;		// Removing split points invalidates the flat mirror
     return ref;
-  }  
+  }
 
 /// \brief Get the value object for a given point and return the range over which the value object applies
 ///
@@ -566,7 +566,7 @@ void EmitPrettyPrint::expand(void)
 {
   int4 max = tokqueue.getMax();
   int4 left = tokqueue.bottomref();
-  tokqueue.expand(200);
+  tokqueue.expand(max);		// Grow geometrically, so filling a large queue doesn't repeatedly copy it
   // Expanding puts the leftmost element at reference 0
   // So we need to adjust references
   for(int4 i=0;i<max;++i)
@@ -575,7 +575,7 @@ void EmitPrettyPrint::expand(void)
   // or equal to the number of elements in tokqueue, so
   // if we keep scanqueue and tokqueue with the same max
   // we don't need to check for scanqueue overflow
-  scanqueue.expand(200);
+  scanqueue.expand(max);
 }
 
 /// (Permanently) adjust the current set of indent levels to guarantee a minimum
@@ -1222,14 +1222,33 @@ void EmitPrettyPrint::setMarkup(bool val)
   lowlevel->setOutputStream(t);
 }
 
+/// The pretty printer forwards its committed tokens to the given emitter,
+/// which it now owns, in place of its previous low-level emitter.  Any
+/// established output stream carries over.
+/// \param lvl is the new low-level emitter
+/// \return \b true as the emitter is always installed
+bool EmitPrettyPrint::setLowLevelEmit(Emit *lvl)
+
+{
+  ostream *t = lowlevel->getOutputStream();
+  delete lowlevel;
+  lowlevel = lvl;
+  if (t != (ostream *)0)
+    lvl->setOutputStream(t);
+  return true;
+}
+
 void EmitPrettyPrint::setMaxLineSize(int4 val)
 
 {
   if ((val<20)||(val>10000))
     throw LowlevelError("Bad maximum line size");
   maxlinesize = val;
-  scanqueue.setMax(3*val);
-  tokqueue.setMax(3*val);
+  int4 qmax = 3*val;
+  if (qmax < tokqueue.getMax())
+    qmax = tokqueue.getMax();	// Keep the high-water mark established by previous documents
+  scanqueue.setMax(qmax);
+  tokqueue.setMax(qmax);
   spaceremain = maxlinesize;
   clear();
 }
@@ -356,6 +356,15 @@ public:
   /// \param val is \b true if markup is desired
   virtual void setMarkup(bool val) {}
 
+  /// \brief Install a custom low-level emitter
+  ///
+  /// If \b this emitter layers on top of a lower-level emitter, replace that emitter
+  /// with the given one, taking ownership of it.  Otherwise the method has no effect,
+  /// ownership is not taken, and \b false is returned.
+  /// \param lvl is the new low-level emitter
+  /// \return \b true if the emitter was installed
+  virtual bool setLowLevelEmit(Emit *lvl) { return false; }
+
   /// \brief Toggle whether \b this emitter produces packed output
   ///
   /// If the emitter supports it, \b true selects packed output and \b false selects unpacked XML output.
@@ -1112,6 +1121,7 @@ public:
   virtual bool emitsMarkup(void) const { return lowlevel->emitsMarkup(); }
   virtual void resetDefaults(void);
   virtual void setMarkup(bool val);
+  virtual bool setLowLevelEmit(Emit *lvl);
 };
 
 /// \brief Helper class for sending cancelable print commands to an ExitXml
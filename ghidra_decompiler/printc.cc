@@ -1336,7 +1336,8 @@ void PrintC::push_integer(uintb val,int4 sz,bool sign,tagtype tag,
     displayFormat = (PrintLanguage::mostNaturalBase(val)==16) ? Symbol::force_hex : Symbol::force_dec;
   }
 
-  ostringstream t;
+  scratch.str(string());	// Reuse the scratch stream rather than constructing one per constant
+  ostringstream &t( scratch );
   if (print_negsign)
     t << '-';
   if (displayFormat == Symbol::force_hex)
@@ -1638,7 +1639,8 @@ void PrintC::pushCharConstant(uintb val,const Datatype *ct,tagtype tag,const Var
     }
     displayFormat = Symbol::force_hex;	// Fallthru but force a hex representation
   }
-  ostringstream t;
+  scratch.str(string());	// Reuse the scratch stream rather than constructing one per constant
+  ostringstream &t( scratch );
   // From here we assume, the constant value is a direct unicode code-point.
   // The value could be an illegal code-point (surrogates or beyond the max code-point),
   // but this will just be emitted as an escape sequence.
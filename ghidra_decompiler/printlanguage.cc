@@ -155,16 +155,27 @@ void PrintLanguage::pushOp(const OpToken *tok,const PcodeOp *op)
   revpol.back().id = id;
 }
 
-/// Push a single token (an Atom) onto the RPN stack. This may trigger some amount
+/// Push a single token (an Atom) onto the RPN stack. If there are pending Varnodes that
+/// were pushed before the Atom, its resolution is deferred, in order, behind them on the
+/// pending queue.  Otherwise the Atom resolves immediately, which may trigger some amount
 /// of the RPN stack to get emitted, depending on what was pushed previously.
-/// The 'emit' routines are called, popping off as much as possible.
 /// \param atom is the token to be pushed
 void PrintLanguage::pushAtom(const Atom &atom)
 
 {
-  if (pending < nodepend.size()) // pending varnodes before atom
-    recurse();			// So we must recurse
+  if (pending < nodepend.size()) {	// pending varnodes before atom
+    atomnames.push_back(atom.name);	// Keep a stable copy of the token characters
+    nodepend.emplace(nodepend.begin()+pending,atomnames.back(),atom);
+    return;
+  }
+  pushAtomDirect(atom);
+}
 
+/// The 'emit' routines are called, popping off as much of the RPN stack as possible.
+/// \param atom is the token being resolved
+void PrintLanguage::pushAtomDirect(const Atom &atom)
+
+{
   if (revpol.empty())
     emitAtom(atom);
   else {
@@ -519,6 +530,17 @@ void PrintLanguage::recurse(void)
   pending = nodepend.size();	// Lay claim to the rest
   while(lastPending < pending) {
     const Varnode *vn = nodepend.back().vn;
+    if (vn == (const Varnode *)0) {	// A deferred leaf token
+      const NodePending &node( nodepend.back() );
+      Atom atom(*node.name,node.type,node.highlight,node.op);	// Characters remain stable in atomnames
+      atom.ptr_second = node.meta;
+      atom.offset = node.offset;
+      nodepend.pop_back();
+      pending -= 1;
+      pushAtomDirect(atom);
+      pending = nodepend.size();
+      continue;
+    }
     const PcodeOp *op = nodepend.back().op;
     mods = nodepend.back().vnmod;
     nodepend.pop_back();
@@ -537,6 +559,8 @@ void PrintLanguage::recurse(void)
     pending = nodepend.size();
   }
   mods = modsave;
+  if (pending == 0 && nodepend.empty())
+    atomnames.clear();		// Queue fully drained, so owned characters can be released
 }
 
 /// Push an operator onto the stack that has a normal binary format.
@@ -689,6 +713,7 @@ void PrintLanguage::clear(void)
   pending = 0;
 
   nodepend.clear();
+  atomnames.clear();
 }
 
 /// This determines how integers are displayed by default. Possible
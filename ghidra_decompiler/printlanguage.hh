@@ -188,18 +188,12 @@ public:
     mutable int4 id2;		///< The id of the token group \b this surrounds (for surround operator tokens)
   };
 
-  /// \brief A pending data-flow node; waiting to be placed on the reverse polish notation stack
-  ///
-  /// This holds an \e implied Varnode in the data-flow graph, which prints as the expression producing
-  /// the value in the Varnode.
-  struct NodePending {
-    const Varnode *vn;		///< The implied Varnode
-    const PcodeOp *op;		///< The single operator consuming value from the implied Varnode
-    uint4 vnmod;		///< Printing modifications to enforce on the expression
-
-    /// \brief Construct a pending data-flow node
-    NodePending(const Varnode *v,const PcodeOp *o,uint4 m) {
-      vn = v; op = o; vnmod = m; }
+  /// \brief Meta-data that can be associated with a non-operator token
+  union AtomMeta {
+    const Varnode *vn;		///< A Varnode associated with the token
+    const Funcdata *fd;		///< A function associated with the token
+    const Datatype *ct;		///< A type associated with the token
+    uintb intValue;		///< An integer value associated with the token
   };
 
   /// \brief A single non-operator token emitted by the decompiler
@@ -212,12 +206,7 @@ public:
     tagtype type;		///< The type of Atom
     EmitMarkup::syntax_highlight highlight;	///< The type of highlighting to use when emitting the token
     const PcodeOp *op;		///< A p-code operation associated with the token
-    union {
-      const Varnode *vn;	///< A Varnode associated with the token
-      const Funcdata *fd;	///< A function associated with the token
-      const Datatype *ct;	///< A type associated with the token
-      uintb intValue;		///< An integer value associated with the token
-    } ptr_second;		///< Other meta-data associated with the token
+    AtomMeta ptr_second;	///< Other meta-data associated with the token
     int4 offset;        	///< The offset (within the parent structure) for a \e field token
 
     /// \brief Construct a token with no associated data-flow annotations
@@ -257,12 +246,38 @@ public:
     }
 
   };
+
+  /// \brief A pending node; waiting to be placed on the reverse polish notation stack
+  ///
+  /// This either holds an \e implied Varnode in the data-flow graph, which prints as the
+  /// expression producing the value in the Varnode, or a leaf Atom whose emission has been
+  /// deferred until the pending Varnodes pushed before it have been resolved.
+  struct NodePending {
+    const Varnode *vn;		///< The implied Varnode, or null for a deferred leaf token
+    const PcodeOp *op;		///< The single operator consuming value from the implied Varnode
+    uint4 vnmod;		///< Printing modifications to enforce on the expression
+    const string *name;		///< Stable copy of a deferred leaf token's characters
+    tagtype type;		///< The type of a deferred leaf token
+    EmitMarkup::syntax_highlight highlight;	///< Highlighting for a deferred leaf token
+    AtomMeta meta;		///< Other meta-data associated with a deferred leaf token
+    int4 offset;		///< The field offset for a deferred leaf token
+
+    /// \brief Construct a pending data-flow node
+    NodePending(const Varnode *v,const PcodeOp *o,uint4 m) {
+      vn = v; op = o; vnmod = m; }
+
+    /// \brief Construct a deferred leaf token
+    NodePending(const string &nm,const Atom &a) {
+      vn = (const Varnode *)0; op = a.op; vnmod = 0;
+      name = &nm; type = a.type; highlight = a.highlight; meta = a.ptr_second; offset = a.offset; }
+  };
 private:
   string name;				///< The name of the high-level language
   vector<uint4> modstack;		///< Printing modification stack
   vector<const Scope *> scopestack;	///< The symbol scope stack
   vector<ReversePolish> revpol;		///< The Reverse Polish Notation (RPN) token stack
   vector<NodePending> nodepend;		///< Data-flow nodes waiting to be pushed onto the RPN stack
+  list<string> atomnames;		///< Owned token characters backing deferred leaf tokens
   int4 pending;				///< Number of data-flow nodes waiting to be pushed
   int4 line_commentindent;		///< Number of characters a comment line should be indented
   string commentstart;			///< Delimiter characters for the start of a comment
@@ -276,6 +291,7 @@ protected:
   uint4 instr_comment_type;		///< Type of instruction comments to display
   uint4 head_comment_type;		///< Type of header comments to display
   namespace_strategy namespc_strategy;	///< How should namespace tokens be displayed
+  ostringstream scratch;		///< Reusable stream for building synthesized tokens
 #ifdef CPUI_DEBUG
   bool isStackEmpty(void) const { return (nodepend.empty()&&revpol.empty()); }	///< Return \b true if the RPN stack is empty
   bool isModStackEmpty(void) const { return modstack.empty(); }			///< Return \b true if the printing modification stack is empty
@@ -290,6 +306,7 @@ protected:
   void unsetMod(uint4 m) { mods &= ~m; }					///< Deactivate the given printing modification
   void pushOp(const OpToken *tok,const PcodeOp *op);			///< Push an operator token onto the RPN stack
   void pushAtom(const Atom &atom);					///< Push a variable token onto the RPN stack
+  void pushAtomDirect(const Atom &atom);				///< Resolve a variable token against the RPN stack
   void pushVn(const Varnode *vn,const PcodeOp *op,uint4 m);	///< Push an expression rooted at a Varnode onto the RPN stack
   void pushVnExplicit(const Varnode *vn,const PcodeOp *op);		///< Push an explicit variable onto the RPN stack
   void pushSymbolDetail(const Varnode *vn,const PcodeOp *op,bool isRead);	///< Push symbol name with adornments matching given Varnode
@@ -461,6 +478,7 @@ public:
   void setHeaderComment(uint4 val) { head_comment_type = val; }		///< Set the type of comments suitable for a function header
   bool emitsMarkup(void) const { return emit->emitsMarkup(); }		///< Does the low-level emitter, emit markup
   void setMarkup(bool val) { emit->setMarkup(val); }			///< Turn on/off mark-up in emitted output
+  Emit *getEmitter(void) const { return emit; }			///< Get the low-level token emitter
   void setPackedOutput(bool val);					///< Turn on/off packed output
   void setFlat(bool val);						///< Set whether nesting code structure should be emitted
 
@@ -227,11 +227,26 @@ rangemap<_recordtype>::insert(const inittype &data,linetype a,linetype b)
   typename std::list<_recordtype>::iterator liter;
   typename std::multiset<AddrRange>::iterator low = tree.lower_bound(AddrRange(f));
 
-  if (low != tree.end()) {
-    if ((*low).first < f)	// Check if left boundary refines existing partition
-      unzip(f-1,low);		// If so do the refinement
+  if (low == tree.end()) {
+    // Append fast path.  Every existing boundary point is less than the new range, so
+    // no refinement can occur, the record sorts after all others, and the single new
+    // sub-range belongs at the end of the tree.  Inserting with the end hint makes
+    // building a container from presorted records run in amortized constant time per record.
+    record.emplace_back( data, a, b );
+    liter = record.end();
+    --liter;
+    AddrRange addrrange(b,(*liter).getSubsort());
+    addrrange.first = a;
+    addrrange.a = a;
+    addrrange.b = b;
+    addrrange.value = liter;
+    tree.insert(tree.end(),addrrange);
+    return liter;
   }
 
+  if ((*low).first < f)		// Check if left boundary refines existing partition
+    unzip(f-1,low);		// If so do the refinement
+
   record.emplace_front( data, a, b );
   liter = record.begin();
 
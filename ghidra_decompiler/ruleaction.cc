@@ -20,6 +20,40 @@
 
 namespace ghidra {
 
+/// \brief Invoke a concrete Rule's applyOp() directly, bypassing virtual dispatch
+///
+/// The qualified call lets the compiler resolve the method at compile time and
+/// inline the body into the caller.
+/// \tparam T is the concrete Rule class
+/// \param rl is the Rule being applied
+/// \param op is the given PcodeOp where the Rule may apply
+/// \param data is the function to which to apply
+/// \return 1 if the Rule made changes, 0 otherwise
+template<class T>
+static inline int4 applyDirect(Rule *rl,PcodeOp *op,Funcdata &data)
+
+{
+  return ((T *)rl)->T::applyOp(op,data);
+}
+
+int4 ruleApplyFast(int4 fastid,Rule *rl,PcodeOp *op,Funcdata &data)
+
+{
+  switch(fastid) {
+  case fastid_collect_terms:
+    return applyDirect<RuleCollectTerms>(rl,op,data);
+  case fastid_term_order:
+    return applyDirect<RuleTermOrder>(rl,op,data);
+  case fastid_trivial_arith:
+    return applyDirect<RuleTrivialArith>(rl,op,data);
+  case fastid_trivial_bool:
+    return applyDirect<RuleTrivialBool>(rl,op,data);
+  case fastid_trivial_shift:
+    return applyDirect<RuleTrivialShift>(rl,op,data);
+  }
+  return rl->applyOp(op,data);	// Unrecognized id falls back to virtual dispatch
+}
+
 /// \class RuleEarlyRemoval
 /// \brief Get rid of unused PcodeOp objects where we can guarantee the output is unused
 int4 RuleEarlyRemoval::applyOp(PcodeOp *op,Funcdata &data)
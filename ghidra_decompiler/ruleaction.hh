@@ -29,6 +29,19 @@
 
 namespace ghidra {
 
+/// \brief Fast-path dispatch ids for the hottest rules
+///
+/// Rules that account for the bulk of applyOp() invocations register one of these
+/// ids in their constructor, routing their application through the devirtualized
+/// switch in ruleApplyFast() rather than the virtual call.
+enum RuleFastId {
+  fastid_collect_terms = 1,	///< RuleCollectTerms
+  fastid_term_order = 2,	///< RuleTermOrder
+  fastid_trivial_arith = 3,	///< RuleTrivialArith
+  fastid_trivial_bool = 4,	///< RuleTrivialBool
+  fastid_trivial_shift = 5	///< RuleTrivialShift
+};
+
 /// \brief Structure for sorting out pointer expression trees
 ///
 /// Given a base pointer of known data-type and an additive expression involving
@@ -102,7 +115,8 @@ public:
 class RuleCollectTerms : public Rule {
   static Varnode *getMultCoeff(Varnode *vn,uintb &coef);	///< Get the multiplicative coefficient
 public:
-  RuleCollectTerms(const string &g) : Rule(g, 0, "collect_terms") {}	///< Constructor
+  RuleCollectTerms(const string &g) : Rule(g, 0, "collect_terms") {
+    setFastId(fastid_collect_terms); }	///< Constructor
   virtual Rule *clone(const ActionGroupList &grouplist) const {
     if (!grouplist.contains(getGroup())) return (Rule *)0;
     return new RuleCollectTerms(getGroup());
@@ -253,7 +267,8 @@ public:
 // Reversible rules
 class RuleTermOrder : public Rule {
 public:
-  RuleTermOrder(const string &g) : Rule(g, 0, "termorder") {}	///< Constructor
+  RuleTermOrder(const string &g) : Rule(g, 0, "termorder") {
+    setFastId(fastid_term_order); }	///< Constructor
   virtual Rule *clone(const ActionGroupList &grouplist) const {
     if (!grouplist.contains(getGroup())) return (Rule *)0;
     return new RuleTermOrder(getGroup());
@@ -489,7 +504,8 @@ public:
 };
 class RuleTrivialArith : public Rule {
 public:
-  RuleTrivialArith(const string &g) : Rule(g, 0, "trivialarith") {}	///< Constructor
+  RuleTrivialArith(const string &g) : Rule(g, 0, "trivialarith") {
+    setFastId(fastid_trivial_arith); }	///< Constructor
   virtual Rule *clone(const ActionGroupList &grouplist) const {
     if (!grouplist.contains(getGroup())) return (Rule *)0;
     return new RuleTrivialArith(getGroup());
@@ -499,7 +515,8 @@ public:
 };
 class RuleTrivialBool : public Rule {
 public:
-  RuleTrivialBool(const string &g) : Rule(g, 0, "trivialbool") {}	///< Constructor
+  RuleTrivialBool(const string &g) : Rule(g, 0, "trivialbool") {
+    setFastId(fastid_trivial_bool); }	///< Constructor
   virtual Rule *clone(const ActionGroupList &grouplist) const {
     if (!grouplist.contains(getGroup())) return (Rule *)0;
     return new RuleTrivialBool(getGroup());
@@ -631,7 +648,8 @@ public:
 };
 class RuleTrivialShift : public Rule {
 public:
-  RuleTrivialShift(const string &g) : Rule(g, 0, "trivialshift") {}	///< Constructor
+  RuleTrivialShift(const string &g) : Rule(g, 0, "trivialshift") {
+    setFastId(fastid_trivial_shift); }	///< Constructor
   virtual Rule *clone(const ActionGroupList &grouplist) const {
     if (!grouplist.contains(getGroup())) return (Rule *)0;
     return new RuleTrivialShift(getGroup());
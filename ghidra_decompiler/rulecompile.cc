@@ -406,11 +406,7 @@ RuleCompile::~RuleCompile(void)
 {
   if (finalrule != (ConstraintGroup *)0)
     delete finalrule;
-  for(int4 i=0;i<inst.size();++i) {
-    OpBehavior *t_op = inst[i];
-    if (t_op != (OpBehavior *)0)
-      delete t_op;
-  }
+  OpBehavior::deregisterInstructions(inst);
 }
 
 void RuleCompile::ruleError(const char *s)
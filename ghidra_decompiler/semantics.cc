@@ -18,6 +18,32 @@
 
 namespace ghidra {
 
+TplArena::~TplArena(void)
+
+{
+  for(int4 i=0;i<slabs.size();++i)
+    ::operator delete(slabs[i]);
+}
+
+/// Storage is carved from the current slab if the request fits, otherwise a new
+/// slab is allocated.  A request bigger than the default slab size gets a slab
+/// of its own.
+/// \param bytes is the number of bytes of storage requested
+/// \return a pointer to the uninitialized storage
+void *TplArena::allocate(size_t bytes)
+
+{
+  bytes = (bytes + 15) & ~((size_t)0xf);	// Preserve maximal alignment between objects
+  if (fill + bytes > currentSize) {
+    currentSize = (bytes > SLAB_BYTES) ? bytes : SLAB_BYTES;
+    slabs.push_back((uint1 *)::operator new(currentSize));
+    fill = 0;
+  }
+  void *res = slabs.back() + fill;
+  fill += bytes;
+  return res;
+}
+
 ConstTpl::ConstTpl(const_type tp)
 
 {				// Constructor for relative jump constants and uniques
@@ -565,6 +591,18 @@ HandleTpl::HandleTpl(const ConstTpl &spc,const ConstTpl &sz,const VarnodeTpl *vn
 {				// Build handle to thing being pointed at by -vn-
 }
 
+bool HandleTpl::isFixed(void) const
+
+{ // Determine if fix() produces the same FixedHandle for every instruction,
+  // i.e. no template piece reads anything from the parser state
+  if (space.getType() != ConstTpl::spaceid) return false;
+  if (!size.isFixed() || !ptroffset.isFixed()) return false;
+  if (ptrspace.getType() == ConstTpl::real)
+    return true;		// Remaining pieces are not read
+  if (ptrspace.getType() != ConstTpl::spaceid) return false;
+  return (ptrsize.isFixed() && (temp_space.getType() == ConstTpl::spaceid) && temp_offset.isFixed());
+}
+
 void HandleTpl::fix(FixedHandle &hand,const ParserWalker &walker) const
 
 {
@@ -692,7 +730,11 @@ void OpTpl::encode(Encoder &encoder) const
   encoder.closeElement(sla::ELEM_OP_TPL);
 }
 
-void OpTpl::decode(Decoder &decoder)
+/// Decode \b this op and its varnodes, allocating the varnode nodes out of the
+/// given arena when one is provided.
+/// \param decoder is the stream decoder
+/// \param arena is the arena to allocate from (or null for individual heap nodes)
+void OpTpl::decode(Decoder &decoder,TplArena *arena)
 
 {
   uint4 el = decoder.openElement(sla::ELEM_OP_TPL);
@@ -704,11 +746,13 @@ void OpTpl::decode(Decoder &decoder)
     output = (VarnodeTpl *)0;
   }
   else {
-    output = new VarnodeTpl();
+    output = (arena == (TplArena *)0) ? new VarnodeTpl()
+      : new(arena->allocate(sizeof(VarnodeTpl))) VarnodeTpl();
     output->decode(decoder);
   }
   while(decoder.peekElement() != 0) {
-    VarnodeTpl *vn = new VarnodeTpl();
+    VarnodeTpl *vn = (arena == (TplArena *)0) ? new VarnodeTpl()
+      : new(arena->allocate(sizeof(VarnodeTpl))) VarnodeTpl();
     vn->decode(decoder);
     input.push_back(vn);
   }
@@ -719,10 +763,20 @@ ConstructTpl::~ConstructTpl(void)
 
 {				// Constructor owns its ops and handles
   vector<OpTpl *>::iterator oiter;
-  for(oiter=vec.begin();oiter!=vec.end();++oiter)
-    delete *oiter;
-  if (result != (HandleTpl *)0)
-    delete result;
+  if (arena == (TplArena *)0) {
+    for(oiter=vec.begin();oiter!=vec.end();++oiter)
+      delete *oiter;
+    if (result != (HandleTpl *)0)
+      delete result;
+  }
+  else {
+    // The nodes themselves are reclaimed with the arena; release only the
+    // input arrays the ops allocated on the side
+    for(oiter=vec.begin();oiter!=vec.end();++oiter) {
+      (*oiter)->detachNodes();
+      (*oiter)->~OpTpl();
+    }
+  }
 }
 
 bool ConstructTpl::addOp(OpTpl *ot)
@@ -873,9 +927,16 @@ void ConstructTpl::encode(Encoder &encoder,int4 sectionid) const
   encoder.closeElement(sla::ELEM_CONSTRUCT_TPL);
 }
 
-int4 ConstructTpl::decode(Decoder &decoder)
+/// Decode \b this template, allocating its ops, varnodes, and result handle out
+/// of the given arena when one is provided.  An arena-backed template must not
+/// be mutated afterward and must be destroyed before its arena.
+/// \param decoder is the stream decoder
+/// \param tplArena is the arena to allocate from (or null for individual heap nodes)
+/// \return the section id of the template (-1 for the main section)
+int4 ConstructTpl::decode(Decoder &decoder,TplArena *tplArena)
 
 {
+  arena = tplArena;
   uint4 el = decoder.openElement(sla::ELEM_CONSTRUCT_TPL);
   int4 sectionid = -1;
   uint4 attrib = decoder.getNextAttributeId();
@@ -898,12 +959,14 @@ int4 ConstructTpl::decode(Decoder &decoder)
     result = (HandleTpl *)0;
   }
   else {
-    result = new HandleTpl();
+    result = (arena == (TplArena *)0) ? new HandleTpl()
+      : new(arena->allocate(sizeof(HandleTpl))) HandleTpl();
     result->decode(decoder);
   }
   while(decoder.peekElement() != 0) {
-    OpTpl *op = new OpTpl();
-    op->decode(decoder);
+    OpTpl *op = (arena == (TplArena *)0) ? new OpTpl()
+      : new(arena->allocate(sizeof(OpTpl))) OpTpl();
+    op->decode(decoder,arena);
     vec.push_back(op);
   }
   decoder.closeElement(el);
@@ -31,6 +31,28 @@ namespace ghidra {
 
 class Translate;		// Forward declaration
 class HandleTpl;		// Forward declaration
+
+/// \brief Bump allocator backing the semantic templates of decoded constructors
+///
+/// Templates decoded from a .sla file are immutable once built, but their
+/// OpTpl/VarnodeTpl/HandleTpl nodes would otherwise be scattered across the
+/// heap.  Decoding through an arena packs the nodes of a subtable's templates
+/// into contiguous slabs, so the template walk performed for every emitted
+/// instruction stays within a few cache lines.  All storage is reclaimed at
+/// once when the arena is destroyed; templates built by the SLEIGH compiler or
+/// the p-code snippet parser, which are individually mutated and freed, do not
+/// use an arena.
+class TplArena {
+  static const int4 SLAB_BYTES = 65536;	///< Default number of bytes in one slab
+  vector<uint1 *> slabs;	///< Allocated slabs of raw storage
+  size_t fill;			///< Number of bytes used in the current slab
+  size_t currentSize;		///< Number of bytes in the current slab
+public:
+  TplArena(void) { fill = 0; currentSize = 0; }	///< Construct an empty arena
+  ~TplArena(void);		///< Destructor
+  void *allocate(size_t bytes);	///< Obtain raw storage for one template node
+};
+
 class ConstTpl {
 public:
   enum const_type { real=0, handle=1, j_start=2, j_next=3, j_next2=4, j_curspace=5, 
@@ -68,6 +90,7 @@ public:
   AddrSpace *fixSpace(const ParserWalker &walker) const;
   void transfer(const vector<HandleTpl *> &params);
   bool isZero(void) const { return ((type==real)&&(value_real==0)); }
+  bool isFixed(void) const { return ((type==real)||(type==spaceid)); }	// fix() reads nothing from the walker
   void changeHandleIndex(const vector<int4> &handmap);
   void fillinSpace(FixedHandle &hand,const ParserWalker &walker) const;
   void fillinOffset(FixedHandle &hand,const ParserWalker &walker) const;
@@ -129,6 +152,7 @@ public:
   void setPtrSize(const ConstTpl &sz) { ptrsize=sz; }
   void setPtrOffset(uintb val) { ptroffset = ConstTpl(ConstTpl::real,val); }
   void setTempOffset(uintb val) { temp_offset = ConstTpl(ConstTpl::real,val); }
+  bool isFixed(void) const;
   void fix(FixedHandle &hand,const ParserWalker &walker) const;
   void changeHandleIndex(const vector<int4> &handmap);
   void encode(Encoder &encoder) const;
@@ -136,9 +160,11 @@ public:
 };
 
 class OpTpl {
+  friend class ConstructTpl;
   VarnodeTpl *output;
   OpCode opc;
   vector<VarnodeTpl *> input;
+  void detachNodes(void) { output = (VarnodeTpl *)0; input.clear(); }	// Drop references to arena-owned varnodes
 public:
   OpTpl(void) {}
   OpTpl(OpCode oc) { opc = oc; output = (VarnodeTpl *)0; }
@@ -156,7 +182,7 @@ public:
   void removeInput(int4 index);
   void changeHandleIndex(const vector<int4> &handmap);
   void encode(Encoder &encoder) const;
-  void decode(Decoder &decoder);
+  void decode(Decoder &decoder,TplArena *arena);
 };
 
 class ConstructTpl {
@@ -166,10 +192,11 @@ protected:
   uint4 numlabels;		// Number of label templates
   vector<OpTpl *> vec;
   HandleTpl *result;
+  TplArena *arena;		// Arena owning the template nodes (null if individually heap-allocated)
   void setOpvec(vector<OpTpl *> &opvec) { vec = opvec; }
   void setNumLabels(uint4 val) { numlabels = val; }
 public:
-  ConstructTpl(void) { delayslot=0; numlabels=0; result = (HandleTpl *)0; }
+  ConstructTpl(void) { delayslot=0; numlabels=0; result = (HandleTpl *)0; arena = (TplArena *)0; }
   ~ConstructTpl(void);
   uint4 delaySlot(void) const { return delayslot; }
   uint4 numLabels(void) const { return numlabels; }
@@ -185,7 +212,7 @@ public:
   void setOutput(VarnodeTpl *vn,int4 index);
   void deleteOps(const vector<int4> &indices);
   void encode(Encoder &encoder,int4 sectionid) const;
-  int4 decode(Decoder &decoder);
+  int4 decode(Decoder &decoder,TplArena *tplArena);
 };
 
 class PcodeEmit;   // Forward declaration for emitter
@@ -0,0 +1,321 @@
+/**
+ * LoadImage implementations and the SleighArchitecture subclass shared by the
+ * gRPC server (server_main.cc) and the corpus benchmark (bench_main.cc).
+ * Everything here presents a flat in-memory (or memory-mapped) view of a raw
+ * binary to the decompiler core.
+ */
+#ifndef __SERVER_ARCH_HH__
+#define __SERVER_ARCH_HH__
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Kill Windows LoadImage macro
+#ifdef LoadImage
+#undef LoadImage
+#endif
+#ifdef LoadImageA
+#undef LoadImageA
+#endif
+#ifdef LoadImageW
+#undef LoadImageW
+#endif
+
+#include "sleigh_arch.hh"
+#include "loadimage.hh"
+#include "crc32.hh"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace ghidra;
+
+// Get directory containing the executable
+inline std::string getExecutableDir() {
+#ifdef _WIN32
+    char path[MAX_PATH];
+    GetModuleFileNameA(NULL, path, MAX_PATH);
+    std::string exePath(path);
+    size_t lastSlash = exePath.find_last_of("\\/");
+    if (lastSlash != std::string::npos) {
+        return exePath.substr(0, lastSlash);
+    }
+    return ".";
+#else
+    // Linux/Mac: read /proc/self/exe or use argv[0]
+    char path[4096];
+    ssize_t len = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    if (len != -1) {
+        path[len] = '\0';
+        std::string exePath(path);
+        size_t lastSlash = exePath.find_last_of("/");
+        if (lastSlash != std::string::npos) {
+            return exePath.substr(0, lastSlash);
+        }
+    }
+    return ".";
+#endif
+}
+
+// Common base for the server's LoadImage implementations: presents a flat
+// in-memory view of the binary to Sleigh plus the byte-level helpers the
+// RPC layer needs (hashing, raw byte export)
+class ServerLoadImage : public LoadImage {
+protected:
+    struct SectionRange {
+        uint64_t start;
+        uint64_t end;       // Exclusive
+        bool executable;
+    };
+    uint64_t base_addr_;
+    std::vector<SectionRange> sections_;  // Optional; empty = everything mapped
+    AddrSpace* code_space_ = nullptr;     // For reporting sections to codedata
+    mutable size_t section_cursor_ = 0;   // getNextSection() iteration state
+    ServerLoadImage(uint64_t base) : LoadImage("memory"), base_addr_(base) {}
+public:
+    virtual const uint1* buffer(void) const = 0;
+    virtual uint1* writableBuffer(void) = 0;
+    virtual size_t imageSize(void) const = 0;
+
+    uint64_t baseAddress(void) const { return base_addr_; }
+
+    // Patch image bytes in place; returns false if the range is out of bounds
+    bool writeBytes(uint64_t offset, const std::string& data) {
+        if (offset < base_addr_)
+            return false;
+        size_t pos = offset - base_addr_;
+        if (pos + data.size() > imageSize())
+            return false;
+        memcpy(writableBuffer() + pos, data.data(), data.size());
+        return true;
+    }
+
+    void addSection(uint64_t start, uint64_t length, bool executable) {
+        sections_.push_back({start, start + length, executable});
+    }
+
+    // Is the address inside an executable section (or is no map declared)
+    bool isExecutable(uint64_t offset) const {
+        if (sections_.empty())
+            return true;
+        for (const auto& sec : sections_) {
+            if (offset >= sec.start && offset < sec.end)
+                return sec.executable;
+        }
+        return false;
+    }
+
+    // End of the executable region containing offset: bulk disassembly may
+    // run up to (but never across) this address. With no section map the
+    // whole image is fair game.
+    uint64_t executableLimit(uint64_t offset) const {
+        if (sections_.empty())
+            return base_addr_ + imageSize();
+        for (const auto& sec : sections_) {
+            if (offset >= sec.start && offset < sec.end)
+                return sec.executable ? sec.end : offset;
+        }
+        return offset;
+    }
+
+    // Section iteration for the codedata sweep: present the executable
+    // sections (or the whole image when no map was declared) so runModel()
+    // only disassembles code regions
+    void setCodeSpace(AddrSpace* spc) { code_space_ = spc; }
+
+    virtual void openSectionInfo(void) const override { section_cursor_ = 0; }
+    virtual void closeSectionInfo(void) const override {}
+    virtual bool getNextSection(LoadImageSection &sec) const override {
+        std::vector<SectionRange> exec;
+        for (const auto& range : sections_)
+            if (range.executable)
+                exec.push_back(range);
+        if (exec.empty())
+            exec.push_back({base_addr_, base_addr_ + imageSize(), true});
+        if (section_cursor_ >= exec.size()) {
+            sec.address = Address(code_space_, base_addr_);
+            sec.size = 0;
+            sec.flags = LoadImageSection::unalloc;
+            return false;
+        }
+        const SectionRange& range = exec[section_cursor_];
+        sec.address = Address(code_space_, range.start);
+        sec.size = range.end - range.start;
+        sec.flags = LoadImageSection::code;
+        section_cursor_ += 1;
+        return (section_cursor_ < exec.size());
+    }
+
+    // Flow following truncates (as bad instruction data) instead of decoding
+    // into .data or unmapped ranges
+    virtual bool isExecutableAddress(const Address &addr) const override {
+        return isExecutable(addr.getOffset());
+    }
+
+    // Does [offset,offset+size) overlap any declared section
+    bool isMapped(uint64_t offset, int4 size) const {
+        if (sections_.empty())
+            return true;
+        for (const auto& sec : sections_) {
+            if (offset < sec.end && offset + size > sec.start)
+                return true;
+        }
+        return false;
+    }
+
+    virtual void loadFill(uint1 *ptr, int4 size, const Address &addr) override {
+        uint64_t offset = addr.getOffset();
+        uint64_t max = base_addr_ + imageSize();
+        const uint1* data = buffer();
+
+        // With a section map, reads entirely outside it are garbage that the
+        // flow follower would otherwise happily decode; fail them like bad
+        // instruction data so control flow truncates instead
+        if (!isMapped(offset, size))
+            throw BadDataError("Read from unmapped address");
+
+        // Fast path: the whole request lies inside the image
+        if (offset >= base_addr_ && offset + size <= max) {
+            memcpy(ptr, data + (offset - base_addr_), size);
+            return;
+        }
+
+        for(int4 i = 0; i < size; ++i) {
+            uint64_t cur = offset + i;
+            if (cur >= base_addr_ && cur < max) {
+                ptr[i] = data[cur - base_addr_];
+            } else {
+                ptr[i] = 0;
+            }
+        }
+    }
+
+    virtual string getArchType(void) const override { return "memory"; }
+    virtual void adjustVma(long adjust) override {}
+
+    // CRC32 of up to \e max bytes of image starting at \e offset
+    uint4 hashBytes(uint64_t offset, size_t max) const {
+        uint4 reg = 0xffffffff;
+        if (offset < base_addr_ || offset >= base_addr_ + imageSize())
+            return 0;
+        size_t pos = offset - base_addr_;
+        size_t count = imageSize() - pos;
+        if (count > max)
+            count = max;
+        const uint1* data = buffer();
+        reg = crc_update_bytes(reg, data + pos, static_cast<int4>(count));
+        return reg ^ 0xffffffff;
+    }
+
+    // Copy raw image bytes at \e offset into \e out; returns bytes copied
+};
+
+// Holds a private copy of the bytes shipped through LoadBinaryRequest
+class MemoryLoadImage : public ServerLoadImage {
+    std::string data_;
+public:
+    MemoryLoadImage(const std::string& d, uint64_t base)
+        : ServerLoadImage(base), data_(d) {}
+
+    virtual const uint1* buffer(void) const override {
+        return reinterpret_cast<const uint1*>(data_.data());
+    }
+    virtual uint1* writableBuffer(void) override {
+        return reinterpret_cast<uint1*>(&data_[0]);
+    }
+    virtual size_t imageSize(void) const override { return data_.size(); }
+};
+
+// Memory-maps a server-local file: instruction fetches read straight from
+// the page cache with no protobuf transfer and no private copy. The mapping
+// is copy-on-write so PatchBytes never touches the file on disk.
+class MmapLoadImage : public ServerLoadImage {
+    uint1* map_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = NULL;
+#endif
+public:
+    MmapLoadImage(const std::string& path, uint64_t base)
+        : ServerLoadImage(base) {
+#ifdef _WIN32
+        file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file_ == INVALID_HANDLE_VALUE)
+            throw LowlevelError("Unable to open file: " + path);
+        LARGE_INTEGER sz;
+        GetFileSizeEx(file_, &sz);
+        size_ = static_cast<size_t>(sz.QuadPart);
+        mapping_ = CreateFileMappingA(file_, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+        if (mapping_ == NULL) {
+            CloseHandle(file_);
+            throw LowlevelError("Unable to map file: " + path);
+        }
+        map_ = static_cast<uint1*>(MapViewOfFile(mapping_, FILE_MAP_COPY, 0, 0, 0));
+        if (map_ == nullptr) {
+            CloseHandle(mapping_);
+            CloseHandle(file_);
+            throw LowlevelError("Unable to map file: " + path);
+        }
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw LowlevelError("Unable to open file: " + path);
+        struct stat st;
+        if (fstat(fd, &st) < 0) {
+            close(fd);
+            throw LowlevelError("Unable to stat file: " + path);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        void* m = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close(fd);  // Mapping keeps its own reference
+        if (m == MAP_FAILED)
+            throw LowlevelError("Unable to map file: " + path);
+        map_ = static_cast<uint1*>(m);
+#endif
+    }
+
+    ~MmapLoadImage() {
+#ifdef _WIN32
+        if (map_ != nullptr) UnmapViewOfFile(map_);
+        if (mapping_ != NULL) CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+#else
+        if (map_ != nullptr) munmap(map_, size_);
+#endif
+    }
+
+    virtual const uint1* buffer(void) const override { return map_; }
+    virtual uint1* writableBuffer(void) override { return map_; }
+    virtual size_t imageSize(void) const override { return size_; }
+};
+
+// Custom Architecture that uses one of our LoadImage implementations
+class ServerArchitecture : public SleighArchitecture {
+    ServerLoadImage* custom_loader;
+public:
+    ServerArchitecture(const string& sleigh_id, ServerLoadImage* ldr, ostream* err)
+        : SleighArchitecture("", sleigh_id, err), custom_loader(ldr) {}
+    
+    virtual void buildLoader(DocumentStorage& store) override {
+        loader = custom_loader;  // Use our custom loader
+    }
+
+    // Point an already initialized architecture at a different image. Used
+    // by the warm pool: the expensive spec parsing happened against a
+    // placeholder loader and only the byte source changes here.
+    void setLoader(ServerLoadImage* ldr) {
+        custom_loader = ldr;
+        loader = ldr;
+    }
+};
+
+#endif
@@ -11,12 +11,29 @@
 #include <string>
 #include <thread>
 #include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <map>
+#include <list>
+#include <tuple>
+#include <atomic>
 #include <vector>
+#include <queue>
+#include <functional>
+#include <condition_variable>
 #include <sstream>
 #include <set>
+#include <algorithm>
 #include <fstream>
+#include <cstring>
+#include <chrono>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 #include <grpcpp/grpcpp.h>
+#include <google/protobuf/arena.h>
 #include "ghidra_service.grpc.pb.h"
 
 // Kill Windows LoadImage macro
@@ -34,83 +51,224 @@
 #include "libdecomp.hh"
 #include "sleigh_arch.hh"
 #include "loadimage.hh"
+#include "crc32.hh"
+#include "action.hh"
+#include "grammar.hh"
+#include "marshal.hh"
+#include "codedata.hh"
+#include "graph.hh"
+#include "server_arch.hh"
 
-using grpc::Server;
-using grpc::ServerBuilder;
-using grpc::ServerContext;
-using grpc::Status;
-using namespace ghidra_service;
-using namespace ghidra;
-
-#ifdef _WIN32
-#include <windows.h>
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 
-// Get directory containing the executable
-static std::string getExecutableDir() {
+// Peak resident set size of the process so far, in kilobytes (0 where the
+// platform doesn't expose it)
+static uint64_t processPeakRssKb() {
 #ifdef _WIN32
-    char path[MAX_PATH];
-    GetModuleFileNameA(NULL, path, MAX_PATH);
-    std::string exePath(path);
-    size_t lastSlash = exePath.find_last_of("\\/");
-    if (lastSlash != std::string::npos) {
-        return exePath.substr(0, lastSlash);
-    }
-    return ".";
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#ifdef __APPLE__
+    return static_cast<uint64_t>(usage.ru_maxrss) / 1024;  // Reported in bytes
 #else
-    // Linux/Mac: read /proc/self/exe or use argv[0]
-    char path[4096];
-    ssize_t len = readlink("/proc/self/exe", path, sizeof(path) - 1);
-    if (len != -1) {
-        path[len] = '\0';
-        std::string exePath(path);
-        size_t lastSlash = exePath.find_last_of("/");
-        if (lastSlash != std::string::npos) {
-            return exePath.substr(0, lastSlash);
-        }
-    }
-    return ".";
+    return static_cast<uint64_t>(usage.ru_maxrss);         // Reported in KB
+#endif
 #endif
 }
 
-// Custom LoadImage - feeds bytes to Sleigh
-class MemoryLoadImage : public LoadImage {
-    std::string data_;
-    uint64_t base_addr_;
+// Arms the per-thread Action deadline for the enclosing scope
+struct ActionTimeoutGuard {
+    ActionTimeoutGuard(uint32_t ms) { ghidra::Action::startTimeout(ms); }
+    ~ActionTimeoutGuard() { ghidra::Action::clearTimeout(); }
+};
+
+// Routes the per-thread Action cancel test at the RPC's cancellation state
+struct ActionCancelGuard {
+    static bool test(void* ctx) {
+        return static_cast<grpc::ServerContextBase*>(ctx)->IsCancelled();
+    }
+    ActionCancelGuard(grpc::ServerContextBase* ctx) {
+        if (ctx != nullptr)
+            ghidra::Action::setCancelCallback(&ActionCancelGuard::test, ctx);
+    }
+    ~ActionCancelGuard() { ghidra::Action::clearCancelCallback(); }
+};
+
+// Parks a background decompilation between actions for as long as any
+// interactive request is in flight, so triage sweeps never add latency to
+// the analyst's clicks
+struct ActionYieldGuard {
+    static void wait(void* counter) {
+        auto* active = static_cast<std::atomic<int>*>(counter);
+        while (active->load() > 0 && !ghidra::Action::isAborted())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ActionYieldGuard(std::atomic<int>* active) {
+        if (active != nullptr)
+            ghidra::Action::setYieldCallback(&ActionYieldGuard::wait, active);
+    }
+    ~ActionYieldGuard() { ghidra::Action::clearYieldCallback(); }
+};
+
+// Fixed-size thread pool that keeps long-running decompilation work off the
+// gRPC event threads, so cheap RPCs (Ping, cache hits, disassembly) stay
+// sub-millisecond while decompiles grind in the background.
+class Executor {
+    std::vector<std::thread> threads_;
+    // Two-level queue: foreground jobs always dispatch ahead of queued
+    // background work (batch triage, prefetch)
+    std::queue<std::function<void()>> work_;
+    std::queue<std::function<void()>> bg_work_;
+    std::mutex mu_;
+    std::condition_variable cv_;
+    bool shutdown_ = false;
+
+    void run() {
+        for (;;) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mu_);
+                cv_.wait(lock, [this] { return shutdown_ || !work_.empty() || !bg_work_.empty(); });
+                if (shutdown_ && work_.empty() && bg_work_.empty())
+                    return;
+                std::queue<std::function<void()>>& q = work_.empty() ? bg_work_ : work_;
+                job = std::move(q.front());
+                q.pop();
+            }
+            job();
+        }
+    }
+
 public:
-    MemoryLoadImage(const std::string& d, uint64_t base) 
-        : LoadImage("memory"), data_(d), base_addr_(base) {}
-    
-    virtual void loadFill(uint1 *ptr, int4 size, const Address &addr) override {
-        uint64_t offset = addr.getOffset();
-        uint64_t max = base_addr_ + data_.size();
-        
-        for(int4 i = 0; i < size; ++i) {
-            uint64_t cur = offset + i;
-            if (cur >= base_addr_ && cur < max) {
-                ptr[i] = static_cast<uint1>(data_[cur - base_addr_]);
+    explicit Executor(unsigned nthreads) {
+        if (nthreads == 0)
+            nthreads = 1;
+        for (unsigned i = 0; i < nthreads; ++i)
+            threads_.emplace_back(&Executor::run, this);
+    }
+
+    ~Executor() {
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            shutdown_ = true;
+        }
+        cv_.notify_all();
+        for (auto& t : threads_)
+            t.join();
+    }
+
+    void submit(std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            work_.push(std::move(job));
+        }
+        cv_.notify_one();
+    }
+
+    void submitBackground(std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            bg_work_.push(std::move(job));
+        }
+        cv_.notify_one();
+    }
+
+    // Jobs waiting (foreground + background); a persistently deep queue is
+    // the first sign of an overloaded or wedged instance
+    size_t queueDepth() {
+        std::lock_guard<std::mutex> lock(mu_);
+        return work_.size() + bg_work_.size();
+    }
+
+    size_t numThreads() const { return threads_.size(); }
+};
+
+// NUMA layout of the host, read once from sysfs. Each Funcdata workload has a
+// large private working set, so batch workers are pinned to one node apiece:
+// the whole node rather than a single CPU, leaving the kernel free to balance
+// across that socket's cores without migrating the working set off-socket.
+// Everything a pinned worker allocates (analysis containers, protobuf arena
+// slabs) is placed on its node by first touch. On non-Linux hosts, or when
+// sysfs describes no nodes, the topology collapses to one node and pinning is
+// a no-op.
+class NumaTopology {
+    std::vector<std::vector<int>> node_cpus_;
+
+    // Parse a sysfs cpulist like "0-15,32-47" into explicit CPU ids
+    static std::vector<int> parseCpuList(const std::string& txt) {
+        std::vector<int> cpus;
+        std::stringstream ss(txt);
+        std::string piece;
+        while (std::getline(ss, piece, ',')) {
+            size_t dash = piece.find('-');
+            int lo, hi;
+            if (dash == std::string::npos) {
+                lo = hi = atoi(piece.c_str());
             } else {
-                ptr[i] = 0;
+                lo = atoi(piece.substr(0, dash).c_str());
+                hi = atoi(piece.substr(dash + 1).c_str());
             }
+            for (int c = lo; c <= hi && c >= lo; ++c)
+                cpus.push_back(c);
         }
+        return cpus;
+    }
+
+    NumaTopology() {
+#ifdef __linux__
+        for (int node = 0;; ++node) {
+            std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) +
+                             "/cpulist");
+            if (!in)
+                break;
+            std::string line;
+            std::getline(in, line);
+            std::vector<int> cpus = parseCpuList(line);
+            if (!cpus.empty())
+                node_cpus_.push_back(std::move(cpus));
+        }
+#endif
+        if (node_cpus_.empty())
+            node_cpus_.emplace_back();  // Single anonymous node; pinning disabled
     }
-    
-    virtual string getArchType(void) const override { return "memory"; }
-    virtual void adjustVma(long adjust) override {}
-};
 
-// Custom Architecture that uses our MemoryLoadImage
-class ServerArchitecture : public SleighArchitecture {
-    MemoryLoadImage* custom_loader;
 public:
-    ServerArchitecture(const string& sleigh_id, MemoryLoadImage* ldr, ostream* err)
-        : SleighArchitecture("", sleigh_id, err), custom_loader(ldr) {}
-    
-    virtual void buildLoader(DocumentStorage& store) override {
-        loader = custom_loader;  // Use our custom loader
+    static const NumaTopology& get() {
+        static NumaTopology topo;
+        return topo;
+    }
+
+    unsigned numNodes() const { return (unsigned)node_cpus_.size(); }
+
+    // Restrict the calling thread to the given node's CPUs
+    void pinToNode(unsigned node) const {
+#ifdef __linux__
+        const std::vector<int>& cpus = node_cpus_[node % node_cpus_.size()];
+        if (cpus.empty())
+            return;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int c : cpus)
+            CPU_SET(c, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
     }
 };
 
+using grpc::Server;
+using grpc::ServerBuilder;
+using grpc::ServerContext;
+using grpc::Status;
+using namespace ghidra_service;
+using namespace ghidra;
+
 // Assembly Emitter - captures disassembly output
 class ServerAssemblyEmit : public AssemblyEmit {
 public:
@@ -123,263 +281,3541 @@ public:
     }
 };
 
-class DecompilerServiceImpl final : public DecompilerService::Service {
-    std::mutex mu_;
-    std::unique_ptr<MemoryLoadImage> loader;
-    std::unique_ptr<ServerArchitecture> arch;
-    uint64_t base_address = 0;
-    bool initialized = false;
-    
+// Collects a whole disassembled range (one row per instruction) from a
+// single printAssemblyRange() call
+class RangeAssemblyEmit : public AssemblyEmit {
 public:
-    DecompilerServiceImpl() {
-        // Get executable directory and compute paths relative to it
-        std::string exeDir = getExecutableDir();
-        
-        // Try multiple possible locations for the languages folder:
-        // 1. <exe_dir>/../../ghidra_decompiler/languages (when exe is in build/Release)
-        // 2. <exe_dir>/../ghidra_decompiler/languages (when exe is in build)
-        // 3. <exe_dir>/languages (deployed scenario)
-        std::vector<std::pair<std::string, std::string>> searchPaths = {
-            {exeDir + "/../../ghidra_decompiler", exeDir + "/../../ghidra_decompiler/languages"},
-            {exeDir + "/../ghidra_decompiler", exeDir + "/../ghidra_decompiler/languages"},
-            {exeDir, exeDir + "/languages"}
-        };
-        
-        std::string baseDir;
-        std::string langDir;
-        
-        for (const auto& paths : searchPaths) {
-            std::ifstream test(paths.second + "/x86.ldefs");
-            if (test.good()) {
-                baseDir = paths.first;
-                langDir = paths.second;
-                break;
-            }
-        }
-        
-        if (langDir.empty()) {
-            std::cerr << "[Server] ERROR: Could not find languages directory!" << std::endl;
-            std::cerr << "[Server] Searched from: " << exeDir << std::endl;
-            return;
+    struct Row {
+        uint64_t address;
+        string mnem;
+        string body;
+    };
+    std::vector<Row> rows;
+
+    virtual void dump(const Address &addr, const string &m, const string &b) override {
+        rows.push_back(Row{addr.getOffset(), m, b});
+    }
+};
+
+// ostream buffer that hands fixed-size chunks of the pretty-printed C output
+// to a callback as EmitPrettyPrint produces it, instead of accumulating the
+// whole document in one string
+class ChunkStreamBuf : public std::streambuf {
+public:
+    static constexpr size_t CHUNK_BYTES = 64 * 1024;
+
+    explicit ChunkStreamBuf(const std::function<void(const std::string&)>& sink)
+        : sink_(sink) { buf_.reserve(CHUNK_BYTES); }
+
+    // Push any buffered tail; call once after the document is complete
+    void finish() {
+        if (!buf_.empty()) {
+            sink_(buf_);
+            buf_.clear();
         }
-        
-        std::cout << "[Server] Base directory: " << baseDir << std::endl;
-        std::cout << "[Server] Languages directory: " << langDir << std::endl;
-        
-        // Initialize Ghidra library (registers print languages, capabilities, etc.)
-        startDecompilerLibrary(baseDir.c_str());
-        // Manually add the languages directory to specpaths
-        SleighArchitecture::specpaths.addDir2Path(langDir);
-        // Parse .ldefs files by calling getDescriptions()
-        try {
-            SleighArchitecture::getDescriptions();
-        } catch (const LowlevelError& e) {
-            std::cerr << "[Server Init] Warning: " << e.explain << std::endl;
+    }
+
+protected:
+    int overflow(int ch) override {
+        if (ch != traits_type::eof()) {
+            buf_.push_back((char)ch);
+            if (buf_.size() >= CHUNK_BYTES)
+                finish();
         }
+        return ch;
     }
-    
-    ~DecompilerServiceImpl() {
-        cleanup();
+
+    std::streamsize xsputn(const char* data, std::streamsize n) override {
+        buf_.append(data, n);
+        if (buf_.size() >= CHUNK_BYTES)
+            finish();
+        return n;
     }
-    
-    void cleanup() {
-        arch.reset();
-        loader.reset();
-        initialized = false;
+
+private:
+    const std::function<void(const std::string&)>& sink_;
+    std::string buf_;
+};
+
+// Streambuf that appends into a caller-owned string. Lets a worker thread
+// keep one output allocation alive and reuse it for every function it
+// prints, instead of growing a fresh ostringstream per document.
+class StringStreamBuf : public std::streambuf {
+public:
+    explicit StringStreamBuf(std::string& out) : out_(out) {}
+
+protected:
+    int overflow(int ch) override {
+        if (ch != traits_type::eof())
+            out_.push_back((char)ch);
+        return ch;
     }
 
-    Status LoadBinary(ServerContext* ctx, const LoadBinaryRequest* request,
-                      LoadBinaryResponse* reply) override {
-        std::lock_guard<std::mutex> lock(mu_);
-        
-        try {
-            std::cout << "[Server] Loading binary: " << request->binary_content().size() << " bytes" << std::endl;
-            cleanup();
-            
-            base_address = request->base_address();
-            
-            // Create custom loader
-            loader = std::make_unique<MemoryLoadImage>(request->binary_content(), base_address);
-            
-            // Get language ID (e.g., "x86:LE:64:default")
-            string lang_id = request->arch_spec();
-            if (lang_id.empty()) {
-                lang_id = "x86:LE:64:default";
+    std::streamsize xsputn(const char* data, std::streamsize n) override {
+        out_.append(data, n);
+        return n;
+    }
+
+private:
+    std::string& out_;
+};
+
+// Low-level emitter that, besides writing plain text to the output stream,
+// records committed tokens (syntax class, text, machine address) and/or the
+// line/column span of each statement into the reply, so clients can
+// colorize and map cursors back to addresses without re-lexing the C output
+class TokenEmit : public EmitNoMarkup {
+public:
+    TokenEmit(DecompileResponse* reply, bool record_tokens, bool record_lines)
+        : reply_(reply), record_tokens_(record_tokens), record_lines_(record_lines) {}
+
+    int4 beginStatement(const PcodeOp* op) override {
+        if (record_lines_)
+            stmt_stack_.push_back({line_, col_, opAddress(op)});
+        return EmitNoMarkup::beginStatement(op);
+    }
+    void endStatement(int4 id) override {
+        if (record_lines_ && !stmt_stack_.empty()) {
+            const OpenStmt& stmt = stmt_stack_.back();
+            if (stmt.address != 0) {
+                ghidra_service::LineAddr* entry = reply_->add_line_map();
+                entry->set_start_line(stmt.line);
+                entry->set_start_col(stmt.col);
+                entry->set_end_line(line_);
+                entry->set_end_col(col_);
+                entry->set_address(stmt.address);
             }
-            std::cout << "[Server] Language ID: " << lang_id << std::endl;
-            
-            // Create Architecture
-            arch = std::make_unique<ServerArchitecture>(lang_id, loader.get(), &std::cerr);
-            
-            // Initialize with DocumentStorage
-            DocumentStorage store;
-            arch->init(store);
-            
-            initialized = true;
-            reply->set_success(true);
-            std::cout << "[Server] Binary loaded successfully" << std::endl;
-            
-        } catch (const LowlevelError& e) {
-            std::cerr << "[Server] Ghidra error: " << e.explain << std::endl;
-            cleanup();
-            reply->set_success(false);
-            reply->set_error_message(e.explain);
-        } catch (const std::exception& e) {
-            std::cerr << "[Server] Error: " << e.what() << std::endl;
-            cleanup();
-            reply->set_success(false);
-            reply->set_error_message(e.what());
-        } catch (...) {
-            std::cerr << "[Server] Unknown error" << std::endl;
-            cleanup();
-            reply->set_success(false);
-            reply->set_error_message("Unknown exception during initialization");
+            stmt_stack_.pop_back();
         }
-        
-        return Status::OK;
+        EmitNoMarkup::endStatement(id);
     }
 
-    Status DecompileFunction(ServerContext* ctx, const DecompileRequest* request,
-                     DecompileResponse* reply) override {
-        std::lock_guard<std::mutex> lock(mu_);
-        
-        if (!initialized || !arch) {
-            reply->set_success(false);
-            reply->set_error_message("Binary not loaded");
-            return Status::OK;
-        }
+    void tagLine(void) override {
+        EmitNoMarkup::tagLine();
+        add(EmitMarkup::no_color, "\n" + std::string(indentlevel, ' '), 0);
+    }
+    void tagLine(int4 indent) override {
+        EmitNoMarkup::tagLine(indent);
+        add(EmitMarkup::no_color, "\n" + std::string(indent, ' '), 0);
+    }
+    void tagVariable(const string& name, syntax_highlight hl,
+                     const Varnode* vn, const PcodeOp* op) override {
+        EmitNoMarkup::tagVariable(name, hl, vn, op);
+        add(hl, name, opAddress(op));
+    }
+    void tagOp(const string& name, syntax_highlight hl, const PcodeOp* op) override {
+        EmitNoMarkup::tagOp(name, hl, op);
+        add(hl, name, opAddress(op));
+    }
+    void tagFuncName(const string& name, syntax_highlight hl,
+                     const Funcdata* fd, const PcodeOp* op) override {
+        EmitNoMarkup::tagFuncName(name, hl, fd, op);
+        add(hl, name, fd != nullptr ? fd->getAddress().getOffset() : opAddress(op));
+    }
+    void tagType(const string& name, syntax_highlight hl, const Datatype* ct) override {
+        EmitNoMarkup::tagType(name, hl, ct);
+        add(hl, name, 0);
+    }
+    void tagField(const string& name, syntax_highlight hl, const Datatype* ct,
+                  int4 off, const PcodeOp* op) override {
+        EmitNoMarkup::tagField(name, hl, ct, off, op);
+        add(hl, name, opAddress(op));
+    }
+    void tagComment(const string& name, syntax_highlight hl,
+                    const AddrSpace* spc, uintb off) override {
+        EmitNoMarkup::tagComment(name, hl, spc, off);
+        add(hl, name, off);
+    }
+    void tagLabel(const string& name, syntax_highlight hl,
+                  const AddrSpace* spc, uintb off) override {
+        EmitNoMarkup::tagLabel(name, hl, spc, off);
+        add(hl, name, off);
+    }
+    void tagCaseLabel(const string& name, syntax_highlight hl,
+                      const PcodeOp* op, uintb value) override {
+        EmitNoMarkup::tagCaseLabel(name, hl, op, value);
+        add(hl, name, opAddress(op));
+    }
+    void print(const string& data, syntax_highlight hl = no_color) override {
+        EmitNoMarkup::print(data, hl);
+        add(hl, data, 0);
+    }
+    int4 openParen(const string& paren, int4 id = 0) override {
+        add(EmitMarkup::no_color, paren, 0);
+        return EmitNoMarkup::openParen(paren, id);
+    }
+    void closeParen(const string& paren, int4 id) override {
+        add(EmitMarkup::no_color, paren, 0);
+        EmitNoMarkup::closeParen(paren, id);
+    }
 
-        try {
-            Address func_addr(arch->getDefaultCodeSpace(), request->address());
-            std::cout << "[Server] Decompiling function at 0x" << std::hex << request->address() << std::dec << std::endl;
-            
-            // Create function name
-            std::ostringstream fname;
-            fname << "func_" << std::hex << request->address();
-            
-            // Find or create function in symbol table
-            Scope* global_scope = arch->symboltab->getGlobalScope();
-            Funcdata* fd = global_scope->findFunction(func_addr);
-            
-            if (fd == nullptr) {
-                // Create a new function
-                fd = global_scope->addFunction(func_addr, fname.str())->getFunction();
-            }
-            
-            if (fd == nullptr) {
-                reply->set_success(false);
-                reply->set_error_message("Failed to create function");
-                return Status::OK;
-            }
-            
-            // Clear any previous analysis
-            if (fd->isProcStarted()) {
-                arch->clearAnalysis(fd);
-            }
-            
-            // Perform decompilation
-            std::cout << "[Server] Running decompile actions..." << std::endl;
-            arch->allacts.getCurrent()->reset(*fd);
-            int4 res = arch->allacts.getCurrent()->perform(*fd);
-            
-            if (res < 0) {
-                std::cout << "[Server] Decompilation incomplete (break point hit)" << std::endl;
+private:
+    struct OpenStmt {
+        uint32_t line;
+        uint32_t col;
+        uint64_t address;
+    };
+
+    void add(syntax_highlight hl, const std::string& text, uint64_t addr) {
+        if (record_tokens_) {
+            ghidra_service::CToken* tok = reply_->add_tokens();
+            tok->set_kind((uint32_t)hl);
+            tok->set_text(text);
+            if (addr != 0)
+                tok->set_address(addr);
+        }
+        // Track the cursor position within the emitted text
+        for (char c : text) {
+            if (c == '\n') {
+                line_ += 1;
+                col_ = 0;
             } else {
-                std::cout << "[Server] Decompilation complete" << std::endl;
-            }
-            
-            // ===== Generate C Code =====
-            std::ostringstream c_stream;
-            arch->print->setOutputStream(&c_stream);
-            arch->print->docFunction(fd);
-            
-            reply->set_c_code(c_stream.str());
-            reply->set_signature(fd->getName() + "()");
-            reply->set_success(true);
-            
-            // ===== Generate Disassembly Blocks =====
-            ghidra_service::BasicBlock* pb_block = reply->add_blocks();
-            pb_block->set_start_addr(func_addr.getOffset());
-            pb_block->set_id(func_addr.getOffset());
-            
-            // Simple linear disassembly
-            Address cur = func_addr;
-            int instr_count = 0;
-            const int MAX_INSTRS = 200;
-            
-            while(instr_count < MAX_INSTRS) {
-                ServerAssemblyEmit emit;
-                int4 length = arch->translate->printAssembly(emit, cur);
-                
-                if (length <= 0) break;
-                
-                ghidra_service::Instruction* pb_instr = pb_block->add_instructions();
-                pb_instr->set_address(cur.getOffset());
-                pb_instr->set_length(length);
-                pb_instr->set_mnemonic(emit.mnem);
-                pb_instr->set_operands(emit.body);
-                
-                // Stop at RET
-                if (emit.mnem.find("RET") != string::npos) {
-                    break;
-                }
-                
-                cur = cur + length;
-                instr_count++;
+                col_ += 1;
             }
-            pb_block->set_end_addr(cur.getOffset());
-            
-            std::cout << "[Server] Generated " << instr_count << " instructions" << std::endl;
-            
-        } catch (const LowlevelError& e) {
-            std::cerr << "[Server] Decompile error: " << e.explain << std::endl;
-            reply->set_success(false);
-            reply->set_error_message(e.explain);
-        } catch (const std::exception& e) {
-            std::cerr << "[Server] Decompile error: " << e.what() << std::endl;
-            reply->set_success(false);
-            reply->set_error_message(e.what());
-        } catch (...) {
-            std::cerr << "[Server] Unknown decompile error" << std::endl;
-            reply->set_success(false);
-            reply->set_error_message("Unknown exception during decompilation");
         }
-        
-        return Status::OK;
     }
-
-    Status DisassembleRange(ServerContext* ctx, const DisassembleRequest* request,
-                     DisassembleResponse* reply) override {
-        return Status::OK;
+    static uint64_t opAddress(const PcodeOp* op) {
+        return op != nullptr ? op->getAddr().getOffset() : 0;
     }
 
-    Status Ping(ServerContext* context, const PingRequest* request,
-                PingResponse* reply) override {
-        reply->set_alive(true);
-        return Status::OK;
-    }
+    DecompileResponse* reply_;
+    bool record_tokens_;
+    bool record_lines_;
+    uint32_t line_ = 1;
+    uint32_t col_ = 0;
+    std::vector<OpenStmt> stmt_stack_;
 };
 
-void RunServer() {
-    std::string server_address("0.0.0.0:50051");
-    DecompilerServiceImpl service;
+// One loaded binary and everything that hangs off it. The expensive
+// process-wide setup (startDecompilerLibrary + parsed .ldefs descriptions)
+// is shared by all sessions, so creating a session only pays for the
+// architecture init of that one binary.
+struct Session {
+    std::string id;  // Key in the service's session table
+    // LoadBinary takes state_mu_ exclusively (it swaps out the whole
+    // architecture); decompile/disassemble RPCs take it shared so gRPC's
+    // handler threads can run them in parallel.
+    std::shared_mutex state_mu_;
+    // One lock per function entry address: two clients asking for the same
+    // function serialize (and the second one finds the analysis warm), while
+    // requests for different functions proceed concurrently.
+    std::mutex func_mu_table_lock_;
+    std::unordered_map<uint64_t, std::shared_ptr<std::mutex>> func_mu_table_;
+    // Guards shared architecture structures (symbol table, action selection)
+    // that are touched briefly at the start of each decompilation.
+    std::mutex symtab_mu_;
+    std::unique_ptr<ServerLoadImage> loader;
+    std::unique_ptr<ServerArchitecture> arch;
+    // Printers for the output phase, one checked out per in-flight
+    // decompile. The printer carries mutable emit state and cannot be
+    // shared, but constructing one is cheap (the op-token tables are
+    // static), so workers print concurrently instead of serializing on
+    // arch->print. Released printers keep their buffer capacity warm.
+    std::mutex printer_mu_;
+    std::vector<std::unique_ptr<PrintLanguage>> printer_pool_;
+    // Private clones of the decompiler's root Actions, keyed by root name.
+    // The registered tree in arch->allacts carries mutable per-run state
+    // (status, apply counts, break points) and cannot be shared by two
+    // concurrent runs, but the grouplists and derivation recipe it holds
+    // are immutable once built; each worker leases its own clone of the
+    // tree and returns it to the pool when the run completes.
+    std::mutex action_mu_;
+    std::map<std::string, std::vector<std::unique_ptr<Action>>> action_pool_;
+    // Performance preset ("fast"/"balanced"/"thorough") last applied to the
+    // architecture, sticky until a request names a different one; guarded by
+    // symtab_mu_ like the other architecture mutations
+    std::string applied_preset_;
+    uint64_t base_address = 0;
+    std::atomic<bool> initialized{false};
+    // Identifies the exact LoadBinary request currently loaded; guarded by
+    // state_mu_. Cleared when the image diverges from it (PatchBytes).
+    std::string load_fingerprint_;
 
-    ServerBuilder builder;
-    builder.AddListeningPort(server_address, grpc::InsecureServerCredentials());
-    builder.RegisterService(&service);
-    
-    std::unique_ptr<Server> server(builder.BuildAndStart());
+    // LRU cache of finished decompilations. Keyed by entry address, a CRC32
+    // of the bytes at the entry point, the request flags that change the
+    // response shape, and the action group that produced it (a "preview"
+    // result must never satisfy a full-pipeline request). A cold client
+    // cache (restart, second analyst) then costs a map lookup instead of a
+    // full action pipeline run.
+    typedef std::tuple<uint64_t, uint4, bool, bool, std::string, bool, bool, bool> CacheKey;
+    static const size_t CACHE_MAX = 256;      // Entries kept per session
+    static const size_t CACHE_HASH_WINDOW = 4096;  // Bytes hashed from entry point
+    std::mutex cache_mu_;
+    std::list<std::pair<CacheKey, DecompileResponse>> cache_lru_;
+    std::map<CacheKey, std::list<std::pair<CacheKey, DecompileResponse>>::iterator> cache_index_;
+    // Sidecar file holding an on-disk copy of the cache. Fission restarts
+    // this server routinely, and without persistence every restart re-pays
+    // full analysis of everything the analyst had open. Only binaries loaded
+    // by path get a sidecar: a byte-shipped image has no stable identity to
+    // name one by. Keys carry the function byte-hash, so entries for patched
+    // bytes stop matching instead of needing an explicit flush.
+    std::string cache_path_;  // Empty = persistence disabled
+
+    // Whole-binary call graph built by AnalyzeBinary: function entry point to
+    // the entry points of its direct callees. Batch work consults it to run
+    // callee-first, so recovered prototypes are already warm when the callers
+    // decompile. Empty until an AnalyzeBinary sweep has run.
+    std::mutex callgraph_mu_;
+    std::map<uint64_t, std::vector<uint64_t>> call_edges_;
+
+    // Look up a finished decompilation; returns true and fills \e reply on a hit
+    bool cacheLookup(const CacheKey& key, DecompileResponse* reply) {
+        std::lock_guard<std::mutex> lock(cache_mu_);
+        auto iter = cache_index_.find(key);
+        if (iter == cache_index_.end())
+            return false;
+        cache_lru_.splice(cache_lru_.begin(), cache_lru_, iter->second);
+        reply->CopyFrom(iter->second->second);
+        return true;
+    }
+
+    // Insert into the LRU, evicting the oldest entry; caller holds cache_mu_
+    void cacheInsert(const CacheKey& key, const DecompileResponse& reply) {
+        auto iter = cache_index_.find(key);
+        if (iter != cache_index_.end()) {
+            cache_lru_.erase(iter->second);
+            cache_index_.erase(iter);
+        }
+        cache_lru_.emplace_front(key, reply);
+        cache_index_[key] = cache_lru_.begin();
+        while (cache_lru_.size() > CACHE_MAX) {
+            cache_index_.erase(cache_lru_.back().first);
+            cache_lru_.pop_back();
+        }
+    }
+
+    // Drop every cached result; used when a performance preset change
+    // rewrites the analysis limits every entry was produced under
+    void cacheDropAll() {
+        std::lock_guard<std::mutex> lock(cache_mu_);
+        cache_lru_.clear();
+        cache_index_.clear();
+    }
+
+    // Drop every cached result for one function; used when a symbol edit
+    // changes its output without changing its bytes
+    void cacheDropFunction(uint64_t addr) {
+        std::lock_guard<std::mutex> lock(cache_mu_);
+        for (auto iter = cache_lru_.begin(); iter != cache_lru_.end();) {
+            if (std::get<0>(iter->first) == addr) {
+                cache_index_.erase(iter->first);
+                iter = cache_lru_.erase(iter);
+            } else
+                ++iter;
+        }
+    }
+
+    // One sidecar record: the cache key fields followed by the serialized response
+    static void writeCacheRecord(std::ostream& out, const CacheKey& key,
+                                 const std::string& blob) {
+        uint64_t addr = std::get<0>(key);
+        uint32_t hash = std::get<1>(key);
+        uint8_t flags = (std::get<2>(key) ? 1 : 0) | (std::get<3>(key) ? 2 : 0) |
+                        (std::get<5>(key) ? 4 : 0) | (std::get<6>(key) ? 8 : 0) |
+                        (std::get<7>(key) ? 16 : 0);
+        const std::string& group = std::get<4>(key);
+        uint32_t glen = group.size();
+        uint32_t rlen = blob.size();
+        out.write((const char*)&addr, sizeof(addr));
+        out.write((const char*)&hash, sizeof(hash));
+        out.write((const char*)&flags, sizeof(flags));
+        out.write((const char*)&glen, sizeof(glen));
+        out.write(group.data(), glen);
+        out.write((const char*)&rlen, sizeof(rlen));
+        out.write(blob.data(), rlen);
+    }
+
+    // Append one finished decompilation to the sidecar; caller holds cache_mu_.
+    // Failures are silent: a read-only location just runs without persistence.
+    void persistEntry(const CacheKey& key, const DecompileResponse& reply) {
+        if (cache_path_.empty())
+            return;
+        struct stat st;
+        bool fresh = (stat(cache_path_.c_str(), &st) != 0 || st.st_size == 0);
+        std::ofstream out(cache_path_.c_str(), std::ios::binary | std::ios::app);
+        if (!out)
+            return;
+        if (fresh)
+            out.write("FDC1", 4);
+        std::string blob;
+        if (!reply.SerializeToString(&blob))
+            return;
+        writeCacheRecord(out, key, blob);
+    }
+
+    // Store a finished decompilation, evicting the least recently used entry
+    void cacheStore(const CacheKey& key, const DecompileResponse& reply) {
+        std::lock_guard<std::mutex> lock(cache_mu_);
+        cacheInsert(key, reply);
+        persistEntry(key, reply);
+    }
+
+    size_t cacheSize() {
+        std::lock_guard<std::mutex> lock(cache_mu_);
+        return cache_lru_.size();
+    }
+
+    // Replay decompilations persisted by a previous server run into the LRU.
+    // A short read or unparseable record drops the tail (a crash mid-append
+    // loses at most the last record). When accumulated appends exceed the
+    // LRU capacity the file is compacted to the surviving entries, through a
+    // temporary name so a concurrent start never reads a half-built file.
+    void loadPersistedCache() {
+        std::lock_guard<std::mutex> lock(cache_mu_);
+        if (cache_path_.empty())
+            return;
+        std::ifstream in(cache_path_.c_str(), std::ios::binary);
+        if (!in)
+            return;
+        char magic[4];
+        in.read(magic, 4);
+        if (!in || memcmp(magic, "FDC1", 4) != 0)
+            return;
+        size_t records = 0;
+        for (;;) {
+            uint64_t addr;
+            uint32_t hash, glen, rlen;
+            uint8_t flags;
+            in.read((char*)&addr, sizeof(addr));
+            in.read((char*)&hash, sizeof(hash));
+            in.read((char*)&flags, sizeof(flags));
+            in.read((char*)&glen, sizeof(glen));
+            if (!in || glen > 4096)
+                break;
+            std::string group(glen, '\0');
+            in.read(&group[0], glen);
+            in.read((char*)&rlen, sizeof(rlen));
+            if (!in || rlen > (64u << 20))
+                break;
+            std::string blob(rlen, '\0');
+            in.read(&blob[0], rlen);
+            if (!in)
+                break;
+            DecompileResponse resp;
+            if (!resp.ParseFromString(blob))
+                break;
+            CacheKey key(addr, hash, (flags & 1) != 0, (flags & 2) != 0, group,
+                         (flags & 4) != 0, (flags & 8) != 0, (flags & 16) != 0);
+            cacheInsert(key, resp);
+            records += 1;
+        }
+        in.close();
+        if (records > CACHE_MAX) {
+            std::string tmp = cache_path_ + ".tmp";
+            std::ofstream out(tmp.c_str(), std::ios::binary | std::ios::trunc);
+            if (!out)
+                return;
+            out.write("FDC1", 4);
+            for (auto iter = cache_lru_.rbegin(); iter != cache_lru_.rend(); ++iter) {
+                std::string blob;
+                if (!iter->second.SerializeToString(&blob))
+                    continue;
+                writeCacheRecord(out, iter->first, blob);
+            }
+            out.close();
+            if (out)
+                rename(tmp.c_str(), cache_path_.c_str());
+        }
+    }
+
+    // ---- Warm-start snapshots -------------------------------------------
+    // The result sidecar restores finished output, but a crashed server
+    // still loses the session's mutable analysis state: the database scopes
+    // (carrying the overrides and recovered jump tables of every resident
+    // function), type extensions, comments, and string decodings. A periodic
+    // snapshot serializes the architecture's complete <save_state> through
+    // the packed binary marshal layer into one file; auto-recovery then
+    // restores the exact working state with a single decode instead of
+    // replaying LoadBinary plus every decompilation. Only binaries loaded
+    // by path get a snapshot, for the same identity reasons as the sidecar.
+    static const uint32_t SNAPSHOT_BATCH = 8;   // Mutations that force a write
+    static const int SNAPSHOT_SECS = 30;        // Max age of unwritten dirt
+    std::string snapshot_path_;                 // Empty = snapshots disabled
+    std::atomic<uint32_t> snapshot_dirty_{0};   // Mutations since the last write
+    std::chrono::steady_clock::time_point snapshot_time_ = std::chrono::steady_clock::now();
+
+    // Record that the session's analysis state changed
+    void noteStateMutation() {
+        if (!snapshot_path_.empty())
+            snapshot_dirty_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Has enough dirt accumulated to justify the cost of a write?
+    bool snapshotDue() {
+        uint32_t dirty = snapshot_dirty_.load(std::memory_order_relaxed);
+        if (dirty == 0 || snapshot_path_.empty())
+            return false;
+        if (dirty >= SNAPSHOT_BATCH)
+            return true;
+        return std::chrono::steady_clock::now() - snapshot_time_ >=
+               std::chrono::seconds(SNAPSHOT_SECS);
+    }
+
+    // Serialize the full mutable state. Caller holds state_mu_ exclusively,
+    // so no analysis is mutating the tables mid-encode. Written through a
+    // temporary name so a crash mid-write never leaves a torn file; a
+    // failure (read-only location) just runs without snapshots.
+    void writeStateSnapshot() {
+        if (snapshot_path_.empty() || !arch)
+            return;
+        std::string tmp = snapshot_path_ + ".tmp";
+        {
+            std::ofstream out(tmp.c_str(), std::ios::binary | std::ios::trunc);
+            if (!out)
+                return;
+            out.write("FSS1", 4);
+            try {
+                PackedEncode encoder(out);
+                arch->encode(encoder);
+            } catch (const LowlevelError&) {
+                out.close();
+                unlink(tmp.c_str());
+                return;
+            }
+            if (!out)
+                return;
+        }
+        if (rename(tmp.c_str(), snapshot_path_.c_str()) == 0) {
+            snapshot_dirty_.store(0, std::memory_order_relaxed);
+            snapshot_time_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    // Restore a previous run's snapshot into the freshly initialized
+    // architecture. Caller holds state_mu_ exclusively (LoadBinary). The
+    // file is mapped read-only and decoded in place, no staging copy.
+    void loadStateSnapshot() {
+        if (snapshot_path_.empty() || !arch)
+            return;
+        int fd = open(snapshot_path_.c_str(), O_RDONLY);
+        if (fd < 0)
+            return;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 4) {
+            close(fd);
+            return;
+        }
+        void* base = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (base == MAP_FAILED)
+            return;
+        uint1* bytes = (uint1*)base;
+        if (memcmp(bytes, "FSS1", 4) != 0) {
+            munmap(base, st.st_size);
+            return;
+        }
+        try {
+            PackedDecode decoder(arch.get());
+            decoder.ingestBytes(bytes + 4, (int4)(st.st_size - 4));
+            arch->restore(decoder);
+            std::cout << "[Server] Restored session state snapshot ("
+                      << st.st_size << " bytes)" << std::endl;
+        } catch (const LowlevelError& e) {
+            // Stale or torn snapshot (format change, crash between write and
+            // rename): discard it rather than poison every future start
+            std::cerr << "[Server] Ignoring unusable state snapshot: "
+                      << e.explain << std::endl;
+            unlink(snapshot_path_.c_str());
+        }
+        munmap(base, st.st_size);
+    }
+
+    // Recovered jump-table models, keyed by entry address and the byte-hash
+    // of the function body. Re-opening a function with switches then skips
+    // the emulation-driven recovery entirely; a patch to the bytes changes
+    // the hash and naturally misses.
+    typedef std::pair<uint64_t, uint4> JumpTableKey;
+    std::map<JumpTableKey, std::string> jumptable_cache_;
+
+    bool jumpTableLookup(const JumpTableKey& key, std::string* blob) {
+        std::lock_guard<std::mutex> lock(cache_mu_);
+        auto iter = jumptable_cache_.find(key);
+        if (iter == jumptable_cache_.end())
+            return false;
+        *blob = iter->second;
+        return true;
+    }
+
+    void jumpTableStore(const JumpTableKey& key, const std::string& blob) {
+        std::lock_guard<std::mutex> lock(cache_mu_);
+        jumptable_cache_[key] = blob;
+    }
+
+    // Page-granular cache of decoded instructions backing DisassembleRange.
+    // Scrolling the Assembly panel sends bursts of overlapping ranges;
+    // pages decoded once are re-served from memory and only the frontier
+    // pays the decoder. A page holds the instructions starting inside it
+    // and is stored only when a decode run covered it completely, so cached
+    // content always equals what a fresh decode would produce. FIFO-bounded:
+    // scroll access is sequential, so eviction order barely matters.
+    static const uint64_t DISASM_PAGE = 4096;
+    static const size_t DISASM_PAGES_MAX = 4096;  // ~16MB of decoded code
+    std::mutex disasm_mu_;
+    std::map<uint64_t, std::vector<ghidra_service::Instruction>> disasm_pages_;
+    std::list<uint64_t> disasm_fifo_;
+
+    // Serve [start,end) wholly from cached pages. Fails unless every
+    // covered page is resident and a cached instruction begins exactly at
+    // \e start (a misaligned start must re-decode: the stream would differ)
+    bool disasmLookup(uint64_t start, uint64_t end, DisassembleResponse* reply) {
+        if (end <= start)
+            return false;
+        std::lock_guard<std::mutex> lock(disasm_mu_);
+        uint64_t first_page = start & ~(DISASM_PAGE - 1);
+        for (uint64_t page = first_page; page < end; page += DISASM_PAGE)
+            if (disasm_pages_.find(page) == disasm_pages_.end())
+                return false;
+        bool aligned = false;
+        for (const auto& instr : disasm_pages_[first_page]) {
+            if (instr.address() == start) {
+                aligned = true;
+                break;
+            }
+        }
+        if (!aligned)
+            return false;
+        for (uint64_t page = first_page; page < end; page += DISASM_PAGE) {
+            for (const auto& instr : disasm_pages_[page]) {
+                if (instr.address() < start || instr.address() >= end)
+                    continue;
+                *reply->add_instructions() = instr;
+            }
+        }
+        reply->set_success(true);
+        return true;
+    }
+
+    // File the instructions of a fresh decode run [start,start+total) under
+    // the pages the run covered completely; partial edge pages are skipped
+    void disasmStore(uint64_t start, uint64_t total, const DisassembleResponse& reply) {
+        if (total == 0)
+            return;
+        uint64_t run_end = start + total;
+        std::lock_guard<std::mutex> lock(disasm_mu_);
+        uint64_t first = (start + DISASM_PAGE - 1) & ~(DISASM_PAGE - 1);
+        for (uint64_t page = first; page + DISASM_PAGE <= run_end; page += DISASM_PAGE) {
+            if (disasm_pages_.find(page) != disasm_pages_.end())
+                continue;  // Already resident
+            std::vector<ghidra_service::Instruction>& rows = disasm_pages_[page];
+            for (const auto& instr : reply.instructions()) {
+                if (instr.address() >= page && instr.address() < page + DISASM_PAGE)
+                    rows.push_back(instr);
+            }
+            disasm_fifo_.push_back(page);
+        }
+        while (disasm_fifo_.size() > DISASM_PAGES_MAX) {
+            disasm_pages_.erase(disasm_fifo_.front());
+            disasm_fifo_.pop_front();
+        }
+    }
+
+    // Drop pages overlapping [start,end): the underlying bytes changed.
+    // The page before the range goes too, in case an instruction starting
+    // there spans into the patched bytes.
+    void disasmDrop(uint64_t start, uint64_t end) {
+        std::lock_guard<std::mutex> lock(disasm_mu_);
+        uint64_t first = start & ~(DISASM_PAGE - 1);
+        if (first >= DISASM_PAGE)
+            first -= DISASM_PAGE;
+        for (uint64_t page = first; page < end; page += DISASM_PAGE) {
+            if (disasm_pages_.erase(page) != 0)
+                disasm_fifo_.remove(page);
+        }
+    }
+
+    // Shared-memory response arena for a co-located client. The client asks
+    // for one at LoadBinary, mmaps the returned path read-only, and bulk C
+    // payloads then travel as an offset/length pair instead of being
+    // serialized through protobuf and copied through the socket. Allocation
+    // is a bump cursor over a ring: the client copies each payload out on
+    // receipt, so an entry only needs to survive until the cursor laps it.
+    static const size_t SHM_MIN_BYTES = 65536;  // Smaller payloads go inline
+    uint8_t* shm_base_ = nullptr;
+    size_t shm_size_ = 0;
+    std::string shm_path_;
+    std::mutex shm_mu_;
+    size_t shm_cursor_ = 0;
+
+    // Create the arena as a /dev/shm backed file; silently grants nothing
+    // on failure or on platforms without it, and the client stays on the
+    // inline path
+    void shmCreate(uint64_t size) {
+#ifndef _WIN32
+        std::ostringstream path;
+        path << "/dev/shm/ghidra_server_" << getpid() << "_" << (const void*)this;
+        int fd = open(path.str().c_str(), O_CREAT | O_TRUNC | O_RDWR, 0600);
+        if (fd < 0)
+            return;
+        if (ftruncate(fd, (off_t)size) != 0) {
+            close(fd);
+            unlink(path.str().c_str());
+            return;
+        }
+        void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (base == MAP_FAILED) {
+            unlink(path.str().c_str());
+            return;
+        }
+        shm_base_ = (uint8_t*)base;
+        shm_size_ = size;
+        shm_path_ = path.str();
+        shm_cursor_ = 0;
+        std::cout << "[Server] Shared response arena: " << shm_path_ << " ("
+                  << size << " bytes)" << std::endl;
+#endif
+    }
+
+    void shmRelease() {
+#ifndef _WIN32
+        if (shm_base_ != nullptr) {
+            munmap(shm_base_, shm_size_);
+            unlink(shm_path_.c_str());
+        }
+#endif
+        shm_base_ = nullptr;
+        shm_size_ = 0;
+        shm_path_.clear();
+        shm_cursor_ = 0;
+    }
+
+    // Move a bulk C payload out of the reply and into the arena. Only the
+    // interactive unary path calls this: batch and prefetch work would lap
+    // the ring faster than the client drains it.
+    void shmMoveResponse(DecompileResponse* reply) {
+        if (shm_base_ == nullptr)
+            return;
+        const std::string& text = reply->c_code();
+        if (text.size() < SHM_MIN_BYTES || text.size() > shm_size_)
+            return;
+        size_t off;
+        {
+            std::lock_guard<std::mutex> lock(shm_mu_);
+            if (shm_cursor_ + text.size() > shm_size_)
+                shm_cursor_ = 0;  // Wrap; the oldest entries are lapped
+            off = shm_cursor_;
+            shm_cursor_ += text.size();
+        }
+        std::memcpy(shm_base_ + off, text.data(), text.size());
+        reply->set_shm_offset(off);
+        reply->set_shm_length(text.size());
+        reply->clear_c_code();
+    }
+
+    // Last full C document emitted per function. A re-decompile after a
+    // patch or rename usually differs by a few lines; when the client
+    // quotes back the hash of the version it is displaying, the reply
+    // carries just the changed line range and the GUI patches its view
+    // instead of re-laying-out the whole document.
+    static const size_t DOC_MAX = 128;  // Documents retained per session
+    std::mutex doc_mu_;
+    std::map<uint64_t, std::pair<uint4, std::string>> last_docs_;  // hash, text
+    std::list<uint64_t> doc_fifo_;
+
+    static uint4 docHash(const std::string& text) {
+        uint4 reg = 0xffffffff;
+        reg = crc_update_bytes(reg, (const uint1*)text.data(), (int4)text.size());
+        return reg ^ 0xffffffff;
+    }
+
+    // Record \e reply's document and, if \e prev_hash names the version we
+    // emitted last time, rewrite the reply as a line delta against it
+    void deltaEncode(uint64_t addr, uint64_t prev_hash, DecompileResponse* reply) {
+        if (!reply->success() || reply->c_code().empty())
+            return;
+        const std::string& text = reply->c_code();
+        uint4 hash = docHash(text);
+        std::string prev;
+        bool have_prev = false;
+        {
+            std::lock_guard<std::mutex> lock(doc_mu_);
+            auto iter = last_docs_.find(addr);
+            if (iter != last_docs_.end() && prev_hash != 0 &&
+                iter->second.first == (uint4)prev_hash) {
+                prev = iter->second.second;
+                have_prev = true;
+            }
+            if (iter == last_docs_.end()) {
+                doc_fifo_.push_back(addr);
+                while (doc_fifo_.size() > DOC_MAX) {
+                    last_docs_.erase(doc_fifo_.front());
+                    doc_fifo_.pop_front();
+                }
+            }
+            last_docs_[addr] = std::make_pair(hash, text);
+        }
+        reply->set_doc_hash(hash);
+        if (!have_prev)
+            return;
+
+        if (prev == text) {
+            reply->set_is_delta(true);  // Empty delta: nothing changed
+            reply->clear_c_code();
+            return;
+        }
+
+        // Trim matching leading and trailing lines; what is left in the
+        // middle is the replacement range. Localized edits collapse to a
+        // few lines this way without a full diff algorithm.
+        std::vector<std::string> old_lines, new_lines;
+        splitLines(prev, old_lines);
+        splitLines(text, new_lines);
+        size_t prefix = 0;
+        while (prefix < old_lines.size() && prefix < new_lines.size() &&
+               old_lines[prefix] == new_lines[prefix])
+            ++prefix;
+        size_t suffix = 0;
+        while (suffix < old_lines.size() - prefix && suffix < new_lines.size() - prefix &&
+               old_lines[old_lines.size() - 1 - suffix] == new_lines[new_lines.size() - 1 - suffix])
+            ++suffix;
+        // Slice the replacement straight out of the new text so the client
+        // reconstructs it byte-for-byte (the final line may lack a newline)
+        bool ends_nl = !text.empty() && text[text.size() - 1] == '\n';
+        size_t a = 0;
+        for (size_t i = 0; i < prefix; ++i)
+            a += new_lines[i].size() + 1;
+        size_t b = text.size();
+        for (size_t i = 0; i < suffix; ++i) {
+            size_t len = new_lines[new_lines.size() - 1 - i].size() + 1;
+            if (i == 0 && !ends_nl)
+                len -= 1;
+            b -= len;
+        }
+        std::string middle = text.substr(a, b - a);
+        // A delta close to the document size is all overhead; ship it whole
+        if (middle.size() >= text.size() * 3 / 4)
+            return;
+        ghidra_service::TextDelta* d = reply->add_delta();
+        d->set_start_line(static_cast<uint32_t>(prefix));
+        d->set_old_count(static_cast<uint32_t>(old_lines.size() - prefix - suffix));
+        d->set_text(middle);
+        reply->set_is_delta(true);
+        reply->clear_c_code();
+    }
+
+    static void splitLines(const std::string& text, std::vector<std::string>& lines) {
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t nl = text.find('\n', pos);
+            if (nl == std::string::npos) {
+                lines.push_back(text.substr(pos));
+                break;
+            }
+            lines.push_back(text.substr(pos, nl - pos));
+            pos = nl + 1;
+        }
+    }
+
+    // Check out a printer for one decompilation's output phase
+    std::unique_ptr<PrintLanguage> acquirePrinter() {
+        {
+            std::lock_guard<std::mutex> lock(printer_mu_);
+            if (!printer_pool_.empty()) {
+                std::unique_ptr<PrintLanguage> p = std::move(printer_pool_.back());
+                printer_pool_.pop_back();
+                return p;
+            }
+        }
+        std::unique_ptr<PrintLanguage> p(
+            PrintLanguageCapability::getDefault()->buildLanguage(arch.get()));
+        p->initializeFromArchitecture();
+        return p;
+    }
+
+    void releasePrinter(std::unique_ptr<PrintLanguage> p) {
+        p->clear();  // Never pool a printer left in a partial state
+        std::lock_guard<std::mutex> lock(printer_mu_);
+        printer_pool_.push_back(std::move(p));
+    }
+
+    // Check out a private root-Action clone for one decompilation run
+    std::unique_ptr<Action> acquireAction(const std::string& name) {
+        {
+            std::lock_guard<std::mutex> lock(action_mu_);
+            auto& pool = action_pool_[name];
+            if (!pool.empty()) {
+                std::unique_ptr<Action> a = std::move(pool.back());
+                pool.pop_back();
+                return a;
+            }
+        }
+        // First lease for this name on this many concurrent workers;
+        // cloneRoot may derive and register the pipeline, which mutates
+        // allacts, so take the same lock the other allacts users hold
+        std::lock_guard<std::mutex> slock(symtab_mu_);
+        return std::unique_ptr<Action>(arch->allacts.cloneRoot(name));
+    }
+
+    void releaseAction(const std::string& name, std::unique_ptr<Action> a) {
+        std::lock_guard<std::mutex> lock(action_mu_);
+        action_pool_[name].push_back(std::move(a));
+    }
+
+    // Fetch (or create) the per-address lock for a function entry point
+    std::shared_ptr<std::mutex> functionLock(uint64_t addr) {
+        std::lock_guard<std::mutex> lock(func_mu_table_lock_);
+        auto& slot = func_mu_table_[addr];
+        if (!slot)
+            slot = std::make_shared<std::mutex>();
+        return slot;
+    }
+
+    void cleanup() {
+        {
+            std::lock_guard<std::mutex> lock(printer_mu_);
+            printer_pool_.clear();  // Printers reference arch; drop them first
+        }
+        {
+            std::lock_guard<std::mutex> lock(action_mu_);
+            action_pool_.clear();  // Action clones likewise predate the reset
+        }
+        arch.reset();
+        loader.reset();
+        initialized = false;
+        load_fingerprint_.clear();
+        std::lock_guard<std::mutex> lock(cache_mu_);
+        cache_lru_.clear();
+        cache_index_.clear();
+        jumptable_cache_.clear();
+        cache_path_.clear();
+        snapshot_path_.clear();
+        snapshot_dirty_.store(0, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> dlock(disasm_mu_);
+            disasm_pages_.clear();
+            disasm_fifo_.clear();
+        }
+        shmRelease();
+        {
+            std::lock_guard<std::mutex> dlock(doc_mu_);
+            last_docs_.clear();
+            doc_fifo_.clear();
+        }
+    }
+};
+
+class DecompilerServiceImpl final : public DecompilerService::CallbackService {
+    // Session table: keyed by the client-chosen session_id. The empty ID is
+    // the default session so single-binary clients keep working unchanged.
+    std::mutex sessions_mu_;
+    std::unordered_map<std::string, std::shared_ptr<Session>> sessions_;
+
+    // Look up a session; optionally create it (LoadBinary path)
+    std::shared_ptr<Session> getSession(const std::string& id, bool create) {
+        std::lock_guard<std::mutex> lock(sessions_mu_);
+        auto iter = sessions_.find(id);
+        if (iter != sessions_.end())
+            return iter->second;
+        if (!create)
+            return nullptr;
+        auto sess = std::make_shared<Session>();
+        sess->id = id;
+        sessions_[id] = sess;
+        return sess;
+    }
+
+    // Queue background decompilation of direct callees so they are warm in
+    // the result cache by the time the analyst clicks into them
+    void prefetchCallees(Session* sess, const std::vector<uint64_t>& callees,
+                         bool include_asm, bool include_pcode) {
+        std::string session_id = sess->id;
+        for (uint64_t addr : callees) {
+            executor_.submitBackground([this, session_id, addr, include_asm, include_pcode]() {
+                ActionYieldGuard yield_guard(&foreground_active_);
+                std::shared_ptr<Session> sp = getSession(session_id, false);
+                if (!sp)
+                    return;
+                std::shared_lock<std::shared_mutex> lock(sp->state_mu_, std::try_to_lock);
+                if (!lock.owns_lock() || !sp->initialized || !sp->arch)
+                    return;  // A reload is underway; the prefetch is moot
+
+                // Already warm (or another prefetch got there first)?
+                Session::CacheKey key(addr,
+                                      sp->loader->hashBytes(addr, Session::CACHE_HASH_WINDOW),
+                                      include_asm, include_pcode, std::string(), false, false,
+                                      false);
+                DecompileResponse probe;
+                if (sp->cacheLookup(key, &probe))
+                    return;
+
+                // Build the scratch reply on an arena; only the cache's own
+                // copy of it survives this job
+                google::protobuf::Arena arena;
+                DecompileResponse* scratch =
+                    google::protobuf::Arena::CreateMessage<DecompileResponse>(&arena);
+                decompileOne(nullptr, sp.get(), addr, include_asm, include_pcode, false,
+                             false, false, 0, std::string(), std::string(), scratch, false);
+            });
+        }
+    }
+
+    // Runs LoadBinary and decompilation work off the gRPC event threads
+    Executor executor_{std::thread::hardware_concurrency()};
+
+    // Request-latency histogram over decompileOne (cache hits included,
+    // speculative prefetches excluded). Bounds are inclusive upper limits in
+    // microseconds; everything beyond the last bound lands in the overflow
+    // bucket reported with upper_micros == 0.
+    static constexpr uint64_t LATENCY_BOUNDS[7] =
+        {1000, 5000, 25000, 100000, 500000, 2500000, 10000000};
+    // Interactive decompiles in flight; background work polls this at its
+    // yield points and parks while it is non-zero
+    std::atomic<int> foreground_active_{0};
+
+    std::mutex metrics_mu_;
+    uint64_t latency_counts_[8] = {};
+    uint64_t total_requests_ = 0;
+
+    // Pipeline restarts by triggering cause, summed over all requests;
+    // functions restarting at least the threshold get logged individually
+    static constexpr int RESTART_LOG_THRESHOLD = 3;
+    uint64_t restart_cause_counts_[ghidra::Funcdata::cause_max] = {};
+    uint64_t total_restarts_ = 0;
+
+    // Largest single decompilation footprint seen (MemoryStats.total_bytes),
+    // for sizing result caches and worker pools against real workloads
+    std::atomic<uint64_t> peak_function_bytes_{0};
+
+    void recordLatency(uint64_t usec) {
+        std::lock_guard<std::mutex> lock(metrics_mu_);
+        int bucket = 0;
+        while (bucket < 7 && usec > LATENCY_BOUNDS[bucket])
+            ++bucket;
+        latency_counts_[bucket] += 1;
+        total_requests_ += 1;
+    }
+
+    // Per-RPC-method request counters and latency histograms (same bucket
+    // bounds as above), scraped through GetServerStats
+    enum RpcMethod {
+        RPC_LOAD = 0, RPC_DECOMPILE, RPC_DECOMPILE_STREAM, RPC_DISASSEMBLE,
+        RPC_BATCH, RPC_PATCH, RPC_ANALYZE, RPC_METRICS, RPC_PING, RPC_STATS,
+        RPC_RENAME, RPC_RETYPE,
+        RPC_MAX
+    };
+    static const char* rpcName(int method) {
+        static const char* names[RPC_MAX] = {
+            "LoadBinary", "DecompileFunction", "DecompileFunctionStream",
+            "DisassembleRange", "BatchDecompile", "PatchBytes",
+            "AnalyzeBinary", "GetMetrics", "Ping", "GetServerStats",
+            "RenameSymbol", "RetypeSymbol"
+        };
+        return names[method];
+    }
+    struct RpcStat {
+        uint64_t count = 0;
+        uint64_t errors = 0;
+        uint64_t buckets[8] = {};
+    };
+    RpcStat rpc_stats_[RPC_MAX];  // Guarded by metrics_mu_
+    const std::chrono::steady_clock::time_point start_time_ =
+        std::chrono::steady_clock::now();
+
+    void recordRpc(int method, std::chrono::steady_clock::time_point t0, bool ok) {
+        uint64_t usec = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - t0).count();
+        std::lock_guard<std::mutex> lock(metrics_mu_);
+        RpcStat& st = rpc_stats_[method];
+        st.count += 1;
+        if (!ok)
+            st.errors += 1;
+        int bucket = 0;
+        while (bucket < 7 && usec > LATENCY_BOUNDS[bucket])
+            ++bucket;
+        st.buckets[bucket] += 1;
+    }
+
+    // Pool of pre-initialized architectures, keyed by language ID. init()
+    // re-reads and re-parses .sla/.pspec/.cspec documents and takes seconds;
+    // keeping warmed instances ready makes a reload effectively instant.
+    // Entries are never recycled after use, only replenished in background.
+    struct WarmArch {
+        std::unique_ptr<MemoryLoadImage> placeholder;  // Loader used during init
+        std::unique_ptr<ServerArchitecture> arch;
+    };
+    std::mutex warm_mu_;
+    std::unordered_map<std::string, std::vector<WarmArch>> warm_pool_;
+    static const size_t WARM_PER_LANG = 2;
+
+    // Drives the sampling profiler's clock (see Action::profileTick)
+    std::thread profiler_thread_;
+    std::atomic<bool> profiler_stop_{false};
+
+    // Build one pre-initialized architecture for the given language
+    WarmArch makeWarmArch(const std::string& lang_id) {
+        WarmArch entry;
+        entry.placeholder = std::make_unique<MemoryLoadImage>(std::string(), 0);
+        entry.arch = std::make_unique<ServerArchitecture>(lang_id, entry.placeholder.get(), &std::cerr);
+        DocumentStorage store;
+        entry.arch->init(store);
+        return entry;
+    }
+
+    // Take a warmed architecture for the language, if one is ready
+    WarmArch takeWarmArch(const std::string& lang_id) {
+        std::lock_guard<std::mutex> lock(warm_mu_);
+        auto iter = warm_pool_.find(lang_id);
+        if (iter == warm_pool_.end() || iter->second.empty())
+            return WarmArch();
+        WarmArch entry = std::move(iter->second.back());
+        iter->second.pop_back();
+        return entry;
+    }
+
+    // Top the pool back up for the language, in the background
+    void replenishWarmPool(const std::string& lang_id) {
+        executor_.submit([this, lang_id]() {
+            for (;;) {
+                {
+                    std::lock_guard<std::mutex> lock(warm_mu_);
+                    if (warm_pool_[lang_id].size() >= WARM_PER_LANG)
+                        return;
+                }
+                WarmArch entry;
+                try {
+                    entry = makeWarmArch(lang_id);
+                } catch (const LowlevelError& e) {
+                    std::cerr << "[Server] Warm init failed for " << lang_id
+                              << ": " << e.explain << std::endl;
+                    return;
+                }
+                std::lock_guard<std::mutex> lock(warm_mu_);
+                warm_pool_[lang_id].push_back(std::move(entry));
+            }
+        });
+    }
+
+public:
+    DecompilerServiceImpl() {
+        // Get executable directory and compute paths relative to it
+        std::string exeDir = getExecutableDir();
+        
+        // Try multiple possible locations for the languages folder:
+        // 1. <exe_dir>/../../ghidra_decompiler/languages (when exe is in build/Release)
+        // 2. <exe_dir>/../ghidra_decompiler/languages (when exe is in build)
+        // 3. <exe_dir>/languages (deployed scenario)
+        std::vector<std::pair<std::string, std::string>> searchPaths = {
+            {exeDir + "/../../ghidra_decompiler", exeDir + "/../../ghidra_decompiler/languages"},
+            {exeDir + "/../ghidra_decompiler", exeDir + "/../ghidra_decompiler/languages"},
+            {exeDir, exeDir + "/languages"}
+        };
+        
+        std::string baseDir;
+        std::string langDir;
+        
+        // Probe via a directory listing rather than per-file opens: the listing
+        // lands in FileManage's cache, so the .ldefs scan below reuses it
+        // instead of re-walking the directory (which may be a network share)
+        for (const auto& paths : searchPaths) {
+            std::vector<std::string> hits;
+            FileManage::matchListDir(hits, "x86.ldefs", true, paths.second, false);
+            if (!hits.empty()) {
+                baseDir = paths.first;
+                langDir = paths.second;
+                break;
+            }
+        }
+        
+        if (langDir.empty()) {
+            std::cerr << "[Server] ERROR: Could not find languages directory!" << std::endl;
+            std::cerr << "[Server] Searched from: " << exeDir << std::endl;
+            return;
+        }
+        
+        std::cout << "[Server] Base directory: " << baseDir << std::endl;
+        std::cout << "[Server] Languages directory: " << langDir << std::endl;
+        
+        // Initialize Ghidra library (registers print languages, capabilities, etc.)
+        startDecompilerLibrary(baseDir.c_str());
+        // Manually add the languages directory to specpaths
+        SleighArchitecture::specpaths.addDir2Path(langDir);
+        // Parse .ldefs files by calling getDescriptions()
+        try {
+            SleighArchitecture::getDescriptions();
+        } catch (const LowlevelError& e) {
+            std::cerr << "[Server Init] Warning: " << e.explain << std::endl;
+        }
+
+        // Warm the common languages so the first LoadBinary is instant too
+        replenishWarmPool("x86:LE:64:default");
+        replenishWarmPool("x86:LE:32:default");
+
+        // Always-on sampling profiler: the watcher advances the sampling
+        // clock every 10ms and workers attribute elapsed ticks to whatever
+        // Action/Rule they are inside. Cheap enough to leave running; the
+        // profile streams out through GetMetrics for diagnosing a slow
+        // server without restarting it.
+        Action::enableProfiling();
+        profiler_thread_ = std::thread([this]() {
+            while (!profiler_stop_.load()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                Action::profileTick();
+            }
+        });
+    }
+    
+    ~DecompilerServiceImpl() {
+        profiler_stop_.store(true);
+        if (profiler_thread_.joinable())
+            profiler_thread_.join();
+        std::lock_guard<std::mutex> lock(sessions_mu_);
+        for (auto& entry : sessions_)
+            entry.second->cleanup();
+        sessions_.clear();
+    }
+
+    // Force a client-supplied C declaration onto the function at \e addr,
+    // creating the function if it does not exist yet. The locked prototype
+    // then short-circuits parameter trial recovery both when the function
+    // itself decompiles and at every call site that references it, which is
+    // where most pipeline restarts on import-heavy code come from. Caller
+    // holds the session's state_mu_ (shared or exclusive).
+    void applyPrototype(Session* sess, uint64_t addr, const std::string& decl) {
+        ServerArchitecture* arch = sess->arch.get();
+        try {
+            PrototypePieces pieces;
+            std::istringstream ps(decl);
+            parse_protopieces(pieces, ps, arch);
+
+            std::lock_guard<std::mutex> slock(sess->symtab_mu_);
+            Address func_addr(arch->getDefaultCodeSpace(), addr);
+            Scope* global_scope = arch->symboltab->getGlobalScope();
+            Funcdata* fd = global_scope->findFunction(func_addr);
+            if (fd == nullptr) {
+                std::string name = pieces.name;
+                if (name.empty()) {
+                    std::ostringstream fname;
+                    fname << "func_" << std::hex << addr;
+                    name = fname.str();
+                }
+                fd = global_scope->addFunction(func_addr, name)->getFunction();
+            }
+            if (fd == nullptr)
+                return;
+            if (fd->getFuncProto().isInputLocked())
+                return;  // Already applied (or recovered and locked)
+            fd->getFuncProto().setPieces(pieces);  // Locks input/output/model
+            sess->noteStateMutation();
+        } catch (const LowlevelError& e) {
+            // A declaration the grammar rejects is advisory data, not a
+            // reason to fail the request; recovery just runs normally
+            std::cerr << "[Server] Bad prototype for 0x" << std::hex << addr
+                      << std::dec << ": " << e.explain << std::endl;
+        }
+    }
+
+    // Persist the session's mutable state if enough has changed since the
+    // last snapshot. The write runs as its own executor task and takes the
+    // session exclusively, so it never stalls the RPC that triggered it.
+    void maybeSnapshot(std::shared_ptr<Session> sess) {
+        if (!sess->snapshotDue())
+            return;
+        executor_.submit([sess]() {
+            std::unique_lock<std::shared_mutex> lock(sess->state_mu_);
+            if (sess->initialized && sess->snapshotDue())
+                sess->writeStateSnapshot();
+        });
+    }
+
+    // Identity of a LoadBinary request: two requests that would load the
+    // same image the same way produce the same string. Byte-shipped images
+    // are identified by content CRC, mapped files by their path plus size
+    // and mtime, so a rebuilt binary at the same path forces a real reload.
+    static std::string loadFingerprint(const LoadBinaryRequest* request) {
+        std::ostringstream s;
+        s << request->arch_spec() << '|' << request->base_address() << '|';
+        if (!request->file_path().empty()) {
+            s << "path:" << request->file_path();
+            struct stat st;
+            if (stat(request->file_path().c_str(), &st) == 0)
+                s << ':' << st.st_size << ':' << st.st_mtime;
+        } else {
+            uint4 reg = 0xffffffff;
+            reg = crc_update_bytes(reg, (const uint1*)request->binary_content().data(),
+                                   (int4)request->binary_content().size());
+            s << "crc:" << (reg ^ 0xffffffff) << ':' << request->binary_content().size();
+        }
+        for (const auto& sec : request->sections())
+            s << '|' << sec.start() << ',' << sec.length() << ',' << sec.executable();
+        // Prototypes are planted and locked during the load, so a request
+        // carrying different ones is not the load the session already has
+        for (const auto& proto : request->prototypes())
+            s << '|' << proto.address() << ':' << proto.declaration();
+        s << '|' << request->shm_size();  // A new arena size needs a real reload
+        return s.str();
+    }
+
+    // Heavy half of LoadBinary; runs on the executor
+    void doLoadBinary(const LoadBinaryRequest* request, LoadBinaryResponse* reply) {
+        std::shared_ptr<Session> sess = getSession(request->session_id(), true);
+        // Exclusive: no decompilation may be in flight on this session while
+        // the architecture is torn down and rebuilt.
+        std::unique_lock<std::shared_mutex> lock(sess->state_mu_);
+
+        // Auto-recovery and panel refreshes re-send the image the session
+        // already has; when nothing about the request changed, keep every
+        // cached analysis instead of tearing the architecture down
+        std::string fingerprint = loadFingerprint(request);
+        if (sess->initialized && fingerprint == sess->load_fingerprint_) {
+            std::cout << "[Server] Binary already loaded, keeping caches (session '"
+                      << request->session_id() << "')" << std::endl;
+            reply->set_shm_path(sess->shm_path_);
+            reply->set_success(true);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> tlock(sess->func_mu_table_lock_);
+            sess->func_mu_table_.clear();
+        }
+
+        try {
+            std::cout << "[Server] Loading binary: " << request->binary_content().size() << " bytes (session '" << request->session_id() << "')" << std::endl;
+            sess->cleanup();
+            
+            sess->base_address = request->base_address();
+            
+            // Create custom loader: map a server-local file in place when a
+            // path is given (zero copies), otherwise copy the shipped bytes
+            if (!request->file_path().empty()) {
+                std::cout << "[Server] Mapping file: " << request->file_path() << std::endl;
+                sess->loader = std::make_unique<MmapLoadImage>(request->file_path(), sess->base_address);
+                sess->cache_path_ = request->file_path() + ".decomp.cache";
+                sess->snapshot_path_ = request->file_path() + ".decomp.state";
+            } else {
+                sess->loader = std::make_unique<MemoryLoadImage>(request->binary_content(), sess->base_address);
+            }
+            for (const auto& sec : request->sections())
+                sess->loader->addSection(sec.start(), sec.length(), sec.executable());
+            
+            // Get language ID (e.g., "x86:LE:64:default")
+            string lang_id = request->arch_spec();
+            if (lang_id.empty()) {
+                lang_id = "x86:LE:64:default";
+            }
+            std::cout << "[Server] Language ID: " << lang_id << std::endl;
+            
+            // Create Architecture: preferably adopt a pre-warmed instance
+            // and just swap in the new loader, else pay full init
+            WarmArch warm = takeWarmArch(lang_id);
+            if (warm.arch) {
+                std::cout << "[Server] Using warm architecture for " << lang_id << std::endl;
+                sess->arch = std::move(warm.arch);
+                sess->arch->setLoader(sess->loader.get());
+            } else {
+                sess->arch = std::make_unique<ServerArchitecture>(lang_id, sess->loader.get(), &std::cerr);
+                DocumentStorage store;
+                sess->arch->init(store);
+            }
+            replenishWarmPool(lang_id);
+            sess->loader->setCodeSpace(sess->arch->getDefaultCodeSpace());
+
+            // Re-opening after a restart: serve what the analyst had open
+            // from the sidecar instead of re-running the action pipeline
+            sess->loadPersistedCache();
+
+            // And restore the mutable analysis state (scopes, types,
+            // overrides, jump tables) a previous run snapshotted
+            sess->loadStateSnapshot();
+
+            // Signatures the client already knows (import metadata, a prior
+            // session): plant them before any analysis runs
+            for (const auto& proto : request->prototypes())
+                applyPrototype(sess.get(), proto.address(), proto.declaration());
+
+            // Shared response arena for co-located clients; bulk C output
+            // then travels as offsets instead of through the socket
+            if (request->shm_size() > 0)
+                sess->shmCreate(request->shm_size());
+            reply->set_shm_path(sess->shm_path_);
+
+            sess->initialized = true;
+            sess->load_fingerprint_ = fingerprint;
+            reply->set_success(true);
+            std::cout << "[Server] Binary loaded successfully" << std::endl;
+            
+        } catch (const LowlevelError& e) {
+            std::cerr << "[Server] Ghidra error: " << e.explain << std::endl;
+            sess->cleanup();
+            reply->set_success(false);
+            reply->set_error_message(e.explain);
+        } catch (const std::exception& e) {
+            std::cerr << "[Server] Error: " << e.what() << std::endl;
+            sess->cleanup();
+            reply->set_success(false);
+            reply->set_error_message(e.what());
+        } catch (...) {
+            std::cerr << "[Server] Unknown error" << std::endl;
+            sess->cleanup();
+            reply->set_success(false);
+            reply->set_error_message("Unknown exception during initialization");
+        }
+    }
+
+    grpc::ServerUnaryReactor* LoadBinary(grpc::CallbackServerContext* ctx,
+                                         const LoadBinaryRequest* request,
+                                         LoadBinaryResponse* reply) override {
+        grpc::ServerUnaryReactor* reactor = ctx->DefaultReactor();
+        auto t0 = std::chrono::steady_clock::now();
+        executor_.submit([this, request, reply, reactor, t0]() {
+            doLoadBinary(request, reply);
+            recordRpc(RPC_LOAD, t0, reply->success());
+            reactor->Finish(Status::OK);
+        });
+        return reactor;
+    }
+
+    // Decompile a single function into \e reply. Shared by the unary
+    // DecompileFunction RPC and the BatchDecompile workers; the caller must
+    // hold the session's state_mu_ (shared) and have checked initialization.
+    void decompileOne(grpc::ServerContextBase* ctx, Session* sess, uint64_t address,
+                      bool include_asm, bool include_pcode, bool include_tokens,
+                      bool include_line_map, bool skip_casts, uint32_t timeout_ms,
+                      const std::string& action_group, const std::string& preset,
+                      DecompileResponse* reply, bool speculate = false,
+                      const std::function<void(const std::string&)>* c_sink = nullptr) {
+        // Record wall-clock latency into the histogram on every exit path
+        struct LatencyScope {
+            DecompilerServiceImpl* svc;
+            std::chrono::steady_clock::time_point start;
+            bool enabled;
+            ~LatencyScope() {
+                if (enabled)
+                    svc->recordLatency(std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - start).count());
+            }
+        } latency_scope{this, std::chrono::steady_clock::now(), !speculate};
+
+        ServerArchitecture *arch = sess->arch.get();
+
+        // Switch the requested performance preset in before anything consults
+        // the shared limits. Presets are sticky on the session; an actual
+        // switch drops the result cache, whose entries were all produced
+        // under the old limits
+        if (!preset.empty()) {
+            std::lock_guard<std::mutex> slock(sess->symtab_mu_);
+            if (preset != sess->applied_preset_) {
+                try {
+                    arch->options->set(ElementId::find("performancepreset", 0), preset);
+                } catch (const ParseError& err) {
+                    reply->set_success(false);
+                    reply->set_error_message(err.explain);
+                    return;
+                }
+                sess->applied_preset_ = preset;
+                sess->cacheDropAll();
+            }
+        }
+
+        // Serve from the result cache if the underlying bytes are unchanged
+        Session::CacheKey cache_key(address,
+                                    sess->loader->hashBytes(address, Session::CACHE_HASH_WINDOW),
+                                    include_asm, include_pcode, action_group, include_tokens,
+                                    include_line_map, skip_casts);
+        if (sess->cacheLookup(cache_key, reply)) {
+            std::cout << "[Server] Cache hit for 0x" << std::hex << address << std::dec << std::endl;
+            return;
+        }
+
+        std::shared_ptr<std::mutex> fmu = sess->functionLock(address);
+        std::lock_guard<std::mutex> flock(*fmu);
+
+        // A concurrent request for the same function may have filled the
+        // cache while we waited on the per-function lock
+        if (sess->cacheLookup(cache_key, reply))
+            return;
+
+        try {
+            Address func_addr(arch->getDefaultCodeSpace(), address);
+            std::cout << "[Server] Decompiling function at 0x" << std::hex << address << std::dec << std::endl;
+
+            // Create function name
+            std::ostringstream fname;
+            fname << "func_" << std::hex << address;
+
+            // Find or create function in symbol table (shared structure,
+            // keep the critical section short)
+            Funcdata* fd;
+            {
+                std::lock_guard<std::mutex> slock(sess->symtab_mu_);
+                Scope* global_scope = arch->symboltab->getGlobalScope();
+                fd = global_scope->findFunction(func_addr);
+
+                if (fd == nullptr) {
+                    // Create a new function
+                    fd = global_scope->addFunction(func_addr, fname.str())->getFunction();
+                }
+            }
+
+            if (fd == nullptr) {
+                reply->set_success(false);
+                reply->set_error_message("Failed to create function");
+                return;
+            }
+            
+            // Clear any previous analysis, keeping re-validatable artifacts
+            // (jump-table addresses, inferred types) to seed the fresh run
+            if (fd->isProcStarted()) {
+                arch->clearAnalysis(fd, true);
+            }
+
+            // Seed previously recovered jump-table models so switch recovery
+            // doesn't re-run emulation on a function we've seen before
+            Session::JumpTableKey jt_key(address, std::get<1>(cache_key));
+            std::string jt_blob;
+            if (sess->jumpTableLookup(jt_key, &jt_blob)) {
+                try {
+                    std::istringstream jt_in(jt_blob);
+                    DocumentStorage jt_store;
+                    Document* jt_doc = jt_store.parseDocument(jt_in);
+                    XmlDecode jt_decoder(arch, jt_doc->getRoot());
+                    fd->decodeJumpTable(jt_decoder);
+                } catch (const LowlevelError&) {
+                    // A stale or unparseable model just means recovery runs normally
+                } catch (const DecoderError&) {
+                }
+            }
+            
+            // Perform decompilation, aborting at the client's deadline or
+            // as soon as the client abandons the call
+            std::cout << "[Server] Running decompile actions..." << std::endl;
+            ActionTimeoutGuard timeout_guard(timeout_ms);
+            ActionCancelGuard cancel_guard(ctx);
+            std::string rootname;
+            {
+                // Group derivation registers into allacts on first use
+                std::lock_guard<std::mutex> slock(sess->symtab_mu_);
+                if (skip_casts) {
+                    // Derive (once per session) a sibling of the requested
+                    // group with the "casts" stage removed; output prints
+                    // without cast syntax but skips the analysis cost
+                    std::string base = action_group.empty() ? std::string("decompile")
+                                                            : action_group;
+                    rootname = base + "-nocast";
+                    try {
+                        arch->allacts.getRoot(rootname);
+                    } catch (const LowlevelError&) {
+                        arch->allacts.cloneGroup(base, rootname);
+                        arch->allacts.removeFromGroup(rootname, "casts");
+                        arch->allacts.getRoot(rootname);
+                    }
+                } else {
+                    rootname = action_group.empty() ? arch->allacts.getCurrentName()
+                                                    : action_group;
+                }
+            }
+            // The registered tree in allacts carries mutable per-run state
+            // and cannot back two concurrent runs; lease a private clone
+            struct ActionLease {
+                Session* sess;
+                std::string name;
+                std::unique_ptr<Action> a;
+                ~ActionLease() { sess->releaseAction(name, std::move(a)); }
+            } act_lease{sess, rootname, sess->acquireAction(rootname)};
+            Action* rootact = act_lease.a.get();
+            rootact->reset(*fd);
+            int4 res = rootact->perform(*fd);
+
+            if (res < 0 && Action::isCancelled()) {
+                std::cout << "[Server] Decompilation abandoned by client, tearing down" << std::endl;
+                arch->clearAnalysis(fd);
+                reply->set_success(false);
+                reply->set_error_message("Cancelled");
+                return;
+            }
+            bool partial = false;
+            if (res < 0 && Action::timeoutExpired()) {
+                // Deadline expired mid-pipeline. Everything computed so far
+                // is still printable (the pretty-printer falls back to raw
+                // p-code statements on un-finalized trees), so emit the
+                // partially-transformed function flagged as partial instead
+                // of throwing the work away.
+                std::cout << "[Server] Decompilation timed out after " << timeout_ms
+                          << "ms, emitting partial output" << std::endl;
+                std::ostringstream msg;
+                msg << "Decompilation timed out after " << timeout_ms << "ms";
+                reply->set_error_message(msg.str());
+                reply->set_partial(true);
+                partial = true;
+            }
+            else if (res < 0) {
+                std::cout << "[Server] Decompilation incomplete (break point hit)" << std::endl;
+            } else {
+                std::cout << "[Server] Decompilation complete" << std::endl;
+            }
+
+            // Lock in the recovered prototype.  The shared symbol database
+            // then acts as a session-lifetime prototype cache: later
+            // decompiles of callers pick this up through the callee's
+            // Funcdata instead of re-running parameter trial analysis at
+            // every call site.  PatchBytes drops the lock when the
+            // function's bytes change.
+            if (res >= 0) {
+                FuncProto& fproto = fd->getFuncProto();
+                if (!fproto.isInputLocked()) {
+                    // Other in-flight decompiles read this prototype through
+                    // their call specs; flip the locks inside the shared
+                    // symbol-table exclusive section
+                    std::lock_guard<std::mutex> slock(sess->symtab_mu_);
+                    fproto.setInputLock(true);
+                    fproto.setOutputLock(true);
+                }
+            }
+            
+            // ===== Generate C Code =====
+            // Check out a printer from the session pool so the output phase
+            // runs concurrently across workers; returned to the pool (reset)
+            // on every exit path
+            struct PrinterLease {
+                Session* sess;
+                std::unique_ptr<PrintLanguage> p;
+                ~PrinterLease() { sess->releasePrinter(std::move(p)); }
+            } lease{sess, sess->acquirePrinter()};
+            PrintLanguage* printer = lease.p.get();
+            // While tokens are captured the pretty-printer's low-level
+            // emitter holds a pointer into the reply; always restore the
+            // plain emitter, even if printing throws
+            struct EmitterRestore {
+                PrintLanguage* print;
+                bool active;
+                ~EmitterRestore() {
+                    if (active)
+                        print->getEmitter()->setLowLevelEmit(new EmitNoMarkup());
+                }
+            } emitter_restore{printer, include_tokens || include_line_map};
+            if (include_tokens || include_line_map)
+                printer->getEmitter()->setLowLevelEmit(
+                    new TokenEmit(reply, include_tokens, include_line_map));
+            try {
+                if (c_sink != nullptr) {
+                    // Stream the output to the caller as the pretty-printer
+                    // emits it; nothing here ever holds the whole document
+                    ChunkStreamBuf cbuf(*c_sink);
+                    std::ostream c_out(&cbuf);
+                    printer->setOutputStream(&c_out);
+                    printer->docFunction(fd);
+                    cbuf.finish();
+                } else {
+                    // Reused per worker thread: batch runs print thousands of
+                    // functions and the buffer stays warm at high-water capacity
+                    thread_local std::string c_buf;
+                    c_buf.clear();
+                    StringStreamBuf sbuf(c_buf);
+                    std::ostream c_out(&sbuf);
+                    printer->setOutputStream(&c_out);
+                    printer->docFunction(fd);
+                    reply->set_c_code(c_buf);
+                }
+            } catch (const LowlevelError& e) {
+                // A complete analysis must print; a half-transformed tree
+                // occasionally cannot, and then the timeout error stands alone
+                if (!partial)
+                    throw;
+                reply->set_success(false);
+                return;
+            }
+            reply->set_signature(fd->getName() + "()");
+            reply->set_success(true);
+
+            // Memory accounting: attribute this function's analysis footprint
+            // so RSS growth can be traced to individual requests
+            {
+                FuncMemoryUsage usage;
+                fd->measureMemory(usage);
+                ghidra_service::MemoryStats* stats = reply->mutable_stats();
+                stats->set_varnode_bytes(usage.varnodebytes);
+                stats->set_op_bytes(usage.opbytes);
+                stats->set_cover_bytes(usage.coverbytes);
+                stats->set_type_bytes(arch->types->memoryEstimate());
+                stats->set_total_bytes(usage.getTotal());
+                stats->set_varnode_count(static_cast<uint32_t>(usage.varnodecount));
+                stats->set_op_count(static_cast<uint32_t>(usage.opcount));
+                uint64_t total = usage.getTotal();
+                uint64_t prev = peak_function_bytes_.load();
+                while (total > prev &&
+                       !peak_function_bytes_.compare_exchange_weak(prev, total)) {}
+            }
+
+            // Restart accounting: how many times flow discovery forced the
+            // pipeline to start over on this function, and why
+            {
+                int restarts = fd->numRestarts();
+                reply->set_restarts(static_cast<uint32_t>(restarts));
+                for (int c = 0; c < Funcdata::cause_max; ++c) {
+                    int n = fd->getRestartCount(c);
+                    if (n == 0) continue;
+                    ghidra_service::PhaseMetric* pm = reply->add_restart_causes();
+                    pm->set_name(Funcdata::restartCauseName(c));
+                    pm->set_tested(static_cast<uint32_t>(n));
+                }
+                if (restarts > 0) {
+                    std::lock_guard<std::mutex> lk(metrics_mu_);
+                    total_restarts_ += restarts;
+                    for (int c = 0; c < Funcdata::cause_max; ++c)
+                        restart_cause_counts_[c] += fd->getRestartCount(c);
+                }
+                if (restarts >= RESTART_LOG_THRESHOLD) {
+                    std::cout << "[Server] Function 0x" << std::hex
+                              << address << std::dec << " restarted "
+                              << restarts << " times (";
+                    bool first = true;
+                    for (int c = 0; c < Funcdata::cause_max; ++c) {
+                        int n = fd->getRestartCount(c);
+                        if (n == 0) continue;
+                        if (!first) std::cout << ", ";
+                        std::cout << Funcdata::restartCauseName(c) << " x" << n;
+                        first = false;
+                    }
+                    std::cout << ")" << std::endl;
+                }
+            }
+
+            // ===== Export the recovered CFG =====
+            // The completed Funcdata already owns the structured BlockGraph;
+            // emit its basic blocks directly instead of a second linear
+            // disassembly pass (which also truncated large functions).
+            int instr_count = 0;
+            if (include_asm) {
+                // Instruction bytes are sliced straight out of the image
+                // backing buffer: one copy into the reply, so the client's
+                // bytes column needs no second fetch path
+                const uint1* img = sess->loader->buffer();
+                uint64_t img_base = sess->loader->baseAddress();
+                uint64_t img_end = img_base + sess->loader->imageSize();
+                const ghidra::BlockGraph& graph = fd->getBasicBlocks();
+                // Lay out the graph view here on the worker thread, so the
+                // coordinates ride the result cache with the rest of the reply
+                ghidra::GraphLayout glayout;
+                glayout.reset(graph);
+                std::vector<ghidra_service::BasicBlock*> pb_by_index(
+                    graph.getSize(), nullptr);
+                for (int4 i = 0; i < graph.getSize(); ++i) {
+                    FlowBlock* bl = graph.getBlock(i);
+                    Address bstart = bl->getStart();
+                    Address bstop = bl->getStop();
+                    if (bstart.isInvalid()) continue;
+
+                    ghidra_service::BasicBlock* pb_block = reply->add_blocks();
+                    pb_by_index[i] = pb_block;
+                    pb_block->set_start_addr(bstart.getOffset());
+                    pb_block->set_id(bl->getIndex());
+                    for (int4 j = 0; j < bl->sizeOut(); ++j)
+                        pb_block->add_out_branches(bl->getOut(j)->getIndex());
+
+                    // Disassemble the block's address range; getStop() is the
+                    // address of the last instruction, so run through it
+                    if (!sess->loader->isExecutable(bstart.getOffset()))
+                        continue;
+                    Address cur = bstart;
+                    try {
+                        for (;;) {
+                            ServerAssemblyEmit emit;
+                            int4 length = arch->translate->printAssembly(emit, cur);
+                            if (length <= 0) break;
+
+                            ghidra_service::Instruction* pb_instr = pb_block->add_instructions();
+                            pb_instr->set_address(cur.getOffset());
+                            pb_instr->set_length(length);
+                            pb_instr->set_mnemonic(emit.mnem);
+                            pb_instr->set_operands(emit.body);
+                            uint64_t off = cur.getOffset();
+                            if (off >= img_base && off + length <= img_end)
+                                pb_instr->set_raw_bytes(img + (off - img_base),
+                                                        length);
+                            instr_count++;
+
+                            if (include_pcode) {
+                                // Serialize this instruction's (post-analysis)
+                                // ops in the compact packed format, straight
+                                // into a flat buffer; no stream on the hot path
+                                thread_local std::string packed_buf;
+                                packed_buf.clear();
+                                PackedEncodeBuffer encoder(packed_buf);
+                                PcodeOpTree::const_iterator oiter = fd->beginOp(cur);
+                                PcodeOpTree::const_iterator oend = fd->endOp(cur);
+                                for (; oiter != oend; ++oiter) {
+                                    PcodeOp* op = oiter->second;
+                                    if (op->isDead()) continue;
+                                    op->encode(encoder);
+                                }
+                                pb_instr->set_pcode_packed(packed_buf);
+                            }
+
+                            if (cur.getOffset() >= bstop.getOffset()) {
+                                cur = cur + length;
+                                break;
+                            }
+                            cur = cur + length;
+                        }
+                    } catch (const LowlevelError& e) {
+                        // Undecodable bytes inside the block: keep what we have
+                    }
+                    pb_block->set_end_addr(cur.getOffset());
+                }
+
+                // Size each node from its disassembly text (fixed-pitch
+                // estimate), then solve the layered layout once per function
+                for (int4 i = 0; i < graph.getSize(); ++i) {
+                    ghidra_service::BasicBlock* pb_block = pb_by_index[i];
+                    if (pb_block == nullptr) continue;
+                    int4 chars = 0;
+                    for (const auto& instr : pb_block->instructions()) {
+                        int4 len = (int4)(instr.mnemonic().size() +
+                                          instr.operands().size() + 1);
+                        if (len > chars) chars = len;
+                    }
+                    if (chars < 8) chars = 8;
+                    ghidra::GraphLayout::Node& node = glayout.getNode(i);
+                    node.width = 8 * chars + 16;
+                    node.height = 16 * (pb_block->instructions_size() + 1) + 8;
+                }
+                glayout.layout();
+                for (int4 i = 0; i < graph.getSize(); ++i) {
+                    ghidra_service::BasicBlock* pb_block = pb_by_index[i];
+                    if (pb_block == nullptr) continue;
+                    const ghidra::GraphLayout::Node& node = glayout.getNode(i);
+                    pb_block->set_x(node.x);
+                    pb_block->set_y(node.y);
+                    pb_block->set_width(node.width);
+                    pb_block->set_height(node.height);
+                }
+                for (int4 i = 0; i < glayout.numEdges(); ++i) {
+                    const ghidra::GraphLayout::Edge& edge = glayout.getEdge(i);
+                    if (pb_by_index[edge.from] == nullptr ||
+                        pb_by_index[edge.to] == nullptr)
+                        continue;
+                    ghidra_service::EdgeRoute* route = reply->add_edge_routes();
+                    route->set_from_id(graph.getBlock(edge.from)->getIndex());
+                    route->set_to_id(graph.getBlock(edge.to)->getIndex());
+                    for (int4 x : edge.xs) route->add_xs(x);
+                    for (int4 y : edge.ys) route->add_ys(y);
+                }
+            }
+
+            std::cout << "[Server] Generated " << reply->blocks_size() << " blocks, "
+                      << instr_count << " instructions" << std::endl;
+
+            // A streamed reply never retained its C text, so it cannot be
+            // cached without poisoning the unary path; a partial reply must
+            // never satisfy a later request that could afford the full run
+            if (c_sink == nullptr && !partial)
+                sess->cacheStore(cache_key, *reply);
+
+            // A fresh run grew the session's analysis state (new symbols,
+            // recovered prototypes, jump tables): snapshot-worthy
+            sess->noteStateMutation();
+
+            // Remember recovered jump-table models for the next time this
+            // function is opened (keyed by byte-hash, so patches invalidate)
+            if (!partial && fd->numJumpTables() > 0 && jt_blob.empty()) {
+                std::ostringstream jt_out;
+                XmlEncode jt_encoder(jt_out);
+                fd->encodeJumpTable(jt_encoder);
+                sess->jumpTableStore(jt_key, jt_out.str());
+            }
+
+            // The analyst's next click is almost always a callee of the
+            // function just opened: queue them for idle prefetch into the
+            // result cache. Prefetched work never fans out further.
+            if (speculate) {
+                std::vector<uint64_t> callees;
+                for (int4 i = 0; i < fd->numCalls(); ++i) {
+                    const Address& entry = fd->getCallSpecs(i)->getEntryAddress();
+                    if (!entry.isInvalid())
+                        callees.push_back(entry.getOffset());
+                }
+                if (!callees.empty())
+                    prefetchCallees(sess, callees, include_asm, include_pcode);
+            }
+            
+        } catch (const LowlevelError& e) {
+            std::cerr << "[Server] Decompile error: " << e.explain << std::endl;
+            reply->set_success(false);
+            reply->set_error_message(e.explain);
+        } catch (const std::exception& e) {
+            std::cerr << "[Server] Decompile error: " << e.what() << std::endl;
+            reply->set_success(false);
+            reply->set_error_message(e.what());
+        } catch (...) {
+            std::cerr << "[Server] Unknown decompile error" << std::endl;
+            reply->set_success(false);
+            reply->set_error_message("Unknown exception during decompilation");
+        }
+        
+    }
+
+    grpc::ServerUnaryReactor* DecompileFunction(grpc::CallbackServerContext* ctx,
+                                                const DecompileRequest* request,
+                                                DecompileResponse* reply) override {
+        grpc::ServerUnaryReactor* reactor = ctx->DefaultReactor();
+        auto t0 = std::chrono::steady_clock::now();
+        std::shared_ptr<Session> sess = getSession(request->session_id(), false);
+        if (!sess) {
+            reply->set_success(false);
+            reply->set_error_message("Unknown session");
+            recordRpc(RPC_DECOMPILE, t0, false);
+            reactor->Finish(Status::OK);
+            return reactor;
+        }
+
+        // Fast path on the event thread: serve a cache hit immediately. A
+        // request naming a performance preset must take the slow path, where
+        // a preset switch is detected before the cache is consulted
+        if (request->performance_preset().empty()) {
+            std::shared_lock<std::shared_mutex> lock(sess->state_mu_, std::try_to_lock);
+            if (lock.owns_lock() && sess->initialized && sess->arch) {
+                Session::CacheKey key(request->address(),
+                                      sess->loader->hashBytes(request->address(), Session::CACHE_HASH_WINDOW),
+                                      request->include_asm(), request->include_pcode(),
+                                      request->action_group(), request->include_tokens(),
+                                      request->include_line_map(), request->skip_casts());
+                if (sess->cacheLookup(key, reply)) {
+                    sess->deltaEncode(request->address(), request->prev_doc_hash(), reply);
+                    sess->shmMoveResponse(reply);
+                    recordRpc(RPC_DECOMPILE, t0, true);
+                    reactor->Finish(Status::OK);
+                    return reactor;
+                }
+            }
+        }
+
+        // Slow path: full decompilation on the executor. Interactive requests
+        // (priority 0) jump the queue and pause any background decompiles;
+        // background requests install the yield guard so they step aside.
+        bool background = request->priority() > 0;
+        if (!background)
+            foreground_active_ += 1;
+        auto job = [this, ctx, sess, request, reply, reactor, background, t0]() {
+            std::shared_lock<std::shared_mutex> lock(sess->state_mu_);
+            if (!sess->initialized || !sess->arch) {
+                reply->set_success(false);
+                reply->set_error_message("Binary not loaded");
+            } else {
+                for (const auto& proto : request->prototypes())
+                    applyPrototype(sess.get(), proto.address(), proto.declaration());
+                ActionYieldGuard yield_guard(background ? &foreground_active_ : nullptr);
+                decompileOne(ctx, sess.get(), request->address(),
+                             request->include_asm(), request->include_pcode(),
+                             request->include_tokens(), request->include_line_map(),
+                             request->skip_casts(), request->timeout_ms(),
+                             request->action_group(), request->performance_preset(), reply, true);
+                // The cache always keeps the inline form; only the outgoing
+                // copy is rewritten as a delta or moved to the arena
+                sess->deltaEncode(request->address(), request->prev_doc_hash(), reply);
+                sess->shmMoveResponse(reply);
+            }
+            if (!background)
+                foreground_active_ -= 1;
+            maybeSnapshot(sess);
+            recordRpc(RPC_DECOMPILE, t0, reply->success());
+            reactor->Finish(Status::OK);
+        };
+        if (background)
+            executor_.submitBackground(std::move(job));
+        else
+            executor_.submit(std::move(job));
+        return reactor;
+    }
+
+    // Shared body of RenameSymbol/RetypeSymbol. The symbol table keeps every
+    // decompiled Funcdata resident, so a symbol edit only has to mutate the
+    // local scope and re-run the output phase: no action pipeline, no flow
+    // discovery. A non-empty \e type_decl retypes (and optionally renames,
+    // when the declaration carries a new identifier); otherwise \e new_name
+    // renames. Caller holds the session's state_mu_ (shared).
+    void doSymbolEdit(Session* sess, uint64_t address, const std::string& name,
+                      const std::string& new_name, const std::string& type_decl,
+                      SymbolEditResponse* reply) {
+        ServerArchitecture* arch = sess->arch.get();
+        std::shared_ptr<std::mutex> fmu = sess->functionLock(address);
+        std::lock_guard<std::mutex> flock(*fmu);
+        try {
+            Funcdata* fd;
+            {
+                std::lock_guard<std::mutex> slock(sess->symtab_mu_);
+                Address func_addr(arch->getDefaultCodeSpace(), address);
+                fd = arch->symboltab->getGlobalScope()->findFunction(func_addr);
+            }
+            if (fd == nullptr || !fd->isProcStarted()) {
+                // No resident analysis to edit; the client falls back to a
+                // full DecompileFunction round trip
+                reply->set_success(false);
+                reply->set_error_message("Function not decompiled");
+                return;
+            }
+
+            std::vector<Symbol*> symList;
+            fd->getScopeLocal()->queryByName(name, symList);
+            if (symList.empty()) {
+                reply->set_success(false);
+                reply->set_error_message("No symbol named: " + name);
+                return;
+            }
+            if (symList.size() > 1) {
+                reply->set_success(false);
+                reply->set_error_message("More than one symbol named: " + name);
+                return;
+            }
+            Symbol* sym = symList[0];
+            if (type_decl.empty() && new_name.empty()) {
+                reply->set_success(false);
+                reply->set_error_message("Missing new name");
+                return;
+            }
+
+            if (sym->getCategory() == Symbol::function_parameter) {
+                std::lock_guard<std::mutex> slock(sess->symtab_mu_);
+                fd->getFuncProto().setInputLock(true);
+            }
+            if (!type_decl.empty()) {
+                std::istringstream ts(type_decl);
+                std::string declname;
+                Datatype* ct = parse_type(ts, declname, arch);
+                sym->getScope()->retypeSymbol(sym, ct);
+                sym->getScope()->setAttribute(sym, Varnode::typelock);
+                if (!declname.empty() && declname != name) {
+                    sym->getScope()->renameSymbol(sym, declname);
+                    sym->getScope()->setAttribute(sym, Varnode::namelock);
+                }
+            } else {
+                sym->getScope()->renameSymbol(sym, new_name);
+                sym->getScope()->setAttribute(sym, Varnode::namelock | Varnode::typelock);
+            }
+
+            // Cached results for this function show the old name now
+            sess->cacheDropFunction(address);
+            sess->noteStateMutation();
+
+            struct PrinterLease {
+                Session* sess;
+                std::unique_ptr<PrintLanguage> p;
+                ~PrinterLease() { sess->releasePrinter(std::move(p)); }
+            } lease{sess, sess->acquirePrinter()};
+            PrintLanguage* printer = lease.p.get();
+            thread_local std::string c_buf;
+            c_buf.clear();
+            StringStreamBuf sbuf(c_buf);
+            std::ostream c_out(&sbuf);
+            printer->setOutputStream(&c_out);
+            printer->docFunction(fd);
+            reply->set_c_code(c_buf);
+            reply->set_signature(fd->getName() + "()");
+            reply->set_success(true);
+        } catch (const LowlevelError& e) {
+            reply->set_success(false);
+            reply->set_error_message(e.explain);
+        }
+    }
+
+    grpc::ServerUnaryReactor* RenameSymbol(grpc::CallbackServerContext* ctx,
+                                           const RenameSymbolRequest* request,
+                                           SymbolEditResponse* reply) override {
+        grpc::ServerUnaryReactor* reactor = ctx->DefaultReactor();
+        auto t0 = std::chrono::steady_clock::now();
+        std::shared_ptr<Session> sess = getSession(request->session_id(), false);
+        if (!sess) {
+            reply->set_success(false);
+            reply->set_error_message("Unknown session");
+            recordRpc(RPC_RENAME, t0, false);
+            reactor->Finish(Status::OK);
+            return reactor;
+        }
+        executor_.submit([this, sess, request, reply, reactor, t0]() {
+            std::shared_lock<std::shared_mutex> lock(sess->state_mu_);
+            if (!sess->initialized || !sess->arch) {
+                reply->set_success(false);
+                reply->set_error_message("Binary not loaded");
+            } else {
+                doSymbolEdit(sess.get(), request->function(), request->old_name(),
+                             request->new_name(), "", reply);
+            }
+            maybeSnapshot(sess);
+            recordRpc(RPC_RENAME, t0, reply->success());
+            reactor->Finish(Status::OK);
+        });
+        return reactor;
+    }
+
+    grpc::ServerUnaryReactor* RetypeSymbol(grpc::CallbackServerContext* ctx,
+                                           const RetypeSymbolRequest* request,
+                                           SymbolEditResponse* reply) override {
+        grpc::ServerUnaryReactor* reactor = ctx->DefaultReactor();
+        auto t0 = std::chrono::steady_clock::now();
+        std::shared_ptr<Session> sess = getSession(request->session_id(), false);
+        if (!sess) {
+            reply->set_success(false);
+            reply->set_error_message("Unknown session");
+            recordRpc(RPC_RETYPE, t0, false);
+            reactor->Finish(Status::OK);
+            return reactor;
+        }
+        executor_.submit([this, sess, request, reply, reactor, t0]() {
+            std::shared_lock<std::shared_mutex> lock(sess->state_mu_);
+            if (!sess->initialized || !sess->arch) {
+                reply->set_success(false);
+                reply->set_error_message("Binary not loaded");
+            } else {
+                doSymbolEdit(sess.get(), request->function(), request->name(),
+                             "", request->type_declaration(), reply);
+            }
+            maybeSnapshot(sess);
+            recordRpc(RPC_RETYPE, t0, reply->success());
+            reactor->Finish(Status::OK);
+        });
+        return reactor;
+    }
+
+    // Completion-driven callee-first dispatch over a set of function entry
+    // points: an index becomes ready only once all of its listed callees
+    // have *finished*, so their recovered prototypes are locked in before
+    // any caller starts. Shared by the BatchDecompile workers and the
+    // AnalyzeBinary prototype bootstrap.
+    class DependencyScheduler {
+        std::mutex mu_;
+        std::condition_variable cv_;
+        // One ready queue per NUMA node: a released caller queues on the node
+        // that finished its last callee, and workers prefer their own node's
+        // queue, so dependent work tends to stay on the socket whose caches
+        // already hold the callee's recovered state
+        std::vector<std::queue<size_t>> ready_;
+        std::vector<int> remaining_;         // Unfinished listed callees
+        std::vector<std::vector<size_t>> callers_;
+        std::vector<bool> dispatched_;
+        size_t dispatched_count_ = 0;
+        unsigned inflight_ = 0;
+        std::atomic<bool> cancelled_{false};
+
+    public:
+        // Build the dependency graph over the given addresses from the call
+        // graph. Functions outside the graph start immediately; call cycles
+        // are broken at dispatch time.
+        void build(const std::vector<uint64_t>& addrs,
+                   const std::map<uint64_t, std::vector<uint64_t>>& edges,
+                   unsigned num_nodes) {
+            size_t n = addrs.size();
+            ready_.assign(num_nodes == 0 ? 1 : num_nodes, std::queue<size_t>());
+            remaining_.assign(n, 0);
+            callers_.assign(n, std::vector<size_t>());
+            dispatched_.assign(n, false);
+            std::map<uint64_t, size_t> index_of;
+            for (size_t i = 0; i < n; ++i)
+                index_of.emplace(addrs[i], i);
+            for (size_t i = 0; i < n; ++i) {
+                auto eiter = edges.find(addrs[i]);
+                if (eiter == edges.end())
+                    continue;
+                for (uint64_t callee : eiter->second) {
+                    if (callee == addrs[i])
+                        continue;  // Direct recursion
+                    auto citer = index_of.find(callee);
+                    if (citer == index_of.end())
+                        continue;
+                    remaining_[i] += 1;
+                    callers_[citer->second].push_back(i);
+                }
+            }
+            unsigned spread = 0;  // Seed the initially unblocked work evenly across nodes
+            for (size_t i = 0; i < n; ++i) {
+                if (remaining_[i] == 0)
+                    ready_[spread++ % ready_.size()].push(i);
+            }
+        }
+
+        void cancel() { cancelled_ = true; }
+
+        // Claim the next index for a worker on the given node, blocking while
+        // everything left is waiting on an in-flight callee. The worker's own
+        // node is drained first; when it runs dry the other nodes' queues are
+        // stolen from rather than idling the socket. Returns \b false once
+        // the work is exhausted or cancelled. When nothing is ready and
+        // nothing is in flight, the remaining entries form call cycles: break
+        // one by dispatching the entry with the fewest unfinished callees.
+        bool nextWork(unsigned node, size_t& idx) {
+            std::unique_lock<std::mutex> slock(mu_);
+            for (;;) {
+                if (cancelled_ || dispatched_count_ == dispatched_.size())
+                    return false;
+                bool found = false;
+                for (size_t k = 0; k < ready_.size() && !found; ++k) {
+                    std::queue<size_t>& q = ready_[(node + k) % ready_.size()];
+                    while (!q.empty()) {
+                        idx = q.front();
+                        q.pop();
+                        if (!dispatched_[idx]) {  // Else cycle-break raced with completion
+                            found = true;
+                            break;
+                        }
+                    }
+                }
+                if (found)
+                    break;
+                if (inflight_ == 0) {
+                    size_t best = dispatched_.size();
+                    for (size_t i = 0; i < dispatched_.size(); ++i) {
+                        if (dispatched_[i])
+                            continue;
+                        if (best == dispatched_.size() || remaining_[i] < remaining_[best])
+                            best = i;
+                    }
+                    if (best == dispatched_.size())
+                        return false;
+                    idx = best;
+                    break;
+                }
+                // Bounded wait instead of a bare wait: cancellation paths
+                // flip cancelled_ without taking mu_, so poll rather than
+                // risk a missed notify
+                cv_.wait_for(slock, std::chrono::milliseconds(50));
+            }
+            dispatched_[idx] = true;
+            dispatched_count_ += 1;
+            inflight_ += 1;
+            return true;
+        }
+
+        // Mark an index finished and release any callers it was blocking.
+        // Released callers queue on the finishing worker's node: its caches
+        // hold the freshest prototype state the caller is about to consume.
+        void finishWork(size_t idx, unsigned node) {
+            std::lock_guard<std::mutex> slock(mu_);
+            inflight_ -= 1;
+            for (size_t caller : callers_[idx]) {
+                if (--remaining_[caller] == 0 && !dispatched_[caller])
+                    ready_[node % ready_.size()].push(caller);
+            }
+            cv_.notify_all();
+        }
+    };
+
+    // Streams batch results as workers finish them. Workers each hold the
+    // session's state lock shared for their lifetime; only one StartWrite is
+    // outstanding at a time, with finished items queued in between.
+    //
+    // Each item is built on its own protobuf Arena: a large function's reply
+    // carries thousands of Instruction submessages, and allocating each one
+    // individually made malloc/free churn dominate batch profiles. With the
+    // arena the whole item lives in a few contiguous slabs and is dropped in
+    // O(1) when its holder is released after the write completes.
+    class BatchReactor : public grpc::ServerWriteReactor<BatchDecompileItem> {
+        DecompilerServiceImpl* svc_;
+        grpc::CallbackServerContext* ctx_;
+        const BatchDecompileRequest* request_;
+        std::shared_ptr<Session> sess_;
+        std::vector<std::thread> workers_;
+        struct ArenaItem {
+            google::protobuf::Arena arena;
+            BatchDecompileItem* msg = nullptr;
+        };
+
+        std::mutex mu_;
+        std::queue<std::unique_ptr<ArenaItem>> pending_;
+        std::unique_ptr<ArenaItem> current_;
+        bool writing_ = false;
+        unsigned active_workers_ = 0;
+        DependencyScheduler sched_;          // Callee-first completion order
+        std::atomic<bool> cancelled_{false};
+        const std::chrono::steady_clock::time_point t0_ =
+            std::chrono::steady_clock::now();
+
+        // Schedule the requested addresses callee-first using the call graph
+        // from an earlier AnalyzeBinary sweep, so each callee's recovered
+        // prototype is already cached when its callers' FuncCallSpecs ask
+        void buildSchedule() {
+            std::vector<uint64_t> addrs(request_->addresses().begin(),
+                                        request_->addresses().end());
+            std::lock_guard<std::mutex> glock(sess_->callgraph_mu_);
+            sched_.build(addrs, sess_->call_edges_, NumaTopology::get().numNodes());
+        }
+
+        void workerMain(unsigned worker_index) {
+            const NumaTopology& topo = NumaTopology::get();
+            unsigned node = worker_index % topo.numNodes();
+            topo.pinToNode(node);
+            std::shared_lock<std::shared_mutex> lock(sess_->state_mu_);
+            // Batch triage is background work: step aside whenever an
+            // interactive request is running
+            ActionYieldGuard yield_guard(&svc_->foreground_active_);
+            for (;;) {
+                size_t idx;
+                if (!sched_.nextWork(node, idx))
+                    break;
+                uint64_t addr = request_->addresses(idx);
+                auto item = std::make_unique<ArenaItem>();
+                item->msg = google::protobuf::Arena::CreateMessage<BatchDecompileItem>(&item->arena);
+                item->msg->set_address(addr);
+                svc_->decompileOne(ctx_, sess_.get(), addr,
+                                   request_->include_asm(), request_->include_pcode(), false,
+                                   false, false, 0, std::string(), std::string(),
+                                   item->msg->mutable_result());
+                push(std::move(item));
+                sched_.finishWork(idx, node);
+            }
+            std::lock_guard<std::mutex> qlock(mu_);
+            active_workers_ -= 1;
+            if (active_workers_ == 0 && !writing_ && pending_.empty())
+                Finish(Status::OK);
+        }
+
+        void push(std::unique_ptr<ArenaItem> item) {
+            std::lock_guard<std::mutex> qlock(mu_);
+            if (!writing_) {
+                writing_ = true;
+                current_ = std::move(item);
+                StartWrite(current_->msg);
+            } else {
+                pending_.push(std::move(item));
+            }
+        }
+
+    public:
+        BatchReactor(DecompilerServiceImpl* svc, grpc::CallbackServerContext* ctx,
+                     const BatchDecompileRequest* request, std::shared_ptr<Session> sess,
+                     unsigned num_workers)
+            : svc_(svc), ctx_(ctx), request_(request), sess_(std::move(sess)) {
+            if (sess_)
+                buildSchedule();
+            if (num_workers == 0) {
+                cancelled_ = true;  // Rejected before any worker started
+                sched_.cancel();
+            }
+            active_workers_ = num_workers;
+            for (unsigned i = 0; i < num_workers; ++i)
+                workers_.emplace_back(&BatchReactor::workerMain, this, i);
+        }
+
+        void OnWriteDone(bool ok) override {
+            std::lock_guard<std::mutex> qlock(mu_);
+            if (!ok) {
+                cancelled_ = true;
+                sched_.cancel();
+            }
+            if (!ok || pending_.empty()) {
+                writing_ = false;
+                if (active_workers_ == 0)
+                    Finish(ok ? Status::OK : Status::CANCELLED);
+                return;
+            }
+            current_ = std::move(pending_.front());
+            pending_.pop();
+            StartWrite(current_->msg);
+        }
+
+        void OnCancel() override {
+            cancelled_ = true;
+            sched_.cancel();
+        }
+
+        void OnDone() override {
+            for (auto& t : workers_)
+                t.join();
+            svc_->recordRpc(RPC_BATCH, t0_, !cancelled_);
+            delete this;
+        }
+    };
+
+    grpc::ServerWriteReactor<BatchDecompileItem>* BatchDecompile(
+            grpc::CallbackServerContext* ctx,
+            const BatchDecompileRequest* request) override {
+        std::shared_ptr<Session> sess = getSession(request->session_id(), false);
+        if (!sess || !sess->initialized || !sess->arch) {
+            auto* reactor = new BatchReactor(this, ctx, request, sess, 0);
+            reactor->Finish(Status(grpc::StatusCode::FAILED_PRECONDITION, "Binary not loaded"));
+            return reactor;
+        }
+
+        unsigned num_workers = request->num_workers();
+        if (num_workers == 0)
+            num_workers = std::thread::hardware_concurrency();
+        if (num_workers == 0)
+            num_workers = 1;
+        if (num_workers > (unsigned)request->addresses_size())
+            num_workers = request->addresses_size();
+
+        std::cout << "[Server] Batch decompiling " << request->addresses_size()
+                  << " functions on " << num_workers << " workers" << std::endl;
+
+        return new BatchReactor(this, ctx, request, std::move(sess), num_workers);
+    }
+
+    // Streams the C output of a single decompilation in chunks. One worker
+    // job runs the decompile; chunks queue behind the single outstanding
+    // StartWrite just like BatchReactor's items.
+    class ChunkReactor : public grpc::ServerWriteReactor<DecompileChunk> {
+        std::mutex mu_;
+        std::queue<DecompileChunk> pending_;
+        DecompileChunk current_;
+        bool writing_ = false;
+        bool worker_done_ = false;
+        DecompilerServiceImpl* svc_;
+        const std::chrono::steady_clock::time_point t0_ =
+            std::chrono::steady_clock::now();
+        bool ok_ = false;
+
+        void push(DecompileChunk&& chunk) {
+            std::lock_guard<std::mutex> qlock(mu_);
+            if (!writing_) {
+                writing_ = true;
+                current_ = std::move(chunk);
+                StartWrite(&current_);
+            } else {
+                pending_.push(std::move(chunk));
+            }
+        }
+
+    public:
+        std::atomic<bool> cancelled_{false};
+
+        explicit ChunkReactor(DecompilerServiceImpl* svc) : svc_(svc) {}
+
+        void emitText(const std::string& piece) {
+            DecompileChunk chunk;
+            chunk.set_c_code(piece);
+            push(std::move(chunk));
+        }
+
+        void emitFinal(DecompileResponse&& result) {
+            DecompileChunk chunk;
+            chunk.set_last(true);
+            *chunk.mutable_result() = std::move(result);
+            {
+                std::lock_guard<std::mutex> qlock(mu_);
+                worker_done_ = true;
+                ok_ = chunk.result().success();
+            }
+            push(std::move(chunk));
+        }
+
+        void OnWriteDone(bool ok) override {
+            std::lock_guard<std::mutex> qlock(mu_);
+            if (!ok)
+                cancelled_ = true;
+            if (!ok || pending_.empty()) {
+                writing_ = false;
+                if (worker_done_)
+                    Finish(ok ? Status::OK : Status::CANCELLED);
+                return;
+            }
+            current_ = std::move(pending_.front());
+            pending_.pop();
+            StartWrite(&current_);
+        }
+
+        void OnCancel() override { cancelled_ = true; }
+
+        void OnDone() override {
+            svc_->recordRpc(RPC_DECOMPILE_STREAM, t0_, ok_ && !cancelled_);
+            delete this;
+        }
+    };
+
+    grpc::ServerWriteReactor<DecompileChunk>* DecompileFunctionStream(
+            grpc::CallbackServerContext* ctx,
+            const DecompileRequest* request) override {
+        auto* reactor = new ChunkReactor(this);
+        std::shared_ptr<Session> sess = getSession(request->session_id(), false);
+        if (!sess || !sess->initialized || !sess->arch) {
+            reactor->Finish(Status(grpc::StatusCode::FAILED_PRECONDITION, "Binary not loaded"));
+            return reactor;
+        }
+
+        executor_.submit([this, ctx, request, reactor, sess]() {
+            std::shared_lock<std::shared_mutex> lock(sess->state_mu_);
+            DecompileResponse result;
+            if (!sess->initialized || !sess->arch) {
+                result.set_success(false);
+                result.set_error_message("Binary not loaded");
+            } else {
+                for (const auto& proto : request->prototypes())
+                    applyPrototype(sess.get(), proto.address(), proto.declaration());
+                std::function<void(const std::string&)> sink =
+                    [reactor](const std::string& piece) { reactor->emitText(piece); };
+                decompileOne(ctx, sess.get(), request->address(),
+                             request->include_asm(), request->include_pcode(),
+                             request->include_tokens(), request->include_line_map(),
+                             request->skip_casts(), request->timeout_ms(),
+                             request->action_group(), request->performance_preset(),
+                             &result, false, &sink);
+                if (!result.c_code().empty()) {
+                    // Cache hit: the reply came back whole, so chunk it here
+                    const std::string& text = result.c_code();
+                    for (size_t pos = 0; pos < text.size(); pos += ChunkStreamBuf::CHUNK_BYTES)
+                        reactor->emitText(text.substr(pos, ChunkStreamBuf::CHUNK_BYTES));
+                    result.clear_c_code();
+                }
+            }
+            reactor->emitFinal(std::move(result));
+        });
+        return reactor;
+    }
+
+    grpc::ServerUnaryReactor* DisassembleRange(grpc::CallbackServerContext* ctx,
+                                               const DisassembleRequest* request,
+                                               DisassembleResponse* reply) override {
+        grpc::ServerUnaryReactor* reactor = ctx->DefaultReactor();
+        auto t0 = std::chrono::steady_clock::now();
+        doDisassembleRange(request, reply);
+        recordRpc(RPC_DISASSEMBLE, t0, reply->success());
+        reactor->Finish(Status::OK);
+        return reactor;
+    }
+
+    // Decode loop shared with the reactor entry point above; cheap enough to
+    // run directly on the gRPC event thread
+    void doDisassembleRange(const DisassembleRequest* request, DisassembleResponse* reply) {
+        std::shared_ptr<Session> sess = getSession(request->session_id(), false);
+        if (!sess) {
+            reply->set_success(false);
+            reply->set_error_message("Unknown session");
+            return;
+        }
+        std::shared_lock<std::shared_mutex> lock(sess->state_mu_);
+
+        if (!sess->initialized || !sess->arch) {
+            reply->set_success(false);
+            reply->set_error_message("Binary not loaded");
+            return;
+        }
+
+        ServerArchitecture* arch = sess->arch.get();
+        uint64_t end = request->address() + request->length();
+
+        try {
+            // One bulk call decodes the whole run: the engine hoists its
+            // per-instruction cache dispatch out of the loop and stops by
+            // itself at undecodable bytes. Never decode past the end of the
+            // executable section containing the start address.
+            uint64_t limit = sess->loader->executableLimit(request->address());
+            if (end > limit)
+                end = limit;
+
+            // Scroll bursts overlap heavily; pages decoded for an earlier
+            // request in the burst are served straight from memory
+            if (sess->disasmLookup(request->address(), end, reply))
+                return;
+
+            RangeAssemblyEmit emit;
+            Address start(arch->getDefaultCodeSpace(), request->address());
+            int4 total = 0;
+            if (end > request->address())
+                total = arch->translate->printAssemblyRange(
+                    emit, start, (int4)(end - request->address()));
+
+            const uint1* img = sess->loader->buffer();
+            uint64_t img_base = sess->loader->baseAddress();
+            uint64_t img_end = img_base + sess->loader->imageSize();
+            for (size_t i = 0; i < emit.rows.size(); ++i) {
+                const RangeAssemblyEmit::Row& row = emit.rows[i];
+                uint64_t next = (i + 1 < emit.rows.size())
+                                    ? emit.rows[i + 1].address
+                                    : request->address() + total;
+                ghidra_service::Instruction* pb_instr = reply->add_instructions();
+                pb_instr->set_address(row.address);
+                pb_instr->set_length(next - row.address);
+                pb_instr->set_mnemonic(row.mnem);
+                pb_instr->set_operands(row.body);
+                if (row.address >= img_base && next <= img_end)
+                    pb_instr->set_raw_bytes(img + (row.address - img_base),
+                                            next - row.address);
+            }
+            reply->set_success(true);
+            sess->disasmStore(request->address(), (uint64_t)total, *reply);
+        } catch (const LowlevelError& e) {
+            // Ran into undecodable bytes: return what decoded so far
+            reply->set_success(reply->instructions_size() != 0);
+            reply->set_error_message(e.explain);
+        }
+
+        return;
+    }
+
+    // Streams a precomputed list of FunctionMeta one write at a time
+    class MetaStreamReactor : public grpc::ServerWriteReactor<FunctionMeta> {
+        std::vector<FunctionMeta> items_;
+        size_t pos_ = 0;
+        DecompilerServiceImpl* svc_;
+        const std::chrono::steady_clock::time_point t0_ =
+            std::chrono::steady_clock::now();
+        bool ok_ = false;
+
+        void nextWrite() {
+            if (pos_ < items_.size())
+                StartWrite(&items_[pos_]);
+            else {
+                ok_ = true;
+                Finish(Status::OK);
+            }
+        }
+
+    public:
+        explicit MetaStreamReactor(DecompilerServiceImpl* svc) : svc_(svc) {}
+
+        void start(std::vector<FunctionMeta>&& items) {
+            items_ = std::move(items);
+            nextWrite();
+        }
+
+        void OnWriteDone(bool ok) override {
+            if (!ok) {
+                Finish(Status::CANCELLED);
+                return;
+            }
+            pos_ += 1;
+            nextWrite();
+        }
+
+        void OnDone() override {
+            svc_->recordRpc(RPC_ANALYZE, t0_, ok_);
+            delete this;
+        }
+    };
+
+    // Recover and lock one function's prototype with the "paramid" action
+    // group: enough of the pipeline to identify parameters and the return
+    // value, well short of a full decompilation. The analysis itself is
+    // discarded afterwards so a whole-binary sweep stays within memory;
+    // only the locked prototype survives for later decompilations.
+    void bootstrapOne(Session* sess, uint64_t address) {
+        ServerArchitecture* arch = sess->arch.get();
+        std::shared_ptr<std::mutex> fmu = sess->functionLock(address);
+        std::lock_guard<std::mutex> flock(*fmu);
+        try {
+            Address func_addr(arch->getDefaultCodeSpace(), address);
+            std::ostringstream fname;
+            fname << "func_" << std::hex << address;
+            Funcdata* fd;
+            {
+                std::lock_guard<std::mutex> slock(sess->symtab_mu_);
+                Scope* global_scope = arch->symboltab->getGlobalScope();
+                fd = global_scope->findFunction(func_addr);
+                if (fd == nullptr)
+                    fd = global_scope->addFunction(func_addr, fname.str())->getFunction();
+            }
+            if (fd == nullptr)
+                return;
+            if (fd->getFuncProto().isInputLocked())
+                return;  // Client-supplied or already recovered
+            if (fd->isProcStarted())
+                arch->clearAnalysis(fd);
+            struct ActionLease {
+                Session* sess;
+                std::string name;
+                std::unique_ptr<Action> a;
+                ~ActionLease() { sess->releaseAction(name, std::move(a)); }
+            } act_lease{sess, "paramid", sess->acquireAction("paramid")};
+            Action* rootact = act_lease.a.get();
+            rootact->reset(*fd);
+            int4 res = rootact->perform(*fd);
+            if (res >= 0) {
+                FuncProto& fproto = fd->getFuncProto();
+                if (!fproto.isInputLocked()) {
+                    fproto.setInputLock(true);
+                    fproto.setOutputLock(true);
+                }
+            }
+            arch->clearAnalysis(fd);
+        } catch (const LowlevelError&) {
+            // A function that will not even disassemble is simply skipped
+        }
+    }
+
+    // Whole-binary prototype bootstrap: run bootstrapOne over every
+    // discovered function in callee-first completion order, so each
+    // caller's paramid analysis already sees its callees' locked
+    // prototypes instead of guessing them. Workers hold the session's
+    // state lock shared and yield to interactive requests, exactly like
+    // the batch decompile workers.
+    void bootstrapPrototypes(std::shared_ptr<Session> sess,
+                             const std::vector<uint64_t>& entries) {
+        DependencyScheduler sched;
+        {
+            std::lock_guard<std::mutex> glock(sess->callgraph_mu_);
+            sched.build(entries, sess->call_edges_, NumaTopology::get().numNodes());
+        }
+        unsigned nthreads = std::thread::hardware_concurrency();
+        if (nthreads == 0)
+            nthreads = 1;
+        if (nthreads > entries.size())
+            nthreads = entries.size() ? (unsigned)entries.size() : 1;
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < nthreads; ++t) {
+            workers.emplace_back([this, &sess, &sched, &entries, t]() {
+                const NumaTopology& topo = NumaTopology::get();
+                unsigned node = t % topo.numNodes();
+                topo.pinToNode(node);
+                std::shared_lock<std::shared_mutex> lock(sess->state_mu_);
+                ActionYieldGuard yield_guard(&foreground_active_);
+                for (;;) {
+                    size_t idx;
+                    if (!sched.nextWork(node, idx))
+                        break;
+                    bootstrapOne(sess.get(), entries[idx]);
+                    sched.finishWork(idx, node);
+                }
+            });
+        }
+        for (auto& t : workers)
+            t.join();
+    }
+
+    grpc::ServerWriteReactor<FunctionMeta>* AnalyzeBinary(
+            grpc::CallbackServerContext* ctx,
+            const AnalyzeBinaryRequest* request) override {
+        auto* reactor = new MetaStreamReactor(this);
+        std::shared_ptr<Session> sess = getSession(request->session_id(), false);
+        if (!sess || !sess->initialized || !sess->arch) {
+            reactor->Finish(Status(grpc::StatusCode::FAILED_PRECONDITION, "Binary not loaded"));
+            return reactor;
+        }
+
+        const bool bootstrap = request->bootstrap_prototypes();
+        executor_.submit([this, sess, reactor, bootstrap]() {
+            std::shared_lock<std::shared_mutex> lock(sess->state_mu_);
+            if (!sess->initialized || !sess->arch) {
+                reactor->Finish(Status(grpc::StatusCode::FAILED_PRECONDITION, "Binary not loaded"));
+                return;
+            }
+            try {
+                std::cout << "[Server] Running code/data discovery sweep" << std::endl;
+                CodeDataAnalysis codedata;
+                codedata.init(sess->arch.get());
+                unsigned sweep_threads = std::thread::hardware_concurrency();
+                codedata.runModel(sweep_threads == 0 ? 1 : (int)sweep_threads);
+
+                // Function entries: call targets from the cross reference
+                // table plus unlinked starts the model inferred
+                std::set<uint64_t> starts;
+                for (const auto& entry : codedata.tofrom_crossref) {
+                    if ((entry.second & CodeUnit::call) != 0)
+                        starts.insert(entry.first.a.getOffset());
+                }
+                for (const auto& addr : codedata.unlinkedstarts)
+                    starts.insert(addr.getOffset());
+
+                // Call edges: the sweep already decoded every instruction and
+                // recorded call cross-references, so what remains is
+                // attributing each call site to the function body containing
+                // it. Partition the sites across threads, each filling a
+                // per-thread buffer, and merge into one edge map at the end.
+                std::vector<uint64_t> entries(starts.begin(), starts.end());
+                std::vector<std::pair<uint64_t, uint64_t>> sites;  // (call site, target)
+                for (const auto& entry : codedata.fromto_crossref) {
+                    if ((entry.second & CodeUnit::call) != 0)
+                        sites.emplace_back(entry.first.a.getOffset(),
+                                           entry.first.b.getOffset());
+                }
+                unsigned nthreads = std::thread::hardware_concurrency();
+                if (nthreads == 0)
+                    nthreads = 1;
+                if (nthreads > sites.size())
+                    nthreads = sites.size() ? sites.size() : 1;
+                size_t chunk = (sites.size() + nthreads - 1) / nthreads;
+                std::vector<std::vector<std::pair<uint64_t, uint64_t>>> parts(nthreads);
+                std::vector<std::thread> workers;
+                for (unsigned t = 0; t < nthreads; ++t) {
+                    workers.emplace_back([&, t]() {
+                        size_t lo = t * chunk;
+                        size_t hi = std::min(lo + chunk, sites.size());
+                        std::vector<std::pair<uint64_t, uint64_t>>& out = parts[t];
+                        out.reserve(hi - lo);
+                        for (size_t k = lo; k < hi; ++k) {
+                            auto owner = std::upper_bound(entries.begin(), entries.end(),
+                                                          sites[k].first);
+                            if (owner == entries.begin())
+                                continue;  // Call site precedes every function
+                            out.emplace_back(*(owner - 1), sites[k].second);
+                        }
+                    });
+                }
+                for (auto& t : workers)
+                    t.join();
+                std::map<uint64_t, std::vector<uint64_t>> edges;
+                for (const auto& part : parts) {
+                    for (const auto& edge : part)
+                        edges[edge.first].push_back(edge.second);
+                }
+                for (auto& entry : edges) {
+                    std::sort(entry.second.begin(), entry.second.end());
+                    entry.second.erase(
+                        std::unique(entry.second.begin(), entry.second.end()),
+                        entry.second.end());
+                }
+
+                std::vector<FunctionMeta> items;
+                items.reserve(starts.size());
+                for (auto iter = starts.begin(); iter != starts.end(); ++iter) {
+                    FunctionMeta meta;
+                    meta.set_address(*iter);
+                    auto next = iter;
+                    ++next;
+                    if (next != starts.end())
+                        meta.set_size(static_cast<uint32_t>(*next - *iter));
+                    std::ostringstream name;
+                    name << "func_" << std::hex << *iter;
+                    meta.set_name(name.str());
+                    meta.set_is_import(false);
+                    auto eiter = edges.find(*iter);
+                    if (eiter != edges.end()) {
+                        for (uint64_t callee : eiter->second)
+                            meta.add_callees(callee);
+                    }
+                    items.push_back(std::move(meta));
+                }
+                std::cout << "[Server] Discovery found " << items.size()
+                          << " function starts" << std::endl;
+                {
+                    std::lock_guard<std::mutex> glock(sess->callgraph_mu_);
+                    sess->call_edges_ = std::move(edges);
+                }
+                reactor->start(std::move(items));
+
+                // Stream is on its way; the prototype sweep continues in
+                // this job without delaying the discovery results
+                if (bootstrap) {
+                    std::cout << "[Server] Bootstrapping prototypes for "
+                              << entries.size() << " functions" << std::endl;
+                    bootstrapPrototypes(sess, entries);
+                    std::cout << "[Server] Prototype bootstrap complete" << std::endl;
+                }
+                sess->noteStateMutation();
+                maybeSnapshot(sess);
+            } catch (const LowlevelError& e) {
+                reactor->Finish(Status(grpc::StatusCode::INTERNAL, e.explain));
+            }
+        });
+        return reactor;
+    }
+
+    grpc::ServerUnaryReactor* PatchBytes(grpc::CallbackServerContext* ctx,
+                                         const PatchBytesRequest* request,
+                                         PatchBytesResponse* reply) override {
+        grpc::ServerUnaryReactor* reactor = ctx->DefaultReactor();
+        auto t0 = std::chrono::steady_clock::now();
+        std::shared_ptr<Session> sess = getSession(request->session_id(), false);
+        if (!sess) {
+            reply->set_success(false);
+            reply->set_error_message("Unknown session");
+            recordRpc(RPC_PATCH, t0, false);
+            reactor->Finish(Status::OK);
+            return reactor;
+        }
+        // Exclusive: the image bytes are shared by every in-flight decode
+        std::unique_lock<std::shared_mutex> lock(sess->state_mu_);
+        if (!sess->initialized || !sess->arch) {
+            reply->set_success(false);
+            reply->set_error_message("Binary not loaded");
+            recordRpc(RPC_PATCH, t0, false);
+            reactor->Finish(Status::OK);
+            return reactor;
+        }
+
+        if (!sess->loader->writeBytes(request->address(), request->data())) {
+            reply->set_success(false);
+            reply->set_error_message("Patch range out of bounds");
+            recordRpc(RPC_PATCH, t0, false);
+            reactor->Finish(Status::OK);
+            return reactor;
+        }
+        // The image no longer matches what LoadBinary shipped, so a re-send
+        // of that request must reload rather than short-circuit
+        sess->load_fingerprint_.clear();
+        // Decoded pages over the patched bytes are stale
+        sess->disasmDrop(request->address(), request->address() + request->data().size());
+        // So are the translator's per-thread instruction caches: they hit
+        // purely on address, so a cached pre-patch parse (and its p-code)
+        // would otherwise be replayed at the patched address. The exclusive
+        // state lock guarantees no decode is in flight on any thread.
+        sess->arch->translate->clearDisassemblyCache();
+
+        // Invalidate only analyses overlapping the patched range. The result
+        // cache entries for those functions are dropped explicitly: the cache
+        // key only hashes CACHE_HASH_WINDOW bytes from the entry point, so a
+        // patch landing past that window would still match the stale entry.
+        uint64_t patch_start = request->address();
+        uint64_t patch_end = patch_start + request->data().size();
+        uint32_t invalidated = 0;
+        try {
+            ServerArchitecture* arch = sess->arch.get();
+            Scope* global_scope = arch->symboltab->getGlobalScope();
+            std::vector<uint64_t> known;
+            {
+                std::lock_guard<std::mutex> tlock(sess->func_mu_table_lock_);
+                for (const auto& entry : sess->func_mu_table_)
+                    known.push_back(entry.first);
+            }
+            for (uint64_t addr : known) {
+                Address func_addr(arch->getDefaultCodeSpace(), addr);
+                Funcdata* fd = global_scope->findFunction(func_addr);
+                uint64_t size = Session::CACHE_HASH_WINDOW;  // Extent guess when no body was recovered
+                if (fd != nullptr && fd->isProcStarted() && fd->getSize() != 0)
+                    size = (uint64_t)fd->getSize();
+                if (addr >= patch_end || addr + size <= patch_start)
+                    continue;
+                sess->cacheDropFunction(addr);
+                if (fd == nullptr || !fd->isProcStarted())
+                    continue;
+                arch->clearAnalysis(fd);
+                // The recovered-prototype lock is stale along with the
+                // body; unlock and clear so the next decompile re-derives
+                FuncProto& fproto = fd->getFuncProto();
+                fproto.setInputLock(false);
+                fproto.setOutputLock(false);
+                fproto.clearUnlockedInput();
+                fproto.clearUnlockedOutput();
+                invalidated += 1;
+            }
+            reply->set_success(true);
+            reply->set_invalidated_functions(invalidated);
+            std::cout << "[Server] Patched " << request->data().size() << " bytes at 0x"
+                      << std::hex << patch_start << std::dec << ", invalidated "
+                      << invalidated << " functions" << std::endl;
+        } catch (const LowlevelError& e) {
+            reply->set_success(false);
+            reply->set_error_message(e.explain);
+        }
+        recordRpc(RPC_PATCH, t0, reply->success());
+        reactor->Finish(Status::OK);
+        return reactor;
+    }
+
+    grpc::ServerUnaryReactor* GetMetrics(grpc::CallbackServerContext* ctx,
+                                         const GetMetricsRequest* request,
+                                         GetMetricsResponse* reply) override {
+        grpc::ServerUnaryReactor* reactor = ctx->DefaultReactor();
+        auto t0 = std::chrono::steady_clock::now();
+
+        // Per-phase totals come straight off the session's action hierarchy;
+        // the counters accumulate across requests until the session reloads
+        std::shared_ptr<Session> sp = getSession(request->session_id(), false);
+        if (sp) {
+            std::shared_lock<std::shared_mutex> slock(sp->state_mu_);
+            if (sp->initialized && sp->arch) {
+                // The counts live in the per-worker root-Action clones now,
+                // not the registered tree, so sum the pool by name (clones
+                // leased to in-flight runs are missed until they return)
+                struct PhaseSum {
+                    uint64_t tested = 0;
+                    uint64_t applied = 0;
+                    uint64_t micros = 0;
+                };
+                std::map<std::string, PhaseSum> phase_sums;
+                std::map<std::string, PhaseSum> rule_sums;
+                {
+                    std::lock_guard<std::mutex> alock(sp->action_mu_);
+                    for (auto& entry : sp->action_pool_) {
+                        for (auto& clone : entry.second) {
+                            std::vector<Action*> cacts;
+                            clone->collectStatistics(cacts);
+                            for (Action* act : cacts) {
+                                PhaseSum& sum = phase_sums[act->getName()];
+                                sum.tested += act->getNumTests();
+                                sum.applied += act->getNumApply();
+                                sum.micros += act->getElapsedUsec();
+                            }
+                            std::vector<Rule*> crules;
+                            clone->collectRules(crules);
+                            for (Rule* rule : crules) {
+                                PhaseSum& sum = rule_sums[rule->getName()];
+                                sum.tested += rule->getNumTests();
+                                sum.applied += rule->getNumApply();
+                                sum.micros += rule->getNanos() / 1000;
+                            }
+                        }
+                    }
+                }
+                std::vector<Action*> acts;
+                sp->arch->allacts.getCurrent()->collectStatistics(acts);
+                for (Action* act : acts) {
+                    const PhaseSum& sum = phase_sums[act->getName()];
+                    ghidra_service::PhaseMetric* phase = reply->add_phases();
+                    phase->set_name(act->getName());
+                    phase->set_tested(act->getNumTests() + sum.tested);
+                    phase->set_applied(act->getNumApply() + sum.applied);
+                    phase->set_micros(act->getElapsedUsec() + sum.micros);
+                }
+                std::vector<Rule*> rules;
+                sp->arch->allacts.getCurrent()->collectRules(rules);
+                for (Rule* rule : rules) {
+                    const PhaseSum& sum = rule_sums[rule->getName()];
+                    ghidra_service::PhaseMetric* rm = reply->add_rules();
+                    rm->set_name(rule->getName());
+                    rm->set_tested(rule->getNumTests() + sum.tested);
+                    rm->set_applied(rule->getNumApply() + sum.applied);
+                    rm->set_micros(rule->getNanos() / 1000 + sum.micros);
+                }
+                reply->set_valueset_iterations(sp->arch->valueset_iterations);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(metrics_mu_);
+            for (int i = 0; i < 8; ++i) {
+                ghidra_service::LatencyBucket* bucket = reply->add_latency();
+                bucket->set_upper_micros(i < 7 ? LATENCY_BOUNDS[i] : 0);
+                bucket->set_count(latency_counts_[i]);
+            }
+            reply->set_total_requests(total_requests_);
+            reply->set_total_restarts(total_restarts_);
+            for (int c = 0; c < ghidra::Funcdata::cause_max; ++c) {
+                if (restart_cause_counts_[c] == 0) continue;
+                ghidra_service::PhaseMetric* pm = reply->add_restart_causes();
+                pm->set_name(ghidra::Funcdata::restartCauseName(c));
+                pm->set_tested(static_cast<uint32_t>(restart_cause_counts_[c]));
+            }
+        }
+
+        // Memory gauges: OS high-water RSS plus the largest single
+        // decompilation footprint we have attributed
+        reply->set_peak_rss_kb(processPeakRssKb());
+        reply->set_peak_function_bytes(peak_function_bytes_.load());
+
+        // Statistical profile of where pipeline time is going, process-wide:
+        // each count is one sampling tick attributed to an Action or Rule
+        {
+            std::map<std::string, uint8> samples;
+            Action::takeProfile(samples);
+            for (const auto& entry : samples) {
+                ghidra_service::PhaseMetric* pm = reply->add_profile();
+                pm->set_name(entry.first);
+                pm->set_tested(static_cast<uint32_t>(entry.second));
+            }
+        }
+        reply->set_success(true);
+        recordRpc(RPC_METRICS, t0, true);
+        reactor->Finish(Status::OK);
+        return reactor;
+    }
+
+    grpc::ServerUnaryReactor* GetServerStats(grpc::CallbackServerContext* ctx,
+                                             const GetServerStatsRequest* request,
+                                             GetServerStatsResponse* reply) override {
+        grpc::ServerUnaryReactor* reactor = ctx->DefaultReactor();
+        auto t0 = std::chrono::steady_clock::now();
+
+        reply->set_uptime_sec(std::chrono::duration_cast<std::chrono::seconds>(
+            t0 - start_time_).count());
+
+        // Per-method request counters and latency histograms; methods that
+        // have never been called are omitted so dashboards stay compact
+        {
+            std::lock_guard<std::mutex> lock(metrics_mu_);
+            for (int m = 0; m < RPC_MAX; ++m) {
+                const RpcStat& st = rpc_stats_[m];
+                if (st.count == 0)
+                    continue;
+                ghidra_service::MethodStats* ms = reply->add_methods();
+                ms->set_method(rpcName(m));
+                ms->set_count(st.count);
+                ms->set_errors(st.errors);
+                for (int i = 0; i < 8; ++i) {
+                    ghidra_service::LatencyBucket* bucket = ms->add_latency();
+                    bucket->set_upper_micros(i < 7 ? LATENCY_BOUNDS[i] : 0);
+                    bucket->set_count(st.buckets[i]);
+                }
+            }
+        }
+
+        // Instantaneous load: how much work is queued behind the pool
+        reply->set_queue_depth(executor_.queueDepth());
+        reply->set_worker_threads(executor_.numThreads());
+
+        // Result-cache occupancy summed over live sessions
+        {
+            std::lock_guard<std::mutex> lock(sessions_mu_);
+            uint64_t entries = 0;
+            for (const auto& entry : sessions_)
+                entries += entry.second->cacheSize();
+            reply->set_sessions(sessions_.size());
+            reply->set_cache_entries(entries);
+            reply->set_cache_capacity((uint64_t)sessions_.size() * Session::CACHE_MAX);
+        }
+
+        reply->set_peak_rss_kb(processPeakRssKb());
+
+        recordRpc(RPC_STATS, t0, true);
+        reactor->Finish(Status::OK);
+        return reactor;
+    }
+
+    grpc::ServerUnaryReactor* Ping(grpc::CallbackServerContext* context, const PingRequest* request,
+                                   PingResponse* reply) override {
+        reply->set_alive(true);
+        grpc::ServerUnaryReactor* reactor = context->DefaultReactor();
+        recordRpc(RPC_PING, std::chrono::steady_clock::now(), true);
+        reactor->Finish(Status::OK);
+        return reactor;
+    }
+};
+
+void RunServer(const std::string& server_address) {
+    DecompilerServiceImpl service;
+
+    ServerBuilder builder;
+    builder.AddListeningPort(server_address, grpc::InsecureServerCredentials());
+    builder.RegisterService(&service);
+
+    std::unique_ptr<Server> server(builder.BuildAndStart());
+    if (!server) {
+        std::cerr << "CRITICAL ERROR: Cannot listen on " << server_address << std::endl;
+        return;
+    }
     std::cout << "Server listening on " << server_address << std::endl;
     server->Wait();
 }
 
+// ---------------------------------------------------------------------------
+// Replay mode: feed a recorded request log back into the service in-process
+// (over gRPC's in-process channel, no network) at configurable concurrency and
+// report per-RPC latency distributions. The log is JSONL, one flat object per
+// line, e.g.:
+//
+//   {"rpc": "LoadBinary", "file": "/tmp/a.bin", "arch": "x86:LE:64:default"}
+//   {"rpc": "DecompileFunction", "address": "0x401000", "delay_ms": 120}
+//   {"rpc": "BatchDecompile", "addresses": [4198400, 4198656]}
+//
+// Recognized fields: rpc, session_id, delay_ms (pause before issuing, so a
+// single-worker replay reproduces the recorded pacing), and per-RPC fields:
+// file/base/arch (LoadBinary), address/timeout_ms/action_group/performance_preset
+// (DecompileFunction), address/length (DisassembleRange), addresses
+// (BatchDecompile). Unknown rpc names are counted as failures.
+// ---------------------------------------------------------------------------
+
+// Extract a scalar field from one flat JSON object; not a general JSON parser
+static bool jsonField(const std::string& line, const std::string& key, std::string* out) {
+    std::string needle = "\"" + key + "\"";
+    size_t pos = line.find(needle);
+    if (pos == std::string::npos)
+        return false;
+    pos = line.find(':', pos + needle.size());
+    if (pos == std::string::npos)
+        return false;
+    ++pos;
+    while (pos < line.size() && isspace(line[pos]))
+        ++pos;
+    if (pos >= line.size())
+        return false;
+    if (line[pos] == '"') {
+        size_t end = line.find('"', pos + 1);
+        if (end == std::string::npos)
+            return false;
+        *out = line.substr(pos + 1, end - pos - 1);
+        return true;
+    }
+    size_t end = pos;
+    while (end < line.size() && line[end] != ',' && line[end] != '}' && line[end] != ']')
+        ++end;
+    *out = line.substr(pos, end - pos);
+    while (!out->empty() && isspace(out->back()))
+        out->pop_back();
+    return true;
+}
+
+static bool jsonNumber(const std::string& line, const std::string& key, uint64_t* out) {
+    std::string text;
+    if (!jsonField(line, key, &text) || text.empty())
+        return false;
+    *out = strtoull(text.c_str(), nullptr, 0);  // Base 0: handles 0x-prefixed too
+    return true;
+}
+
+// Extract the numeric array field (e.g. "addresses": [1, 2]) if present
+static void jsonNumberArray(const std::string& line, const std::string& key,
+                            std::vector<uint64_t>* out) {
+    std::string needle = "\"" + key + "\"";
+    size_t pos = line.find(needle);
+    if (pos == std::string::npos)
+        return;
+    pos = line.find('[', pos + needle.size());
+    if (pos == std::string::npos)
+        return;
+    size_t end = line.find(']', pos);
+    if (end == std::string::npos)
+        return;
+    std::istringstream body(line.substr(pos + 1, end - pos - 1));
+    std::string token;
+    while (std::getline(body, token, ',')) {
+        size_t at = token.find_first_not_of(" \t\"");
+        if (at == std::string::npos)
+            continue;
+        out->push_back(strtoull(token.c_str() + at, nullptr, 0));
+    }
+}
+
+struct ReplayStats {
+    std::mutex mu;
+    std::map<std::string, std::vector<double>> latency_us;  // Per RPC name
+    uint64_t failures = 0;
+};
+
+// Issue one recorded request through the stub and record its latency
+static void replayOne(DecompilerService::Stub* stub, const std::string& line,
+                      ReplayStats* stats) {
+    std::string rpc;
+    if (!jsonField(line, "rpc", &rpc))
+        return;
+    std::string session_id;
+    jsonField(line, "session_id", &session_id);
+    uint64_t delay_ms = 0;
+    if (jsonNumber(line, "delay_ms", &delay_ms) && delay_ms != 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+
+    grpc::ClientContext ctx;
+    Status status(grpc::StatusCode::UNIMPLEMENTED, "unknown rpc");
+    auto start = std::chrono::steady_clock::now();
+    if (rpc == "LoadBinary") {
+        LoadBinaryRequest req;
+        LoadBinaryResponse resp;
+        std::string file, arch;
+        uint64_t base = 0;
+        if (jsonField(line, "file", &file))
+            req.set_file_path(file);
+        if (jsonField(line, "arch", &arch))
+            req.set_arch_spec(arch);
+        jsonNumber(line, "base", &base);
+        req.set_base_address(base);
+        req.set_session_id(session_id);
+        status = stub->LoadBinary(&ctx, req, &resp);
+        if (status.ok() && !resp.success())
+            status = Status(grpc::StatusCode::INTERNAL, resp.error_message());
+    } else if (rpc == "DecompileFunction") {
+        DecompileRequest req;
+        DecompileResponse resp;
+        uint64_t address = 0, timeout_ms = 0;
+        std::string action_group, preset;
+        jsonNumber(line, "address", &address);
+        req.set_address(address);
+        if (jsonNumber(line, "timeout_ms", &timeout_ms))
+            req.set_timeout_ms(static_cast<uint32_t>(timeout_ms));
+        if (jsonField(line, "action_group", &action_group))
+            req.set_action_group(action_group);
+        if (jsonField(line, "performance_preset", &preset))
+            req.set_performance_preset(preset);
+        req.set_session_id(session_id);
+        status = stub->DecompileFunction(&ctx, req, &resp);
+        if (status.ok() && !resp.success())
+            status = Status(grpc::StatusCode::INTERNAL, resp.error_message());
+    } else if (rpc == "DisassembleRange") {
+        DisassembleRequest req;
+        DisassembleResponse resp;
+        uint64_t address = 0, length = 0;
+        jsonNumber(line, "address", &address);
+        jsonNumber(line, "length", &length);
+        req.set_address(address);
+        req.set_length(static_cast<uint32_t>(length));
+        req.set_session_id(session_id);
+        status = stub->DisassembleRange(&ctx, req, &resp);
+    } else if (rpc == "BatchDecompile") {
+        BatchDecompileRequest req;
+        std::vector<uint64_t> addresses;
+        jsonNumberArray(line, "addresses", &addresses);
+        for (uint64_t addr : addresses)
+            req.add_addresses(addr);
+        req.set_session_id(session_id);
+        auto reader = stub->BatchDecompile(&ctx, req);
+        BatchDecompileItem item;
+        while (reader && reader->Read(&item)) {}
+        status = reader ? reader->Finish() : status;
+    } else if (rpc == "AnalyzeBinary") {
+        AnalyzeBinaryRequest req;
+        req.set_session_id(session_id);
+        auto reader = stub->AnalyzeBinary(&ctx, req);
+        FunctionMeta meta;
+        while (reader && reader->Read(&meta)) {}
+        status = reader ? reader->Finish() : status;
+    } else if (rpc == "Ping") {
+        PingRequest req;
+        PingResponse resp;
+        status = stub->Ping(&ctx, req, &resp);
+    }
+    double us = std::chrono::duration<double, std::micro>(
+                    std::chrono::steady_clock::now() - start).count();
+
+    std::lock_guard<std::mutex> lock(stats->mu);
+    stats->latency_us[rpc].push_back(us);
+    if (!status.ok())
+        stats->failures += 1;
+}
+
+static int RunReplay(const std::string& logpath, int concurrency, int repeat) {
+    std::ifstream log(logpath.c_str());
+    if (!log) {
+        std::cerr << "[Replay] Cannot open log: " << logpath << std::endl;
+        return 1;
+    }
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(log, line)) {
+        if (line.empty() || line[0] == '#')
+            continue;
+        lines.push_back(line);
+    }
+    if (lines.empty()) {
+        std::cerr << "[Replay] Log is empty: " << logpath << std::endl;
+        return 1;
+    }
+    if (concurrency < 1)
+        concurrency = 1;
+    if (repeat < 1)
+        repeat = 1;
+    std::cout << "[Replay] " << lines.size() << " requests x" << repeat
+              << ", concurrency " << concurrency << std::endl;
+
+    DecompilerServiceImpl service;
+    ServerBuilder builder;
+    builder.RegisterService(&service);
+    std::unique_ptr<Server> server(builder.BuildAndStart());
+    auto channel = server->InProcessChannel(grpc::ChannelArguments());
+
+    ReplayStats stats;
+    std::atomic<size_t> next{0};
+    size_t total = lines.size() * static_cast<size_t>(repeat);
+    auto wall_start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < concurrency; ++t) {
+        workers.emplace_back([&]() {
+            auto stub = DecompilerService::NewStub(channel);
+            for (;;) {
+                size_t idx = next.fetch_add(1);
+                if (idx >= total)
+                    break;
+                replayOne(stub.get(), lines[idx % lines.size()], &stats);
+            }
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+    double wall_sec = std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - wall_start).count();
+
+    std::cout << "[Replay] " << total << " requests in " << wall_sec << " s ("
+              << (wall_sec > 0.0 ? total / wall_sec : 0.0) << " req/sec), "
+              << stats.failures << " failures" << std::endl;
+    for (auto& entry : stats.latency_us) {
+        std::vector<double>& lat = entry.second;
+        std::sort(lat.begin(), lat.end());
+        double p50 = lat[lat.size() / 2];
+        double p99 = lat[(lat.size() * 99) / 100 < lat.size() ? (lat.size() * 99) / 100
+                                                              : lat.size() - 1];
+        std::cout << "[Replay]   " << entry.first << ": " << lat.size()
+                  << " calls, p50 " << p50 << " us, p99 " << p99 << " us" << std::endl;
+    }
+    server->Shutdown();
+    return stats.failures == 0 ? 0 : 2;
+}
+
+// ---------------------------------------------------------------------------
+// Offline decompile-all mode: no daemon, no RPC round trips. Load one binary,
+// decompile every discovered function across all cores, and write a single
+// packed artifact that downstream tools mmap and index by function address.
+//
+// Artifact layout (all integers little-endian, as written by the host):
+//   "FDA1"                          4-byte magic
+//   uint32  count                   number of functions
+//   count * { uint64 address,       sorted ascending, so lookups bisect
+//             uint64 offset,        file offset of the record
+//             uint32 length }       record length in bytes
+//   records                         serialized DecompileResponse protobufs,
+//                                   each carrying C output, token markup,
+//                                   CFG blocks, and per-instruction p-code
+// ---------------------------------------------------------------------------
+static int RunDecompileAll(const std::string& binpath, const std::string& outpath,
+                           const std::string& arch_spec, uint64_t base, int threads) {
+    if (threads < 1) {
+        unsigned hw = std::thread::hardware_concurrency();
+        threads = hw == 0 ? 1 : (int)hw;
+    }
+    // The service is driven over gRPC's in-process channel, same as replay
+    // mode: one code path serves interactive and batch work
+    DecompilerServiceImpl service;
+    ServerBuilder builder;
+    builder.RegisterService(&service);
+    std::unique_ptr<Server> server(builder.BuildAndStart());
+    auto channel = server->InProcessChannel(grpc::ChannelArguments());
+    auto stub = DecompilerService::NewStub(channel);
+
+    {
+        grpc::ClientContext ctx;
+        LoadBinaryRequest req;
+        LoadBinaryResponse resp;
+        req.set_file_path(binpath);
+        req.set_arch_spec(arch_spec);
+        req.set_base_address(base);
+        Status status = stub->LoadBinary(&ctx, req, &resp);
+        if (!status.ok() || !resp.success()) {
+            std::cerr << "[DecompileAll] Load failed: "
+                      << (status.ok() ? resp.error_message() : status.error_message())
+                      << std::endl;
+            server->Shutdown();
+            return 1;
+        }
+    }
+
+    // Discovery sweep: every function start the code/data model finds
+    std::vector<uint64_t> entries;
+    {
+        grpc::ClientContext ctx;
+        AnalyzeBinaryRequest req;
+        auto reader = stub->AnalyzeBinary(&ctx, req);
+        FunctionMeta meta;
+        while (reader && reader->Read(&meta))
+            entries.push_back(meta.address());
+        Status status = reader ? reader->Finish() : Status(grpc::StatusCode::INTERNAL, "no stream");
+        if (!status.ok()) {
+            std::cerr << "[DecompileAll] Discovery failed: " << status.error_message() << std::endl;
+            server->Shutdown();
+            return 1;
+        }
+    }
+    std::cout << "[DecompileAll] " << entries.size() << " functions, "
+              << threads << " workers" << std::endl;
+
+    std::mutex results_mu;
+    std::vector<std::pair<uint64_t, std::string>> results;
+    results.reserve(entries.size());
+    std::atomic<size_t> next{0};
+    std::atomic<uint64_t> failures{0};
+    auto wall_start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&]() {
+            auto wstub = DecompilerService::NewStub(channel);
+            for (;;) {
+                size_t idx = next.fetch_add(1);
+                if (idx >= entries.size())
+                    break;
+                grpc::ClientContext ctx;
+                DecompileRequest req;
+                DecompileResponse resp;
+                req.set_address(entries[idx]);
+                req.set_include_asm(true);
+                req.set_include_pcode(true);
+                req.set_include_tokens(true);
+                req.set_include_line_map(true);
+                Status status = wstub->DecompileFunction(&ctx, req, &resp);
+                if (!status.ok() || !resp.success()) {
+                    failures.fetch_add(1);
+                    continue;
+                }
+                std::string blob;
+                if (!resp.SerializeToString(&blob)) {
+                    failures.fetch_add(1);
+                    continue;
+                }
+                std::lock_guard<std::mutex> lock(results_mu);
+                results.emplace_back(entries[idx], std::move(blob));
+                if (results.size() % 100 == 0)
+                    std::cout << "[DecompileAll] " << results.size() << "/"
+                              << entries.size() << std::endl;
+            }
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+    double wall_sec = std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - wall_start).count();
+    server->Shutdown();
+
+    std::sort(results.begin(), results.end(),
+              [](const std::pair<uint64_t, std::string>& a,
+                 const std::pair<uint64_t, std::string>& b) { return a.first < b.first; });
+
+    // Write through a temporary name so a killed job never leaves a torn
+    // artifact where a pipeline stage would pick it up
+    std::string tmp = outpath + ".tmp";
+    std::ofstream out(tmp.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "[DecompileAll] Cannot write: " << outpath << std::endl;
+        return 1;
+    }
+    out.write("FDA1", 4);
+    uint32_t count = results.size();
+    out.write((const char*)&count, sizeof(count));
+    uint64_t offset = 4 + sizeof(count) +
+                      (uint64_t)count * (sizeof(uint64_t) * 2 + sizeof(uint32_t));
+    for (const auto& entry : results) {
+        uint64_t addr = entry.first;
+        uint32_t len = entry.second.size();
+        out.write((const char*)&addr, sizeof(addr));
+        out.write((const char*)&offset, sizeof(offset));
+        out.write((const char*)&len, sizeof(len));
+        offset += len;
+    }
+    for (const auto& entry : results)
+        out.write(entry.second.data(), entry.second.size());
+    out.close();
+    if (!out || rename(tmp.c_str(), outpath.c_str()) != 0) {
+        std::cerr << "[DecompileAll] Cannot write: " << outpath << std::endl;
+        unlink(tmp.c_str());
+        return 1;
+    }
+
+    std::cout << "[DecompileAll] " << count << " functions in " << wall_sec
+              << " s (" << (wall_sec > 0.0 ? count / wall_sec : 0.0)
+              << " func/sec), " << failures.load() << " failures, wrote "
+              << outpath << std::endl;
+    return failures.load() == 0 ? 0 : 2;
+}
+
 int main(int argc, char** argv) {
     if(argc > 1 && string(argv[1]) == "test") {
         return 0;
     }
+    if (argc > 2 && string(argv[1]) == "--decompile-all") {
+        std::string binpath(argv[2]);
+        std::string outpath = binpath + ".decomp.all";
+        std::string arch_spec;
+        uint64_t base = 0;
+        int threads = 0;
+        for (int i = 3; i + 1 < argc; i += 2) {
+            std::string arg(argv[i]);
+            if (arg == "-o")
+                outpath = argv[i + 1];
+            else if (arg == "--arch")
+                arch_spec = argv[i + 1];
+            else if (arg == "--base")
+                base = strtoull(argv[i + 1], nullptr, 0);
+            else if (arg == "--threads")
+                threads = atoi(argv[i + 1]);
+        }
+        return RunDecompileAll(binpath, outpath, arch_spec, base, threads);
+    }
+    if (argc > 2 && string(argv[1]) == "--replay") {
+        std::string logpath(argv[2]);
+        int concurrency = 1, repeat = 1;
+        for (int i = 3; i + 1 < argc; i += 2) {
+            std::string arg(argv[i]);
+            if (arg == "--concurrency")
+                concurrency = atoi(argv[i + 1]);
+            else if (arg == "--repeat")
+                repeat = atoi(argv[i + 1]);
+        }
+        try {
+            return RunReplay(logpath, concurrency, repeat);
+        } catch (const std::exception& e) {
+            std::cerr << "CRITICAL ERROR: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    // Transport selection. Local clients should prefer --uds: the
+    // Assembly-panel scroll rate turns into a stream of tiny RPCs, and a
+    // domain socket skips the TCP stack on every one of them. gRPC speaks
+    // AF_UNIX through the "unix:" URI scheme on Linux/macOS and on
+    // Windows 10+ alike, so one flag covers both.
+    std::string server_address("0.0.0.0:50051");
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg(argv[i]);
+        if (arg == "--listen") {
+            server_address = argv[i + 1];
+        } else if (arg == "--uds") {
+#ifndef _WIN32
+            unlink(argv[i + 1]);  // Stale socket file from a previous run
+#endif
+            server_address = std::string("unix:") + argv[i + 1];
+        }
+    }
 
     try {
-        RunServer();
+        RunServer(server_address);
     } catch (const std::exception& e) {
         std::cerr << "CRITICAL ERROR: " << e.what() << std::endl;
     } catch (...) {
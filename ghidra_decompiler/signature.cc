@@ -58,6 +58,51 @@ static hashword hash_mixin(hashword val1,hashword val2)
   return res;
 }
 
+/// \brief Compute hash_mixin() of one value against four others in a single pass
+///
+/// Each mixin chain walks the CRC table one dependent lookup at a time, so a
+/// single chain stalls on every step.  Interleaving four independent chains
+/// keeps the lookups pipelined, which is where the batched form gets its
+/// throughput.  The results are identical to four separate hash_mixin() calls.
+/// \param val1 is the common first value
+/// \param val2 is an array of four second values
+/// \param res is an array that will hold the four resulting hashes
+static void hash_mixin4(hashword val1,const hashword *val2,hashword *res)
+
+{
+  uint4 hi0,hi1,hi2,hi3;
+  uint4 lo0,lo1,lo2,lo3;
+  hashword v0 = val2[0];
+  hashword v1 = val2[1];
+  hashword v2 = val2[2];
+  hashword v3 = val2[3];
+
+  hi0 = hi1 = hi2 = hi3 = (uint4)(val1>>32);
+  lo0 = lo1 = lo2 = lo3 = (uint4)val1;
+  for(int4 i=0;i<8;++i) {
+    uint4 t0 = hi0;
+    uint4 t1 = hi1;
+    uint4 t2 = hi2;
+    uint4 t3 = hi3;
+    hi0 = crc_update(hi0,(uint4)v0);
+    hi1 = crc_update(hi1,(uint4)v1);
+    hi2 = crc_update(hi2,(uint4)v2);
+    hi3 = crc_update(hi3,(uint4)v3);
+    v0 >>= 8;
+    v1 >>= 8;
+    v2 >>= 8;
+    v3 >>= 8;
+    lo0 = crc_update(lo0,t0);
+    lo1 = crc_update(lo1,t1);
+    lo2 = crc_update(lo2,t2);
+    lo3 = crc_update(lo3,t3);
+  }
+  res[0] = (((uint8)hi0)<<32) | lo0;
+  res[1] = (((uint8)hi1)<<32) | lo1;
+  res[2] = (((uint8)hi2)<<32) | lo2;
+  res[3] = (((uint8)hi3)<<32) | lo3;
+}
+
 /// \param s is the given stream to write to
 void Signature::print(ostream &s) const
 
@@ -325,7 +370,19 @@ void SignatureEntry::hashIn(vector<SignatureEntry *> &neigh)
   if (isCommutative()) {
     hashword accum = 0;
     hashword tmphash;
-    for(int4 i=0;i<neigh.size();++i) {
+    hashword inval[4];
+    hashword outval[4];
+    int4 num = neigh.size();
+    int4 i;
+    for(i=0;i+4<=num;i+=4) {	// The mixins are independent, so batch them
+      inval[0] = neigh[i]->hash[1];
+      inval[1] = neigh[i+1]->hash[1];
+      inval[2] = neigh[i+2]->hash[1];
+      inval[3] = neigh[i+3]->hash[1];
+      hash_mixin4(curhash,inval,outval);
+      accum += outval[0] + outval[1] + outval[2] + outval[3];
+    }
+    for(;i<num;++i) {
       SignatureEntry *entry = neigh[i];
       tmphash = hash_mixin(curhash,entry->hash[1]);
       accum += tmphash;
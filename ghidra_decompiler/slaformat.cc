@@ -15,6 +15,14 @@
  */
 #include "slaformat.hh"
 
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdio>
+#endif
+
 namespace ghidra {
 namespace sla {
 const int4 FORMAT_SCOPE = 1;
@@ -219,12 +227,109 @@ FormatDecode::FormatDecode(const AddrSpaceManager *spcManager)
   : PackedDecode(spcManager)
 {
   inBuffer = new uint1[IN_BUFFER_SIZE];
+  mapBuffer = (uint1 *)0;
+  mapLength = 0;
 }
 
 FormatDecode::~FormatDecode(void)
 
 {
   delete [] inBuffer;
+#ifndef _WIN32
+  if (mapBuffer != (uint1 *)0)
+    munmap(mapBuffer,mapLength);
+#endif
+}
+
+/// The zlib-packed portion of the stream is inflated once and written, followed
+/// by a stream terminator byte, to a flat sidecar file.  The write goes through
+/// a temporary name so a concurrent start never maps a half-built cache.
+/// \param s is the opened .sla stream, positioned past the format header
+/// \param cachePath is the file to create
+void FormatDecode::buildCache(istream &s,const string &cachePath)
+
+{
+  string tmpPath = cachePath + ".tmp";
+  ofstream out(tmpPath.c_str(),ios::binary|ios::trunc);
+  if (!out)
+    throw LowlevelError("Unable to write .sla cache: " + tmpPath);
+  vector<uint1> outVec(BUFFER_SIZE);
+  uint1 *outBuf = outVec.data();
+  Decompress decompressor;
+  int4 outAvail = BUFFER_SIZE;
+
+  while(!decompressor.isFinished()) {
+    s.read((char *)inBuffer,IN_BUFFER_SIZE);
+    int4 gcount = s.gcount();
+    if (gcount == 0)
+	break;
+    decompressor.input(inBuffer,gcount);
+    for(;;) {
+      outAvail = decompressor.inflate(outBuf + (BUFFER_SIZE - outAvail), outAvail);
+      if (outAvail != 0)
+	break;			// Decompressor needs more input
+      out.write((char *)outBuf,BUFFER_SIZE);	// Buffer filled, flush and refill
+      outAvail = BUFFER_SIZE;
+    }
+  }
+  out.write((char *)outBuf,BUFFER_SIZE - outAvail);
+  uint1 terminator = PackedFormat::ELEMENT_END;
+  out.write((char *)&terminator,1);
+  out.close();
+  if (!out)
+    throw LowlevelError("Unable to write .sla cache: " + tmpPath);
+#ifndef _WIN32
+  if (rename(tmpPath.c_str(),cachePath.c_str()) != 0)
+    throw LowlevelError("Unable to install .sla cache: " + cachePath);
+#endif
+}
+
+/// A flat sidecar image next to the given .sla file is memory-mapped and used
+/// in place as the decoder's input stream: page faults replace both the zlib
+/// inflation and the heap buffering of a normal ingest, so the per-start cost
+/// of .sla processing is paid once per install.  A missing or out-of-date
+/// sidecar is (re)built first; if the cache cannot be built or mapped (e.g. a
+/// read-only install directory) the caller falls back to ingestStream().
+/// \param slaPath is the path of the .sla file
+/// \return true if the cache was mapped, false if a normal ingest is required
+bool FormatDecode::ingestCached(const string &slaPath)
+
+{
+#ifdef _WIN32
+  return false;			// Fall back to the streaming path
+#else
+  string cachePath = slaPath + ".cache";
+  struct stat slaStat, cacheStat;
+  if (stat(slaPath.c_str(),&slaStat) != 0)
+    return false;
+  if (stat(cachePath.c_str(),&cacheStat) != 0 || cacheStat.st_mtime < slaStat.st_mtime) {
+    ifstream s(slaPath.c_str(),ios::binary);
+    if (!s)
+      return false;
+    if (!isSlaFormat(s))
+      throw LowlevelError("Missing SLA format header: " + slaPath);
+    try {
+      buildCache(s,cachePath);
+    } catch(LowlevelError &err) {
+      return false;		// Install directory may be read-only
+    }
+    if (stat(cachePath.c_str(),&cacheStat) != 0)
+      return false;
+  }
+  if (cacheStat.st_size == 0)
+    return false;
+  int fd = open(cachePath.c_str(),O_RDONLY);
+  if (fd < 0)
+    return false;
+  void *map = mmap((void *)0,cacheStat.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+  close(fd);			// The mapping holds its own reference
+  if (map == MAP_FAILED)
+    return false;
+  mapBuffer = (uint1 *)map;
+  mapLength = cacheStat.st_size;
+  ingestBytes(mapBuffer,(int4)mapLength);
+  return true;
+#endif
 }
 
 void FormatDecode::ingestStream(istream &s)
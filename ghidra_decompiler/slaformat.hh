@@ -193,10 +193,14 @@ public:
 class FormatDecode : public PackedDecode {
   static const int4 IN_BUFFER_SIZE;	///< The size of the \e input buffer
   uint1 *inBuffer;			///< The \e input buffer
+  uint1 *mapBuffer;			///< Memory-mapped sidecar cache (or null)
+  uint8 mapLength;			///< Number of mapped bytes
+  void buildCache(istream &s,const string &cachePath);	///< Inflate the .sla stream into a flat sidecar file
 public:
   FormatDecode(const AddrSpaceManager *spcManager);	///< Initialize the decoder
   virtual ~FormatDecode(void);				///< Destructor
   virtual void ingestStream(istream &s);
+  bool ingestCached(const string &slaPath);	///< Ingest via a memory-mapped sidecar cache, building it if necessary
 };
 
 }	// End namespace sla
@@ -18,11 +18,14 @@
 
 namespace ghidra {
 
+std::atomic<uint4> PcodeCacher::highwater(600);
+
 PcodeCacher::PcodeCacher(void)
 
 {
-  // We aim to allocate this array only once
-  uint4 maxsize = 600;
+  // Size the arena from the high-water mark of previous instances, so a
+  // new decode thread starts big enough for the instructions already seen
+  uint4 maxsize = highwater.load(std::memory_order_relaxed);
   poolstart = new VarnodeData[ maxsize ];
   endpool = poolstart + maxsize;
   curpool = poolstart;
@@ -45,11 +48,9 @@ VarnodeData *PcodeCacher::expandPool(uint4 size)
   uint4 cursize = curpool - poolstart;
   if (cursize + size <= curmax)
     return curpool;		// No expansion necessary
-  uint4 increase = (cursize + size) - curmax;
-  if (increase < 100)		// Increase by at least 100
-    increase = 100;
-
-  uint4 newsize = curmax + increase;
+  uint4 newsize = curmax * 2;	// Grow geometrically so one big instruction costs one copy
+  if (newsize < cursize + size)
+    newsize = cursize + size;
 
   VarnodeData *newpool = new VarnodeData[newsize];
   for(uint4 i=0;i<cursize;++i)
@@ -108,6 +109,9 @@ void PcodeCacher::addLabel(uint4 id)
 void PcodeCacher::clear(void)
 
 {
+  uint4 used = curpool - poolstart;
+  if (used > highwater.load(std::memory_order_relaxed))
+    highwater.store(used,std::memory_order_relaxed);	// Approximate maximum is fine
   curpool = poolstart;
   issued.clear();
   label_refs.clear();
@@ -145,6 +149,22 @@ void PcodeCacher::emit(const Address &addr,PcodeEmit *emt) const
     emt->dump(addr,(*iter).opc,(*iter).outvar,(*iter).invar,(*iter).isize);
 }
 
+/// The accumulated p-code is copied onto the given parser context, so later
+/// decodes of the same instruction can replay the translation instead of
+/// rebuilding it.  The copy shares the lifetime and validity of the parser
+/// context itself.
+/// \param pos is the parser context to copy onto
+void PcodeCacher::exportPcode(ParserContext &pos) const
+
+{
+  pos.clearPcodeCache();
+  vector<PcodeData>::const_iterator iter;
+
+  for(iter=issued.begin();iter!=issued.end();++iter)
+    pos.addCachedOp((*iter).opc,(*iter).outvar,(*iter).invar,(*iter).isize);
+  pos.finalizePcodeCache();
+}
+
 /// \brief Generate a concrete VarnodeData object from the given template (VarnodeTpl)
 ///
 /// \param vntpl is the template to reference
@@ -459,6 +479,11 @@ void DisassemblyCache::initialize(int4 min,int4 hashsize)
   ParserContext *pos = list[0];
   for(int4 i=0;i<hashsize;++i)
     hashtable[i] = pos;		// Make sure all hashtable positions point to a real ParserContext
+  lengthcache.resize(LENGTH_CACHE_SIZE);
+  for(int4 i=0;i<LENGTH_CACHE_SIZE;++i)
+    lengthcache[i].length = -1;	// Mark all length slots empty
+  hitcount = 0;
+  misscount = 0;
 }
 
 void DisassemblyCache::free(void)
@@ -468,10 +493,12 @@ void DisassemblyCache::free(void)
     delete list[i];
   delete [] list;
   delete [] hashtable;
+  delete contextcache;		// The copy-on-write view (not the shared cache)
 }
 
 /// \param trans is the Translate object instantiating this cache (for inst_next2 callbacks)
-/// \param ccache is the ContextCache front-end shared across all the parser contexts
+/// \param ccache is the shared ContextCache; the parser contexts get a private
+/// copy-on-write view of it, so caches on different threads decode without contention
 /// \param cspace is the constant address space used for minting constant Varnodes
 /// \param cachesize is the number of distinct ParserContext objects in this cache
 /// \param windowsize is the size of the ParserContext hash-table
@@ -479,7 +506,7 @@ DisassemblyCache::DisassemblyCache(Translate *trans,ContextCache *ccache,AddrSpa
 
 {
   translate = trans;
-  contextcache = ccache;
+  contextcache = new ContextCacheView(ccache);
   constspace = cspace;
   initialize(cachesize,windowsize);		// Set default settings for the cache
 }
@@ -497,8 +524,11 @@ ParserContext *DisassemblyCache::getParserContext(const Address &addr)
 {
   int4 hashindex = ((int4) addr.getOffset()) & mask;
   ParserContext *res = hashtable[ hashindex ];
-  if (res->getAddr() == addr)
+  if (res->getAddr() == addr) {
+    hitcount += 1;
     return res;
+  }
+  misscount += 1;
   res = list[ nextfree ];
   nextfree += 1;		// Advance the circular index
   if (nextfree >= minimumreuse)
@@ -518,15 +548,70 @@ Sleigh::Sleigh(LoadImage *ld,ContextDatabase *c_db)
   loader = ld;
   context_db = c_db;
   cache = new ContextCache(c_db);
-  discache = (DisassemblyCache *)0;
+  parser_cachesize = -1;		// Sizes chosen automatically during initialize()
+  parser_windowsize = -1;
+}
+
+/// Build a translator that shares the decoded specification tables of an existing,
+/// fully initialized translator instead of reloading the .sla file.  The new
+/// instance owns its own context cache and disassembly caches, so translators
+/// built this way can serve separate programs (and threads) concurrently.
+/// \param op2 is the fully initialized translator to share tables with
+/// \param ld is the LoadImage to draw program bytes from
+/// \param c_db is the context database
+Sleigh::Sleigh(const Sleigh &op2,LoadImage *ld,ContextDatabase *c_db)
+  : SleighBase(op2)
+
+{
+  loader = ld;
+  context_db = c_db;
+  cache = new ContextCache(c_db);
+  parser_cachesize = -1;
+  parser_windowsize = -1;
 }
 
 void Sleigh::clearForDelete(void)
 
 {
   delete cache;
-  if (discache != (DisassemblyCache *)0)
-    delete discache;
+  std::lock_guard<std::mutex> lock(shard_mutex);
+  std::map<std::thread::id,DisassemblyCache *>::const_iterator iter;
+  for(iter=dis_shards.begin();iter!=dis_shards.end();++iter)
+    delete (*iter).second;
+  dis_shards.clear();
+}
+
+/// Each thread performing disassembly gets its own DisassemblyCache, so the
+/// parallel decode paths never contend on (or corrupt) a shared hash-table.
+/// A shard is created on first use with the currently configured sizes.
+/// \return the calling thread's cache shard
+DisassemblyCache *Sleigh::obtainShard(void) const
+
+{
+  std::lock_guard<std::mutex> lock(shard_mutex);
+  DisassemblyCache *&shard = dis_shards[std::this_thread::get_id()];
+  if (shard == (DisassemblyCache *)0)
+    shard = new DisassemblyCache(const_cast<Sleigh *>(this),cache,getConstantSpace(),
+				 parser_cachesize,parser_windowsize);
+  return shard;
+}
+
+/// Shards are private to their decode threads, so the sums are only exact
+/// once those threads are quiescent; callers use this for benchmark and
+/// diagnostic reporting after a decode pass completes.
+/// \param hits will hold the total cache hits across all shards
+/// \param misses will hold the total cache misses across all shards
+void Sleigh::getCacheStats(uint8 &hits,uint8 &misses) const
+
+{
+  hits = 0;
+  misses = 0;
+  std::lock_guard<std::mutex> lock(shard_mutex);
+  std::map<std::thread::id,DisassemblyCache *>::const_iterator iter;
+  for(iter=dis_shards.begin();iter!=dis_shards.end();++iter) {
+    hits += (*iter).second->getHitCount();
+    misses += (*iter).second->getMissCount();
+  }
 }
 
 Sleigh::~Sleigh(void)
@@ -543,11 +628,11 @@ void Sleigh::reset(LoadImage *ld,ContextDatabase *c_db)
 
 {
   clearForDelete();
-  pcode_cache.clear();
   loader = ld;
   context_db = c_db;
   cache = new ContextCache(c_db);
-  discache = (DisassemblyCache *)0;
+  parser_cachesize = -1;
+  parser_windowsize = -1;
 }
 
 /// The .sla file from the document store is loaded and cache objects are prepared
@@ -559,23 +644,61 @@ void Sleigh::initialize(DocumentStorage &store)
     const Element *el = store.getTag("sleigh");
     if (el == (const Element *)0)
       throw LowlevelError("Could not find sleigh tag");
-    sla::FormatDecode decoder(this);
-    ifstream s(el->getContent(), std::ios_base::binary);
-    if (!s)
-      throw LowlevelError("Could not open .sla file: " + el->getContent());
-    decoder.ingestStream(s);
-    s.close();
-    decode(decoder);
+    std::unique_ptr<sla::FormatDecode> decoder(new sla::FormatDecode(this));
+    bool mapped = decoder->ingestCached(el->getContent());	// Prefer the flat memory-mapped cache
+    if (!mapped) {
+      ifstream s(el->getContent(), std::ios_base::binary);
+      if (!s)
+        throw LowlevelError("Could not open .sla file: " + el->getContent());
+      decoder->ingestStream(s);
+      s.close();
+    }
+    decode(*decoder);
+    if (mapped)		// The mapping must outlive the deferred subtable bodies it backs
+      setSlaBacking(decoder.release());
   }
   else
     reregisterContext();
-  uint4 parser_cachesize = 2;
-  uint4 parser_windowsize = 32;
-  if ((maxdelayslotbytes > 1)||(unique_allocatemask != 0)) {
-    parser_cachesize = 8;
-    parser_windowsize = 256;
+  if (parser_cachesize < 0) {		// If not explicitly configured, size from language properties
+    parser_cachesize = 2;
+    parser_windowsize = 32;
+    if ((maxdelayslotbytes > 1)||(unique_allocatemask != 0)) {
+      parser_cachesize = 8;
+      parser_windowsize = 256;
+    }
   }
-  discache = new DisassemblyCache(this,cache,getConstantSpace(),parser_cachesize,parser_windowsize);
+}
+
+/// Existing shards are flushed so the new sizes take effect on each thread's
+/// next disassembly.  Do not call while disassembly is in progress.
+/// \param cachesize is the number of ParserContext objects per decode thread
+/// \param windowsize is the size of the address hash-table, a power of 2
+void Sleigh::setDisassemblyCache(int4 cachesize,int4 windowsize) const
+
+{
+  uintb masktest = coveringmask((uintb)(windowsize-1));
+  if (masktest != (uintb)(windowsize-1))	// Fail before any shard is flushed
+    throw LowlevelError("Bad windowsize for disassembly cache");
+  std::lock_guard<std::mutex> lock(shard_mutex);
+  parser_cachesize = cachesize;
+  parser_windowsize = windowsize;
+  std::map<std::thread::id,DisassemblyCache *>::const_iterator iter;
+  for(iter=dis_shards.begin();iter!=dis_shards.end();++iter)
+    delete (*iter).second;
+  dis_shards.clear();
+}
+
+/// Every thread's shard is dropped, including its length cache and any p-code
+/// built from the old program bytes; shards are recreated on each thread's
+/// next disassembly.  The caller must ensure no disassembly is in progress.
+void Sleigh::clearDisassemblyCache(void) const
+
+{
+  std::lock_guard<std::mutex> lock(shard_mutex);
+  std::map<std::thread::id,DisassemblyCache *>::const_iterator iter;
+  for(iter=dis_shards.begin();iter!=dis_shards.end();++iter)
+    delete (*iter).second;
+  dis_shards.clear();
 }
 
 /// \brief Obtain a parse tree for the instruction at the given address
@@ -590,7 +713,7 @@ void Sleigh::initialize(DocumentStorage &store)
 ParserContext *Sleigh::obtainContext(const Address &addr,int4 state) const
 
 {
-  ParserContext *pos = discache->getParserContext(addr);
+  ParserContext *pos = obtainShard()->getParserContext(addr);
   int4 curstate = pos->getParserState();
   if (curstate >= state)
     return pos;
@@ -677,34 +800,42 @@ void Sleigh::resolveHandles(ParserContext &pos) const
     while(oper < numoper) {
       OperandSymbol *sym = ct->getOperand(oper);
       walker.pushOperand(oper);	// Descend into node
-      triple = sym->getDefiningSymbol();
-      if (triple != (TripleSymbol *)0) {
-	if (triple->getType() == SleighSymbol::subtable_symbol)
-	  break;
-	else			// Some other kind of symbol as an operand
-	  triple->getFixedHandle(walker.getParentHandle(),walker);
-      }
-      else {			// Must be an expression
-	PatternExpression *patexp = sym->getDefiningExpression();
-	intb res = patexp->getValue(walker);
-	FixedHandle &hand(walker.getParentHandle());
-	hand.space = pos.getConstSpace(); // Result of expression is a constant
-	hand.offset_space = (AddrSpace *)0;
-	hand.offset_offset = (uintb)res;
-	hand.size = 0;		// This size should not get used
+      if (ct->isFixedHandle(oper))	// Handle was precomputed at .sla load
+	walker.getParentHandle() = ct->getFixedHandle(oper);
+      else {
+	triple = sym->getDefiningSymbol();
+	if (triple != (TripleSymbol *)0) {
+	  if (triple->getType() == SleighSymbol::subtable_symbol)
+	    break;
+	  else			// Some other kind of symbol as an operand
+	    triple->getFixedHandle(walker.getParentHandle(),walker);
+	}
+	else {			// Must be an expression
+	  PatternExpression *patexp = sym->getDefiningExpression();
+	  intb res = patexp->getValue(walker);
+	  FixedHandle &hand(walker.getParentHandle());
+	  hand.space = pos.getConstSpace(); // Result of expression is a constant
+	  hand.offset_space = (AddrSpace *)0;
+	  hand.offset_offset = (uintb)res;
+	  hand.size = 0;		// This size should not get used
+	}
       }
       walker.popOperand();
       oper += 1;
     }
     if (oper >= numoper) {	// Finished processing constructor
-      ConstructTpl *templ = ct->getTempl();
-      if (templ != (ConstructTpl *)0) {
-	HandleTpl *res = templ->getResult();
-	if (res != (HandleTpl *)0)	// Pop up handle to containing operand
-	  res->fix(walker.getParentHandle(),walker);
-	// If we need an indicator that the constructor exports nothing try
-        // else
-	//   walker.getParentHandle().setInvalid();
+      if (ct->isFixedExport())	// Export handle was precomputed at .sla load
+	walker.getParentHandle() = ct->getFixedExport();
+      else {
+	ConstructTpl *templ = ct->getTempl();
+	if (templ != (ConstructTpl *)0) {
+	  HandleTpl *res = templ->getResult();
+	  if (res != (HandleTpl *)0)	// Pop up handle to containing operand
+	    res->fix(walker.getParentHandle(),walker);
+	  // If we need an indicator that the constructor exports nothing try
+	  // else
+	  //   walker.getParentHandle().setInvalid();
+	}
       }
       walker.popOperand();
     }
@@ -712,11 +843,64 @@ void Sleigh::resolveHandles(ParserContext &pos) const
   pos.setParserState(ParserContext::pcode);
 }
 
+/// The calling thread's cache shard is looked up once and the parse state is
+/// walked in place for the whole run, so long straight-line sweeps pay no
+/// per-instruction dispatch beyond the pattern walk itself.
+/// \param emit is the disassembly emitting object
+/// \param baseaddr is the address of the first machine instruction
+/// \param maxbytes is the maximum number of bytes to disassemble
+/// \return the number of bytes successfully disassembled
+int4 Sleigh::printAssemblyRange(AssemblyEmit &emit,const Address &baseaddr,int4 maxbytes) const
+
+{
+  DisassemblyCache *shard = obtainShard();
+  Address addr = baseaddr;
+  int4 total = 0;
+
+  while(total < maxbytes) {
+    ParserContext *pos = shard->getParserContext(addr);
+    try {
+      if (pos->getParserState() == ParserContext::uninitialized)
+	resolve(*pos);
+    } catch(BadDataError &err) {
+      break;			// Undecodable bytes end the run
+    }
+    ParserWalker walker(pos);
+    walker.baseState();
+    Constructor *ct = walker.getConstructor();
+    ostringstream mons;
+    ct->printMnemonic(mons,walker);
+    ostringstream body;
+    ct->printBody(body,walker);
+    emit.dump(addr,mons.str(),body.str());
+    int4 len = pos->getLength();
+    if (len <= 0) break;
+    total += len;
+    addr = addr + len;
+  }
+  return total;
+}
+
+/// Length-only queries are the inner loop of fall-through scanning, so they
+/// get their own fast path: a direct-mapped address -> length cache on the
+/// calling thread's shard, far larger than the ParserContext window for a
+/// fraction of the memory.  A miss performs the disassembly resolution (no
+/// handle or semantics processing) and caches just the resulting length.
+/// \param baseaddr is the address of the instruction
+/// \return the length of the instruction in bytes
 int4 Sleigh::instructionLength(const Address &baseaddr) const
 
 {
-  ParserContext *pos = obtainContext(baseaddr,ParserContext::disassembly);
-  return pos->getLength();
+  DisassemblyCache *shard = obtainShard();
+  int4 len = shard->getCachedLength(baseaddr);
+  if (len >= 0)
+    return len;
+  ParserContext *pos = shard->getParserContext(baseaddr);
+  if (pos->getParserState() == ParserContext::uninitialized)
+    resolve(*pos);		// Stop at disassembly resolution; length is now known
+  len = pos->getLength();
+  shard->setCachedLength(baseaddr,len);
+  return len;
 }
 
 int4 Sleigh::printAssembly(AssemblyEmit &emit,const Address &baseaddr) const
@@ -766,14 +950,21 @@ int4 Sleigh::oneInstruction(PcodeEmit &emit,const Address &baseaddr) const
     } while(bytecount < pos->getDelaySlot());
     pos->setNaddr(pos->getAddr()+fallOffset);
   }
+  if (pos->isPcodeCached()) {	// Replay the translation cached by an earlier decode
+    pos->emitPcodeCache(baseaddr,emit);
+    return fallOffset;
+  }
   ParserWalker walker(pos);
   walker.baseState();
-  pcode_cache.clear();
-  SleighBuilder builder(&walker,discache,&pcode_cache,getConstantSpace(),getUniqueSpace(),unique_allocatemask);
+  DisassemblyCache *shard = obtainShard();
+  PcodeCacher *pcodecache = shard->getPcodeCacher();	// Arena owned by this thread's shard
+  pcodecache->clear();
+  SleighBuilder builder(&walker,shard,pcodecache,getConstantSpace(),getUniqueSpace(),unique_allocatemask);
   try {
     builder.build(walker.getConstructor()->getTempl(),-1);
-    pcode_cache.resolveRelatives();
-    pcode_cache.emit(baseaddr,&emit);
+    pcodecache->resolveRelatives();
+    pcodecache->exportPcode(*pos);	// Cache the translation for replay by repeated decodes
+    pcodecache->emit(baseaddr,&emit);
   } catch(UnimplError &err) {
     ostringstream s;
     s << "Instruction not implemented in pcode:\n ";
@@ -792,6 +983,36 @@ int4 Sleigh::oneInstruction(PcodeEmit &emit,const Address &baseaddr) const
   return fallOffset;
 }
 
+/// Instruction parse trees are filled into this thread's DisassemblyCache,
+/// fully resolved for p-code generation, starting at the given address and
+/// following fall-thru flow.  Decoding stops at the stop address, when the
+/// instruction count is exhausted, at undecodable data, or at any instruction
+/// carrying context commits, since successors must not be parsed before those
+/// commits are applied.  Errors are left for the caller to rediscover with
+/// its own handling when it decodes the offending address for real.
+/// \param addr is the address of the first instruction to decode
+/// \param stopaddr is the first address that should \e not be decoded
+/// \param maxinstr is the maximum number of instructions to decode
+void Sleigh::decodeRange(const Address &addr,const Address &stopaddr,int4 maxinstr) const
+
+{
+  if (addr.getSpace() != stopaddr.getSpace()) return;
+  Address curaddr = addr;
+  while(maxinstr > 0 && curaddr < stopaddr) {
+    if (alignment != 1 && (curaddr.getOffset() % alignment)!=0) return;
+    ParserContext *pos;
+    try {
+      pos = obtainContext(curaddr,ParserContext::pcode);
+    }
+    catch(LowlevelError &err) {
+      return;			// Main decode loop will reproduce the error with proper handling
+    }
+    if (pos->hasCommits()) return;
+    curaddr = curaddr + pos->getLength();
+    maxinstr -= 1;
+  }
+}
+
 void Sleigh::registerContext(const string &name,int4 sbit,int4 ebit)
 
 {
@@ -21,6 +21,11 @@
 
 #include "sleighbase.hh"
 
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+
 namespace ghidra {
 
 class LoadImage;
@@ -53,9 +58,13 @@ struct PcodeData {
 /// The engine accumulates PcodeData and VarnodeData objects for
 /// a single instruction.  Once the full instruction is constructed,
 /// the objects are passed to the emitter (PcodeEmit) via the emit() method.
-/// The class acts as a pool of memory for PcodeData and VarnodeData objects
-/// that can be reused repeatedly to emit multiple instructions.
+/// The class acts as a bump arena for PcodeData and VarnodeData objects:
+/// clear() resets the allocation pointer between instructions without freeing,
+/// the pool grows geometrically on overflow, and new instances are sized from
+/// the high-water mark observed across all instances, so steady-state decode
+/// never reallocates even for instructions expanding to dozens of ops.
 class PcodeCacher {
+  static std::atomic<uint4> highwater;	///< Largest pool use observed across all instances
   VarnodeData *poolstart;		///< Start of the pool of VarnodeData objects
   VarnodeData *curpool;			///< First unused VarnodeData
   VarnodeData *endpool;			///< End of the pool of VarnodeData objects
@@ -96,29 +105,63 @@ public:
   void clear(void);			///< Reset the cache so that all objects are unallocated
   void resolveRelatives(void);		///< Rewrite branch target Varnodes as \e relative offsets
   void emit(const Address &addr,PcodeEmit *emt) const;	///< Pass the cached p-code data to the emitter
+  void exportPcode(ParserContext &pos) const;	///< Store the built p-code on the parser context for replay
 };
 
 /// \brief A container for disassembly context used by the SLEIGH engine
 ///
 /// This acts as a factor for the ParserContext objects which are used to disassemble
-/// a single instruction.  These all share a ContextCache which is a front end for
-/// accessing the ContextDatabase and resolving context variables from the SLEIGH spec.
+/// a single instruction.  These all share a ContextCacheView, a copy-on-write front end
+/// for accessing the ContextDatabase, so caches owned by different decode threads read
+/// context without locking and only synchronize on actual context changes.
 /// ParserContext objects are stored in a hash-table keyed by the address of the instruction.
 class DisassemblyCache {
+  /// \brief A cached instruction length, for length-only queries
+  struct LengthEntry {
+    uintb offset;		///< Offset of the instruction within its space
+    int4 length;		///< Length in bytes (-1 for an empty slot)
+  };
+  static const int4 LENGTH_CACHE_SIZE = 1024;	///< Number of (direct-mapped) length entries, a power of 2
   Translate *translate;		///< The Translate object that owns this cache
-  ContextCache *contextcache;	///< Cached values from the ContextDatabase
+  ContextCache *contextcache;	///< Copy-on-write view of the shared ContextCache (owned)
   AddrSpace *constspace;	///< The constant address space
   int4 minimumreuse;		///< Can call getParserContext this many times, before a ParserContext is reused
   uint4 mask;			///< Size of the hashtable in form 2^n-1
   ParserContext **list;		///< (circular) array of currently cached ParserContext objects
   int4 nextfree;		///< Current end/beginning of circular list
   ParserContext **hashtable;	///< Hashtable for looking up ParserContext via Address
+  vector<LengthEntry> lengthcache;	///< Instruction lengths, far cheaper to hold than a full ParserContext
+  PcodeCacher pcodecache;	///< P-code arena for instructions built by this (thread's) cache
+  uint8 hitcount;		///< Number of look-ups satisfied by an already parsed ParserContext
+  uint8 misscount;		///< Number of look-ups that had to recycle (and reparse) a ParserContext
   void initialize(int4 min,int4 hashsize);	///< Initialize the hash-table of ParserContexts
   void free(void);		///< Free the hash-table of ParserContexts
 public:
   DisassemblyCache(Translate *trans,ContextCache *ccache,AddrSpace *cspace,int4 cachesize,int4 windowsize);	///< Constructor
   ~DisassemblyCache(void) { free(); }	///< Destructor
   ParserContext *getParserContext(const Address &addr);		///< Get the parser for a particular Address
+  PcodeCacher *getPcodeCacher(void) { return &pcodecache; }	///< Get the p-code arena owned by \b this cache
+  uint8 getHitCount(void) const { return hitcount; }	///< Get the number of cache hits
+  uint8 getMissCount(void) const { return misscount; }	///< Get the number of cache misses
+
+  /// \brief Look up a cached instruction length
+  ///
+  /// \param addr is the address of the instruction
+  /// \return the length in bytes or -1 if the address is not cached
+  int4 getCachedLength(const Address &addr) const {
+    const LengthEntry &entry( lengthcache[ addr.getOffset() & (LENGTH_CACHE_SIZE-1) ] );
+    return (entry.offset == addr.getOffset()) ? entry.length : -1;
+  }
+
+  /// \brief Cache the length of the instruction at the given address
+  ///
+  /// \param addr is the address of the instruction
+  /// \param length is the length in bytes
+  void setCachedLength(const Address &addr,int4 length) {
+    LengthEntry &entry( lengthcache[ addr.getOffset() & (LENGTH_CACHE_SIZE-1) ] );
+    entry.offset = addr.getOffset();
+    entry.length = length;
+  }
 };
 
 /// \brief Build p-code from a pre-parsed instruction
@@ -163,24 +206,33 @@ class Sleigh : public SleighBase {
   LoadImage *loader;			///< The mapped bytes in the program
   ContextDatabase *context_db;		///< Database of context values steering disassembly
   ContextCache *cache;			///< Cache of recently used context values
-  mutable DisassemblyCache *discache;	///< Cache of recently parsed instructions
-  mutable PcodeCacher pcode_cache;	///< Cache of p-code data just prior to emitting
+  mutable int4 parser_cachesize;	///< Configured ParserContext objects per cache shard (-1 = automatic)
+  mutable int4 parser_windowsize;	///< Configured hash-table size per cache shard
+  mutable std::mutex shard_mutex;	///< Guards the shard table
+  mutable std::map<std::thread::id,DisassemblyCache *> dis_shards;	///< Per decode-thread instruction caches
   void clearForDelete(void);		///< Delete the context and disassembly caches
+  DisassemblyCache *obtainShard(void) const;	///< Get (or create) the calling thread's cache shard
 protected:
   ParserContext *obtainContext(const Address &addr,int4 state) const;
   void resolve(ParserContext &pos) const;	///< Generate a parse tree suitable for disassembly
   void resolveHandles(ParserContext &pos) const;	///< Prepare the parse tree for p-code generation
 public:
   Sleigh(LoadImage *ld,ContextDatabase *c_db);		///< Constructor
+  Sleigh(const Sleigh &op2,LoadImage *ld,ContextDatabase *c_db);	///< Shared-table constructor
   virtual ~Sleigh(void);				///< Destructor
   void reset(LoadImage *ld,ContextDatabase *c_db);	///< Reset the engine for a new program
   virtual void initialize(DocumentStorage &store);
   virtual void registerContext(const string &name,int4 sbit,int4 ebit);
   virtual void setContextDefault(const string &nm,uintm val);
   virtual void allowContextSet(bool val) const;
+  virtual void setDisassemblyCache(int4 cachesize,int4 windowsize) const;
+  virtual void clearDisassemblyCache(void) const;
+  void getCacheStats(uint8 &hits,uint8 &misses) const;	///< Sum ParserContext cache counters over all shards
   virtual int4 instructionLength(const Address &baseaddr) const;
   virtual int4 oneInstruction(PcodeEmit &emit,const Address &baseaddr) const;
+  virtual void decodeRange(const Address &addr,const Address &stopaddr,int4 maxinstr) const;
   virtual int4 printAssembly(AssemblyEmit &emit,const Address &baseaddr) const;
+  virtual int4 printAssemblyRange(AssemblyEmit &emit,const Address &baseaddr,int4 maxbytes) const;
 };
 
 /** \page sleigh SLEIGH
@@ -16,6 +16,11 @@
 #include "sleigh_arch.hh"
 #include "inject_sleigh.hh"
 
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <cstdio>
+#endif
+
 namespace ghidra {
 
 AttributeId ATTRIB_DEPRECATED = AttributeId("deprecated",136);
@@ -34,6 +39,11 @@ ElementId ELEM_LANGUAGE = ElementId("language",234);
 ElementId ELEM_LANGUAGE_DEFINITIONS = ElementId("language_definitions",235);
 
 map<int4,Sleigh> SleighArchitecture::translators;
+std::mutex SleighArchitecture::translators_mutex;
+map<string,Document *> SleighArchitecture::specdocs;
+std::mutex SleighArchitecture::specdocs_mutex;
+map<string,std::shared_ptr<const CoreTypeGroup>> SleighArchitecture::coregroups;
+std::mutex SleighArchitecture::coregroups_mutex;
 vector<LanguageDescription> SleighArchitecture::description;
 
 FileManage SleighArchitecture::specpaths; // Global specfile manager
@@ -50,6 +60,18 @@ void CompilerTag::decode(Decoder &decoder)
   decoder.closeElement(elemId);
 }
 
+/// Write a \<compiler> element describing \b this record
+/// \param encoder is the stream encoder
+void CompilerTag::encode(Encoder &encoder) const
+
+{
+  encoder.openElement(ELEM_COMPILER);
+  encoder.writeString(ATTRIB_NAME,name);
+  encoder.writeString(ATTRIB_SPEC,spec);
+  encoder.writeString(ATTRIB_ID,id);
+  encoder.closeElement(ELEM_COMPILER);
+}
+
 /// Parse an ldefs \<language> element
 /// \param decoder is the stream decoder
 void LanguageDescription::decode(Decoder &decoder)
@@ -95,6 +117,36 @@ void LanguageDescription::decode(Decoder &decoder)
   decoder.closeElement(elemId);
 }
 
+/// Write a \<language> element describing \b this processor.  Attributes and
+/// child elements are emitted in the order decode() reads them, so the output
+/// can be restored through any Decoder, packed or XML.
+/// \param encoder is the stream encoder
+void LanguageDescription::encode(Encoder &encoder) const
+
+{
+  encoder.openElement(ELEM_LANGUAGE);
+  encoder.writeString(ATTRIB_PROCESSOR,processor);
+  encoder.writeString(ATTRIB_ENDIAN,isbigendian ? "big" : "little");
+  encoder.writeSignedInteger(ATTRIB_SIZE,size);
+  encoder.writeString(ATTRIB_VARIANT,variant);
+  encoder.writeString(ATTRIB_VERSION,version);
+  encoder.writeString(ATTRIB_SLAFILE,slafile);
+  encoder.writeString(ATTRIB_PROCESSORSPEC,processorspec);
+  encoder.writeString(ATTRIB_ID,id);
+  if (deprecated)
+    encoder.writeBool(ATTRIB_DEPRECATED,true);
+  if (!description.empty()) {
+    encoder.openElement(ELEM_DESCRIPTION);
+    encoder.writeString(ATTRIB_CONTENT,description);
+    encoder.closeElement(ELEM_DESCRIPTION);
+  }
+  for(int4 i=0;i<compilers.size();++i)
+    compilers[i].encode(encoder);
+  for(int4 i=0;i<truncations.size();++i)
+    truncations[i].encode(encoder);
+  encoder.closeElement(ELEM_LANGUAGE);
+}
+
 /// Pick out the CompilerTag associated with the desired \e compiler \e id string
 /// \param nm is the desired id string
 /// \return a reference to the matching CompilerTag
@@ -152,6 +204,8 @@ void SleighArchitecture::loadLanguageDescription(const string &specfile,ostream
 SleighArchitecture::~SleighArchitecture(void)
 
 {
+  if (ownedtranslate != (Sleigh *)0)
+    delete ownedtranslate;
   translate = (const Translate *)0;
 }
 
@@ -168,21 +222,28 @@ string SleighArchitecture::getDescription(void) const
 bool SleighArchitecture::isTranslateReused(void)
 
 {
+  std::lock_guard<std::mutex> lock(translators_mutex);
   return (translators.find(languageindex) != translators.end());
 }
 
 Translate *SleighArchitecture::buildTranslator(DocumentStorage &store)
 
 {				// Build a sleigh translator
+  std::lock_guard<std::mutex> lock(translators_mutex);
   map<int4,Sleigh>::iterator iter;
 
   iter = translators.find(languageindex);
   if (iter != translators.end()) {
-    iter->second.reset(loader, context);
-    return &iter->second;
+    // The tables for this language are already decoded.  Build a lightweight
+    // translator sharing them, with its own context and disassembly caches, so
+    // concurrent Architecture instances never stomp each other's decode state.
+    ownedtranslate = new Sleigh(iter->second,loader,context);
+    return ownedtranslate;
   }
   pair<map<int4,Sleigh>::iterator,bool> res;
   res = translators.emplace(piecewise_construct,forward_as_tuple(languageindex),forward_as_tuple(loader,context));
+  res.first->second.initialize(store);	// Decode the tables while the lock is held, so a
+					// concurrent build of the same language can share them
   return &(*res.first).second;
 }
 
@@ -204,6 +265,14 @@ void SleighArchitecture::buildTypegrp(DocumentStorage &store)
 void SleighArchitecture::buildCoreTypes(DocumentStorage &store)
 
 {
+  {
+    std::lock_guard<std::mutex> lock(coregroups_mutex);
+    map<string,std::shared_ptr<const CoreTypeGroup>>::const_iterator giter = coregroups.find(target);
+    if (giter != coregroups.end()) {
+      types->adoptCoreTypes((*giter).second);	// Same language: share the universe already built
+      return;
+    }
+  }
   const Element *el = store.getTag("coretypes");
 
   if (el != (const Element *)0) {
@@ -236,6 +305,12 @@ void SleighArchitecture::buildCoreTypes(DocumentStorage &store)
     types->setCoreType("wchar4",4,TYPE_INT,true);
     types->cacheCoreTypes();
   }
+  std::lock_guard<std::mutex> lock(coregroups_mutex);
+  if (coregroups.find(target) == coregroups.end())
+    coregroups[target] = types->donateCoreTypes();	// Let later instances of this language share
+  else
+    types->donateCoreTypes();	// Another thread built the same language first; keep ownership
+				// with a private group so the types are freed exactly once
 }
 
 void SleighArchitecture::buildCommentDB(DocumentStorage &store)
@@ -311,9 +386,15 @@ void SleighArchitecture::buildSymbols(DocumentStorage &store)
       else
         symboltab->setPropertyRange(Varnode::volatil, range);
     }
-    Datatype *ct = types->getBase(size, TYPE_UNKNOWN);
-    Address usepoint;
-    symboltab->getGlobalScope()->addSymbol(name, ct, addr, usepoint);
+    Scope *scope = symboltab->getGlobalScope();
+    ScopeInternal *internal = dynamic_cast<ScopeInternal *>(scope);
+    if (internal != (ScopeInternal *)0)
+      internal->addDeferred(name, addr, size);	// Materialized on first query
+    else {
+      Datatype *ct = types->getBase(size, TYPE_UNKNOWN);
+      Address usepoint;
+      scope->addSymbol(name, ct, addr, usepoint);
+    }
     lastAddr = addr;
     lastSize = size;
   }
@@ -351,6 +432,37 @@ void SleighArchitecture::resolveArchitecture(void)
     throw LowlevelError("No sleigh specification for "+baseid);
 }
 
+/// Specification files are immutable once installed, and every Architecture
+/// built for a language re-reads the same .pspec and .cspec.  Parse each file
+/// at most once per process and hand out the cached DOM root; the cached
+/// Documents live until process exit.  The parse itself runs outside the
+/// cache lock so concurrent cold starts parse different files in parallel;
+/// a race on the same file costs one redundant parse, never a bad cache.
+/// \param filename is the path of the specification file
+/// \return the root element of the parsed document
+const Element *SleighArchitecture::getCachedSpecRoot(const string &filename)
+
+{
+  {
+    std::lock_guard<std::mutex> lock(specdocs_mutex);
+    map<string,Document *>::iterator iter = specdocs.find(filename);
+    if (iter != specdocs.end())
+      return (*iter).second->getRoot();
+  }
+  ifstream s(filename.c_str());
+  if (!s)
+    throw DecoderError("Unable to open xml document "+filename);
+  Document *doc = xml_tree(s);
+  std::lock_guard<std::mutex> lock(specdocs_mutex);
+  map<string,Document *>::iterator iter = specdocs.find(filename);
+  if (iter != specdocs.end()) {	// Another thread won the parse race
+    delete doc;
+    return (*iter).second->getRoot();
+  }
+  specdocs[filename] = doc;
+  return doc->getRoot();
+}
+
 void SleighArchitecture::buildSpecFile(DocumentStorage &store)
 
 { // Given a specific language, make sure relevant spec files are loaded
@@ -362,7 +474,7 @@ void SleighArchitecture::buildSpecFile(DocumentStorage &store)
   string processorfile;
   string compilerfile;
   string slafile;
-  
+
   specpaths.findFile(processorfile,language.getProcessorSpec());
   specpaths.findFile(compilerfile,compilertag.getSpec());
   if (!language_reuse) {
@@ -370,41 +482,10 @@ void SleighArchitecture::buildSpecFile(DocumentStorage &store)
     if (slafile.empty())
       throw SleighError("Could not find .sla file for " + archid);
   }
-  
-  try {
-    Document *doc = store.openDocument(processorfile);
-    store.registerTag(doc->getRoot());
-  }
-  catch(DecoderError &err) {
-    ostringstream serr;
-    serr << "XML error parsing processor specification: " << processorfile;
-    serr << "\n " << err.explain;
-    throw SleighError(serr.str());
-  }
-  catch(LowlevelError &err) {
-    ostringstream serr;
-    serr << "Error reading processor specification: " << processorfile;
-    serr << "\n " << err.explain;
-    throw SleighError(serr.str());
-  }
-  
-  try {
-    Document *doc = store.openDocument(compilerfile);
-    store.registerTag(doc->getRoot());
-  }
-  catch(DecoderError &err) {
-    ostringstream serr;
-    serr << "XML error parsing compiler specification: " << compilerfile;
-    serr << "\n " << err.explain;
-    throw SleighError(serr.str());
-  }
-  catch(LowlevelError &err) {
-    ostringstream serr;
-    serr << "Error reading compiler specification: " << compilerfile;
-    serr << "\n " << err.explain;
-    throw SleighError(serr.str());
-  }
 
+  // Register the <sleigh> tag first (it only wraps the file path) so a
+  // caller can start decoding the .sla tables while the specification
+  // files below are still being parsed
   if (!language_reuse) {
     istringstream s("<sleigh>" + slafile + "</sleigh>");
     try {
@@ -418,6 +499,42 @@ void SleighArchitecture::buildSpecFile(DocumentStorage &store)
       throw SleighError(serr.str());
     }
   }
+
+  // The two specification files are independent: parse the processor spec
+  // on a worker while the compiler spec parses here, so a cold start (both
+  // missing from the process-wide cache) costs the longer parse, not the sum
+  const Element *procroot = (const Element *)0;
+  string procerror;
+  std::thread procthread([&processorfile,&procroot,&procerror]() {
+    try {
+      procroot = getCachedSpecRoot(processorfile);
+    }
+    catch(DecoderError &err) {
+      procerror = "XML error parsing processor specification: " + processorfile + "\n " + err.explain;
+    }
+    catch(LowlevelError &err) {
+      procerror = "Error reading processor specification: " + processorfile + "\n " + err.explain;
+    }
+  });
+
+  const Element *comproot = (const Element *)0;
+  string comperror;
+  try {
+    comproot = getCachedSpecRoot(compilerfile);
+  }
+  catch(DecoderError &err) {
+    comperror = "XML error parsing compiler specification: " + compilerfile + "\n " + err.explain;
+  }
+  catch(LowlevelError &err) {
+    comperror = "Error reading compiler specification: " + compilerfile + "\n " + err.explain;
+  }
+  procthread.join();
+  if (!procerror.empty())
+    throw SleighError(procerror);
+  if (!comperror.empty())
+    throw SleighError(comperror);
+  store.registerTag(procroot);
+  store.registerTag(comproot);
 }
 
 void SleighArchitecture::modifySpaces(Translate *trans)
@@ -442,11 +559,123 @@ SleighArchitecture::SleighArchitecture(const string &fname,const string &targ,os
   filename = fname;
   target = targ;
   errorstream = estream;
+  ownedtranslate = (Sleigh *)0;
+}
+
+#ifndef _WIN32
+
+static const int4 DESCRIPTION_CACHE_VERSION = 1;	///< Format version of the .ldefs.cache file
+
+/// \brief Compute a staleness key over a set of specification files
+///
+/// The key is an FNV-1a hash folding in each file's path, modification time, and
+/// size, so adding, removing, or editing any .ldefs invalidates a cache built
+/// from the set.
+/// \param specfiles is the list of paths to hash
+/// \return the 64-bit key
+static uint8 specFileKey(const vector<string> &specfiles)
+
+{
+  uint8 hash = 0xcbf29ce484222325;
+  for(int4 i=0;i<specfiles.size();++i) {
+    const string &path( specfiles[i] );
+    struct stat status;
+    uint8 mtime = 0;
+    uint8 fsize = 0;
+    if (stat(path.c_str(),&status)==0) {
+      mtime = (uint8)status.st_mtime;
+      fsize = (uint8)status.st_size;
+    }
+    for(int4 j=0;j<path.size();++j) {
+      hash ^= (uint1)path[j];
+      hash *= 0x100000001b3;
+    }
+    for(int4 j=0;j<8;++j) {
+      hash ^= (mtime >> (j*8)) & 0xff;
+      hash *= 0x100000001b3;
+      hash ^= (fsize >> (j*8)) & 0xff;
+      hash *= 0x100000001b3;
+    }
+  }
+  return hash;
 }
 
+/// \brief Load language descriptions from a previously built cache file
+///
+/// The file starts with a plain-text header line holding the format version and
+/// staleness key, followed by a PackedEncode stream of the descriptions.  A
+/// missing file, mismatched header, or any decoding error is reported as a miss
+/// so the caller falls back to XML parsing.
+/// \param cachefile is the path to the cache file
+/// \param key is the staleness key the header must match
+/// \param descs will hold the loaded descriptions
+/// \return \b true if the cache was valid and \b descs was populated
+static bool loadDescriptionCache(const string &cachefile,uint8 key,vector<LanguageDescription> &descs)
+
+{
+  ifstream s(cachefile.c_str(),ios::binary);
+  if (!s) return false;
+  string header;
+  getline(s,header);
+  ostringstream expect;
+  expect << "ldefscache " << dec << DESCRIPTION_CACHE_VERSION << ' ' << hex << key;
+  if (header != expect.str())
+    return false;		// Stale or from a different format version
+  PackedDecode decoder((const AddrSpaceManager *)0);
+  try {
+    decoder.ingestStream(s);
+    uint4 elemId = decoder.openElement(ELEM_LANGUAGE_DEFINITIONS);
+    while(decoder.peekElement() != 0) {
+      descs.emplace_back();
+      descs.back().decode(decoder);
+    }
+    decoder.closeElement(elemId);
+  }
+  catch(LowlevelError &err) {	// Truncated or corrupt cache
+    descs.clear();
+    return false;
+  }
+  return !descs.empty();
+}
+
+/// \brief Write the language descriptions to a cache file for later warm starts
+///
+/// The file is written to a temporary path and atomically renamed into place, so
+/// a concurrent server start never sees a partial cache.  Failures are silently
+/// ignored; the install directory may be read-only.
+/// \param cachefile is the path of the cache file to create
+/// \param key is the staleness key to record in the header
+/// \param descs is the list of descriptions to encode
+static void saveDescriptionCache(const string &cachefile,uint8 key,const vector<LanguageDescription> &descs)
+
+{
+  string tmpPath = cachefile + ".tmp";
+  {
+    ofstream s(tmpPath.c_str(),ios::binary|ios::trunc);
+    if (!s) return;
+    s << "ldefscache " << dec << DESCRIPTION_CACHE_VERSION << ' ' << hex << key << '\n';
+    PackedEncode encoder(s);
+    encoder.openElement(ELEM_LANGUAGE_DEFINITIONS);
+    for(int4 i=0;i<descs.size();++i)
+      descs[i].encode(encoder);
+    encoder.closeElement(ELEM_LANGUAGE_DEFINITIONS);
+    if (!s) {
+      s.close();
+      remove(tmpPath.c_str());
+      return;
+    }
+  }
+  if (rename(tmpPath.c_str(),cachefile.c_str()) != 0)
+    remove(tmpPath.c_str());
+}
+
+#endif
+
 /// This is run once when spinning up the decompiler.
 /// Look for the root .ldefs files within the normal directories and parse them.
 /// Use these to populate the list of \e language \e ids that are supported.
+/// A compiled cache of the parsed descriptions is kept beside the .ldefs files,
+/// so a warm start skips the XML parsing entirely.
 /// \param errs is an output stream for writing error messages
 void SleighArchitecture::collectSpecFiles(ostream &errs)
 
@@ -456,8 +685,28 @@ void SleighArchitecture::collectSpecFiles(ostream &errs)
   vector<string> testspecs;
   vector<string>::iterator iter;
   specpaths.matchList(testspecs,".ldefs",true);
+#ifndef _WIN32
+  uint8 key = 0;
+  string cachefile;
+  if (!testspecs.empty()) {
+    key = specFileKey(testspecs);
+    string::size_type pos = testspecs.front().rfind('/');
+    if (pos != string::npos) {
+      cachefile = testspecs.front().substr(0,pos+1) + ".ldefs.cache";
+      if (loadDescriptionCache(cachefile,key,description))
+	return;
+    }
+  }
+#endif
+  ostringstream warnings;
   for(iter=testspecs.begin();iter!=testspecs.end();++iter)
-    loadLanguageDescription(*iter,errs);
+    loadLanguageDescription(*iter,warnings);
+  errs << warnings.str();
+#ifndef _WIN32
+  // Only cache a clean parse; a warm start must reproduce any cold-start errors
+  if (!cachefile.empty() && !description.empty() && warnings.str().empty())
+    saveDescriptionCache(cachefile,key,description);
+#endif
 }
 
 /// \param encoder is the stream encoder
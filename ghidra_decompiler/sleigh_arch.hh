@@ -50,6 +50,7 @@ class CompilerTag {
 public:
   CompilerTag(void) {}	///< Constructor
   void decode(Decoder &decoder);	///< Restore the record from an XML stream
+  void encode(Encoder &encoder) const;	///< Encode the record to a stream
   const string &getName(void) const { return name; }	///< Get the human readable name of the spec
   const string &getSpec(void) const { return spec; }	///< Get the file-name
   const string &getId(void) const { return id; }	///< Get the string used as part of \e language \e id
@@ -79,6 +80,7 @@ class LanguageDescription {
 public:
   LanguageDescription(void) {}					///< Constructor
   void decode(Decoder &decoder);				///< Parse \b this description from a stream
+  void encode(Encoder &encoder) const;				///< Encode \b this description to a stream
   const string &getProcessor(void) const { return processor; }	///< Get the name of the processor
   bool isBigEndian(void) const { return isbigendian; }		///< Return \b true if the processor is big-endian
   int4 getSize(void) const { return size; }			///< Get the size of the address bus
@@ -105,13 +107,29 @@ public:
 ///
 /// Generally a \e language \e id (i.e. x86:LE:64:default) is provided, then this
 /// object is able to automatically load in configuration and construct the Translate object.
+///
+/// Start-up cost is amortized at several levels: the .ldefs scan is cached in a
+/// flat sidecar file, the compiled .sla image is inflated once into a sidecar
+/// that later starts memory-map, parsed .pspec/.cspec documents are cached for
+/// the life of the process, and decoded SLEIGH tables are shared between all
+/// Architecture instances for the same language.  The resolved products of the
+/// compiler spec (prototype models, context defaults) are rebuilt from the
+/// cached document per instance: they embed per-instance AddrSpace pointers and
+/// have no flat serialization.
 class SleighArchitecture : public Architecture {
-  static map<int4,Sleigh> translators;		///< Map from language index to instantiated translators
+  static map<int4,Sleigh> translators;		///< Map from language index to translators holding the decoded tables
+  static std::mutex translators_mutex;		///< Guards the \b translators map
+  static map<string,Document *> specdocs;	///< Cache of parsed specification files, keyed by file path
+  static std::mutex specdocs_mutex;		///< Guards the \b specdocs map
+  static map<string,std::shared_ptr<const CoreTypeGroup>> coregroups;	///< Core data-type groups shared across instances, keyed by language id
+  static std::mutex coregroups_mutex;		///< Guards the \b coregroups map
   static vector<LanguageDescription> description;	///< List of languages we know about
   int4 languageindex;					///< Index (within LanguageDescription array) of the active language
   string filename;					///< Name of active load-image file
   string target;					///< The \e language \e id of the active load-image
+  Sleigh *ownedtranslate;				///< Shared-table translator owned by \b this (may be null)
   static void loadLanguageDescription(const string &specfile,ostream &errs);
+  static const Element *getCachedSpecRoot(const string &filename);	///< Parse a specification file at most once per process
   bool isTranslateReused(void);				///< Test if last Translate object can be reused
 protected:
   ostream *errorstream;					///< Error stream associated with \b this SleighArchitecture
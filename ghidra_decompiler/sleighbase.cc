@@ -66,6 +66,11 @@ void SourceFileIndexer::encode(Encoder &encoder) const
 }
 
 SleighBase::SleighBase(void)
+  : tables(new SleighTables()), userop(tables->userop), varnode_xref(tables->varnode_xref),
+    register_loc_hash(tables->register_loc_hash), register_name_hash(tables->register_name_hash),
+    root(tables->root), symtab(tables->symtab), maxdelayslotbytes(tables->maxdelayslotbytes),
+    unique_allocatemask(tables->unique_allocatemask), numSections(tables->numSections),
+    indexer(tables->indexer)
 
 {
   root = (SubtableSymbol *)0;
@@ -74,8 +79,33 @@ SleighBase::SleighBase(void)
   numSections = 0;
 }
 
+/// The new translator holds a reference to the (already decoded) tables of the
+/// given translator, rather than a private copy, and shares its address spaces.
+/// The tables are effectively immutable, so any number of translators built this
+/// way can decode concurrently; each still carries its own mutable state
+/// (context database, caches) supplied by the derived class.
+/// \param op2 is the fully initialized translator to share tables with
+SleighBase::SleighBase(const SleighBase &op2)
+  : tables(op2.tables), userop(tables->userop), varnode_xref(tables->varnode_xref),
+    register_loc_hash(tables->register_loc_hash), register_name_hash(tables->register_name_hash),
+    root(tables->root), symtab(tables->symtab), maxdelayslotbytes(tables->maxdelayslotbytes),
+    unique_allocatemask(tables->unique_allocatemask), numSections(tables->numSections),
+    indexer(tables->indexer)
+
+{
+  copySpaces(&op2);
+  setBigEndian(op2.isBigEndian());
+  setUniqueBase(op2.getUniqueBase());
+  alignment = op2.alignment;
+  floatformats = op2.floatformats;
+}
+
 /// Assuming the symbol table is populated, iterate through the table collecting
-/// registers (for the map), user-op names, and context fields.
+/// registers (for the map), user-op names, and context fields.  The registers
+/// additionally populate a pair of hash tables, keyed by exact storage location
+/// and by name, so the per-operand lookups during assembly emission are a single
+/// hash probe.  The hashed values point into \b varnode_xref, whose nodes are
+/// stable once \b this method completes.
 void SleighBase::buildXrefs(vector<string> &errorPairs)
 
 {
@@ -93,6 +123,10 @@ void SleighBase::buildXrefs(vector<string> &errorPairs)
 	errorPairs.push_back(sym->getName());
 	errorPairs.push_back((*(res.first)).second);
       }
+      else {
+	register_loc_hash[(*res.first).first] = &(*res.first).second;
+	register_name_hash[(*res.first).second] = &(*res.first).first;
+      }
     }
     else if (sym->getType() == SleighSymbol::userop_symbol) {
       int4 index = ((UserOpSymbol *)sym)->getIndex();
@@ -110,6 +144,25 @@ void SleighBase::buildXrefs(vector<string> &errorPairs)
   }
 }
 
+/// Assuming the symbol table is populated, visit every Constructor of every
+/// subtable and precompute the operand and export handles that don't depend
+/// on the parse tree, so handle resolution can skip them per decode.
+void SleighBase::cacheFixedHandles(void)
+
+{
+  SymbolScope *glb = symtab.getGlobalScope();
+  SymbolTree::const_iterator iter;
+  AddrSpace *constspace = getConstantSpace();
+
+  for(iter=glb->begin();iter!=glb->end();++iter) {
+    SleighSymbol *sym = *iter;
+    if (sym->getType() != SleighSymbol::subtable_symbol) continue;
+    SubtableSymbol *subsym = (SubtableSymbol *)sym;
+    for(int4 i=0;i<subsym->getNumConstructors();++i)
+      subsym->getConstructor(i)->cacheFixedHandles(constspace);
+  }
+}
+
 /// If \b this SleighBase is being reused with a new program, the context
 /// variables need to be registered with the new program's database
 void SleighBase::reregisterContext(void)
@@ -133,6 +186,9 @@ void SleighBase::reregisterContext(void)
 const VarnodeData &SleighBase::getRegister(const string &nm) const
 
 {
+  unordered_map<string,const VarnodeData *>::const_iterator hiter = register_name_hash.find(nm);
+  if (hiter != register_name_hash.end())
+    return *(*hiter).second;
   VarnodeSymbol *sym = (VarnodeSymbol *)findSymbol(nm);
   if (sym == (VarnodeSymbol *)0)
     throw SleighError("Unknown register name: "+nm);
@@ -148,6 +204,10 @@ string SleighBase::getRegisterName(AddrSpace *base,uintb off,int4 size) const
   sym.space = base;
   sym.offset = off;
   sym.size = size;
+  unordered_map<VarnodeData,const string *,SleighTables::RegisterHash>::const_iterator hiter;
+  hiter = register_loc_hash.find(sym);	// Exact hits, the common case, are a single hash probe
+  if (hiter != register_loc_hash.end())
+    return *(*hiter).second;
   map<VarnodeData,string>::const_iterator iter = varnode_xref.upper_bound(sym); // First point greater than offset
   if (iter == varnode_xref.begin()) return "";
   iter--;
@@ -174,9 +234,10 @@ string SleighBase::getExactRegisterName(AddrSpace *base,uintb off,int4 size) con
   sym.space = base;
   sym.offset = off;
   sym.size = size;
-  map<VarnodeData,string>::const_iterator iter = varnode_xref.find(sym);
-  if (iter == varnode_xref.end()) return "";
-  return (*iter).second;
+  unordered_map<VarnodeData,const string *,SleighTables::RegisterHash>::const_iterator iter;
+  iter = register_loc_hash.find(sym);
+  if (iter == register_loc_hash.end()) return "";
+  return *(*iter).second;
 }
 
 void SleighBase::getAllRegisters(map<VarnodeData,string> &reglist) const
@@ -376,6 +437,7 @@ void SleighBase::decode(Decoder &decoder)
   buildXrefs(errorPairs);
   if (!errorPairs.empty())
     throw SleighError("Duplicate register pairs");
+  cacheFixedHandles();
 }
 
 } // End namespace ghidra
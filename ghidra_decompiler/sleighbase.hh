@@ -21,6 +21,7 @@
 #include "translate.hh"
 #include "slaformat.hh"
 #include "slghsymbol.hh"
+#include <memory>
 
 namespace ghidra {
 
@@ -51,23 +52,68 @@ private:
   map<string, int4> fileToIndex;  ///< map from files to indices
 };
 
-/// \brief Common core of classes that read or write SLEIGH specification files natively.
-
+/// \brief The decoded tables of a SLEIGH specification
 ///
-/// This class represents what's in common across the SLEIGH infrastructure between:
-///   - Reading the various SLEIGH specification files
-///   - Building and writing out SLEIGH specification files
-class SleighBase : public Translate {
-  vector<string> userop;		///< Names of user-define p-code ops for \b this Translate object
+/// The symbol table, decision trees, and semantic templates read from a .sla file.
+/// Once decoding is complete the tables are never modified, so translator
+/// instances for the same language can share a single copy.  Subtable bodies
+/// whose decode was deferred (SubtableSymbol::deferDecode) are the one
+/// exception; each fills itself in on its first resolution hit, under its own
+/// lock, out of the mapped image held by \b slaBacking.
+struct SleighTables {
+  /// \brief Hash function for a register's storage location
+  struct RegisterHash {
+    /// \brief Mix the space, offset, and size of a location into a hash bucket index
+    ///
+    /// \param vn is the storage location to hash
+    /// \return the hash value
+    size_t operator()(const VarnodeData &vn) const {
+      uint8 res = vn.offset;
+      res *= 0x100000001b3;	// FNV-1a style mixing of the location components
+      res ^= ((uint8)vn.size << 32) ^ (uint8)(uintp)vn.space;
+      res *= 0x100000001b3;
+      return (size_t)(res ^ (res >> 32));
+    }
+  };
+  vector<string> userop;		///< Names of user-define p-code ops in the specification
   map<VarnodeData,string> varnode_xref;	///< A map from Varnodes in the \e register space to register names
-protected:
+  unordered_map<VarnodeData,const string *,RegisterHash> register_loc_hash;	///< Hashed exact location -> register name, into \b varnode_xref
+  unordered_map<string,const VarnodeData *> register_name_hash;	///< Hashed register name -> storage location, into \b varnode_xref
   SubtableSymbol *root;		///< The root SLEIGH decoding symbol
   SymbolTable symtab;		///< The SLEIGH symbol table
   uint4 maxdelayslotbytes;	///< Maximum number of bytes in a delay-slot directive
   uint4 unique_allocatemask;	///< Bits that are guaranteed to be zero in the unique allocation scheme
   uint4 numSections;		///< Number of \e named sections
   SourceFileIndexer indexer;    ///< source file index used when generating SLEIGH constructor debug info
+  std::unique_ptr<sla::FormatDecode> slaBacking;	///< Mapped .sla image backing deferred subtable bodies (may be null)
+};
+
+/// \brief Common core of classes that read or write SLEIGH specification files natively.
+
+///
+/// This class represents what's in common across the SLEIGH infrastructure between:
+///   - Reading the various SLEIGH specification files
+///   - Building and writing out SLEIGH specification files
+///
+/// The decoded tables live in a separate SleighTables object that may be shared
+/// with other translator instances of the same language; members of \b this class
+/// are references into that object so existing table accesses read naturally.
+class SleighBase : public Translate {
+  std::shared_ptr<SleighTables> tables;	///< The specification tables, possibly shared
+  vector<string> &userop;		///< Names of user-define p-code ops for \b this Translate object
+  map<VarnodeData,string> &varnode_xref;	///< A map from Varnodes in the \e register space to register names
+  unordered_map<VarnodeData,const string *,SleighTables::RegisterHash> &register_loc_hash;	///< Hashed exact location -> register name
+  unordered_map<string,const VarnodeData *> &register_name_hash;	///< Hashed register name -> storage location
+protected:
+  SubtableSymbol *&root;	///< The root SLEIGH decoding symbol
+  SymbolTable &symtab;		///< The SLEIGH symbol table
+  uint4 &maxdelayslotbytes;	///< Maximum number of bytes in a delay-slot directive
+  uint4 &unique_allocatemask;	///< Bits that are guaranteed to be zero in the unique allocation scheme
+  uint4 &numSections;		///< Number of \e named sections
+  SourceFileIndexer &indexer;   ///< source file index used when generating SLEIGH constructor debug info
   void buildXrefs(vector<string> &errorPairs);	///< Build register map. Collect user-ops and context-fields.
+  void cacheFixedHandles(void);	///< Precompute decode-invariant handles for every Constructor
+  void setSlaBacking(sla::FormatDecode *decoder) { tables->slaBacking.reset(decoder); }	///< Keep the mapped .sla image alive for deferred subtable decode
   void reregisterContext(void);	///< Reregister context fields for a new executable
   AddrSpace *decodeSlaSpace(Decoder &decoder,const Translate *trans); ///< Add a space parsed from a .sla file
   void decodeSlaSpaces(Decoder &decoder,const Translate *trans); ///< Restore address spaces from a .sla file
@@ -75,6 +121,7 @@ protected:
 public:
   static const uint4 MAX_UNIQUE_SIZE;    ///< Maximum size of a varnode in the unique space (should match value in SleighBase.java)
   SleighBase(void);		///< Construct an uninitialized translator
+  SleighBase(const SleighBase &op2);	///< Construct a translator sharing the tables of another
   bool isInitialized(void) const { return (root != (SubtableSymbol *)0); }	///< Return \b true if \b this is initialized
   virtual ~SleighBase(void) {}	///< Destructor
   virtual const VarnodeData &getRegister(const string &nm) const;
@@ -83,6 +130,7 @@ public:
   virtual void getAllRegisters(map<VarnodeData,string> &reglist) const;
   virtual void getUserOpNames(vector<string> &res) const;
 
+  std::shared_ptr<const SleighTables> getTables(void) const { return tables; }	///< Get the specification tables, which may be shared with other translators
   SleighSymbol *findSymbol(const string &nm) const { return symtab.findSymbol(nm); }	///< Find a specific SLEIGH symbol by name in the current scope
   SleighSymbol *findSymbol(uintm id) const { return symtab.findSymbol(id); }	///< Find a specific SLEIGH symbol by id
   SleighSymbol *findGlobalSymbol(const string &nm) const { return symtab.findGlobalSymbol(nm); }	///< Find a specific global SLEIGH symbol by name
@@ -16,6 +16,12 @@
 #include "slgh_compile.hh"
 #include "filemanage.hh"
 #include <csignal>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 extern FILE *sleighin;		// Global pointer to file for lexer
 extern int sleighlex_destroy(void);
@@ -1790,6 +1796,7 @@ SleighCompile::SleighCompile(void)
   warnallnops = false;
   failinsensitivedups = true;
   debugoutput = false;
+  maxthreads = 1;
   root = (SubtableSymbol *)0;
   curmacro = (MacroSymbol *)0;
   curct = (Constructor *)0;
@@ -1902,14 +1909,41 @@ int4 SleighCompile::calcContextVarLayout(int4 start,int4 sz,int4 numbits)
 /// conflicting patterns is accumulated.  Identical pattern pairs are reported
 /// as errors, and indistinguishable pattern pairs are reported as errors depending
 /// on the \b lenientconflicterrors setting.
+/// Each subtable's tree only touches that subtable's own constructors, so when
+/// multiple worker threads are configured, the subtables are partitioned into
+/// contiguous blocks built concurrently.  Error pairs accumulate in per-thread
+/// DecisionProperties that are folded back together in table order, keeping
+/// reported errors deterministic.
 void SleighCompile::buildDecisionTrees(void)
 
 {
   DecisionProperties props;
   root->buildDecisionTree(props);
 
-  for(int4 i=0;i<tables.size();++i)
-    tables[i]->buildDecisionTree(props);
+  int4 numthreads = maxthreads;
+  if (numthreads > tables.size())
+    numthreads = tables.size();
+  if (numthreads > 1) {
+    vector<DecisionProperties> threadprops(numthreads);
+    vector<std::thread> pool;
+    for(int4 t=0;t<numthreads;++t) {
+      int4 start = (int4)(((int8)tables.size() * t) / numthreads);
+      int4 stop = (int4)(((int8)tables.size() * (t+1)) / numthreads);
+      DecisionProperties *myprops = &threadprops[t];
+      pool.emplace_back([this,start,stop,myprops](void) {
+	for(int4 i=start;i<stop;++i)
+	  tables[i]->buildDecisionTree(*myprops);
+      });
+    }
+    for(int4 t=0;t<numthreads;++t)
+      pool[t].join();
+    for(int4 t=0;t<numthreads;++t)
+      props.absorb(threadprops[t]);
+  }
+  else {
+    for(int4 i=0;i<tables.size();++i)
+      tables[i]->buildDecisionTree(props);
+  }
 
   const vector<pair<Constructor*, Constructor*> > &ierrors( props.getIdentErrors() );
   if (ierrors.size() != 0) {
@@ -3749,6 +3783,7 @@ int main(int argc,char **argv)
   if (argc < 2) {
     cerr << "USAGE: sleigh [-x] [-dNAME=VALUE] inputfile [outputfile]" << endl;
     cerr << "   -a              scan for all slaspec files recursively where inputfile is a directory" << endl;
+    cerr << "   -jN             compile with N parallel jobs (0 = number of hardware threads)" << endl;
     cerr << "   -x              turns on parser debugging" << endl;
     cerr << "   -y              write .sla using XML debug format" << endl;
     cerr << "   -u              print warnings for unnecessary pcode instructions" << endl;
@@ -3777,12 +3812,30 @@ int main(int argc,char **argv)
   bool debugOutput = false;
   
   bool compileAll = false;
-  
+  int4 maxJobs = 1;
+
   int4 i;
   for(i=1;i<argc;++i) {
     if (argv[i][0] != '-') break;
     if (argv[i][1] == 'a')
       compileAll = true;
+    else if (argv[i][1] == 'j') {
+      maxJobs = 0;		// Bare -j selects one job per hardware thread
+      if (argv[i][2] != 0) {
+	istringstream s(argv[i]+2);
+	maxJobs = -1;
+	s >> maxJobs;
+	if (maxJobs < 0) {
+	  cerr << "Bad sleigh option: "<< argv[i] << endl;
+	  exit(1);
+	}
+      }
+      if (maxJobs == 0) {
+	maxJobs = (int4)std::thread::hardware_concurrency();
+	if (maxJobs < 1)
+	  maxJobs = 1;
+      }
+    }
     else if (argv[i][1] == 'D') {
       string preproc(argv[i]+2);
       string::size_type pos = preproc.find('=');
@@ -3836,6 +3889,51 @@ int main(int argc,char **argv)
       dirStr = argv[i];
     findSlaSpecs(slaspecs, dirStr,SLASPECEXT);
     cout << "Compiling " << dec << slaspecs.size() << " slaspec files in " << dirStr << endl;
+#ifndef _WIN32
+    if (maxJobs > 1 && slaspecs.size() > 1) {
+      // Compile specs in separate worker processes, up to maxJobs at a time.
+      // The parser's global state (lexer file stack, the slgh object pointer)
+      // rules out in-process concurrency across files; a fresh process per
+      // spec gets full isolation for free.
+      map<pid_t,string> running;
+      int4 next = 0;
+      for(;;) {
+	while(retval == 0 && next < slaspecs.size() && running.size() < (size_t)maxJobs) {
+	  string slaspec = slaspecs[next];
+	  cout << "Compiling (" << dec << (next+1) << " of " << dec << slaspecs.size() << ") " << slaspec << endl;
+	  string sla = slaspec;
+	  sla.replace(slaspec.length() - slaspecExtLen, slaspecExtLen, SLAEXT);
+	  next += 1;
+	  pid_t pid = fork();
+	  if (pid == 0) {
+	    SleighCompile compiler;
+	    compiler.setAllOptions(defines, unnecessaryPcodeWarning, lenientConflict, allCollisionWarning, allNopWarning,
+				   deadTempWarning, enforceLocalKeyWord,largeTemporaryWarning, caseSensitiveRegisterNames,
+				   debugOutput);
+	    exit(compiler.run_compilation(slaspec,sla) != 0 ? 1 : 0);
+	  }
+	  if (pid < 0) {
+	    cerr << "Unable to fork compile job" << endl;
+	    retval = 1;
+	    break;
+	  }
+	  running[pid] = slaspec;
+	}
+	if (running.empty()) break;
+	int status = 0;
+	pid_t done = waitpid(-1,&status,0);
+	if (done < 0) break;
+	map<pid_t,string>::iterator riter = running.find(done);
+	if (riter == running.end()) continue;
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+	  cerr << "Compile failed: " << (*riter).second << endl;
+	  retval = 1;		// Launch no new jobs, but let outstanding ones finish
+	}
+	running.erase(riter);
+      }
+      return retval;
+    }
+#endif
     for(int4 j=0;j<slaspecs.size();++j) {
       string slaspec = slaspecs[j];
       cout << "Compiling (" << dec << (j+1) << " of " << dec << slaspecs.size() << ") " << slaspec << endl;
@@ -3845,12 +3943,13 @@ int main(int argc,char **argv)
       compiler.setAllOptions(defines, unnecessaryPcodeWarning, lenientConflict, allCollisionWarning, allNopWarning,
 			     deadTempWarning, enforceLocalKeyWord,largeTemporaryWarning, caseSensitiveRegisterNames,
 			     debugOutput);
+      compiler.setMaxThreads(maxJobs);
       retval = compiler.run_compilation(slaspec,sla);
       if (retval != 0) {
 	return retval; // stop on first error
       }
     }
-    
+
   } else { // compile single specification
     
     if (i==argc) {
@@ -3882,7 +3981,8 @@ int main(int argc,char **argv)
     compiler.setAllOptions(defines, unnecessaryPcodeWarning, lenientConflict, allCollisionWarning, allNopWarning,
 			   deadTempWarning, enforceLocalKeyWord,largeTemporaryWarning,caseSensitiveRegisterNames,
 			   debugOutput);
-    
+    compiler.setMaxThreads(maxJobs);
+
     if (i < argc - 1) {
       string fileoutExamine(argv[i+1]);
       string::size_type extOutPos = fileoutExamine.find(SLAEXT);
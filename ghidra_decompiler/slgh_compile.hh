@@ -301,6 +301,7 @@ private:
   bool warnallnops;			///< \b true if pcode NOPs generate individual warnings
   bool failinsensitivedups;		///< \b true if case insensitive register duplicates cause error
   bool debugoutput;			///< \b true if output .sla is written in XML debug format
+  int4 maxthreads;			///< Maximum worker threads for per-subtable compilation stages
   vector<string> noplist;		///< List of individual NOP warnings
   mutable Location currentLocCache;	///< Location for (last) request of current location
   int4 errors;				///< Number of fatal errors encountered
@@ -368,6 +369,11 @@ public:
   /// \param val is \b true if no error is generated.  The default is \b true.
   void setLenientConflict(bool val) { lenientconflicterrors = val; }
 
+  /// \brief Set the number of worker threads used for per-subtable compilation stages
+  ///
+  /// \param val is the maximum thread count.  The default is 1 (fully sequential).
+  void setMaxThreads(int4 val) { maxthreads = (val < 1) ? 1 : val; }
+
   /// \brief Set whether collisions in exported locals generate warnings individually
   ///
   /// \param val is \b true if warnings are generated individually.  The default is \b false.
@@ -826,6 +826,8 @@ void OperandValue::decode(Decoder &decoder,Translate *trans)
   uintm ctid = decoder.readUnsignedInteger(sla::ATTRIB_CT);
   SleighBase *sleigh = (SleighBase *)trans;
   SubtableSymbol *tab = dynamic_cast<SubtableSymbol *>(sleigh->findSymbol(tabid));
+  if (tab->isDeferred())
+    tab->loadDeferred();	// Need the Constructor object now, not at first resolution
   ct = tab->getConstructor(ctid);
   decoder.closeElement(el);
 }
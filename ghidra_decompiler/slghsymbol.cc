@@ -187,6 +187,18 @@ void SymbolTable::decode(Decoder &decoder,SleighBase *trans)
     decodeSymbolHeader(decoder);
 				// Now decode the symbol content
   while(decoder.peekElement() != 0) {
+    uint1 *defer = decoder.getReadPosition();
+    if (defer != (uint1 *)0 && decoder.peekElement() == sla::ELEM_SUBTABLE_SYM) {
+      // The input outlives the decoder (it is the memory-mapped .sla cache), so
+      // subtable bodies, the bulk of the specification, are recorded here and
+      // decoded lazily on their first resolution hit
+      uint4 subel = decoder.openElement();
+      uintm id = decoder.readUnsignedInteger(sla::ATTRIB_ID);
+      decoder.closeElementSkipping(subel);
+      SubtableSymbol *subsym = (SubtableSymbol *)findSymbol(id);
+      subsym->deferDecode(defer,(int4)(decoder.getReadPosition()-defer),trans);
+      continue;
+    }
     decoder.openElement();
     uintm id = decoder.readUnsignedInteger(sla::ATTRIB_ID);
     SleighSymbol *sym;
@@ -1341,6 +1353,8 @@ Constructor::Constructor(void)
   firstwhitespace = -1;
   flowthruindex = -1;
   inerror = false;
+  fixedmask = 0;
+  fixedexport = false;
 }
 
 Constructor::Constructor(SubtableSymbol *p)
@@ -1352,6 +1366,8 @@ Constructor::Constructor(SubtableSymbol *p)
   templ = (ConstructTpl *)0;
   firstwhitespace = -1;
   inerror = false;
+  fixedmask = 0;
+  fixedexport = false;
 }
 
 Constructor::~Constructor(void)
@@ -1512,6 +1528,50 @@ void Constructor::removeTrailingSpace(void)
   //    printpiece.pop_back();
 }
 
+void Constructor::cacheFixedHandles(AddrSpace *constspace)
+
+{ // Precompute the FixedHandle for any operand or export that resolves the
+  // same way for every decode.  An operand backed directly by a register or
+  // epsilon symbol, or by a constant expression, never reads the parse tree,
+  // nor does an export template built purely from literal pieces.  The
+  // resolveHandles() hot loop copies these stored handles instead of
+  // recomputing them per instruction.
+  ParserWalker nullwalker((const ParserContext *)0);	// Never dereferenced on these paths
+  fixedmask = 0;
+  fixedexport = false;
+  fixedhand.clear();
+  fixedhand.resize(operands.size());
+  for(int4 i=0;(i<operands.size())&&(i<32);++i) {
+    OperandSymbol *sym = operands[i];
+    TripleSymbol *triple = sym->getDefiningSymbol();
+    if (triple != (TripleSymbol *)0) {
+      SleighSymbol::symbol_type tp = triple->getType();
+      if ((tp == SleighSymbol::varnode_symbol)||(tp == SleighSymbol::epsilon_symbol)) {
+	triple->getFixedHandle(fixedhand[i],nullwalker);
+	fixedmask |= ((uint4)1 << i);
+      }
+    }
+    else {
+      PatternExpression *patexp = sym->getDefiningExpression();
+      if (dynamic_cast<ConstantValue *>(patexp) != (ConstantValue *)0) {
+	FixedHandle &hand(fixedhand[i]);
+	hand.space = constspace;
+	hand.offset_space = (AddrSpace *)0;
+	hand.offset_offset = (uintb)patexp->getValue(nullwalker);
+	hand.size = 0;
+	fixedmask |= ((uint4)1 << i);
+      }
+    }
+  }
+  if (templ != (ConstructTpl *)0) {
+    HandleTpl *res = templ->getResult();
+    if ((res != (HandleTpl *)0)&&res->isFixed()) {
+      res->fix(exporthand,nullwalker);
+      fixedexport = true;
+    }
+  }
+}
+
 void Constructor::markSubtableOperands(vector<int4> &check) const
 
 { // Adjust -check- so it has one entry for every operand, a 0 if it is a subtable, a 2 if it is not
@@ -1641,7 +1701,8 @@ void Constructor::decode(Decoder &decoder,SleighBase *trans)
     }
     else {
       ConstructTpl *cur = new ConstructTpl();
-      int4 sectionid = cur->decode(decoder);
+      TplArena *arena = (parent != (SubtableSymbol *)0) ? parent->getTplArena() : (TplArena *)0;
+      int4 sectionid = cur->decode(decoder,arena);
       if (sectionid < 0) {
 	if (templ != (ConstructTpl *)0)
 	  throw LowlevelError("Duplicate main section");
@@ -1843,6 +1904,58 @@ SubtableSymbol::SubtableSymbol(const string &nm) : TripleSymbol(nm)
   pattern = (TokenPattern *)0;
   decisiontree = (DecisionNode *)0;
   errors = 0;
+  deferbuf = (uint1 *)0;
+  defersize = 0;
+  defertrans = (SleighBase *)0;
+  deferred = false;
+  loadthread = std::thread::id();
+}
+
+/// Instead of decoding the subtable body up front, record its raw extent in the
+/// input stream so the decode happens lazily on the first resolution hit.  The
+/// bytes must outlive \b this symbol; they are backed by the memory-mapped .sla
+/// cache held alive by the shared SleighTables.
+/// \param ptr is the start of the subtable element in the input stream
+/// \param sz is the number of bytes in the element
+/// \param trans is the SLEIGH translation object the eventual decode runs against
+void SubtableSymbol::deferDecode(uint1 *ptr,int4 sz,SleighBase *trans)
+
+{
+  deferbuf = ptr;
+  defersize = sz;
+  defertrans = trans;
+  deferred.store(true,std::memory_order_release);
+}
+
+/// Decode the subtable body recorded by deferDecode(), including the fixed
+/// handle precomputation that normally runs as part of the initial .sla decode.
+/// Multiple threads can hit an unloaded subtable simultaneously; the first one
+/// in performs the decode and the rest wait on the lock.  The decode itself can
+/// reference \b this table again, through an OperandValue expression naming one
+/// of its own (already constructed) Constructors; such re-entrant calls return
+/// immediately rather than deadlocking on the mutex.
+void SubtableSymbol::loadDeferred(void)
+
+{
+  if (loadthread.load(std::memory_order_relaxed) == std::this_thread::get_id())
+    return;			// Re-entrant reference while decoding our own body
+  std::lock_guard<std::mutex> lock(defermutex);
+  if (!deferred.load(std::memory_order_relaxed)) return;	// Another thread completed the load
+  loadthread.store(std::this_thread::get_id(),std::memory_order_relaxed);
+  PackedDecode decoder(defertrans);
+  // One byte of slack past the element's own END marker: consuming the final
+  // byte of a stream throws, so the decoder needs lookahead the way endIngest()
+  // normally pads it.  The byte exists because the enclosing \<symbol_table>
+  // always continues past a subtable element.
+  decoder.ingestBytes(deferbuf,defersize + 1);
+  decoder.openElement();	// \<subtable_sym> recorded with its element header
+  decode(decoder,defertrans);
+  AddrSpace *constspace = defertrans->getConstantSpace();
+  for(int4 i=0;i<construct.size();++i)
+    construct[i]->cacheFixedHandles(constspace);
+  deferbuf = (uint1 *)0;
+  loadthread.store(std::thread::id(),std::memory_order_relaxed);
+  deferred.store(false,std::memory_order_release);
 }
 
 SubtableSymbol::~SubtableSymbol(void)
@@ -1906,9 +2019,97 @@ void SubtableSymbol::decode(Decoder &decoder,SleighBase *trans)
   pattern = (TokenPattern *)0;
   beingbuilt = false;
   errors = 0;
+  flattenDecisionTree();
   decoder.closeElement(sla::ELEM_SUBTABLE_SYM.getId());
 }
 
+/// The decision tree is copied breadth-first into one contiguous array, with
+/// each node's children occupying a consecutive block located by index, and
+/// all the (pattern,constructor) pairs gathered into a second array grouped
+/// by node.  resolve() then walks the flat form without touching the
+/// individually allocated tree nodes.  The original tree is retained: it owns
+/// the patterns and the encode() representation.
+void SubtableSymbol::flattenDecisionTree(void)
+
+{
+  flatnodes.clear();
+  flatpairs.clear();
+  if (decisiontree == (DecisionNode *)0) return;
+  vector<const DecisionNode *> worklist;	// Breadth-first order; index matches flatnodes
+  worklist.push_back(decisiontree);
+  flatnodes.emplace_back();
+  for(size_t i=0;i<worklist.size();++i) {
+    const DecisionNode *node = worklist[i];
+    FlatDecisionNode flat;
+    flat.startbit = node->startbit;
+    flat.bitsize = node->bitsize;
+    flat.contextdecision = node->contextdecision;
+    flat.firstpair = (int4)flatpairs.size();
+    flat.numpairs = (int4)node->list.size();
+    for(size_t j=0;j<node->list.size();++j) {
+      FlatPair fp;
+      fp.pat = node->list[j].first;
+      fp.ct = node->list[j].second;
+      fp.instmask0 = fp.pat->getMask(0,8*sizeof(uintm),false);
+      fp.instval0 = fp.pat->getValue(0,8*sizeof(uintm),false);
+      flatpairs.push_back(fp);
+    }
+    flat.firstchild = node->children.empty() ? -1 : (int4)worklist.size();
+    for(size_t j=0;j<node->children.size();++j) {
+      worklist.push_back(node->children[j]);
+      flatnodes.emplace_back();		// Reserve the contiguous child block
+    }
+    flatnodes[i] = flat;
+  }
+}
+
+/// The flattened form of the decision tree is walked when available, so the
+/// hot resolution loop stays within two contiguous arrays; trees that have
+/// not been flattened (during language compilation) fall back to the
+/// pointer-linked walk.
+/// \param walker is the parser state to resolve against
+/// \return the matching Constructor
+Constructor *SubtableSymbol::resolve(ParserWalker &walker)
+
+{
+  if (deferred.load(std::memory_order_acquire))
+    loadDeferred();
+  if (flatnodes.empty())
+    return decisiontree->resolve(walker);
+  int4 cur = 0;
+  for(;;) {
+    const FlatDecisionNode &node = flatnodes[cur];
+    if (node.bitsize == 0) {		// The node is terminal
+      int4 end = node.firstpair + node.numpairs;
+      uintm window = 0;
+      bool haswindow = false;
+      for(int4 i=node.firstpair;i<end;++i) {
+	const FlatPair &fp = flatpairs[i];
+	if (fp.instmask0 != 0) {	// Cheap first-word rejection before the full match
+	  if (!haswindow) {		// Load the instruction window once per node
+	    window = walker.getInstructionBits(0,8*sizeof(uintm));
+	    haswindow = true;
+	  }
+	  if ((window & fp.instmask0) != fp.instval0) continue;
+	}
+	if (fp.pat->isMatch(walker))
+	  return fp.ct;
+      }
+      ostringstream s;
+      s << walker.getAddr().getShortcut();
+      walker.getAddr().printRaw(s);
+      s << ": Unable to resolve constructor";
+      throw BadDataError(s.str());
+    }
+    uintm val;
+    if (node.contextdecision)
+      val = walker.getContextBits(node.startbit,node.bitsize);
+    else
+      val = walker.getInstructionBits(node.startbit,node.bitsize);
+    cur = node.firstchild + (int4)val;
+  }
+}
+
 void SubtableSymbol::buildDecisionTree(DecisionProperties &props)
 
 {				// Associate pattern disjoints to constructors
@@ -1924,6 +2125,7 @@ void SubtableSymbol::buildDecisionTree(DecisionProperties &props)
 	decisiontree->addConstructorPair(pat->getDisjoint(j),construct[i]);
   }
   decisiontree->split(props);	// Create the decision strategy
+  flattenDecisionTree();
 }
 
 TokenPattern *SubtableSymbol::buildPattern(ostream &s)
@@ -1985,6 +2187,15 @@ void DecisionProperties::conflictingPattern(Constructor *a,Constructor *b)
   }
 }
 
+void DecisionProperties::absorb(DecisionProperties &op2)
+
+{ // Fold error pairs accumulated in -op2- into -this-, preserving their order
+  identerrors.insert(identerrors.end(),op2.identerrors.begin(),op2.identerrors.end());
+  conflicterrors.insert(conflicterrors.end(),op2.conflicterrors.begin(),op2.conflicterrors.end());
+  op2.identerrors.clear();
+  op2.conflicterrors.clear();
+}
+
 DecisionNode::DecisionNode(DecisionNode *p)
 
 {
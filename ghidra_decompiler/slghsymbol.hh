@@ -18,6 +18,9 @@
 
 #include "semantics.hh"
 #include "slghpatexpress.hh"
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 namespace ghidra {
 
@@ -489,6 +492,10 @@ class Constructor {		// This is NOT a symbol
   int4 lineno;
   int4 src_index;           //source file index
   mutable bool inerror;                 // An error is associated with this Constructor
+  uint4 fixedmask;		// Bit set for each operand whose handle is the same for every decode
+  bool fixedexport;		// True if the export handle is the same for every decode
+  vector<FixedHandle> fixedhand; // Precomputed operand handles, indexed by operand slot
+  FixedHandle exporthand;	// Precomputed export handle
   void orderOperands(void);
 public:
   Constructor(void);		// For use with decode
@@ -528,6 +535,11 @@ public:
     for(iter=context.begin();iter!=context.end();++iter)
       (*iter)->apply(walker);
   }
+  void cacheFixedHandles(AddrSpace *constspace); // Precompute decode-invariant handles
+  bool isFixedHandle(int4 i) const { return ((i<32)&&(((fixedmask>>i)&1)!=0)); }
+  const FixedHandle &getFixedHandle(int4 i) const { return fixedhand[i]; }
+  bool isFixedExport(void) const { return fixedexport; }
+  const FixedHandle &getFixedExport(void) const { return exporthand; }
   void markSubtableOperands(vector<int4> &check) const;
   void collectLocalExports(vector<uintb> &results) const;
   void setError(bool val) const { inerror = val; }
@@ -543,11 +555,13 @@ class DecisionProperties {
 public:
   void identicalPattern(Constructor *a,Constructor *b);
   void conflictingPattern(Constructor *a,Constructor *b);
+  void absorb(DecisionProperties &op2);
   const vector<pair<Constructor *, Constructor *> > &getIdentErrors(void) const { return identerrors; }
   const vector<pair<Constructor *, Constructor *> > &getConflictErrors(void) const { return conflicterrors; }
 };
 
 class DecisionNode {
+  friend class SubtableSymbol;	// Allows the flattened form to be built from the tree
   vector<pair<DisjointPattern *,Constructor *> > list;
   vector<DecisionNode *> children;
   int4 num;			// Total number of patterns we distinguish
@@ -571,24 +585,67 @@ public:
   void decode(Decoder &decoder,DecisionNode *par,SubtableSymbol *sub);
 };
 
+/// \brief A node of a decision tree in its flattened form
+///
+/// The nodes of a SubtableSymbol's decision tree, linked by index rather than
+/// pointer, so constructor resolution walks one contiguous array instead of
+/// chasing individually heap-allocated tree nodes (see flattenDecisionTree)
+struct FlatDecisionNode {
+  int4 startbit,bitsize;	///< Bits in the stream on which to base the decision
+  bool contextdecision;		///< True if this is decision based on context
+  int4 firstchild;		///< Index of the first child node; all 2^bitsize children are contiguous
+  int4 firstpair;		///< Index of this node's first (pattern,constructor) pair
+  int4 numpairs;		///< Number of pairs attached to this node
+};
+
+/// \brief A (pattern,constructor) pair of the flattened decision tree
+///
+/// The first mask/value word of the instruction pattern is precomputed so a
+/// terminal node can reject most candidates with one AND/compare against a
+/// once-loaded instruction window, before invoking the full pattern match
+struct FlatPair {
+  DisjointPattern *pat;		///< The pattern to match
+  Constructor *ct;		///< The corresponding Constructor
+  uintm instmask0;		///< Instruction mask of the pattern's first word (0 = no constraint)
+  uintm instval0;		///< Value the masked first word must have
+};
+
 class SubtableSymbol : public TripleSymbol {
   TokenPattern *pattern;
   bool beingbuilt,errors;
   vector<Constructor *> construct; // All the Constructors in this table
   DecisionNode *decisiontree;
-public:
-  SubtableSymbol(void) { pattern = (TokenPattern *)0; decisiontree = (DecisionNode *)0; } // For use with decode
+  vector<FlatDecisionNode> flatnodes;	// Decision tree flattened into a contiguous array (breadth-first)
+  vector<FlatPair> flatpairs;		// All pattern pairs, grouped by node
+  TplArena tplarena;		// Contiguous backing store for the constructors' template nodes
+  uint1 *deferbuf;		// Raw .sla bytes of the subtable body, if decode was deferred
+  int4 defersize;		// Number of raw bytes in the deferred body
+  SleighBase *defertrans;	// Translator the deferred decode runs against
+  std::mutex defermutex;	// Serializes the one-time deferred decode
+  std::atomic<bool> deferred;	// True while the body remains undecoded
+  std::atomic<std::thread::id> loadthread;	// Thread currently running the deferred decode
+  void flattenDecisionTree(void);	// Build the flattened form of the decision tree
+public:
+  SubtableSymbol(void) {
+    pattern = (TokenPattern *)0; decisiontree = (DecisionNode *)0;
+    deferbuf = (uint1 *)0; defersize = 0; defertrans = (SleighBase *)0; deferred = false;
+    loadthread = std::thread::id();
+  } // For use with decode
   SubtableSymbol(const string &nm);
   virtual ~SubtableSymbol(void);
+  void deferDecode(uint1 *ptr,int4 sz,SleighBase *trans);	// Record the undecoded subtable body
+  void loadDeferred(void);	// Decode the deferred subtable body
+  bool isDeferred(void) const { return deferred.load(std::memory_order_acquire); }	// Is the body still undecoded
   bool isBeingBuilt(void) const { return beingbuilt; }
   bool isError(void) const { return errors; }
   void addConstructor(Constructor *ct) { ct->setId(construct.size()); construct.push_back(ct); }
   void buildDecisionTree(DecisionProperties &props);
   TokenPattern *buildPattern(ostream &s);
   TokenPattern *getPattern(void) const { return pattern; }
+  TplArena *getTplArena(void) { return &tplarena; }	// Get the arena backing this subtable's decoded templates
   int4 getNumConstructors(void) const { return construct.size(); }
   Constructor *getConstructor(uintm id) const { return construct[id]; }
-  virtual Constructor *resolve(ParserWalker &walker) { return decisiontree->resolve(walker); }
+  virtual Constructor *resolve(ParserWalker &walker);
   virtual PatternExpression *getPatternExpression(void) const { throw SleighError("Cannot use subtable in expression"); }
   virtual void getFixedHandle(FixedHandle &hand,ParserWalker &walker) const {
     throw SleighError("Cannot use subtable in expression"); }
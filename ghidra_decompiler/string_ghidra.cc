@@ -33,15 +33,15 @@ GhidraStringManager::~GhidraStringManager(void)
 const vector<uint1> &GhidraStringManager::getStringData(const Address &addr,Datatype *charType,bool &isTrunc)
 
 {
-  map<Address,StringData>::iterator iter;
-  iter = stringMap.find(addr);
-  if (iter != stringMap.end()) {
-    isTrunc = (*iter).second.isTruncated;
-    return (*iter).second.byteData;
+  int4 charsize = charType->getSize();
+  std::lock_guard<std::mutex> lock(stringLock);
+  StringData *cached = findStringData(addr,charsize);
+  if (cached != (StringData *)0) {
+    isTrunc = cached->isTruncated;
+    return cached->byteData;
   }
 
-  StringData &stringData(stringMap[addr]);
-  stringData.isTruncated = false;
+  StringData &stringData( insertStringData(addr,charsize) );
   glb->getStringData(stringData.byteData, addr, charType, maximumChars,stringData.isTruncated);
   isTrunc = stringData.isTruncated;
   return stringData.byteData;
@@ -17,6 +17,12 @@
 #include "architecture.hh"
 #include "crc32.hh"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace ghidra {
 
 AttributeId ATTRIB_TRUNC = AttributeId("trunc",69);
@@ -95,20 +101,20 @@ void StringManager::assignStringData(StringData &data,const uint1 *buf,int4 size
 uint8 StringManager::calcInternalHash(const Address &addr,const uint1 *buf,int4 size)
 
 {
-  uint4 reg = 0x7b7c66a9;
-  for(int4 i=0;i<size;++i) {
-    reg = crc_update(reg, buf[i]);
-  }
+  uint4 reg = crc_update_bytes(0x7b7c66a9,buf,size);
   uint8 res = addr.getOffset();
   res ^= ((uint8)reg) << 32;
   return res;
 }
 
+/// The number of strings held in the cache at one time is bounded; once the bound is
+/// reached the least recently used string is dropped to make room for a new decoding.
 /// \param max is the maximum number of characters to allow before truncating string
 StringManager::StringManager(int4 max)
 
 {
   maximumChars = max;
+  maximumEntries = 4096;
 }
 
 StringManager::~StringManager(void)
@@ -117,6 +123,60 @@ StringManager::~StringManager(void)
   clear();
 }
 
+void StringManager::clear(void)
+
+{
+  std::lock_guard<std::mutex> lock(stringLock);
+  stringMap.clear();
+  lruOrder.clear();
+}
+
+/// The caller must hold the cache lock.  If data is found, its entry is moved to the
+/// front of the recency list so that it is evicted last.
+/// \param addr is the start address of the string
+/// \param charsize is the size in bytes of a character element
+/// \return the cached data or null
+StringManager::StringData *StringManager::findStringData(const Address &addr,int4 charsize)
+
+{
+  map<pair<Address,int4>,StringData>::iterator iter;
+  iter = stringMap.find(make_pair(addr,charsize));
+  if (iter == stringMap.end())
+    return (StringData *)0;
+  StringData &data( (*iter).second );
+  lruOrder.splice(lruOrder.begin(),lruOrder,data.lruSlot);
+  return &data;
+}
+
+/// The caller must hold the cache lock.  If the cache has reached its bound, the least
+/// recently used string is evicted to make room.  The returned entry is empty and sits
+/// at the front of the recency list.
+/// \param addr is the start address of the string
+/// \param charsize is the size in bytes of a character element
+/// \return the allocated string data
+StringManager::StringData &StringManager::insertStringData(const Address &addr,int4 charsize)
+
+{
+  pair<Address,int4> key(addr,charsize);
+  map<pair<Address,int4>,StringData>::iterator iter = stringMap.find(key);
+  if (iter != stringMap.end()) {		// Re-registering an existing string
+    StringData &data( (*iter).second );
+    lruOrder.splice(lruOrder.begin(),lruOrder,data.lruSlot);
+    data.isTruncated = false;
+    data.byteData.clear();
+    return data;
+  }
+  if ((int4)stringMap.size() >= maximumEntries) {
+    stringMap.erase(lruOrder.back());
+    lruOrder.pop_back();
+  }
+  StringData &data( stringMap[key] );
+  lruOrder.push_front(key);
+  data.lruSlot = lruOrder.begin();
+  data.isTruncated = false;
+  return data;
+}
+
 /// Encode the given unicode codepoint as UTF8 (1, 2, 3, or 4 bytes) and
 /// write the bytes to the stream.
 /// \param s is the output stream
@@ -191,9 +251,8 @@ uint8 StringManager::registerInternalStringData(const Address &addr,const uint1
     return 0;	// Not a legal encoding
   uint8 hash = calcInternalHash(addr, buf, size);
   Address constAddr = addr.getSpace()->getManager()->getConstant(hash);
-  StringData &stringData( stringMap[constAddr] );
-  stringData.byteData.clear();
-  stringData.isTruncated = false;
+  std::lock_guard<std::mutex> lock(stringLock);
+  StringData &stringData( insertStringData(constAddr,charsize) );
   assignStringData(stringData, buf, size, charsize, numChars, addr.isBigEndian());
   return hash;
 }
@@ -203,12 +262,13 @@ uint8 StringManager::registerInternalStringData(const Address &addr,const uint1
 void StringManager::encode(Encoder &encoder) const
 
 {
+  std::lock_guard<std::mutex> lock(stringLock);
   encoder.openElement(ELEM_STRINGMANAGE);
 
-  map<Address,StringData>::const_iterator iter1;
+  map<pair<Address,int4>,StringData>::const_iterator iter1;
   for(iter1=stringMap.begin();iter1!=stringMap.end();++iter1) {
     encoder.openElement(ELEM_STRING);
-    (*iter1).first.encode(encoder);
+    (*iter1).first.first.encode(encoder,(*iter1).first.second);
     const StringData &stringData( (*iter1).second );
     encoder.openElement(ELEM_BYTES);
     encoder.writeBool(ATTRIB_TRUNC, stringData.isTruncated);
@@ -231,12 +291,16 @@ void StringManager::encode(Encoder &encoder) const
 void StringManager::decode(Decoder &decoder)
 
 {
+  std::lock_guard<std::mutex> lock(stringLock);
   uint4 elemId = decoder.openElement(ELEM_STRINGMANAGE);
   for (;;) {
     uint4 subId = decoder.openElement();
     if (subId != ELEM_STRING) break;
-    Address addr = Address::decode(decoder);
-    StringData &stringData(stringMap[addr]);
+    int4 charsize;
+    Address addr = Address::decode(decoder,charsize);
+    if (charsize == 0)
+      charsize = 1;		// Older format with no character size recorded
+    StringData &stringData( insertStringData(addr,charsize) );
     uint4 subId2 = decoder.openElement(ELEM_BYTES);
     stringData.isTruncated = decoder.readBool(ATTRIB_TRUNC);
     istringstream is(decoder.readString(ATTRIB_CONTENT));
@@ -270,6 +334,45 @@ void StringManager::decode(Decoder &decoder)
   decoder.closeElement(elemId);
 }
 
+/// \brief Count the leading run of plain ASCII elements in a buffer
+///
+/// Scan forward from the start of the buffer while bytes are in the range 0x01
+/// through 0x7f: single byte UTF8 elements that are neither a null terminator
+/// nor part of a multi-byte encoding.  The bulk of the scan classifies 16 bytes
+/// at a time when vector instructions are available.
+/// \param buf is the byte buffer to scan
+/// \param size is the number of bytes in the buffer
+/// \return the number of leading plain ASCII bytes
+static int4 scanAsciiRun(const uint1 *buf,int4 size)
+
+{
+  int4 i = 0;
+#if defined(__SSE2__)
+  while(i + 16 <= size) {
+    __m128i chunk = _mm_loadu_si128((const __m128i *)(buf + i));
+    __m128i zero = _mm_cmpeq_epi8(chunk,_mm_setzero_si128());
+    // The sign bit collects bytes >= 0x80, the compare collects zero bytes
+    if (_mm_movemask_epi8(_mm_or_si128(chunk,zero)) != 0)
+      break;			// Chunk holds a terminator or multi-byte element
+    i += 16;
+  }
+#elif defined(__aarch64__)
+  while(i + 16 <= size) {
+    uint8x16_t chunk = vld1q_u8(buf + i);
+    uint8x16_t stop = vorrq_u8(vceqq_u8(chunk,vdupq_n_u8(0)),
+			       vcgeq_u8(chunk,vdupq_n_u8(0x80)));
+    if (vmaxvq_u8(stop) != 0)
+      break;			// Chunk holds a terminator or multi-byte element
+    i += 16;
+  }
+#endif
+  while(i < size && buf[i] != 0 && buf[i] < 0x80)
+    i += 1;
+  return i;
+}
+
+/// The buffer is scanned for a character element with all bytes zero.  The bulk
+/// of the scan tests 16 bytes at a time when vector instructions are available.
 /// \param buffer is the byte buffer
 /// \param size is the number of bytes in the buffer
 /// \param charsize is the presumed size (in bytes) of character elements
@@ -277,7 +380,42 @@ void StringManager::decode(Decoder &decoder)
 bool StringManager::hasCharTerminator(const uint1 *buffer,int4 size,int4 charsize)
 
 {
-  for(int4 i=0;i<size;i+=charsize) {
+  int4 i = 0;
+#if defined(__SSE2__)
+  if (charsize == 1 || charsize == 2 || charsize == 4) {
+    __m128i zero = _mm_setzero_si128();
+    while(i + 16 <= size) {	// 16 is a multiple of every element size
+      __m128i chunk = _mm_loadu_si128((const __m128i *)(buffer + i));
+      __m128i eq;
+      if (charsize == 1)
+	eq = _mm_cmpeq_epi8(chunk,zero);
+      else if (charsize == 2)
+	eq = _mm_cmpeq_epi16(chunk,zero);
+      else
+	eq = _mm_cmpeq_epi32(chunk,zero);
+      if (_mm_movemask_epi8(eq) != 0)
+	return true;
+      i += 16;
+    }
+  }
+#elif defined(__aarch64__)
+  if (charsize == 1 || charsize == 2 || charsize == 4) {
+    while(i + 16 <= size) {	// 16 is a multiple of every element size
+      uint8x16_t chunk = vld1q_u8(buffer + i);
+      uint8x16_t eq;
+      if (charsize == 1)
+	eq = vceqq_u8(chunk,vdupq_n_u8(0));
+      else if (charsize == 2)
+	eq = vreinterpretq_u8_u16(vceqq_u16(vreinterpretq_u16_u8(chunk),vdupq_n_u16(0)));
+      else
+	eq = vreinterpretq_u8_u32(vceqq_u32(vreinterpretq_u32_u8(chunk),vdupq_n_u32(0)));
+      if (vmaxvq_u8(eq) != 0)
+	return true;
+      i += 16;
+    }
+  }
+#endif
+  for(;i<size;i+=charsize) {
     bool isTerminator = true;
     for(int4 j=0;j<charsize;++j) {
       if (buffer[i+j] != 0) {	// Non-zero bytes means character can't be a null terminator
@@ -329,6 +467,12 @@ int4 StringManager::checkCharacters(const uint1 *buf,int4 size,int4 charsize,boo
   int4 count=0;
   int4 skip = charsize;
   while(i<size) {
+    if (charsize == 1) {	// Bulk-skip runs of plain ASCII elements
+      int4 run = scanAsciiRun(buf+i,size-i);
+      count += run;
+      i += run;
+      if (i >= size) break;
+    }
     int4 codepoint = getCodepoint(buf+i,charsize,bigend,skip);
     if (codepoint < 0) return -1;
     if (codepoint == 0) break;
@@ -427,22 +571,21 @@ StringManagerUnicode::~StringManagerUnicode(void)
 const vector<uint1> &StringManagerUnicode::getStringData(const Address &addr,Datatype *charType,bool &isTrunc)
 
 {
-  map<Address,StringData>::iterator iter;
-  iter = stringMap.find(addr);
-  if (iter != stringMap.end()) {
-    isTrunc = (*iter).second.isTruncated;
-    return (*iter).second.byteData;
+  int4 charsize = charType->getSize();
+  std::lock_guard<std::mutex> lock(stringLock);	// Also serializes use of testBuffer
+  StringData *cached = findStringData(addr,charsize);
+  if (cached != (StringData *)0) {
+    isTrunc = cached->isTruncated;
+    return cached->byteData;
   }
 
-  StringData &stringData(stringMap[addr]);		// Allocate (initially empty) byte vector
-  stringData.isTruncated = false;
+  StringData &stringData( insertStringData(addr,charsize) );	// Allocate (initially empty) byte vector
   isTrunc = false;
 
   if (charType->isOpaqueString())		// Cannot currently test for an opaque encoding
     return stringData.byteData;			// Return the empty buffer
 
   int4 curBufferSize = 0;
-  int4 charsize = charType->getSize();
   bool foundTerminator = false;
 
   try {
@@ -21,6 +21,8 @@
 
 #include "type.hh"
 
+#include <mutex>
+
 namespace ghidra {
 
 class Architecture;
@@ -44,9 +46,15 @@ protected:
   public:
     bool isTruncated;		///< \b true if the string is truncated
     vector<uint1> byteData;	///< UTF8 encoded string data
+    list<pair<Address,int4> >::iterator lruSlot;	///< Position of \b this in the recency list
   };
-  map<Address,StringData> stringMap;	///< Map from address to string data
+  map<pair<Address,int4>,StringData> stringMap;	///< Map from (address,character size) to string data
+  list<pair<Address,int4> > lruOrder;	///< Keys of cached strings, most recently used first
   int4 maximumChars;			///< Maximum characters in a string before truncating
+  int4 maximumEntries;			///< Maximum number of cached strings before eviction
+  mutable std::mutex stringLock;	///< Guards the cache across decompiling threads
+  StringData *findStringData(const Address &addr,int4 charsize);	///< Find cached string data, marking it most recently used
+  StringData &insertStringData(const Address &addr,int4 charsize);	///< Allocate a cache slot, evicting if the cache is full
   bool writeUnicode(ostream &s,const uint1 *buffer,int4 size,int4 charsize,bool bigend);	///< Translate/copy unicode to UTF8
   void assignStringData(StringData &data,const uint1 *buf,int4 size,int4 charsize,int4 numChars,bool bigend);
   static uint8 calcInternalHash(const Address &addr,const uint1 *buf,int4 size);
@@ -54,14 +62,16 @@ public:
   StringManager(int4 max);		///< Constructor
   virtual ~StringManager(void);		///< Destructor
 
-  void clear(void) { stringMap.clear(); }			///< Clear out any cached strings
+  void clear(void);					///< Clear out any cached strings
 
   bool isString(const Address &addr,Datatype *charType);	// Determine if data at the given address is a string
 
   /// \brief Retrieve string data at the given address as a UTF8 byte array
   ///
   /// If the address does not represent string data, a zero length vector is returned. Otherwise,
-  /// the string data is fetched, converted to a UTF8 encoding, cached and returned.
+  /// the string data is fetched, converted to a UTF8 encoding, cached and returned.  The returned
+  /// reference stays valid until at least \b maximumEntries other strings have been decoded, after
+  /// which the underlying cache entry may be evicted.
   /// \param addr is the given address
   /// \param charType is a character data-type indicating the encoding
   /// \param isTrunc passes back whether the string is truncated
@@ -1563,8 +1563,12 @@ int4 RuleSubvarAnd::applyOp(PcodeOp *op,Funcdata &data)
   //  if ((vn->getConsume() & 0xff)==0xff) return 0;
   //  if (op->getIn(1)->getOffset() != (uintb)1) return 0;
   if (op->getOut()->hasNoDescend()) return 0;
+  if (data.isSubflowFailed(vn,cmask,0)) return 0;
   SubvariableFlow subflow(&data,vn,cmask,false,false,false);
-  if (!subflow.doTrace()) return 0;
+  if (!subflow.doTrace()) {
+    data.recordSubflowFail(vn,cmask,0);
+    return 0;
+  }
   subflow.doReplacement();
   return 1;
 }
@@ -1597,8 +1601,13 @@ int4 RuleSubvarSubpiece::applyOp(PcodeOp *op,Funcdata &data)
     if (vn->loneDescend() == op)
       big = true;
   }
+  uint4 mode = (aggressive ? 1 : 0) | (big ? 4 : 0);
+  if (data.isSubflowFailed(vn,mask,mode)) return 0;
   SubvariableFlow subflow(&data,vn,mask,aggressive,false,big);
-  if (!subflow.doTrace()) return 0;
+  if (!subflow.doTrace()) {
+    data.recordSubflowFail(vn,mask,mode);
+    return 0;
+  }
   subflow.doReplacement();
   return 1;
 }
@@ -1654,8 +1663,10 @@ int4 RuleSubvarCompZero::applyOp(PcodeOp *op,Funcdata &data)
     }
   }
 
+  if (data.isSubflowFailed(vn,mask,0)) return 0;
   SubvariableFlow subflow(&data,vn,mask,false,false,false);
   if (!subflow.doTrace()) {
+    data.recordSubflowFail(vn,mask,0);
     return 0;
   }
   subflow.doReplacement();
@@ -1680,8 +1691,12 @@ int4 RuleSubvarShift::applyOp(PcodeOp *op,Funcdata &data)
   mask = (mask >> sa) << sa;
   if (op->getOut()->hasNoDescend()) return 0;
 
+  if (data.isSubflowFailed(vn,mask,0)) return 0;
   SubvariableFlow subflow(&data,vn,mask,false,false,false);
-  if (!subflow.doTrace()) return 0;
+  if (!subflow.doTrace()) {
+    data.recordSubflowFail(vn,mask,0);
+    return 0;
+  }
   subflow.doReplacement();
   return 1;
 }
@@ -1699,8 +1714,13 @@ int4 RuleSubvarZext::applyOp(PcodeOp *op,Funcdata &data)
   Varnode *invn = op->getIn(0);
   uintb mask = calc_mask(invn->getSize());
 
+  uint4 mode = invn->isPtrFlow() ? 1 : 0;
+  if (data.isSubflowFailed(vn,mask,mode)) return 0;
   SubvariableFlow subflow(&data,vn,mask,invn->isPtrFlow(),false,false);
-  if (!subflow.doTrace()) return 0;
+  if (!subflow.doTrace()) {
+    data.recordSubflowFail(vn,mask,mode);
+    return 0;
+  }
   subflow.doReplacement();
   return 1;
 }
@@ -1718,8 +1738,13 @@ int4 RuleSubvarSext::applyOp(PcodeOp *op,Funcdata &data)
   Varnode *invn = op->getIn(0);
   uintb mask = calc_mask(invn->getSize());
 
+  uint4 mode = (isaggressive ? 1 : 0) | 2;
+  if (data.isSubflowFailed(vn,mask,mode)) return 0;
   SubvariableFlow subflow(&data,vn,mask,isaggressive,true,false);
-  if (!subflow.doTrace()) return 0;
+  if (!subflow.doTrace()) {
+    data.recordSubflowFail(vn,mask,mode);
+    return 0;
+  }
   subflow.doReplacement();
   return 1;
 }
@@ -16,6 +16,11 @@
 #include "test.hh"
 #include "libdecomp.hh"
 
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 namespace ghidra {
 
 /// Run all the tests unless a non-empty set of names is passed in.
@@ -49,6 +54,86 @@ int UnitTest::run(set<string> &testNames)
   return total - passed;
 }
 
+/// Run the tests as with run(), but fork a fresh process for each test and
+/// keep up to \b numJobs of them going at once.  The child's address space
+/// isolates whatever Architecture or other global state a test mutates, so
+/// tests cannot contaminate each other no matter how they are interleaved,
+/// and a crash takes down only the one test.
+/// \param testNames is the (possibly empty) set of specific tests to run
+/// \param numJobs is the number of tests to keep in flight
+/// \return number of failed tests
+int UnitTest::runParallel(set<string> &testNames,int numJobs)
+
+{
+#ifdef _WIN32
+  return run(testNames);	// No fork(); fall back to the sequential runner
+#else
+  vector<UnitTest *> selected;
+  for(auto &t : UnitTest::tests()) {
+    if (testNames.size() > 0 && testNames.find(t->name) == testNames.end())
+      continue;
+    selected.push_back(t);
+  }
+  if (numJobs < 1)
+    numJobs = 1;
+  std::map<pid_t,UnitTest *> running;
+  int total = selected.size();
+  int passed = 0;
+  size_t next = 0;
+
+  while(next < selected.size() || !running.empty()) {
+    while((int)running.size() < numJobs && next < selected.size()) {
+      UnitTest *t = selected[next];
+      next += 1;
+      pid_t pid = fork();
+      if (pid == 0) {		// Child: execute exactly one test and exit
+	try {
+	  t->func();
+	} catch(LowlevelError &err) {
+	  cerr << "  " << t->name << " fail: " << err.explain << endl;
+	  _exit(1);
+	} catch(...) {
+	  cerr << "  " << t->name << " fail" << endl;
+	  _exit(1);
+	}
+	_exit(0);
+      }
+      else if (pid < 0) {	// fork failed; run the test in this process
+	cerr << "testing : " << t->name << " ..." << endl;
+	try {
+	  t->func();
+	  passed += 1;
+	  cerr << "  passed." << endl;
+	} catch(LowlevelError &err) {
+	  cerr << "  fail: " << err.explain << endl;
+	} catch(...) {
+	  cerr << "  fail" << endl;
+	}
+      }
+      else
+	running[pid] = t;
+    }
+    if (running.empty()) continue;
+    int status = 0;
+    pid_t done = wait(&status);
+    if (done < 0) break;
+    std::map<pid_t,UnitTest *>::iterator iter = running.find(done);
+    if (iter == running.end()) continue;
+    bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    if (WIFSIGNALED(status))
+      cerr << "testing : " << (*iter).second->name << " ... CRASHED (signal " << WTERMSIG(status) << ")" << endl;
+    else
+      cerr << "testing : " << (*iter).second->name << " ... " << (ok ? "passed." : "FAILED") << endl;
+    if (ok)
+      passed += 1;
+    running.erase(iter);
+  }
+  cerr << "==============================" << endl;
+  cerr << passed << "/" << total << " tests passed." << endl;
+  return total - passed;
+#endif
+}
+
 /// Create list of the absolute path of all tests to be run
 /// \param dirname is a directory containing the XML test files
 /// \param testNames (if not empty) specifies particular tests to run
@@ -110,6 +195,7 @@ int main(int argc, char **argv) {
   argv += 1;
   set<string> unitTestNames;
   set<string> dataTestNames;
+  int numJobs = 1;
   string dirname("../datatests");
   string sleighdirname("../../../../../../..");
   while (argc > 0) {
@@ -136,6 +222,17 @@ int main(int argc, char **argv) {
       argv += 1;
       argc -= 1;
     }
+    else if (command == "-j") {
+      istringstream s(argv[1]);
+      s >> numJobs;
+      argv += 2;
+      argc -= 2;
+    }
+    else if (command == "--perf-baseline") {
+      FunctionTestCollection::setPerfBaseline(true);
+      argv += 1;
+      argc -= 1;
+    }
     else if (command == "unittests") {
       runUnitTests = true;
       runDataTests = false;	// Run only unit tests
@@ -149,7 +246,7 @@ int main(int argc, char **argv) {
       break;
     }
     else {
-      cout << "USAGE: ghidra_test [-usesleighenv] [-sleighpath <sleighdir>] [-path <datatestdir>] [[unittests|datatests] [testname1 testname2 ...]]" << endl;
+      cout << "USAGE: ghidra_test [-usesleighenv] [-sleighpath <sleighdir>] [-path <datatestdir>] [-j <numjobs>] [--perf-baseline] [[unittests|datatests] [testname1 testname2 ...]]" << endl;
       return -1;
     }
   }
@@ -159,7 +256,8 @@ int main(int argc, char **argv) {
   // max exit code value in add_exit_code
   int failedTests = 0;
   if (runUnitTests) {
-    int errors = UnitTest::run(unitTestNames);
+    int errors = (numJobs > 1) ? UnitTest::runParallel(unitTestNames,numJobs)
+			       : UnitTest::run(unitTestNames);
     failedTests = add_exit_code(failedTests, errors);
   }
   if (runDataTests) {
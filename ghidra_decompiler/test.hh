@@ -73,6 +73,7 @@ struct UnitTest {
   }
 
   static int run(set<string> &testNames);	///< Run all the instantiated tests
+  static int runParallel(set<string> &testNames,int numJobs);	///< Run tests in parallel, each in its own process
 };
 
 } // End namespace ghidra
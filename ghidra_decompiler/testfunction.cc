@@ -15,8 +15,12 @@
  */
 #include "ifacedecomp.hh"
 
+#include <chrono>
+
 namespace ghidra {
 
+bool FunctionTestCollection::perfBaseline = false;
+
 void FunctionTestProperty::startTest(void) const
 
 {
@@ -110,6 +114,11 @@ void FunctionTestCollection::clear(void)
   dcp->clearArchitecture();
   commands.clear();
   testList.clear();
+  timeBudgetMs = 0;
+  memBudgetKb = 0;
+  perfTolerance = 0.2;
+  measuredMs = 0;
+  measuredKb = 0;
   console->reset();
 }
 
@@ -144,6 +153,25 @@ void FunctionTestCollection::restoreXmlCommands(const Element *el)
   }
 }
 
+/// Budgets are optional attributes; anything not present stays unchecked.
+/// \param el is the root \<perfbudget> tag
+void FunctionTestCollection::restoreXmlPerf(const Element *el)
+
+{
+  for(int4 i=0;i<el->getNumAttributes();++i) {
+    const string &attrib(el->getAttributeName(i));
+    istringstream s(el->getAttributeValue(i));
+    if (attrib == "millis")
+      s >> timeBudgetMs;
+    else if (attrib == "kilobytes")
+      s >> memBudgetKb;
+    else if (attrib == "tolerance")
+      s >> perfTolerance;
+    else
+      throw IfaceParseError("Unknown attribute in <perfbudget>: "+attrib);
+  }
+}
+
 /// Instantiate an Architecture object
 void FunctionTestCollection::buildProgram(DocumentStorage &docStorage)
 
@@ -222,6 +250,11 @@ FunctionTestCollection::FunctionTestCollection(ostream &s)
   console->setErrorIsDone(true);
   numTestsApplied = 0;
   numTestsSucceeded = 0;
+  timeBudgetMs = 0;
+  memBudgetKb = 0;
+  perfTolerance = 0.2;
+  measuredMs = 0;
+  measuredKb = 0;
 }
 
 FunctionTestCollection::FunctionTestCollection(IfaceStatus *con)
@@ -232,6 +265,11 @@ FunctionTestCollection::FunctionTestCollection(IfaceStatus *con)
   dcp = (IfaceDecompData *)console->getData("decompile");
   numTestsApplied = 0;
   numTestsSucceeded = 0;
+  timeBudgetMs = 0;
+  memBudgetKb = 0;
+  perfTolerance = 0.2;
+  measuredMs = 0;
+  measuredKb = 0;
 }
 
 FunctionTestCollection::~FunctionTestCollection(void)
@@ -284,6 +322,8 @@ void FunctionTestCollection::restoreXml(DocumentStorage &store,const Element *el
       store.registerTag(subel);
       buildProgram(store);
     }
+    else if (subel->getName() == "perfbudget")
+      restoreXmlPerf(subel);
     else
       throw IfaceParseError("Unknown tag in <decompilertest>: "+subel->getName());
   }
@@ -316,7 +356,16 @@ void FunctionTestCollection::runTests(list<string> &lateStream)
   console->optr = &midBuffer;
   ostringstream bulkout;
   console->fileoptr = &bulkout;
+  std::chrono::steady_clock::time_point starttime = std::chrono::steady_clock::now();
   mainloop(console);
+  std::chrono::steady_clock::time_point endtime = std::chrono::steady_clock::now();
+  measuredMs = std::chrono::duration_cast<std::chrono::milliseconds>(endtime - starttime).count();
+  measuredKb = 0;
+  if (dcp->fd != (Funcdata *)0) {	// Footprint of the last function the script decompiled
+    FuncMemoryUsage usage;
+    dcp->fd->measureMemory(usage);
+    measuredKb = usage.getTotal() / 1024;
+  }
   console->optr = origStream;
   console->fileoptr = origStream;
   if (console->isInError()) {
@@ -348,6 +397,87 @@ void FunctionTestCollection::runTests(list<string> &lateStream)
     passLineToTests(line);
   }
   evaluateTests(lateStream);
+  if (perfBaseline)
+    writeBaseline();
+  else
+    checkPerf(lateStream);
+}
+
+/// Each configured budget counts as one additional test.  A budget fails if
+/// the measured number exceeds it by more than the tolerance fraction, so
+/// ordinary run-to-run noise does not trip the check.
+/// \param lateStream collects failures to display as a summary
+void FunctionTestCollection::checkPerf(list<string> &lateStream) const
+
+{
+  if (timeBudgetMs != 0) {
+    numTestsApplied += 1;
+    uint8 limit = (uint8)(timeBudgetMs * (1.0 + perfTolerance));
+    if (measuredMs <= limit) {
+      *console->optr << "Success -- time budget (" << dec << measuredMs << " ms <= " << limit << " ms)" << endl;
+      numTestsSucceeded += 1;
+    }
+    else {
+      *console->optr << "FAIL -- time budget (" << dec << measuredMs << " ms > " << limit << " ms)" << endl;
+      ostringstream fs;
+      fs << "Time budget exceeded for " << fileName << ": " << measuredMs << " ms > " << limit << " ms";
+      lateStream.push_back(fs.str());
+    }
+  }
+  if (memBudgetKb != 0) {
+    numTestsApplied += 1;
+    uint8 limit = (uint8)(memBudgetKb * (1.0 + perfTolerance));
+    if (measuredKb <= limit) {
+      *console->optr << "Success -- memory budget (" << dec << measuredKb << " KB <= " << limit << " KB)" << endl;
+      numTestsSucceeded += 1;
+    }
+    else {
+      *console->optr << "FAIL -- memory budget (" << dec << measuredKb << " KB > " << limit << " KB)" << endl;
+      ostringstream fs;
+      fs << "Memory budget exceeded for " << fileName << ": " << measuredKb << " KB > " << limit << " KB";
+      lateStream.push_back(fs.str());
+    }
+  }
+}
+
+/// Replace any existing \<perfbudget> tag in the test file with the numbers
+/// just measured, or insert one if the file has none.  The rest of the file
+/// is preserved byte for byte.
+void FunctionTestCollection::writeBaseline(void) const
+
+{
+  ifstream infile(fileName.c_str());
+  if (!infile)
+    throw IfaceExecutionError("Unable to reopen test file: " + fileName);
+  ostringstream contents;
+  contents << infile.rdbuf();
+  infile.close();
+  string text = contents.str();
+
+  ostringstream tag;
+  tag << "<perfbudget millis=\"" << dec << measuredMs << "\" kilobytes=\"" << measuredKb;
+  tag << "\" tolerance=\"" << perfTolerance << "\"/>";
+
+  string::size_type pos = text.find("<perfbudget");
+  if (pos != string::npos) {
+    string::size_type endpos = text.find("/>",pos);
+    if (endpos == string::npos)
+      throw IfaceExecutionError("Malformed <perfbudget> tag in: " + fileName);
+    text.replace(pos,endpos + 2 - pos,tag.str());
+  }
+  else {
+    pos = text.find("</decompilertest>");
+    if (pos == string::npos)
+      throw IfaceExecutionError("No <decompilertest> close tag in: " + fileName);
+    text.insert(pos,tag.str() + "\n");
+  }
+
+  ofstream outfile(fileName.c_str());
+  if (!outfile)
+    throw IfaceExecutionError("Unable to rewrite test file: " + fileName);
+  outfile << text;
+  outfile.close();
+  *console->optr << "Baseline recorded for " << fileName << ": " << dec << measuredMs << " ms, " << measuredKb << " KB" << endl;
 }
 
 /// Run through all XML files in the given list, processing each in turn.
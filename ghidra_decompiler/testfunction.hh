@@ -67,7 +67,14 @@ public:
 /// and then the output is scanned for by the test objects (FunctionTestProperty).
 /// Results of passed/failed tests are collected.  If the command line script
 /// does not complete properly, this is considered a special kind of failure.
+///
+/// A test file may additionally carry a \<perfbudget> tag giving wall-time
+/// and memory budgets for the script.  Budgets are checked after the string
+/// tests; exceeding a budget by more than the configured tolerance counts as
+/// a failure.  In \e baseline mode, measured numbers are written back into
+/// the test file instead of being checked.
 class FunctionTestCollection {
+  static bool perfBaseline;	///< Set to \b true to record budgets rather than check them
   IfaceDecompData *dcp;		///< Program data for the test collection
   string fileName;		///< Name of the file containing test data
   list<FunctionTestProperty> testList;	///< List of tests for this collection
@@ -76,13 +83,21 @@ class FunctionTestCollection {
   bool consoleOwner;		///< Set to \b true if \b this object owns the console
   mutable int4 numTestsApplied;		///< Count of tests that were executed
   mutable int4 numTestsSucceeded;	///< Count of tests that passed
+  uint8 timeBudgetMs;		///< Wall-time budget for the script in milliseconds (0 = unchecked)
+  uint8 memBudgetKb;		///< Function footprint budget in kilobytes (0 = unchecked)
+  double perfTolerance;		///< Fractional overrun allowed before a budget check fails
+  mutable uint8 measuredMs;	///< Wall-time measured by the last runTests()
+  mutable uint8 measuredKb;	///< Function footprint measured by the last runTests()
   void clear(void);		///< Clear any previous architecture and function
   static string stripNewlines(const string &ref);	///< Convert any \e newline character to a \e space
   void restoreXmlCommands(const Element *el);	///< Reconstruct commands from an XML tag
+  void restoreXmlPerf(const Element *el);	///< Reconstruct performance budgets from an XML tag
   void buildProgram(DocumentStorage &store);	///< Build program (Architecture) from \<binaryimage> tag
   void startTests(void) const;	///< Initialize each FunctionTestProperty
   void passLineToTests(const string &line) const;	///< Let all tests analyze a line of the results
   void evaluateTests(list<string> &lateStream) const;
+  void checkPerf(list<string> &lateStream) const;	///< Check measured numbers against the budgets
+  void writeBaseline(void) const;	///< Write measured numbers back into the test file
 public:
   FunctionTestCollection(ostream &s);		///< Constructor
   FunctionTestCollection(IfaceStatus *con);	///< Constructor with preexisting console
@@ -95,6 +110,7 @@ public:
   void restoreXml(DocumentStorage &store,const Element *el);	///< Load tests from a \<decompilertest> tag.
   void restoreXmlOldForm(DocumentStorage &store,const Element *el);	///< Load tests from \<binaryimage> tag.
   void runTests(list<string> &lateStream);	///< Run the script and perform the tests
+  static void setPerfBaseline(bool val) { perfBaseline = val; }	///< Toggle recording of performance baselines
   static int runTestFiles(const vector<string> &testFiles,ostream &s);	///< Run tests for each listed file
 };
 
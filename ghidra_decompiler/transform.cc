@@ -326,13 +326,77 @@ void LanedRegister::LanedIterator::normalize(void)
   }
 }
 
-TransformManager::~TransformManager(void)
+TransformArena::~TransformArena(void)
 
 {
-  map<int4,TransformVar *>::iterator iter;
-  for(iter=pieceMap.begin();iter!=pieceMap.end();++iter) {
-    delete [] (*iter).second;
+  for(int4 i=0;i<slabs.size();++i)
+    ::operator delete(slabs[i].first);
+}
+
+/// Storage is carved from the current slab if it fits, otherwise the next retained
+/// slab is started (or a new one allocated).  A request bigger than the default slab
+/// size gets a slab of its own.
+/// \param bytes is the number of bytes of storage requested
+/// \return a pointer to the uninitialized storage
+void *TransformArena::allocate(int4 bytes)
+
+{
+  bytes = (bytes + 15) & ~0xf;		// Preserve maximal alignment between objects
+  if (current >= 0 && fill + bytes <= slabs[current].second) {
+    void *res = slabs[current].first + fill;
+    fill += bytes;
+    return res;
   }
+  current += 1;
+  fill = bytes;
+  if (current == slabs.size()) {
+    int4 sz = (bytes > SLAB_BYTES) ? bytes : SLAB_BYTES;
+    slabs.emplace_back((char *)::operator new(sz),sz);
+  }
+  else if (slabs[current].second < bytes) {	// Retained slab is too small for the request
+    ::operator delete(slabs[current].first);
+    slabs[current] = pair<char *,int4>((char *)::operator new(bytes),bytes);
+  }
+  return slabs[current].first;
+}
+
+/// All outstanding allocations are invalidated, but the slabs are retained so the
+/// storage can be carved up again by a subsequent transform.
+void TransformArena::rewind(void)
+
+{
+  current = -1;
+  fill = 0;
+}
+
+/// The arena backing the placeholder nodes is borrowed from the function, so that
+/// its storage is retained and reused across successive transforms.
+/// \param f is the function being operated on
+TransformManager::TransformManager(Funcdata *f)
+
+{
+  fd = f;
+  arena = f->getTransformArena();
+}
+
+TransformManager::~TransformManager(void)
+
+{
+  for(int4 i=0;i<newOps.size();++i)
+    newOps[i]->~TransformOp();	// TransformVar placeholders are trivially destructible
+  arena->rewind();		// Placeholder storage is reclaimed wholesale
+}
+
+/// The storage comes from the arena.  The caller must still run initialize() on each element.
+/// \param num is the number of elements in the array
+/// \return the new array of placeholder variables
+TransformVar *TransformManager::newVarArray(int4 num)
+
+{
+  TransformVar *res = (TransformVar *)arena->allocate(num * (int4)sizeof(TransformVar));
+  for(int4 i=0;i<num;++i)
+    new((void *)(res + i)) TransformVar();
+  return res;
 }
 
 /// \brief Should the address of the given Varnode be preserved when constructing a piece
@@ -370,7 +434,7 @@ void TransformManager::clearVarnodeMarks(void)
 TransformVar *TransformManager::newPreexistingVarnode(Varnode *vn)
 
 {
-  TransformVar *res = new TransformVar[1];
+  TransformVar *res = newVarArray(1);
   pieceMap[vn->getCreateIndex()] = res;	// Enter preexisting Varnode into map, so we don't make another placeholder
 
   // value of 0 treats this as "piece" of itself at offset 0, allows getPiece() to find it
@@ -384,8 +448,8 @@ TransformVar *TransformManager::newPreexistingVarnode(Varnode *vn)
 TransformVar *TransformManager::newUnique(int4 size)
 
 {
-  newVarnodes.emplace_back();
-  TransformVar *res = &newVarnodes.back();
+  TransformVar *res = newVarArray(1);
+  newVarnodes.push_back(res);
   res->initialize(TransformVar::normal_temp,(Varnode *)0,size*8,size,0);
   return res;
 }
@@ -399,8 +463,8 @@ TransformVar *TransformManager::newUnique(int4 size)
 TransformVar *TransformManager::newConstant(int4 size,int4 lsbOffset,uintb val)
 
 {
-  newVarnodes.emplace_back();
-  TransformVar *res = &newVarnodes.back();
+  TransformVar *res = newVarArray(1);
+  newVarnodes.push_back(res);
   res->initialize(TransformVar::constant,(Varnode *)0,size*8,size,(val >> lsbOffset) & calc_mask(size));
   return res;
 }
@@ -411,8 +475,8 @@ TransformVar *TransformManager::newConstant(int4 size,int4 lsbOffset,uintb val)
 TransformVar *TransformManager::newIop(Varnode *vn)
 
 {
-  newVarnodes.emplace_back();
-  TransformVar *res = &newVarnodes.back();
+  TransformVar *res = newVarArray(1);
+  newVarnodes.push_back(res);
   res->initialize(TransformVar::constant_iop,(Varnode *)0,vn->getSize()*8,vn->getSize(),vn->getOffset());
   return res;
 }
@@ -426,7 +490,7 @@ TransformVar *TransformManager::newIop(Varnode *vn)
 TransformVar *TransformManager::newPiece(Varnode *vn,int4 bitSize,int4 lsbOffset)
 
 {
-  TransformVar *res = new TransformVar[1];
+  TransformVar *res = newVarArray(1);
   pieceMap[vn->getCreateIndex()] = res;
   int4 byteSize = (bitSize + 7) / 8;
   uint4 type = preserveAddress(vn, bitSize, lsbOffset) ? TransformVar::piece : TransformVar::piece_temp;
@@ -446,7 +510,7 @@ TransformVar *TransformManager::newSplit(Varnode *vn,const LaneDescription &desc
 
 {
   int4 num = description.getNumLanes();
-  TransformVar *res = new TransformVar[num];
+  TransformVar *res = newVarArray(num);
   pieceMap[vn->getCreateIndex()] = res;
   for(int4 i=0;i<num;++i) {
     int4 bitpos = description.getPosition(i) * 8;
@@ -475,7 +539,7 @@ TransformVar *TransformManager::newSplit(Varnode *vn,const LaneDescription &desc
 TransformVar *TransformManager::newSplit(Varnode *vn,const LaneDescription &description,int4 numLanes,int4 startLane)
 
 {
-  TransformVar *res = new TransformVar[numLanes];
+  TransformVar *res = newVarArray(numLanes);
   pieceMap[vn->getCreateIndex()] = res;
   int4 baseBitPos = description.getPosition(startLane) * 8;
   for(int4 i=0;i<numLanes;++i) {
@@ -503,16 +567,16 @@ TransformVar *TransformManager::newSplit(Varnode *vn,const LaneDescription &desc
 TransformOp *TransformManager::newOpReplace(int4 numParams,OpCode opc,PcodeOp *replace)
 
 {
-  newOps.emplace_back();
-  TransformOp &rop(newOps.back());
-  rop.op = replace;
-  rop.replacement = (PcodeOp *)0;
-  rop.opc = opc;
-  rop.special = TransformOp::op_replacement;
-  rop.output = (TransformVar *)0;
-  rop.follow = (TransformOp *)0;
-  rop.input.resize(numParams,(TransformVar *)0);
-  return &rop;
+  TransformOp *rop = new(arena->allocate(sizeof(TransformOp))) TransformOp();
+  newOps.push_back(rop);
+  rop->op = replace;
+  rop->replacement = (PcodeOp *)0;
+  rop->opc = opc;
+  rop->special = TransformOp::op_replacement;
+  rop->output = (TransformVar *)0;
+  rop->follow = (TransformOp *)0;
+  rop->input.resize(numParams,(TransformVar *)0);
+  return rop;
 }
 
 /// \brief Create a new placeholder op that will not replace an existing op
@@ -526,16 +590,16 @@ TransformOp *TransformManager::newOpReplace(int4 numParams,OpCode opc,PcodeOp *r
 TransformOp *TransformManager::newOp(int4 numParams,OpCode opc,TransformOp *follow)
 
 {
-  newOps.emplace_back();
-  TransformOp &rop(newOps.back());
-  rop.op = follow->op;
-  rop.replacement = (PcodeOp *)0;
-  rop.opc = opc;
-  rop.special = 0;
-  rop.output = (TransformVar *)0;
-  rop.follow = follow;
-  rop.input.resize(numParams,(TransformVar *)0);
-  return &rop;
+  TransformOp *rop = new(arena->allocate(sizeof(TransformOp))) TransformOp();
+  newOps.push_back(rop);
+  rop->op = follow->op;
+  rop->replacement = (PcodeOp *)0;
+  rop->opc = opc;
+  rop->special = 0;
+  rop->output = (TransformVar *)0;
+  rop->follow = follow;
+  rop->input.resize(numParams,(TransformVar *)0);
+  return rop;
 }
 
 /// \brief Create a new placeholder op for an existing PcodeOp
@@ -550,16 +614,16 @@ TransformOp *TransformManager::newOp(int4 numParams,OpCode opc,TransformOp *foll
 TransformOp *TransformManager::newPreexistingOp(int4 numParams,OpCode opc,PcodeOp *originalOp)
 
 {
-  newOps.emplace_back();
-  TransformOp &rop(newOps.back());
-  rop.op = originalOp;
-  rop.replacement = (PcodeOp *)0;
-  rop.opc = opc;
-  rop.special = TransformOp::op_preexisting;
-  rop.output = (TransformVar *)0;
-  rop.follow = (TransformOp *)0;
-  rop.input.resize(numParams,(TransformVar *)0);
-  return &rop;
+  TransformOp *rop = new(arena->allocate(sizeof(TransformOp))) TransformOp();
+  newOps.push_back(rop);
+  rop->op = originalOp;
+  rop->replacement = (PcodeOp *)0;
+  rop->opc = opc;
+  rop->special = TransformOp::op_preexisting;
+  rop->output = (TransformVar *)0;
+  rop->follow = (TransformOp *)0;
+  rop->input.resize(numParams,(TransformVar *)0);
+  return rop;
 }
 
 /// Check if a placeholder node was created for the preexisting Varnode for,
@@ -653,15 +717,14 @@ void TransformManager::specialHandling(TransformOp &rop)
 void TransformManager::createOps(void)
 
 {
-  list<TransformOp>::iterator iter;
-  for(iter=newOps.begin();iter!=newOps.end();++iter)
-    (*iter).createReplacement(fd);
+  for(int4 i=0;i<newOps.size();++i)
+    newOps[i]->createReplacement(fd);
 
   int4 followCount;
   do {
     followCount = 0;
-    for(iter=newOps.begin();iter!=newOps.end();++iter) {
-      if (!(*iter).attemptInsertion(fd))
+    for(int4 i=0;i<newOps.size();++i) {
+      if (!newOps[i]->attemptInsertion(fd))
 	followCount += 1;
     }
   } while(followCount != 0);
@@ -692,18 +755,15 @@ void TransformManager::createVarnodes(vector<TransformVar *> &inputList)
 	break;
     }
   }
-  list<TransformVar>::iterator iter;
-  for(iter=newVarnodes.begin();iter!=newVarnodes.end();++iter) {
-    (*iter).createReplacement(fd);
-  }
+  for(int4 i=0;i<newVarnodes.size();++i)
+    newVarnodes[i]->createReplacement(fd);
 }
 
 void TransformManager::removeOld(void)
 
 {
-  list<TransformOp>::iterator iter;
-  for(iter=newOps.begin();iter!=newOps.end();++iter) {
-    TransformOp &rop(*iter);
+  for(int4 i=0;i<newOps.size();++i) {
+    TransformOp &rop(*newOps[i]);
     if ((rop.special & TransformOp::op_replacement) != 0) {
       if (!rop.op->isDead())
 	fd->opDestroy(rop.op);	// Destroy old op (and its output Varnode)
@@ -728,9 +788,8 @@ void TransformManager::transformInputVarnodes(vector<TransformVar *> &inputList)
 void TransformManager::placeInputs(void)
 
 {
-  list<TransformOp>::iterator iter;
-  for(iter=newOps.begin();iter!=newOps.end();++iter) {
-    TransformOp &rop(*iter);
+  for(int4 j=0;j<newOps.size();++j) {
+    TransformOp &rop(*newOps[j]);
     PcodeOp *op = rop.replacement;
     for(int4 i=0;i<rop.input.size();++i) {
       TransformVar *rvn = rop.input[i];
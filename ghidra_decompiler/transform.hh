@@ -147,6 +147,24 @@ public:
   bool extension(int4 numLanes,int4 skipLanes,int4 bytePos,int4 size,int4 &resNumLanes,int4 &resSkipLanes) const;
 };
 
+/// \brief Bump allocator backing the placeholder nodes of a transform
+///
+/// Storage for placeholders is carved sequentially out of large slabs and reclaimed
+/// all at once when the transform is finished.  The slabs themselves are retained by
+/// the owning Funcdata and handed to subsequent TransformManager instances, so that
+/// repeated rule applications produce no traffic on the global heap.
+class TransformArena {
+  static const int4 SLAB_BYTES = 65536;	///< Default number of bytes in one slab
+  vector<pair<char *,int4> > slabs;	///< Allocated slabs of raw storage, with their sizes
+  int4 current;				///< Index of the slab being filled (-1 if none)
+  int4 fill;				///< Number of bytes used in the current slab
+public:
+  TransformArena(void) { current = -1; fill = 0; }	///< Construct an empty arena
+  ~TransformArena(void);		///< Destructor
+  void *allocate(int4 bytes);		///< Obtain raw storage for the given number of bytes
+  void rewind(void);			///< Make all storage available again, retaining the slabs
+};
+
 /// \brief Class for splitting larger registers holding smaller logical lanes
 ///
 /// Given a starting Varnode in the data-flow, look for evidence of the Varnode
@@ -155,10 +173,12 @@ public:
 /// Varnode and data-flow into explicit operations on the lanes.
 class TransformManager {
   Funcdata *fd;					///< Function being operated on
+  TransformArena *arena;			///< Arena providing storage for all placeholder nodes
   map<int4,TransformVar *> pieceMap;		///< Map from large Varnodes to their new pieces
-  list<TransformVar> newVarnodes;		///< Storage for Varnode placeholder nodes
-  list<TransformOp> newOps;			///< Storage for PcodeOp placeholder nodes
+  vector<TransformVar *> newVarnodes;		///< Varnode placeholders not associated with an original Varnode
+  vector<TransformOp *> newOps;			///< PcodeOp placeholder nodes in creation order
 
+  TransformVar *newVarArray(int4 num);	///< Allocate an array of placeholder variables from the arena
   void specialHandling(TransformOp &rop);
   void createOps(void);		///< Create a new op for each placeholder
   void createVarnodes(vector<TransformVar *> &inputList);	///< Create a Varnode for each placeholder
@@ -166,7 +186,7 @@ class TransformManager {
   void transformInputVarnodes(vector<TransformVar *> &inputList);	///< Remove old input Varnodes, mark new input Varnodes
   void placeInputs(void);	///< Set input Varnodes for all new ops
 public:
-  TransformManager(Funcdata *f) { fd = f; }	///< Constructor
+  TransformManager(Funcdata *f);		///< Constructor
   virtual ~TransformManager(void);		///< Destructor
   virtual bool preserveAddress(Varnode *vn,int4 bitSize,int4 lsbOffset) const;
   Funcdata *getFunction(void) const { return fd; }	///< Get function being transformed
@@ -44,6 +44,17 @@ void TruncationTag::decode(Decoder &decoder)
   decoder.closeElement(elemId);
 }
 
+/// Write a \<truncate_space> element describing \b this object
+/// \param encoder is the stream encoder
+void TruncationTag::encode(Encoder &encoder) const
+
+{
+  encoder.openElement(ELEM_TRUNCATE_SPACE);
+  encoder.writeString(ATTRIB_SPACE,spaceName);
+  encoder.writeUnsignedInteger(ATTRIB_SIZE,size);
+  encoder.closeElement(ELEM_TRUNCATE_SPACE);
+}
+
 /// Construct a virtual space.  This is usually used for the stack
 /// space, which is indicated by the \b isFormal parameters, but multiple such spaces are allowed.
 /// \param m is the manager for this \b program \b specific address space
@@ -961,6 +972,37 @@ Translate::Translate(void)
 /// If no floating-point format objects were registered by the \b initialize method, this
 /// method will fill in some suitable default formats.  These defaults are based on
 /// the 4-byte and 8-byte encoding specified by the IEEE 754 standard.
+/// \brief Disassemble a contiguous run of instructions with a single call
+///
+/// Instructions are decoded in address order, each reported to the application
+/// through the \e dump method of the emit object, until the end of the range
+/// is reached or undecodable bytes are encountered.  An engine may override
+/// this to keep its parse machinery warm across the whole run, which is
+/// substantially cheaper than calling printAssembly() in a loop.
+/// \param emit is the disassembly emitting object
+/// \param baseaddr is the address of the first machine instruction
+/// \param maxbytes is the maximum number of bytes to disassemble
+/// \return the number of bytes successfully disassembled
+int4 Translate::printAssemblyRange(AssemblyEmit &emit,const Address &baseaddr,int4 maxbytes) const
+
+{
+  Address addr = baseaddr;
+  int4 total = 0;
+
+  while(total < maxbytes) {
+    int4 len;
+    try {
+      len = printAssembly(emit,addr);
+    } catch(BadDataError &err) {
+      break;			// Undecodable bytes end the run
+    }
+    if (len <= 0) break;
+    total += len;
+    addr = addr + len;
+  }
+  return total;
+}
+
 void Translate::setDefaultFloatFormats(void)
 
 {
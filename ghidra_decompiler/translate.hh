@@ -83,6 +83,7 @@ class TruncationTag {
   uint4 size;		///< Size truncated addresses into the space
 public:
   void decode(Decoder &decoder);				///< Restore \b this from a stream
+  void encode(Encoder &encoder) const;				///< Encode \b this to a stream
   const string &getName(void) const { return spaceName; }	///< Get name of address space being truncated
   uint4 getSize(void) const { return size; }			///< Size (of pointers) for new truncated space
 };
@@ -362,6 +363,35 @@ public:
   /// \param val is \b true to allow context changes, \b false prevents changes
   virtual void allowContextSet(bool val) const {}
 
+  /// \brief Configure the size of any internal disassembly caching
+  ///
+  /// Engines that cache parsed instructions can be tuned for disassembly
+  /// heavy workloads.  The default implementation does nothing.
+  /// \param cachesize is the number of cached instruction parses (per decode thread)
+  /// \param windowsize is the size of the address hash-table, a power of 2
+  virtual void setDisassemblyCache(int4 cachesize,int4 windowsize) const {}
+
+  /// \brief Discard any cached instruction parses
+  ///
+  /// Engines that cache parsed instructions must be told when the underlying
+  /// program bytes change, or they may replay a stale decode at a patched
+  /// address.  Do not call while disassembly is in progress.  The default
+  /// implementation does nothing.
+  virtual void clearDisassemblyCache(void) const {}
+
+  /// \brief Speculatively decode a range of fall-thru instructions
+  ///
+  /// Engines that cache parsed instructions can prefetch a straight-line
+  /// run of instructions ahead of p-code generation, so that generation
+  /// streams from the cache.  Decoding is allowed to stop early: at bad or
+  /// unimplemented data, or at any instruction whose context commits could
+  /// affect the decoding of its successors.  The default implementation
+  /// does nothing.
+  /// \param addr is the address of the first instruction to decode
+  /// \param stopaddr is the first address that should \e not be decoded
+  /// \param maxinstr is the maximum number of instructions to decode
+  virtual void decodeRange(const Address &addr,const Address &stopaddr,int4 maxinstr) const {}
+
   /// \brief Get a register as VarnodeData given its name
   ///
   /// Retrieve the location and size of a register given its name
@@ -440,6 +470,7 @@ public:
   /// \param emit is the disassembly emitting object
   /// \param baseaddr is the address of the machine instruction to disassemble
   virtual int4 printAssembly(AssemblyEmit &emit,const Address &baseaddr) const=0;
+  virtual int4 printAssemblyRange(AssemblyEmit &emit,const Address &baseaddr,int4 maxbytes) const;
 };
 
 /// Return the size of addresses for the processor's official
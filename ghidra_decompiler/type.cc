@@ -232,6 +232,24 @@ int4 Datatype::compareDependency(const Datatype &op) const
   return 0;
 }
 
+/// The hash is a function only of properties tested by the container's functional
+/// comparator, so two data-types that compare as equivalent always produce the same
+/// value.  Composite data-types fold in their components by pointer identity, since
+/// the components are already interned by the factory.
+/// \return the hash value
+uint8 Datatype::getStructuralHash(void) const
+
+{
+  uint8 res = 0xcbf29ce484222325;	// FNV-1a over the identifying fields
+  res ^= (uint8)submeta;
+  res *= 0x100000001b3;
+  res ^= (uint8)size;
+  res *= 0x100000001b3;
+  res ^= id;
+  res *= 0x100000001b3;
+  return res;
+}
+
 /// Convert a type \b meta-type into the string name of the meta-type
 /// \param metatype is the encoded type meta-type
 /// \param res will hold the resulting string
@@ -966,6 +984,19 @@ int4 TypePointer::compareDependency(const Datatype &op) const
   return (op.getSize()-size);
 }
 
+uint8 TypePointer::getStructuralHash(void) const
+
+{
+  uint8 res = Datatype::getStructuralHash();
+  res ^= (uint8)(uintp)ptrto;
+  res *= 0x100000001b3;
+  res ^= (uint8)wordsize;
+  res *= 0x100000001b3;
+  res ^= (uint8)(uintp)spaceid;
+  res *= 0x100000001b3;
+  return res;
+}
+
 void TypePointer::encode(Encoder &encoder) const
 
 {
@@ -1231,6 +1262,15 @@ int4 TypeArray::compareDependency(const Datatype &op) const
   return (op.getSize()-size);
 }
 
+uint8 TypeArray::getStructuralHash(void) const
+
+{
+  uint8 res = Datatype::getStructuralHash();
+  res ^= (uint8)(uintp)arrayof;
+  res *= 0x100000001b3;
+  return res;
+}
+
 Datatype *TypeArray::getSubType(int8 off,int8 *newoff) const
 
 {				// Go down exactly one level, to type of element
@@ -3101,6 +3141,13 @@ void TypeSpacebase::decode(Decoder &decoder,TypeFactory &typegrp)
 bool TypeFactory::propagatedbg_on = false;
 #endif
 
+CoreTypeGroup::~CoreTypeGroup(void)
+
+{
+  for(int4 i=0;i<coretypes.size();++i)
+    delete coretypes[i];
+}
+
 /// Initialize an empty container
 /// \param g is the owning Architecture
 TypeFactory::TypeFactory(Architecture *g)
@@ -3200,6 +3247,7 @@ void TypeFactory::setCoreType(const string &name,int4 size,
 void TypeFactory::cacheCoreTypes(void)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(factorylock);
   DatatypeSet::iterator iter;
 
   for(iter=tree.begin();iter!=tree.end();++iter) {
@@ -3251,21 +3299,63 @@ void TypeFactory::cacheCoreTypes(void)
 void TypeFactory::clear(void)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(factorylock);
   DatatypeSet::iterator iter;
 
-  for(iter=tree.begin();iter!=tree.end();++iter)
-    delete *iter;
+  for(iter=tree.begin();iter!=tree.end();++iter) {
+    Datatype *ct = *iter;
+    if (ct->isCoreType() && coreGroup)
+      continue;			// Owned by the shared group, not this factory
+    delete ct;
+  }
+  coreGroup.reset();
   tree.clear();
   nametree.clear();
+  hashindex.clear();
   clearCache();
   warnings.clear();
   incompleteTypedef.clear();
 }
 
+/// The core data-types currently in \b this factory are moved into a new group, which takes
+/// over ownership.  The factory keeps the objects in its lookup trees and holds a reference
+/// to the group; other factories for the same language can then adoptCoreTypes() the group
+/// instead of rebuilding the base type universe from the specification.
+/// \return the newly created group
+std::shared_ptr<const CoreTypeGroup> TypeFactory::donateCoreTypes(void)
+
+{
+  CoreTypeGroup *group = new CoreTypeGroup();
+  DatatypeSet::iterator iter;
+
+  for(iter=tree.begin();iter!=tree.end();++iter) {
+    Datatype *ct = *iter;
+    if (ct->isCoreType())
+      group->coretypes.push_back(ct);
+  }
+  coreGroup.reset(group);
+  return coreGroup;
+}
+
+/// The group's data-types are inserted into \b this factory's lookup trees, and the cache of
+/// common types is primed, mirroring decodeCoreTypes().  The objects remain owned by the
+/// group and must be treated as read-only, as other factories may be sharing them.
+/// \param group is the group of core data-types to share
+void TypeFactory::adoptCoreTypes(std::shared_ptr<const CoreTypeGroup> group)
+
+{
+  clear();			// Make sure this routine flushes, as decodeCoreTypes does
+  coreGroup = group;
+  for(int4 i=0;i<coreGroup->coretypes.size();++i)
+    insert(coreGroup->coretypes[i]);
+  cacheCoreTypes();
+}
+
 /// Delete anything that isn't a core type
 void TypeFactory::clearNoncore(void)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(factorylock);
   DatatypeSet::iterator iter;
   Datatype *ct;
 
@@ -3277,6 +3367,7 @@ void TypeFactory::clearNoncore(void)
       continue;
     }
     nametree.erase(ct);
+    hashErase(ct);
     tree.erase(iter++);
     delete ct;
   }
@@ -3354,6 +3445,7 @@ Datatype *TypeFactory::findByIdLocal(const string &n,uint8 id) const
 Datatype *TypeFactory::findById(const string &n,uint8 id,int4 sz)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(factorylock);
   if (sz > 0) {				// If the id is for a "variable length" base data-type
     id = Datatype::hashSize(id, sz);	// Construct the id for the "sized" variant
   }
@@ -3371,18 +3463,49 @@ Datatype *TypeFactory::findByName(const string &n)
 
 /// Find data-type without reference to name, using the functional comparators
 /// For this to work, the type must be built out of dependencies that are already
-/// present in \b this type factory
+/// present in \b this type factory.  The structural hash narrows the search to a
+/// single bucket, and the functional comparator makes the precise match.
 /// \param ct is the data-type to match
 /// \return the matching Datatype or NULL
 Datatype *TypeFactory::findNoName(Datatype &ct)
 
 {
-  DatatypeSet::const_iterator iter;
-  Datatype *res = (Datatype *)0;
-  iter = tree.find(&ct);
-  if (iter != tree.end())
-    res = *iter;
-  return res;
+  uint8 hash = ct.getStructuralHash();
+  pair<unordered_multimap<uint8,Datatype *>::const_iterator,unordered_multimap<uint8,Datatype *>::const_iterator>
+    range = hashindex.equal_range(hash);
+  while(range.first != range.second) {
+    Datatype *res = (*range.first).second;
+    if (res->compareDependency(ct)==0 && res->getId() == ct.getId())
+      return res;
+    ++range.first;
+  }
+  return (Datatype *)0;
+}
+
+/// The data-type's structural hash is computed and stored on the object, then
+/// the object is added to the hash index under it.
+/// \param ct is the data-type to index
+void TypeFactory::hashInsert(Datatype *ct)
+
+{
+  ct->structhash = ct->getStructuralHash();
+  hashindex.insert(pair<uint8,Datatype *>(ct->structhash,ct));
+}
+
+/// The data-type is looked up under its stored structural hash, so this must be
+/// called \e before any mutation that changes the hash.
+/// \param ct is the data-type to remove from the hash index
+void TypeFactory::hashErase(Datatype *ct)
+
+{
+  unordered_multimap<uint8,Datatype *>::iterator iter = hashindex.find(ct->structhash);
+  while(iter != hashindex.end() && (*iter).first == ct->structhash) {
+    if ((*iter).second == ct) {
+      hashindex.erase(iter);
+      return;
+    }
+    ++iter;
+  }
 }
 
 /// Internal method for finally inserting a new Datatype pointer
@@ -3401,6 +3524,7 @@ void TypeFactory::insert(Datatype *newtype)
     delete newtype;
     throw LowlevelError(s.str());
   }
+  hashInsert(newtype);
   if (newtype->id!=0)
     nametree.insert(newtype);
 }
@@ -3412,6 +3536,7 @@ void TypeFactory::insert(Datatype *newtype)
 Datatype *TypeFactory::findAdd(Datatype &ct)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(factorylock);
   Datatype *newtype,*res;
 
   if (ct.name.size()!=0) {	// If there is a name
@@ -3445,8 +3570,10 @@ Datatype *TypeFactory::findAdd(Datatype &ct)
 Datatype *TypeFactory::setName(Datatype *ct,const string &n)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(factorylock);
   if (ct->id != 0)
     nametree.erase( ct );	// Erase any name reference
+  hashErase(ct);
   tree.erase(ct);		// Remove new type completely from trees
   ct->name = n;			// Change the name
   ct->displayName = n;
@@ -3454,6 +3581,7 @@ Datatype *TypeFactory::setName(Datatype *ct,const string &n)
     ct->id = Datatype::hashName(n);
 				// Insert type with new name
   tree.insert(ct);
+  hashInsert(ct);
   nametree.insert( ct );	// Re-insert name reference
   return ct;
 }
@@ -3466,6 +3594,7 @@ Datatype *TypeFactory::setName(Datatype *ct,const string &n)
 void TypeFactory::setDisplayFormat(Datatype *ct,uint4 format)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(factorylock);
   ct->setDisplayFormat(format);
 }
 
@@ -3479,14 +3608,17 @@ void TypeFactory::setDisplayFormat(Datatype *ct,uint4 format)
 void TypeFactory::setFields(const vector<TypeField> &fd,TypeStruct *ot,int4 newSize,int4 newAlign,uint4 flags)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(factorylock);
   if (!ot->isIncomplete())
     throw LowlevelError("Can only set fields on an incomplete structure");
 
+  hashErase(ot);
   tree.erase(ot);
   ot->setFields(fd,newSize,newAlign);
   ot->flags &= ~(uint4)Datatype::type_incomplete;
   ot->flags |= (flags & (Datatype::opaque_string | Datatype::variable_length | Datatype::type_incomplete));
   tree.insert(ot);
+  hashInsert(ot);
   recalcPointerSubmeta(ot, SUB_PTR);
   recalcPointerSubmeta(ot, SUB_PTR_STRUCT);
 }
@@ -3500,14 +3632,17 @@ void TypeFactory::setFields(const vector<TypeField> &fd,TypeStruct *ot,int4 newS
 void TypeFactory::setFields(const vector<TypeField> &fd,TypeUnion *ot,int4 newSize,int4 newAlign,uint4 flags)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(factorylock);
   if (!ot->isIncomplete())
     throw LowlevelError("Can only set fields on an incomplete union");
 
+  hashErase(ot);
   tree.erase(ot);
   ot->setFields(fd,newSize,newAlign);
   ot->flags &= ~(uint4)Datatype::type_incomplete;
   ot->flags |= (flags & (Datatype::variable_length | Datatype::type_incomplete));
   tree.insert(ot);
+  hashInsert(ot);
 }
 
 /// The given prototype is copied into the given code data-type
@@ -3518,13 +3653,16 @@ void TypeFactory::setFields(const vector<TypeField> &fd,TypeUnion *ot,int4 newSi
 void TypeFactory::setPrototype(const FuncProto *fp,TypeCode *newCode,uint4 flags)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(factorylock);
   if (!newCode->isIncomplete())
     throw LowlevelError("Can only set prototype on incomplete data-type");
+  hashErase(newCode);
   tree.erase(newCode);
   newCode->setPrototype(this,fp);
   newCode->flags &= ~(uint4)Datatype::type_incomplete;
   newCode->flags |= (flags & (Datatype::variable_length | Datatype::type_incomplete));
   tree.insert(newCode);
+  hashInsert(newCode);
 }
 
 /// \param nmap is the mapping from integer value to name string
@@ -3532,9 +3670,12 @@ void TypeFactory::setPrototype(const FuncProto *fp,TypeCode *newCode,uint4 flags
 void TypeFactory::setEnumValues(const map<uintb,string> &nmap,TypeEnum *te)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(factorylock);
+  hashErase(te);
   tree.erase(te);
   te->setNameMap(nmap);
   tree.insert(te);
+  hashInsert(te);
 }
 
 /// Recursively write out all the components of a data-type in dependency order
@@ -3563,6 +3704,7 @@ void TypeFactory::orderRecurse(vector<Datatype *> &deporder,DatatypeSet &mark,
 void TypeFactory::dependentOrder(vector<Datatype *> &deporder) const
 
 {
+  std::lock_guard<std::recursive_mutex> lock(factorylock);
   DatatypeSet mark;
   DatatypeSet::const_iterator iter;
 
@@ -3570,11 +3712,32 @@ void TypeFactory::dependentOrder(vector<Datatype *> &deporder) const
     orderRecurse(deporder,mark,*iter);
 }
 
+/// A rough estimate used for memory attribution: each data-type counts an object
+/// size approximated by a large common subclass, its container node overhead, its
+/// name string, and its dependency/field payload.
+/// \return the estimated number of heap bytes behind \b this container
+uint8 TypeFactory::memoryEstimate(void) const
+
+{
+  std::lock_guard<std::recursive_mutex> lock(factorylock);
+  uint8 res = 0;
+  DatatypeSet::const_iterator iter;
+
+  for(iter=tree.begin();iter!=tree.end();++iter) {
+    Datatype *ct = *iter;
+    res += sizeof(TypeStruct) + 3*sizeof(void *);
+    res += ct->getName().size();
+    res += ct->numDepend() * sizeof(TypeField);
+  }
+  return res;
+}
+
 /// There should be exactly one instance of the "void" Datatype object, which this fetches
 /// \return the "void" data-type
 TypeVoid *TypeFactory::getTypeVoid(void)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(factorylock);
   TypeVoid *ct = (TypeVoid *)typecache[0][TYPE_VOID-TYPE_FLOAT];
   if (ct != (TypeVoid *)0)
     return ct;
@@ -3582,6 +3745,7 @@ TypeVoid *TypeFactory::getTypeVoid(void)
   tv.id = Datatype::hashName(tv.name);
   ct = (TypeVoid *)tv.clone();
   tree.insert(ct);
+  hashInsert(ct);
   nametree.insert(ct);
   typecache[0][TYPE_VOID-TYPE_FLOAT] = ct; // Cache this particular type ourselves
   return ct;
@@ -3736,9 +3900,11 @@ void TypeFactory::recalcPointerSubmeta(Datatype *base,sub_metatype sub)
     if (ptr->ptrto != base) break;
     ++iter;
     if (ptr->submeta == sub) {
+      hashErase(ptr);
       tree.erase(ptr);
       ptr->submeta = curSub;		// Change to correct submeta
       tree.insert(ptr);			// Reinsert
+      hashInsert(ptr);
     }
   }
 }
@@ -3749,6 +3915,7 @@ void TypeFactory::recalcPointerSubmeta(Datatype *base,sub_metatype sub)
 void TypeFactory::insertWarning(Datatype *dt,string warn)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(factorylock);
   if (dt->getId() == 0)
     throw LowlevelError("Can only issue warnings for named data-types");
   dt->flags |= Datatype::warning_issued;
@@ -3760,6 +3927,7 @@ void TypeFactory::insertWarning(Datatype *dt,string warn)
 void TypeFactory::removeWarning(Datatype *dt)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(factorylock);
   list<DatatypeWarning>::iterator iter = warnings.begin();
   while(iter != warnings.end()) {
     if ((*iter).dataType->getId() == dt->getId() && (*iter).dataType->getName() == dt->getName()) {
@@ -3776,6 +3944,7 @@ void TypeFactory::removeWarning(Datatype *dt)
 void TypeFactory::resolveIncompleteTypedefs(void)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(factorylock);
   list<Datatype *>::iterator iter = incompleteTypedef.begin();
   while(iter != incompleteTypedef.end()) {
     Datatype *dt = *iter;
@@ -3817,6 +3986,7 @@ void TypeFactory::resolveIncompleteTypedefs(void)
 Datatype *TypeFactory::getTypedef(Datatype *ct,const string &name,uint8 id,uint4 format)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(factorylock);
   if (id == 0)
     id = Datatype::hashName(name);
   Datatype *res = findByIdLocal(name, id);
@@ -4121,11 +4291,13 @@ Datatype *TypeFactory::getExactPiece(Datatype *ct,int4 offset,int4 size)
 void TypeFactory::destroyType(Datatype *ct)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(factorylock);
   if (ct->isCoreType())
     throw LowlevelError("Cannot destroy core type");
   if (ct->hasWarning())
     removeWarning(ct);
   nametree.erase(ct);
+  hashErase(ct);
   tree.erase(ct);
   delete ct;
 }
@@ -4154,6 +4326,7 @@ Datatype *TypeFactory::concretize(Datatype *ct)
 Datatype *TypeFactory::decodeType(Decoder &decoder)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(factorylock);
   Datatype *ct;
   uint4 elemId = decoder.peekElement();
   if (ELEM_TYPEREF == elemId) {
@@ -4192,6 +4365,7 @@ Datatype *TypeFactory::decodeType(Decoder &decoder)
 Datatype *TypeFactory::decodeTypeWithCodeFlags(Decoder &decoder,bool isConstructor,bool isDestructor)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(factorylock);
   TypePointer tp;
   uint4 elemId = decoder.openElement();
   tp.decodeBasic(decoder);
@@ -4215,6 +4389,7 @@ Datatype *TypeFactory::decodeTypeWithCodeFlags(Decoder &decoder,bool isConstruct
 void TypeFactory::encode(Encoder &encoder) const
 
 {
+  std::lock_guard<std::recursive_mutex> lock(factorylock);
   vector<Datatype *> deporder;
   vector<Datatype *>::iterator iter;
 
@@ -4239,6 +4414,7 @@ void TypeFactory::encode(Encoder &encoder) const
 void TypeFactory::encodeCoreTypes(Encoder &encoder) const
 
 {
+  std::lock_guard<std::recursive_mutex> lock(factorylock);
   DatatypeSet::const_iterator iter;
   Datatype *ct;
 
@@ -4552,6 +4728,7 @@ Datatype *TypeFactory::decodeTypeNoRef(Decoder &decoder,bool forcecore)
 void TypeFactory::decode(Decoder &decoder)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(factorylock);
   uint4 elemId = decoder.openElement(ELEM_TYPEGRP);
 
   while(decoder.peekElement() != 0)
@@ -4566,6 +4743,7 @@ void TypeFactory::decode(Decoder &decoder)
 void TypeFactory::decodeCoreTypes(Decoder &decoder)
 
 {
+  std::lock_guard<std::recursive_mutex> lock(factorylock);
   clear();			// Make sure this routine flushes
 
   uint4 elemId = decoder.openElement(ELEM_CORETYPES);
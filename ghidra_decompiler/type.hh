@@ -21,8 +21,14 @@
 
 #include "address.hh"
 
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+
 namespace ghidra {
 
+using std::unordered_multimap;
+
 extern AttributeId ATTRIB_ALIGNMENT;	///< Marshaling attribute "alignment"
 extern AttributeId ATTRIB_ARRAYSIZE;	///< Marshaling attribute "arraysize"
 extern AttributeId ATTRIB_CHAR;		///< Marshaling attribute "char"
@@ -187,6 +193,7 @@ protected:
   friend class TypeFactory;
   friend struct DatatypeCompare;
   uint8 id;			///< A unique id for the type (or 0 if an id is not assigned)
+  uint8 structhash;		///< Structural hash under which \b this is indexed by its TypeFactory
   int4 size;			///< Size (of variable holding a value of this type)
   uint4 flags;			///< Boolean properties of the type
   string name;			///< Name of type
@@ -209,10 +216,10 @@ protected:
 public:
   /// Construct the base data-type copying low-level properties of another
   Datatype(const Datatype &op) { size = op.size; name=op.name; displayName=op.displayName; metatype=op.metatype;
-    submeta=op.submeta; flags=op.flags; id=op.id; typedefImm=op.typedefImm; alignment=op.alignment; alignSize=op.alignSize; }
+    submeta=op.submeta; flags=op.flags; id=op.id; structhash=op.structhash; typedefImm=op.typedefImm; alignment=op.alignment; alignSize=op.alignSize; }
   /// Construct the base data-type providing size and meta-type
   Datatype(int4 s,int4 align,type_metatype m) {
-    size=s; metatype=m; submeta=base2sub[m]; flags=0; id=0; typedefImm=(Datatype *)0; alignment=align; alignSize=s; }
+    size=s; metatype=m; submeta=base2sub[m]; flags=0; id=0; structhash=0; typedefImm=(Datatype *)0; alignment=align; alignSize=s; }
   virtual ~Datatype(void) {}	///< Destructor
   bool isCoreType(void) const { return ((flags&coretype)!=0); }	///< Is this a core data-type
   bool isCharPrint(void) const { return ((flags&(chartype|utf16|utf32|opaque_string))!=0); }	///< Does this print as a 'char'
@@ -273,6 +280,7 @@ public:
   virtual void printNameBase(ostream &s) const { if (!name.empty()) s<<name[0]; }
   virtual int4 compare(const Datatype &op,int4 level) const; ///< Order types for propagation
   virtual int4 compareDependency(const Datatype &op) const; ///< Compare for storage in tree structure
+  virtual uint8 getStructuralHash(void) const;	///< Hash the structural description of \b this data-type
   virtual void encode(Encoder &encoder) const;	///< Encode the data-type to a stream
   virtual bool isPtrsubMatching(int8 off,int8 extra,int8 multiplier) const;	///< Is this data-type suitable as input to a CPUI_PTRSUB op
   virtual Datatype *getStripped(void) const;		///< Get a stripped version of \b this for formal use in formal declarations
@@ -424,6 +432,7 @@ public:
   virtual void printNameBase(ostream &s) const { s << 'p'; ptrto->printNameBase(s); }
   virtual int4 compare(const Datatype &op,int4 level) const;
   virtual int4 compareDependency(const Datatype &op) const;
+  virtual uint8 getStructuralHash(void) const;
   virtual Datatype *clone(void) const { return new TypePointer(*this); }
   virtual void encode(Encoder &encoder) const;
   virtual TypePointer *downChain(int8 &off,TypePointer *&par,int8 &parOff,bool allowArrayWrap,TypeFactory &typegrp);
@@ -457,6 +466,7 @@ public:
   virtual void printNameBase(ostream &s) const { s << 'a'; arrayof->printNameBase(s); }
   virtual int4 compare(const Datatype &op,int4 level) const; // For tree structure
   virtual int4 compareDependency(const Datatype &op) const; // For tree structure
+  virtual uint8 getStructuralHash(void) const;
   virtual Datatype *clone(void) const { return new TypeArray(*this); }
   virtual void encode(Encoder &encoder) const;
   virtual Datatype *resolveInFlow(PcodeOp *op,int4 slot);
@@ -758,6 +768,21 @@ public:
   const string &getWarning(void) const { return warning; }	///< Get the warning string
 };
 
+/// \brief An immutable group of core data-types, shareable across TypeFactory instances
+///
+/// The core data-types built from a compiler spec are identical for every Architecture
+/// instance of the same language.  The first factory to build them can donate the objects to
+/// a group, which takes over ownership.  Factories constructed later adopt the group,
+/// inserting the same objects into their lookup trees and skipping construction of the base
+/// type universe entirely.  Adopted objects must be treated as read-only; they are deleted
+/// only when the last reference to the group is dropped.
+class CoreTypeGroup {
+  friend class TypeFactory;
+  vector<Datatype *> coretypes;		///< The core data-type objects owned by \b this group
+public:
+  ~CoreTypeGroup(void);			///< Destroy the core data-types
+};
+
 /// \brief Container class for all Datatype objects in an Architecture
 class TypeFactory {
   int4 sizeOfInt;		///< Size of the core "int" data-type
@@ -771,6 +796,7 @@ class TypeFactory {
   vector<int4> alignMap;	///< Alignment of primitive data-types based on their size
   DatatypeSet tree;		///< Datatypes within this factory (sorted by function)
   DatatypeNameSet nametree;	///< Cross-reference by name
+  unordered_multimap<uint8,Datatype *> hashindex;	///< Index of datatypes in \b tree keyed by structural hash
   Datatype *typecache[9][8];	///< Matrix of the most common atomic data-types
   Datatype *typecache10;	///< Specially cached 10-byte float type
   Datatype *typecache16;	///< Specially cached 16-byte float type
@@ -778,7 +804,11 @@ class TypeFactory {
   Datatype *charcache[5];	///< Cached character data-types
   list<DatatypeWarning> warnings;	///< Warnings for the user about data-types in \b this factory
   list<Datatype *> incompleteTypedef;	///< Incomplete data-types defined as a \e typedef
+  std::shared_ptr<const CoreTypeGroup> coreGroup;	///< If non-null, core types are owned by this shared group
+  mutable std::recursive_mutex factorylock;	///< Guards the data-type containers across decompiling threads
   Datatype *findNoName(Datatype &ct);	///< Find data-type (in this container) by function
+  void hashInsert(Datatype *ct);	///< Add the given data-type to the hash index
+  void hashErase(Datatype *ct);		///< Remove the given data-type from the hash index
   void insert(Datatype *newtype);	///< Insert pointer into the cross-reference sets
   Datatype *findAdd(Datatype &ct);	///< Find data-type in this container or add it
   void orderRecurse(vector<Datatype *> &deporder,DatatypeSet &mark,Datatype *ct) const;	///< Write out dependency list
@@ -853,6 +883,7 @@ public:
   void destroyType(Datatype *ct);				///< Remove a data-type from \b this
   Datatype *concretize(Datatype *ct);				///< Convert given data-type to concrete form
   void dependentOrder(vector<Datatype *> &deporder) const;	///< Place all data-types in dependency order
+  uint8 memoryEstimate(void) const;			///< Estimate heap bytes consumed by all data-types
   void encode(Encoder &encoder) const;			///< Encode \b this container to stream
   void encodeCoreTypes(Encoder &encoder) const;		///< Encode core types to stream
   void decode(Decoder &decoder);			///< Decode \b this from a \<typegrp> element
@@ -861,6 +892,8 @@ public:
   void parseEnumConfig(Decoder &decoder);		///< Parse the \<enum> tag
   void setCoreType(const string &name,int4 size,type_metatype meta,bool chartp);	///< Create a core data-type
   void cacheCoreTypes(void);				///< Cache common types
+  std::shared_ptr<const CoreTypeGroup> donateCoreTypes(void);	///< Move ownership of core types into a shareable group
+  void adoptCoreTypes(std::shared_ptr<const CoreTypeGroup> group);	///< Share core types built by another factory
   list<DatatypeWarning>::const_iterator beginWarnings(void) const { return warnings.begin(); }	///< Start of data-type warnings
   list<DatatypeWarning>::const_iterator endWarnings(void) const { return warnings.end(); }	///< End of data-type warnings
 #ifdef TYPEPROP_DEBUG
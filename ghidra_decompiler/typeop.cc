@@ -244,7 +244,7 @@ TypeOp::TypeOp(TypeFactory *t,OpCode opc,const string &n)
 TypeOp::~TypeOp(void)
 
 {
-  if (behave != (OpBehavior *)0)
+  if (behave != (OpBehavior *)0 && !behave->isShared())
     delete behave;
 }
 
@@ -391,7 +391,7 @@ TypeOpCopy::TypeOpCopy(TypeFactory *t) : TypeOp(t,CPUI_COPY,"copy")
 
 {
   opflags = PcodeOp::unary | PcodeOp::nocollapse;
-  behave = new OpBehaviorCopy();
+  behave = OpBehavior::getShared(CPUI_COPY);
 }
 
 Datatype *TypeOpCopy::getInputCast(const PcodeOp *op,int4 slot,const CastStrategy *castStrategy) const
@@ -434,7 +434,7 @@ TypeOpLoad::TypeOpLoad(TypeFactory *t) : TypeOp(t,CPUI_LOAD,"load")
 
 {
   opflags = PcodeOp::special | PcodeOp::nocollapse;
-  behave = new OpBehavior(CPUI_LOAD,false,true); // Dummy behavior
+  behave = OpBehavior::getShared(CPUI_LOAD); // Dummy behavior
 }
 
 Datatype *TypeOpLoad::getInputCast(const PcodeOp *op,int4 slot,const CastStrategy *castStrategy) const
@@ -514,7 +514,7 @@ TypeOpStore::TypeOpStore(TypeFactory *t) : TypeOp(t,CPUI_STORE,"store")
 
 {
   opflags = PcodeOp::special | PcodeOp::nocollapse;
-  behave = new OpBehavior(CPUI_STORE,false,true); // Dummy behavior
+  behave = OpBehavior::getShared(CPUI_STORE); // Dummy behavior
 }
 
 Datatype *TypeOpStore::getInputCast(const PcodeOp *op,int4 slot,const CastStrategy *castStrategy) const
@@ -584,7 +584,7 @@ TypeOpBranch::TypeOpBranch(TypeFactory *t) : TypeOp(t,CPUI_BRANCH,"goto")
 
 {
   opflags = (PcodeOp::special|PcodeOp::branch|PcodeOp::coderef|PcodeOp::nocollapse);
-  behave = new OpBehavior(CPUI_BRANCH,false,true); // Dummy behavior
+  behave = OpBehavior::getShared(CPUI_BRANCH); // Dummy behavior
 }
 
 void TypeOpBranch::printRaw(ostream &s,const PcodeOp *op)
@@ -603,7 +603,7 @@ TypeOpCbranch::TypeOpCbranch(TypeFactory *t) : TypeOp(t,CPUI_CBRANCH,"goto")
 
 {
   opflags = (PcodeOp::special|PcodeOp::branch|PcodeOp::coderef|PcodeOp::nocollapse);
-  behave = new OpBehavior(CPUI_CBRANCH,false,true); // Dummy behavior
+  behave = OpBehavior::getShared(CPUI_CBRANCH); // Dummy behavior
 }
 
 Datatype *TypeOpCbranch::getInputLocal(const PcodeOp *op,int4 slot) const
@@ -647,7 +647,7 @@ TypeOpBranchind::TypeOpBranchind(TypeFactory *t) : TypeOp(t,CPUI_BRANCHIND,"swit
 
 {
   opflags = PcodeOp::special|PcodeOp::branch|PcodeOp::nocollapse;
-  behave = new OpBehavior(CPUI_BRANCHIND,false,true); // Dummy behavior
+  behave = OpBehavior::getShared(CPUI_BRANCHIND); // Dummy behavior
 }
 
 void TypeOpBranchind::printRaw(ostream &s,const PcodeOp *op)
@@ -661,7 +661,7 @@ TypeOpCall::TypeOpCall(TypeFactory *t) : TypeOp(t,CPUI_CALL,"call")
 
 {
   opflags = (PcodeOp::special|PcodeOp::call|PcodeOp::has_callspec|PcodeOp::coderef|PcodeOp::nocollapse);
-  behave = new OpBehavior(CPUI_CALL,false,true); // Dummy behavior
+  behave = OpBehavior::getShared(CPUI_CALL); // Dummy behavior
 }
 
 void TypeOpCall::printRaw(ostream &s,const PcodeOp *op)
@@ -739,7 +739,7 @@ TypeOpCallind::TypeOpCallind(TypeFactory *t) : TypeOp(t,CPUI_CALLIND,"callind")
 
 {
   opflags = PcodeOp::special|PcodeOp::call|PcodeOp::has_callspec|PcodeOp::nocollapse;
-  behave = new OpBehavior(CPUI_CALLIND,false,true); // Dummy behavior
+  behave = OpBehavior::getShared(CPUI_CALLIND); // Dummy behavior
 }
 
 Datatype *TypeOpCallind::getInputLocal(const PcodeOp *op,int4 slot) const
@@ -812,7 +812,7 @@ TypeOpCallother::TypeOpCallother(TypeFactory *t) : TypeOp(t,CPUI_CALLOTHER,"sysc
 
 {
   opflags = PcodeOp::special|PcodeOp::call|PcodeOp::nocollapse;
-  behave = new OpBehavior(CPUI_CALLOTHER,false,true); // Dummy behavior
+  behave = OpBehavior::getShared(CPUI_CALLOTHER); // Dummy behavior
 }
 
 void TypeOpCallother::printRaw(ostream &s,const PcodeOp *op)
@@ -876,7 +876,7 @@ TypeOpReturn::TypeOpReturn(TypeFactory *t) : TypeOp(t,CPUI_RETURN,"return")
 
 {
   opflags = PcodeOp::special|PcodeOp::returns|PcodeOp::nocollapse|PcodeOp::return_copy;
-  behave = new OpBehavior(CPUI_RETURN,false,true); // Dummy behavior
+  behave = OpBehavior::getShared(CPUI_RETURN); // Dummy behavior
 }
 
 void TypeOpReturn::printRaw(ostream &s,const PcodeOp *op)
@@ -926,7 +926,7 @@ TypeOpEqual::TypeOpEqual(TypeFactory *t)
 {
   opflags = PcodeOp::binary | PcodeOp::booloutput | PcodeOp::commutative;
   addlflags = inherits_sign;
-  behave = new OpBehaviorEqual();
+  behave = OpBehavior::getShared(CPUI_INT_EQUAL);
 }
 
 Datatype *TypeOpEqual::getInputCast(const PcodeOp *op,int4 slot,const CastStrategy *castStrategy) const
@@ -990,7 +990,7 @@ TypeOpNotEqual::TypeOpNotEqual(TypeFactory *t)
 {
   opflags = PcodeOp::binary | PcodeOp::booloutput | PcodeOp::commutative;
   addlflags = inherits_sign;
-  behave = new OpBehaviorNotEqual();
+  behave = OpBehavior::getShared(CPUI_INT_NOTEQUAL);
 }
 
 Datatype *TypeOpNotEqual::getInputCast(const PcodeOp *op,int4 slot,const CastStrategy *castStrategy) const
@@ -1017,7 +1017,7 @@ TypeOpIntSless::TypeOpIntSless(TypeFactory *t)
 {
   opflags = PcodeOp::binary | PcodeOp::booloutput;
   addlflags = inherits_sign;
-  behave = new OpBehaviorIntSless();
+  behave = OpBehavior::getShared(CPUI_INT_SLESS);
 }
 
 Datatype *TypeOpIntSless::getInputCast(const PcodeOp *op,int4 slot,const CastStrategy *castStrategy) const
@@ -1043,7 +1043,7 @@ TypeOpIntSlessEqual::TypeOpIntSlessEqual(TypeFactory *t)
 {
   opflags = PcodeOp::binary | PcodeOp::booloutput;
   addlflags = inherits_sign;
-  behave = new OpBehaviorIntSlessEqual();
+  behave = OpBehavior::getShared(CPUI_INT_SLESSEQUAL);
 }
 
 Datatype *TypeOpIntSlessEqual::getInputCast(const PcodeOp *op,int4 slot,const CastStrategy *castStrategy) const
@@ -1069,7 +1069,7 @@ TypeOpIntLess::TypeOpIntLess(TypeFactory *t)
 {
   opflags = PcodeOp::binary | PcodeOp::booloutput;
   addlflags = inherits_sign;
-  behave = new OpBehaviorIntLess();
+  behave = OpBehavior::getShared(CPUI_INT_LESS);
 }
 
 Datatype *TypeOpIntLess::getInputCast(const PcodeOp *op,int4 slot,const CastStrategy *castStrategy) const
@@ -1093,7 +1093,7 @@ TypeOpIntLessEqual::TypeOpIntLessEqual(TypeFactory *t)
 {
   opflags = PcodeOp::binary | PcodeOp::booloutput;
   addlflags = inherits_sign;
-  behave = new OpBehaviorIntLessEqual();
+  behave = OpBehavior::getShared(CPUI_INT_LESSEQUAL);
 }
 
 Datatype *TypeOpIntLessEqual::getInputCast(const PcodeOp *op,int4 slot,const CastStrategy *castStrategy) const
@@ -1116,7 +1116,7 @@ TypeOpIntZext::TypeOpIntZext(TypeFactory *t)
   : TypeOpFunc(t,CPUI_INT_ZEXT,"ZEXT",TYPE_UINT,TYPE_UINT)
 {
   opflags = PcodeOp::unary;
-  behave = new OpBehaviorIntZext();
+  behave = OpBehavior::getShared(CPUI_INT_ZEXT);
 }
 
 string TypeOpIntZext::getOperatorName(const PcodeOp *op) const
@@ -1142,7 +1142,7 @@ TypeOpIntSext::TypeOpIntSext(TypeFactory *t)
   : TypeOpFunc(t,CPUI_INT_SEXT,"SEXT",TYPE_INT,TYPE_INT)
 {
   opflags = PcodeOp::unary;
-  behave = new OpBehaviorIntSext();
+  behave = OpBehavior::getShared(CPUI_INT_SEXT);
 }
 
 string TypeOpIntSext::getOperatorName(const PcodeOp *op) const
@@ -1169,7 +1169,7 @@ TypeOpIntAdd::TypeOpIntAdd(TypeFactory *t)
 {
   opflags = PcodeOp::binary | PcodeOp::commutative;
   addlflags = arithmetic_op | inherits_sign;
-  behave = new OpBehaviorIntAdd();
+  behave = OpBehavior::getShared(CPUI_INT_ADD);
 }
 
 Datatype *TypeOpIntAdd::getOutputToken(const PcodeOp *op,CastStrategy *castStrategy) const
@@ -1320,7 +1320,7 @@ TypeOpIntSub::TypeOpIntSub(TypeFactory *t)
 {
   opflags = PcodeOp::binary;
   addlflags = arithmetic_op | inherits_sign;
-  behave = new OpBehaviorIntSub();
+  behave = OpBehavior::getShared(CPUI_INT_SUB);
 }
 
 Datatype *TypeOpIntSub::getOutputToken(const PcodeOp *op,CastStrategy *castStrategy) const
@@ -1334,7 +1334,7 @@ TypeOpIntCarry::TypeOpIntCarry(TypeFactory *t)
 {
   opflags = PcodeOp::binary | PcodeOp::commutative | PcodeOp::booloutput;
   addlflags = arithmetic_op;
-  behave = new OpBehaviorIntCarry();
+  behave = OpBehavior::getShared(CPUI_INT_CARRY);
 }
 
 string TypeOpIntCarry::getOperatorName(const PcodeOp *op) const
@@ -1350,7 +1350,7 @@ TypeOpIntScarry::TypeOpIntScarry(TypeFactory *t)
 {
   opflags = PcodeOp::binary | PcodeOp::commutative | PcodeOp::booloutput;
   addlflags = arithmetic_op;
-  behave = new OpBehaviorIntScarry();
+  behave = OpBehavior::getShared(CPUI_INT_SCARRY);
 }
 
 string TypeOpIntScarry::getOperatorName(const PcodeOp *op) const
@@ -1366,7 +1366,7 @@ TypeOpIntSborrow::TypeOpIntSborrow(TypeFactory *t)
 {
   opflags = PcodeOp::binary | PcodeOp::booloutput;
   addlflags = arithmetic_op;
-  behave = new OpBehaviorIntSborrow();
+  behave = OpBehavior::getShared(CPUI_INT_SBORROW);
 }
 
 string TypeOpIntSborrow::getOperatorName(const PcodeOp *op) const
@@ -1382,7 +1382,7 @@ TypeOpInt2Comp::TypeOpInt2Comp(TypeFactory *t)
 {
   opflags = PcodeOp::unary;
   addlflags = arithmetic_op | inherits_sign;
-  behave = new OpBehaviorInt2Comp();
+  behave = OpBehavior::getShared(CPUI_INT_2COMP);
 }
 
 Datatype *TypeOpInt2Comp::getOutputToken(const PcodeOp *op,CastStrategy *castStrategy) const
@@ -1396,7 +1396,7 @@ TypeOpIntNegate::TypeOpIntNegate(TypeFactory *t)
 {
   opflags = PcodeOp::unary;
   addlflags = logical_op | inherits_sign;
-  behave = new OpBehaviorIntNegate();
+  behave = OpBehavior::getShared(CPUI_INT_NEGATE);
 }
 
 Datatype *TypeOpIntNegate::getOutputToken(const PcodeOp *op,CastStrategy *castStrategy) const
@@ -1410,7 +1410,7 @@ TypeOpIntXor::TypeOpIntXor(TypeFactory *t)
 {
   opflags = PcodeOp::binary | PcodeOp::commutative;
   addlflags = logical_op | inherits_sign;
-  behave = new OpBehaviorIntXor();
+  behave = OpBehavior::getShared(CPUI_INT_XOR);
 }
 
 Datatype *TypeOpIntXor::getOutputToken(const PcodeOp *op,CastStrategy *castStrategy) const
@@ -1443,7 +1443,7 @@ TypeOpIntAnd::TypeOpIntAnd(TypeFactory *t)
 {
   opflags = PcodeOp::binary | PcodeOp::commutative;
   addlflags = logical_op | inherits_sign;
-  behave = new OpBehaviorIntAnd();
+  behave = OpBehavior::getShared(CPUI_INT_AND);
 }
 
 Datatype *TypeOpIntAnd::getOutputToken(const PcodeOp *op,CastStrategy *castStrategy) const
@@ -1476,7 +1476,7 @@ TypeOpIntOr::TypeOpIntOr(TypeFactory *t)
 {
   opflags = PcodeOp::binary | PcodeOp::commutative;
   addlflags = logical_op | inherits_sign;
-  behave = new OpBehaviorIntOr();
+  behave = OpBehavior::getShared(CPUI_INT_OR);
 }
 
 Datatype *TypeOpIntOr::getOutputToken(const PcodeOp *op,CastStrategy *castStrategy) const
@@ -1504,7 +1504,7 @@ TypeOpIntLeft::TypeOpIntLeft(TypeFactory *t)
 {
   opflags = PcodeOp::binary;
   addlflags = inherits_sign | inherits_sign_zero | shift_op;
-  behave = new OpBehaviorIntLeft();
+  behave = OpBehavior::getShared(CPUI_INT_LEFT);
 }
 
 Datatype *TypeOpIntLeft::getInputLocal(const PcodeOp *op,int4 slot) const
@@ -1529,7 +1529,7 @@ TypeOpIntRight::TypeOpIntRight(TypeFactory *t)
 {
   opflags = PcodeOp::binary;
   addlflags = inherits_sign | inherits_sign_zero | shift_op;
-  behave = new OpBehaviorIntRight();
+  behave = OpBehavior::getShared(CPUI_INT_RIGHT);
 }
 
 Datatype *TypeOpIntRight::getInputLocal(const PcodeOp *op,int4 slot) const
@@ -1569,7 +1569,7 @@ TypeOpIntSright::TypeOpIntSright(TypeFactory *t)
 {
   opflags = PcodeOp::binary;
   addlflags = inherits_sign | inherits_sign_zero | shift_op;
-  behave = new OpBehaviorIntSright();
+  behave = OpBehavior::getShared(CPUI_INT_SRIGHT);
 }
 
 void TypeOpIntSright::printRaw(ostream &s,const PcodeOp *op)
@@ -1619,7 +1619,7 @@ TypeOpIntMult::TypeOpIntMult(TypeFactory *t)
 {
   opflags = PcodeOp::binary | PcodeOp::commutative;
   addlflags = arithmetic_op | inherits_sign;
-  behave = new OpBehaviorIntMult();
+  behave = OpBehavior::getShared(CPUI_INT_MULT);
 }
 
 Datatype *TypeOpIntMult::getOutputToken(const PcodeOp *op,CastStrategy *castStrategy) const
@@ -1633,7 +1633,7 @@ TypeOpIntDiv::TypeOpIntDiv(TypeFactory *t)
 {
   opflags = PcodeOp::binary;
   addlflags = arithmetic_op | inherits_sign;
-  behave = new OpBehaviorIntDiv();
+  behave = OpBehavior::getShared(CPUI_INT_DIV);
 }
 
 Datatype *TypeOpIntDiv::getInputCast(const PcodeOp *op,int4 slot,const CastStrategy *castStrategy) const
@@ -1653,7 +1653,7 @@ TypeOpIntSdiv::TypeOpIntSdiv(TypeFactory *t)
 {
   opflags = PcodeOp::binary;
   addlflags = arithmetic_op | inherits_sign;
-  behave = new OpBehaviorIntSdiv();
+  behave = OpBehavior::getShared(CPUI_INT_SDIV);
 }
 
 Datatype *TypeOpIntSdiv::getInputCast(const PcodeOp *op,int4 slot,const CastStrategy *castStrategy) const
@@ -1673,7 +1673,7 @@ TypeOpIntRem::TypeOpIntRem(TypeFactory *t)
 {
   opflags = PcodeOp::binary;
   addlflags = arithmetic_op | inherits_sign | inherits_sign_zero;
-  behave = new OpBehaviorIntRem();
+  behave = OpBehavior::getShared(CPUI_INT_REM);
 }
 
 Datatype *TypeOpIntRem::getInputCast(const PcodeOp *op,int4 slot,const CastStrategy *castStrategy) const
@@ -1693,7 +1693,7 @@ TypeOpIntSrem::TypeOpIntSrem(TypeFactory *t)
 {
   opflags = PcodeOp::binary;
   addlflags = arithmetic_op | inherits_sign | inherits_sign_zero;
-  behave = new OpBehaviorIntSrem();
+  behave = OpBehavior::getShared(CPUI_INT_SREM);
 }
 
 Datatype *TypeOpIntSrem::getInputCast(const PcodeOp *op,int4 slot,const CastStrategy *castStrategy) const
@@ -1713,7 +1713,7 @@ TypeOpBoolNegate::TypeOpBoolNegate(TypeFactory *t)
 {
   opflags = PcodeOp::unary | PcodeOp::booloutput;
   addlflags = logical_op;
-  behave = new OpBehaviorBoolNegate();
+  behave = OpBehavior::getShared(CPUI_BOOL_NEGATE);
 }
 
 TypeOpBoolXor::TypeOpBoolXor(TypeFactory *t)
@@ -1721,7 +1721,7 @@ TypeOpBoolXor::TypeOpBoolXor(TypeFactory *t)
 {
   opflags = PcodeOp::binary | PcodeOp::commutative | PcodeOp::booloutput;
   addlflags = logical_op;
-  behave = new OpBehaviorBoolXor();
+  behave = OpBehavior::getShared(CPUI_BOOL_XOR);
 }
 
 TypeOpBoolAnd::TypeOpBoolAnd(TypeFactory *t)
@@ -1729,7 +1729,7 @@ TypeOpBoolAnd::TypeOpBoolAnd(TypeFactory *t)
 {
   opflags = PcodeOp::binary | PcodeOp::commutative | PcodeOp::booloutput;
   addlflags = logical_op;
-  behave = new OpBehaviorBoolAnd();
+  behave = OpBehavior::getShared(CPUI_BOOL_AND);
 }
 
 TypeOpBoolOr::TypeOpBoolOr(TypeFactory *t)
@@ -1737,7 +1737,7 @@ TypeOpBoolOr::TypeOpBoolOr(TypeFactory *t)
 {
   opflags = PcodeOp::binary | PcodeOp::commutative | PcodeOp::booloutput;
   addlflags = logical_op;
-  behave = new OpBehaviorBoolOr();
+  behave = OpBehavior::getShared(CPUI_BOOL_OR);
 }
 
 TypeOpFloatEqual::TypeOpFloatEqual(TypeFactory *t,const Translate *trans)
@@ -1945,7 +1945,7 @@ TypeOpMulti::TypeOpMulti(TypeFactory *t) : TypeOp(t,CPUI_MULTIEQUAL,"?")
 
 {
   opflags = PcodeOp::special | PcodeOp::marker|PcodeOp::nocollapse;
-  behave = new OpBehavior(CPUI_MULTIEQUAL,false,true); // Dummy behavior
+  behave = OpBehavior::getShared(CPUI_MULTIEQUAL); // Dummy behavior
 }
 
 Datatype *TypeOpMulti::propagateType(Datatype *alttype,PcodeOp *op,Varnode *invn,Varnode *outvn,
@@ -1986,7 +1986,7 @@ TypeOpIndirect::TypeOpIndirect(TypeFactory *t) : TypeOp(t,CPUI_INDIRECT,"[]")
 
 {
   opflags = PcodeOp::special | PcodeOp::marker | PcodeOp::nocollapse;
-  behave = new OpBehavior(CPUI_INDIRECT,false,true); // Dummy behavior
+  behave = OpBehavior::getShared(CPUI_INDIRECT); // Dummy behavior
 }
 
 Datatype *TypeOpIndirect::getInputLocal(const PcodeOp *op,int4 slot) const
@@ -2038,7 +2038,7 @@ TypeOpPiece::TypeOpPiece(TypeFactory *t)
   : TypeOpFunc(t,CPUI_PIECE,"CONCAT",TYPE_UNKNOWN,TYPE_UNKNOWN)
 {
   opflags = PcodeOp::binary;
-  behave = new OpBehaviorPiece();
+  behave = OpBehavior::getShared(CPUI_PIECE);
   nearPointerSize = 0;
   farPointerSize = t->getSizeOfAltPointer();
   if (farPointerSize != 0)
@@ -2117,7 +2117,7 @@ TypeOpSubpiece::TypeOpSubpiece(TypeFactory *t)
   : TypeOpFunc(t,CPUI_SUBPIECE,"SUB",TYPE_UNKNOWN,TYPE_UNKNOWN)
 {
   opflags = PcodeOp::binary;
-  behave = new OpBehaviorSubpiece();
+  behave = OpBehavior::getShared(CPUI_SUBPIECE);
   nearPointerSize = 0;
   farPointerSize = t->getSizeOfAltPointer();
   if (farPointerSize != 0)
@@ -2210,7 +2210,7 @@ TypeOpCast::TypeOpCast(TypeFactory *t) : TypeOp(t,CPUI_CAST,"(cast)")
 
 {
   opflags = PcodeOp::unary | PcodeOp::special | PcodeOp::nocollapse;
-  behave = new OpBehavior(CPUI_CAST,false,true); // Dummy behavior
+  behave = OpBehavior::getShared(CPUI_CAST); // Dummy behavior
 }
 
 void TypeOpCast::printRaw(ostream &s,const PcodeOp *op)
@@ -2226,7 +2226,7 @@ TypeOpPtradd::TypeOpPtradd(TypeFactory *t) : TypeOp(t,CPUI_PTRADD,"+")
 {
   opflags = PcodeOp::ternary | PcodeOp::nocollapse;
   addlflags = arithmetic_op;
-  behave = new OpBehavior(CPUI_PTRADD,false); // Dummy behavior
+  behave = OpBehavior::getShared(CPUI_PTRADD); // Dummy behavior
 }
 
 Datatype *TypeOpPtradd::getInputLocal(const PcodeOp *op,int4 slot) const
@@ -2296,7 +2296,7 @@ TypeOpPtrsub::TypeOpPtrsub(TypeFactory *t) : TypeOp(t,CPUI_PTRSUB,"->")
 				// allow this to be commutative.
   opflags = PcodeOp::binary|PcodeOp::nocollapse;
   addlflags = arithmetic_op;
-  behave = new OpBehavior(CPUI_PTRSUB,false); // Dummy behavior
+  behave = OpBehavior::getShared(CPUI_PTRSUB); // Dummy behavior
 }
 
 Datatype *TypeOpPtrsub::getOutputLocal(const PcodeOp *op) const
@@ -2368,7 +2368,7 @@ TypeOpSegment::TypeOpSegment(TypeFactory *t) : TypeOp(t,CPUI_SEGMENTOP,"segmento
 
 {
   opflags = PcodeOp::special | PcodeOp::nocollapse;
-  behave = new OpBehavior(CPUI_SEGMENTOP,false,true); // Dummy behavior
+  behave = OpBehavior::getShared(CPUI_SEGMENTOP); // Dummy behavior
 }
 
 void TypeOpSegment::printRaw(ostream &s,const PcodeOp *op)
@@ -2422,7 +2422,7 @@ TypeOpCpoolref::TypeOpCpoolref(TypeFactory *t) : TypeOp(t,CPUI_CPOOLREF,"cpoolre
 {
   cpool = t->getArch()->cpool;
   opflags = PcodeOp::special | PcodeOp::nocollapse;
-  behave = new OpBehavior(CPUI_CPOOLREF,false,true); // Dummy behavior
+  behave = OpBehavior::getShared(CPUI_CPOOLREF); // Dummy behavior
 }
 
 Datatype *TypeOpCpoolref::getOutputLocal(const PcodeOp *op) const
@@ -2472,7 +2472,7 @@ TypeOpNew::TypeOpNew(TypeFactory *t) : TypeOp(t,CPUI_NEW,"new")
 
 {
   opflags = PcodeOp::special | PcodeOp::call | PcodeOp::nocollapse;
-  behave = new OpBehavior(CPUI_NEW,false,true);		// Dummy behavior
+  behave = OpBehavior::getShared(CPUI_NEW);		// Dummy behavior
 }
 
 Datatype *TypeOpNew::propagateType(Datatype *alttype,PcodeOp *op,Varnode *invn,Varnode *outvn,
@@ -2506,7 +2506,7 @@ TypeOpInsert::TypeOpInsert(TypeFactory *t)
   : TypeOpFunc(t,CPUI_INSERT,"INSERT",TYPE_UNKNOWN,TYPE_INT)
 {
   opflags = PcodeOp::ternary;
-  behave = new OpBehavior(CPUI_INSERT,false);	// Dummy behavior
+  behave = OpBehavior::getShared(CPUI_INSERT);	// Dummy behavior
 }
 
 Datatype *TypeOpInsert::getInputLocal(const PcodeOp *op,int4 slot) const
@@ -2521,7 +2521,7 @@ TypeOpExtract::TypeOpExtract(TypeFactory *t)
   : TypeOpFunc(t,CPUI_EXTRACT,"EXTRACT",TYPE_INT,TYPE_INT)
 {
   opflags = PcodeOp::ternary;
-  behave = new OpBehavior(CPUI_EXTRACT,false);	// Dummy behavior
+  behave = OpBehavior::getShared(CPUI_EXTRACT);	// Dummy behavior
 }
 
 Datatype *TypeOpExtract::getInputLocal(const PcodeOp *op,int4 slot) const
@@ -2536,14 +2536,14 @@ TypeOpPopcount::TypeOpPopcount(TypeFactory *t)
   : TypeOpFunc(t,CPUI_POPCOUNT,"POPCOUNT",TYPE_INT,TYPE_UNKNOWN)
 {
   opflags = PcodeOp::unary;
-  behave = new OpBehaviorPopcount();
+  behave = OpBehavior::getShared(CPUI_POPCOUNT);
 }
 
 TypeOpLzcount::TypeOpLzcount(TypeFactory *t)
   : TypeOpFunc(t,CPUI_LZCOUNT,"LZCOUNT",TYPE_INT,TYPE_UNKNOWN)
 {
   opflags = PcodeOp::unary;
-  behave = new OpBehaviorLzcount();
+  behave = OpBehavior::getShared(CPUI_LZCOUNT);
 }
 
 } // End namespace ghidra
@@ -79,7 +79,7 @@ public:
   /// \param in1 is the input value
   /// \return the output value
   uintb evaluateUnary(int4 sizeout,int4 sizein,uintb in1) const {
-    return behave->evaluateUnary(sizeout,sizein,in1); }
+    return OpBehavior::evaluateUnaryFast(behave,sizeout,sizein,in1); }
 
   /// \brief Emulate the binary op-code on an input value
   ///
@@ -89,7 +89,7 @@ public:
   /// \param in2 is the second input value
   /// \return the output value
   uintb evaluateBinary(int4 sizeout,int4 sizein,uintb in1,uintb in2) const {
-    return behave->evaluateBinary(sizeout,sizein,in1,in2); }
+    return OpBehavior::evaluateBinaryFast(behave,sizeout,sizein,in1,in2); }
 
   /// \brief Reverse the binary op-code operation, recovering a constant input value
   ///
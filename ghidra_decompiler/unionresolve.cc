@@ -76,6 +76,19 @@ ResolveEdge::ResolveEdge(const Datatype *parent,const PcodeOp *op,int4 slot)
     typeId = parent->getId();
 }
 
+/// The base data-type id and slot encoding are taken as previously encoded values,
+/// typically salvaged from an edge that did not survive a restart of analysis.
+/// \param id is the id of the base data-type being resolved
+/// \param op is the PcodeOp component of the edge
+/// \param code is the previously encoded slot and pointer-ness
+ResolveEdge::ResolveEdge(uint8 id,const PcodeOp *op,int4 code)
+
+{
+  typeId = id;
+  opTime = op->getTime();
+  encoding = code;
+}
+
 const int4 ScoreUnionFields::threshold = 256;
 const int4 ScoreUnionFields::maxPasses = 6;
 const int4 ScoreUnionFields::maxTrials = 1024;
@@ -63,6 +63,11 @@ class ResolveEdge {
   int4 encoding;		///< Encoding of the slot and pointer-ness
 public:
   ResolveEdge(const Datatype *parent,const PcodeOp *op,int4 slot);	///< Construct from components
+  ResolveEdge(uint8 id,const PcodeOp *op,int4 code);		///< Construct from a salvaged encoding
+  uint8 getTypeId(void) const { return typeId; }	///< Get the id of the base data-type being resolved
+  int4 getEncoding(void) const { return encoding; }	///< Get the encoding of the slot and pointer-ness
+  int4 getSlot(void) const;				///< Get the slot component of \b this edge
+  uintm getOpTime(void) const { return opTime; }	///< Get the id of the PcodeOp component of \b this edge
   bool operator<(const ResolveEdge &op2) const;			///< Compare two edges
 };
 
@@ -169,6 +174,15 @@ public:
 /// Compare based on the data-type, the \b slot, and the PcodeOp's unique id.
 /// \param op2 is the other edge to compare with \b this
 /// \return \b true if \b this should be ordered before the other edge
+/// Undo the pointer-ness marker added by the constructor.  The marker can only collide
+/// with an unmarked slot of 0xfff or greater, which never occurs in practice.
+/// \return the slot of the edge (-1 for the write edge)
+inline int4 ResolveEdge::getSlot(void) const
+
+{
+  return (encoding >= 0xfff) ? encoding - 0x1000 : encoding;
+}
+
 inline bool ResolveEdge::operator<(const ResolveEdge &op2) const
 
 {
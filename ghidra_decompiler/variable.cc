@@ -656,8 +656,11 @@ void HighVariable::mergeInternal(HighVariable *tv2,bool isspeculative)
   std::merge(instcopy.begin(),instcopy.end(),tv2->inst.begin(),tv2->inst.end(),inst.begin(),compareJustLoc);
   tv2->inst.clear();
 
-  if (((highflags&coverdirty)==0)&&((tv2->highflags&coverdirty)==0))
+  if ((highflags&coverdirty)==0) {
+    if ((tv2->highflags&coverdirty)!=0)
+      tv2->updateInternalCover();	// Rebuild the (smaller) incoming cover, rather than dirtying the union
     internalCover.merge(tv2->internalCover);
+  }
   else
     highflags |= coverdirty;
 
@@ -15,6 +15,7 @@
  */
 #include "varmap.hh"
 #include "funcdata.hh"
+#include "crc32.hh"
 
 namespace ghidra {
 
@@ -347,8 +348,17 @@ ScopeLocal::ScopeLocal(uint8 id,AddrSpace *spc,Funcdata *fd,Architecture *g) : S
   rangeLocked = false;
   stackGrowsNegative = true;
   overlapProblems = false;
+  restructureHash = 0;
+  restructureValid = false;
   restrictScope(fd);
-} 
+}
+
+void ScopeLocal::clear(void)
+
+{
+  restructureValid = false;
+  ScopeInternal::clear();
+}
 
 /// Turn any symbols that are \e name \e locked but not \e type \e locked into name recommendations
 /// removing the symbol in the process.  This allows the decompiler to decide on how the stack is layed
@@ -380,6 +390,28 @@ void ScopeLocal::collectNameRecs(void)
   }
 }
 
+/// Record the data-type of any fully unlocked Symbol with a fixed storage location as a
+/// type recommendation, in preparation for the Symbol being cleared.  If the restarted
+/// analysis recreates a variable at the same storage, the recommendation re-seeds type
+/// propagation with the previously inferred data-type; otherwise it goes unused.
+void ScopeLocal::collectTypeRecs(void)
+
+{
+  typeRecommend.clear();	// Clear out any old recommendations
+
+  SymbolNameTree::iterator iter = nametree.begin();
+  while(iter!=nametree.end()) {
+    Symbol *sym = *iter++;
+    if (sym->isNameLocked() || sym->isTypeLocked()) continue;	// Locked symbols survive the clear
+    Datatype *ct = sym->getType();
+    if (ct == (Datatype *)0 || ct->getMetatype() == TYPE_UNKNOWN) continue;
+    SymbolEntry *entry = sym->getFirstWholeMap();
+    if (entry == (SymbolEntry *)0 || entry->isDynamic()) continue;
+    if (entry->getSize() != ct->getSize()) continue;
+    addTypeRecommendation(entry->getAddr(),ct);
+  }
+}
+
 /// For any read of the input stack pointer by a non-additive p-code op, assume this constitutes a
 /// a zero offset reference into the stack frame.  Replace the raw Varnode with the standard
 /// spacebase placeholder, PTRSUB(sp,#0), so that the data-type system can treat it as a reference.
@@ -511,6 +543,7 @@ void ScopeLocal::markNotMapped(AddrSpace *spc,uintb first,int4 sz,bool parameter
 
 {
   if (space != spc) return;
+  restructureValid = false;	// Removing ranges changes what the next restructure would build
   uintb last = first + sz - 1;
   // Do not allow the range to cover the split point between "negative" and "positive" stack offsets
   if (last < first)		// Check for possible wrap around
@@ -1039,7 +1072,9 @@ void MapState::addGuard(const LoadGuard &guard,OpCode opc,TypeFactory *typeFacto
 }
 
 /// Run through all Symbols in the given map and create a corresponding RangeHint
-/// to \b this collection for each Symbol.
+/// to \b this collection for each Symbol.  Unlocked Symbols that restructuring
+/// clears before rebuilding are skipped, so the collection comes out the same
+/// whether it is gathered before or after that clear.
 /// \param rangemap is the given map of Symbols
 void MapState::gatherSymbols(const EntryMap *rangemap)
 
@@ -1050,6 +1085,7 @@ void MapState::gatherSymbols(const EntryMap *rangemap)
   for(riter=rangemap->begin_list();riter!=rangemap->end_list();++riter) {
     sym = (*riter).getSymbol();
     if (sym == (Symbol *)0) continue;
+    if (sym->getCategory() < 0 && !sym->isTypeLocked()) continue;	// Destined for removal before any rebuild
     //    if ((*iter).isPiece()) continue;     // This should probably never happen
     uintb start = (*riter).getAddr().getOffset();
     Datatype *ct = sym->getType();
@@ -1081,6 +1117,36 @@ bool MapState::initialize(void)
   return true;
 }
 
+/// A CRC32 is computed across every collected hint and the boundary of the analyzed
+/// range.  Because gathering is deterministic, two collections over an unchanged
+/// function produce the same byte sequence, so matching hashes (modulo collisions)
+/// indicate the restructured symbol map would come out the same.
+/// \return the hash of the collection
+uint4 MapState::hashRanges(void) const
+
+{
+  uint4 reg = 0xffffffff;
+  const Range *lastrange = range.getLastSignedRange(spaceid);
+  if (lastrange != (const Range *)0) {
+    uintb first = lastrange->getFirst();
+    uintb last = lastrange->getLast();
+    reg = crc_update_bytes(reg,(const uint1 *)&first,sizeof(first));
+    reg = crc_update_bytes(reg,(const uint1 *)&last,sizeof(last));
+  }
+  vector<RangeHint *>::const_iterator riter;
+  for(riter=maplist.begin();riter!=maplist.end();++riter) {
+    const RangeHint *hint = *riter;
+    reg = crc_update_bytes(reg,(const uint1 *)&hint->start,sizeof(hint->start));
+    reg = crc_update_bytes(reg,(const uint1 *)&hint->size,sizeof(hint->size));
+    reg = crc_update_bytes(reg,(const uint1 *)&hint->flags,sizeof(hint->flags));
+    reg = crc_update_bytes(reg,(const uint1 *)&hint->rangeType,sizeof(hint->rangeType));
+    reg = crc_update_bytes(reg,(const uint1 *)&hint->highind,sizeof(hint->highind));
+    uint8 id = hint->type->getId();
+    reg = crc_update_bytes(reg,(const uint1 *)&id,sizeof(id));
+  }
+  return reg ^ 0xffffffff;
+}
+
 /// Filter out INDIRECT, MULTIEQUAL, and PIECE operations that are just copying between the same storage location.
 /// If there is another operation reading the Varnode, return \b true, otherwise return \b false.
 /// \param vn is the given Varnode to test
@@ -1248,18 +1314,47 @@ void MapState::gatherOpen(const Funcdata &fd)
     addGuard(*siter,CPUI_STORE,typeFactory);
 }
 
+/// The hash combines the gathered RangeHints with the unlocked Symbols the previous
+/// restructure created.  If both match, the rebuild would reproduce the symbol map
+/// that is already in place and can be skipped.
+/// \param state is the gathered collection of RangeHints
+/// \return the combined hash
+uint4 ScopeLocal::hashLayout(const MapState &state) const
+
+{
+  uint4 reg = state.hashRanges();
+  const EntryMap *rangemap = maptable[space->getIndex()];
+  if (rangemap == (const EntryMap *)0) return reg;
+  list<SymbolEntry>::const_iterator iter;
+  for(iter=rangemap->begin_list();iter!=rangemap->end_list();++iter) {
+    const SymbolEntry &entry(*iter);
+    Symbol *sym = entry.getSymbol();
+    if (sym == (Symbol *)0) continue;
+    if (sym->getCategory() >= 0 || sym->isTypeLocked()) continue;	// Already hashed as a hint
+    uintb off = entry.getAddr().getOffset();
+    int4 sz = entry.getSize();
+    reg = crc_update_bytes(reg,(const uint1 *)&off,sizeof(off));
+    reg = crc_update_bytes(reg,(const uint1 *)&sz,sizeof(sz));
+    uint8 id = sym->getType()->getId();
+    reg = crc_update_bytes(reg,(const uint1 *)&id,sizeof(id));
+  }
+  return reg;
+}
+
 /// Define stack Symbols based on Varnodes.
 /// This method can be called repeatedly during decompilation. It helps propagate data-types.
+/// The hints gathered for the rebuild are hashed first; if they match the previous
+/// invocation and the symbol map hasn't been disturbed since, the existing map is
+/// already what the rebuild would produce and the expensive clear/restructure is skipped.
 /// Unaliased symbols can optionally be marked to facilitate removal of INDIRECT ops, but
 /// this is generally done later in the process.
 /// \param aliasyes is \b true if unaliased Symbols should be marked
 void ScopeLocal::restructureVarnode(bool aliasyes)
 
 {
-  clearUnlockedCategory(-1);	// Clear out any unlocked entries
   MapState state(space,getRangeTree(),fd->getFuncProto().getParamRange(),
 		  glb->types->getBase(1,TYPE_UNKNOWN)); // Organize list of ranges to insert
-    
+
 #ifdef OPACTION_DEBUG
   if (debugon)
     state.turnOnDebug(glb);
@@ -1267,7 +1362,13 @@ void ScopeLocal::restructureVarnode(bool aliasyes)
   state.gatherVarnodes(*fd); // Gather stack type information from varnodes
   state.gatherOpen(*fd);
   state.gatherSymbols(maptable[space->getIndex()]);
-  overlapProblems = restructure(state);
+  uint4 hash = hashLayout(state);
+  if (!restructureValid || hash != restructureHash) {
+    clearUnlockedCategory(-1);	// Clear out any unlocked entries
+    overlapProblems = restructure(state);
+    restructureHash = hashLayout(state);	// Rehash against the freshly built map
+    restructureValid = true;
+  }
 
   // At some point, processing mapped input symbols may be folded
   // into the above gather/restructure process, but for now
@@ -193,6 +193,7 @@ public:
   MapState(AddrSpace *spc,const RangeList &rn,const RangeList &pm,Datatype *dt);	///< Constructor
   ~MapState(void);		///< Destructor
   bool initialize(void);	///< Initialize the hint collection for iteration
+  uint4 hashRanges(void) const;	///< Compute a hash of the collected hints
   void sortAlias(void) { checker.sortAlias(); }		///< Sort the alias starting offsets
   const vector<uintb> &getAlias(void) { return checker.getAlias(); }	///< Get the list of alias starting offsets
   void gatherSymbols(const EntryMap *rangemap);		///< Add Symbol information as hints to the collection
@@ -219,6 +220,9 @@ class ScopeLocal : public ScopeInternal {
   bool stackGrowsNegative;	///< Marked \b true if the stack is considered to \e grow towards smaller offsets
   bool rangeLocked;		///< True if the subset of addresses \e mapped to \b this scope has been locked
   bool overlapProblems;		///< True if the last \b restructure had overlapping variable problems
+  uint4 restructureHash;	///< Hash of the inputs to the last \b restructure
+  bool restructureValid;	///< True if the symbol map still matches \b restructureHash
+  uint4 hashLayout(const MapState &state) const;	///< Hash restructure inputs and the unlocked Symbols they produced
   bool adjustFit(RangeHint &a) const;	///< Make the given RangeHint fit in the current Symbol map
   void createEntry(const RangeHint &a);	///< Create a Symbol entry corresponding to the given (fitted) RangeHint
   bool restructure(MapState &state);	///< Merge hints into a formal Symbol layout of the address space
@@ -248,6 +252,7 @@ public:
   void markNotMapped(AddrSpace *spc,uintb first,int4 sz,bool param);	///< Mark a specific address range is not mapped
 
 				// Routines that are specific to one address space
+  virtual void clear(void);
   virtual void encode(Encoder &encoder) const;
   virtual void decode(Decoder &decoder);
   virtual void decodeWrappingAttributes(Decoder &decoder);
@@ -261,6 +266,7 @@ public:
   SymbolEntry *remapSymbolDynamic(Symbol *sym,uint8 hash,const Address &usepoint);
   void recoverNameRecommendationsForSymbols(void);
   void applyTypeRecommendations(void);		///< Try to apply recommended data-type information
+  void collectTypeRecs(void);		///< Collect data-types resolved for unlocked Symbols
   bool hasTypeRecommendations(void) const { return !typeRecommend.empty(); }	///< Are there data-type recommendations
   void addTypeRecommendation(const Address &addr,Datatype *dt);		///< Add a new data-type recommendation
 };
@@ -36,7 +36,8 @@ inline bool VarnodeCompareLocDef::operator()(const Varnode *a,const Varnode *b)
 {
   uint4 f1,f2;
 
-  if (a->getAddr() != b->getAddr()) return (a->getAddr() < b->getAddr());
+  if (a->spcindex != b->spcindex) return (a->spcindex < b->spcindex);
+  if (a->getOffset() != b->getOffset()) return (a->getOffset() < b->getOffset());
   if (a->getSize() != b->getSize()) return (a->getSize() < b->getSize());
   f1 = a->getFlags()&(Varnode::input|Varnode::written);
   f2 = b->getFlags()&(Varnode::input|Varnode::written);
@@ -70,7 +71,8 @@ inline bool VarnodeCompareDefLoc::operator()(const Varnode *a,const Varnode *b)
     if (a->getDef()->getSeqNum() != b->getDef()->getSeqNum())
       return (a->getDef()->getSeqNum() < b->getDef()->getSeqNum());
   }
-  if (a->getAddr() != b->getAddr()) return (a->getAddr() < b->getAddr());
+  if (a->spcindex != b->spcindex) return (a->spcindex < b->spcindex);
+  if (a->getOffset() != b->getOffset()) return (a->getOffset() < b->getOffset());
   if (a->getSize() != b->getSize()) return (a->getSize() < b->getSize());
   if (f1==0)			// both are free
     //    return (a<b);		// Compare pointers
@@ -322,6 +324,7 @@ void Varnode::eraseDescend(PcodeOp *op)
   while (*iter != op)		// Find this op in list of vn's descendants
     iter++;
   descend.erase(iter);		// Remove it from list
+  lonedescend = (descend.size() == 1) ? descend.front() : (PcodeOp *)0;
   setFlags(Varnode::coverdirty);
 }
 
@@ -336,6 +339,7 @@ void Varnode::addDescend(PcodeOp *op)
       throw LowlevelError("Free varnode has multiple descendants");
   }
   descend.push_back(op);
+  lonedescend = (descend.size() == 1) ? op : (PcodeOp *)0;
   setFlags(Varnode::coverdirty);
 }
 
@@ -345,6 +349,7 @@ void Varnode::destroyDescend(void)
 
 {
   descend.clear();
+  lonedescend = (PcodeOp *)0;
 }
 
 /// Set desired boolean attributes on this Varnode and then set dirty bits if appropriate
@@ -579,7 +584,9 @@ Varnode::Varnode(int4 s,const Address &m,Datatype *dt)
   : loc(m)
 {				// Construct a varnode
   size = s;
+  updateSpaceIndex();
   def = (PcodeOp *)0;		// No defining op yet
+  lonedescend = (PcodeOp *)0;	// No reading ops yet
   type = dt;
   high = (HighVariable *)0;
   mapentry = (SymbolEntry *)0;
@@ -671,23 +678,6 @@ Datatype *Varnode::getHighTypeReadFacing(const PcodeOp *op) const
   return ct->findResolve(op, op->getSlot(this));
 }
 
-/// This is a convenience method for quickly finding the unique PcodeOp that reads this Varnode
-/// \return only descendant (if there is 1 and ONLY 1) or \b null otherwise
-PcodeOp *Varnode::loneDescend(void) const
-
-{
-  PcodeOp *op;
-
-  if (descend.empty()) return (PcodeOp *)0; // No descendants
-
-  list<PcodeOp *>::const_iterator iter;
-
-  iter = descend.begin();
-  op = *iter++;			// First descendant
-  if (iter != descend.end()) return (PcodeOp *)0; // More than 1 descendant
-  return op;
-}
-
 /// A Varnode can be defined as "coming into scope" at the Address of the first PcodeOp that
 /// writes to that storage location.  Within SSA form this \b first-use address always exists and
 /// is unique if we consider inputs to come into scope at the start Address of the function they are in
@@ -1233,8 +1223,9 @@ void VarnodeBank::clear(void)
   VarnodeLocSet::iterator iter;
 
   for(iter=loc_tree.begin();iter!=loc_tree.end();++iter)
-    delete *iter;
+    (*iter)->~Varnode();	// Storage is reclaimed wholesale by the pool
 
+  pool.reset();
   loc_tree.clear();
   def_tree.clear();
   uniqid = uniqbase;		// Reset counter to base value
@@ -1250,7 +1241,7 @@ void VarnodeBank::clear(void)
 Varnode *VarnodeBank::create(int4 s,const Address &m,Datatype *ct)
 
 {
-  Varnode *vn = new Varnode(s,m,ct);
+  Varnode *vn = new(pool.allocate()) Varnode(s,m,ct);
   
   vn->create_index = create_index++;
   vn->lociter = loc_tree.insert(vn).first; // Frees can always be inserted without duplication
@@ -1281,7 +1272,7 @@ void VarnodeBank::destroy(Varnode *vn)
 
   loc_tree.erase(vn->lociter);
   def_tree.erase(vn->defiter);
-  delete vn;
+  pool.destroy(vn);
 }
 
 /// Enter the Varnode into both the \e location and \e definition based trees.
@@ -1298,7 +1289,7 @@ Varnode *VarnodeBank::xref(Varnode *vn)
   if (!check.second) {		// Set already contains this varnode
     othervn = *(check.first);
     replace(vn,othervn); // Patch ops using the old varnode
-    delete vn;
+    pool.destroy(vn);
     return othervn;
   }
 				// Otherwise a new insertion
@@ -1347,6 +1338,7 @@ void VarnodeBank::replace(Varnode *oldvn,Varnode *newvn)
     newvn->addDescend(op);
     op->setInput(newvn,i); // This must be called AFTER descend is updated
   }
+  oldvn->lonedescend = (oldvn->descend.size() == 1) ? oldvn->descend.front() : (PcodeOp *)0;
   oldvn->setFlags(Varnode::coverdirty);
   newvn->setFlags(Varnode::coverdirty);
 }
@@ -1411,7 +1403,7 @@ Varnode *VarnodeBank::setDef(Varnode *vn,PcodeOp *op)
 Varnode *VarnodeBank::createDef(int4 s,const Address &m, Datatype *ct,PcodeOp *op)
 
 {
-  Varnode *vn = new Varnode(s,m,ct);
+  Varnode *vn = new(pool.allocate()) Varnode(s,m,ct);
   vn->create_index = create_index++;
   vn->setDef(op);
   return xref(vn);
@@ -1538,6 +1530,7 @@ VarnodeLocSet::const_iterator VarnodeBank::beginLoc(AddrSpace *spaceid) const
 
 {
   searchvn.loc = Address(spaceid,0);
+  searchvn.updateSpaceIndex();
   return loc_tree.lower_bound(&searchvn);
 }
 
@@ -1549,6 +1542,7 @@ VarnodeLocSet::const_iterator VarnodeBank::endLoc(AddrSpace *spaceid) const
 
 {
   searchvn.loc = Address(manage->getNextSpaceInOrder(spaceid),0);
+  searchvn.updateSpaceIndex();
   return loc_tree.lower_bound(&searchvn);
 }
 
@@ -1560,6 +1554,7 @@ VarnodeLocSet::const_iterator VarnodeBank::beginLoc(const Address &addr) const
 
 {
   searchvn.loc = addr;
+  searchvn.updateSpaceIndex();
   return loc_tree.lower_bound(&searchvn);
 }
 
@@ -1573,9 +1568,12 @@ VarnodeLocSet::const_iterator VarnodeBank::endLoc(const Address &addr) const
   if (addr.getOffset() == addr.getSpace()->getHighest()) {
     AddrSpace* space = addr.getSpace();
     searchvn.loc = Address(manage->getNextSpaceInOrder(space),0);
+    searchvn.updateSpaceIndex();
   }
-  else
+  else {
     searchvn.loc = addr+1;
+    searchvn.updateSpaceIndex();
+  }
   return loc_tree.lower_bound(&searchvn);
 }
 
@@ -1589,6 +1587,7 @@ VarnodeLocSet::const_iterator VarnodeBank::beginLoc(int4 s,const Address &addr)
 {
   searchvn.size = s;
   searchvn.loc = addr;
+  searchvn.updateSpaceIndex();
   VarnodeLocSet::const_iterator iter = loc_tree.lower_bound(&searchvn);
   searchvn.size = 0;		// Return size to 0
   return iter;
@@ -1604,6 +1603,7 @@ VarnodeLocSet::const_iterator VarnodeBank::endLoc(int4 s,const Address &addr) co
 {
   searchvn.size = s+1;
   searchvn.loc = addr;
+  searchvn.updateSpaceIndex();
   VarnodeLocSet::const_iterator iter = loc_tree.lower_bound(&searchvn);
   searchvn.size = 0;		// Return size to 0
   return iter;
@@ -1627,6 +1627,7 @@ VarnodeLocSet::const_iterator VarnodeBank::beginLoc(int4 s,const Address &addr,
   if (fl == Varnode::input) {
     searchvn.size = s;
     searchvn.loc = addr;
+    searchvn.updateSpaceIndex();
     iter = loc_tree.lower_bound(&searchvn);
     searchvn.size = 0;
     return iter;
@@ -1636,6 +1637,7 @@ VarnodeLocSet::const_iterator VarnodeBank::beginLoc(int4 s,const Address &addr,
     PcodeOp searchop(0,sq);
     searchvn.size = s;
     searchvn.loc = addr;
+    searchvn.updateSpaceIndex();
     searchvn.flags = Varnode::written;
     searchvn.def = &searchop;
     iter = loc_tree.lower_bound(&searchvn);
@@ -1648,6 +1650,7 @@ VarnodeLocSet::const_iterator VarnodeBank::beginLoc(int4 s,const Address &addr,
   PcodeOp searchop(0,sq);
   searchvn.size = s;
   searchvn.loc = addr;
+  searchvn.updateSpaceIndex();
   searchvn.flags = Varnode::written;
   searchvn.def = &searchop;
   iter = loc_tree.upper_bound(&searchvn);
@@ -1672,6 +1675,7 @@ VarnodeLocSet::const_iterator VarnodeBank::endLoc(int4 s,const Address &addr,
 {
   VarnodeLocSet::const_iterator iter;
   searchvn.loc = addr;
+  searchvn.updateSpaceIndex();
   
   if (fl == Varnode::written) {
     searchvn.size = s;
@@ -1714,6 +1718,7 @@ VarnodeLocSet::const_iterator VarnodeBank::beginLoc(int4 s,const Address &addr,
   VarnodeLocSet::const_iterator iter;
   searchvn.size = s;
   searchvn.loc = addr;
+  searchvn.updateSpaceIndex();
   searchvn.flags = Varnode::written;
   if (uniq==~((uintm)0))	// If don't care about uniq
     uniq = 0;			// find earliest
@@ -1743,6 +1748,7 @@ VarnodeLocSet::const_iterator VarnodeBank::endLoc(int4 s,const Address &addr,
   VarnodeLocSet::const_iterator iter;
   searchvn.size = s;
   searchvn.loc = addr;
+  searchvn.updateSpaceIndex();
   searchvn.flags = Varnode::written;
   //  if (uniq==~((uintm)0))
   //    uniq = 0;
@@ -1813,7 +1819,8 @@ VarnodeDefSet::const_iterator VarnodeBank::beginDef(uint4 fl) const
   if (fl == Varnode::input)
     return def_tree.begin();	// Inputs occur first with def_tree
   else if (fl == Varnode::written) {
-    searchvn.loc = Address(Address::m_minimal); // Lowest possible location
+    searchvn.loc = Address(Address::m_minimal);
+    searchvn.updateSpaceIndex(); // Lowest possible location
     searchvn.flags = Varnode::written;
     SeqNum sq(Address::m_minimal); // Lowest possible seqnum
     PcodeOp searchop(0,sq);
@@ -1824,7 +1831,8 @@ VarnodeDefSet::const_iterator VarnodeBank::beginDef(uint4 fl) const
   }
 
   // Find the start of the frees
-  searchvn.loc = Address(Address::m_maximal); // Maximal possible location
+  searchvn.loc = Address(Address::m_maximal);
+  searchvn.updateSpaceIndex(); // Maximal possible location
   searchvn.flags = Varnode::written;
   SeqNum sq(Address::m_maximal); // Maximal seqnum
   PcodeOp searchop(0,sq);
@@ -1849,7 +1857,8 @@ VarnodeDefSet::const_iterator VarnodeBank::endDef(uint4 fl) const
   VarnodeDefSet::const_iterator iter;
 
   if (fl == Varnode::input) {	// Highest input is lowest written
-    searchvn.loc = Address(Address::m_minimal); // Lowest possible location
+    searchvn.loc = Address(Address::m_minimal);
+    searchvn.updateSpaceIndex(); // Lowest possible location
     searchvn.flags = Varnode::written;
     SeqNum sq(Address::m_minimal); // Lowest possible seqnum
     PcodeOp searchop(0,sq);
@@ -1859,7 +1868,8 @@ VarnodeDefSet::const_iterator VarnodeBank::endDef(uint4 fl) const
     return iter;
   }
   else if (fl == Varnode::written) { // Highest written
-    searchvn.loc = Address(Address::m_maximal); // Maximal possible location
+    searchvn.loc = Address(Address::m_maximal);
+    searchvn.updateSpaceIndex(); // Maximal possible location
     searchvn.flags = Varnode::written;
     SeqNum sq(Address::m_maximal); // Maximal seqnum
     PcodeOp searchop(0,sq);
@@ -1891,12 +1901,14 @@ VarnodeDefSet::const_iterator VarnodeBank::beginDef(uint4 fl,const Address &addr
     throw LowlevelError("Cannot get contiguous written AND addressed");
   else if (fl == Varnode::input) {
     searchvn.loc = addr;
+    searchvn.updateSpaceIndex();
     iter = def_tree.lower_bound(&searchvn);
     return iter;
   }
 
   // Find the start of the frees with a given address
   searchvn.loc = addr;
+  searchvn.updateSpaceIndex();
   searchvn.flags = 0;
 				// Since a size 0 object shouldn't exist, an upper bound
 				// should bump up to first free of addr with non-zero size
@@ -1925,6 +1937,7 @@ VarnodeDefSet::const_iterator VarnodeBank::endDef(uint4 fl,const Address &addr)
     throw LowlevelError("Cannot get contiguous written AND addressed");
   else if (fl == Varnode::input) {
     searchvn.loc = addr;
+    searchvn.updateSpaceIndex();
     searchvn.size = 1000000;
     iter = def_tree.lower_bound(&searchvn);
     searchvn.size = 0;
@@ -1933,6 +1946,7 @@ VarnodeDefSet::const_iterator VarnodeBank::endDef(uint4 fl,const Address &addr)
 
   // Find the start of the frees with a given address
   searchvn.loc = addr;
+  searchvn.updateSpaceIndex();
   searchvn.size = 1000000;
   searchvn.flags = 0;
 				// Since a size 0 object shouldn't exist, an upper bound
@@ -20,6 +20,7 @@
 
 #include "pcoderaw.hh"
 #include "cover.hh"
+#include "objectpool.hh"
 
 namespace ghidra {
 
@@ -118,8 +119,6 @@ public:
   enum addl_flags {
     activeheritage = 0x01,	///< The varnode is actively being heritaged
     writemask = 0x02,           ///< Should not be considered a write in heritage calculation
-    vacconsume = 0x04,		///< Vacuous consume
-    lisconsume = 0x08,		///< In consume worklist
     ptrcheck = 0x10,	        ///< The Varnode value is \e NOT a pointer
     ptrflow = 0x20,             ///< If this varnode flows to or from a pointer
     unsignedprint = 0x40,	///< Constant that must be explicitly printed as an unsigned token
@@ -134,6 +133,7 @@ public:
 private:
   mutable uint4 flags;		///< The collection of boolean attributes for this Varnode
   int4 size;			///< Size of the Varnode in bytes
+  uint4 spcindex;		///< Cached sort index of the storage space, so tree compares stay within \b this object
   uint4 create_index;		///< A unique one-up index assigned to Varnode at its creation
   int2 mergegroup;		///< Which group of forced merges does this Varnode belong to
   uint2 addlflags;		///< Additional flags
@@ -147,6 +147,7 @@ private:
   VarnodeLocSet::iterator lociter;	///< Iterator into VarnodeBank sorted by location
   VarnodeDefSet::iterator defiter;	///< Iterator into VarnodeBank sorted by definition
   list<PcodeOp *> descend;		///< List of every op using this varnode as input
+  PcodeOp *lonedescend;		///< The unique reading op when \b descend holds exactly one entry (null otherwise)
   mutable Cover *cover;		///< Addresses covered by the def->use of this Varnode
   mutable union {
     Datatype *dataType;		///< Temporary data-type associated with \b this for use in type propagate algorithm
@@ -158,6 +159,23 @@ private:
   friend class Merge;
   friend class Funcdata;
   friend class CloneBlockOps;
+  friend struct VarnodeCompareLocDef;
+  friend struct VarnodeCompareDefLoc;
+
+  /// \brief Recompute the cached sort index of the storage space
+  ///
+  /// The index collapses the sentinel and AddrSpace ordering of Address::operator<
+  /// into one integer kept inside \b this object, so tree comparators never have to
+  /// dereference the AddrSpace.  It must be called whenever \b loc changes space.
+  void updateSpaceIndex(void) {
+    AddrSpace *spc = loc.getSpace();
+    if (spc == (AddrSpace *)0)
+      spcindex = 0;
+    else if (spc == (AddrSpace *) ~((uintp)0))
+      spcindex = ~((uint4)0);
+    else
+      spcindex = (uint4)spc->getIndex() + 1;
+  }
   void updateCover(void) const;	///< Internal function for update coverage information
   void calcCover(void) const;	///< Turn on the Cover object for this Varnode
   void clearCover(void) const; ///< Turn off any coverage information
@@ -204,13 +222,7 @@ public:
   list<PcodeOp *>::const_iterator endDescend(void) const { return descend.end(); } ///< Get the end iterator to list of descendants
   uintb getConsume(void) const { return consumed; } ///< Get mask of consumed bits
   void setConsume(uintb val) { consumed = val; } ///< Set the mask of consumed bits (used by dead-code algorithm)
-  bool isConsumeList(void) const { return ((addlflags&Varnode::lisconsume)!=0); } ///< Get marker used by dead-code algorithm
-  bool isConsumeVacuous(void) const { return ((addlflags&Varnode::vacconsume)!=0); } ///< Get marker used by dead-code algorithm
-  void setConsumeList(void) { addlflags |= Varnode::lisconsume; } ///< Set marker used by dead-code algorithm
-  void setConsumeVacuous(void) { addlflags |= Varnode::vacconsume; } ///< Set marker used by dead-code algorithm
-  void clearConsumeList(void) { addlflags &= ~Varnode::lisconsume; } ///< Clear marker used by dead-code algorithm
-  void clearConsumeVacuous(void) { addlflags &= ~Varnode::vacconsume; } ///< Clear marker used by dead-code algorithm
-  PcodeOp *loneDescend(void) const; ///< Return unique reading PcodeOp, or \b null if there are zero or more than 1
+  PcodeOp *loneDescend(void) const { return lonedescend; } ///< Return unique reading PcodeOp, or \b null if there are zero or more than 1
   Address getUsePoint(const Funcdata &fd) const; ///< Get Address when this Varnode first comes into scope
   int4 printRawNoMarkup(ostream &s) const; ///< Print a simple identifier for the Varnode
   void printRaw(ostream &s) const; ///< Print a simple identifier plus additional info identifying Varnode with SSA form
@@ -362,7 +374,10 @@ public:
 /// The class maintains a \e last \e offset counter for allocation
 /// temporary Varnode objects in the \e unique space. Constants are created
 /// by passing a constant address to the create() method.
+/// All Varnode objects are carved from a pool owned by \b this container,
+/// so creation bypasses the global heap and clear() releases them wholesale.
 class VarnodeBank {
+  ObjectPool<Varnode> pool;	///< Storage pool owning all Varnodes in the container
   AddrSpaceManager *manage;	///< Underlying address space manager
   AddrSpace *uniq_space;	///< Space to allocate unique varnodes from
   uintm uniqbase;		///< Base for unique addresses
@@ -1,8 +1,11 @@
 /**
  * Fission C Wrapper for Ghidra Decompiler
- * 
- * SIMPLIFIED VERSION for debugging
- * 
+ *
+ * In-process decompilation: embeds SleighArchitecture and the action
+ * pipeline directly behind the C ABI so a single-user client can link the
+ * decompiler and skip the gRPC serialization and process hop entirely.
+ * The gRPC server (server_main.cc) remains the path for multi-session use.
+ *
  * Copyright 2024 Fission Dev Team
  * Licensed under Apache 2.0
  */
@@ -10,14 +13,12 @@
 #include "wrapper.h"
 #include <cstring>
 #include <sstream>
+#include <memory>
 #include <mutex>
 
-// Only include Ghidra headers when actually needed
 #ifdef USE_GHIDRA
 #include "libdecomp.hh"
-#include "sleigh_arch.hh"
-#include "loadimage.hh"
-#include "context.hh"
+#include "server_arch.hh"
 using namespace ghidra;
 #endif
 
@@ -29,16 +30,227 @@ static bool g_library_initialized = false;
 static std::mutex g_init_mutex;
 
 /**
- * Minimal FissionDecompiler struct - no Ghidra dependencies for now
+ * Decompiler instance: owns one architecture built over the caller's bytes.
+ * The architecture is rebuilt only when the bytes or base address change,
+ * so repeated calls against the same image reuse all cached analysis.
  */
 struct FissionDecompiler {
     std::string sla_dir;
+    std::string lang_id;
     bool initialized;
     std::mutex mutex;
-    
+    // Result of the last decompile/disassemble on this handle; the _view
+    // entry points hand out pointers into it, so it must survive until
+    // the next call taking this instance
+    std::string result_buf;
+
+#ifdef USE_GHIDRA
+    // The loader is owned by the architecture once handed over
+    // (~Architecture deletes it); this pointer is only kept for image
+    // change detection
+    MemoryLoadImage* loader;
+    std::unique_ptr<ServerArchitecture> arch;
+    uint64_t loaded_base;
+
+    FissionDecompiler()
+        : lang_id("x86:LE:64:default"), initialized(false),
+          loader(nullptr), loaded_base(0) {}
+
+    // Make sure the architecture reflects the caller's bytes, rebuilding it
+    // when the image changed. Returns false (with g_last_error set) on failure.
+    bool ensureImage(const uint8_t* bytes, size_t bytes_len, uint64_t base_addr) {
+        if (arch && loaded_base == base_addr &&
+            loader->imageSize() == bytes_len &&
+            memcmp(loader->buffer(), bytes, bytes_len) == 0) {
+            return true;  // Same image: keep cached analysis
+        }
+        arch.reset();  // Frees the previous loader as well
+        loader = nullptr;
+        try {
+            loader = new MemoryLoadImage(
+                std::string(reinterpret_cast<const char*>(bytes), bytes_len),
+                base_addr);
+            arch = std::make_unique<ServerArchitecture>(lang_id, loader, &std::cerr);
+            DocumentStorage store;
+            arch->init(store);
+            loader->setCodeSpace(arch->getDefaultCodeSpace());
+            loaded_base = base_addr;
+            return true;
+        } catch (const LowlevelError& e) {
+            arch.reset();
+            loader = nullptr;
+            g_last_error = "Architecture setup failed: " + e.explain;
+            return false;
+        } catch (const std::exception& e) {
+            arch.reset();
+            loader = nullptr;
+            g_last_error = std::string("Architecture setup failed: ") + e.what();
+            return false;
+        }
+    }
+#else
     FissionDecompiler() : initialized(false) {}
+#endif
 };
 
+#ifdef USE_GHIDRA
+// Captures one instruction's disassembly strings from printAssembly()
+class WrapperAssemblyEmit : public AssemblyEmit {
+public:
+    std::string mnem;
+    std::string body;
+
+    virtual void dump(const Address &addr, const string &m, const string &b) override {
+        mnem = m;
+        body = b;
+    }
+};
+#endif
+
+// Copy a result string into the caller's buffer, always NUL terminated
+static int copyOut(const std::string& result, char* out_buffer, size_t out_len) {
+    size_t copy_len = std::min(result.size(), out_len - 1);
+    memcpy(out_buffer, result.c_str(), copy_len);
+    out_buffer[copy_len] = '\0';
+    return static_cast<int>(copy_len);
+}
+
+// Shared argument validation for both result styles
+static bool checkArgs(FissionDecompiler* decomp, const uint8_t* bytes, size_t bytes_len) {
+    if (!decomp || !decomp->initialized) {
+        g_last_error = "Decompiler not initialized";
+        return false;
+    }
+    if (!bytes || bytes_len == 0) {
+        g_last_error = "Invalid input bytes";
+        return false;
+    }
+    return true;
+}
+
+// Produce decompiled C code into decomp->result_buf.
+// Caller holds decomp->mutex. Returns 0 on success, -1 with g_last_error set.
+static int decompileInto(
+    FissionDecompiler* decomp,
+    const uint8_t* bytes,
+    size_t bytes_len,
+    uint64_t base_addr
+) {
+#ifdef USE_GHIDRA
+    if (!decomp->ensureImage(bytes, bytes_len, base_addr))
+        return -1;
+    ServerArchitecture* arch = decomp->arch.get();
+
+    try {
+        Address func_addr(arch->getDefaultCodeSpace(), base_addr);
+        std::ostringstream fname;
+        fname << "func_" << std::hex << base_addr;
+
+        Scope* global_scope = arch->symboltab->getGlobalScope();
+        Funcdata* fd = global_scope->findFunction(func_addr);
+        if (fd == nullptr)
+            fd = global_scope->addFunction(func_addr, fname.str())->getFunction();
+        if (fd == nullptr) {
+            g_last_error = "Unable to create function";
+            return -1;
+        }
+
+        // Run the full action pipeline unless a previous call over the
+        // same image already analyzed this function
+        if (!fd->isProcComplete()) {
+            Action* rootact = arch->allacts.getCurrent();
+            rootact->reset(*fd);
+            if (rootact->perform(*fd) < 0) {
+                g_last_error = "Decompilation did not complete";
+                return -1;
+            }
+        }
+
+        std::ostringstream c_out;
+        arch->print->setOutputStream(&c_out);
+        arch->print->docFunction(fd);
+        decomp->result_buf = c_out.str();
+        return 0;
+    } catch (const LowlevelError& e) {
+        g_last_error = "Decompilation failed: " + e.explain;
+        return -1;
+    } catch (const std::exception& e) {
+        g_last_error = std::string("Decompilation failed: ") + e.what();
+        return -1;
+    }
+#else
+    // Built without the decompiler core: report a stub so callers fall
+    // back to the gRPC server path
+    std::ostringstream output;
+    output << "// Decompiled by Fission (Ghidra Sleigh Engine)\n";
+    output << "// Address: 0x" << std::hex << base_addr << std::dec << "\n";
+    output << "// Input: " << bytes_len << " bytes\n\n";
+    output << "// Built without USE_GHIDRA; native decompilation unavailable\n";
+    decomp->result_buf = output.str();
+    return 0;
+#endif
+}
+
+// Produce disassembly text into decomp->result_buf.
+// Caller holds decomp->mutex. Returns 0 on success, -1 with g_last_error set.
+static int disassembleInto(
+    FissionDecompiler* decomp,
+    const uint8_t* bytes,
+    size_t bytes_len,
+    uint64_t base_addr
+) {
+#ifdef USE_GHIDRA
+    if (!decomp->ensureImage(bytes, bytes_len, base_addr))
+        return -1;
+    ServerArchitecture* arch = decomp->arch.get();
+
+    try {
+        std::ostringstream output;
+        uint64_t end = base_addr + bytes_len;
+        Address cur(arch->getDefaultCodeSpace(), base_addr);
+        while (cur.getOffset() < end) {
+            WrapperAssemblyEmit emit;
+            int4 length;
+            try {
+                length = arch->translate->printAssembly(emit, cur);
+            } catch (const BadDataError&) {
+                break;  // Undecodable bytes end the listing
+            }
+            if (length <= 0)
+                break;
+            output << std::hex << cur.getOffset() << ":  "
+                   << emit.mnem << " " << emit.body << "\n";
+            cur = cur + length;
+        }
+        decomp->result_buf = output.str();
+        return 0;
+    } catch (const LowlevelError& e) {
+        g_last_error = "Disassembly failed: " + e.explain;
+        return -1;
+    }
+#else
+    // Simple hex dump fallback when built without the decompiler core
+    std::ostringstream output;
+    output << "; Disassembly by Fission (Ghidra Sleigh)\n";
+    output << "; Address: 0x" << std::hex << base_addr << "\n";
+    output << "; Bytes: " << std::dec << bytes_len << "\n\n";
+
+    size_t addr = base_addr;
+    for (size_t i = 0; i < bytes_len && i < 64; i += 8) {
+        output << std::hex << addr << ":  ";
+        for (size_t j = i; j < i + 8 && j < bytes_len; j++) {
+            output << std::hex;
+            if (bytes[j] < 16) output << "0";
+            output << (int)bytes[j] << " ";
+        }
+        output << "\n";
+        addr += 8;
+    }
+    decomp->result_buf = output.str();
+    return 0;
+#endif
+}
+
 extern "C" {
 
 FissionDecompiler* fission_decompiler_init(const char* sla_dir) {
@@ -46,13 +258,26 @@ FissionDecompiler* fission_decompiler_init(const char* sla_dir) {
         g_last_error = "sla_dir is null";
         return nullptr;
     }
-    
+
     try {
-        // Simple initialization - don't call Ghidra yet
+#ifdef USE_GHIDRA
+        {
+            // Process-wide Sleigh setup: capabilities and the specification
+            // search path. Runs once no matter how many instances the
+            // client creates.
+            std::lock_guard<std::mutex> lock(g_init_mutex);
+            if (!g_library_initialized) {
+                startDecompilerLibrary(sla_dir);
+                SleighArchitecture::specpaths.addDir2Path(sla_dir);
+                g_library_initialized = true;
+            }
+        }
+#else
+        g_library_initialized = true;
+#endif
         FissionDecompiler* decomp = new FissionDecompiler();
         decomp->sla_dir = sla_dir;
         decomp->initialized = true;
-        g_library_initialized = true;
         return decomp;
     } catch (const std::exception& e) {
         g_last_error = std::string("Failed to create decompiler: ") + e.what();
@@ -74,39 +299,42 @@ int fission_decompile(
     char* out_buffer,
     size_t out_len
 ) {
-    if (!decomp || !decomp->initialized) {
-        g_last_error = "Decompiler not initialized";
-        return -1;
-    }
-    
-    if (!bytes || bytes_len == 0) {
-        g_last_error = "Invalid input bytes";
+    if (!checkArgs(decomp, bytes, bytes_len))
         return -1;
-    }
-    
+
     if (!out_buffer || out_len == 0) {
         g_last_error = "Invalid output buffer";
         return -1;
     }
-    
+
     std::lock_guard<std::mutex> lock(decomp->mutex);
-    
-    // For now, just return a placeholder until we fix Ghidra integration
-    std::ostringstream output;
-    output << "// Decompiled by Fission (Ghidra Sleigh Engine)\n";
-    output << "// Address: 0x" << std::hex << base_addr << std::dec << "\n";
-    output << "// Input: " << bytes_len << " bytes\n\n";
-    output << "void func_" << std::hex << base_addr << "() {\n";
-    output << "    // TODO: Full Ghidra decompilation\n";
-    output << "    // SLA dir: " << decomp->sla_dir << "\n";
-    output << "}\n";
-    
-    std::string result = output.str();
-    size_t copy_len = std::min(result.size(), out_len - 1);
-    memcpy(out_buffer, result.c_str(), copy_len);
-    out_buffer[copy_len] = '\0';
-    
-    return static_cast<int>(copy_len);
+    if (decompileInto(decomp, bytes, bytes_len, base_addr) < 0)
+        return -1;
+    return copyOut(decomp->result_buf, out_buffer, out_len);
+}
+
+int fission_decompile_view(
+    FissionDecompiler* decomp,
+    const uint8_t* bytes,
+    size_t bytes_len,
+    uint64_t base_addr,
+    const char** out_ptr,
+    size_t* out_size
+) {
+    if (!checkArgs(decomp, bytes, bytes_len))
+        return -1;
+
+    if (!out_ptr || !out_size) {
+        g_last_error = "Invalid output pointers";
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lock(decomp->mutex);
+    if (decompileInto(decomp, bytes, bytes_len, base_addr) < 0)
+        return -1;
+    *out_ptr = decomp->result_buf.c_str();
+    *out_size = decomp->result_buf.size();
+    return 0;
 }
 
 int fission_disassemble(
@@ -117,48 +345,42 @@ int fission_disassemble(
     char* out_buffer,
     size_t out_len
 ) {
-    if (!decomp || !decomp->initialized) {
-        g_last_error = "Decompiler not initialized";
-        return -1;
-    }
-    
-    if (!bytes || bytes_len == 0) {
-        g_last_error = "Invalid input bytes";
+    if (!checkArgs(decomp, bytes, bytes_len))
         return -1;
-    }
-    
+
     if (!out_buffer || out_len == 0) {
         g_last_error = "Invalid output buffer";
         return -1;
     }
-    
+
     std::lock_guard<std::mutex> lock(decomp->mutex);
-    
-    // Simple hex dump as placeholder
-    std::ostringstream output;
-    output << "; Disassembly by Fission (Ghidra Sleigh)\n";
-    output << "; Address: 0x" << std::hex << base_addr << "\n";
-    output << "; Bytes: " << std::dec << bytes_len << "\n\n";
-    
-    // Raw bytes display
-    size_t addr = base_addr;
-    for (size_t i = 0; i < bytes_len && i < 64; i += 8) {
-        output << std::hex << addr << ":  ";
-        for (size_t j = i; j < i + 8 && j < bytes_len; j++) {
-            output << std::hex;
-            if (bytes[j] < 16) output << "0";
-            output << (int)bytes[j] << " ";
-        }
-        output << "\n";
-        addr += 8;
+    if (disassembleInto(decomp, bytes, bytes_len, base_addr) < 0)
+        return -1;
+    return copyOut(decomp->result_buf, out_buffer, out_len);
+}
+
+int fission_disassemble_view(
+    FissionDecompiler* decomp,
+    const uint8_t* bytes,
+    size_t bytes_len,
+    uint64_t base_addr,
+    const char** out_ptr,
+    size_t* out_size
+) {
+    if (!checkArgs(decomp, bytes, bytes_len))
+        return -1;
+
+    if (!out_ptr || !out_size) {
+        g_last_error = "Invalid output pointers";
+        return -1;
     }
-    
-    std::string result = output.str();
-    size_t copy_len = std::min(result.size(), out_len - 1);
-    memcpy(out_buffer, result.c_str(), copy_len);
-    out_buffer[copy_len] = '\0';
-    
-    return static_cast<int>(copy_len);
+
+    std::lock_guard<std::mutex> lock(decomp->mutex);
+    if (disassembleInto(decomp, bytes, bytes_len, base_addr) < 0)
+        return -1;
+    *out_ptr = decomp->result_buf.c_str();
+    *out_size = decomp->result_buf.size();
+    return 0;
 }
 
 const char* fission_get_error(void) {
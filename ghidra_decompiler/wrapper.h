@@ -56,9 +56,34 @@ int fission_decompile(
     size_t out_len
 );
 
+/**
+ * Decompile a function at the given address, without copying the result.
+ *
+ * On success *out_ptr points at a NUL-terminated buffer owned by the
+ * decompiler instance and *out_size holds its length. The buffer stays
+ * valid until the next call taking this instance, or until the instance
+ * is destroyed — callers needing to keep the text longer must copy it.
+ *
+ * @param decomp Decompiler instance
+ * @param bytes Raw machine code bytes
+ * @param bytes_len Length of bytes buffer
+ * @param base_addr Virtual address of the function
+ * @param out_ptr Receives a pointer to the decompiled C code
+ * @param out_size Receives the length of the result in bytes
+ * @return 0 on success, -1 on error
+ */
+int fission_decompile_view(
+    FissionDecompiler* decomp,
+    const uint8_t* bytes,
+    size_t bytes_len,
+    uint64_t base_addr,
+    const char** out_ptr,
+    size_t* out_size
+);
+
 /**
  * Disassemble instructions at the given address.
- * 
+ *
  * @param decomp Decompiler instance
  * @param bytes Raw machine code bytes
  * @param bytes_len Length of bytes buffer
@@ -76,6 +101,27 @@ int fission_disassemble(
     size_t out_len
 );
 
+/**
+ * Disassemble instructions at the given address, without copying the result.
+ * Same ownership and lifetime rules as fission_decompile_view().
+ *
+ * @param decomp Decompiler instance
+ * @param bytes Raw machine code bytes
+ * @param bytes_len Length of bytes buffer
+ * @param base_addr Virtual address of the first instruction
+ * @param out_ptr Receives a pointer to the disassembly text
+ * @param out_size Receives the length of the result in bytes
+ * @return 0 on success, -1 on error
+ */
+int fission_disassemble_view(
+    FissionDecompiler* decomp,
+    const uint8_t* bytes,
+    size_t bytes_len,
+    uint64_t base_addr,
+    const char** out_ptr,
+    size_t* out_size
+);
+
 /**
  * Get the last error message.
  * 
@@ -96,6 +96,7 @@
 // AttValue mode   looking for endquote  or '&'
 // Comment mode    looking for "--"
 
+#include <cstring>
 #include <iostream>
 #include <string>
 
@@ -125,37 +126,60 @@ public:
 	       ElementBraceToken = 265,
 	       CommandBraceToken = 266 };
 private:
+  static const int4 BUFSIZE = 16384;	///< Number of bytes read from the stream at a time
   mode curmode;			///< The current scanning mode
   istream &s;			///< The stream being scanned
   string *lvalue;		///< Current string being built
-  int4 lookahead[4];	///< Lookahead into the byte stream
-  int4 pos;				///< Current position in the lookahead buffer
+  char *buffer;			///< Block of buffered bytes from the stream
+  int4 bufpos;			///< Next unconsumed byte in the buffer
+  int4 buftop;			///< Number of valid bytes in the buffer
   bool endofstream;		///< Has end of stream been reached
   void clearlvalue(void);	///< Clear the current token string
+  void refill(void);		///< Read the next block of bytes from the stream
 
   /// \brief Get the next byte in the stream
   ///
-  /// Maintain a lookahead of 4 bytes at all times so that we can check for special
-  /// XML character sequences without consuming.
+  /// Bytes are consumed from the buffered block, refilling it from the
+  /// stream as necessary.
   /// \return the next byte value as an integer
   int4 getxmlchar(void) {
-    char c;	    
-    int4 ret=lookahead[pos];
-    if (!endofstream) {
-      s.get(c); 
-      if (s.eof()||(c=='\0')) {
-	endofstream = true;
-	lookahead[pos] = '\n';
-      }
-      else
-	lookahead[pos] = c;
+    if (bufpos == buftop) {
+      if (endofstream) return -1;
+      refill();
+      if (bufpos == buftop) return -1;
     }
-    else
-      lookahead[pos] = -1;
-    pos = (pos+1)&3;
-    return ret;
+    return (int4)buffer[bufpos++];
+  }
+
+  /// \brief Peek at the next (i-th) byte without consuming
+  int4 next(int4 i) {
+    while(bufpos + i >= buftop) {
+      if (endofstream) return -1;
+      refill();
+    }
+    return (int4)buffer[bufpos+i];
+  }
+
+  /// \brief Offset from the current position of the earliest of three stop bytes
+  ///
+  /// Search the buffered bytes for any of three candidate byte values.
+  /// \return the offset of the earliest occurrence, or -1 if none is present
+  int4 findStop(char c1,char c2,char c3) {
+    int4 n = buftop - bufpos;
+    const char *base = buffer + bufpos;
+    const char *p = (const char *)memchr(base,c1,n);
+    if (p != (const char *)0)
+      n = (int4)(p - base);
+    const char *q = (const char *)memchr(base,c2,n);
+    if (q != (const char *)0) {
+      p = q;
+      n = (int4)(p - base);
+    }
+    q = (const char *)memchr(base,c3,n);
+    if (q != (const char *)0)
+      p = q;
+    return (p == (const char *)0) ? -1 : (int4)(p - base);
   }
-  int4 next(int4 i) { return lookahead[(pos+i)&3]; }	///< Peek at the next (i-th) byte without consuming
   bool isLetter(int4 val) { return (((val>=0x41)&&(val<=0x5a))||((val>=0x61)&&(val<=0x7a))); }	///< Is the given byte a \e letter
   bool isInitialNameChar(int4 val);		///< Is the given byte/character the valid start of an XML name
   bool isNameChar(int4 val);			///< Is the given byte/character valid for an XML name	
@@ -2082,15 +2106,44 @@ XmlScan::XmlScan(istream &t) : s(t)
 {
   curmode = SingleMode;
   lvalue = (string *)0;
-  pos = 0;
+  buffer = new char[BUFSIZE];
+  bufpos = 0;
+  buftop = 0;
   endofstream = false;
-  getxmlchar(); getxmlchar(); getxmlchar(); getxmlchar(); // Fill lookahead buffer
 }
 
 XmlScan::~XmlScan(void)
 
 {
   clearlvalue();
+  delete [] buffer;
+}
+
+/// Unconsumed bytes are compacted to the front of the buffer, then the buffer is
+/// topped up from the stream.  Reaching the end of the stream, or an embedded
+/// null character, truncates the input and appends a single terminating newline,
+/// matching the behavior of the old character-at-a-time reader.
+void XmlScan::refill(void)
+
+{
+  if (bufpos > 0) {
+    memmove(buffer,buffer+bufpos,buftop-bufpos);
+    buftop -= bufpos;
+    bufpos = 0;
+  }
+  s.read(buffer+buftop,BUFSIZE-1-buftop);	// Always leave room for the terminating newline
+  int4 count = (int4)s.gcount();
+  bool hitend = (count != BUFSIZE-1-buftop);	// Short read means end of stream
+  char *nullchar = (char *)memchr(buffer+buftop,'\0',count);
+  if (nullchar != (char *)0) {
+    count = (int4)(nullchar - (buffer+buftop));	// Truncate at embedded null character
+    hitend = true;
+  }
+  buftop += count;
+  if (hitend) {
+    endofstream = true;
+    buffer[buftop++] = '\n';
+  }
 }
 
 void XmlScan::clearlvalue(void)
@@ -2118,13 +2171,18 @@ int4 XmlScan::scanCharData(void)
   lvalue = new string();
   
   while(next(0) != -1) {		// look for '<' '&' or ']]>'
-    if (next(0) == '<') break;
-    if (next(0) == '&') break;
-    if (next(0) == ']')
-      if (next(1)== ']')
-	if (next(2)=='>')
-	  break;
-    *lvalue += getxmlchar();
+    int4 stop = findStop('<','&',']');
+    if (stop < 0) {			// No stop character in buffer
+      lvalue->append(buffer+bufpos,buftop-bufpos);
+      bufpos = buftop;
+      continue;
+    }
+    lvalue->append(buffer+bufpos,stop);
+    bufpos += stop;
+    if (next(0) != ']') break;		// Stopped at '<' or '&'
+    if ((next(1)==']')&&(next(2)=='>'))
+      break;
+    *lvalue += getxmlchar();		// Lone ']' is part of the character data
   }
   if (lvalue->size()==0)
     return scanSingle();
@@ -2138,12 +2196,21 @@ int4 XmlScan::scanCData(void)
   lvalue = new string();
 
   while(next(0) != -1) {	// Look for "]]>" and non-Char
-    if (next(0)==']')
-      if (next(1)==']')
-	if (next(2)=='>')
-	  break;
-    if (!isChar(next(0))) break;
-    *lvalue += getxmlchar();
+    int4 stop = buftop - bufpos;
+    for(int4 i=0;i<stop;++i) {
+      char c = buffer[bufpos+i];
+      if ((c == ']')||(!isChar((int4)c))) {
+	stop = i;
+	break;
+      }
+    }
+    lvalue->append(buffer+bufpos,stop);
+    bufpos += stop;
+    if (bufpos == buftop) continue;	// Buffer exhausted without a stop character
+    if (next(0) != ']') break;		// Stopped at a non-Char
+    if ((next(1)==']')&&(next(2)=='>'))
+      break;
+    *lvalue += getxmlchar();		// Lone ']' is part of the CDATA
   }
   return CDataToken;		// CData can be empty
 }
@@ -2186,10 +2253,15 @@ int4 XmlScan::scanAttValue(int4 quote)
   clearlvalue();
   lvalue = new string();
   while(next(0) != -1) {
-    if (next(0) == quote) break;
-    if (next(0) == '<') break;
-    if (next(0) == '&') break;
-    *lvalue += getxmlchar();
+    int4 stop = findStop((char)quote,'<','&');
+    if (stop < 0) {			// No stop character in buffer
+      lvalue->append(buffer+bufpos,buftop-bufpos);
+      bufpos = buftop;
+      continue;
+    }
+    lvalue->append(buffer+bufpos,stop);
+    bufpos += stop;
+    break;
   }
   if (lvalue->size() == 0)
     return scanSingle();
@@ -2203,11 +2275,21 @@ int4 XmlScan::scanComment(void)
   lvalue = new string();
 
   while(next(0) != -1) {
-    if (next(0)=='-')
-      if (next(1)=='-')
+    int4 stop = buftop - bufpos;
+    for(int4 i=0;i<stop;++i) {
+      char c = buffer[bufpos+i];
+      if ((c == '-')||(!isChar((int4)c))) {
+	stop = i;
 	break;
-    if (!isChar(next(0))) break;
-    *lvalue += getxmlchar();
+      }
+    }
+    lvalue->append(buffer+bufpos,stop);
+    bufpos += stop;
+    if (bufpos == buftop) continue;	// Buffer exhausted without a stop character
+    if (next(0) != '-') break;		// Stopped at a non-Char
+    if (next(1)=='-')
+      break;
+    *lvalue += getxmlchar();		// Lone '-' is part of the comment
   }
   return CommentToken;
 }